@@ -59,7 +59,9 @@ class PlasmaView extends View {
 
     public PlasmaView(Context context, int width, int height) {
         super(context);
-        mBitmap = Bitmap.createBitmap(width, height, Bitmap.Config.RGB_565);
+        // the renderer draws in the bitmap's format: ARGB_8888 is what the
+        // canvas draws into, so drawBitmap() has nothing to convert
+        mBitmap = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888);
         mStartTime = System.currentTimeMillis();
     }
 
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BAND_WORKERS_H
+#define BAND_WORKERS_H
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Threads running the bands of a job, shared by the plasma renderer and the
+ * nn-samples CPU executor: Run() wakes them, runs band 0 on the calling
+ * thread and returns when all the bands are done. The threads are started
+ * the first time they are needed and wait between runs.
+ */
+class BandWorkers {
+ public:
+  BandWorkers() = default;
+  BandWorkers(const BandWorkers&) = delete;
+  BandWorkers& operator=(const BandWorkers&) = delete;
+  ~BandWorkers() {
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      exit_ = true;
+    }
+    start_.notify_all();
+    for (std::thread& thread : threads_) thread.join();
+  }
+
+  void Run(int bands, const std::function<void(int)>& job) {
+    if (bands > 1) {
+      std::lock_guard<std::mutex> lock(lock_);
+      while (static_cast<int>(threads_.size()) < bands - 1) {
+        int band = static_cast<int>(threads_.size()) + 1;
+        // it starts from the run before this one, whenever it runs
+        threads_.emplace_back(&BandWorkers::Loop, this, band, run_);
+      }
+      job_ = &job;
+      bands_ = bands;
+      pending_ = bands - 1;
+      run_++;
+    }
+    start_.notify_all();
+    job(0);
+    if (bands > 1) {
+      std::unique_lock<std::mutex> lock(lock_);
+      done_.wait(lock, [this] { return pending_ == 0; });
+      job_ = nullptr;
+    }
+  }
+
+ private:
+  void Loop(int band, uint32_t seen) {
+    std::unique_lock<std::mutex> lock(lock_);
+    while (true) {
+      start_.wait(lock, [&] { return exit_ || run_ != seen; });
+      if (exit_) return;
+      seen = run_;
+      if (band >= bands_) continue;
+      const std::function<void(int)>* job = job_;
+      lock.unlock();
+      (*job)(band);
+      lock.lock();
+      if (--pending_ == 0) done_.notify_one();
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex lock_;
+  std::condition_variable start_, done_;
+  const std::function<void(int)>* job_ = nullptr;
+  int bands_ = 0;
+  uint32_t run_ = 0;
+  int pending_ = 0;
+  bool exit_ = false;
+};
+
+#endif  // BAND_WORKERS_H
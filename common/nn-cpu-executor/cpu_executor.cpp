@@ -0,0 +1,495 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpu_executor.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <thread>
+
+#include "band_workers.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__ANDROID__) && __has_include(<android/NeuralNetworks.h>)
+#include <android/NeuralNetworks.h>
+// The codes are NNAPI's, so a model is described to both with the same ones.
+#define SAME_AS_NNAPI(code, nnapi)                           \
+  static_assert(nn_cpu::code == static_cast<int32_t>(nnapi), \
+                #code " is not " #nnapi)
+SAME_AS_NNAPI(kInt32, ANEURALNETWORKS_INT32);
+SAME_AS_NNAPI(kTensorFloat32, ANEURALNETWORKS_TENSOR_FLOAT32);
+SAME_AS_NNAPI(kAdd, ANEURALNETWORKS_ADD);
+SAME_AS_NNAPI(kMul, ANEURALNETWORKS_MUL);
+SAME_AS_NNAPI(kFusedNone, ANEURALNETWORKS_FUSED_NONE);
+SAME_AS_NNAPI(kFusedRelu, ANEURALNETWORKS_FUSED_RELU);
+SAME_AS_NNAPI(kFusedRelu1, ANEURALNETWORKS_FUSED_RELU1);
+SAME_AS_NNAPI(kFusedRelu6, ANEURALNETWORKS_FUSED_RELU6);
+#undef SAME_AS_NNAPI
+#endif
+
+#define MAX_THREADS 8
+
+namespace nn_cpu {
+
+// Elements a tile runs all the steps over: a few tiles of inputs,
+// temporaries and outputs stay in the L1 cache.
+static constexpr size_t kTileElements = 1024;
+// A band of fewer elements is not worth waking a thread for.
+static constexpr size_t kMinBandElements = 16 * 1024;
+
+namespace {
+
+// The operations of a step, on one element (Scalar) or 4 (Simd) at a time.
+struct Scalar {
+  typedef float Value;
+  static constexpr size_t kWidth = 1;
+  static Value Load(const float* p) { return *p; }
+  static void Store(float* p, Value v) { *p = v; }
+  static Value Add(Value a, Value b) { return a + b; }
+  static Value Mul(Value a, Value b) { return a * b; }
+  static Value Clamp(Value v, float low, float high) {
+    return std::min(std::max(v, low), high);
+  }
+};
+
+#if defined(__ARM_NEON)
+struct Simd {
+  typedef float32x4_t Value;
+  static constexpr size_t kWidth = 4;
+  static Value Load(const float* p) { return vld1q_f32(p); }
+  static void Store(float* p, Value v) { vst1q_f32(p, v); }
+  static Value Add(Value a, Value b) { return vaddq_f32(a, b); }
+  static Value Mul(Value a, Value b) { return vmulq_f32(a, b); }
+  static Value Clamp(Value v, float low, float high) {
+    return vminq_f32(vmaxq_f32(v, vdupq_n_f32(low)), vdupq_n_f32(high));
+  }
+};
+#elif defined(__SSE2__)
+struct Simd {
+  typedef __m128 Value;
+  static constexpr size_t kWidth = 4;
+  static Value Load(const float* p) { return _mm_loadu_ps(p); }
+  static void Store(float* p, Value v) { _mm_storeu_ps(p, v); }
+  static Value Add(Value a, Value b) { return _mm_add_ps(a, b); }
+  static Value Mul(Value a, Value b) { return _mm_mul_ps(a, b); }
+  static Value Clamp(Value v, float low, float high) {
+    return _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(low)), _mm_set1_ps(high));
+  }
+};
+#endif
+
+/*
+ * out = (in[0] + in[1]) for an ADD, out = (in[0] [+ in[1]]) * (in[2] [+
+ * in[3]]) for a MUL with folded ADDs, clamped to the fused activation.
+ * Runs elements first to count, Lanes::kWidth at a time, and returns where
+ * it stopped: before the last elements when they are fewer than that.
+ */
+template <typename Lanes, bool kLeftSum, bool kMul, bool kRightSum,
+          bool kClamp>
+static size_t RunLanes(const float* const* in, float* out, size_t first,
+                       size_t count, float low, float high) {
+  // in locals: out could alias in[], as far as the compiler knows
+  const float *a = in[0], *b = in[1], *c = in[2], *d = in[3];
+  size_t i = first;
+  for (; i + Lanes::kWidth <= count; i += Lanes::kWidth) {
+    typename Lanes::Value v = Lanes::Load(a + i);
+    if (kLeftSum) v = Lanes::Add(v, Lanes::Load(b + i));
+    if (kMul) {
+      typename Lanes::Value right = Lanes::Load(c + i);
+      if (kRightSum) right = Lanes::Add(right, Lanes::Load(d + i));
+      v = Lanes::Mul(v, right);
+    }
+    if (kClamp) v = Lanes::Clamp(v, low, high);
+    Lanes::Store(out + i, v);
+  }
+  return i;
+}
+
+template <bool kLeftSum, bool kMul, bool kRightSum, bool kClamp>
+static void RunKernel(const float* const* in, float* out, size_t count,
+                      float low, float high) {
+  size_t i = 0;
+#if defined(__ARM_NEON) || defined(__SSE2__)
+  i = RunLanes<Simd, kLeftSum, kMul, kRightSum, kClamp>(in, out, 0, count,
+                                                         low, high);
+#endif
+  RunLanes<Scalar, kLeftSum, kMul, kRightSum, kClamp>(in, out, i, count, low,
+                                                      high);
+}
+
+typedef void (*Kernel)(const float* const* in, float* out, size_t count,
+                       float low, float high);
+
+template <bool kLeftSum, bool kMul, bool kRightSum>
+static Kernel KernelFor(bool clamp) {
+  return clamp ? RunKernel<kLeftSum, kMul, kRightSum, true>
+               : RunKernel<kLeftSum, kMul, kRightSum, false>;
+}
+
+static Kernel KernelFor(bool leftSum, bool mul, bool rightSum, bool clamp) {
+  if (!mul) return KernelFor<true, false, false>(clamp);
+  if (leftSum) {
+    return rightSum ? KernelFor<true, true, true>(clamp)
+                    : KernelFor<true, true, false>(clamp);
+  }
+  return rightSum ? KernelFor<false, true, true>(clamp)
+                  : KernelFor<false, true, false>(clamp);
+}
+
+static bool ActivationRange(int32_t fuseCode, float* low, float* high) {
+  const float infinity = std::numeric_limits<float>::infinity();
+  switch (fuseCode) {
+    case kFusedNone:
+      *low = -infinity;
+      *high = infinity;
+      return true;
+    case kFusedRelu:
+      *low = 0;
+      *high = infinity;
+      return true;
+    case kFusedRelu1:
+      *low = -1;
+      *high = 1;
+      return true;
+    case kFusedRelu6:
+      *low = 0;
+      *high = 6;
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+// One pass over the elements: out = in[0] + in[1], or (in[0] [+ in[1]]) *
+// (in[2] [+ in[3]]), clamped to [low, high].
+struct Model::Step {
+  Kernel kernel;
+  Source in[4];
+  Source out;
+  float low, high;
+};
+
+Model::Model() = default;
+Model::~Model() = default;
+
+bool Model::AddOperand(int32_t type, const std::vector<uint32_t>& dimensions) {
+  if (finished_ || (type != kInt32 && type != kTensorFloat32)) return false;
+  if (type == kInt32 && !dimensions.empty()) return false;
+  operands_.push_back(Operand{type, dimensions});
+  return true;
+}
+
+bool Model::SetOperandValue(uint32_t index, const void* data, size_t length) {
+  if (finished_ || index >= operands_.size() || data == nullptr) return false;
+  Operand& operand = operands_[index];
+  if (operand.type == kInt32) {
+    if (length != sizeof(operand.scalar)) return false;
+    memcpy(&operand.scalar, data, length);
+  } else {
+    size_t elements = 1;
+    for (uint32_t dimension : operand.dimensions) elements *= dimension;
+    if (operand.dimensions.empty() || length != elements * sizeof(float)) {
+      return false;
+    }
+    operand.tensor.resize(elements);
+    memcpy(operand.tensor.data(), data, length);
+  }
+  operand.hasValue = true;
+  return true;
+}
+
+bool Model::AddOperation(int32_t type, const std::vector<uint32_t>& inputs,
+                         const std::vector<uint32_t>& outputs) {
+  if (finished_ || (type != kAdd && type != kMul)) return false;
+  if (inputs.size() != 3 || outputs.size() != 1) return false;
+  for (uint32_t index : inputs) {
+    if (index >= operands_.size()) return false;
+  }
+  if (outputs[0] >= operands_.size()) return false;
+  operations_.push_back(Operation{type, inputs, outputs});
+  return true;
+}
+
+bool Model::IdentifyInputsAndOutputs(const std::vector<uint32_t>& inputs,
+                                     const std::vector<uint32_t>& outputs) {
+  if (finished_ || outputs.empty()) return false;
+  for (uint32_t index : inputs) {
+    if (index >= operands_.size()) return false;
+  }
+  for (uint32_t index : outputs) {
+    if (index >= operands_.size()) return false;
+  }
+  inputs_ = inputs;
+  outputs_ = outputs;
+  return true;
+}
+
+bool Model::Finish(const Options& options) {
+  if (finished_ || outputs_.empty()) return false;
+
+  // Every tensor has the dimensions of the first one, and every operand has
+  // one source: a value, a model input or an operation.
+  const std::vector<uint32_t>* dimensions = nullptr;
+  std::vector<int> producers(operands_.size(), -1);
+  std::vector<bool> isInput(operands_.size(), false);
+  for (const Operand& operand : operands_) {
+    if (operand.type != kTensorFloat32) continue;
+    if (dimensions == nullptr) dimensions = &operand.dimensions;
+    if (operand.dimensions != *dimensions) return false;
+  }
+  if (dimensions == nullptr || dimensions->empty()) return false;
+  elementCount_ = 1;
+  for (uint32_t dimension : *dimensions) elementCount_ *= dimension;
+  if (elementCount_ == 0) return false;
+
+  for (uint32_t index : inputs_) {
+    if (operands_[index].type != kTensorFloat32 || operands_[index].hasValue ||
+        isInput[index]) {
+      return false;
+    }
+    isInput[index] = true;
+  }
+  for (size_t i = 0; i < operations_.size(); ++i) {
+    const Operation& operation = operations_[i];
+    const uint32_t out = operation.outputs[0];
+    if (operands_[operation.inputs[0]].type != kTensorFloat32 ||
+        operands_[operation.inputs[1]].type != kTensorFloat32 ||
+        operands_[operation.inputs[2]].type != kInt32 ||
+        !operands_[operation.inputs[2]].hasValue) {
+      return false;
+    }
+    if (operands_[out].type != kTensorFloat32 || operands_[out].hasValue ||
+        isInput[out] || producers[out] >= 0) {
+      return false;
+    }
+    float low, high;
+    if (!ActivationRange(operands_[operation.inputs[2]].scalar, &low, &high)) {
+      return false;
+    }
+    producers[out] = static_cast<int>(i);
+  }
+  std::vector<bool> isOutput(operands_.size(), false);
+  for (uint32_t index : outputs_) {
+    if (producers[index] < 0 || isOutput[index]) return false;
+    isOutput[index] = true;
+  }
+
+  // The operations in an order where each one comes after the ones its
+  // inputs are from.
+  std::vector<uint32_t> order;
+  std::vector<int> state(operations_.size(), 0);  // 1: visiting, 2: ordered
+  std::function<bool(int)> visit = [&](int i) {
+    if (state[i] == 2) return true;
+    if (state[i] == 1) return false;  // a cycle
+    state[i] = 1;
+    for (int input = 0; input < 2; ++input) {
+      const uint32_t index = operations_[i].inputs[input];
+      if (producers[index] >= 0) {
+        if (!visit(producers[index])) return false;
+      } else if (!isInput[index] && !operands_[index].hasValue) {
+        return false;  // never set
+      }
+    }
+    state[i] = 2;
+    order.push_back(i);
+    return true;
+  };
+  for (size_t i = 0; i < operations_.size(); ++i) {
+    if (!visit(static_cast<int>(i))) return false;
+  }
+
+  options_ = options;
+  PlanSteps(order);
+  finished_ = true;
+  return true;
+}
+
+void Model::PlanSteps(const std::vector<uint32_t>& order) {
+  std::vector<int> uses(operands_.size(), 0);
+  std::vector<int> inputAt(operands_.size(), -1);
+  std::vector<int> outputAt(operands_.size(), -1);
+  std::vector<int> producers(operands_.size(), -1);
+  for (size_t i = 0; i < operations_.size(); ++i) {
+    uses[operations_[i].inputs[0]]++;
+    uses[operations_[i].inputs[1]]++;
+    producers[operations_[i].outputs[0]] = static_cast<int>(i);
+  }
+  for (size_t i = 0; i < inputs_.size(); ++i) inputAt[inputs_[i]] = i;
+  for (size_t i = 0; i < outputs_.size(); ++i) outputAt[outputs_[i]] = i;
+
+  // An ADD without activation, whose sum is only a MUL input, runs in the
+  // MUL: its sum is never stored.
+  std::vector<bool> folded(operations_.size(), false);
+  auto foldable = [&](uint32_t index) {
+    const int producer = producers[index];
+    return options_.fuse && producer >= 0 &&
+           operations_[producer].type == kAdd &&
+           operands_[operations_[producer].inputs[2]].scalar == kFusedNone &&
+           uses[index] == 1 && outputAt[index] < 0;
+  };
+  for (const Operation& operation : operations_) {
+    if (operation.type != kMul) continue;
+    for (int input = 0; input < 2; ++input) {
+      if (foldable(operation.inputs[input])) {
+        folded[producers[operation.inputs[input]]] = true;
+      }
+    }
+  }
+
+  std::vector<int> temporaryAt(operands_.size(), -1);
+  temporaryCount_ = 0;
+  auto source = [&](uint32_t index) {
+    if (inputAt[index] >= 0) {
+      return Source{Source::kInput, static_cast<uint32_t>(inputAt[index])};
+    }
+    if (outputAt[index] >= 0) {
+      return Source{Source::kOutput, static_cast<uint32_t>(outputAt[index])};
+    }
+    if (operands_[index].hasValue) return Source{Source::kConstant, index};
+    if (temporaryAt[index] < 0) temporaryAt[index] = temporaryCount_++;
+    const uint32_t temporary = temporaryAt[index];
+    return Source{Source::kTemporary, temporary};
+  };
+
+  steps_.clear();
+  for (uint32_t i : order) {
+    if (folded[i]) continue;
+    const Operation& operation = operations_[i];
+    Step step;
+    // in[] is in[0] + in[1] for an ADD, and the two MUL factors in in[0]
+    // (+ in[1]) and in[2] (+ in[3])
+    bool sums[2] = {operation.type == kAdd, false};
+    if (operation.type == kAdd) {
+      step.in[0] = source(operation.inputs[0]);
+      step.in[1] = source(operation.inputs[1]);
+    } else {
+      for (int input = 0; input < 2; ++input) {
+        const uint32_t index = operation.inputs[input];
+        if (producers[index] >= 0 && folded[producers[index]]) {
+          const Operation& add = operations_[producers[index]];
+          step.in[input * 2] = source(add.inputs[0]);
+          step.in[input * 2 + 1] = source(add.inputs[1]);
+          sums[input] = true;
+        } else {
+          step.in[input * 2] = source(index);
+        }
+      }
+    }
+    // inputs a step does not read point at in[0], to be valid anyway
+    for (int input = 1; input < 4; ++input) {
+      if ((input == 1 && !sums[0]) || (input == 2 && operation.type == kAdd) ||
+          (input == 3 && !sums[1])) {
+        step.in[input] = step.in[0];
+      }
+    }
+    step.out = source(operation.outputs[0]);
+    const int32_t fuseCode = operands_[operation.inputs[2]].scalar;
+    ActivationRange(fuseCode, &step.low, &step.high);
+    step.kernel = KernelFor(sums[0], operation.type == kMul, sums[1],
+                            fuseCode != kFusedNone);
+    steps_.push_back(step);
+  }
+
+  int threads = options_.threads;
+  if (threads <= 0) threads = std::thread::hardware_concurrency();
+  threads = std::max(1, std::min(threads, MAX_THREADS));
+  if (options_.fuse) {
+    temporaries_.assign(threads,
+                        std::vector<float>(temporaryCount_ * kTileElements));
+  } else {
+    temporaries_.assign(temporaryCount_, std::vector<float>(elementCount_));
+  }
+  options_.threads = threads;
+  workers_ = std::make_unique<BandWorkers>();
+}
+
+void Model::RunBand(size_t firstStep, size_t lastStep, int band, int bands) {
+  const size_t tiles = (elementCount_ + kTileElements - 1) / kTileElements;
+  const size_t firstTile = tiles * band / bands;
+  const size_t lastTile = tiles * (band + 1) / bands;
+  for (size_t tile = firstTile; tile < lastTile; ++tile) {
+    const size_t begin = tile * kTileElements;
+    const size_t count = std::min(kTileElements, elementCount_ - begin);
+    auto data = [&](Source source) -> float* {
+      switch (source.kind) {
+        case Source::kInput:
+          return const_cast<float*>(inputData_[source.index]) + begin;
+        case Source::kOutput:
+          return outputData_[source.index] + begin;
+        case Source::kConstant:
+          return operands_[source.index].tensor.data() + begin;
+        case Source::kTemporary:
+          break;
+      }
+      if (options_.fuse) {
+        return temporaries_[band].data() + source.index * kTileElements;
+      }
+      return temporaries_[source.index].data() + begin;
+    };
+    for (size_t s = firstStep; s < lastStep; ++s) {
+      const Step& step = steps_[s];
+      const float* in[4];
+      for (int i = 0; i < 4; ++i) in[i] = data(step.in[i]);
+      step.kernel(in, data(step.out), count, step.low, step.high);
+    }
+  }
+}
+
+bool Model::Compute(const std::vector<const float*>& inputs,
+                    const std::vector<float*>& outputs) {
+  if (!finished_ || inputs.size() != inputs_.size() ||
+      outputs.size() != outputs_.size()) {
+    return false;
+  }
+  for (const float* input : inputs) {
+    if (input == nullptr) return false;
+  }
+  for (float* output : outputs) {
+    if (output == nullptr) return false;
+  }
+  inputData_ = inputs.data();
+  outputData_ = outputs.data();
+
+  const size_t tiles = (elementCount_ + kTileElements - 1) / kTileElements;
+  const int bands = static_cast<int>(std::max<size_t>(
+      1, std::min({static_cast<size_t>(options_.threads), tiles,
+                   elementCount_ / kMinBandElements})));
+  if (options_.fuse) {
+    workers_->Run(bands, [this, bands](int band) {
+      RunBand(0, steps_.size(), band, bands);
+    });
+  } else {
+    for (size_t s = 0; s < steps_.size(); ++s) {
+      workers_->Run(bands, [this, s, bands](int band) {
+        RunBand(s, s + 1, band, bands);
+      });
+    }
+  }
+  inputData_ = nullptr;
+  outputData_ = nullptr;
+  return true;
+}
+
+}  // namespace nn_cpu
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NN_CPU_EXECUTOR_H
+#define NN_CPU_EXECUTOR_H
+
+/*
+ * A CPU executor for the models of the NNAPI samples: ADD and MUL of float
+ * tensors of the same dimensions, with their fused activations. A model is
+ * described as it is to ANeuralNetworksModel_*, with the same operand
+ * numbering and codes, so the samples can run it when NNAPI cannot compile
+ * theirs. Nothing here depends on Android, so it also builds on the host
+ * (see host/executor_bench.cpp).
+ *
+ * Finish() plans the model: an ADD whose only use is as a MUL input is
+ * folded into the MUL, and the elements are split into tiles, which run
+ * all the operations one after the other while their inputs are still in
+ * the cache, 4 floats at a time with NEON or SSE2. The tiles are split into
+ * bands, run by one thread per CPU.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+class BandWorkers;
+
+namespace nn_cpu {
+
+// Operand types, with the values of ANEURALNETWORKS_INT32 and
+// ANEURALNETWORKS_TENSOR_FLOAT32.
+enum : int32_t {
+  kInt32 = 1,
+  kTensorFloat32 = 3,
+};
+
+// Operations, with the values of ANEURALNETWORKS_ADD and ANEURALNETWORKS_MUL.
+// Their inputs are as in NNAPI: two tensors and an INT32 fuse code constant.
+enum : int32_t {
+  kAdd = 0,
+  kMul = 18,
+};
+
+// Fuse codes, with the values of NNAPI's FuseCode.
+enum : int32_t {
+  kFusedNone = 0,
+  kFusedRelu = 1,
+  kFusedRelu1 = 2,
+  kFusedRelu6 = 3,
+};
+
+struct Options {
+  // Up to this many threads run a Compute(), 0 for one per CPU.
+  int threads = 0;
+  // false runs each operation over whole tensors, one after the other, with
+  // nothing folded: the plain way, to compare with.
+  bool fuse = true;
+};
+
+class Model {
+ public:
+  Model();
+  ~Model();
+
+  // As ANeuralNetworksModel_addOperand() and the others of the same names,
+  // false where they return an error. Operands are numbered from 0 in the
+  // order they are added. Tensor values are copied.
+  bool AddOperand(int32_t type, const std::vector<uint32_t>& dimensions = {});
+  bool SetOperandValue(uint32_t index, const void* data, size_t length);
+  bool AddOperation(int32_t type, const std::vector<uint32_t>& inputs,
+                    const std::vector<uint32_t>& outputs);
+  bool IdentifyInputsAndOutputs(const std::vector<uint32_t>& inputs,
+                                const std::vector<uint32_t>& outputs);
+  // Checks the model can run here, and plans how. false if it cannot: an
+  // operation or operand type it does not run, tensors of different
+  // dimensions, an operand without a value or a cycle.
+  bool Finish(const Options& options = Options());
+
+  // Elements of each tensor of the finished model.
+  size_t ElementCount() const { return elementCount_; }
+
+  // Runs the finished model: inputs[i] is model input i and outputs[i]
+  // model output i, ElementCount() floats each, none of the outputs
+  // overlapping another buffer.
+  bool Compute(const std::vector<const float*>& inputs,
+               const std::vector<float*>& outputs);
+
+ private:
+  struct Operand {
+    int32_t type;
+    std::vector<uint32_t> dimensions;
+    bool hasValue = false;
+    std::vector<float> tensor;
+    int32_t scalar = 0;
+  };
+  struct Operation {
+    int32_t type;
+    std::vector<uint32_t> inputs;
+    std::vector<uint32_t> outputs;
+  };
+  // Where a step reads or writes its elements.
+  struct Source {
+    enum Kind { kInput, kOutput, kConstant, kTemporary } kind;
+    uint32_t index;  // in the model inputs, outputs, operands or temporaries
+  };
+  struct Step;
+
+  void PlanSteps(const std::vector<uint32_t>& order);
+  void RunBand(size_t firstStep, size_t lastStep, int band, int bands);
+
+  std::vector<Operand> operands_;
+  std::vector<Operation> operations_;
+  std::vector<uint32_t> inputs_;
+  std::vector<uint32_t> outputs_;
+  bool finished_ = false;
+
+  Options options_;
+  size_t elementCount_ = 0;
+  std::vector<Step> steps_;
+  uint32_t temporaryCount_ = 0;
+  // unfused: one whole tensor per temporary; fused: one tile per temporary
+  // and band
+  std::vector<std::vector<float>> temporaries_;
+  std::unique_ptr<BandWorkers> workers_;
+
+  // of the running Compute()
+  const float* const* inputData_ = nullptr;
+  float* const* outputData_ = nullptr;
+};
+
+}  // namespace nn_cpu
+
+#endif  // NN_CPU_EXECUTOR_H
@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The models of nn-samples/basic ((tensor0 + tensor1) * (tensor2 +
+ * tensor3)) and nn-samples/sequence (sumOut = sumIn + stateIn, stateOut =
+ * stateIn * ratio), described to the CPU executor as the samples describe
+ * them to NNAPI, and a model with activations and a stored intermediate.
+ * Checks their outputs against plain loops (and the basic and sequence
+ * ones against the values the samples expect), then reports the time of a
+ * Compute() for each at a few sizes: plain loops, one operation at a time
+ * (Options::fuse false), and fused on one thread and on up to threads
+ * threads (the number of CPUs by default).
+ *
+ * usage: executor_bench [milliseconds per measure [threads]]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "cpu_executor.h"
+
+// The graph of SimpleModel::CreateCompiledModel(): constants tensor0 and
+// tensor2, inputs tensor1 and tensor3.
+static bool BuildBasic(nn_cpu::Model* model,
+                       const std::vector<uint32_t>& dimensions,
+                       const std::vector<float>& tensor0,
+                       const std::vector<float>& tensor2,
+                       const nn_cpu::Options& options) {
+  const int32_t fuseNone = nn_cpu::kFusedNone;
+  return model->AddOperand(nn_cpu::kInt32) &&                      // fuse code
+         model->SetOperandValue(0, &fuseNone, sizeof(fuseNone)) &&
+         model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&  // tensor0
+         model->SetOperandValue(1, tensor0.data(),
+                                tensor0.size() * sizeof(float)) &&
+         model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&  // tensor1
+         model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&  // tensor2
+         model->SetOperandValue(3, tensor2.data(),
+                                tensor2.size() * sizeof(float)) &&
+         model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&  // tensor3
+         model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&  // 5: sum
+         model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&  // 6: sum
+         model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&  // 7: out
+         model->AddOperation(nn_cpu::kAdd, {1, 2, 0}, {5}) &&
+         model->AddOperation(nn_cpu::kAdd, {3, 4, 0}, {6}) &&
+         model->AddOperation(nn_cpu::kMul, {5, 6, 0}, {7}) &&
+         model->IdentifyInputsAndOutputs({2, 4}, {7}) &&
+         model->Finish(options);
+}
+
+// The graph of SimpleSequenceModel::CreateModel(): inputs sumIn and
+// stateIn, outputs sumOut and stateOut.
+static bool BuildSequence(nn_cpu::Model* model,
+                          const std::vector<uint32_t>& dimensions,
+                          const std::vector<float>& ratio,
+                          const nn_cpu::Options& options) {
+  const int32_t fuseNone = nn_cpu::kFusedNone;
+  return model->AddOperand(nn_cpu::kInt32) &&
+         model->SetOperandValue(0, &fuseNone, sizeof(fuseNone)) &&
+         model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&  // sumIn
+         model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&  // stateIn
+         model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&  // ratio
+         model->SetOperandValue(3, ratio.data(),
+                                ratio.size() * sizeof(float)) &&
+         model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&  // sumOut
+         model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&  // stateOut
+         model->AddOperation(nn_cpu::kAdd, {1, 2, 0}, {4}) &&
+         model->AddOperation(nn_cpu::kMul, {2, 3, 0}, {5}) &&
+         model->IdentifyInputsAndOutputs({1, 2}, {4, 5}) &&
+         model->Finish(options);
+}
+
+// relu6((a + b) * relu(a + c)), with the sum a + b also an output: nothing
+// is folded, and relu(a + c) is a temporary.
+static bool BuildActivations(nn_cpu::Model* model,
+                             const std::vector<uint32_t>& dimensions,
+                             const nn_cpu::Options& options) {
+  const int32_t codes[] = {nn_cpu::kFusedNone, nn_cpu::kFusedRelu,
+                           nn_cpu::kFusedRelu6};
+  bool built = true;
+  for (uint32_t i = 0; i < 3; ++i) {
+    built = built && model->AddOperand(nn_cpu::kInt32) &&
+            model->SetOperandValue(i, &codes[i], sizeof(codes[i]));
+  }
+  for (int i = 0; i < 6; ++i) {  // 3 to 5: a, b, c; 6 to 8: sums, product
+    built = built && model->AddOperand(nn_cpu::kTensorFloat32, dimensions);
+  }
+  return built && model->AddOperation(nn_cpu::kAdd, {3, 4, 0}, {6}) &&
+         model->AddOperation(nn_cpu::kAdd, {3, 5, 1}, {7}) &&
+         model->AddOperation(nn_cpu::kMul, {6, 7, 2}, {8}) &&
+         model->IdentifyInputsAndOutputs({3, 4, 5}, {8, 6}) &&
+         model->Finish(options);
+}
+
+// best of 3 runs of at least milliseconds each, in microseconds per call
+static double Measure(const std::function<void()>& compute,
+                      double milliseconds) {
+  double best = 1e30;
+  for (int run = 0; run < 3; run++) {
+    int calls = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::milli> time;
+    do {
+      compute();
+      calls++;
+      time = std::chrono::steady_clock::now() - start;
+    } while (time.count() < milliseconds);
+    best = std::min(best, time.count() * 1000 / calls);
+  }
+  return best;
+}
+
+static std::vector<float> Pattern(size_t count, float scale, float offset) {
+  std::vector<float> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = offset + scale * static_cast<float>((i * 7919) % 1000) / 1000;
+  }
+  return values;
+}
+
+int main(int argc, char** argv) {
+  const double milliseconds = argc > 1 ? atof(argv[1]) : 200;
+  const int cpus = std::max(1u, std::thread::hardware_concurrency());
+  const int threads = argc > 2 ? atoi(argv[2]) : cpus;
+  bool ok = true;
+
+  // The samples' own sizes and values: (1 + 0.5) * (2 + 0.5) for basic, and
+  // 1 + 0.5 + ... + 0.5^19 after 20 steps of sequence.
+  {
+    std::vector<float> half(200, 0.5f), out(200);
+    std::vector<float> input1(200, 1.0f), input2(200, 2.0f);
+    nn_cpu::Model model;
+    ok &= BuildBasic(&model, {200}, half, half, nn_cpu::Options()) &&
+          model.Compute({input1.data(), input2.data()}, {out.data()});
+    for (float value : out) ok &= value == 1.5f * 2.5f;
+    printf("basic 200: %g, expected %g\n", out[0], 1.5f * 2.5f);
+  }
+  {
+    const size_t count = 200 * 200;
+    std::vector<float> ratio(count, 0.5f);
+    std::vector<float> sumIn(count, 0), stateIn(count, 1.0f);
+    std::vector<float> sumOut(count), stateOut(count);
+    nn_cpu::Model model;
+    ok &= BuildSequence(&model, {200, 200}, ratio, nn_cpu::Options());
+    for (int step = 0; ok && step < 20; ++step) {
+      ok &= model.Compute({sumIn.data(), stateIn.data()},
+                          {sumOut.data(), stateOut.data()});
+      std::swap(sumIn, sumOut);
+      std::swap(stateIn, stateOut);
+    }
+    const double expected = (1 - std::pow(0.5, 20)) / (1 - 0.5);
+    for (float value : sumIn) ok &= std::fabs(value - expected) < 1e-6;
+    printf("sequence 200x200, 20 steps: %.7f, expected %.7f\n", sumIn[0],
+           expected);
+  }
+
+  // Each model at each size, against plain loops.
+  struct Case {
+    const char* name;
+    int inputs, outputs;
+    std::function<bool(nn_cpu::Model*, const std::vector<uint32_t>&,
+                       const nn_cpu::Options&)>
+        build;
+    // the model as plain loops, one operation at a time
+    std::function<void(const std::vector<const float*>&,
+                       const std::vector<float*>&, size_t)>
+        loops;
+  };
+  std::vector<float> constant0, constant1;
+  const Case cases[] = {
+      {"basic", 2, 1,
+       [&](nn_cpu::Model* model, const std::vector<uint32_t>& dimensions,
+           const nn_cpu::Options& options) {
+         return BuildBasic(model, dimensions, constant0, constant1, options);
+       },
+       [&](const std::vector<const float*>& in, const std::vector<float*>& out,
+           size_t count) {
+         static std::vector<float> sum0, sum1;
+         sum0.resize(count);
+         sum1.resize(count);
+         for (size_t i = 0; i < count; ++i) sum0[i] = constant0[i] + in[0][i];
+         for (size_t i = 0; i < count; ++i) sum1[i] = constant1[i] + in[1][i];
+         for (size_t i = 0; i < count; ++i) out[0][i] = sum0[i] * sum1[i];
+       }},
+      {"sequence", 2, 2,
+       [&](nn_cpu::Model* model, const std::vector<uint32_t>& dimensions,
+           const nn_cpu::Options& options) {
+         return BuildSequence(model, dimensions, constant0, options);
+       },
+       [&](const std::vector<const float*>& in, const std::vector<float*>& out,
+           size_t count) {
+         for (size_t i = 0; i < count; ++i) out[0][i] = in[0][i] + in[1][i];
+         for (size_t i = 0; i < count; ++i) {
+           out[1][i] = in[1][i] * constant0[i];
+         }
+       }},
+      {"activations", 3, 2, BuildActivations,
+       [&](const std::vector<const float*>& in, const std::vector<float*>& out,
+           size_t count) {
+         static std::vector<float> sum;
+         sum.resize(count);
+         for (size_t i = 0; i < count; ++i) out[1][i] = in[0][i] + in[1][i];
+         for (size_t i = 0; i < count; ++i) {
+           sum[i] = std::max(in[0][i] + in[2][i], 0.0f);
+         }
+         for (size_t i = 0; i < count; ++i) {
+           out[0][i] = std::min(std::max(out[1][i] * sum[i], 0.0f), 6.0f);
+         }
+       }},
+  };
+  const std::vector<std::vector<uint32_t>> sizes = {
+      {200}, {200, 200}, {1000, 1000}, {2000, 2000}};
+
+  printf("%d CPUs, up to %d threads\n", cpus, threads);
+  printf("%-12s %-10s %-18s %12s %8s\n", "model", "size", "executor",
+         "us/compute", "speedup");
+  for (const Case& test : cases) {
+    for (const std::vector<uint32_t>& dimensions : sizes) {
+      size_t count = 1;
+      for (uint32_t dimension : dimensions) count *= dimension;
+      constant0 = Pattern(count, 2, -0.5f);
+      constant1 = Pattern(count, 1, 0.25f);
+      std::vector<std::vector<float>> inputs, expected, outputs;
+      std::vector<const float*> in;
+      std::vector<float*> want, out;
+      for (int i = 0; i < test.inputs; ++i) {
+        inputs.push_back(Pattern(count, 3 + i, -1.5f + i));
+      }
+      for (int i = 0; i < test.outputs; ++i) {
+        expected.emplace_back(count);
+        outputs.emplace_back(count);
+      }
+      for (auto& input : inputs) in.push_back(input.data());
+      for (auto& output : expected) want.push_back(output.data());
+      for (auto& output : outputs) out.push_back(output.data());
+
+      char size[32];
+      snprintf(size, sizeof(size), "%u", dimensions[0]);
+      if (dimensions.size() > 1) {
+        snprintf(size, sizeof(size), "%ux%u", dimensions[0], dimensions[1]);
+      }
+      double loops = Measure([&] { test.loops(in, want, count); },
+                             milliseconds);
+      printf("%-12s %-10s %-18s %12.1f %8s\n", test.name, size, "loops",
+             loops, "");
+
+      std::vector<std::pair<const char*, nn_cpu::Options>> executors;
+      nn_cpu::Options options;
+      options.threads = 1;
+      options.fuse = false;
+      executors.emplace_back("unfused x1", options);
+      options.fuse = true;
+      executors.emplace_back("fused x1", options);
+      char threaded[32];
+      snprintf(threaded, sizeof(threaded), "fused x%d", threads);
+      if (threads > 1) {
+        options.threads = threads;
+        executors.emplace_back(threaded, options);
+      }
+      for (auto& executor : executors) {
+        nn_cpu::Model model;
+        if (!test.build(&model, dimensions, executor.second)) {
+          printf("%s: cannot build the model\n", test.name);
+          ok = false;
+          continue;
+        }
+        // the same floats as the loops: each element takes the same
+        // operations, in the same order
+        for (auto& output : outputs) std::fill(output.begin(), output.end(), 0);
+        ok &= model.Compute(in, out);
+        bool same = outputs == expected;
+        ok &= same;
+        double time = Measure([&] { model.Compute(in, out); }, milliseconds);
+        printf("%-12s %-10s %-18s %12.1f %7.2fx%s\n", test.name, size,
+               executor.first, time, loops / time,
+               same ? "" : "  DIFFERENT OUTPUT");
+      }
+    }
+  }
+  printf(ok ? "all outputs as expected\n" : "SOME OUTPUTS WRONG\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Mpixels/s of the plasma renderer at 1080p and 4K, in each pixel format,
+ * against the scalar RGB565 loop it replaced (scalar_plasma.c), on one
+ * thread and on up to the number of CPUs; and whether it draws the same
+ * pixels. The scalar loop's OPTIMIZE_WRITES stores a pair of pixels in 32
+ * bits with the first one in the high half, so little-endian CPUs swap
+ * them: they are swapped back before comparing. RGBX8888 is compared with
+ * it by cutting its channels to 5-6-5 bits, and RGBA_F16 with RGBX8888 by
+ * turning its halves back into 8 bit sRGB.
+ *
+ * usage: plasma_bench [frames]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "plasma.h"
+
+extern "C" {
+void scalar_plasma_init(void);
+void scalar_plasma_fill(const PlasmaSurface* info, double t);
+}
+
+// 8 bit sRGB of a linear half float
+static int SrgbFromHalf(uint16_t half) {
+  int exponent = (half >> 10) & 0x1f, mantissa = half & 0x3ff;
+  double linear = exponent ? std::ldexp(1024 + mantissa, exponent - 25)
+                           : std::ldexp(mantissa, -24);
+  double srgb = linear <= 0.0031308
+                    ? linear * 12.92
+                    : 1.055 * std::pow(linear, 1 / 2.4) - 0.055;
+  return static_cast<int>(std::lround(srgb * 255));
+}
+
+static uint16_t Rgb565FromRgbx(uint32_t pixel) {
+  return static_cast<uint16_t>((pixel << 8 & 0xf800) | (pixel >> 5 & 0x07e0) |
+                               (pixel >> 19 & 0x001f));
+}
+
+static uint32_t RgbxFromF16(uint64_t pixel) {
+  if (pixel >> 48 != 0x3c00) return 0;  // alpha must be 1.0
+  return SrgbFromHalf(pixel & 0xffff) |
+         SrgbFromHalf(pixel >> 16 & 0xffff) << 8 |
+         SrgbFromHalf(pixel >> 32 & 0xffff) << 16 | 0xff000000u;
+}
+
+typedef void (*FillFunc)(const PlasmaSurface* surface, double t);
+
+// best of 3 runs of frames frames, in Mpixels/s
+static double Measure(FillFunc fill, const PlasmaSurface& surface,
+                      uint32_t frames) {
+  double best = 0.0;
+  for (int run = 0; run < 3; run++) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frames; frame++) {
+      fill(&surface, frame * 16.7);
+    }
+    std::chrono::duration<double> time =
+        std::chrono::steady_clock::now() - start;
+    best = std::max(best, static_cast<double>(surface.width) *
+                              surface.height * frames / time.count() / 1e6);
+  }
+  return best;
+}
+
+int main(int argc, char** argv) {
+  uint32_t frames = argc > 1 ? atoi(argv[1]) : 20;
+  scalar_plasma_init();
+  plasma_init();
+
+  const int32_t sizes[][2] = {{1920, 1080}, {3840, 2160}};
+  const struct {
+    PlasmaFormat format;
+    const char* name;
+    int32_t bytes;
+  } formats[] = {{PLASMA_FORMAT_RGB565, "RGB565", 2},
+                 {PLASMA_FORMAT_RGBX8888, "RGBX8888", 4},
+                 {PLASMA_FORMAT_RGBA_F16, "RGBA_F16", 8}};
+  int cpus = std::max(1u, std::thread::hardware_concurrency());
+  printf("%d CPUs, %u frames\n", cpus, frames);
+  printf("%-10s %-9s %-14s %10s %8s\n", "size", "format", "renderer",
+         "Mpixels/s", "speedup");
+  for (auto& size : sizes) {
+    PlasmaSurface surface;
+    surface.width = size[0];
+    surface.height = size[1];
+    size_t count = static_cast<size_t>(surface.width) * surface.height;
+    std::vector<uint16_t> reference(count), rgb565(count);
+    std::vector<uint32_t> rgbx(count);
+    std::vector<uint64_t> f16(count);
+
+    // same pixels, at a few times
+    bool same[3] = {true, true, true};
+    plasma_set_threads(cpus);
+    for (double t : {0.0, 1234.5, 98765.0}) {
+      surface.pixels = reference.data();
+      surface.stride = surface.width * 2;
+      scalar_plasma_fill(&surface, t);
+      for (size_t idx = 0; idx + 1 < count; idx += 2) {
+        std::swap(reference[idx], reference[idx + 1]);
+      }
+      surface.format = PLASMA_FORMAT_RGB565;
+      surface.pixels = rgb565.data();
+      plasma_fill(&surface, t);
+      surface.format = PLASMA_FORMAT_RGBX8888;
+      surface.pixels = rgbx.data();
+      surface.stride = surface.width * 4;
+      plasma_fill(&surface, t);
+      surface.format = PLASMA_FORMAT_RGBA_F16;
+      surface.pixels = f16.data();
+      surface.stride = surface.width * 8;
+      plasma_fill(&surface, t);
+      same[0] &= reference == rgb565;
+      for (size_t idx = 0; idx < count; idx++) {
+        same[1] &= Rgb565FromRgbx(rgbx[idx]) == reference[idx];
+        same[2] &= RgbxFromF16(f16[idx]) == rgbx[idx];
+      }
+    }
+
+    char name[16];
+    snprintf(name, sizeof(name), "%dx%d", surface.width, surface.height);
+    surface.pixels = reference.data();
+    surface.stride = surface.width * 2;
+    double scalar = Measure(scalar_plasma_fill, surface, frames);
+    printf("%-10s %-9s %-14s %10.1f %8s\n", name, "RGB565", "scalar", scalar,
+           "1.00");
+    for (int format = 0; format < 3; format++) {
+      surface.format = formats[format].format;
+      surface.stride = surface.width * formats[format].bytes;
+      surface.pixels = format == 0   ? static_cast<void*>(rgb565.data())
+                       : format == 1 ? static_cast<void*>(rgbx.data())
+                                     : static_cast<void*>(f16.data());
+      for (int threads = 1; threads <= cpus; threads *= 2) {
+        plasma_set_threads(threads);
+        double simd = Measure(plasma_fill, surface, frames);
+        char renderer[16];
+        snprintf(renderer, sizeof(renderer), "simd x%d", threads);
+        printf("%-10s %-9s %-14s %10.1f %8.2f%s\n", name,
+               formats[format].name, renderer, simd, simd / scalar,
+               same[format] ? "" : "  DIFFERENT PIXELS");
+        if (threads < cpus && threads * 2 > cpus) threads = cpus / 2;
+      }
+    }
+  }
+  return 0;
+}
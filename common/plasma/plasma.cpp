@@ -0,0 +1,429 @@
+/*
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "plasma.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "band_workers.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* We're going to perform computations for every pixel of the target
+ * bitmap. floating-point operations are very slow on ARMv5, and not
+ * too bad on ARMv7 with the exception of trigonometric functions.
+ *
+ * For better performance on all platforms, we're going to use fixed-point
+ * arithmetic and all kinds of tricks
+ */
+
+typedef int32_t Fixed;
+
+#define FIXED_BITS 16
+#define FIXED_ONE (1 << FIXED_BITS)
+
+#define FIXED_FROM_FLOAT(x) ((Fixed)((x)*FIXED_ONE))
+
+#define FIXED_FRAC(x) ((x) & ((1 << FIXED_BITS) - 1))
+
+typedef int32_t Angle;
+
+#define ANGLE_BITS 9
+
+#if ANGLE_BITS < 8
+#error ANGLE_BITS must be at least 8
+#endif
+
+#define ANGLE_2PI (1 << ANGLE_BITS)
+#define ANGLE_PI (1 << (ANGLE_BITS - 1))
+
+#if ANGLE_BITS <= FIXED_BITS
+#define ANGLE_FROM_FIXED(x) (Angle)((x) >> (FIXED_BITS - ANGLE_BITS))
+#else
+#define ANGLE_FROM_FIXED(x) (Angle)((x) << (ANGLE_BITS - FIXED_BITS))
+#endif
+
+static Fixed angle_sin_tab[ANGLE_2PI + 1];
+
+static void init_angles(void) {
+  int nn;
+  for (nn = 0; nn < ANGLE_2PI + 1; nn++) {
+    double radians = nn * M_PI / ANGLE_PI;
+    angle_sin_tab[nn] = FIXED_FROM_FLOAT(sin(radians));
+  }
+}
+
+static inline Fixed angle_sin(Angle a) {
+  return angle_sin_tab[(uint32_t)a & (ANGLE_2PI - 1)];
+}
+
+static inline Fixed fixed_sin(Fixed f) {
+  return angle_sin(ANGLE_FROM_FIXED(f));
+}
+
+/* Color palette used for rendering the plasma */
+#define PALETTE_BITS 8
+#define PALETTE_SIZE (1 << PALETTE_BITS)
+
+#if PALETTE_BITS > FIXED_BITS
+#error PALETTE_BITS must be smaller than FIXED_BITS
+#endif
+
+/*
+ * The pixel formats, each with its pixel type and the pixel of an sRGB
+ * color (8 bits a channel). Pixels are stored as one integer, which is
+ * the memory order of the Android formats on little-endian CPUs (all of
+ * Android's ABIs).
+ */
+struct Rgb565 {
+  typedef uint16_t Pixel;
+  static constexpr Pixel make(int red, int green, int blue) {
+    return (Pixel)(((red << 8) & 0xf800) | ((green << 3) & 0x07e0) |
+                   ((blue >> 3) & 0x001f));
+  }
+};
+
+struct Rgbx8888 {
+  typedef uint32_t Pixel;
+  static constexpr Pixel make(int red, int green, int blue) {
+    return (Pixel)red | (Pixel)green << 8 | (Pixel)blue << 16 | 0xff000000u;
+  }
+};
+
+/*
+ * <cmath> isn't constexpr: log() and exp() for the F16 palette. log()
+ * halves or doubles x into [0.5, 1), where ln(x) = 2 atanh((x - 1) /
+ * (x + 1)) converges fast; exp(), for x <= 0, sums the series of x / 1024
+ * and squares it 10 times.
+ */
+static constexpr double const_log(double x) {
+  int exponent = 0;
+  for (; x < 0.5; x *= 2) exponent--;
+  for (; x >= 1.0; x /= 2) exponent++;
+  double z = (x - 1) / (x + 1), term = z, sum = 0;
+  for (int nn = 1; nn < 40; nn += 2, term *= z * z) sum += term / nn;
+  return 2 * sum + exponent * 0.6931471805599453;
+}
+
+static constexpr double const_exp(double x) {
+  double term = 1, sum = 1;
+  for (int nn = 1; nn < 20; nn++) {
+    term *= x / 1024 / nn;
+    sum += term;
+  }
+  for (int nn = 0; nn < 10; nn++) sum *= sum;
+  return sum;
+}
+
+/* IEEE half float of x, 0 <= x < 65504, rounded to nearest */
+static constexpr uint16_t const_half(double x) {
+  if (x <= 0) return 0;
+  int exponent = 0;
+  double scale = 1;
+  for (; x < scale && exponent > -14; exponent--) scale /= 2;
+  for (; x >= 2 * scale; exponent++) scale *= 2;
+  if (x < scale) {  // subnormal: in steps of 2^-24
+    return (uint16_t)(x * 16777216.0 + 0.5);
+  }
+  int mantissa = (int)((x / scale - 1) * 1024 + 0.5);
+  if (mantissa == 1024) {
+    mantissa = 0;
+    exponent++;
+  }
+  return (uint16_t)((exponent + 15) << 10 | mantissa);
+}
+
+/* linear half float of an 8 bit sRGB channel, for the 256 channel values */
+struct LinearHalves {
+  uint16_t halves[256];
+  constexpr LinearHalves() : halves() {
+    for (int nn = 0; nn < 256; nn++) {
+      double srgb = nn / 255.0;
+      double linear =
+          srgb <= 0.04045 ? srgb / 12.92
+                          : const_exp(2.4 * const_log((srgb + 0.055) / 1.055));
+      halves[nn] = const_half(linear);
+    }
+  }
+};
+static constexpr LinearHalves linear_halves;
+
+struct RgbaF16 {
+  typedef uint64_t Pixel;
+  static constexpr Pixel make(int red, int green, int blue) {
+    return (Pixel)linear_halves.halves[red] |
+           (Pixel)linear_halves.halves[green] << 16 |
+           (Pixel)linear_halves.halves[blue] << 32 |
+           (Pixel)const_half(1.0) << 48;
+  }
+};
+
+/* The palette of a format, built by the compiler */
+template <typename Format>
+struct Palette {
+  typename Format::Pixel colors[PALETTE_SIZE];
+
+  constexpr Palette() : colors() {
+    int nn = 0, mm = 0;
+    /* fun with colors */
+    for (nn = 0; nn < PALETTE_SIZE / 4; nn++) {
+      int jj = (nn - mm) * 4 * 255 / PALETTE_SIZE;
+      colors[nn] = Format::make(255, jj, 255 - jj);
+    }
+
+    for (mm = nn; nn < PALETTE_SIZE / 2; nn++) {
+      int jj = (nn - mm) * 4 * 255 / PALETTE_SIZE;
+      colors[nn] = Format::make(255 - jj, 255, jj);
+    }
+
+    for (mm = nn; nn < PALETTE_SIZE * 3 / 4; nn++) {
+      int jj = (nn - mm) * 4 * 255 / PALETTE_SIZE;
+      colors[nn] = Format::make(0, 255 - jj, 255);
+    }
+
+    for (mm = nn; nn < PALETTE_SIZE; nn++) {
+      int jj = (nn - mm) * 4 * 255 / PALETTE_SIZE;
+      colors[nn] = Format::make(jj, 0, 255);
+    }
+  }
+};
+
+template <typename Format>
+constexpr Palette<Format> palette{};
+
+template <typename Format>
+static inline typename Format::Pixel palette_from_fixed(Fixed x) {
+  if (x < 0) x = -x;
+  if (x >= FIXED_ONE) x = FIXED_ONE - 1;
+  int idx = FIXED_FRAC(x) >> (FIXED_BITS - PALETTE_BITS);
+  return palette<Format>.colors[idx & (PALETTE_SIZE - 1)];
+}
+
+void plasma_init(void) { init_angles(); }
+
+#define YT1_INCR FIXED_FROM_FLOAT(1 / 100.)
+#define YT2_INCR FIXED_FROM_FLOAT(1 / 163.)
+#define XT1_INCR FIXED_FROM_FLOAT(1 / 173.)
+#define XT2_INCR FIXED_FROM_FLOAT(1 / 242.)
+
+/*
+ * A pixel is palette_from_fixed((row term + column term) / 4), where the
+ * column term, fixed_sin(xt1) + fixed_sin(xt2), is the same on every row:
+ * it is computed once a frame, into column_sin, instead of twice a pixel.
+ * Then a row is adds, shifts and a palette read: palette_indices() works
+ * out 8 indices at a time in SIMD registers, and store_pixels() reads
+ * their colors and stores them 16 bytes at a time: one store of RGB565,
+ * two of RGBX8888, four of RGBA_F16. NEON's TBL only looks up 64 bytes per
+ * instruction, and the palettes (512 bytes and more) don't fit in
+ * registers, so a lookup per lane is cheaper (SSE2 has nothing better).
+ */
+#if defined(__ARM_NEON)
+typedef uint16x8_t Indices;
+
+static inline Indices palette_indices(const Fixed* column_sin, Fixed base) {
+  const int32x4_t vbase = vdupq_n_s32(base);
+  const int32x4_t vmax = vdupq_n_s32(FIXED_ONE - 1);
+  int32x4_t i1 = vaddq_s32(vld1q_s32(column_sin), vbase);
+  int32x4_t i2 = vaddq_s32(vld1q_s32(column_sin + 4), vbase);
+  i1 = vminq_s32(vabsq_s32(vshrq_n_s32(i1, 2)), vmax);
+  i2 = vminq_s32(vabsq_s32(vshrq_n_s32(i2, 2)), vmax);
+  return vcombine_u16(
+      vshrn_n_u32(vreinterpretq_u32_s32(i1), FIXED_BITS - PALETTE_BITS),
+      vshrn_n_u32(vreinterpretq_u32_s32(i2), FIXED_BITS - PALETTE_BITS));
+}
+
+static inline void store_pixels(uint16_t* line, Indices idx, Rgb565) {
+  const uint16_t* colors = palette<Rgb565>.colors;
+  uint16_t lanes[8];
+  vst1q_u16(lanes, idx);
+  uint16x8_t pixels = vld1q_dup_u16(&colors[lanes[0]]);
+  pixels = vld1q_lane_u16(&colors[lanes[1]], pixels, 1);
+  pixels = vld1q_lane_u16(&colors[lanes[2]], pixels, 2);
+  pixels = vld1q_lane_u16(&colors[lanes[3]], pixels, 3);
+  pixels = vld1q_lane_u16(&colors[lanes[4]], pixels, 4);
+  pixels = vld1q_lane_u16(&colors[lanes[5]], pixels, 5);
+  pixels = vld1q_lane_u16(&colors[lanes[6]], pixels, 6);
+  pixels = vld1q_lane_u16(&colors[lanes[7]], pixels, 7);
+  vst1q_u16(line, pixels);
+}
+
+static inline void store_pixels(uint32_t* line, Indices idx, Rgbx8888) {
+  const uint32_t* colors = palette<Rgbx8888>.colors;
+  uint16_t lanes[8];
+  vst1q_u16(lanes, idx);
+  for (int half = 0; half < 8; half += 4) {
+    uint32x4_t pixels = vld1q_dup_u32(&colors[lanes[half]]);
+    pixels = vld1q_lane_u32(&colors[lanes[half + 1]], pixels, 1);
+    pixels = vld1q_lane_u32(&colors[lanes[half + 2]], pixels, 2);
+    pixels = vld1q_lane_u32(&colors[lanes[half + 3]], pixels, 3);
+    vst1q_u32(line + half, pixels);
+  }
+}
+
+static inline void store_pixels(uint64_t* line, Indices idx, RgbaF16) {
+  const uint64_t* colors = palette<RgbaF16>.colors;
+  uint16_t lanes[8];
+  vst1q_u16(lanes, idx);
+  for (int pair = 0; pair < 8; pair += 2) {
+    vst1q_u64(line + pair, vcombine_u64(vld1_u64(&colors[lanes[pair]]),
+                                        vld1_u64(&colors[lanes[pair + 1]])));
+  }
+}
+#elif defined(__SSE2__)
+typedef __m128i Indices;
+
+static inline Indices palette_indices(const Fixed* column_sin, Fixed base) {
+  const __m128i vbase = _mm_set1_epi32(base);
+  __m128i i1 =
+      _mm_add_epi32(_mm_loadu_si128((const __m128i*)column_sin), vbase);
+  __m128i i2 =
+      _mm_add_epi32(_mm_loadu_si128((const __m128i*)(column_sin + 4)), vbase);
+  i1 = _mm_srai_epi32(i1, 2);
+  i2 = _mm_srai_epi32(i2, 2);
+  // abs() without SSSE3
+  __m128i s1 = _mm_srai_epi32(i1, 31), s2 = _mm_srai_epi32(i2, 31);
+  i1 = _mm_sub_epi32(_mm_xor_si128(i1, s1), s1);
+  i2 = _mm_sub_epi32(_mm_xor_si128(i2, s2), s2);
+  // the sines are within +-FIXED_ONE, so |ii / 4| <= FIXED_ONE: take one
+  // off the index of FIXED_ONE instead of clamping (no pminsd in SSE2)
+  i1 = _mm_sub_epi32(_mm_srli_epi32(i1, FIXED_BITS - PALETTE_BITS),
+                     _mm_srli_epi32(i1, FIXED_BITS));
+  i2 = _mm_sub_epi32(_mm_srli_epi32(i2, FIXED_BITS - PALETTE_BITS),
+                     _mm_srli_epi32(i2, FIXED_BITS));
+  return _mm_packs_epi32(i1, i2);
+}
+
+#define LANE(n) _mm_extract_epi16(idx, n)
+
+static inline void store_pixels(uint16_t* line, Indices idx, Rgb565) {
+  const uint16_t* colors = palette<Rgb565>.colors;
+  __m128i pixels = _mm_setr_epi16(
+      colors[LANE(0)], colors[LANE(1)], colors[LANE(2)], colors[LANE(3)],
+      colors[LANE(4)], colors[LANE(5)], colors[LANE(6)], colors[LANE(7)]);
+  _mm_storeu_si128((__m128i*)line, pixels);
+}
+
+static inline void store_pixels(uint32_t* line, Indices idx, Rgbx8888) {
+  const uint32_t* colors = palette<Rgbx8888>.colors;
+  _mm_storeu_si128((__m128i*)line,
+                   _mm_setr_epi32(colors[LANE(0)], colors[LANE(1)],
+                                  colors[LANE(2)], colors[LANE(3)]));
+  _mm_storeu_si128((__m128i*)(line + 4),
+                   _mm_setr_epi32(colors[LANE(4)], colors[LANE(5)],
+                                  colors[LANE(6)], colors[LANE(7)]));
+}
+
+static inline __m128i load_pair(const uint64_t* colors, int first,
+                                int second) {
+  return _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)&colors[first]),
+                            _mm_loadl_epi64((const __m128i*)&colors[second]));
+}
+
+static inline void store_pixels(uint64_t* line, Indices idx, RgbaF16) {
+  const uint64_t* colors = palette<RgbaF16>.colors;
+  _mm_storeu_si128((__m128i*)line, load_pair(colors, LANE(0), LANE(1)));
+  _mm_storeu_si128((__m128i*)(line + 2), load_pair(colors, LANE(2), LANE(3)));
+  _mm_storeu_si128((__m128i*)(line + 4), load_pair(colors, LANE(4), LANE(5)));
+  _mm_storeu_si128((__m128i*)(line + 6), load_pair(colors, LANE(6), LANE(7)));
+}
+
+#undef LANE
+#endif
+
+template <typename Format>
+static void fill_row(void* pixels, const Fixed* column_sin, int32_t width,
+                     Fixed base) {
+  typename Format::Pixel* line = (typename Format::Pixel*)pixels;
+  int32_t xx = 0;
+#if defined(__ARM_NEON) || defined(__SSE2__)
+  for (; xx + 8 <= width; xx += 8) {
+    store_pixels(line + xx, palette_indices(column_sin + xx, base), Format());
+  }
+#endif
+  for (; xx < width; xx++) {
+    line[xx] = palette_from_fixed<Format>((base + column_sin[xx]) >> 2);
+  }
+}
+
+typedef void (*FillRowFunc)(void* pixels, const Fixed* column_sin,
+                            int32_t width, Fixed base);
+
+static FillRowFunc row_filler(PlasmaFormat format) {
+  switch (format) {
+    case PLASMA_FORMAT_RGB565:
+      return fill_row<Rgb565>;
+    case PLASMA_FORMAT_RGBX8888:
+      return fill_row<Rgbx8888>;
+    case PLASMA_FORMAT_RGBA_F16:
+      return fill_row<RgbaF16>;
+  }
+  return nullptr;
+}
+
+static int thread_count;
+
+void plasma_set_threads(int count) {
+  thread_count = std::min(std::max(count, 0), PLASMA_MAX_THREADS);
+}
+
+void plasma_fill(const PlasmaSurface* surface, double t) {
+  static BandWorkers workers;
+  static std::vector<Fixed> column_sin;
+
+  FillRowFunc fill = row_filler(surface->format);
+  if (!fill) return;
+
+  Fixed yt1 = FIXED_FROM_FLOAT(t / 1230.);
+  Fixed yt2 = yt1;
+  Fixed xt1 = FIXED_FROM_FLOAT(t / 3000.);
+  Fixed xt2 = xt1;
+
+  column_sin.resize(surface->width);
+  for (int32_t xx = 0; xx < surface->width; xx++) {
+    column_sin[xx] = fixed_sin(xt1) + fixed_sin(xt2);
+    xt1 += XT1_INCR;
+    xt2 += XT2_INCR;
+  }
+
+  int bands = thread_count;
+  if (!bands) {
+    bands = std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                     PLASMA_MAX_THREADS);
+  }
+  // a band of fewer than 16 rows is not worth waking a thread for
+  bands = std::max(1, std::min(bands, surface->height / 16));
+
+  const Fixed* columns = column_sin.data();
+  workers.Run(bands, [=](int band) {
+    int32_t first = surface->height * band / bands;
+    int32_t last = surface->height * (band + 1) / bands;
+    uint8_t* pixels = (uint8_t*)surface->pixels + first * surface->stride;
+    for (int32_t yy = first; yy < last; yy++) {
+      Fixed base = fixed_sin(yt1 + yy * YT1_INCR) +
+                   fixed_sin(yt2 + yy * YT2_INCR);
+      fill(pixels, columns, surface->width, base);
+      pixels += surface->stride;
+    }
+  });
+}
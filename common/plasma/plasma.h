@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PLASMA_H
+#define PLASMA_H
+
+/*
+ * The plasma renderer of bitmap-plasma and native-plasma: fixed-point
+ * plasma, 8 pixels at a time with NEON or SSE2, rows split into bands
+ * drawn on worker threads, in the pixel format of the window or bitmap.
+ * Nothing here depends on Android, so it also builds on the host (see
+ * host/plasma_bench.cpp).
+ */
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Pixel formats plasma_fill() draws in, with one palette each, in the
+ * memory order of Android's window and bitmap formats:
+ *   RGB565:   16 bits, WINDOW_FORMAT_RGB_565, ANDROID_BITMAP_FORMAT_RGB_565
+ *   RGBX8888: R, G, B bytes then 255, which also makes it opaque RGBA_8888
+ *   RGBA_F16: R, G, B, A half floats, linear (an F16 bitmap's color space)
+ */
+typedef enum {
+  PLASMA_FORMAT_RGB565,
+  PLASMA_FORMAT_RGBX8888,
+  PLASMA_FORMAT_RGBA_F16,
+} PlasmaFormat;
+
+/* Pixels to draw into */
+typedef struct {
+  void* pixels;
+  int32_t width;
+  int32_t height;
+  int32_t stride; /* in bytes */
+  PlasmaFormat format;
+} PlasmaSurface;
+
+/* Builds the tables; call once before plasma_fill(). */
+void plasma_init(void);
+
+/*
+ * Number of threads drawing a frame, the caller's included; 0 (the
+ * default) for one per CPU, up to PLASMA_MAX_THREADS.
+ */
+#define PLASMA_MAX_THREADS 8
+void plasma_set_threads(int count);
+
+/*
+ * Draws the plasma at time t (ms), returning when it is all drawn; from one
+ * thread at a time. A format that isn't a PlasmaFormat draws nothing.
+ */
+void plasma_fill(const PlasmaSurface* surface, double t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PLASMA_H */
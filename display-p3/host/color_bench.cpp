@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures TransformColorSpace() on a 12 MP (4032 x 3024) RGBA8 image, for
+ * the conversions AssetTexture does, against the original three pass
+ * implementation (checking that both produce the same bytes), and the high
+ * precision path, TransformColorSpaceHighPrecision(), to RGBA8 and RGBA16F.
+ * The app converts with the high precision path on every display, so its
+ * RGBA8 time over the fused one ("hp8/fused") should stay at 1.0 or below.
+ * Then the sRGB view of a P3 image: two 8 bit conversions through linear
+ * sRGB (what AssetTexture used to do) against one clipping high precision
+ * conversion.
+ * Last, the per image cost of small (64 x 64) conversions, which is mostly
+ * setting up the tables: the three pass implementation builds them for every
+ * image, the others get them from the transform cache.
+ *
+ * usage: color_bench [iterations]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "ColorSpaceTransform.h"
+
+#define IMAGE_WIDTH 4032
+#define IMAGE_HEIGHT 3024
+#define THUMBNAIL_SIZE 64
+#define THUMBNAIL_COUNT 2000
+
+static double Seconds(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+// gradients (every value of every channel) plus some noise
+static void FillImage(std::vector<uint8_t>& img) {
+  uint32_t seed = 1;
+  for (uint32_t y = 0; y < IMAGE_HEIGHT; y++) {
+    for (uint32_t x = 0; x < IMAGE_WIDTH; x++) {
+      uint8_t* p = &img[(y * IMAGE_WIDTH + x) * 4];
+      seed = seed * 1664525 + 1013904223;
+      p[0] = static_cast<uint8_t>(x);
+      p[1] = static_cast<uint8_t>(y);
+      p[2] = static_cast<uint8_t>(seed >> 24);
+      p[3] = static_cast<uint8_t>(x + y);
+    }
+  }
+}
+
+struct BENCH_CASE {
+  const char* name_;
+  float srcGamma_;
+  NPM_TYPE srcNPM_;
+  float dstGamma_;
+  NPM_TYPE dstNPM_;
+};
+
+// the conversions AssetTexture::CreateGLTextures() does
+static const BENCH_CASE cases[] = {
+    {"P3 -> sRGB", DEFAULT_P3_IMAGE_GAMMA, P3_D65, DEFAULT_DISPLAY_GAMMA,
+     SRGB_D65_INV},
+    {"P3 -> linear sRGB", DEFAULT_P3_IMAGE_GAMMA, P3_D65, 0.0f, SRGB_D65_INV},
+    {"linear sRGB -> P3", 0.0f, SRGB_D65, DEFAULT_DISPLAY_GAMMA, P3_D65_INV},
+};
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 5;
+  size_t bytes = IMAGE_WIDTH * IMAGE_HEIGHT * 4;
+  std::vector<uint8_t> image(bytes), fused(bytes), multiPass(bytes);
+  std::vector<uint8_t> precise(bytes * 2);
+  FillImage(image);
+  double mpix = IMAGE_WIDTH * IMAGE_HEIGHT / 1e6;
+
+  printf("%d x %d (%.1f MP), %d iterations\n", IMAGE_WIDTH, IMAGE_HEIGHT, mpix,
+         iterations);
+  printf("%-20s %10s %10s %8s %10s %10s %10s\n", "", "3-pass ms", "fused ms",
+         "speedup", "hp8 ms", "hp8/fused", "hp16f ms");
+  for (const BENCH_CASE& c : cases) {
+    IMAGE_FORMAT src{image.data(), IMAGE_WIDTH, IMAGE_HEIGHT, c.srcGamma_,
+                     GetTransformNPM(c.srcNPM_)};
+    IMAGE_FORMAT dst{multiPass.data(), IMAGE_WIDTH, IMAGE_HEIGHT, c.dstGamma_,
+                     GetTransformNPM(c.dstNPM_)};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      TransformColorSpaceMultiPass(dst, src);
+    }
+    double multiPassTime = Seconds(start) / iterations;
+
+    dst.buf_ = fused.data();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      TransformColorSpace(dst, src);
+    }
+    double fusedTime = Seconds(start) / iterations;
+
+    if (memcmp(fused.data(), multiPass.data(), bytes)) {
+      printf("ERROR: %s: fused and 3-pass results differ!\n", c.name_);
+      return 1;
+    }
+
+    // high precision, to RGBA8 and to RGBA16F
+    double preciseTime[2];
+    PIXEL_FORMAT formats[2] = {PIXEL_RGBA8, PIXEL_RGBA16F};
+    dst.buf_ = precise.data();
+    for (int f = 0; f < 2; f++) {
+      dst.format_ = formats[f];
+      start = std::chrono::steady_clock::now();
+      for (int i = 0; i < iterations; i++) {
+        TransformColorSpaceHighPrecision(dst, src);
+      }
+      preciseTime[f] = Seconds(start) / iterations;
+    }
+    printf("%-20s %10.1f %10.1f %7.1fx %10.1f %10.2f %10.1f\n", c.name_,
+           multiPassTime * 1e3, fusedTime * 1e3, multiPassTime / fusedTime,
+           preciseTime[0] * 1e3, preciseTime[0] / fusedTime,
+           preciseTime[1] * 1e3);
+  }
+
+  // P3 -> sRGB gamut -> P3
+  IMAGE_FORMAT p3{image.data(), IMAGE_WIDTH, IMAGE_HEIGHT,
+                  DEFAULT_P3_IMAGE_GAMMA, GetTransformNPM(P3_D65)};
+  IMAGE_FORMAT linearSRGB{multiPass.data(), IMAGE_WIDTH, IMAGE_HEIGHT, 0.0f,
+                          GetTransformNPM(SRGB_D65_INV)};
+  IMAGE_FORMAT p3View{fused.data(), IMAGE_WIDTH, IMAGE_HEIGHT,
+                      DEFAULT_DISPLAY_GAMMA, GetTransformNPM(P3_D65_INV)};
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    TransformColorSpace(linearSRGB, p3);
+    linearSRGB.npm_ = GetTransformNPM(SRGB_D65);
+    TransformColorSpace(p3View, linearSRGB);
+    linearSRGB.npm_ = GetTransformNPM(SRGB_D65_INV);
+  }
+  double twoPassTime = Seconds(start) / iterations;
+  p3View.buf_ = precise.data();
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    TransformColorSpaceHighPrecision(p3View, p3, GetTransformNPM(SRGB_D65));
+  }
+  double clipTime = Seconds(start) / iterations;
+  printf("sRGB view of P3:     2 x 8 bit %.1f ms, clipping hp8 %.1f ms\n",
+         twoPassTime * 1e3, clipTime * 1e3);
+
+  // small images, where setting up is most of the work
+  IMAGE_FORMAT thumbSrc{image.data(), THUMBNAIL_SIZE, THUMBNAIL_SIZE,
+                        DEFAULT_P3_IMAGE_GAMMA, GetTransformNPM(P3_D65)};
+  IMAGE_FORMAT thumbDst{fused.data(), THUMBNAIL_SIZE, THUMBNAIL_SIZE,
+                        DEFAULT_DISPLAY_GAMMA, GetTransformNPM(SRGB_D65_INV)};
+  bool (*transforms[])(IMAGE_FORMAT&, IMAGE_FORMAT&) = {
+      TransformColorSpaceMultiPass, TransformColorSpace,
+      [](IMAGE_FORMAT& dst, IMAGE_FORMAT& src) {
+        return TransformColorSpaceHighPrecision(dst, src);
+      }};
+  double thumbTime[3];
+  for (int t = 0; t < 3; t++) {
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < THUMBNAIL_COUNT; i++) {
+      transforms[t](thumbDst, thumbSrc);
+    }
+    thumbTime[t] = Seconds(start) / THUMBNAIL_COUNT;
+  }
+  printf("%dx%d P3 -> sRGB:  3-pass %.1f us, fused %.1f us, hp8 %.1f us\n",
+         THUMBNAIL_SIZE, THUMBNAIL_SIZE, thumbTime[0] * 1e6,
+         thumbTime[1] * 1e6, thumbTime[2] * 1e6);
+  return 0;
+}
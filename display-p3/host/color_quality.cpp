@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures how far the 8 bit TransformColorSpace() and the high precision
+ * TransformColorSpaceHighPrecision() are from the exact (double precision)
+ * transform, over every RGB color: error in output code values, and CIE76
+ * delta E in Lab (D65 white). Then banding on a dark gray ramp: how many of
+ * the ramp's steps survive, and the largest jump between neighbors.
+ * The sRGB view of a P3 image is measured both ways AssetTexture has done
+ * it: two 8 bit conversions through linear sRGB, and one clipping high
+ * precision conversion.
+ *
+ * usage: color_quality
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "ColorSpaceTransform.h"
+
+#define CUBE_SIDE 4096  // 2^24 colors, as a 4096 x 4096 image
+#define RAMP_LENGTH 64  // dark ramp: gray codes 0 -- 63
+
+/*
+ * The curves of ColorSpaceTransform.cpp, in double precision
+ */
+static double Decode(double val, float gamma) {
+  if (gamma == 0.0f) return val;
+  if (val < 0.04045) return val / 12.92;
+  return std::pow((val + 0.055) / 1.055, 1.0 / gamma);
+}
+
+static double Encode(double val, float gamma) {
+  if (gamma == 0.0f) return val;
+  if (val < 0.0031308) return val * 12.92;
+  return 1.055 * std::pow(val, static_cast<double>(gamma)) - 0.055;
+}
+
+static double Clamp(double val) {
+  return val < 0.0 ? 0.0 : (val > 1.0 ? 1.0 : val);
+}
+
+struct MATRIX {
+  double m_[3][3];
+};
+
+static MATRIX ToMatrix(const mathfu::mat3& m) {
+  MATRIX out;
+  for (int r = 0; r < 3; r++) {
+    for (int c = 0; c < 3; c++) out.m_[r][c] = m(r, c);
+  }
+  return out;
+}
+
+static void Multiply(const MATRIX& m, const double* in, double* out) {
+  for (int r = 0; r < 3; r++) {
+    out[r] = m.m_[r][0] * in[0] + m.m_[r][1] * in[1] + m.m_[r][2] * in[2];
+  }
+}
+
+struct QUALITY_CASE {
+  const char* name_;
+  float srcGamma_;
+  NPM_TYPE srcNPM_;
+  float dstGamma_;
+  NPM_TYPE dstNPM_;
+  bool clipToSRGB_;  // the sRGB view of a P3 image
+};
+
+static const QUALITY_CASE cases[] = {
+    {"P3 -> sRGB", DEFAULT_P3_IMAGE_GAMMA, P3_D65, DEFAULT_DISPLAY_GAMMA,
+     SRGB_D65_INV, false},
+    {"linear sRGB -> P3", 0.0f, SRGB_D65, DEFAULT_DISPLAY_GAMMA, P3_D65_INV,
+     false},
+    {"P3 -> sRGB view", DEFAULT_P3_IMAGE_GAMMA, P3_D65, DEFAULT_DISPLAY_GAMMA,
+     P3_D65_INV, true},
+};
+
+// the matrices of a case, in double precision
+struct CASE_MATRICES {
+  MATRIX src_, dst_, dstToXYZ_, toSRGB_, fromSRGB_;
+};
+
+static CASE_MATRICES GetMatrices(const QUALITY_CASE& c) {
+  return CASE_MATRICES{ToMatrix(*GetTransformNPM(c.srcNPM_)),
+                       ToMatrix(*GetTransformNPM(c.dstNPM_)),
+                       ToMatrix(GetTransformNPM(c.dstNPM_)->Inverse()),
+                       ToMatrix(*GetTransformNPM(SRGB_D65_INV)),
+                       ToMatrix(*GetTransformNPM(SRGB_D65))};
+}
+
+/*
+ * Exact transform of one 8 bit color to 0.0 -- 1.0 encoded values
+ */
+static void Reference(const QUALITY_CASE& c, const CASE_MATRICES& m,
+                      const uint8_t* in, double* out) {
+  double linear[3], xyz[3], xformed[3];
+  for (int ch = 0; ch < 3; ch++) {
+    linear[ch] = Decode(in[ch] / 255.0, c.srcGamma_);
+  }
+  Multiply(m.src_, linear, xyz);
+  if (c.clipToSRGB_) {
+    Multiply(m.toSRGB_, xyz, xformed);
+    for (int ch = 0; ch < 3; ch++) xformed[ch] = Clamp(xformed[ch]);
+    Multiply(m.fromSRGB_, xformed, xyz);
+  }
+  Multiply(m.dst_, xyz, xformed);
+  for (int ch = 0; ch < 3; ch++) {
+    out[ch] = Clamp(Encode(Clamp(xformed[ch]), c.dstGamma_));
+  }
+}
+
+/*
+ * Lab (D65 white) of 0.0 -- 1.0 encoded values in the destination space
+ */
+static void ToLab(const QUALITY_CASE& c, const CASE_MATRICES& m,
+                  const double* encoded, double* lab) {
+  static const double white[3] = {0.95047, 1.0, 1.08883};
+  double linear[3], xyz[3], f[3];
+  for (int ch = 0; ch < 3; ch++) {
+    linear[ch] = Decode(encoded[ch], c.dstGamma_);
+  }
+  Multiply(m.dstToXYZ_, linear, xyz);
+  for (int ch = 0; ch < 3; ch++) {
+    double t = xyz[ch] / white[ch];
+    f[ch] = t > 216.0 / 24389.0 ? std::cbrt(t)
+                                : (24389.0 / 27.0 * t + 16) / 116;
+  }
+  lab[0] = 116 * f[1] - 16;
+  lab[1] = 500 * (f[0] - f[1]);
+  lab[2] = 200 * (f[1] - f[2]);
+}
+
+struct ERRORS {
+  double maxCode_, meanCode_;  // in 8 bit code values
+  double maxDeltaE_, meanDeltaE_;
+};
+
+static ERRORS Measure(const QUALITY_CASE& c, const std::vector<uint8_t>& in,
+                      const std::vector<uint8_t>& out) {
+  ERRORS e{};
+  CASE_MATRICES m = GetMatrices(c);
+  size_t pixels = in.size() / 4;
+  for (size_t i = 0; i < pixels; i++) {
+    double exact[3], actual[3], exactLab[3], actualLab[3];
+    Reference(c, m, &in[i * 4], exact);
+    for (int ch = 0; ch < 3; ch++) {
+      actual[ch] = out[i * 4 + ch] / 255.0;
+      double err = std::fabs(actual[ch] - exact[ch]) * 255;
+      e.maxCode_ = err > e.maxCode_ ? err : e.maxCode_;
+      e.meanCode_ += err;
+    }
+    ToLab(c, m, exact, exactLab);
+    ToLab(c, m, actual, actualLab);
+    double dE = 0.0;
+    for (int ch = 0; ch < 3; ch++) {
+      dE += (exactLab[ch] - actualLab[ch]) * (exactLab[ch] - actualLab[ch]);
+    }
+    dE = std::sqrt(dE);
+    e.maxDeltaE_ = dE > e.maxDeltaE_ ? dE : e.maxDeltaE_;
+    e.meanDeltaE_ += dE;
+  }
+  e.meanCode_ /= pixels * 3;
+  e.meanDeltaE_ /= pixels;
+  return e;
+}
+
+/*
+ * Banding on a ramp: distinct output levels (of the green channel, which
+ * carries most of the luminance) and the largest step between neighbors
+ */
+static void Banding(const std::vector<uint8_t>& out, int* levels,
+                    int* maxStep) {
+  *levels = 1;
+  *maxStep = 0;
+  for (int i = 1; i < RAMP_LENGTH; i++) {
+    int step = std::abs(out[i * 4 + 1] - out[(i - 1) * 4 + 1]);
+    *levels += step ? 1 : 0;
+    *maxStep = step > *maxStep ? step : *maxStep;
+  }
+}
+
+/*
+ * The 8 bit path; for the sRGB view, the two conversions AssetTexture used
+ * to do, through an 8 bit linear sRGB image
+ */
+static void Transform8(const QUALITY_CASE& c, std::vector<uint8_t>& in,
+                       std::vector<uint8_t>& out, uint32_t width,
+                       uint32_t height) {
+  IMAGE_FORMAT src{in.data(), width, height, c.srcGamma_,
+                   GetTransformNPM(c.srcNPM_)};
+  IMAGE_FORMAT dst{out.data(), width, height, c.dstGamma_,
+                   GetTransformNPM(c.dstNPM_)};
+  if (!c.clipToSRGB_) {
+    TransformColorSpace(dst, src);
+    return;
+  }
+  std::vector<uint8_t> linear(in.size());
+  IMAGE_FORMAT linearSRGB{linear.data(), width, height, 0.0f,
+                          GetTransformNPM(SRGB_D65_INV)};
+  TransformColorSpace(linearSRGB, src);
+  linearSRGB.npm_ = GetTransformNPM(SRGB_D65);
+  TransformColorSpace(dst, linearSRGB);
+}
+
+static void TransformPrecise(const QUALITY_CASE& c, std::vector<uint8_t>& in,
+                             std::vector<uint8_t>& out, uint32_t width,
+                             uint32_t height) {
+  IMAGE_FORMAT src{in.data(), width, height, c.srcGamma_,
+                   GetTransformNPM(c.srcNPM_)};
+  IMAGE_FORMAT dst{out.data(), width, height, c.dstGamma_,
+                   GetTransformNPM(c.dstNPM_)};
+  TransformColorSpaceHighPrecision(
+      dst, src, c.clipToSRGB_ ? GetTransformNPM(SRGB_D65) : nullptr);
+}
+
+int main() {
+  std::vector<uint8_t> cube(CUBE_SIDE * CUBE_SIDE * 4);
+  for (uint32_t i = 0; i < CUBE_SIDE * CUBE_SIDE; i++) {
+    cube[i * 4 + 0] = static_cast<uint8_t>(i >> 16);
+    cube[i * 4 + 1] = static_cast<uint8_t>(i >> 8);
+    cube[i * 4 + 2] = static_cast<uint8_t>(i);
+    cube[i * 4 + 3] = 255;
+  }
+  std::vector<uint8_t> ramp(RAMP_LENGTH * 4);
+  for (int i = 0; i < RAMP_LENGTH; i++) {
+    ramp[i * 4 + 0] = ramp[i * 4 + 1] = ramp[i * 4 + 2] = i;
+    ramp[i * 4 + 3] = 255;
+  }
+
+  std::vector<uint8_t> out(cube.size()), rampOut(ramp.size());
+  printf("all %d colors; dark ramp of %d grays\n", CUBE_SIDE * CUBE_SIDE,
+         RAMP_LENGTH);
+  printf("%-20s %-10s %9s %9s %9s %9s %7s %5s\n", "", "path", "max code",
+         "mean code", "max dE", "mean dE", "levels", "step");
+  for (const QUALITY_CASE& c : cases) {
+    for (int precise = 0; precise < 2; precise++) {
+      if (precise) {
+        TransformPrecise(c, cube, out, CUBE_SIDE, CUBE_SIDE);
+        TransformPrecise(c, ramp, rampOut, RAMP_LENGTH, 1);
+      } else {
+        Transform8(c, cube, out, CUBE_SIDE, CUBE_SIDE);
+        Transform8(c, ramp, rampOut, RAMP_LENGTH, 1);
+      }
+      ERRORS e = Measure(c, cube, out);
+      int levels, maxStep;
+      Banding(rampOut, &levels, &maxStep);
+      printf("%-20s %-10s %9.2f %9.3f %9.2f %9.3f %7d %5d\n",
+             precise ? "" : c.name_, precise ? "precise" : "8 bit",
+             e.maxCode_, e.meanCode_, e.maxDeltaE_, e.meanDeltaE_, levels,
+             maxStep);
+    }
+  }
+  return 0;
+}
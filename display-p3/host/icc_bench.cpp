@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * For each PNG in the asset directory: the color space PNGHeader finds (the
+ * iCCP profile's, or cHRM / gAMA), how far its NPM is from display P3 and
+ * sRGB, the gamma fitted to the profile's TRCs and its error, and what the
+ * app does with the image. Then the time to parse each profile, against
+ * getting it from the profile cache.
+ *
+ * usage: icc_bench [iterations] [asset dir]
+ */
+#include <zlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "IccProfile.h"
+#include "TexturePipeline.h"
+#include "simple_png.h"
+
+static double Seconds(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+static bool ReadFile(const std::string& path, std::vector<uint8_t>& data) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) return false;
+  data.resize(std::filesystem::file_size(path));
+  size_t len = fread(data.data(), 1, data.size(), file);
+  fclose(file);
+  data.resize(len);
+  return true;
+}
+
+static uint32_t ReadUint32(const uint8_t* p) {
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+         (uint32_t(p[2]) << 8) | p[3];
+}
+
+// the inflated iCCP profile of a PNG file, empty if it has none
+static std::vector<uint8_t> ExtractProfile(const std::vector<uint8_t>& png) {
+  std::vector<uint8_t> profile;
+  for (size_t offset = 8; offset + 12 <= png.size();) {
+    uint32_t len = ReadUint32(&png[offset]);
+    const uint8_t* data = &png[offset + 8];
+    if (len > png.size() - offset - 12) break;
+    if (!memcmp(&png[offset + 4], "iCCP", 4)) {
+      size_t nameLen = strnlen(reinterpret_cast<const char*>(data), len);
+      uLongf size = 4 * 1024 * 1024;
+      profile.resize(size);
+      if (nameLen + 2 > len ||
+          uncompress(profile.data(), &size, data + nameLen + 2,
+                     len - nameLen - 2) != Z_OK) {
+        size = 0;
+      }
+      profile.resize(size);
+      break;
+    }
+    offset += len + 12;
+  }
+  return profile;
+}
+
+static float MaxDelta(const mathfu::mat3& a, const mathfu::mat3& b) {
+  float delta = 0.0f;
+  for (int idx = 0; idx < 9; idx++) {
+    float diff = a(idx / 3, idx % 3) - b(idx / 3, idx % 3);
+    delta = std::max(delta, std::fabs(diff));
+  }
+  return delta;
+}
+
+int main(int argc, char** argv) {
+  uint32_t iterations = argc > 1 ? atoi(argv[1]) : 1000;
+  std::string assetDir = argc > 2 ? argv[2] : PNG_ASSET_DIR;
+
+  std::vector<std::string> files;
+  for (auto& entry : std::filesystem::directory_iterator(assetDir)) {
+    if (entry.path().extension() == ".png") files.push_back(entry.path());
+  }
+  std::sort(files.begin(), files.end());
+
+  printf("%-28s %-6s %8s %8s %7s %8s  %s\n", "file", "color", "dP3",
+         "dsRGB", "gamma", "error", "app");
+  std::vector<std::vector<uint8_t>> profiles;
+  for (const std::string& path : files) {
+    std::vector<uint8_t> png;
+    if (!ReadFile(path, png)) continue;
+    std::string name = std::filesystem::path(path).filename();
+    PNGHeader header(name, png.data(), png.size());
+    std::vector<uint8_t> profileBytes = ExtractProfile(png);
+    if (!profileBytes.empty()) profiles.push_back(profileBytes);
+
+    const IccProfile* profile = header.Profile();
+    const char* kind = profile ? (profile->Version() >= 4 ? "ICC v4" : "ICC v2")
+                               : !profileBytes.empty() ? "ICC ?"
+                               : header.HasNPM()       ? "cHRM"
+                                                       : "none";
+    SOURCE_SPACE source =
+        TexturePipeline::GetSourceSpace(png.data(), png.size());
+    printf("%-28s %-6s ", name.c_str(), kind);
+    if (header.HasNPM()) {
+      printf("%8.5f %8.5f ", MaxDelta(*header.NPM(), *GetTransformNPM(P3_D65)),
+             MaxDelta(*header.NPM(), *GetTransformNPM(SRGB_D65)));
+    } else {
+      printf("%8s %8s ", "-", "-");
+    }
+    if (profile) {
+      printf("1/%5.3f %8.5f ", 1.0f / profile->Gamma(), profile->GammaError());
+    } else {
+      printf("%7s %8s ", "-", "-");
+    }
+    printf(" %s\n", source.p3_ ? "P3 as is" : "converted");
+  }
+  if (profiles.empty()) return 0;
+
+  auto start = std::chrono::steady_clock::now();
+  uint32_t parsed = 0;
+  for (uint32_t it = 0; it < iterations; it++) {
+    for (auto& bytes : profiles) {
+      parsed += IccProfile::Parse(bytes.data(), bytes.size()) != nullptr;
+    }
+  }
+  double parseTime = Seconds(start);
+  start = std::chrono::steady_clock::now();
+  uint32_t cached = 0;
+  for (uint32_t it = 0; it < iterations; it++) {
+    for (auto& bytes : profiles) {
+      cached += IccProfile::Get(bytes.data(), bytes.size()) != nullptr;
+    }
+  }
+  double getTime = Seconds(start);
+  double count = static_cast<double>(iterations) * profiles.size();
+  printf("%zu profiles: Parse() %.2f us, cached Get() %.2f us (%.1fx)\n",
+         profiles.size(), parseTime * 1e6 / count, getTime * 1e6 / count,
+         parseTime / getTime);
+  return parsed != cached;
+}
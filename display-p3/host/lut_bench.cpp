@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures ColorLut3D against the analytic transforms, on the P3 to sRGB
+ * conversion AssetTexture does (clipped to the sRGB gamut):
+ *   - building 17^3 and 33^3 LUTs, and loading them from the disk cache
+ *   - that the SIMD kernel matches the plain C one, byte for byte
+ *   - throughput on a 12 MP image, RGBA8 and RGBA16, on one thread and on
+ *     all of them, against TransformColorSpace() and
+ *     TransformColorSpaceHighPrecision()
+ *   - accuracy against the exact (double precision) pipeline, in output
+ *     code values: 8 bit over a third of the RGB cube, 16 bit on random
+ *     colors
+ *
+ * usage: lut_bench [iterations] [cache dir]
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ColorLut3D.h"
+
+#define IMAGE_WIDTH 4032
+#define IMAGE_HEIGHT 3024
+#define ACCURACY_STEP 3  // 8 bit accuracy: every 3rd value of each channel
+#define ACCURACY_COLORS16 (1 << 20)
+
+static double Seconds(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+// gradients (every value of every channel) plus some noise, as color_bench
+template <typename T>
+static void FillImage(std::vector<T>& img, uint32_t scale) {
+  uint32_t seed = 1;
+  for (uint32_t y = 0; y < IMAGE_HEIGHT; y++) {
+    for (uint32_t x = 0; x < IMAGE_WIDTH; x++) {
+      T* p = &img[(y * IMAGE_WIDTH + x) * 4];
+      seed = seed * 1664525 + 1013904223;
+      p[0] = static_cast<T>(x * scale);
+      p[1] = static_cast<T>(y * scale);
+      p[2] = static_cast<T>(seed >> (32 - 8 * sizeof(T)));
+      p[3] = static_cast<T>((x + y) * scale);
+    }
+  }
+}
+
+template <typename T>
+static void FillRandom(std::vector<T>& pixels, uint32_t seed) {
+  for (T& val : pixels) {
+    seed = seed * 1664525 + 1013904223;
+    val = static_cast<T>(seed >> 16);
+  }
+}
+
+struct ERRORS {
+  double max_, mean_;
+};
+
+// error of 8 or 16 bit RGBA output against the pipeline, in code values
+template <typename T>
+static ERRORS Measure(const ColorPipeline& pipeline, const std::vector<T>& in,
+                      const std::vector<T>& out, double maxVal) {
+  ERRORS e{0.0, 0.0};
+  size_t pixels = in.size() / 4;
+  for (size_t idx = 0; idx < pixels; idx++) {
+    double rgb[3];
+    for (int ch = 0; ch < 3; ch++) rgb[ch] = in[idx * 4 + ch] / maxVal;
+    pipeline.Apply(rgb);
+    for (int ch = 0; ch < 3; ch++) {
+      double err = std::fabs(out[idx * 4 + ch] - rgb[ch] * maxVal);
+      e.max_ = err > e.max_ ? err : e.max_;
+      e.mean_ += err;
+    }
+  }
+  e.mean_ /= pixels * 3;
+  return e;
+}
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 3;
+  std::string cacheDir =
+      argc > 2 ? argv[2]
+               : (std::filesystem::temp_directory_path() / "lut3d").string();
+  std::filesystem::create_directories(cacheDir);
+  uint32_t cpus = std::max(std::thread::hardware_concurrency(), 1u);
+
+  // what TransformColorSpaceHighPrecision(dst, src, clip) computes
+  ColorPipeline pipeline;
+  pipeline.Decode(TRC_SRGB, DEFAULT_P3_IMAGE_GAMMA)
+      .Matrix(*GetTransformNPM(SRGB_D65_INV) * *GetTransformNPM(P3_D65))
+      .Clip()
+      .Encode(TRC_SRGB, DEFAULT_DISPLAY_GAMMA);
+
+  size_t pixels = IMAGE_WIDTH * IMAGE_HEIGHT;
+  std::vector<uint8_t> image8(pixels * 4), out8(pixels * 4), ref8(pixels * 4);
+  std::vector<uint16_t> image16(pixels * 4), out16(pixels * 4),
+      ref16(pixels * 4);
+  FillImage(image8, 1);
+  FillImage(image16, 257);
+  IMAGE_FORMAT src8{image8.data(), IMAGE_WIDTH, IMAGE_HEIGHT,
+                    DEFAULT_P3_IMAGE_GAMMA, GetTransformNPM(P3_D65)};
+  IMAGE_FORMAT dst8{out8.data(), IMAGE_WIDTH, IMAGE_HEIGHT,
+                    DEFAULT_DISPLAY_GAMMA, GetTransformNPM(SRGB_D65_INV)};
+  IMAGE_FORMAT src16 = src8, dst16 = dst8;
+  src16.buf_ = image16.data();
+  src16.format_ = PIXEL_RGBA16;
+  dst16.buf_ = out16.data();
+  dst16.format_ = PIXEL_RGBA16;
+
+  // the analytic paths
+  double mpix = pixels / 1e6;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) TransformColorSpace(dst8, src8);
+  double fusedTime = Seconds(start) / iterations;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    TransformColorSpaceHighPrecision(dst8, src8,
+                                     GetTransformNPM(SRGB_D65));
+  }
+  double preciseTime = Seconds(start) / iterations;
+  printf("%d x %d (%.1f MP), %d iterations, %u CPUs, cache in %s\n",
+         IMAGE_WIDTH, IMAGE_HEIGHT, mpix, iterations, cpus, cacheDir.c_str());
+  printf("analytic 8 -> 8:  fused %.1f ms (no clip), high precision %.1f ms\n",
+         fusedTime * 1e3, preciseTime * 1e3);
+
+  // accuracy inputs
+  std::vector<uint8_t> cube8;
+  for (uint32_t b = 0; b < 256; b += ACCURACY_STEP) {
+    for (uint32_t g = 0; g < 256; g += ACCURACY_STEP) {
+      for (uint32_t r = 0; r < 256; r += ACCURACY_STEP) {
+        cube8.insert(cube8.end(), {static_cast<uint8_t>(r),
+                                   static_cast<uint8_t>(g),
+                                   static_cast<uint8_t>(b), 255});
+      }
+    }
+  }
+  std::vector<uint8_t> cubeOut8(cube8.size());
+  IMAGE_FORMAT cubeSrc{cube8.data(), static_cast<uint32_t>(cube8.size() / 4),
+                       1, DEFAULT_P3_IMAGE_GAMMA, GetTransformNPM(P3_D65)};
+  IMAGE_FORMAT cubeDst{cubeOut8.data(), cubeSrc.width_, 1,
+                       DEFAULT_DISPLAY_GAMMA, GetTransformNPM(SRGB_D65_INV)};
+  TransformColorSpaceHighPrecision(cubeDst, cubeSrc,
+                                   GetTransformNPM(SRGB_D65));
+  ERRORS precise = Measure(pipeline, cube8, cubeOut8, 255.0);
+  printf("analytic accuracy: high precision 8 bit max %.2f, mean %.3f\n",
+         precise.max_, precise.mean_);
+
+  std::vector<uint16_t> colors16(ACCURACY_COLORS16 * 4),
+      colorsOut16(colors16.size());
+  FillRandom(colors16, 3);
+  IMAGE_FORMAT colorSrc{colors16.data(), ACCURACY_COLORS16, 1, 0.0f, nullptr,
+                        PIXEL_RGBA16};
+  IMAGE_FORMAT colorDst{colorsOut16.data(), ACCURACY_COLORS16, 1, 0.0f,
+                        nullptr, PIXEL_RGBA16};
+
+  uint32_t grids[] = {ColorLut3D::SMALL_GRID, ColorLut3D::LARGE_GRID};
+  for (uint32_t grid : grids) {
+    printf("\n%u^3 LUT\n", grid);
+    ColorLut3D lut;
+    start = std::chrono::steady_clock::now();
+    lut.Build(pipeline, grid);
+    double buildTime = Seconds(start);
+    ColorLut3D cached;
+    cached.Build(pipeline, grid, cacheDir.c_str());  // makes sure it's saved
+    start = std::chrono::steady_clock::now();
+    cached.Build(pipeline, grid, cacheDir.c_str());
+    double loadTime = Seconds(start);
+    printf("  build %.2f ms, from disk cache %.2f ms (%s)\n", buildTime * 1e3,
+           loadTime * 1e3, cached.LoadedFromCache() ? "hit" : "MISS");
+
+    // SIMD must match C, in every format combination
+    IMAGE_FORMAT srcs[] = {src8, src16, src8, src16};
+    IMAGE_FORMAT dsts[] = {dst8, dst16, dst16, dst8};
+    for (int f = 0; f < 4; f++) {
+      IMAGE_FORMAT dst = dsts[f], ref = dsts[f];
+      ref.buf_ = ref.format_ == PIXEL_RGBA16 ? static_cast<void*>(ref16.data())
+                                             : ref8.data();
+      lut.Apply(dst, srcs[f]);
+      lut.ApplyScalar(ref, srcs[f]);
+      if (memcmp(dst.buf_, ref.buf_,
+                 pixels * (dst.format_ == PIXEL_RGBA16 ? 8 : 4))) {
+        printf("ERROR: SIMD and C results differ (case %d)!\n", f);
+        return 1;
+      }
+    }
+
+    const char* names[] = {"8 -> 8", "16 -> 16"};
+    for (int f = 0; f < 2; f++) {
+      IMAGE_FORMAT& src = f ? src16 : src8;
+      IMAGE_FORMAT& dst = f ? dst16 : dst8;
+      double times[3];
+      for (int t = 0; t < 3; t++) {
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+          if (t == 0) {
+            lut.ApplyScalar(dst, src);
+          } else {
+            lut.Apply(dst, src, t == 1 ? 1 : cpus);
+          }
+        }
+        times[t] = Seconds(start) / iterations;
+      }
+      printf("  %-9s C %.1f ms, SIMD %.1f ms, %u threads %.1f ms "
+             "(%.0f Mpixels/s)\n",
+             names[f], times[0] * 1e3, times[1] * 1e3, cpus, times[2] * 1e3,
+             mpix / times[2]);
+    }
+
+    lut.Apply(cubeDst, cubeSrc);
+    ERRORS e8 = Measure(pipeline, cube8, cubeOut8, 255.0);
+    lut.Apply(colorDst, colorSrc);
+    ERRORS e16 = Measure(pipeline, colors16, colorsOut16, 65535.0);
+    printf("  accuracy: 8 bit max %.2f, mean %.3f; 16 bit max %.1f, "
+           "mean %.2f\n",
+           e8.max_, e8.mean_, e16.max_, e16.mean_);
+  }
+  return 0;
+}
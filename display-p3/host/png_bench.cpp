@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures the streaming PNGDecoder against what AssetTexture did before:
+ * decoding the whole image with stb_image, then converting it from P3 to
+ * sRGB with TransformColorSpaceHighPrecision(). For the app's PNG assets,
+ * plus a 12 MP RGBA and RGB image written here with every filter type
+ * (row % 5), in small IDAT chunks:
+ *   - that the decoder's rows match stb_image's, the SIMD unfiltering
+ *     matches plain C, and the converted images are the same
+ *   - time, and working memory on top of the converted image: stb holds the
+ *     inflated data and the decoded image; PNGDecoder two rows and zlib's
+ *     state
+ *
+ * usage: png_bench [iterations] [asset dir]
+ */
+#include <zlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <stb/stb_image.h>
+
+#include "simple_png.h"
+
+#define SYNTHETIC_WIDTH 4032
+#define SYNTHETIC_HEIGHT 3024
+#define SYNTHETIC_IDAT_SIZE (64 * 1024)
+
+static double Seconds(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+static void PutUint32(std::vector<uint8_t>& out, uint32_t val) {
+  uint8_t bytes[] = {static_cast<uint8_t>(val >> 24),
+                     static_cast<uint8_t>(val >> 16),
+                     static_cast<uint8_t>(val >> 8),
+                     static_cast<uint8_t>(val)};
+  out.insert(out.end(), bytes, bytes + 4);
+}
+
+static void PutChunk(std::vector<uint8_t>& out, const char* type,
+                     const uint8_t* data, uint32_t len) {
+  PutUint32(out, len);
+  size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data, data + len);
+  PutUint32(out, crc32(0, &out[start], len + 4));
+}
+
+/*
+ * A gradient plus noise, filtered with filter type row % 5
+ */
+static std::vector<uint8_t> MakePNG(uint32_t channels) {
+  uint32_t rowBytes = SYNTHETIC_WIDTH * channels;
+  std::vector<uint8_t> raw, row(rowBytes), prev(rowBytes, 0);
+  raw.reserve((rowBytes + 1) * SYNTHETIC_HEIGHT);
+  uint32_t seed = 1;
+  for (uint32_t y = 0; y < SYNTHETIC_HEIGHT; y++) {
+    for (uint32_t x = 0; x < SYNTHETIC_WIDTH; x++) {
+      seed = seed * 1664525 + 1013904223;
+      uint8_t px[] = {static_cast<uint8_t>(x), static_cast<uint8_t>(y),
+                      static_cast<uint8_t>((x + y) / 4 + (seed >> 29)),
+                      static_cast<uint8_t>(255 - (seed >> 30))};
+      memcpy(&row[x * channels], px, channels);
+    }
+    uint8_t filter = y % 5;
+    raw.push_back(filter);
+    for (uint32_t idx = 0; idx < rowBytes; idx++) {
+      int32_t a = idx >= channels ? row[idx - channels] : 0;
+      int32_t b = prev[idx];
+      int32_t c = idx >= channels ? prev[idx - channels] : 0;
+      int32_t p = a + b - c, pa = abs(p - a), pb = abs(p - b),
+              pc = abs(p - c);
+      int32_t predictors[] = {
+          0, a, b, (a + b) / 2,
+          (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c)};
+      raw.push_back(static_cast<uint8_t>(row[idx] - predictors[filter]));
+    }
+    prev.swap(row);
+  }
+
+  uLongf zlen = compressBound(raw.size());
+  std::vector<uint8_t> zdata(zlen);
+  compress2(zdata.data(), &zlen, raw.data(), raw.size(), 6);
+
+  std::vector<uint8_t> png = {137, 80, 78, 71, 13, 10, 26, 10};
+  uint8_t ihdr[13] = {0};
+  for (int i = 0; i < 4; i++) {
+    ihdr[i] = static_cast<uint8_t>(SYNTHETIC_WIDTH >> (24 - 8 * i));
+    ihdr[4 + i] = static_cast<uint8_t>(SYNTHETIC_HEIGHT >> (24 - 8 * i));
+  }
+  ihdr[8] = 8;
+  ihdr[9] = channels == 4 ? 6 : 2;
+  PutChunk(png, "IHDR", ihdr, sizeof(ihdr));
+  for (uLongf offset = 0; offset < zlen; offset += SYNTHETIC_IDAT_SIZE) {
+    PutChunk(png, "IDAT", &zdata[offset],
+             std::min<uLongf>(SYNTHETIC_IDAT_SIZE, zlen - offset));
+  }
+  PutChunk(png, "IEND", nullptr, 0);
+  return png;
+}
+
+static bool Verify(const std::vector<uint8_t>& png, const uint8_t* expected) {
+  PNGDecoder decoder(png.data(), png.size());
+  size_t rowBytes = decoder.Width() * 4;
+  for (int simd = 0; simd < 2; simd++) {
+    bool same = decoder.Decode(
+        [&](uint32_t row, uint8_t* rgba) {
+          return !memcmp(rgba, expected + row * rowBytes, rowBytes);
+        },
+        simd);
+    if (!same) return false;
+  }
+  return true;
+}
+
+static void Bench(const std::string& name, const std::vector<uint8_t>& png,
+                  int iterations) {
+  PNGDecoder decoder(png.data(), png.size());
+  if (!decoder.IsSupported()) {
+    printf("%-28s not supported by PNGDecoder\n", name.c_str());
+    return;
+  }
+  uint32_t width = decoder.Width(), height = decoder.Height();
+  std::vector<uint8_t> converted(width * height * 4),
+      streamed(converted.size());
+  IMAGE_FORMAT p3{nullptr, width, height, DEFAULT_P3_IMAGE_GAMMA,
+                  GetTransformNPM(P3_D65)};
+  IMAGE_FORMAT dst{converted.data(), width, height, DEFAULT_DISPLAY_GAMMA,
+                   GetTransformNPM(SRGB_D65_INV)};
+
+  // stb_image, then the conversion
+  double stbTime = 0.0;
+  int n;
+  for (int i = 0; i < iterations; i++) {
+    auto start = std::chrono::steady_clock::now();
+    int w, h;
+    uint8_t* image =
+        stbi_load_from_memory(png.data(), png.size(), &w, &h, &n, 4);
+    p3.buf_ = image;
+    TransformColorSpaceHighPrecision(dst, p3);
+    stbTime += Seconds(start);
+    if (i == iterations - 1 && !Verify(png, image)) {
+      printf("ERROR: %s: rows differ from stb_image!\n", name.c_str());
+      exit(1);
+    }
+    stbi_image_free(image);
+  }
+  // stb inflates all of the image data, then decodes it to a whole image
+  uint32_t bitDepth = png[24];
+  size_t stbMemory =
+      (static_cast<size_t>(width) * n * bitDepth / 8 + 1) * height +
+      converted.size();
+
+  dst.buf_ = streamed.data();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) decoder.DecodeTransformed(dst, p3);
+  double streamTime = Seconds(start);
+  if (converted != streamed) {
+    printf("ERROR: %s: converted images differ!\n", name.c_str());
+    exit(1);
+  }
+
+  printf("%-28s %5u x %-5u %3u bit  %7.2f ms %7.2f ms  %8.1f KB %7.1f KB\n",
+         name.c_str(), width, height, bitDepth,
+         stbTime * 1e3 / iterations, streamTime * 1e3 / iterations,
+         stbMemory / 1024.0, decoder.PeakMemory() / 1024.0);
+}
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 3;
+  std::string assetDir = argc > 2 ? argv[2] : PNG_ASSET_DIR;
+
+  printf("P3 PNG -> sRGB RGBA8, %d iterations; time and working memory:\n",
+         iterations);
+  printf("%-28s %-13s %7s  %10s %10s  %11s %10s\n", "", "size", "depth",
+         "stb + xform", "streaming", "stb", "streaming");
+
+  std::vector<std::filesystem::path> files;
+  for (auto& entry : std::filesystem::directory_iterator(assetDir)) {
+    if (entry.path().extension() == ".png") files.push_back(entry.path());
+  }
+  std::sort(files.begin(), files.end());
+  for (auto& path : files) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) continue;
+    std::vector<uint8_t> png(std::filesystem::file_size(path));
+    size_t len = fread(png.data(), 1, png.size(), file);
+    fclose(file);
+    png.resize(len);
+    Bench(path.filename().string(), png, iterations);
+  }
+
+  Bench("synthetic RGBA, all filters", MakePNG(4), iterations);
+  Bench("synthetic RGB, all filters", MakePNG(3), iterations);
+  return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures the total time to prepare N images (the app's PNG assets, over
+ * and over) for the textures of a P3 display: read, decoded and converted
+ * by TexturePipeline with 1 -- K workers, while this thread stands in for
+ * the GL thread, taking the images and copying them as an upload would.
+ * The baseline does all of it on one thread, one image after the other, as
+ * CreateTextures() did. Then cancellation: how long a new Start() takes to
+ * deliver its first image while the previous one is still busy, and that
+ * nothing of the previous one comes out.
+ *
+ * usage: texture_bench [images] [max workers] [asset dir]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TexturePipeline.h"
+
+static double Seconds(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+static bool ReadFile(const std::string& path, std::vector<uint8_t>& data) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) return false;
+  data.resize(std::filesystem::file_size(path));
+  size_t len = fread(data.data(), 1, data.size(), file);
+  fclose(file);
+  data.resize(len);
+  return true;
+}
+
+// what glTexSubImage2D() does with the pixels, more or less
+static void Upload(const PREPARED_IMAGE& image, std::vector<uint8_t>& gpu) {
+  size_t bytes = image.sRGBView_.size();
+  gpu.resize(std::max(gpu.size(), bytes * 2));
+  memcpy(gpu.data(), image.sRGBView_.data(), bytes);
+  if (!image.p3_.empty()) memcpy(gpu.data() + bytes, image.p3_.data(), bytes);
+}
+
+int main(int argc, char** argv) {
+  uint32_t imageCount = argc > 1 ? atoi(argv[1]) : 40;
+  uint32_t maxWorkers =
+      argc > 2 ? atoi(argv[2])
+               : std::max(std::thread::hardware_concurrency(), 4u);
+  std::string assetDir = argc > 3 ? argv[3] : PNG_ASSET_DIR;
+
+  std::vector<std::string> files;
+  for (auto& entry : std::filesystem::directory_iterator(assetDir)) {
+    if (entry.path().extension() == ".png") files.push_back(entry.path());
+  }
+  if (files.empty()) {
+    printf("no PNG files in %s\n", assetDir.c_str());
+    return 1;
+  }
+  std::sort(files.begin(), files.end());
+  TexturePipeline::FileReader reader = [&files](uint32_t index,
+                                                std::vector<uint8_t>& data) {
+    return ReadFile(files[index % files.size()], data);
+  };
+
+  printf("%u images (%zu files), %u CPUs, P3 display\n", imageCount,
+         files.size(), std::thread::hardware_concurrency());
+  std::vector<uint8_t> gpu;
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t idx = 0; idx < imageCount; idx++) {
+    std::vector<uint8_t> data;
+    PREPARED_IMAGE image;
+    reader(idx, data);
+    TexturePipeline::Prepare(data, true, image);
+    Upload(image, gpu);
+  }
+  double serialTime = Seconds(start);
+  printf("one thread:  %8.1f ms\n", serialTime * 1e3);
+
+  for (uint32_t workers = 1; workers <= maxWorkers; workers++) {
+    TexturePipeline pipeline(workers);
+    start = std::chrono::steady_clock::now();
+    pipeline.Start(imageCount, reader, true);
+    std::vector<bool> seen(imageCount, false);
+    std::unique_ptr<PREPARED_IMAGE> image;
+    uint32_t taken = 0;
+    while (pipeline.Next(image, true)) {
+      if (!image->valid_ || seen[image->index_]) {
+        printf("ERROR: image %u is bad or came twice!\n", image->index_);
+        return 1;
+      }
+      seen[image->index_] = true;
+      Upload(*image, gpu);
+      taken++;
+    }
+    double time = Seconds(start);
+    if (taken != imageCount) {
+      printf("ERROR: got %u of %u images!\n", taken, imageCount);
+      return 1;
+    }
+    printf("%2u worker%s: %8.1f ms (%.2fx)\n", workers,
+           workers > 1 ? "s" : " ", time * 1e3, serialTime / time);
+  }
+
+  // a new display color space while the pipeline is full and busy
+  TexturePipeline pipeline(maxWorkers);
+  pipeline.Start(imageCount, reader, true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  start = std::chrono::steady_clock::now();
+  pipeline.Start(imageCount, reader, false);
+  std::unique_ptr<PREPARED_IMAGE> image;
+  pipeline.Next(image, true);
+  double firstTime = Seconds(start);
+  uint32_t taken = 1, leftovers = !image->p3_.empty();
+  while (pipeline.Next(image, true)) {
+    taken++;
+    leftovers += !image->p3_.empty();
+  }
+  printf("restart: first image after %.1f ms; %u images, %u from before\n",
+         firstTime * 1e3, taken, leftovers);
+  return leftovers || taken != imageCount;
+}
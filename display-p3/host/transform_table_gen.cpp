@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Builds the tables of the standard conversions (standardTransforms and
+ * standardTransforms16 in ColorSpaceTransform.cpp) and writes them as
+ * static data, so the app never builds them. The output is checked in as
+ * image-view/src/main/cpp/StandardTransforms.inl; the transform_tables
+ * target of the host build regenerates it and must be run after changing
+ * the curves, the NPMs or the list of standard conversions.
+ *
+ * usage: transform_table_gen out.inl
+ */
+#define TRANSFORM_TABLE_GENERATOR
+#include "ColorSpaceTransform.cpp"
+
+#include <cstdio>
+
+static const char* npmNames[] = {"SRGB_D65", "SRGB_D65_INV", "P3_D65",
+                                 "P3_D65_INV", "none"};
+
+template <typename T>
+static void WriteArray(FILE* out, const T* values, size_t count,
+                       size_t perLine, const char* format) {
+  fprintf(out, "{");
+  for (size_t idx = 0; idx < count; idx++) {
+    const char* separator = idx ? " " : "";
+    if (count > perLine && idx % perLine == 0) separator = "\n        ";
+    fprintf(out, "%s", separator);
+    fprintf(out, format, values[idx]);
+    fprintf(out, idx + 1 < count ? "," : "");
+  }
+  fprintf(out, "}");
+}
+
+static void GetFormats(const STANDARD_TRANSFORM& standard, IMAGE_FORMAT& dst,
+                       IMAGE_FORMAT& src) {
+  src = IMAGE_FORMAT{nullptr, 0, 0, standard.srcGamma_,
+                     GetTransformNPM(standard.src_)};
+  dst = IMAGE_FORMAT{nullptr, 0, 0, standard.dstGamma_,
+                     GetTransformNPM(standard.dst_), standard.format_};
+}
+
+static void WriteComment(FILE* out, const STANDARD_TRANSFORM& standard) {
+  fprintf(out, "    // %s (gamma %.4f) -> %s (gamma %.4f), clip: %s%s\n",
+          npmNames[standard.src_], standard.srcGamma_,
+          npmNames[standard.dst_], standard.dstGamma_,
+          npmNames[standard.clip_],
+          standard.format_ == PIXEL_RGBA16F ? ", RGBA16F" : "");
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s out.inl\n", argv[0]);
+    return 1;
+  }
+  FILE* out = fopen(argv[1], "w");
+  if (!out) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  fprintf(out,
+          "// Generated by host/transform_table_gen from "
+          "ColorSpaceTransform.cpp:\n"
+          "// the tables of standardTransforms and standardTransforms16, in "
+          "order.\n"
+          "// Do not edit; regenerate with the transform_tables target of "
+          "the host build.\n\n");
+
+  fprintf(out, "static const PIXEL_TRANSFORM standardTables[] = {\n");
+  for (const STANDARD_TRANSFORM& standard : standardTransforms) {
+    IMAGE_FORMAT dst, src;
+    GetFormats(standard, dst, src);
+    PIXEL_TRANSFORM xform;
+    BuildPixelTransform(dst, src, xform);
+    WriteComment(out, standard);
+    fprintf(out, "    {");
+    WriteArray(out, xform.decode_, 256, 16, "%3u");
+    fprintf(out, ",\n     ");
+    WriteArray(out, xform.matrix_, 9, 9, "%d");
+    fprintf(out, ",\n     ");
+    WriteArray(out, xform.encode_, 256, 16, "%3u");
+    fprintf(out, "},\n");
+  }
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "static const PIXEL_TRANSFORM16 standardTables16[] = {\n");
+  for (const STANDARD_TRANSFORM& standard : standardTransforms16) {
+    IMAGE_FORMAT dst, src;
+    GetFormats(standard, dst, src);
+    static PIXEL_TRANSFORM16 xform;
+    BuildPixelTransform16(dst, src,
+                          standard.clip_ == TYPE_COUNT
+                              ? nullptr
+                              : GetTransformNPM(standard.clip_),
+                          xform);
+    WriteComment(out, standard);
+    fprintf(out, "    {");
+    WriteArray(out, xform.decode_, 256, 12, "%5u");
+    fprintf(out, ",\n     ");
+    WriteArray(out, xform.matrix_, 9, 9, "%d");
+    fprintf(out, ",\n     ");
+    WriteArray(out, xform.clipMatrix_, 9, 9, "%d");
+    fprintf(out, ",\n     %s, %s,\n     ", xform.clip_ ? "true" : "false",
+            xform.format_ == PIXEL_RGBA16F ? "PIXEL_RGBA16F" : "PIXEL_RGBA8");
+    WriteArray(out, xform.encode_, ENCODE_LUT_SIZE, 12,
+               xform.format_ == PIXEL_RGBA16F ? "0x%04x" : "%3u");
+    fprintf(out, ",\n     ");
+    WriteArray(out, xform.alpha_, 256, 10, "0x%04x");
+    fprintf(out, ",\n     ");
+    if (xform.clip_) {
+      fprintf(out, "{}");  // columns_ are only for one matrix
+    } else {
+      WriteArray(out, &xform.columns_[0][0][0], 3 * 256 * 4, 8, "%d");
+    }
+    fprintf(out, "},\n");
+  }
+  fprintf(out, "};\n");
+
+  if (fclose(out)) {
+    perror(argv[1]);
+    return 1;
+  }
+  return 0;
+}
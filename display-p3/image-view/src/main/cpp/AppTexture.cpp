@@ -33,6 +33,9 @@ void ImageViewEngine::DeleteTextures(void) {
  *    Create 2 textures in current display_ color space ( P3 or sRGB)
  *    If it is P3 space, image is transformed through sRGB so colors
  *    outside sRGB gamut are removed.
+ *    The images are read, decoded and transformed by texturePipeline_ on its
+ *    worker threads; UploadTextures() creates the textures as they are done.
+ *    A new display color space abandons the images of the previous one.
  */
 bool ImageViewEngine::CreateTextures(void) {
   std::vector<std::string> files;
@@ -46,10 +49,40 @@ bool ImageViewEngine::CreateTextures(void) {
     AssetTexture* tex = new AssetTexture(f);
     ASSERT(tex, "OUT OF MEMORY");
     tex->ColorSpace(dispColorSpace_);
-    bool status = tex->CreateGLTextures(app_->activity->assetManager);
-    ASSERT(status, "Failed to create Texture for %s", f.c_str());
     textures_.push_back(tex);
   }
 
+  if (!texturePipeline_) {
+    texturePipeline_.reset(new TexturePipeline());
+  }
+  AAssetManager* mgr = app_->activity->assetManager;
+  texturePipeline_->Start(
+      static_cast<uint32_t>(files.size()),
+      [mgr, files](uint32_t index, std::vector<uint8_t>& data) {
+        std::string name = files[index];
+        return AssetReadFile(mgr, name, data);
+      },
+      dispColorSpace_ != DISPLAY_COLORSPACE::SRGB);
+
   return true;
 }
+
+/*
+ * UploadTextures()
+ *    Creates the textures of images texturePipeline_ has prepared, up to
+ *    MAX_UPLOADS_PER_FRAME of them so frames keep coming while loading
+ */
+#define MAX_UPLOADS_PER_FRAME 1
+
+void ImageViewEngine::UploadTextures(void) {
+  if (!texturePipeline_) return;
+
+  std::unique_ptr<PREPARED_IMAGE> image;
+  for (int count = 0; count < MAX_UPLOADS_PER_FRAME &&
+                      texturePipeline_->Next(image, false);
+       count++) {
+    AssetTexture* tex = textures_[image->index_];
+    bool status = tex->CreateGLTextures(*image);
+    ASSERT(status, "Failed to create Texture for %s", tex->Name().c_str());
+  }
+}
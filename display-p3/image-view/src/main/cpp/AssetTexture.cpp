@@ -15,14 +15,13 @@
  *
  */
 
-#define STB_IMAGE_IMPLEMENTATION
-#define STBI_ONLY_PNG
 #include "AssetTexture.h"
 
 #include <stb/stb_image.h>
 
+#include <cstring>
+
 #include "AssetUtil.h"
-#include "ColorSpaceTransform.h"
 #include "ImageViewEngine.h"
 #include "simple_png.h"
 
@@ -70,7 +69,13 @@ GLuint AssetTexture::SRGBATexId() {
  *     texture is created from:
  *       original image --> sRGB color Space --> display_ color space
  *     during the process, colors outside sRGB are clamped.
+ *     The image is decoded a band of rows at a time, each band converted and
+ *     uploaded as it is done, so neither the decoded image nor its converted
+ *     copy is ever held in memory. PNGs the streaming decoder can't handle
+ *     are decoded whole with stb_image.
  */
+#define UPLOAD_BAND_ROWS 64
+
 bool AssetTexture::CreateGLTextures(AAssetManager* mgr) {
   ASSERT(mgr, "Asset Manager is not valid");
   ASSERT(dispColorSpace_ != DISPLAY_COLORSPACE::INVALID,
@@ -83,39 +88,76 @@ bool AssetTexture::CreateGLTextures(AAssetManager* mgr) {
     sRGBId_ = INVALID_TEXTURE_ID;
   }
 
-  glGenTextures(1, &p3Id_);
-  glBindTexture(GL_TEXTURE_2D, p3Id_);
-
   std::vector<uint8_t> fileData;
   AssetReadFile(mgr, name_, fileData);
 
+  PNGDecoder decoder(fileData.data(), fileData.size());
+  if (!decoder.IsSupported()) {
+    return CreateFromWholeImage(fileData);
+  }
+
+  SOURCE_SPACE source =
+      TexturePipeline::GetSourceSpace(fileData.data(), fileData.size());
+  uint32_t imgWidth = decoder.Width(), imgHeight = decoder.Height();
+  AllocateTextures(imgWidth, imgHeight);
+
+  size_t bandBytes = imgWidth * UPLOAD_BAND_ROWS * 4;
+  std::vector<uint8_t> band(bandBytes), staging(bandBytes);
+  bool ok = decoder.Decode([&](uint32_t row, uint8_t* rgba) {
+    uint32_t bandRow = row % UPLOAD_BAND_ROWS;
+    memcpy(&band[bandRow * imgWidth * 4], rgba, imgWidth * 4);
+    if (bandRow + 1 == UPLOAD_BAND_ROWS || row + 1 == imgHeight) {
+      UploadRows(source, row - bandRow, imgWidth, bandRow + 1, band.data(),
+                 staging.data());
+    }
+    return true;
+  });
+  glBindTexture(GL_TEXTURE_2D, 0);
+  if (!ok) {
+    LOGE("==== Failed to decode %s", name_.c_str());
+    glDeleteTextures(1, &p3Id_);
+    glDeleteTextures(1, &sRGBId_);
+    p3Id_ = INVALID_TEXTURE_ID;
+    sRGBId_ = INVALID_TEXTURE_ID;
+  }
+  valid_ = ok;
+
+  return ok;
+}
+
+/*
+ * CreateFromWholeImage()
+ *     CreateGLTextures() for PNGs the streaming decoder does not support:
+ *     decodes the whole image with stb_image, then converts and uploads it.
+ */
+bool AssetTexture::CreateFromWholeImage(std::vector<uint8_t>& fileData) {
   uint32_t imgWidth, imgHeight, n;
   uint8_t* imageData = stbi_load_from_memory(
       fileData.data(), fileData.size(), reinterpret_cast<int*>(&imgWidth),
       reinterpret_cast<int*>(&imgHeight), reinterpret_cast<int*>(&n), 4);
-  uint8_t* imgBits = imageData;
-  std::vector<uint8_t> staging;
-  if (dispColorSpace_ == DISPLAY_COLORSPACE::SRGB) {
-    staging.resize(imgWidth * imgHeight * 4 * sizeof(uint8_t));
-    IMAGE_FORMAT src{
-        .buf_ = imageData,
-        .width_ = imgWidth,
-        .height_ = imgHeight,
-        .gamma_ = DEFAULT_P3_IMAGE_GAMMA,
-        .npm_ = GetTransformNPM(NPM_TYPE::P3_D65),
-    };
-
-    IMAGE_FORMAT dst{
-        .buf_ = staging.data(),
-        .width_ = imgWidth,
-        .height_ = imgHeight,
-        .gamma_ = DEFAULT_DISPLAY_GAMMA,
-        .npm_ = GetTransformNPM(NPM_TYPE::SRGB_D65_INV),
-    };
-    TransformColorSpace(dst, src);
-    imgBits = staging.data();
+  if (!imageData) {
+    LOGE("==== Failed to decode %s", name_.c_str());
+    return false;
   }
 
+  SOURCE_SPACE source =
+      TexturePipeline::GetSourceSpace(fileData.data(), fileData.size());
+  AllocateTextures(imgWidth, imgHeight);
+  std::vector<uint8_t> staging(imgWidth * imgHeight * 4 * sizeof(uint8_t));
+  UploadRows(source, 0, imgWidth, imgHeight, imageData, staging.data());
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  stbi_image_free(imageData);
+  valid_ = true;
+
+  return true;
+}
+
+/*
+ * AllocateTextures()
+ *     Creates both textures, with no content yet
+ */
+void AssetTexture::AllocateTextures(uint32_t width, uint32_t height) {
   // Our texture content is EOTF encoded, but depends on display P3 mode, app
   // chooses to use or bypass EOTF & OETF hardware functionality. See detailed
   // comments in WideColorCtx.cpp If OETF/EOTF needs bypassed on Android P and
@@ -125,67 +167,83 @@ bool AssetTexture::CreateGLTextures(AAssetManager* mgr) {
   if (dispColorSpace_ == DISPLAY_COLORSPACE::P3_PASSTHROUGH) {
     textureInternalFormat = GL_RGBA;
   }
-  glTexImage2D(GL_TEXTURE_2D, 0,  // mip level
-               textureInternalFormat, imgWidth, imgHeight,
-               0,  // border color
-               GL_RGBA, GL_UNSIGNED_BYTE, imgBits);
-
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-  // Generate sRGB view texture
-  glGenTextures(1, &sRGBId_);
-  glBindTexture(GL_TEXTURE_2D, sRGBId_);
-  if (dispColorSpace_ == DISPLAY_COLORSPACE::P3 ||
-      dispColorSpace_ == DISPLAY_COLORSPACE::P3_PASSTHROUGH) {
-    IMAGE_FORMAT src{
-        .buf_ = imageData,
-        .width_ = imgWidth,
-        .height_ = imgHeight,
-        .gamma_ = DEFAULT_P3_IMAGE_GAMMA,
-        .npm_ = GetTransformNPM(NPM_TYPE::P3_D65),
-    };
-    std::vector<uint8_t> srgbImg(imgWidth * imgHeight * 4 * sizeof(uint8_t));
-    IMAGE_FORMAT dst{
-        .buf_ = srgbImg.data(),
-        .width_ = imgWidth,
-        .height_ = imgHeight,
-        .gamma_ = 0.0f,  // intermediate image stays in linear space
-        .npm_ = GetTransformNPM(NPM_TYPE::SRGB_D65_INV),
-    };
-    TransformColorSpace(dst, src);
-
-    // sRGB back to P3 so we could display_ it correctly on P3 device mode
-    staging.resize(imgWidth * imgHeight * 4 * sizeof(uint8_t));
-    IMAGE_FORMAT tmp = src;
-    src = dst;  // intermediate gamma is 0.0f
-    dst = tmp;  // original src's gamma is preserved
-    src.npm_ = GetTransformNPM(NPM_TYPE::SRGB_D65);
-    dst.buf_ = staging.data();
-    dst.npm_ = GetTransformNPM(NPM_TYPE::P3_D65_INV);
-    dst.gamma_ = DEFAULT_DISPLAY_GAMMA,
-
-    TransformColorSpace(dst, src);
-    imgBits = staging.data();
+
+  GLuint* ids[] = {&p3Id_, &sRGBId_};
+  for (GLuint* id : ids) {
+    glGenTextures(1, id);
+    glBindTexture(GL_TEXTURE_2D, *id);
+    glTexImage2D(GL_TEXTURE_2D, 0,       // mip level
+                 textureInternalFormat,  // GL_SRGB8_ALPHA8 for p3_ext mode,
+                                         // GL_RGBA for p3_passthrough_ext
+                 width, height,
+                 0,  // border color
+                 GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  }
+}
+
+/*
+ * CreateGLTextures()
+ *     Creates the textures from an image a TexturePipeline prepared for the
+ *     current display color space
+ */
+bool AssetTexture::CreateGLTextures(const PREPARED_IMAGE& image) {
+  ASSERT(dispColorSpace_ != DISPLAY_COLORSPACE::INVALID,
+         "eglContext_ color space not set");
+  if (valid_) {
+    glDeleteTextures(1, &p3Id_);
+    glDeleteTextures(1, &sRGBId_);
+    valid_ = false;
+    p3Id_ = INVALID_TEXTURE_ID;
+    sRGBId_ = INVALID_TEXTURE_ID;
+  }
+  if (!image.valid_) {
+    LOGE("==== Failed to decode %s", name_.c_str());
+    return false;
   }
-  glTexImage2D(GL_TEXTURE_2D, 0,       // mip level
-               textureInternalFormat,  // GL_SRGB8_ALPHA8 for p3_ext mode,
-                                       // GL_RGBA for p3_passthrough_ext
-               imgWidth, imgHeight,
-               0,  // border color
-               GL_RGBA, GL_UNSIGNED_BYTE, imgBits);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
+  AllocateTextures(image.width_, image.height_);
+  const uint8_t* sRGBBits = image.sRGBView_.data();
+  UploadImage(0, image.width_, image.height_,
+              image.p3_.empty() ? sRGBBits : image.p3_.data(), sRGBBits);
   glBindTexture(GL_TEXTURE_2D, 0);
-  stbi_image_free(imageData);
   valid_ = true;
 
   return true;
 }
 
+/*
+ * UploadRows()
+ *     Converts rowCount rows of the image (starting at firstRow) from its
+ *     source color space and uploads them to both textures; staging holds
+ *     the converted rows.
+ *       sRGB display: both textures get the image converted to sRGB
+ *       P3 displays:  the P3 texture gets the image in P3 (the original one
+ *                     if it is in P3 already), the sRGB view the image
+ *                     clipped to the sRGB gamut and back to P3, so we
+ *                     could display_ it correctly on P3 device mode
+ */
+void AssetTexture::UploadRows(const SOURCE_SPACE& source, uint32_t firstRow,
+                              uint32_t width, uint32_t rowCount,
+                              uint8_t* rows, uint8_t* staging) {
+  bool p3Display = dispColorSpace_ != DISPLAY_COLORSPACE::SRGB;
+  TexturePipeline::ConvertRows(p3Display, source, width, rowCount, rows,
+                               staging);
+  UploadImage(firstRow, width, rowCount, p3Display ? rows : staging, staging);
+}
+
+void AssetTexture::UploadImage(uint32_t firstRow, uint32_t width,
+                               uint32_t rowCount, const uint8_t* p3Bits,
+                               const uint8_t* sRGBBits) {
+  glBindTexture(GL_TEXTURE_2D, p3Id_);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, width, rowCount, GL_RGBA,
+                  GL_UNSIGNED_BYTE, p3Bits);
+  glBindTexture(GL_TEXTURE_2D, sRGBId_);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, width, rowCount, GL_RGBA,
+                  GL_UNSIGNED_BYTE, sRGBBits);
+}
+
 std::string& AssetTexture::Name(void) { return name_; }
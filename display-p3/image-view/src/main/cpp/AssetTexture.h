@@ -21,7 +21,9 @@
 #include <android/asset_manager.h>
 
 #include <string>
+#include <vector>
 
+#include "TexturePipeline.h"
 #include "common.h"
 
 class AssetTexture {
@@ -32,12 +34,21 @@ class AssetTexture {
   bool valid_;
   enum DISPLAY_COLORSPACE dispColorSpace_;
 
+  bool CreateFromWholeImage(std::vector<uint8_t>& fileData);
+  void AllocateTextures(uint32_t width, uint32_t height);
+  void UploadRows(const SOURCE_SPACE& source, uint32_t firstRow,
+                  uint32_t width, uint32_t rowCount, uint8_t* rows,
+                  uint8_t* staging);
+  void UploadImage(uint32_t firstRow, uint32_t width, uint32_t rowCount,
+                   const uint8_t* p3Bits, const uint8_t* sRGBBits);
+
  public:
   explicit AssetTexture(const std::string& name);
   ~AssetTexture();
   void ColorSpace(enum DISPLAY_COLORSPACE clrSpace);
   DISPLAY_COLORSPACE ColorSpace(void);
   bool CreateGLTextures(AAssetManager* mgr);
+  bool CreateGLTextures(const PREPARED_IMAGE& image);
   bool IsValid(void);
   GLuint P3TexId(void);
   GLuint SRGBATexId(void);
@@ -0,0 +1,685 @@
+/*
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "ColorLut3D.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "android_debug.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// LUT entries: 1.0 in 14 bit fixed point (so the weighted sums of
+// tetrahedral interpolation fit in 32 bits, and the output conversions are
+// shifts); positions in a grid cell: 12 fraction bits
+#define LUT_ONE 16384
+#define LUT_SHIFT 14
+#define FRACTION_BITS 12
+#define FRACTION_ONE (1 << FRACTION_BITS)
+
+#define MIN_GRID_SIZE 2
+#define MAX_GRID_SIZE 64
+
+// Apply() gives each thread at least this many rows
+#define MIN_ROWS_PER_THREAD 16
+
+// disk cache files: header, then the table
+#define LUT_FILE_MAGIC 0x3354554c  // "LUT3"
+#define LUT_FILE_VERSION 1
+struct LUT_FILE_HEADER {
+  uint32_t magic_;
+  uint32_t version_;
+  uint32_t size_;
+  uint32_t reserved_;
+  uint64_t hash_;
+};
+
+/*
+ * HashBytes()
+ *     FNV-1a, 64 bit
+ */
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t idx = 0; idx < size; idx++) {
+    hash = (hash ^ bytes[idx]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+#define HASH_SEED 0xcbf29ce484222325ULL
+
+/*
+ * DecodeTRC() / EncodeTRC()
+ *     The transfer curves, extended to negative values by symmetry (colors
+ *     outside the gamut of a matrix step, before a clip)
+ */
+static double DecodeTRC(double val, TRC_TYPE trc, float gamma) {
+  if (gamma <= 0.0f) return val;
+  double mag = std::fabs(val);
+  if (trc == TRC_SRGB) {
+    mag = mag < 0.04045 ? mag / 12.92
+                        : std::pow((mag + 0.055) / 1.055, 1.0 / gamma);
+  } else {
+    mag = std::pow(mag, 1.0 / gamma);
+  }
+  return val < 0.0 ? -mag : mag;
+}
+
+static double EncodeTRC(double val, TRC_TYPE trc, float gamma) {
+  if (gamma <= 0.0f) return val;
+  double mag = std::fabs(val);
+  if (trc == TRC_SRGB) {
+    mag = mag < 0.0031308 ? mag * 12.92
+                          : 1.055 * std::pow(mag, static_cast<double>(gamma)) -
+                                0.055;
+  } else {
+    mag = std::pow(mag, static_cast<double>(gamma));
+  }
+  return val < 0.0 ? -mag : mag;
+}
+
+ColorPipeline& ColorPipeline::Matrix(const mathfu::mat3& matrix) {
+  COLOR_STEP step{COLOR_STEP_MATRIX, TRC_SRGB, 0.0f, {}};
+  for (int32_t idx = 0; idx < 9; idx++) {
+    step.matrix_[idx] = matrix(idx / 3, idx % 3);
+  }
+  steps_.push_back(step);
+  return *this;
+}
+
+ColorPipeline& ColorPipeline::Decode(TRC_TYPE trc, float gamma) {
+  steps_.push_back(COLOR_STEP{COLOR_STEP_DECODE, trc, gamma, {}});
+  return *this;
+}
+
+ColorPipeline& ColorPipeline::Encode(TRC_TYPE trc, float gamma) {
+  steps_.push_back(COLOR_STEP{COLOR_STEP_ENCODE, trc, gamma, {}});
+  return *this;
+}
+
+ColorPipeline& ColorPipeline::Clip(void) {
+  steps_.push_back(COLOR_STEP{COLOR_STEP_CLIP, TRC_SRGB, 0.0f, {}});
+  return *this;
+}
+
+void ColorPipeline::Apply(double* rgb) const {
+  for (const COLOR_STEP& step : steps_) {
+    switch (step.type_) {
+      case COLOR_STEP_MATRIX: {
+        const float* m = step.matrix_;
+        double r = rgb[0], g = rgb[1], b = rgb[2];
+        rgb[0] = m[0] * r + m[1] * g + m[2] * b;
+        rgb[1] = m[3] * r + m[4] * g + m[5] * b;
+        rgb[2] = m[6] * r + m[7] * g + m[8] * b;
+        break;
+      }
+      case COLOR_STEP_DECODE:
+        for (int32_t ch = 0; ch < 3; ch++) {
+          rgb[ch] = DecodeTRC(rgb[ch], step.trc_, step.gamma_);
+        }
+        break;
+      case COLOR_STEP_ENCODE:
+        for (int32_t ch = 0; ch < 3; ch++) {
+          rgb[ch] = EncodeTRC(rgb[ch], step.trc_, step.gamma_);
+        }
+        break;
+      case COLOR_STEP_CLIP:
+        for (int32_t ch = 0; ch < 3; ch++) {
+          rgb[ch] = std::min(std::max(rgb[ch], 0.0), 1.0);
+        }
+        break;
+    }
+  }
+}
+
+uint64_t ColorPipeline::Hash(void) const {
+  uint64_t hash = HASH_SEED;
+  for (const COLOR_STEP& step : steps_) {
+    int32_t type = step.type_, trc = step.trc_;
+    hash = HashBytes(hash, &type, sizeof(type));
+    hash = HashBytes(hash, &trc, sizeof(trc));
+    hash = HashBytes(hash, &step.gamma_, sizeof(step.gamma_));
+    hash = HashBytes(hash, step.matrix_, sizeof(step.matrix_));
+  }
+  return hash;
+}
+
+ColorLut3D::ColorLut3D() : size_(0), fromCache_(false) {}
+
+/*
+ * GridPosition()
+ *     Grid cell and position in it (Q12) of an input value; the last value
+ *     lands at the far end of the last cell, so there are always corners on
+ *     both sides
+ */
+static inline void GridPosition(uint32_t val, uint32_t maxVal, uint32_t size,
+                                uint32_t& cell, uint32_t& fraction) {
+  uint32_t pos = static_cast<uint32_t>(
+      (static_cast<uint64_t>(val) * ((size - 1) << FRACTION_BITS) +
+       maxVal / 2) /
+      maxVal);
+  cell = pos >> FRACTION_BITS;
+  fraction = pos & (FRACTION_ONE - 1);
+  if (cell == size - 1) {
+    cell--;
+    fraction = FRACTION_ONE;
+  }
+}
+
+void ColorLut3D::BuildIndexTables(void) {
+  const uint32_t stride[3] = {4, 4 * size_, 4 * size_ * size_};
+  for (uint32_t val = 0; val < 256; val++) {
+    uint32_t fraction;
+    GridPosition(val, 255, size_, cell8_[val], fraction);
+    fraction8_[val] = static_cast<uint16_t>(fraction);
+    for (int32_t ch = 0; ch < 3; ch++) {
+      offset8_[ch][val] = static_cast<int32_t>(cell8_[val] * stride[ch]);
+      key8_[ch][val] = static_cast<int32_t>(fraction << 16 | stride[ch]);
+    }
+  }
+}
+
+bool ColorLut3D::Build(const ColorPipeline& pipeline, uint32_t gridSize,
+                       const char* cacheDir) {
+  if (gridSize < MIN_GRID_SIZE || gridSize > MAX_GRID_SIZE) {
+    LOGE("=====Error: %s: grid size %u out of range", __FUNCTION__, gridSize);
+    return false;
+  }
+  size_ = gridSize;
+  fromCache_ = false;
+  BuildIndexTables();
+
+  uint64_t hash = pipeline.Hash();
+  uint32_t version = LUT_FILE_VERSION;
+  hash = HashBytes(hash, &gridSize, sizeof(gridSize));
+  hash = HashBytes(hash, &version, sizeof(version));
+  std::string path;
+  if (cacheDir) {
+    char name[32];
+    snprintf(name, sizeof(name), "lut3d_%016llx.bin",
+             static_cast<unsigned long long>(hash));
+    path = std::string(cacheDir) + "/" + name;
+    if (Load(path, hash)) {
+      fromCache_ = true;
+      return true;
+    }
+  }
+
+  table_.resize(size_ * size_ * size_ * 4);
+  int16_t* entry = table_.data();
+  for (uint32_t b = 0; b < size_; b++) {
+    for (uint32_t g = 0; g < size_; g++) {
+      for (uint32_t r = 0; r < size_; r++, entry += 4) {
+        double rgb[3] = {r / (size_ - 1.0), g / (size_ - 1.0),
+                         b / (size_ - 1.0)};
+        pipeline.Apply(rgb);
+        for (int32_t ch = 0; ch < 3; ch++) {
+          double val = std::min(std::max(rgb[ch], 0.0), 1.0);
+          entry[ch] = static_cast<int16_t>(std::lrint(val * LUT_ONE));
+        }
+        entry[3] = 0;
+      }
+    }
+  }
+
+  if (cacheDir) Save(path, hash);
+  return true;
+}
+
+bool ColorLut3D::Load(const std::string& path, uint64_t hash) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) return false;
+
+  LUT_FILE_HEADER header;
+  std::vector<int16_t> table(size_ * size_ * size_ * 4);
+  bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+               header.magic_ == LUT_FILE_MAGIC &&
+               header.version_ == LUT_FILE_VERSION &&
+               header.size_ == size_ && header.hash_ == hash &&
+               fread(table.data(), sizeof(int16_t), table.size(), file) ==
+                   table.size();
+  fclose(file);
+  if (!valid) {
+    LOGW("Ignoring invalid 3D LUT cache file %s", path.c_str());
+    return false;
+  }
+  table_.swap(table);
+  return true;
+}
+
+void ColorLut3D::Save(const std::string& path, uint64_t hash) const {
+  // written aside and renamed, so readers never see part of a file; the
+  // name is unique to this save, so concurrent ones (from other processes
+  // or threads) don't write into each other's file
+  static std::atomic<uint32_t> saveCount(0);
+  std::string tmpPath = path + "." + std::to_string(getpid()) + "." +
+                        std::to_string(saveCount++) + ".tmp";
+  FILE* file = fopen(tmpPath.c_str(), "wb");
+  if (!file) {
+    LOGW("Can't create 3D LUT cache file %s", tmpPath.c_str());
+    return;
+  }
+  LUT_FILE_HEADER header{LUT_FILE_MAGIC, LUT_FILE_VERSION, size_, 0, hash};
+  bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                 fwrite(table_.data(), sizeof(int16_t), table_.size(),
+                        file) == table_.size();
+  written = fclose(file) == 0 && written;
+  if (!written || rename(tmpPath.c_str(), path.c_str())) {
+    LOGW("Can't write 3D LUT cache file %s", path.c_str());
+    remove(tmpPath.c_str());
+  }
+}
+
+/*
+ * TETRAHEDRON
+ *     The 4 corners (table entries) of the tetrahedron of its grid cell a
+ *     color falls in, and their weights (Q12, adding up to 1.0)
+ */
+struct TETRAHEDRON {
+  const int16_t* corner_[4];
+  int16_t weight_[4];
+};
+
+/*
+ * The axes (0: red, 1: green, 2: blue) in order of decreasing position in
+ * the cell, by (r >= g) << 2 | (g >= b) << 1 | (r >= b); two of the
+ * combinations can't happen. Looked up rather than branched on: which
+ * tetrahedron a pixel falls in is unpredictable.
+ */
+static const uint8_t tetrahedronAxes[8][3] = {
+    {2, 1, 0}, {2, 1, 0}, {1, 2, 0}, {1, 0, 2},
+    {2, 0, 1}, {0, 2, 1}, {0, 1, 2}, {0, 1, 2},
+};
+
+static inline void FindTetrahedron(const int16_t* table, uint32_t size,
+                                   const uint32_t* cell,
+                                   const uint32_t* fraction,
+                                   TETRAHEDRON& tetra) {
+  const uint32_t stride[3] = {4, 4 * size, 4 * size * size};
+  const int16_t* base =
+      table + cell[0] * stride[0] + cell[1] * stride[1] + cell[2] * stride[2];
+  uint32_t fr = fraction[0], fg = fraction[1], fb = fraction[2];
+  const uint8_t* axes =
+      tetrahedronAxes[(fr >= fg) << 2 | (fg >= fb) << 1 | (fr >= fb)];
+  uint32_t s1 = stride[axes[0]], s2 = stride[axes[1]];
+  uint32_t f1 = fraction[axes[0]], f2 = fraction[axes[1]],
+           f3 = fraction[axes[2]];
+  tetra.corner_[0] = base;
+  tetra.corner_[1] = base + s1;
+  tetra.corner_[2] = base + s1 + s2;
+  tetra.corner_[3] = base + stride[0] + stride[1] + stride[2];
+  tetra.weight_[0] = static_cast<int16_t>(FRACTION_ONE - f1);
+  tetra.weight_[1] = static_cast<int16_t>(f1 - f2);
+  tetra.weight_[2] = static_cast<int16_t>(f2 - f3);
+  tetra.weight_[3] = static_cast<int16_t>(f3);
+}
+
+/*
+ * Interpolate*()
+ *     One color from its tetrahedron, to 8 or 16 bit RGB (alpha is left
+ *     for the caller): the weighted sum of the corners, rounded to LUT_ONE
+ *     fixed point, then scaled to the output with rounding
+ */
+static inline void InterpolateScalar(const TETRAHEDRON& tetra, bool wide,
+                                     uint8_t* dst) {
+  for (int32_t ch = 0; ch < 3; ch++) {
+    int32_t sum = 0;
+    for (int32_t corner = 0; corner < 4; corner++) {
+      sum += tetra.weight_[corner] * tetra.corner_[corner][ch];
+    }
+    int32_t val = (sum + (FRACTION_ONE >> 1)) >> FRACTION_BITS;
+    if (wide) {
+      reinterpret_cast<uint16_t*>(dst)[ch] = static_cast<uint16_t>(
+          (val * 65535 + (LUT_ONE >> 1)) >> LUT_SHIFT);
+    } else {
+      dst[ch] =
+          static_cast<uint8_t>((val * 255 + (LUT_ONE >> 1)) >> LUT_SHIFT);
+    }
+  }
+}
+
+/*
+ * PIXEL_QUAD
+ *     Four pixels for the SIMD kernels, one lane each: the table offset of
+ *     their grid cell, and per axis a sort key of their position in the cell
+ *     (Q12) above the table stride of the axis. Sorting the keys gives the
+ *     tetrahedron: the axes by decreasing position, and the weights.
+ */
+struct PIXEL_QUAD {
+  alignas(16) int32_t base_[4];
+  alignas(16) int32_t key_[3][4];
+  alignas(16) uint32_t alpha_[4];  // in the output's bit depth
+};
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HAS_SIMD_KERNEL 1
+static inline void InterpolateSimd4(const int16_t* table, int32_t farCorner,
+                                    const PIXEL_QUAD& quad, bool wide,
+                                    uint8_t* dst) {
+  // a sorting network: first >= second >= third
+  int32x4_t k0 = vld1q_s32(quad.key_[0]);
+  int32x4_t k1 = vld1q_s32(quad.key_[1]);
+  int32x4_t k2 = vld1q_s32(quad.key_[2]);
+  int32x4_t hi = vmaxq_s32(k0, k1), lo = vminq_s32(k0, k1);
+  int32x4_t first = vmaxq_s32(hi, k2), mid = vminq_s32(hi, k2);
+  int32x4_t second = vmaxq_s32(mid, lo), third = vminq_s32(mid, lo);
+
+  int32x4_t strideMask = vdupq_n_s32(0xffff);
+  int32x4_t f1 = vshrq_n_s32(first, 16), f2 = vshrq_n_s32(second, 16),
+            f3 = vshrq_n_s32(third, 16);
+  alignas(16) int32_t corner1[4], corner2[4];
+  int32x4_t offset1 =
+      vaddq_s32(vld1q_s32(quad.base_), vandq_s32(first, strideMask));
+  vst1q_s32(corner1, offset1);
+  vst1q_s32(corner2, vaddq_s32(offset1, vandq_s32(second, strideMask)));
+  alignas(16) int16_t weight[4][4];
+  vst1_s16(weight[0], vmovn_s32(vsubq_s32(vdupq_n_s32(FRACTION_ONE), f1)));
+  vst1_s16(weight[1], vmovn_s32(vsubq_s32(f1, f2)));
+  vst1_s16(weight[2], vmovn_s32(vsubq_s32(f2, f3)));
+  vst1_s16(weight[3], vmovn_s32(f3));
+
+  int32x4_t sum[4];
+  for (int32_t idx = 0; idx < 4; idx++) {
+    const int16_t* c0 = table + quad.base_[idx];
+    int32x4_t s = vmull_n_s16(vld1_s16(c0), weight[0][idx]);
+    s = vmlal_n_s16(s, vld1_s16(table + corner1[idx]), weight[1][idx]);
+    s = vmlal_n_s16(s, vld1_s16(table + corner2[idx]), weight[2][idx]);
+    s = vmlal_n_s16(s, vld1_s16(c0 + farCorner), weight[3][idx]);
+    sum[idx] = vrshrq_n_s32(s, FRACTION_BITS);
+  }
+
+  if (wide) {
+    uint16_t* out = reinterpret_cast<uint16_t*>(dst);
+    for (int32_t idx = 0; idx < 4; idx++, out += 4) {
+      uint16x4_t val = vqmovun_s32(
+          vrshrq_n_s32(vmulq_n_s32(sum[idx], 65535), LUT_SHIFT));
+      vst1_u16(out, vset_lane_u16(static_cast<uint16_t>(quad.alpha_[idx]),
+                                  val, 3));
+    }
+  } else {
+    int16x4_t val[4];
+    for (int32_t idx = 0; idx < 4; idx++) {
+      val[idx] =
+          vmovn_s32(vrshrq_n_s32(vmulq_n_s32(sum[idx], 255), LUT_SHIFT));
+    }
+    uint8x16_t rgb = vcombine_u8(vqmovun_s16(vcombine_s16(val[0], val[1])),
+                                 vqmovun_s16(vcombine_s16(val[2], val[3])));
+    uint32x4_t px = vorrq_u32(
+        vandq_u32(vreinterpretq_u32_u8(rgb), vdupq_n_u32(0x00ffffff)),
+        vshlq_n_u32(vld1q_u32(quad.alpha_), 24));
+    vst1q_u8(dst, vreinterpretq_u8_u32(px));
+  }
+}
+#elif defined(__SSE2__)
+#define HAS_SIMD_KERNEL 1
+// SSE2 has no 32 bit min / max
+static inline __m128i Max32(__m128i a, __m128i b) {
+  __m128i gt = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+}
+static inline __m128i Min32(__m128i a, __m128i b) {
+  __m128i gt = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+}
+
+static inline void InterpolateSimd4(const int16_t* table, int32_t farCorner,
+                                    const PIXEL_QUAD& quad, bool wide,
+                                    uint8_t* dst) {
+  // a sorting network: first >= second >= third
+  __m128i k0 = _mm_load_si128(reinterpret_cast<const __m128i*>(quad.key_[0]));
+  __m128i k1 = _mm_load_si128(reinterpret_cast<const __m128i*>(quad.key_[1]));
+  __m128i k2 = _mm_load_si128(reinterpret_cast<const __m128i*>(quad.key_[2]));
+  __m128i hi = Max32(k0, k1), lo = Min32(k0, k1);
+  __m128i first = Max32(hi, k2), mid = Min32(hi, k2);
+  __m128i second = Max32(mid, lo), third = Min32(mid, lo);
+
+  __m128i strideMask = _mm_set1_epi32(0xffff);
+  __m128i f1 = _mm_srli_epi32(first, 16), f2 = _mm_srli_epi32(second, 16),
+          f3 = _mm_srli_epi32(third, 16);
+  alignas(16) int32_t corner1[4], corner2[4];
+  __m128i offset1 = _mm_add_epi32(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(quad.base_)),
+      _mm_and_si128(first, strideMask));
+  _mm_store_si128(reinterpret_cast<__m128i*>(corner1), offset1);
+  _mm_store_si128(
+      reinterpret_cast<__m128i*>(corner2),
+      _mm_add_epi32(offset1, _mm_and_si128(second, strideMask)));
+  // weights in pairs, (w0, w1) and (w2, w3), for madd
+  alignas(16) int32_t w01[4], w23[4];
+  _mm_store_si128(
+      reinterpret_cast<__m128i*>(w01),
+      _mm_or_si128(_mm_sub_epi32(_mm_set1_epi32(FRACTION_ONE), f1),
+                   _mm_slli_epi32(_mm_sub_epi32(f1, f2), 16)));
+  _mm_store_si128(
+      reinterpret_cast<__m128i*>(w23),
+      _mm_or_si128(_mm_sub_epi32(f2, f3), _mm_slli_epi32(f3, 16)));
+
+  __m128i sum[4];
+  __m128i round = _mm_set1_epi32(FRACTION_ONE >> 1);
+  for (int32_t idx = 0; idx < 4; idx++) {
+    // corners interleaved in pairs, so madd weighs and adds two at a time
+    const int16_t* c0 = table + quad.base_[idx];
+    __m128i c01 = _mm_unpacklo_epi16(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(c0)),
+        _mm_loadl_epi64(
+            reinterpret_cast<const __m128i*>(table + corner1[idx])));
+    __m128i c23 = _mm_unpacklo_epi16(
+        _mm_loadl_epi64(
+            reinterpret_cast<const __m128i*>(table + corner2[idx])),
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(c0 + farCorner)));
+    __m128i s = _mm_add_epi32(_mm_madd_epi16(c01, _mm_set1_epi32(w01[idx])),
+                              _mm_madd_epi16(c23, _mm_set1_epi32(w23[idx])));
+    sum[idx] = _mm_srai_epi32(_mm_add_epi32(s, round), FRACTION_BITS);
+  }
+
+  __m128i half = _mm_set1_epi32(LUT_ONE >> 1);
+  if (wide) {
+    // val * 65535 = (val << 16) - val; then to unsigned 16 bit through a
+    // signed pack
+    __m128i val[4];
+    for (int32_t idx = 0; idx < 4; idx++) {
+      __m128i v = _mm_sub_epi32(_mm_slli_epi32(sum[idx], 16), sum[idx]);
+      v = _mm_srai_epi32(_mm_add_epi32(v, half), LUT_SHIFT);
+      val[idx] = _mm_sub_epi32(v, _mm_set1_epi32(32768));
+    }
+    __m128i flip = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+    __m128i px01 = _mm_xor_si128(_mm_packs_epi32(val[0], val[1]), flip);
+    __m128i px23 = _mm_xor_si128(_mm_packs_epi32(val[2], val[3]), flip);
+    px01 = _mm_insert_epi16(px01, quad.alpha_[0], 3);
+    px01 = _mm_insert_epi16(px01, quad.alpha_[1], 7);
+    px23 = _mm_insert_epi16(px23, quad.alpha_[2], 3);
+    px23 = _mm_insert_epi16(px23, quad.alpha_[3], 7);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), px01);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), px23);
+  } else {
+    // val * 255 = (val << 8) - val
+    __m128i val[4];
+    for (int32_t idx = 0; idx < 4; idx++) {
+      __m128i v = _mm_sub_epi32(_mm_slli_epi32(sum[idx], 8), sum[idx]);
+      val[idx] = _mm_srai_epi32(_mm_add_epi32(v, half), LUT_SHIFT);
+    }
+    __m128i rgb = _mm_packus_epi16(_mm_packs_epi32(val[0], val[1]),
+                                   _mm_packs_epi32(val[2], val[3]));
+    __m128i alpha = _mm_slli_epi32(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(quad.alpha_)), 24);
+    __m128i px = _mm_or_si128(
+        _mm_and_si128(rgb, _mm_set1_epi32(0x00ffffff)), alpha);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), px);
+  }
+}
+#else
+#define HAS_SIMD_KERNEL 0
+#endif
+
+/*
+ * PixelPosition()
+ *     Grid cell and position in it of one source pixel, and its alpha in
+ *     the output's bit depth
+ */
+static inline void PixelPosition(const uint8_t* srcPixel, bool wideSrc,
+                                 bool wideDst, uint32_t size,
+                                 const uint32_t* cell8,
+                                 const uint16_t* fraction8, uint32_t* cell,
+                                 uint32_t* fraction, uint32_t& alpha) {
+  if (wideSrc) {
+    const uint16_t* in = reinterpret_cast<const uint16_t*>(srcPixel);
+    for (int32_t ch = 0; ch < 3; ch++) {
+      GridPosition(in[ch], 65535, size, cell[ch], fraction[ch]);
+    }
+    alpha = wideDst ? in[3] : (in[3] * 255 + 32895) >> 16;
+  } else {
+    for (int32_t ch = 0; ch < 3; ch++) {
+      cell[ch] = cell8[srcPixel[ch]];
+      fraction[ch] = fraction8[srcPixel[ch]];
+    }
+    alpha = wideDst ? srcPixel[3] * 257 : srcPixel[3];
+  }
+}
+
+void ColorLut3D::ApplyRows(IMAGE_FORMAT& dst, IMAGE_FORMAT& src,
+                           uint32_t firstRow, uint32_t rowCount,
+                           bool simd) const {
+  bool wideSrc = src.format_ == PIXEL_RGBA16;
+  bool wideDst = dst.format_ == PIXEL_RGBA16;
+  uint32_t srcPixelBytes = wideSrc ? 8 : 4, dstPixelBytes = wideDst ? 8 : 4;
+  const uint8_t* srcRow = static_cast<const uint8_t*>(src.buf_) +
+                          firstRow * src.width_ * srcPixelBytes;
+  uint8_t* dstRow =
+      static_cast<uint8_t*>(dst.buf_) + firstRow * src.width_ * dstPixelBytes;
+#if HAS_SIMD_KERNEL
+  const int32_t stride[3] = {4, static_cast<int32_t>(4 * size_),
+                             static_cast<int32_t>(4 * size_ * size_)};
+#endif
+
+  for (uint32_t row = 0; row < rowCount; row++) {
+    const uint8_t* srcPixel = srcRow;
+    uint8_t* dstPixel = dstRow;
+    uint32_t col = 0;
+#if HAS_SIMD_KERNEL
+    // four pixels at a time: all four are read before any is written, so
+    // dst may be src
+    for (; simd && col + 4 <= src.width_; col += 4) {
+      // one of the two loops runs (measured faster than a branch in one)
+      PIXEL_QUAD quad;
+      for (int32_t idx = 0; !wideSrc && idx < 4; idx++) {
+        const uint8_t* in = srcPixel;
+        quad.base_[idx] =
+            offset8_[0][in[0]] + offset8_[1][in[1]] + offset8_[2][in[2]];
+        for (int32_t ch = 0; ch < 3; ch++) {
+          quad.key_[ch][idx] = key8_[ch][in[ch]];
+        }
+        quad.alpha_[idx] = wideDst ? in[3] * 257 : in[3];
+        srcPixel += srcPixelBytes;
+      }
+      for (int32_t idx = 0; wideSrc && idx < 4; idx++) {
+        uint32_t cell[3], fraction[3];
+        PixelPosition(srcPixel, wideSrc, wideDst, size_, cell8_, fraction8_,
+                      cell, fraction, quad.alpha_[idx]);
+        quad.base_[idx] = 0;
+        for (int32_t ch = 0; ch < 3; ch++) {
+          quad.base_[idx] += cell[ch] * stride[ch];
+          quad.key_[ch][idx] = fraction[ch] << 16 | stride[ch];
+        }
+        srcPixel += srcPixelBytes;
+      }
+      InterpolateSimd4(table_.data(), stride[0] + stride[1] + stride[2],
+                       quad, wideDst, dstPixel);
+      dstPixel += 4 * dstPixelBytes;
+    }
+#endif
+    for (; col < src.width_; col++) {
+      uint32_t cell[3], fraction[3], alpha;
+      PixelPosition(srcPixel, wideSrc, wideDst, size_, cell8_, fraction8_,
+                    cell, fraction, alpha);
+      TETRAHEDRON tetra;
+      FindTetrahedron(table_.data(), size_, cell, fraction, tetra);
+      InterpolateScalar(tetra, wideDst, dstPixel);
+      if (wideDst) {
+        reinterpret_cast<uint16_t*>(dstPixel)[3] =
+            static_cast<uint16_t>(alpha);
+      } else {
+        dstPixel[3] = static_cast<uint8_t>(alpha);
+      }
+      srcPixel += srcPixelBytes;
+      dstPixel += dstPixelBytes;
+    }
+    srcRow += src.width_ * srcPixelBytes;
+    dstRow += src.width_ * dstPixelBytes;
+  }
+}
+
+bool ColorLut3D::CheckFormats(IMAGE_FORMAT& dst, IMAGE_FORMAT& src) const {
+  if (!size_ || !dst.buf_ || !src.buf_) {
+    LOGE("=====Error: Invalid Parameters to ColorLut3D::Apply()");
+    return false;
+  }
+  bool srcOk = src.format_ == PIXEL_RGBA8 || src.format_ == PIXEL_RGBA16;
+  bool dstOk = dst.format_ == PIXEL_RGBA8 || dst.format_ == PIXEL_RGBA16;
+  if (!srcOk || !dstOk) {
+    LOGE("=====Error: ColorLut3D only converts RGBA8 and RGBA16 images");
+    return false;
+  }
+  if (dst.buf_ == src.buf_ && dst.format_ != src.format_) {
+    LOGE("=====Error: ColorLut3D can't change pixel format in place");
+    return false;
+  }
+  return true;
+}
+
+bool ColorLut3D::Apply(IMAGE_FORMAT& dst, IMAGE_FORMAT& src,
+                       uint32_t threadCount) const {
+  if (!CheckFormats(dst, src)) return false;
+
+  if (!threadCount) {
+    threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  threadCount =
+      std::min(threadCount, std::max(src.height_ / MIN_ROWS_PER_THREAD, 1u));
+
+  // bands of rows: the last one on this thread
+  std::vector<std::thread> threads;
+  uint32_t firstRow = 0;
+  for (uint32_t idx = 0; idx < threadCount; idx++) {
+    uint32_t rowCount = (src.height_ - firstRow) / (threadCount - idx);
+    if (idx + 1 < threadCount) {
+      threads.emplace_back(&ColorLut3D::ApplyRows, this, std::ref(dst),
+                           std::ref(src), firstRow, rowCount, true);
+    } else {
+      ApplyRows(dst, src, firstRow, rowCount, true);
+    }
+    firstRow += rowCount;
+  }
+  for (std::thread& thread : threads) thread.join();
+  return true;
+}
+
+bool ColorLut3D::ApplyScalar(IMAGE_FORMAT& dst, IMAGE_FORMAT& src) const {
+  if (!CheckFormats(dst, src)) return false;
+  ApplyRows(dst, src, 0, src.height_, false);
+  return true;
+}
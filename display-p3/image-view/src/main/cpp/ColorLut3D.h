@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef __COLOR_LUT_3D_H__
+#define __COLOR_LUT_3D_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ColorSpaceTransform.h"
+
+/*
+ * Transfer curves of COLOR_STEP_DECODE / COLOR_STEP_ENCODE steps; gamma is
+ * the encoding exponent, as IMAGE_FORMAT::gamma_ (1/2.2 for 2.2 images)
+ *   TRC_SRGB:  the piecewise curve TransformColorSpace() uses
+ *   TRC_POWER: pure power law
+ */
+enum TRC_TYPE { TRC_SRGB = 0, TRC_POWER };
+
+enum COLOR_STEP_TYPE {
+  COLOR_STEP_MATRIX = 0,  // rgb = matrix * rgb
+  COLOR_STEP_DECODE,      // encoded to linear
+  COLOR_STEP_ENCODE,      // linear to encoded
+  COLOR_STEP_CLIP,        // clamp each channel to 0.0 -- 1.0
+};
+
+struct COLOR_STEP {
+  COLOR_STEP_TYPE type_;
+  TRC_TYPE trc_;
+  float gamma_;
+  float matrix_[9];  // row major
+};
+
+/*
+ * ColorPipeline
+ *     A list of steps from source RGB to destination RGB, evaluated exactly
+ *     (in double precision) to build a ColorLut3D. For example, P3 to sRGB
+ *     clipped to the sRGB gamut:
+ *       ColorPipeline p;
+ *       p.Decode(TRC_SRGB, DEFAULT_P3_IMAGE_GAMMA)
+ *           .Matrix(*GetTransformNPM(SRGB_D65_INV) * *GetTransformNPM(P3_D65))
+ *           .Clip()
+ *           .Encode(TRC_SRGB, DEFAULT_DISPLAY_GAMMA);
+ */
+class ColorPipeline {
+ public:
+  ColorPipeline& Matrix(const mathfu::mat3& matrix);
+  ColorPipeline& Decode(TRC_TYPE trc, float gamma);
+  ColorPipeline& Encode(TRC_TYPE trc, float gamma);
+  ColorPipeline& Clip(void);
+
+  // in place on one color, 0.0 -- 1.0 in (out may be out of range without a
+  // final clip)
+  void Apply(double* rgb) const;
+
+  // identifies the pipeline for the LUT disk cache
+  uint64_t Hash(void) const;
+
+  const std::vector<COLOR_STEP>& Steps(void) const { return steps_; }
+
+ private:
+  std::vector<COLOR_STEP> steps_;
+};
+
+/*
+ * ColorLut3D
+ *     A ColorPipeline sampled on a size^3 grid, applied to images with
+ *     tetrahedral interpolation. Entries are 14 bit fixed point RGB; images
+ *     are R8G8B8A8 or R16G16B16A16 (IMAGE_FORMAT::format_ PIXEL_RGBA8 or
+ *     PIXEL_RGBA16), in any combination, alpha is copied.
+ *     It is for conversions the analytic transforms of ColorSpaceTransform.h
+ *     can't express (any chain of curves, matrices and clips): for the ones
+ *     they can, they are about twice as fast and more accurate (see
+ *     host/lut_bench). The app has no such conversion, so only the host
+ *     build compiles it.
+ */
+class ColorLut3D {
+ public:
+  static const uint32_t SMALL_GRID = 17;
+  static const uint32_t LARGE_GRID = 33;
+
+  ColorLut3D();
+
+  /*
+   * Build()
+   *     Samples pipeline on a gridSize^3 grid (2 -- 64). With a cacheDir,
+   *     first looks for a LUT built earlier from the same pipeline and grid
+   *     size there, and saves what it builds.
+   */
+  bool Build(const ColorPipeline& pipeline, uint32_t gridSize,
+             const char* cacheDir = nullptr);
+
+  /*
+   * Apply()
+   *     dst = LUT(src); dst.buf_ may be src.buf_ if both have the same
+   *     format. Rows are split across threadCount threads (0: one per CPU).
+   */
+  bool Apply(IMAGE_FORMAT& dst, IMAGE_FORMAT& src,
+             uint32_t threadCount = 0) const;
+
+  // Same result as Apply(), plain C on one thread: the reference for the
+  // SIMD kernel
+  bool ApplyScalar(IMAGE_FORMAT& dst, IMAGE_FORMAT& src) const;
+
+  uint32_t GridSize(void) const { return size_; }
+  bool LoadedFromCache(void) const { return fromCache_; }
+
+ private:
+  bool Load(const std::string& path, uint64_t hash);
+  void Save(const std::string& path, uint64_t hash) const;
+  void BuildIndexTables(void);
+  bool CheckFormats(IMAGE_FORMAT& dst, IMAGE_FORMAT& src) const;
+  void ApplyRows(IMAGE_FORMAT& dst, IMAGE_FORMAT& src, uint32_t firstRow,
+                 uint32_t rowCount, bool simd) const;
+
+  uint32_t size_;
+  bool fromCache_;
+  std::vector<int16_t> table_;  // R, G, B, 0 per grid point, red fastest
+  // 8 bit input: grid cell index and position in the cell (Q12) of each
+  // value; for the SIMD kernels, per axis, the table offset of the cell and
+  // the sort key (position above table stride) of each value
+  uint32_t cell8_[256];
+  uint16_t fraction8_[256];
+  int32_t offset8_[3][256];
+  int32_t key8_[3][256];
+};
+
+#endif  // __COLOR_LUT_3D_H__
@@ -16,16 +16,38 @@
  */
 #include "ColorSpaceTransform.h"
 
+#include <array>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
 #include <vector>
 
 #include "android_debug.h"
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define EPSILON 0.000001f
 #define HAS_GAMMA(x) (std::abs(x) > EPSILON && std::abs((x)-1.0f) > EPSILON)
 #define CLIP_COLOR(color, max) ((color > max) ? max : ((color > 0) ? color : 0))
 
+// pixels the chunked kernels stage at a time (their buffers stay in L1)
+#define TRANSFORM_CHUNK_PIXELS 256
+
+// high precision path: 1.0 in its 15 bit linear values, the fractional bits
+// of its matrices, and the size of its encode table
+#define LINEAR_ONE 32767
+#define MATRIX_Q 13
+#define ENCODE_LUT_BITS 12
+#define ENCODE_LUT_SIZE (1 << ENCODE_LUT_BITS)
+
 /*
  * CreateGammaEncodeTable():
  *     sRGB =
@@ -181,9 +203,9 @@ static bool TransformR8G8B8A8(uint8_t* dst, uint8_t* src, uint32_t width,
 
 /*
  * Interface Function:
- *     Convert Color Spaces
+ *     Convert Color Spaces, one full image pass per step
  */
-bool TransformColorSpace(IMAGE_FORMAT& dst, IMAGE_FORMAT& src) {
+bool TransformColorSpaceMultiPass(IMAGE_FORMAT& dst, IMAGE_FORMAT& src) {
   if (!src.npm_ || !dst.npm_ || !dst.buf_ || !src.buf_) {
     LOGE("=====Error: Invalid Parameters to TransformColorSpace()");
     return false;
@@ -207,6 +229,957 @@ bool TransformColorSpace(IMAGE_FORMAT& dst, IMAGE_FORMAT& src) {
   return true;
 }
 
+/*
+ * PIXEL_TRANSFORM
+ *     Everything TransformColorSpace() does to a pixel, as tables: gamma
+ *     decode LUT, matrix in Q10 fixed point (row major), gamma encode LUT.
+ *     Images without gamma get identity LUTs, so the kernels never branch.
+ */
+struct PIXEL_TRANSFORM {
+  uint8_t decode_[256];
+  int16_t matrix_[9];
+  uint8_t encode_[256];
+};
+
+static void BuildPixelTransform(IMAGE_FORMAT& dst, IMAGE_FORMAT& src,
+                                PIXEL_TRANSFORM& xform) {
+  std::vector<uint8_t> table;
+  if (HAS_GAMMA(src.gamma_)) {
+    CreateGammaDecodeTable(1.0f / src.gamma_, table);
+  }
+  for (uint32_t idx = 0; idx < 256; idx++) {
+    xform.decode_[idx] = table.empty() ? idx : table[idx];
+  }
+
+  table.clear();
+  if (HAS_GAMMA(dst.gamma_)) {
+    CreateGammaEncodeTable(dst.gamma_, table);
+  }
+  for (uint32_t idx = 0; idx < 256; idx++) {
+    xform.encode_[idx] = table.empty() ? idx : table[idx];
+  }
+
+  // same rounding as TransformR8G8B8A8()
+  mathfu::mat3 matrix = *dst.npm_ * (*src.npm_);
+  for (int32_t row = 0; row < 3; row++) {
+    for (int32_t col = 0; col < 3; col++) {
+      xform.matrix_[row * 3 + col] =
+          static_cast<int16_t>(matrix(row, col) * 1024 + 0.5f);
+    }
+  }
+}
+
+/*
+ * TransformPixel()
+ *    One pixel, the plain C way; also the reference for the SIMD kernels
+ */
+static inline void TransformPixel(const PIXEL_TRANSFORM& xform, uint8_t* dst,
+                                  const uint8_t* src) {
+  const int16_t* m = xform.matrix_;
+  int32_t r = xform.decode_[src[0]];
+  int32_t g = xform.decode_[src[1]];
+  int32_t b = xform.decode_[src[2]];
+  uint8_t a = src[3];
+  int32_t outR = (m[0] * r + m[1] * g + m[2] * b + 512) >> 10;
+  int32_t outG = (m[3] * r + m[4] * g + m[5] * b + 512) >> 10;
+  int32_t outB = (m[6] * r + m[7] * g + m[8] * b + 512) >> 10;
+  dst[0] = xform.encode_[CLIP_COLOR(outR, 255)];
+  dst[1] = xform.encode_[CLIP_COLOR(outG, 255)];
+  dst[2] = xform.encode_[CLIP_COLOR(outB, 255)];
+  dst[3] = a;
+}
+
+#if defined(__aarch64__)
+/*
+ * AArch64: the whole transform runs in registers, 16 pixels at a time. The
+ * 256 entry LUTs are looked up with four 64 byte TBL/TBX lookups (no gathers).
+ */
+struct NEON_LUT {
+  uint8x16x4_t part_[4];
+};
+
+static inline void LoadLUT(const uint8_t* table, NEON_LUT& lut) {
+  for (int32_t part = 0; part < 4; part++) {
+    for (int32_t reg = 0; reg < 4; reg++) {
+      lut.part_[part].val[reg] = vld1q_u8(table + part * 64 + reg * 16);
+    }
+  }
+}
+
+static inline uint8x16_t LookUp(const NEON_LUT& lut, uint8x16_t idx) {
+  // indices out of a part's 64 entries leave the lane alone
+  uint8x16_t v = vqtbl4q_u8(lut.part_[0], idx);
+  v = vqtbx4q_u8(v, lut.part_[1], vsubq_u8(idx, vdupq_n_u8(64)));
+  v = vqtbx4q_u8(v, lut.part_[2], vsubq_u8(idx, vdupq_n_u8(128)));
+  return vqtbx4q_u8(v, lut.part_[3], vsubq_u8(idx, vdupq_n_u8(192)));
+}
+
+// one output channel of 8 pixels: (m0 * r + m1 * g + m2 * b + 512) >> 10,
+// clamped to 0 -- 255
+static inline uint8x8_t MatrixRow(int16x8_t r, int16x8_t g, int16x8_t b,
+                                  const int16_t* m) {
+  int32x4_t lo = vmull_n_s16(vget_low_s16(r), m[0]);
+  lo = vmlal_n_s16(lo, vget_low_s16(g), m[1]);
+  lo = vmlal_n_s16(lo, vget_low_s16(b), m[2]);
+  int32x4_t hi = vmull_n_s16(vget_high_s16(r), m[0]);
+  hi = vmlal_n_s16(hi, vget_high_s16(g), m[1]);
+  hi = vmlal_n_s16(hi, vget_high_s16(b), m[2]);
+  return vqmovun_s16(
+      vcombine_s16(vqrshrn_n_s32(lo, 10), vqrshrn_n_s32(hi, 10)));
+}
+
+static void TransformPixels(const PIXEL_TRANSFORM& xform, uint8_t* dst,
+                            const uint8_t* src, uint32_t count) {
+  NEON_LUT decode, encode;
+  LoadLUT(xform.decode_, decode);
+  LoadLUT(xform.encode_, encode);
+  const int16_t* m = xform.matrix_;
+  uint32_t idx = 0;
+  for (; idx + 16 <= count; idx += 16) {
+    uint8x16x4_t px = vld4q_u8(src + idx * 4);
+    uint8x16_t rgb[3];
+    for (int32_t ch = 0; ch < 3; ch++) {
+      rgb[ch] = LookUp(decode, px.val[ch]);
+    }
+    int16x8_t r = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(rgb[0])));
+    int16x8_t g = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(rgb[1])));
+    int16x8_t b = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(rgb[2])));
+    int16x8_t r2 = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(rgb[0])));
+    int16x8_t g2 = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(rgb[1])));
+    int16x8_t b2 = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(rgb[2])));
+    for (int32_t ch = 0; ch < 3; ch++) {
+      uint8x16_t v = vcombine_u8(MatrixRow(r, g, b, m + ch * 3),
+                                 MatrixRow(r2, g2, b2, m + ch * 3));
+      px.val[ch] = LookUp(encode, v);
+    }
+    vst4q_u8(dst + idx * 4, px);  // alpha passes through
+  }
+  for (; idx < count; idx++) {
+    TransformPixel(xform, dst + idx * 4, src + idx * 4);
+  }
+}
+
+#else
+/*
+ * Elsewhere there is no cheap 256 entry table lookup, so the pixels go
+ * through the steps in chunks small enough for their staging buffers to stay
+ * in L1 cache: LUT decode into planar R, G, B; SIMD matrix; LUT encode back
+ * to RGBA. The image itself is still read and written only once.
+ */
+
+// in place on planar channels: (m0 * r + m1 * g + m2 * b + 512) >> 10,
+// clamped to 0 -- 255
+static void TransformMatrixPlanar(const int16_t* m, uint8_t* r, uint8_t* g,
+                                  uint8_t* b, uint32_t count) {
+  uint32_t idx = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  for (; idx + 8 <= count; idx += 8) {
+    int16x8_t vr = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(r + idx)));
+    int16x8_t vg = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(g + idx)));
+    int16x8_t vb = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(b + idx)));
+    uint8_t* out[3] = {r + idx, g + idx, b + idx};
+    for (int32_t ch = 0; ch < 3; ch++) {
+      const int16_t* row = m + ch * 3;
+      int32x4_t lo = vmull_n_s16(vget_low_s16(vr), row[0]);
+      lo = vmlal_n_s16(lo, vget_low_s16(vg), row[1]);
+      lo = vmlal_n_s16(lo, vget_low_s16(vb), row[2]);
+      int32x4_t hi = vmull_n_s16(vget_high_s16(vr), row[0]);
+      hi = vmlal_n_s16(hi, vget_high_s16(vg), row[1]);
+      hi = vmlal_n_s16(hi, vget_high_s16(vb), row[2]);
+      vst1_u8(out[ch], vqmovun_s16(vcombine_s16(vqrshrn_n_s32(lo, 10),
+                                                vqrshrn_n_s32(hi, 10))));
+    }
+  }
+#elif defined(__SSE2__)
+  // _mm_madd_epi16 on (r, g) and (b, 1) pairs; the 1 brings in the rounding
+  __m128i zero = _mm_setzero_si128(), one = _mm_set1_epi16(1);
+  __m128i rg[3], br[3];
+  for (int32_t ch = 0; ch < 3; ch++) {
+    const int16_t* row = m + ch * 3;
+    rg[ch] = _mm_set1_epi32((static_cast<uint16_t>(row[1]) << 16) |
+                            static_cast<uint16_t>(row[0]));
+    br[ch] = _mm_set1_epi32((512 << 16) | static_cast<uint16_t>(row[2]));
+  }
+  for (; idx + 8 <= count; idx += 8) {
+    __m128i vr = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(r + idx)), zero);
+    __m128i vg = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(g + idx)), zero);
+    __m128i vb = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + idx)), zero);
+    __m128i rgLo = _mm_unpacklo_epi16(vr, vg);
+    __m128i rgHi = _mm_unpackhi_epi16(vr, vg);
+    __m128i bLo = _mm_unpacklo_epi16(vb, one);
+    __m128i bHi = _mm_unpackhi_epi16(vb, one);
+    uint8_t* out[3] = {r + idx, g + idx, b + idx};
+    for (int32_t ch = 0; ch < 3; ch++) {
+      __m128i lo = _mm_add_epi32(_mm_madd_epi16(rgLo, rg[ch]),
+                                 _mm_madd_epi16(bLo, br[ch]));
+      __m128i hi = _mm_add_epi32(_mm_madd_epi16(rgHi, rg[ch]),
+                                 _mm_madd_epi16(bHi, br[ch]));
+      __m128i v =
+          _mm_packs_epi32(_mm_srai_epi32(lo, 10), _mm_srai_epi32(hi, 10));
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(out[ch]),
+                       _mm_packus_epi16(v, v));
+    }
+  }
+#endif
+  for (; idx < count; idx++) {
+    int32_t vr = r[idx], vg = g[idx], vb = b[idx];
+    int32_t outR = (m[0] * vr + m[1] * vg + m[2] * vb + 512) >> 10;
+    int32_t outG = (m[3] * vr + m[4] * vg + m[5] * vb + 512) >> 10;
+    int32_t outB = (m[6] * vr + m[7] * vg + m[8] * vb + 512) >> 10;
+    r[idx] = static_cast<uint8_t>(CLIP_COLOR(outR, 255));
+    g[idx] = static_cast<uint8_t>(CLIP_COLOR(outG, 255));
+    b[idx] = static_cast<uint8_t>(CLIP_COLOR(outB, 255));
+  }
+}
+
+static void TransformPixels(const PIXEL_TRANSFORM& xform, uint8_t* dst,
+                            const uint8_t* src, uint32_t count) {
+  alignas(16) uint8_t r[TRANSFORM_CHUNK_PIXELS];
+  alignas(16) uint8_t g[TRANSFORM_CHUNK_PIXELS];
+  alignas(16) uint8_t b[TRANSFORM_CHUNK_PIXELS];
+  while (count) {
+    uint32_t n =
+        count < TRANSFORM_CHUNK_PIXELS ? count : TRANSFORM_CHUNK_PIXELS;
+    // whole pixels are loaded and stored as 32 bit words (RGBA in memory
+    // order, so R is the low byte on these little endian CPUs)
+    for (uint32_t idx = 0; idx < n; idx++) {
+      uint32_t px;
+      memcpy(&px, src + idx * 4, 4);
+      r[idx] = xform.decode_[px & 0xFF];
+      g[idx] = xform.decode_[(px >> 8) & 0xFF];
+      b[idx] = xform.decode_[(px >> 16) & 0xFF];
+    }
+    TransformMatrixPlanar(xform.matrix_, r, g, b, n);
+    for (uint32_t idx = 0; idx < n; idx++) {
+      uint32_t px;
+      memcpy(&px, src + idx * 4, 4);
+      px = (px & 0xFF000000) | xform.encode_[r[idx]] |
+           (xform.encode_[g[idx]] << 8) | (xform.encode_[b[idx]] << 16);
+      memcpy(dst + idx * 4, &px, 4);
+    }
+    src += n * 4, dst += n * 4, count -= n;
+  }
+}
+#endif
+
+/*
+ * DecodeGamma() / EncodeGamma()
+ *    The curves of CreateGammaDecodeTable() / CreateGammaEncodeTable(), on
+ *    0.0 -- 1.0 values, for the high precision tables
+ */
+static float DecodeGamma(float val, float gamma) {
+  if (!HAS_GAMMA(gamma)) return val;
+  if (val < 0.04045f) return val / 12.92f;
+  return std::pow((val + 0.055f) / 1.055f, 1.0f / gamma);
+}
+
+static float EncodeGamma(float val, float gamma) {
+  if (!HAS_GAMMA(gamma)) return val;
+  if (val < 0.0031308f) return val * 12.92f;
+  return 1.055f * std::pow(val, gamma) - 0.055f;
+}
+
+/*
+ * FloatToHalf()
+ *    IEEE half float bits of a value in 0.0 -- 1.0, rounded to nearest
+ */
+static uint16_t FloatToHalf(float val) {
+  if (val < 6.103515625e-5f) {  // smallest normal half: subnormal
+    return static_cast<uint16_t>(std::lrint(val * 16777216.0f));
+  }
+  uint32_t bits;
+  memcpy(&bits, &val, sizeof(bits));
+  return static_cast<uint16_t>(((bits + 0x1000) >> 13) - ((127 - 15) << 10));
+}
+
+static int16_t ToFixedPoint(float val, int32_t fractionBits) {
+  long fixed = std::lrint(val * (1 << fractionBits));
+  return static_cast<int16_t>(fixed > INT16_MAX   ? INT16_MAX
+                              : fixed < INT16_MIN ? INT16_MIN
+                                                  : fixed);
+}
+
+static void ToFixedPoint(const mathfu::mat3& matrix, int16_t* fixed) {
+  for (int32_t row = 0; row < 3; row++) {
+    for (int32_t col = 0; col < 3; col++) {
+      fixed[row * 3 + col] = ToFixedPoint(matrix(row, col), MATRIX_Q);
+    }
+  }
+}
+
+/*
+ * PIXEL_TRANSFORM16
+ *     The tables of TransformColorSpaceHighPrecision(): 8 bit encoded to 15
+ *     bit linear, Q13 matrices (two when clipping to a gamut on the way, with
+ *     a clamp between them), 12 bit linear to the output format. Without the
+ *     clip, columns_ has the decode folded into the matrix: entry x of
+ *     columns_[ch] is column ch of matrix_ times the linear value of x, as
+ *     R, G, B, 0 (red's with the rounding added), so the matrix product of a
+ *     pixel is three entries added together.
+ */
+struct PIXEL_TRANSFORM16 {
+  uint16_t decode_[256];
+  int16_t matrix_[9];
+  int16_t clipMatrix_[9];
+  bool clip_;
+  PIXEL_FORMAT format_;
+  uint16_t encode_[ENCODE_LUT_SIZE];  // 8 bit values or half float bits
+  uint16_t alpha_[256];               // half float alpha
+  int32_t columns_[3][256][4];        // zero when clipping
+};
+
+static void BuildPixelTransform16(IMAGE_FORMAT& dst, IMAGE_FORMAT& src,
+                                  const mathfu::mat3* clipNPM,
+                                  PIXEL_TRANSFORM16& xform) {
+  for (uint32_t idx = 0; idx < 256; idx++) {
+    float linear = DecodeGamma(idx / 255.0f, src.gamma_);
+    xform.decode_[idx] =
+        static_cast<uint16_t>(std::lrint(linear * LINEAR_ONE));
+    xform.alpha_[idx] = FloatToHalf(idx / 255.0f);
+  }
+
+  xform.format_ = dst.format_;
+  for (uint32_t idx = 0; idx < ENCODE_LUT_SIZE; idx++) {
+    // the middle of the range of linear values that map to this entry
+    float linear = ((idx << (15 - ENCODE_LUT_BITS)) +
+                    (1 << (14 - ENCODE_LUT_BITS))) /
+                   static_cast<float>(LINEAR_ONE);
+    float encoded = CLIP_COLOR(EncodeGamma(linear, dst.gamma_), 1.0f);
+    xform.encode_[idx] = dst.format_ == PIXEL_RGBA16F
+                             ? FloatToHalf(encoded)
+                             : static_cast<uint16_t>(std::lrint(encoded * 255));
+  }
+
+  xform.clip_ = clipNPM != nullptr;
+  if (xform.clip_) {
+    ToFixedPoint(clipNPM->Inverse() * (*src.npm_), xform.matrix_);
+    ToFixedPoint(*dst.npm_ * (*clipNPM), xform.clipMatrix_);
+  } else {
+    ToFixedPoint(*dst.npm_ * (*src.npm_), xform.matrix_);
+  }
+
+  memset(xform.columns_, 0, sizeof(xform.columns_));
+  if (xform.clip_) return;
+  for (int32_t ch = 0; ch < 3; ch++) {
+    for (uint32_t idx = 0; idx < 256; idx++) {
+      for (int32_t row = 0; row < 3; row++) {
+        xform.columns_[ch][idx][row] =
+            xform.decode_[idx] * xform.matrix_[row * 3 + ch] +
+            (ch ? 0 : 1 << (MATRIX_Q - 1));
+      }
+    }
+  }
+}
+
+/*
+ * TransformPixel16()
+ *    One pixel, the plain C way; also the reference for the SIMD kernels
+ */
+
+// in place on one 15 bit pixel: (m0 * r + m1 * g + m2 * b + 4096) >> 13,
+// clamped to 0 -- LINEAR_ONE
+static inline void MatrixPixel16(const int16_t* m, int32_t* rgb) {
+  const int32_t round = 1 << (MATRIX_Q - 1);
+  int32_t r = rgb[0], g = rgb[1], b = rgb[2];
+  for (int32_t ch = 0; ch < 3; ch++) {
+    const int16_t* row = m + ch * 3;
+    int32_t out = (row[0] * r + row[1] * g + row[2] * b + round) >> MATRIX_Q;
+    rgb[ch] = CLIP_COLOR(out, LINEAR_ONE);
+  }
+}
+
+// one output pixel from the encode table indices of its R, G, B; alpha comes
+// from the source pixel, px (RGBA in memory order)
+template <PIXEL_FORMAT format>
+static inline void EncodePixel16(const PIXEL_TRANSFORM16& xform, uint8_t* dst,
+                                 uint32_t px, uint32_t r, uint32_t g,
+                                 uint32_t b) {
+  if (format == PIXEL_RGBA16F) {
+    uint16_t half[4] = {xform.encode_[r], xform.encode_[g], xform.encode_[b],
+                        xform.alpha_[px >> 24]};
+    memcpy(dst, half, 8);
+  } else {
+    px = (px & 0xFF000000) | xform.encode_[r] | (xform.encode_[g] << 8) |
+         (xform.encode_[b] << 16);
+    memcpy(dst, &px, 4);
+  }
+}
+
+template <PIXEL_FORMAT format>
+static inline void TransformPixel16(const PIXEL_TRANSFORM16& xform,
+                                    uint8_t* dst, const uint8_t* src) {
+  const int32_t shift = 15 - ENCODE_LUT_BITS;
+  uint32_t px;
+  memcpy(&px, src, 4);
+  int32_t rgb[3] = {xform.decode_[px & 0xFF], xform.decode_[(px >> 8) & 0xFF],
+                    xform.decode_[(px >> 16) & 0xFF]};
+  MatrixPixel16(xform.matrix_, rgb);
+  if (xform.clip_) {
+    MatrixPixel16(xform.clipMatrix_, rgb);
+  }
+  EncodePixel16<format>(xform, dst, px, rgb[0] >> shift, rgb[1] >> shift,
+                        rgb[2] >> shift);
+}
+
+#if defined(__aarch64__)
+/*
+ * AArch64: as in TransformPixels(), decode and matrices run in registers, 16
+ * pixels at a time. The 15 bit linear values are looked up as their low and
+ * high bytes, from two 256 entry LUTs. The encode table is too large for
+ * TBL, so its lookups are the only ones done a value at a time.
+ */
+static inline void LoadLUT16(const uint16_t* table, NEON_LUT& low,
+                             NEON_LUT& high) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(table);
+  for (int32_t part = 0; part < 4; part++) {
+    for (int32_t reg = 0; reg < 4; reg++) {
+      uint8x16x2_t entries = vld2q_u8(bytes + (part * 64 + reg * 16) * 2);
+      low.part_[part].val[reg] = entries.val[0];
+      high.part_[part].val[reg] = entries.val[1];
+    }
+  }
+}
+
+// one output channel of 8 pixels: (m0 * r + m1 * g + m2 * b + 4096) >> 13,
+// clamped to 0 -- LINEAR_ONE
+static inline int16x8_t MatrixRow16(int16x8_t r, int16x8_t g, int16x8_t b,
+                                    const int16_t* m) {
+  int32x4_t lo = vmull_n_s16(vget_low_s16(r), m[0]);
+  lo = vmlal_n_s16(lo, vget_low_s16(g), m[1]);
+  lo = vmlal_n_s16(lo, vget_low_s16(b), m[2]);
+  int32x4_t hi = vmull_n_s16(vget_high_s16(r), m[0]);
+  hi = vmlal_n_s16(hi, vget_high_s16(g), m[1]);
+  hi = vmlal_n_s16(hi, vget_high_s16(b), m[2]);
+  int16x8_t v = vcombine_s16(vqrshrn_n_s32(lo, MATRIX_Q),
+                             vqrshrn_n_s32(hi, MATRIX_Q));
+  return vmaxq_s16(v, vdupq_n_s16(0));
+}
+
+template <PIXEL_FORMAT format>
+static void TransformPixelsTo(const PIXEL_TRANSFORM16& xform, uint8_t* dst,
+                              const uint8_t* src, uint32_t count) {
+  NEON_LUT decodeLow, decodeHigh;
+  LoadLUT16(xform.decode_, decodeLow, decodeHigh);
+  const int32_t shift = 15 - ENCODE_LUT_BITS;
+  const uint32_t dstBpp = format == PIXEL_RGBA16F ? 8 : 4;
+  uint32_t idx = 0;
+  for (; idx + 16 <= count; idx += 16) {
+    uint8x16x4_t px = vld4q_u8(src + idx * 4);
+    int16x8_t rgb[2][3];  // pixels 0 -- 7, then 8 -- 15
+    for (int32_t ch = 0; ch < 3; ch++) {
+      uint8x16_t low = LookUp(decodeLow, px.val[ch]);
+      uint8x16_t high = LookUp(decodeHigh, px.val[ch]);
+      rgb[0][ch] = vreinterpretq_s16_u8(vzip1q_u8(low, high));
+      rgb[1][ch] = vreinterpretq_s16_u8(vzip2q_u8(low, high));
+    }
+    uint16_t index[3][16];
+    for (int32_t half = 0; half < 2; half++) {
+      const int16x8_t* in = rgb[half];
+      int16x8_t out[3];
+      for (int32_t ch = 0; ch < 3; ch++) {
+        out[ch] = MatrixRow16(in[0], in[1], in[2], xform.matrix_ + ch * 3);
+      }
+      if (xform.clip_) {
+        int16x8_t clipped[3] = {out[0], out[1], out[2]};
+        for (int32_t ch = 0; ch < 3; ch++) {
+          out[ch] = MatrixRow16(clipped[0], clipped[1], clipped[2],
+                                xform.clipMatrix_ + ch * 3);
+        }
+      }
+      for (int32_t ch = 0; ch < 3; ch++) {
+        vst1q_u16(index[ch] + half * 8,
+                  vshrq_n_u16(vreinterpretq_u16_s16(out[ch]), shift));
+      }
+    }
+    if (format == PIXEL_RGBA16F) {
+      for (uint32_t lane = 0; lane < 16; lane++) {
+        uint32_t alpha = src[(idx + lane) * 4 + 3];
+        EncodePixel16<format>(xform, dst + (idx + lane) * 8, alpha << 24,
+                              index[0][lane], index[1][lane], index[2][lane]);
+      }
+    } else {
+      uint8_t encoded[3][16];
+      for (int32_t ch = 0; ch < 3; ch++) {
+        for (int32_t lane = 0; lane < 16; lane++) {
+          encoded[ch][lane] =
+              static_cast<uint8_t>(xform.encode_[index[ch][lane]]);
+        }
+        px.val[ch] = vld1q_u8(encoded[ch]);
+      }
+      vst4q_u8(dst + idx * 4, px);  // alpha passes through
+    }
+  }
+  for (; idx < count; idx++) {
+    TransformPixel16<format>(xform, dst + idx * dstBpp, src + idx * 4);
+  }
+}
+
+#else
+/*
+ * Elsewhere, without a clip a pixel is three columns_ entries added up (two
+ * pixels per SIMD register) and its encode lookups, with no staging. With
+ * one, the pixels go through the steps in chunks, as in TransformPixels(), on
+ * 15 bit planar channels.
+ */
+
+/*
+ * TransformMatrixPlanar16()
+ *    in place on planar 15 bit channels:
+ *    (m0 * r + m1 * g + m2 * b + 4096) >> 13, clamped to 0 -- LINEAR_ONE,
+ *    then shifted right by encodeShift: 15 - ENCODE_LUT_BITS gives the
+ *    encode table indices, so the encode loop is lookups only.
+ */
+static void TransformMatrixPlanar16(const int16_t* m, int16_t* r, int16_t* g,
+                                    int16_t* b, uint32_t count,
+                                    int32_t encodeShift) {
+  uint32_t idx = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  int16x8_t zero = vdupq_n_s16(0);
+  int16x8_t shift = vdupq_n_s16(static_cast<int16_t>(-encodeShift));
+  for (; idx + 8 <= count; idx += 8) {
+    int16x8_t vr = vld1q_s16(r + idx);
+    int16x8_t vg = vld1q_s16(g + idx);
+    int16x8_t vb = vld1q_s16(b + idx);
+    int16_t* out[3] = {r + idx, g + idx, b + idx};
+    for (int32_t ch = 0; ch < 3; ch++) {
+      const int16_t* row = m + ch * 3;
+      int32x4_t lo = vmull_n_s16(vget_low_s16(vr), row[0]);
+      lo = vmlal_n_s16(lo, vget_low_s16(vg), row[1]);
+      lo = vmlal_n_s16(lo, vget_low_s16(vb), row[2]);
+      int32x4_t hi = vmull_n_s16(vget_high_s16(vr), row[0]);
+      hi = vmlal_n_s16(hi, vget_high_s16(vg), row[1]);
+      hi = vmlal_n_s16(hi, vget_high_s16(vb), row[2]);
+      int16x8_t v = vcombine_s16(vqrshrn_n_s32(lo, MATRIX_Q),
+                                 vqrshrn_n_s32(hi, MATRIX_Q));
+      vst1q_s16(out[ch], vshlq_s16(vmaxq_s16(v, zero), shift));
+    }
+  }
+#elif defined(__SSE2__)
+  __m128i zero = _mm_setzero_si128(), one = _mm_set1_epi16(1);
+  __m128i shift = _mm_cvtsi32_si128(encodeShift);
+  __m128i rg[3], br[3];
+  for (int32_t ch = 0; ch < 3; ch++) {
+    const int16_t* row = m + ch * 3;
+    rg[ch] = _mm_set1_epi32((static_cast<uint16_t>(row[1]) << 16) |
+                            static_cast<uint16_t>(row[0]));
+    br[ch] = _mm_set1_epi32((1 << (MATRIX_Q - 1) << 16) |
+                            static_cast<uint16_t>(row[2]));
+  }
+  for (; idx + 8 <= count; idx += 8) {
+    __m128i vr = _mm_load_si128(reinterpret_cast<const __m128i*>(r + idx));
+    __m128i vg = _mm_load_si128(reinterpret_cast<const __m128i*>(g + idx));
+    __m128i vb = _mm_load_si128(reinterpret_cast<const __m128i*>(b + idx));
+    __m128i rgLo = _mm_unpacklo_epi16(vr, vg);
+    __m128i rgHi = _mm_unpackhi_epi16(vr, vg);
+    __m128i bLo = _mm_unpacklo_epi16(vb, one);
+    __m128i bHi = _mm_unpackhi_epi16(vb, one);
+    int16_t* out[3] = {r + idx, g + idx, b + idx};
+    for (int32_t ch = 0; ch < 3; ch++) {
+      __m128i lo = _mm_add_epi32(_mm_madd_epi16(rgLo, rg[ch]),
+                                 _mm_madd_epi16(bLo, br[ch]));
+      __m128i hi = _mm_add_epi32(_mm_madd_epi16(rgHi, rg[ch]),
+                                 _mm_madd_epi16(bHi, br[ch]));
+      __m128i v = _mm_packs_epi32(_mm_srai_epi32(lo, MATRIX_Q),
+                                  _mm_srai_epi32(hi, MATRIX_Q));
+      _mm_store_si128(reinterpret_cast<__m128i*>(out[ch]),
+                      _mm_srl_epi16(_mm_max_epi16(v, zero), shift));
+    }
+  }
+#endif
+  for (; idx < count; idx++) {
+    int32_t vr = r[idx], vg = g[idx], vb = b[idx];
+    const int32_t round = 1 << (MATRIX_Q - 1);
+    int32_t outR = (m[0] * vr + m[1] * vg + m[2] * vb + round) >> MATRIX_Q;
+    int32_t outG = (m[3] * vr + m[4] * vg + m[5] * vb + round) >> MATRIX_Q;
+    int32_t outB = (m[6] * vr + m[7] * vg + m[8] * vb + round) >> MATRIX_Q;
+    r[idx] = static_cast<int16_t>(CLIP_COLOR(outR, LINEAR_ONE) >> encodeShift);
+    g[idx] = static_cast<int16_t>(CLIP_COLOR(outG, LINEAR_ONE) >> encodeShift);
+    b[idx] = static_cast<int16_t>(CLIP_COLOR(outB, LINEAR_ONE) >> encodeShift);
+  }
+}
+
+// encode table indices of 4 pixels, R, G, B, 0 each: their columns_ entries
+// added up, clamped to 0 -- LINEAR_ONE and shifted
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+static inline void FoldedIndices(const PIXEL_TRANSFORM16& xform,
+                                 const uint8_t* src, uint16_t* index) {
+  const int32_t shift = 15 - ENCODE_LUT_BITS;
+  for (int32_t pair = 0; pair < 2; pair++) {
+    int32x4_t sum[2];
+    for (int32_t pixel = 0; pixel < 2; pixel++) {
+      const uint8_t* px = src + (pair * 2 + pixel) * 4;
+      sum[pixel] = vaddq_s32(vaddq_s32(vld1q_s32(xform.columns_[0][px[0]]),
+                                       vld1q_s32(xform.columns_[1][px[1]])),
+                             vld1q_s32(xform.columns_[2][px[2]]));
+    }
+    int16x8_t v = vcombine_s16(vqshrn_n_s32(sum[0], MATRIX_Q),
+                               vqshrn_n_s32(sum[1], MATRIX_Q));
+    v = vmaxq_s16(v, vdupq_n_s16(0));
+    vst1q_u16(index + pair * 8,
+              vshrq_n_u16(vreinterpretq_u16_s16(v), shift));
+  }
+}
+#elif defined(__SSE2__)
+static inline __m128i SumColumns(const PIXEL_TRANSFORM16& xform,
+                                 const uint8_t* px) {
+  __m128i r = _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(xform.columns_[0][px[0]]));
+  __m128i g = _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(xform.columns_[1][px[1]]));
+  __m128i b = _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(xform.columns_[2][px[2]]));
+  return _mm_add_epi32(_mm_add_epi32(r, g), b);
+}
+
+static inline void FoldedIndices(const PIXEL_TRANSFORM16& xform,
+                                 const uint8_t* src, uint16_t* index) {
+  const int32_t shift = 15 - ENCODE_LUT_BITS;
+  __m128i zero = _mm_setzero_si128();
+  for (int32_t pair = 0; pair < 2; pair++) {
+    const uint8_t* px = src + pair * 8;
+    __m128i v =
+        _mm_packs_epi32(_mm_srai_epi32(SumColumns(xform, px), MATRIX_Q),
+                        _mm_srai_epi32(SumColumns(xform, px + 4), MATRIX_Q));
+    v = _mm_srli_epi16(_mm_max_epi16(v, zero), shift);
+    _mm_store_si128(reinterpret_cast<__m128i*>(index + pair * 8), v);
+  }
+}
+#endif
+
+/*
+ * TransformPixelsFolded()
+ *    TransformPixelsTo() of a conversion without a clip, from columns_
+ */
+template <PIXEL_FORMAT format>
+static void TransformPixelsFolded(const PIXEL_TRANSFORM16& xform,
+                                  uint8_t* dst, const uint8_t* src,
+                                  uint32_t count) {
+  const uint32_t dstBpp = format == PIXEL_RGBA16F ? 8 : 4;
+  uint32_t idx = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__SSE2__)
+  for (; idx + 4 <= count; idx += 4) {
+    uint32_t px[4];
+    memcpy(px, src + idx * 4, sizeof(px));
+    alignas(16) uint16_t index[16];
+    FoldedIndices(xform, src + idx * 4, index);
+    for (uint32_t pixel = 0; pixel < 4; pixel++) {
+      const uint16_t* rgb = index + pixel * 4;
+      EncodePixel16<format>(xform, dst + (idx + pixel) * dstBpp, px[pixel],
+                            rgb[0], rgb[1], rgb[2]);
+    }
+  }
+#endif
+  for (; idx < count; idx++) {
+    TransformPixel16<format>(xform, dst + idx * dstBpp, src + idx * 4);
+  }
+}
+
+template <PIXEL_FORMAT format>
+static void TransformPixelsTo(const PIXEL_TRANSFORM16& xform, uint8_t* dst,
+                              const uint8_t* src, uint32_t count) {
+  if (!xform.clip_) {
+    TransformPixelsFolded<format>(xform, dst, src, count);
+    return;
+  }
+  alignas(16) int16_t r[TRANSFORM_CHUNK_PIXELS];
+  alignas(16) int16_t g[TRANSFORM_CHUNK_PIXELS];
+  alignas(16) int16_t b[TRANSFORM_CHUNK_PIXELS];
+  const int32_t shift = 15 - ENCODE_LUT_BITS;
+  const uint32_t dstBpp = format == PIXEL_RGBA16F ? 8 : 4;
+  while (count) {
+    uint32_t n =
+        count < TRANSFORM_CHUNK_PIXELS ? count : TRANSFORM_CHUNK_PIXELS;
+    for (uint32_t idx = 0; idx < n; idx++) {
+      uint32_t px;
+      memcpy(&px, src + idx * 4, 4);
+      r[idx] = xform.decode_[px & 0xFF];
+      g[idx] = xform.decode_[(px >> 8) & 0xFF];
+      b[idx] = xform.decode_[(px >> 16) & 0xFF];
+    }
+    TransformMatrixPlanar16(xform.matrix_, r, g, b, n, 0);
+    TransformMatrixPlanar16(xform.clipMatrix_, r, g, b, n, shift);
+    for (uint32_t idx = 0; idx < n; idx++) {
+      uint32_t px;
+      memcpy(&px, src + idx * 4, 4);
+      EncodePixel16<format>(xform, dst + idx * dstBpp, px, r[idx], g[idx],
+                            b[idx]);
+    }
+    src += n * 4, dst += n * dstBpp, count -= n;
+  }
+}
+#endif
+
+static void TransformPixels16(const PIXEL_TRANSFORM16& xform, uint8_t* dst,
+                              const uint8_t* src, uint32_t count) {
+  if (xform.format_ == PIXEL_RGBA16F) {
+    TransformPixelsTo<PIXEL_RGBA16F>(xform, dst, src, count);
+  } else {
+    TransformPixelsTo<PIXEL_RGBA8>(xform, dst, src, count);
+  }
+}
+
+/*
+ * STANDARD_TRANSFORM
+ *     The common P3 / sRGB conversions, whose tables are precompiled into
+ *     StandardTransforms.inl by host/transform_table_gen (in this order).
+ *     clip_ is TYPE_COUNT when not clipping.
+ */
+struct STANDARD_TRANSFORM {
+  NPM_TYPE src_;
+  float srcGamma_;
+  NPM_TYPE dst_;
+  float dstGamma_;
+  NPM_TYPE clip_;
+  PIXEL_FORMAT format_;
+};
+
+static const STANDARD_TRANSFORM standardTransforms[] = {
+    {P3_D65, DEFAULT_P3_IMAGE_GAMMA, SRGB_D65_INV, DEFAULT_DISPLAY_GAMMA,
+     TYPE_COUNT, PIXEL_RGBA8},
+    {P3_D65, DEFAULT_P3_IMAGE_GAMMA, SRGB_D65_INV, 0.0f, TYPE_COUNT,
+     PIXEL_RGBA8},
+    {SRGB_D65, 0.0f, P3_D65_INV, DEFAULT_DISPLAY_GAMMA, TYPE_COUNT,
+     PIXEL_RGBA8},
+};
+
+static const STANDARD_TRANSFORM standardTransforms16[] = {
+    {P3_D65, DEFAULT_P3_IMAGE_GAMMA, SRGB_D65_INV, DEFAULT_DISPLAY_GAMMA,
+     TYPE_COUNT, PIXEL_RGBA8},
+    {P3_D65, DEFAULT_P3_IMAGE_GAMMA, P3_D65_INV, DEFAULT_DISPLAY_GAMMA,
+     SRGB_D65, PIXEL_RGBA8},
+};
+
+#define STANDARD_TRANSFORM_COUNT \
+  (sizeof(standardTransforms) / sizeof(standardTransforms[0]))
+#define STANDARD_TRANSFORM16_COUNT \
+  (sizeof(standardTransforms16) / sizeof(standardTransforms16[0]))
+
+#ifndef TRANSFORM_TABLE_GENERATOR
+#include "StandardTransforms.inl"
+static_assert(sizeof(standardTables) / sizeof(standardTables[0]) ==
+                  STANDARD_TRANSFORM_COUNT,
+              "StandardTransforms.inl is out of date");
+static_assert(sizeof(standardTables16) / sizeof(standardTables16[0]) ==
+                  STANDARD_TRANSFORM16_COUNT,
+              "StandardTransforms.inl is out of date");
+#endif
+
+/*
+ * TRANSFORM_KEY
+ *     What the tables of a conversion depend on: the NPMs by value (callers
+ *     may pass their own matrices), gammas, clip gamut and output format.
+ */
+struct TRANSFORM_KEY {
+  std::array<float, 29> values_;  // src NPM, dst NPM, clip NPM, gammas
+  int32_t flags_;                 // clipping, format
+
+  bool operator<(const TRANSFORM_KEY& other) const {
+    return std::tie(values_, flags_) < std::tie(other.values_, other.flags_);
+  }
+};
+
+static TRANSFORM_KEY MakeTransformKey(const IMAGE_FORMAT& dst,
+                                      const IMAGE_FORMAT& src,
+                                      const mathfu::mat3* clipNPM,
+                                      PIXEL_FORMAT format) {
+  TRANSFORM_KEY key{};
+  for (int32_t idx = 0; idx < 9; idx++) {
+    key.values_[idx] = (*src.npm_)(idx / 3, idx % 3);
+    key.values_[9 + idx] = (*dst.npm_)(idx / 3, idx % 3);
+    key.values_[18 + idx] = clipNPM ? (*clipNPM)(idx / 3, idx % 3) : 0.0f;
+  }
+  key.values_[27] = src.gamma_;
+  key.values_[28] = dst.gamma_;
+  key.flags_ = (clipNPM ? 1 : 0) | (static_cast<int32_t>(format) << 1);
+  return key;
+}
+
+static TRANSFORM_KEY MakeTransformKey(const STANDARD_TRANSFORM& standard) {
+  IMAGE_FORMAT src{nullptr, 0, 0, standard.srcGamma_,
+                   GetTransformNPM(standard.src_)};
+  IMAGE_FORMAT dst{nullptr, 0, 0, standard.dstGamma_,
+                   GetTransformNPM(standard.dst_)};
+  return MakeTransformKey(
+      dst, src,
+      standard.clip_ == TYPE_COUNT ? nullptr : GetTransformNPM(standard.clip_),
+      standard.format_);
+}
+
+/*
+ * TransformCache
+ *     Process wide cache of built tables, so converting many images between
+ *     the same color spaces builds them once (the standard ones never).
+ *     Entries are shared_ptrs: a conversion running on another thread keeps
+ *     its tables when the cache is trimmed.
+ */
+template <typename T>
+class TransformCache {
+ public:
+  // cached tables beyond the precompiled ones, before trimming
+  static const size_t MAX_BUILT_ENTRIES = 32;
+
+  TransformCache(const T* standardTables, const STANDARD_TRANSFORM* standard,
+                 size_t count) {
+    for (size_t idx = 0; idx < count; idx++) {
+      // static data: never freed
+      entries_[MakeTransformKey(standard[idx])] =
+          std::shared_ptr<const T>(&standardTables[idx], [](const T*) {});
+    }
+    standard_ = standardTables;
+    standardCount_ = count;
+  }
+
+  template <typename Builder>
+  std::shared_ptr<const T> Get(const TRANSFORM_KEY& key, Builder build) {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) return it->second;
+
+    if (entries_.size() >= standardCount_ + MAX_BUILT_ENTRIES) {
+      for (auto entry = entries_.begin(); entry != entries_.end();) {
+        entry = IsStandard(entry->second.get()) ? std::next(entry)
+                                                : entries_.erase(entry);
+      }
+    }
+    auto xform = std::make_shared<T>();
+    build(*xform);
+    entries_[key] = xform;
+    return xform;
+  }
+
+ private:
+  bool IsStandard(const T* xform) const {
+    return xform >= standard_ && xform < standard_ + standardCount_;
+  }
+
+  std::mutex lock_;
+  std::map<TRANSFORM_KEY, std::shared_ptr<const T>> entries_;
+  const T* standard_;
+  size_t standardCount_;
+};
+
+#ifdef TRANSFORM_TABLE_GENERATOR
+// generating StandardTransforms.inl: everything is built
+static const PIXEL_TRANSFORM* standardTables = nullptr;
+static const PIXEL_TRANSFORM16* standardTables16 = nullptr;
+#define STANDARD_TABLE_COUNT(count) 0
+#else
+#define STANDARD_TABLE_COUNT(count) (count)
+#endif
+
+static std::shared_ptr<const PIXEL_TRANSFORM> GetPixelTransform(
+    IMAGE_FORMAT& dst, IMAGE_FORMAT& src) {
+  static TransformCache<PIXEL_TRANSFORM> cache(
+      standardTables, standardTransforms,
+      STANDARD_TABLE_COUNT(STANDARD_TRANSFORM_COUNT));
+  return cache.Get(MakeTransformKey(dst, src, nullptr, PIXEL_RGBA8),
+                   [&](PIXEL_TRANSFORM& xform) {
+                     BuildPixelTransform(dst, src, xform);
+                   });
+}
+
+static std::shared_ptr<const PIXEL_TRANSFORM16> GetPixelTransform16(
+    IMAGE_FORMAT& dst, IMAGE_FORMAT& src, const mathfu::mat3* clipNPM) {
+  static TransformCache<PIXEL_TRANSFORM16> cache(
+      standardTables16, standardTransforms16,
+      STANDARD_TABLE_COUNT(STANDARD_TRANSFORM16_COUNT));
+  return cache.Get(MakeTransformKey(dst, src, clipNPM, dst.format_),
+                   [&](PIXEL_TRANSFORM16& xform) {
+                     BuildPixelTransform16(dst, src, clipNPM, xform);
+                   });
+}
+
+/*
+ * Interface Function:
+ *     Convert Color Spaces
+ */
+bool TransformColorSpace(IMAGE_FORMAT& dst, IMAGE_FORMAT& src) {
+  if (!src.npm_ || !dst.npm_ || !dst.buf_ || !src.buf_) {
+    LOGE("=====Error: Invalid Parameters to TransformColorSpace()");
+    return false;
+  }
+  if (src.format_ != PIXEL_RGBA8 || dst.format_ != PIXEL_RGBA8) {
+    LOGE("=====Error: TransformColorSpace() only converts RGBA8 images");
+    return false;
+  }
+
+  std::shared_ptr<const PIXEL_TRANSFORM> xform = GetPixelTransform(dst, src);
+  TransformPixels(*xform, static_cast<uint8_t*>(dst.buf_),
+                  static_cast<const uint8_t*>(src.buf_),
+                  src.width_ * src.height_);
+  return true;
+}
+
+/*
+ * OverlapsSource
+ *     Would writing count pixels in format to dst overwrite source pixels
+ *     before TransformPixels16() reads them? Only an RGBA8 conversion exactly
+ *     in place is safe; RGBA16F pixels are twice the size of the source ones.
+ */
+static bool OverlapsSource(const void* dst, const void* src, uint32_t count,
+                           PIXEL_FORMAT format) {
+  uintptr_t dstBegin = reinterpret_cast<uintptr_t>(dst);
+  uintptr_t srcBegin = reinterpret_cast<uintptr_t>(src);
+  if (format == PIXEL_RGBA8 && dstBegin == srcBegin) return false;
+  uintptr_t dstEnd = dstBegin + count * (format == PIXEL_RGBA16F ? 8u : 4u);
+  uintptr_t srcEnd = srcBegin + count * 4u;
+  return dstBegin < srcEnd && srcBegin < dstEnd;
+}
+
+bool TransformColorSpaceHighPrecision(IMAGE_FORMAT& dst, IMAGE_FORMAT& src,
+                                      const mathfu::mat3* clipNPM) {
+  if (!src.npm_ || !dst.npm_ || !dst.buf_ || !src.buf_) {
+    LOGE("=====Error: Invalid Parameters to %s", __FUNCTION__);
+    return false;
+  }
+  if (src.format_ != PIXEL_RGBA8 || dst.format_ == PIXEL_RGBA16) {
+    LOGE("=====Error: %s converts RGBA8 to RGBA8 or RGBA16F", __FUNCTION__);
+    return false;
+  }
+  if (OverlapsSource(dst.buf_, src.buf_, src.width_ * src.height_,
+                     dst.format_)) {
+    LOGE("=====Error: %s: dst overlaps src", __FUNCTION__);
+    return false;
+  }
+
+  std::shared_ptr<const PIXEL_TRANSFORM16> xform =
+      GetPixelTransform16(dst, src, clipNPM);
+  TransformPixels16(*xform, static_cast<uint8_t*>(dst.buf_),
+                    static_cast<const uint8_t*>(src.buf_),
+                    src.width_ * src.height_);
+  return true;
+}
+
+bool HighPrecisionTransform::Prepare(IMAGE_FORMAT& dst, IMAGE_FORMAT& src,
+                                     const mathfu::mat3* clipNPM) {
+  xform_.reset();
+  if (!src.npm_ || !dst.npm_) {
+    LOGE("=====Error: Invalid Parameters to %s", __FUNCTION__);
+    return false;
+  }
+  if (src.format_ != PIXEL_RGBA8 || dst.format_ == PIXEL_RGBA16) {
+    LOGE("=====Error: %s converts RGBA8 to RGBA8 or RGBA16F", __FUNCTION__);
+    return false;
+  }
+  xform_ = GetPixelTransform16(dst, src, clipNPM);
+  return true;
+}
+
+bool HighPrecisionTransform::Apply(void* dst, const void* src,
+                                   uint32_t count) const {
+  if (!xform_ || !dst || !src) return false;
+  if (OverlapsSource(dst, src, count, xform_->format_)) {
+    LOGE("=====Error: %s: dst overlaps src", __FUNCTION__);
+    return false;
+  }
+  TransformPixels16(*xform_, static_cast<uint8_t*>(dst),
+                    static_cast<const uint8_t*>(src), count);
+  return true;
+}
+
 /*
  * Default NPMs with white reference points as D65
  * The array sequence should match enum NPM_TYPE definition
@@ -21,12 +21,20 @@
 #include <mathfu/glsl_mappings.h>
 
 #include <cstdint>
+#include <memory>
+
+/*
+ * Pixel formats: 4 channels packed, 8 bit unsigned normalized, 16 bit half
+ * float (for GL_RGBA16F textures) or 16 bit unsigned normalized
+ */
+enum PIXEL_FORMAT { PIXEL_RGBA8 = 0, PIXEL_RGBA16F, PIXEL_RGBA16 };
 
 struct IMAGE_FORMAT {
   void* buf_;  // packed image pointer
   uint32_t width_, height_;
   float gamma_;
   const mathfu::mat3* npm_;
+  PIXEL_FORMAT format_;  // PIXEL_RGBA8 unless set
 };
 
 #define DEFAULT_DISPLAY_GAMMA (1.0f / 2.2f)
@@ -37,6 +45,9 @@ struct IMAGE_FORMAT {
  *     Transforms image between DCI-P3 and sRGB space
  *     Dst.buf_ = dst.npm * src.npm * de-gamma(src.buf_)
  *     dst.buf_ = en-gamma(dst.buf_)
+ *     All three steps are done pixel by pixel, in one pass over the image;
+ *     dst.buf_ may be the same as src.buf_. The tables for each pair of
+ *     color spaces are built once per process and cached (thread safe).
  * dst.buf_:
  *     transformed image buf pointer; user must allocate enough space for the
  * image src.buf_: source of the image bits to transform. Both src and dst must
@@ -44,6 +55,52 @@ struct IMAGE_FORMAT {
  */
 bool TransformColorSpace(IMAGE_FORMAT& dst, IMAGE_FORMAT& src);
 
+/*
+ * TransformColorSpaceMultiPass(IMAGE_FORMAT& dst, IMAGE_FORMAT& src)
+ *     Same result as TransformColorSpace(), computed the original way: a
+ *     gamma decode pass, a matrix pass and a gamma encode pass, each over the
+ *     whole image. Kept as the reference the host benchmark checks against.
+ */
+bool TransformColorSpaceMultiPass(IMAGE_FORMAT& dst, IMAGE_FORMAT& src);
+
+/*
+ * TransformColorSpaceHighPrecision(IMAGE_FORMAT& dst, IMAGE_FORMAT& src,
+ *                                  const mathfu::mat3* clipNPM)
+ *     Same transform as TransformColorSpace(), with 15 bit linear
+ *     intermediates instead of 8 bit ones, so dark gradients don't band:
+ *     src is decoded to 15 bits, transformed by a Q13 matrix and encoded
+ *     through a 4096 entry table.
+ * clipNPM:
+ *     if not null, colors are clipped to the color space with this NPM (RGB
+ *     to XYZ) on the way from src to dst, still in a single pass: the sRGB
+ *     view of a P3 image is one call instead of two 8 bit conversions.
+ * src.buf_ must be R8G8B8A8; dst.buf_ is R8G8B8A8 or, if dst.format_ is
+ * PIXEL_RGBA16F, half float RGBA (encoded with dst.gamma_ as well). Only an
+ * RGBA8 dst may share src's buffer, and only exactly in place.
+ */
+bool TransformColorSpaceHighPrecision(IMAGE_FORMAT& dst, IMAGE_FORMAT& src,
+                                      const mathfu::mat3* clipNPM = nullptr);
+
+/*
+ * HighPrecisionTransform
+ *     TransformColorSpaceHighPrecision() for an image converted in pieces,
+ *     e.g. a row at a time as it is decoded: Prepare() looks up the cached
+ *     tables once (the buf_ of dst and src are not used), then each Apply()
+ *     converts count pixels from src to dst, in the formats given to
+ *     Prepare(). Apply() returns false if Prepare() did not succeed, or if
+ *     dst overlaps src other than exactly in place for RGBA8 output.
+ */
+struct PIXEL_TRANSFORM16;
+class HighPrecisionTransform {
+ public:
+  bool Prepare(IMAGE_FORMAT& dst, IMAGE_FORMAT& src,
+               const mathfu::mat3* clipNPM = nullptr);
+  bool Apply(void* dst, const void* src, uint32_t count) const;
+
+ private:
+  std::shared_ptr<const PIXEL_TRANSFORM16> xform_;
+};
+
 /*
  * GetTransformNPM
  */
@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "IccProfile.h"
+
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#include "android_debug.h"
+
+/*
+ * ICC.1 (v4.4) and ICC.1:2001-04 (v2) profile layout
+ */
+#define ICC_HEADER_SIZE 128
+#define ICC_TAG_ENTRY_SIZE 12
+#define ICC_MAX_TAGS 100
+#define ICC_SIGNATURE(c1, c2, c3, c4) \
+  ((uint32_t(c1) << 24) | (uint32_t(c2) << 16) | (uint32_t(c3) << 8) | (c4))
+
+// header fields
+#define ICC_VERSION_OFFSET 8
+#define ICC_COLOR_SPACE_OFFSET 16
+#define ICC_PCS_OFFSET 20
+#define ICC_MAGIC_OFFSET 36
+
+// curve samples GammaError() is measured on
+#define GAMMA_FIT_SAMPLES 256
+
+static uint32_t ReadUint32(const uint8_t* p) {
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+         (uint32_t(p[2]) << 8) | p[3];
+}
+
+static uint16_t ReadUint16(const uint8_t* p) {
+  return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+static float ReadS15Fixed16(const uint8_t* p) {
+  return static_cast<int32_t>(ReadUint32(p)) / 65536.0f;
+}
+
+/*
+ * ICC_CURVE::Decode()
+ */
+float ICC_CURVE::Decode(float val) const {
+  val = std::min(std::max(val, 0.0f), 1.0f);
+  switch (type_) {
+    case ICC_CURVE_IDENTITY:
+      return val;
+    case ICC_CURVE_TABLE: {
+      float pos = val * (table_.size() - 1);
+      size_t idx = std::min(static_cast<size_t>(pos), table_.size() - 2);
+      float frac = pos - idx;
+      return table_[idx] + (table_[idx + 1] - table_[idx]) * frac;
+    }
+    default:
+      break;
+  }
+
+  const float g = params_[0], a = params_[1], b = params_[2], c = params_[3],
+              d = params_[4], e = params_[5], f = params_[6];
+  float base;
+  switch (function_) {
+    case 0:
+      return std::pow(val, g);
+    case 1:
+      base = a * val + b;
+      return val >= -b / a && base > 0.0f ? std::pow(base, g) : 0.0f;
+    case 2:
+      base = a * val + b;
+      return (val >= -b / a && base > 0.0f ? std::pow(base, g) : 0.0f) + c;
+    case 3:
+      base = a * val + b;
+      if (val < d) return c * val;
+      return base > 0.0f ? std::pow(base, g) : 0.0f;
+    default:
+      base = a * val + b;
+      if (val < d) return c * val + f;
+      return (base > 0.0f ? std::pow(base, g) : 0.0f) + e;
+  }
+}
+
+/*
+ * ParseCurve()
+ *     curv or para tag data
+ */
+static bool ParseCurve(const uint8_t* data, size_t size, ICC_CURVE& curve) {
+  if (size < 12) return false;
+  curve = ICC_CURVE{ICC_CURVE_PARAMETRIC, 0, {1.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+                                              0.0f, 0.0f}, {}};
+  uint32_t type = ReadUint32(data);
+  if (type == ICC_SIGNATURE('c', 'u', 'r', 'v')) {
+    uint32_t count = ReadUint32(data + 8);
+    if (size < 12 + count * 2ull) return false;
+    if (count == 0) {
+      curve.type_ = ICC_CURVE_IDENTITY;
+    } else if (count == 1) {
+      curve.params_[0] = ReadUint16(data + 12) / 256.0f;  // u8Fixed8
+    } else {
+      curve.type_ = ICC_CURVE_TABLE;
+      curve.table_.resize(count);
+      for (uint32_t idx = 0; idx < count; idx++) {
+        curve.table_[idx] = ReadUint16(data + 12 + idx * 2) / 65535.0f;
+      }
+    }
+    return true;
+  }
+
+  if (type == ICC_SIGNATURE('p', 'a', 'r', 'a')) {
+    static const uint32_t paramCounts[] = {1, 3, 4, 5, 7};
+    curve.function_ = ReadUint16(data + 8);
+    if (curve.function_ > 4) return false;
+    uint32_t count = paramCounts[curve.function_];
+    if (size < 12 + count * 4) return false;
+    for (uint32_t idx = 0; idx < count; idx++) {
+      curve.params_[idx] = ReadS15Fixed16(data + 12 + idx * 4);
+    }
+    return curve.function_ == 0 || curve.params_[1] != 0.0f;
+  }
+  return false;
+}
+
+static bool ParseXYZ(const uint8_t* data, size_t size, float* xyz) {
+  if (size < 20 || ReadUint32(data) != ICC_SIGNATURE('X', 'Y', 'Z', ' ')) {
+    return false;
+  }
+  for (int idx = 0; idx < 3; idx++) {
+    xyz[idx] = ReadS15Fixed16(data + 8 + idx * 4);
+  }
+  return true;
+}
+
+/*
+ * BradfordToD50()
+ *     Chromatic adaptation of XYZ from white (X, Y, Z with Y = 1) to the
+ *     PCS white, D50
+ */
+static mathfu::mat3 BradfordToD50(const float* white) {
+  static const float bradford[9] = {0.8951f,  0.2664f,  -0.1614f,
+                                    -0.7502f, 1.7135f,  0.0367f,
+                                    0.0389f,  -0.0685f, 1.0296f};
+  static const float d50[3] = {0.9642f, 1.0f, 0.8249f};
+  mathfu::mat3 cone;
+  for (int r = 0; r < 3; r++) {
+    for (int c = 0; c < 3; c++) cone(r, c) = bradford[r * 3 + c];
+  }
+  mathfu::mat3 scale = mathfu::mat3::Identity();
+  for (int r = 0; r < 3; r++) {
+    float src = 0.0f, dst = 0.0f;
+    for (int c = 0; c < 3; c++) {
+      src += cone(r, c) * white[c];
+      dst += cone(r, c) * d50[c];
+    }
+    scale(r, r) = dst / src;
+  }
+  return cone.Inverse() * scale * cone;
+}
+
+/*
+ * ParseTags()
+ *     Finds rXYZ, gXYZ, bXYZ, the TRCs, chad and wtpt in the tag table
+ */
+bool IccProfile::ParseTags(const uint8_t* data, size_t size) {
+  uint32_t count = ReadUint32(data + ICC_HEADER_SIZE);
+  if (count > ICC_MAX_TAGS ||
+      ICC_HEADER_SIZE + 4 + count * ICC_TAG_ENTRY_SIZE > size) {
+    return false;
+  }
+
+  static const uint32_t colorantTags[] = {ICC_SIGNATURE('r', 'X', 'Y', 'Z'),
+                                          ICC_SIGNATURE('g', 'X', 'Y', 'Z'),
+                                          ICC_SIGNATURE('b', 'X', 'Y', 'Z')};
+  static const uint32_t curveTags[] = {ICC_SIGNATURE('r', 'T', 'R', 'C'),
+                                       ICC_SIGNATURE('g', 'T', 'R', 'C'),
+                                       ICC_SIGNATURE('b', 'T', 'R', 'C')};
+  float colorants[3][3], white[3] = {0.9642f, 1.0f, 0.8249f};
+  uint32_t found = 0;  // bits: colorants 0 -- 2, curves 3 -- 5
+  bool hasChad = false;
+  mathfu::mat3 chad;
+  for (uint32_t tag = 0; tag < count; tag++) {
+    const uint8_t* entry =
+        data + ICC_HEADER_SIZE + 4 + tag * ICC_TAG_ENTRY_SIZE;
+    uint32_t signature = ReadUint32(entry);
+    uint32_t offset = ReadUint32(entry + 4), tagSize = ReadUint32(entry + 8);
+    if (offset > size || tagSize > size - offset) return false;
+    const uint8_t* tagData = data + offset;
+
+    for (int ch = 0; ch < 3; ch++) {
+      if (signature == colorantTags[ch]) {
+        if (!ParseXYZ(tagData, tagSize, colorants[ch])) return false;
+        found |= 1 << ch;
+      } else if (signature == curveTags[ch]) {
+        if (!ParseCurve(tagData, tagSize, curves_[ch])) return false;
+        found |= 8 << ch;
+      }
+    }
+    if (signature == ICC_SIGNATURE('w', 't', 'p', 't')) {
+      if (!ParseXYZ(tagData, tagSize, white) || white[1] <= 0.0f) {
+        return false;
+      }
+    } else if (signature == ICC_SIGNATURE('c', 'h', 'a', 'd')) {
+      if (tagSize < 44 ||
+          ReadUint32(tagData) != ICC_SIGNATURE('s', 'f', '3', '2')) {
+        return false;
+      }
+      for (int idx = 0; idx < 9; idx++) {
+        chad(idx / 3, idx % 3) = ReadS15Fixed16(tagData + 8 + idx * 4);
+      }
+      hasChad = true;
+    }
+  }
+  if (found != 0x3f) return false;
+
+  // the colorants are adapted to D50; v4 profiles say how in chad, v2 ones
+  // (mostly) used Bradford from their white point
+  if (!hasChad) {
+    for (int idx = 0; idx < 3; idx++) white[idx] /= white[1];
+    chad = BradfordToD50(white);
+  }
+  mathfu::mat3 pcs;
+  for (int r = 0; r < 3; r++) {
+    for (int c = 0; c < 3; c++) pcs(r, c) = colorants[c][r];
+  }
+  npm_ = chad.Inverse() * pcs;
+  return true;
+}
+
+/*
+ * FitGamma()
+ *     Golden section search for the exponent of TransformColorSpace()'s
+ *     curve closest (least squares, all channels) to the TRCs
+ */
+static float RepoDecode(float val, float exponent) {
+  if (val < 0.04045f) return val / 12.92f;
+  return std::pow((val + 0.055f) / 1.055f, exponent);
+}
+
+void IccProfile::FitGamma(void) {
+  float samples[3][GAMMA_FIT_SAMPLES];
+  bool linear = true;
+  for (int ch = 0; ch < 3; ch++) {
+    for (int idx = 0; idx < GAMMA_FIT_SAMPLES; idx++) {
+      float val = idx / (GAMMA_FIT_SAMPLES - 1.0f);
+      samples[ch][idx] = curves_[ch].Decode(val);
+      linear = linear && std::fabs(samples[ch][idx] - val) < 0.5f / 255;
+    }
+  }
+
+  auto error = [&](float exponent, bool maxError) {
+    float sum = 0.0f;
+    for (int ch = 0; ch < 3; ch++) {
+      for (int idx = 0; idx < GAMMA_FIT_SAMPLES; idx++) {
+        float val = idx / (GAMMA_FIT_SAMPLES - 1.0f);
+        float err = linear ? val : RepoDecode(val, exponent);
+        err = std::fabs(err - samples[ch][idx]);
+        sum = maxError ? std::max(sum, err) : sum + err * err;
+      }
+    }
+    return sum;
+  };
+
+  if (linear) {
+    gamma_ = 0.0f;
+    gammaError_ = error(1.0f, true);
+    return;
+  }
+  const float ratio = 0.618034f;
+  float lo = 1.0f, hi = 3.5f;
+  float x1 = hi - ratio * (hi - lo), x2 = lo + ratio * (hi - lo);
+  float e1 = error(x1, false), e2 = error(x2, false);
+  for (int iteration = 0; iteration < 40; iteration++) {
+    if (e1 < e2) {
+      hi = x2, x2 = x1, e2 = e1;
+      x1 = hi - ratio * (hi - lo), e1 = error(x1, false);
+    } else {
+      lo = x1, x1 = x2, e1 = e2;
+      x2 = lo + ratio * (hi - lo), e2 = error(x2, false);
+    }
+  }
+  float exponent = (lo + hi) / 2;
+  gamma_ = 1.0f / exponent;
+  gammaError_ = error(exponent, true);
+}
+
+std::shared_ptr<const IccProfile> IccProfile::Parse(const uint8_t* data,
+                                                    size_t size) {
+  if (!data || size < ICC_HEADER_SIZE + 4 || ReadUint32(data) > size ||
+      ReadUint32(data + ICC_MAGIC_OFFSET) !=
+          ICC_SIGNATURE('a', 'c', 's', 'p')) {
+    LOGE("==== Invalid ICC profile");
+    return nullptr;
+  }
+  if (ReadUint32(data + ICC_COLOR_SPACE_OFFSET) !=
+          ICC_SIGNATURE('R', 'G', 'B', ' ') ||
+      ReadUint32(data + ICC_PCS_OFFSET) != ICC_SIGNATURE('X', 'Y', 'Z', ' ')) {
+    LOGI("==== ICC profile is not RGB to XYZ, not supported");
+    return nullptr;
+  }
+
+  std::shared_ptr<IccProfile> profile(new IccProfile());
+  profile->version_ = data[ICC_VERSION_OFFSET];
+  if (profile->version_ < 2 || profile->version_ > 4 ||
+      !profile->ParseTags(data, ReadUint32(data))) {
+    LOGI("==== ICC profile is not a matrix / TRC profile, not supported");
+    return nullptr;
+  }
+  profile->FitGamma();
+  return profile;
+}
+
+/*
+ * Get()
+ *     Profiles are looked up by an FNV-1a hash of their bytes, which are
+ *     kept to rule out collisions; only a few different profiles are
+ *     expected, the cache is emptied when it fills up.
+ */
+#define MAX_CACHED_PROFILES 16
+
+struct CACHED_PROFILE {
+  std::vector<uint8_t> bytes_;
+  std::shared_ptr<const IccProfile> profile_;  // nullptr: not supported
+};
+
+std::shared_ptr<const IccProfile> IccProfile::Get(const uint8_t* data,
+                                                  size_t size) {
+  static std::mutex lock;
+  static std::map<uint64_t, CACHED_PROFILE> cache;
+
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t idx = 0; idx < size; idx++) {
+    hash = (hash ^ data[idx]) * 0x100000001b3ull;
+  }
+
+  std::lock_guard<std::mutex> guard(lock);
+  auto it = cache.find(hash);
+  if (it != cache.end() && it->second.bytes_.size() == size &&
+      !memcmp(it->second.bytes_.data(), data, size)) {
+    return it->second.profile_;
+  }
+
+  if (cache.size() >= MAX_CACHED_PROFILES) cache.clear();
+  CACHED_PROFILE& entry = cache[hash];
+  entry.bytes_.assign(data, data + size);
+  entry.profile_ = Parse(data, size);
+  return entry.profile_;
+}
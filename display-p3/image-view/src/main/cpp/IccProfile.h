@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef __ICC_PROFILE_H__
+#define __ICC_PROFILE_H__
+
+#include <mathfu/glsl_mappings.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*
+ * Tone reproduction curve of an ICC profile: encoded to linear, 0.0 -- 1.0
+ *   ICC_CURVE_IDENTITY:   curv with no entries
+ *   ICC_CURVE_TABLE:      curv with a table, interpolated linearly
+ *   ICC_CURVE_PARAMETRIC: curv with a single gamma (function type 0), or
+ *                         para of function type 0 -- 4; params_ are
+ *                         g, a, b, c, d, e, f (ICC.1 table 65)
+ */
+enum ICC_CURVE_TYPE {
+  ICC_CURVE_IDENTITY = 0,
+  ICC_CURVE_TABLE,
+  ICC_CURVE_PARAMETRIC,
+};
+
+struct ICC_CURVE {
+  ICC_CURVE_TYPE type_;
+  uint32_t function_;  // parametric function type
+  float params_[7];
+  std::vector<float> table_;
+
+  float Decode(float val) const;
+};
+
+/*
+ * IccProfile
+ *     The parts of an RGB matrix / TRC ICC profile (version 2 or 4) the
+ *     color space transforms use:
+ *       NPM():   RGB to XYZ, as the NPMs of GetTransformNPM(): the
+ *                colorants (rXYZ, gXYZ, bXYZ) adapted back from the D50
+ *                PCS to the profile's white with chad (or, without one,
+ *                the Bradford transform from wtpt)
+ *       Gamma(): the IMAGE_FORMAT::gamma_ whose curve (see
+ *                TransformColorSpace()) is closest to the profile's TRCs;
+ *                0.0f for linear. GammaError() is the largest difference,
+ *                in linear values; Curve() has the exact TRCs.
+ *     Profiles of other kinds (LUT based, gray, CMYK) are not supported.
+ */
+class IccProfile {
+ public:
+  /*
+   * Get()
+   *     Parses the profile, or returns the one parsed earlier from the same
+   *     bytes (profiles are cached by content hash; thread safe). nullptr if
+   *     the profile is invalid or not supported.
+   */
+  static std::shared_ptr<const IccProfile> Get(const uint8_t* data,
+                                               size_t size);
+
+  // parses without the cache
+  static std::shared_ptr<const IccProfile> Parse(const uint8_t* data,
+                                                 size_t size);
+
+  uint32_t Version(void) const { return version_; }  // major version
+  const mathfu::mat3* NPM(void) const { return &npm_; }
+  float Gamma(void) const { return gamma_; }
+  float GammaError(void) const { return gammaError_; }
+  const ICC_CURVE& Curve(uint32_t channel) const { return curves_[channel]; }
+
+ private:
+  IccProfile() = default;
+  bool ParseTags(const uint8_t* data, size_t size);
+  void FitGamma(void);
+
+  uint32_t version_;
+  mathfu::mat3 npm_;
+  ICC_CURVE curves_[3];
+  float gamma_;
+  float gammaError_;
+};
+
+#endif  // __ICC_PROFILE_H__
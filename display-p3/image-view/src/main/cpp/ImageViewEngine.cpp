@@ -76,7 +76,13 @@ void ImageViewEngine::DrawFrame(void) {
   glVertexAttribPointer(program_.getAttribLocationTex(), 2, GL_FLOAT, GL_FALSE,
                         sizeof(GLfloat) * 4, leftQuadVertices + 2);
   glEnableVertexAttribArray(program_.getAttribLocationTex());
+  UploadTextures();
   int32_t texIdx = textureIdx_;
+  if (!textures_[texIdx]->IsValid()) {
+    // still being prepared
+    eglSwapBuffers(display_, surface_);
+    return;
+  }
   if (renderModeBits_ & RENDERING_P3) {
     glActiveTexture(GL_TEXTURE0 + 0);
     glBindTexture(GL_TEXTURE_2D, textures_[texIdx]->P3TexId());
@@ -105,6 +111,8 @@ void ImageViewEngine::TerminateDisplay(void) {
 
   if (display_ == EGL_NO_DISPLAY) return;
 
+  // the images were for this display's color space
+  if (texturePipeline_) texturePipeline_->Cancel();
   DestroyWideColorCtx();
 
   glDeleteProgram(program_.getProgram());
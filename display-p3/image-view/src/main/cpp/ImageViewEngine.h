@@ -33,6 +33,7 @@
 
 #include "AssetTexture.h"
 #include "ShaderProgram.h"
+#include "TexturePipeline.h"
 #include "android_debug.h"
 #include "common.h"
 #include "gldebug.h"
@@ -72,6 +73,7 @@ class ImageViewEngine {
 
   // Image file texture store
   std::vector<AssetTexture*> textures_;
+  std::unique_ptr<TexturePipeline> texturePipeline_;
   std::atomic<uint32_t> textureIdx_;
 
   enum WIDECOLOR_MODE {
@@ -90,6 +92,7 @@ class ImageViewEngine {
 
   bool CreateTextures(void);
   void DeleteTextures(void);
+  void UploadTextures(void);
 
   uint32_t renderModeBits_;
 
@@ -0,0 +1,1297 @@
+// Generated by host/transform_table_gen from ColorSpaceTransform.cpp:
+// the tables of standardTransforms and standardTransforms16, in order.
+// Do not edit; regenerate with the transform_tables target of the host build.
+
+static const PIXEL_TRANSFORM standardTables[] = {
+    // P3_D65 (gamma 0.4545) -> SRGB_D65_INV (gamma 0.4545), clip: none
+    {{
+          0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   2,   2,   2,
+          2,   2,   2,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,
+          5,   5,   6,   6,   6,   7,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,
+         10,  10,  11,  11,  12,  12,  12,  13,  13,  14,  14,  14,  15,  15,  16,  16,
+         17,  17,  18,  18,  19,  19,  20,  20,  21,  21,  22,  22,  23,  24,  24,  25,
+         25,  26,  26,  27,  28,  28,  29,  30,  30,  31,  32,  32,  33,  34,  34,  35,
+         36,  36,  37,  38,  39,  39,  40,  41,  42,  42,  43,  44,  45,  46,  46,  47,
+         48,  49,  50,  51,  52,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,
+         63,  64,  65,  65,  66,  67,  69,  70,  71,  72,  73,  74,  75,  76,  77,  78,
+         79,  80,  81,  82,  84,  85,  86,  87,  88,  89,  91,  92,  93,  94,  95,  97,
+         98,  99, 100, 102, 103, 104, 105, 107, 108, 109, 111, 112, 113, 115, 116, 117,
+        119, 120, 121, 123, 124, 126, 127, 129, 130, 131, 133, 134, 136, 137, 139, 140,
+        142, 143, 145, 146, 148, 149, 151, 153, 154, 156, 157, 159, 161, 162, 164, 165,
+        167, 169, 170, 172, 174, 176, 177, 179, 181, 182, 184, 186, 188, 189, 191, 193,
+        195, 197, 198, 200, 202, 204, 206, 208, 209, 211, 213, 215, 217, 219, 221, 223,
+        225, 227, 229, 231, 233, 235, 237, 239, 241, 243, 245, 247, 249, 251, 253, 255},
+     {1254, -229, 0, -42, 1067, 0, -19, -80, 1125},
+     {
+          0,   8,  16,  22,  27,  31,  35,  38,  42,  45,  48,  50,  53,  56,  58,  60,
+         62,  65,  67,  69,  71,  72,  74,  76,  78,  80,  81,  83,  85,  86,  88,  89,
+         91,  92,  94,  95,  96,  98,  99, 101, 102, 103, 104, 106, 107, 108, 109, 111,
+        112, 113, 114, 115, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128,
+        129, 131, 132, 133, 134, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143, 144,
+        145, 146, 147, 147, 148, 149, 150, 151, 152, 153, 154, 154, 155, 156, 157, 158,
+        159, 159, 160, 161, 162, 163, 163, 164, 165, 166, 166, 167, 168, 169, 170, 170,
+        171, 172, 173, 173, 174, 175, 176, 176, 177, 178, 178, 179, 180, 181, 181, 182,
+        183, 183, 184, 185, 185, 186, 187, 187, 188, 189, 189, 190, 191, 191, 192, 193,
+        193, 194, 195, 195, 196, 197, 197, 198, 199, 199, 200, 201, 201, 202, 202, 203,
+        204, 204, 205, 205, 206, 207, 207, 208, 209, 209, 210, 210, 211, 212, 212, 213,
+        213, 214, 214, 215, 216, 216, 217, 217, 218, 218, 219, 220, 220, 221, 221, 222,
+        222, 223, 224, 224, 225, 225, 226, 226, 227, 227, 228, 229, 229, 230, 230, 231,
+        231, 232, 232, 233, 233, 234, 234, 235, 235, 236, 236, 237, 238, 238, 239, 239,
+        240, 240, 241, 241, 242, 242, 243, 243, 244, 244, 245, 245, 246, 246, 247, 247,
+        248, 248, 249, 249, 250, 250, 251, 251, 252, 252, 253, 253, 254, 254, 255, 255}},
+    // P3_D65 (gamma 0.4545) -> SRGB_D65_INV (gamma 0.0000), clip: none
+    {{
+          0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   2,   2,   2,
+          2,   2,   2,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,
+          5,   5,   6,   6,   6,   7,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,
+         10,  10,  11,  11,  12,  12,  12,  13,  13,  14,  14,  14,  15,  15,  16,  16,
+         17,  17,  18,  18,  19,  19,  20,  20,  21,  21,  22,  22,  23,  24,  24,  25,
+         25,  26,  26,  27,  28,  28,  29,  30,  30,  31,  32,  32,  33,  34,  34,  35,
+         36,  36,  37,  38,  39,  39,  40,  41,  42,  42,  43,  44,  45,  46,  46,  47,
+         48,  49,  50,  51,  52,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,
+         63,  64,  65,  65,  66,  67,  69,  70,  71,  72,  73,  74,  75,  76,  77,  78,
+         79,  80,  81,  82,  84,  85,  86,  87,  88,  89,  91,  92,  93,  94,  95,  97,
+         98,  99, 100, 102, 103, 104, 105, 107, 108, 109, 111, 112, 113, 115, 116, 117,
+        119, 120, 121, 123, 124, 126, 127, 129, 130, 131, 133, 134, 136, 137, 139, 140,
+        142, 143, 145, 146, 148, 149, 151, 153, 154, 156, 157, 159, 161, 162, 164, 165,
+        167, 169, 170, 172, 174, 176, 177, 179, 181, 182, 184, 186, 188, 189, 191, 193,
+        195, 197, 198, 200, 202, 204, 206, 208, 209, 211, 213, 215, 217, 219, 221, 223,
+        225, 227, 229, 231, 233, 235, 237, 239, 241, 243, 245, 247, 249, 251, 253, 255},
+     {1254, -229, 0, -42, 1067, 0, -19, -80, 1125},
+     {
+          0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15,
+         16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31,
+         32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,
+         48,  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,
+         64,  65,  66,  67,  68,  69,  70,  71,  72,  73,  74,  75,  76,  77,  78,  79,
+         80,  81,  82,  83,  84,  85,  86,  87,  88,  89,  90,  91,  92,  93,  94,  95,
+         96,  97,  98,  99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111,
+        112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127,
+        128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143,
+        144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159,
+        160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175,
+        176, 177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191,
+        192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207,
+        208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223,
+        224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239,
+        240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255}},
+    // SRGB_D65 (gamma 0.0000) -> P3_D65_INV (gamma 0.4545), clip: none
+    {{
+          0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15,
+         16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31,
+         32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,
+         48,  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,
+         64,  65,  66,  67,  68,  69,  70,  71,  72,  73,  74,  75,  76,  77,  78,  79,
+         80,  81,  82,  83,  84,  85,  86,  87,  88,  89,  90,  91,  92,  93,  94,  95,
+         96,  97,  98,  99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111,
+        112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127,
+        128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143,
+        144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159,
+        160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175,
+        176, 177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191,
+        192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207,
+        208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223,
+        224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239,
+        240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255},
+     {842, 182, 0, 34, 990, 0, 17, 74, 932},
+     {
+          0,   8,  16,  22,  27,  31,  35,  38,  42,  45,  48,  50,  53,  56,  58,  60,
+         62,  65,  67,  69,  71,  72,  74,  76,  78,  80,  81,  83,  85,  86,  88,  89,
+         91,  92,  94,  95,  96,  98,  99, 101, 102, 103, 104, 106, 107, 108, 109, 111,
+        112, 113, 114, 115, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128,
+        129, 131, 132, 133, 134, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143, 144,
+        145, 146, 147, 147, 148, 149, 150, 151, 152, 153, 154, 154, 155, 156, 157, 158,
+        159, 159, 160, 161, 162, 163, 163, 164, 165, 166, 166, 167, 168, 169, 170, 170,
+        171, 172, 173, 173, 174, 175, 176, 176, 177, 178, 178, 179, 180, 181, 181, 182,
+        183, 183, 184, 185, 185, 186, 187, 187, 188, 189, 189, 190, 191, 191, 192, 193,
+        193, 194, 195, 195, 196, 197, 197, 198, 199, 199, 200, 201, 201, 202, 202, 203,
+        204, 204, 205, 205, 206, 207, 207, 208, 209, 209, 210, 210, 211, 212, 212, 213,
+        213, 214, 214, 215, 216, 216, 217, 217, 218, 218, 219, 220, 220, 221, 221, 222,
+        222, 223, 224, 224, 225, 225, 226, 226, 227, 227, 228, 229, 229, 230, 230, 231,
+        231, 232, 232, 233, 233, 234, 234, 235, 235, 236, 236, 237, 238, 238, 239, 239,
+        240, 240, 241, 241, 242, 242, 243, 243, 244, 244, 245, 245, 246, 246, 247, 247,
+        248, 248, 249, 249, 250, 250, 251, 251, 252, 252, 253, 253, 254, 254, 255, 255}},
+};
+
+static const PIXEL_TRANSFORM16 standardTables16[] = {
+    // P3_D65 (gamma 0.4545) -> SRGB_D65_INV (gamma 0.4545), clip: none
+    {{
+            0,    10,    20,    30,    40,    50,    60,    70,    80,    90,    99,   176,
+          192,   209,   226,   244,   263,   283,   303,   325,   347,   369,   393,   417,
+          443,   469,   495,   523,   552,   581,   611,   642,   674,   706,   740,   774,
+          809,   845,   882,   920,   959,   998,  1038,  1080,  1122,  1165,  1208,  1253,
+         1299,  1345,  1393,  1441,  1490,  1540,  1591,  1643,  1696,  1750,  1804,  1860,
+         1917,  1974,  2032,  2092,  2152,  2213,  2275,  2338,  2402,  2467,  2533,  2600,
+         2667,  2736,  2806,  2876,  2948,  3020,  3094,  3168,  3244,  3320,  3397,  3476,
+         3555,  3635,  3716,  3799,  3882,  3966,  4051,  4137,  4225,  4313,  4402,  4492,
+         4583,  4675,  4769,  4863,  4958,  5054,  5151,  5249,  5349,  5449,  5550,  5652,
+         5755,  5860,  5965,  6071,  6179,  6287,  6396,  6507,  6618,  6731,  6844,  6959,
+         7075,  7191,  7309,  7428,  7547,  7668,  7790,  7913,  8037,  8162,  8288,  8415,
+         8543,  8673,  8803,  8934,  9067,  9200,  9335,  9470,  9607,  9745,  9884, 10024,
+        10165, 10307, 10450, 10594, 10739, 10886, 11033, 11182, 11331, 11482, 11634, 11787,
+        11940, 12096, 12252, 12409, 12567, 12727, 12887, 13049, 13211, 13375, 13540, 13706,
+        13873, 14042, 14211, 14381, 14553, 14726, 14899, 15074, 15250, 15427, 15606, 15785,
+        15965, 16147, 16330, 16514, 16698, 16885, 17072, 17260, 17450, 17640, 17832, 18025,
+        18219, 18414, 18610, 18807, 19006, 19206, 19406, 19608, 19811, 20016, 20221, 20427,
+        20635, 20844, 21054, 21265, 21477, 21691, 21905, 22121, 22338, 22556, 22775, 22995,
+        23217, 23439, 23663, 23888, 24114, 24341, 24570, 24799, 25030, 25262, 25495, 25729,
+        25965, 26201, 26439, 26678, 26918, 27160, 27402, 27646, 27891, 28137, 28384, 28632,
+        28882, 29132, 29384, 29637, 29892, 30147, 30404, 30662, 30921, 31181, 31442, 31705,
+        31969, 32233, 32500, 32767},
+     {10035, -1843, 0, -345, 8537, 0, -161, -644, 8997},
+     {0, 0, 0, 0, 0, 0, 0, 0, 0},
+     false, PIXEL_RGBA8,
+     {
+          0,   1,   2,   3,   4,   4,   5,   6,   7,   8,   8,   9,
+         10,   6,   7,   7,   8,   9,   9,  10,  10,  11,  11,  12,
+         12,  13,  13,  14,  14,  15,  15,  15,  16,  16,  17,  17,
+         17,  18,  18,  19,  19,  19,  20,  20,  20,  21,  21,  21,
+         22,  22,  22,  23,  23,  23,  24,  24,  24,  25,  25,  25,
+         26,  26,  26,  26,  27,  27,  27,  28,  28,  28,  28,  29,
+         29,  29,  30,  30,  30,  30,  31,  31,  31,  31,  32,  32,
+         32,  32,  33,  33,  33,  33,  34,  34,  34,  34,  34,  35,
+         35,  35,  35,  36,  36,  36,  36,  37,  37,  37,  37,  37,
+         38,  38,  38,  38,  38,  39,  39,  39,  39,  40,  40,  40,
+         40,  40,  41,  41,  41,  41,  41,  42,  42,  42,  42,  42,
+         43,  43,  43,  43,  43,  43,  44,  44,  44,  44,  44,  45,
+         45,  45,  45,  45,  46,  46,  46,  46,  46,  46,  47,  47,
+         47,  47,  47,  48,  48,  48,  48,  48,  48,  49,  49,  49,
+         49,  49,  49,  50,  50,  50,  50,  50,  50,  51,  51,  51,
+         51,  51,  51,  52,  52,  52,  52,  52,  52,  53,  53,  53,
+         53,  53,  53,  53,  54,  54,  54,  54,  54,  54,  55,  55,
+         55,  55,  55,  55,  55,  56,  56,  56,  56,  56,  56,  57,
+         57,  57,  57,  57,  57,  57,  58,  58,  58,  58,  58,  58,
+         58,  59,  59,  59,  59,  59,  59,  59,  60,  60,  60,  60,
+         60,  60,  60,  61,  61,  61,  61,  61,  61,  61,  62,  62,
+         62,  62,  62,  62,  62,  62,  63,  63,  63,  63,  63,  63,
+         63,  64,  64,  64,  64,  64,  64,  64,  64,  65,  65,  65,
+         65,  65,  65,  65,  66,  66,  66,  66,  66,  66,  66,  66,
+         67,  67,  67,  67,  67,  67,  67,  67,  68,  68,  68,  68,
+         68,  68,  68,  68,  69,  69,  69,  69,  69,  69,  69,  69,
+         70,  70,  70,  70,  70,  70,  70,  70,  70,  71,  71,  71,
+         71,  71,  71,  71,  71,  72,  72,  72,  72,  72,  72,  72,
+         72,  72,  73,  73,  73,  73,  73,  73,  73,  73,  74,  74,
+         74,  74,  74,  74,  74,  74,  74,  75,  75,  75,  75,  75,
+         75,  75,  75,  75,  76,  76,  76,  76,  76,  76,  76,  76,
+         76,  77,  77,  77,  77,  77,  77,  77,  77,  77,  78,  78,
+         78,  78,  78,  78,  78,  78,  78,  79,  79,  79,  79,  79,
+         79,  79,  79,  79,  79,  80,  80,  80,  80,  80,  80,  80,
+         80,  80,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,
+         82,  82,  82,  82,  82,  82,  82,  82,  82,  82,  83,  83,
+         83,  83,  83,  83,  83,  83,  83,  84,  84,  84,  84,  84,
+         84,  84,  84,  84,  84,  85,  85,  85,  85,  85,  85,  85,
+         85,  85,  85,  86,  86,  86,  86,  86,  86,  86,  86,  86,
+         86,  86,  87,  87,  87,  87,  87,  87,  87,  87,  87,  87,
+         88,  88,  88,  88,  88,  88,  88,  88,  88,  88,  89,  89,
+         89,  89,  89,  89,  89,  89,  89,  89,  89,  90,  90,  90,
+         90,  90,  90,  90,  90,  90,  90,  90,  91,  91,  91,  91,
+         91,  91,  91,  91,  91,  91,  91,  92,  92,  92,  92,  92,
+         92,  92,  92,  92,  92,  92,  93,  93,  93,  93,  93,  93,
+         93,  93,  93,  93,  93,  94,  94,  94,  94,  94,  94,  94,
+         94,  94,  94,  94,  95,  95,  95,  95,  95,  95,  95,  95,
+         95,  95,  95,  96,  96,  96,  96,  96,  96,  96,  96,  96,
+         96,  96,  96,  97,  97,  97,  97,  97,  97,  97,  97,  97,
+         97,  97,  98,  98,  98,  98,  98,  98,  98,  98,  98,  98,
+         98,  98,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,
+         99,  99, 100, 100, 100, 100, 100, 100, 100, 100, 100, 100,
+        100, 100, 101, 101, 101, 101, 101, 101, 101, 101, 101, 101,
+        101, 101, 102, 102, 102, 102, 102, 102, 102, 102, 102, 102,
+        102, 102, 103, 103, 103, 103, 103, 103, 103, 103, 103, 103,
+        103, 103, 104, 104, 104, 104, 104, 104, 104, 104, 104, 104,
+        104, 104, 104, 105, 105, 105, 105, 105, 105, 105, 105, 105,
+        105, 105, 105, 106, 106, 106, 106, 106, 106, 106, 106, 106,
+        106, 106, 106, 106, 107, 107, 107, 107, 107, 107, 107, 107,
+        107, 107, 107, 107, 107, 108, 108, 108, 108, 108, 108, 108,
+        108, 108, 108, 108, 108, 108, 109, 109, 109, 109, 109, 109,
+        109, 109, 109, 109, 109, 109, 109, 110, 110, 110, 110, 110,
+        110, 110, 110, 110, 110, 110, 110, 110, 111, 111, 111, 111,
+        111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 112, 112,
+        112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 113,
+        113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113,
+        113, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114,
+        114, 114, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115,
+        115, 115, 115, 115, 116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117, 118, 118, 118, 118,
+        118, 118, 118, 118, 118, 118, 118, 118, 118, 118, 118, 119,
+        119, 119, 119, 119, 119, 119, 119, 119, 119, 119, 119, 119,
+        119, 120, 120, 120, 120, 120, 120, 120, 120, 120, 120, 120,
+        120, 120, 120, 120, 121, 121, 121, 121, 121, 121, 121, 121,
+        121, 121, 121, 121, 121, 121, 122, 122, 122, 122, 122, 122,
+        122, 122, 122, 122, 122, 122, 122, 122, 122, 123, 123, 123,
+        123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123,
+        124, 124, 124, 124, 124, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 125, 125, 125, 125, 125, 125, 125, 125, 125,
+        125, 125, 125, 125, 125, 125, 126, 126, 126, 126, 126, 126,
+        126, 126, 126, 126, 126, 126, 126, 126, 126, 127, 127, 127,
+        127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+        127, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+        128, 128, 128, 128, 129, 129, 129, 129, 129, 129, 129, 129,
+        129, 129, 129, 129, 129, 129, 129, 129, 130, 130, 130, 130,
+        130, 130, 130, 130, 130, 130, 130, 130, 130, 130, 130, 130,
+        131, 131, 131, 131, 131, 131, 131, 131, 131, 131, 131, 131,
+        131, 131, 131, 131, 132, 132, 132, 132, 132, 132, 132, 132,
+        132, 132, 132, 132, 132, 132, 132, 132, 133, 133, 133, 133,
+        133, 133, 133, 133, 133, 133, 133, 133, 133, 133, 133, 133,
+        134, 134, 134, 134, 134, 134, 134, 134, 134, 134, 134, 134,
+        134, 134, 134, 134, 134, 135, 135, 135, 135, 135, 135, 135,
+        135, 135, 135, 135, 135, 135, 135, 135, 135, 136, 136, 136,
+        136, 136, 136, 136, 136, 136, 136, 136, 136, 136, 136, 136,
+        136, 136, 137, 137, 137, 137, 137, 137, 137, 137, 137, 137,
+        137, 137, 137, 137, 137, 137, 138, 138, 138, 138, 138, 138,
+        138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 139,
+        139, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139,
+        139, 139, 139, 139, 140, 140, 140, 140, 140, 140, 140, 140,
+        140, 140, 140, 140, 140, 140, 140, 140, 140, 141, 141, 141,
+        141, 141, 141, 141, 141, 141, 141, 141, 141, 141, 141, 141,
+        141, 141, 141, 142, 142, 142, 142, 142, 142, 142, 142, 142,
+        142, 142, 142, 142, 142, 142, 142, 142, 143, 143, 143, 143,
+        143, 143, 143, 143, 143, 143, 143, 143, 143, 143, 143, 143,
+        143, 143, 144, 144, 144, 144, 144, 144, 144, 144, 144, 144,
+        144, 144, 144, 144, 144, 144, 144, 145, 145, 145, 145, 145,
+        145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145,
+        145, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146,
+        146, 146, 146, 146, 146, 146, 146, 147, 147, 147, 147, 147,
+        147, 147, 147, 147, 147, 147, 147, 147, 147, 147, 147, 147,
+        147, 148, 148, 148, 148, 148, 148, 148, 148, 148, 148, 148,
+        148, 148, 148, 148, 148, 148, 148, 148, 149, 149, 149, 149,
+        149, 149, 149, 149, 149, 149, 149, 149, 149, 149, 149, 149,
+        149, 149, 150, 150, 150, 150, 150, 150, 150, 150, 150, 150,
+        150, 150, 150, 150, 150, 150, 150, 150, 151, 151, 151, 151,
+        151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151,
+        151, 151, 151, 152, 152, 152, 152, 152, 152, 152, 152, 152,
+        152, 152, 152, 152, 152, 152, 152, 152, 152, 152, 153, 153,
+        153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153,
+        153, 153, 153, 153, 153, 154, 154, 154, 154, 154, 154, 154,
+        154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154,
+        155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155,
+        155, 155, 155, 155, 155, 155, 155, 156, 156, 156, 156, 156,
+        156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156,
+        156, 156, 157, 157, 157, 157, 157, 157, 157, 157, 157, 157,
+        157, 157, 157, 157, 157, 157, 157, 157, 157, 157, 158, 158,
+        158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158,
+        158, 158, 158, 158, 158, 159, 159, 159, 159, 159, 159, 159,
+        159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159,
+        159, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160,
+        160, 160, 160, 160, 160, 160, 160, 160, 160, 161, 161, 161,
+        161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161,
+        161, 161, 161, 161, 161, 162, 162, 162, 162, 162, 162, 162,
+        162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162,
+        162, 163, 163, 163, 163, 163, 163, 163, 163, 163, 163, 163,
+        163, 163, 163, 163, 163, 163, 163, 163, 163, 164, 164, 164,
+        164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164,
+        164, 164, 164, 164, 164, 164, 165, 165, 165, 165, 165, 165,
+        165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165,
+        165, 165, 166, 166, 166, 166, 166, 166, 166, 166, 166, 166,
+        166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 167,
+        167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167,
+        167, 167, 167, 167, 167, 167, 167, 167, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 169, 169, 169, 169, 169, 169, 169,
+        169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169,
+        169, 169, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 171,
+        171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171,
+        171, 171, 171, 171, 171, 171, 171, 171, 172, 172, 172, 172,
+        172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172,
+        172, 172, 172, 172, 172, 172, 173, 173, 173, 173, 173, 173,
+        173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173,
+        173, 173, 173, 173, 174, 174, 174, 174, 174, 174, 174, 174,
+        174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
+        174, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175,
+        175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 176,
+        176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
+        176, 176, 176, 176, 176, 176, 176, 176, 176, 177, 177, 177,
+        177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177,
+        177, 177, 177, 177, 177, 177, 177, 177, 178, 178, 178, 178,
+        178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178,
+        178, 178, 178, 178, 178, 178, 179, 179, 179, 179, 179, 179,
+        179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179,
+        179, 179, 179, 179, 180, 180, 180, 180, 180, 180, 180, 180,
+        180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180,
+        180, 180, 180, 181, 181, 181, 181, 181, 181, 181, 181, 181,
+        181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 181,
+        181, 181, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182,
+        182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182,
+        182, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183,
+        183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183,
+        184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184,
+        184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 185,
+        185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185,
+        185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 186, 186,
+        186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186,
+        186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 187, 187,
+        187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187,
+        187, 187, 187, 187, 187, 187, 187, 187, 187, 188, 188, 188,
+        188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188,
+        188, 188, 188, 188, 188, 188, 188, 188, 188, 189, 189, 189,
+        189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189,
+        189, 189, 189, 189, 189, 189, 189, 189, 189, 190, 190, 190,
+        190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190,
+        190, 190, 190, 190, 190, 190, 190, 190, 190, 191, 191, 191,
+        191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191,
+        191, 191, 191, 191, 191, 191, 191, 191, 191, 192, 192, 192,
+        192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192,
+        192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 193, 193,
+        193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193,
+        193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 194, 194,
+        194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194,
+        194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 195,
+        195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195,
+        195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 196,
+        196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196,
+        196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196,
+        197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197,
+        197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197,
+        197, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198,
+        198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198,
+        198, 198, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199,
+        199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199,
+        199, 199, 199, 199, 200, 200, 200, 200, 200, 200, 200, 200,
+        200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200,
+        200, 200, 200, 200, 200, 201, 201, 201, 201, 201, 201, 201,
+        201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201,
+        201, 201, 201, 201, 201, 201, 201, 202, 202, 202, 202, 202,
+        202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202,
+        202, 202, 202, 202, 202, 202, 202, 202, 202, 203, 203, 203,
+        203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203,
+        203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 204, 204,
+        204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204,
+        204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204,
+        205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205,
+        205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205,
+        205, 205, 205, 206, 206, 206, 206, 206, 206, 206, 206, 206,
+        206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206,
+        206, 206, 206, 206, 206, 207, 207, 207, 207, 207, 207, 207,
+        207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207,
+        207, 207, 207, 207, 207, 207, 207, 208, 208, 208, 208, 208,
+        208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208,
+        208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 209, 209,
+        209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209,
+        209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209,
+        209, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210,
+        210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210,
+        210, 210, 210, 210, 211, 211, 211, 211, 211, 211, 211, 211,
+        211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211,
+        211, 211, 211, 211, 211, 211, 211, 212, 212, 212, 212, 212,
+        212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212,
+        212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 213, 213,
+        213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213,
+        213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213,
+        213, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214,
+        214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214,
+        214, 214, 214, 214, 214, 215, 215, 215, 215, 215, 215, 215,
+        215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215,
+        215, 215, 215, 215, 215, 215, 215, 215, 216, 216, 216, 216,
+        216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216,
+        216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216,
+        217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217,
+        217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217,
+        217, 217, 217, 217, 218, 218, 218, 218, 218, 218, 218, 218,
+        218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218,
+        218, 218, 218, 218, 218, 218, 218, 218, 219, 219, 219, 219,
+        219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219,
+        219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219,
+        220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220,
+        220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220,
+        220, 220, 220, 220, 221, 221, 221, 221, 221, 221, 221, 221,
+        221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221,
+        221, 221, 221, 221, 221, 221, 221, 221, 221, 222, 222, 222,
+        222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222,
+        222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222,
+        222, 222, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223,
+        223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223,
+        223, 223, 223, 223, 223, 223, 224, 224, 224, 224, 224, 224,
+        224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224,
+        224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 225,
+        225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225,
+        225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225,
+        225, 225, 225, 225, 226, 226, 226, 226, 226, 226, 226, 226,
+        226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226,
+        226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 227, 227,
+        227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227,
+        227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227,
+        227, 227, 227, 228, 228, 228, 228, 228, 228, 228, 228, 228,
+        228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228,
+        228, 228, 228, 228, 228, 228, 228, 228, 229, 229, 229, 229,
+        229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229,
+        229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229,
+        229, 229, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230,
+        230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230,
+        230, 230, 230, 230, 230, 230, 230, 230, 231, 231, 231, 231,
+        231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231,
+        231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231,
+        231, 231, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232,
+        232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232,
+        232, 232, 232, 232, 232, 232, 232, 232, 233, 233, 233, 233,
+        233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233,
+        233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233,
+        233, 233, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234,
+        234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234,
+        234, 234, 234, 234, 234, 234, 234, 234, 235, 235, 235, 235,
+        235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235,
+        235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235,
+        235, 235, 235, 236, 236, 236, 236, 236, 236, 236, 236, 236,
+        236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236,
+        236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 237, 237,
+        237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237,
+        237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237,
+        237, 237, 237, 237, 238, 238, 238, 238, 238, 238, 238, 238,
+        238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238,
+        238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 239,
+        239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239,
+        239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239,
+        239, 239, 239, 239, 239, 239, 239, 240, 240, 240, 240, 240,
+        240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240,
+        240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240,
+        240, 240, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241,
+        241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241,
+        241, 241, 241, 241, 241, 241, 241, 241, 241, 242, 242, 242,
+        242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242,
+        242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242,
+        242, 242, 242, 242, 242, 243, 243, 243, 243, 243, 243, 243,
+        243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243,
+        243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243,
+        243, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244,
+        244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244,
+        244, 244, 244, 244, 244, 244, 244, 244, 245, 245, 245, 245,
+        245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245,
+        245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245,
+        245, 245, 245, 245, 246, 246, 246, 246, 246, 246, 246, 246,
+        246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246,
+        246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246,
+        246, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247,
+        247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247,
+        247, 247, 247, 247, 247, 247, 247, 247, 247, 248, 248, 248,
+        248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248,
+        248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248,
+        248, 248, 248, 248, 248, 249, 249, 249, 249, 249, 249, 249,
+        249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249,
+        249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249,
+        249, 249, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250,
+        250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250,
+        250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 251,
+        251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251,
+        251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251,
+        251, 251, 251, 251, 251, 251, 251, 251, 252, 252, 252, 252,
+        252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252,
+        252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252,
+        252, 252, 252, 252, 252, 253, 253, 253, 253, 253, 253, 253,
+        253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253,
+        253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253,
+        253, 253, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254,
+        254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254,
+        254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 255,
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255},
+     {
+        0x0000, 0x1c04, 0x2004, 0x2206, 0x2404, 0x2505, 0x2606, 0x2707, 0x2804, 0x2885,
+        0x2905, 0x2986, 0x2a06, 0x2a87, 0x2b07, 0x2b88, 0x2c04, 0x2c44, 0x2c85, 0x2cc5,
+        0x2d05, 0x2d45, 0x2d86, 0x2dc6, 0x2e06, 0x2e46, 0x2e87, 0x2ec7, 0x2f07, 0x2f47,
+        0x2f88, 0x2fc8, 0x3004, 0x3024, 0x3044, 0x3064, 0x3085, 0x30a5, 0x30c5, 0x30e5,
+        0x3105, 0x3125, 0x3145, 0x3165, 0x3186, 0x31a6, 0x31c6, 0x31e6, 0x3206, 0x3226,
+        0x3246, 0x3266, 0x3287, 0x32a7, 0x32c7, 0x32e7, 0x3307, 0x3327, 0x3347, 0x3367,
+        0x3388, 0x33a8, 0x33c8, 0x33e8, 0x3404, 0x3414, 0x3424, 0x3434, 0x3444, 0x3454,
+        0x3464, 0x3474, 0x3485, 0x3495, 0x34a5, 0x34b5, 0x34c5, 0x34d5, 0x34e5, 0x34f5,
+        0x3505, 0x3515, 0x3525, 0x3535, 0x3545, 0x3555, 0x3565, 0x3575, 0x3586, 0x3596,
+        0x35a6, 0x35b6, 0x35c6, 0x35d6, 0x35e6, 0x35f6, 0x3606, 0x3616, 0x3626, 0x3636,
+        0x3646, 0x3656, 0x3666, 0x3676, 0x3687, 0x3697, 0x36a7, 0x36b7, 0x36c7, 0x36d7,
+        0x36e7, 0x36f7, 0x3707, 0x3717, 0x3727, 0x3737, 0x3747, 0x3757, 0x3767, 0x3777,
+        0x3788, 0x3798, 0x37a8, 0x37b8, 0x37c8, 0x37d8, 0x37e8, 0x37f8, 0x3804, 0x380c,
+        0x3814, 0x381c, 0x3824, 0x382c, 0x3834, 0x383c, 0x3844, 0x384c, 0x3854, 0x385c,
+        0x3864, 0x386c, 0x3874, 0x387c, 0x3885, 0x388d, 0x3895, 0x389d, 0x38a5, 0x38ad,
+        0x38b5, 0x38bd, 0x38c5, 0x38cd, 0x38d5, 0x38dd, 0x38e5, 0x38ed, 0x38f5, 0x38fd,
+        0x3905, 0x390d, 0x3915, 0x391d, 0x3925, 0x392d, 0x3935, 0x393d, 0x3945, 0x394d,
+        0x3955, 0x395d, 0x3965, 0x396d, 0x3975, 0x397d, 0x3986, 0x398e, 0x3996, 0x399e,
+        0x39a6, 0x39ae, 0x39b6, 0x39be, 0x39c6, 0x39ce, 0x39d6, 0x39de, 0x39e6, 0x39ee,
+        0x39f6, 0x39fe, 0x3a06, 0x3a0e, 0x3a16, 0x3a1e, 0x3a26, 0x3a2e, 0x3a36, 0x3a3e,
+        0x3a46, 0x3a4e, 0x3a56, 0x3a5e, 0x3a66, 0x3a6e, 0x3a76, 0x3a7e, 0x3a87, 0x3a8f,
+        0x3a97, 0x3a9f, 0x3aa7, 0x3aaf, 0x3ab7, 0x3abf, 0x3ac7, 0x3acf, 0x3ad7, 0x3adf,
+        0x3ae7, 0x3aef, 0x3af7, 0x3aff, 0x3b07, 0x3b0f, 0x3b17, 0x3b1f, 0x3b27, 0x3b2f,
+        0x3b37, 0x3b3f, 0x3b47, 0x3b4f, 0x3b57, 0x3b5f, 0x3b67, 0x3b6f, 0x3b77, 0x3b7f,
+        0x3b88, 0x3b90, 0x3b98, 0x3ba0, 0x3ba8, 0x3bb0, 0x3bb8, 0x3bc0, 0x3bc8, 0x3bd0,
+        0x3bd8, 0x3be0, 0x3be8, 0x3bf0, 0x3bf8, 0x3c00},
+     {
+        4096, 4096, 4096, 0, 104446, 646, 2486, 0,
+        204796, -2804, 876, 0, 305146, -6254, -734, 0,
+        405496, -9704, -2344, 0, 505846, -13154, -3954, 0,
+        606196, -16604, -5564, 0, 706546, -20054, -7174, 0,
+        806896, -23504, -8784, 0, 907246, -26954, -10394, 0,
+        997561, -30059, -11843, 0, 1770256, -56624, -24240, 0,
+        1930816, -62144, -26816, 0, 2101411, -68009, -29553, 0,
+        2272006, -73874, -32290, 0, 2452636, -80084, -35188, 0,
+        2643301, -86639, -38247, 0, 2844001, -93539, -41467, 0,
+        3044701, -100439, -44687, 0, 3265471, -108029, -48229, 0,
+        3486241, -115619, -51771, 0, 3707011, -123209, -55313, 0,
+        3947851, -131489, -59177, 0, 4188691, -139769, -63041, 0,
+        4449601, -148739, -67227, 0, 4710511, -157709, -71413, 0,
+        4971421, -166679, -75599, 0, 5252401, -176339, -80107, 0,
+        5543416, -186344, -84776, 0, 5834431, -196349, -89445, 0,
+        6135481, -206699, -94275, 0, 6446566, -217394, -99266, 0,
+        6767686, -228434, -104418, 0, 7088806, -239474, -109570, 0,
+        7429996, -251204, -115044, 0, 7771186, -262934, -120518, 0,
+        8122411, -275009, -126153, 0, 8483671, -287429, -131949, 0,
+        8854966, -300194, -137906, 0, 9236296, -313304, -144024, 0,
+        9627661, -326759, -150303, 0, 10019026, -340214, -156582, 0,
+        10420426, -354014, -163022, 0, 10841896, -368504, -169784, 0,
+        11263366, -382994, -176546, 0, 11694871, -397829, -183469, 0,
+        12126376, -412664, -190392, 0, 12577951, -428189, -197637, 0,
+        13039561, -444059, -205043, 0, 13501171, -459929, -212449, 0,
+        13982851, -476489, -220177, 0, 14464531, -493049, -227905, 0,
+        14956246, -509954, -235794, 0, 15457996, -527204, -243844, 0,
+        15969781, -544799, -252055, 0, 16491601, -562739, -260427, 0,
+        17023456, -581024, -268960, 0, 17565346, -599654, -277654, 0,
+        18107236, -618284, -286348, 0, 18669196, -637604, -295364, 0,
+        19241191, -657269, -304541, 0, 19813186, -676934, -313718, 0,
+        20395216, -696944, -323056, 0, 20997316, -717644, -332716, 0,
+        21599416, -738344, -342376, 0, 22211551, -759389, -352197, 0,
+        22833721, -780779, -362179, 0, 23465926, -802514, -372322, 0,
+        24108166, -824594, -382626, 0, 24760441, -847019, -393091, 0,
+        25422751, -869789, -403717, 0, 26095096, -892904, -414504, 0,
+        26767441, -916019, -425291, 0, 27459856, -939824, -436400, 0,
+        28162306, -963974, -447670, 0, 28864756, -988124, -458940, 0,
+        29587276, -1012964, -470532, 0, 30309796, -1037804, -482124, 0,
+        31052386, -1063334, -494038, 0, 31794976, -1088864, -505952, 0,
+        32557636, -1115084, -518188, 0, 33320296, -1141304, -530424, 0,
+        34092991, -1167869, -542821, 0, 34885756, -1195124, -555540, 0,
+        35678521, -1222379, -568259, 0, 36481321, -1249979, -581139, 0,
+        37294156, -1277924, -594180, 0, 38127061, -1306559, -607543, 0,
+        38959966, -1335194, -620906, 0, 39802906, -1364174, -634430, 0,
+        40655881, -1393499, -648115, 0, 41518891, -1423169, -661961, 0,
+        42401971, -1453529, -676129, 0, 43285051, -1483889, -690297, 0,
+        44178166, -1514594, -704626, 0, 45081316, -1545644, -719116, 0,
+        45994501, -1577039, -733767, 0, 46917721, -1608779, -748579, 0,
+        47861011, -1641209, -763713, 0, 48804301, -1673639, -778847, 0,
+        49757626, -1706414, -794142, 0, 50720986, -1739534, -809598, 0,
+        51694381, -1772999, -825215, 0, 52677811, -1806809, -840993, 0,
+        53681311, -1841309, -857093, 0, 54684811, -1875809, -873193, 0,
+        55698346, -1910654, -889454, 0, 56721916, -1945844, -905876, 0,
+        57755521, -1981379, -922459, 0, 58809196, -2017604, -939364, 0,
+        59862871, -2053829, -956269, 0, 60926581, -2090399, -973335, 0,
+        62010361, -2127659, -990723, 0, 63094141, -2164919, -1008111, 0,
+        64187956, -2202524, -1025660, 0, 65301841, -2240819, -1043531, 0,
+        66415726, -2279114, -1061402, 0, 67549681, -2318099, -1079595, 0,
+        68683636, -2357084, -1097788, 0, 69837661, -2396759, -1116303, 0,
+        71001721, -2436779, -1134979, 0, 72165781, -2476799, -1153655, 0,
+        73349911, -2517509, -1172653, 0, 74544076, -2558564, -1191812, 0,
+        75738241, -2599619, -1210971, 0, 76952476, -2641364, -1230452, 0,
+        78176746, -2683454, -1250094, 0, 79411051, -2725889, -1269897, 0,
+        80655391, -2768669, -1289861, 0, 81909766, -2811794, -1309986, 0,
+        83174176, -2855264, -1330272, 0, 84448621, -2899079, -1350719, 0,
+        85733101, -2943239, -1371327, 0, 87037651, -2988089, -1392257, 0,
+        88342201, -3032939, -1413187, 0, 89656786, -3078134, -1434278, 0,
+        90991441, -3124019, -1455691, 0, 92326096, -3169904, -1477104, 0,
+        93680821, -3216479, -1498839, 0, 95035546, -3263054, -1520574, 0,
+        96410341, -3310319, -1542631, 0, 97795171, -3357929, -1564849, 0,
+        99190036, -3405884, -1587228, 0, 100594936, -3454184, -1609768, 0,
+        102009871, -3502829, -1632469, 0, 103434841, -3551819, -1655331, 0,
+        104869846, -3601154, -1678354, 0, 106314886, -3650834, -1701538, 0,
+        107769961, -3700859, -1724883, 0, 109245106, -3751574, -1748550, 0,
+        110720251, -3802289, -1772217, 0, 112215466, -3853694, -1796206, 0,
+        113710681, -3905099, -1820195, 0, 115225966, -3957194, -1844506, 0,
+        116751286, -4009634, -1868978, 0, 118286641, -4062419, -1893611, 0,
+        119821996, -4115204, -1918244, 0, 121387456, -4169024, -1943360, 0,
+        122952916, -4222844, -1968476, 0, 124528411, -4277009, -1993753, 0,
+        126113941, -4331519, -2019191, 0, 127719541, -4386719, -2044951, 0,
+        129325141, -4441919, -2070711, 0, 130950811, -4497809, -2096793, 0,
+        132576481, -4553699, -2122875, 0, 134222221, -4610279, -2149279, 0,
+        135877996, -4667204, -2175844, 0, 137543806, -4724474, -2202570, 0,
+        139219651, -4782089, -2229457, 0, 140915566, -4840394, -2256666, 0,
+        142611481, -4898699, -2283875, 0, 144317431, -4957349, -2311245, 0,
+        146043451, -5016689, -2338937, 0, 147779506, -5076374, -2366790, 0,
+        149515561, -5136059, -2394643, 0, 151271686, -5196434, -2422818, 0,
+        153037846, -5257154, -2451154, 0, 154814041, -5318219, -2479651, 0,
+        156610306, -5379974, -2508470, 0, 158406571, -5441729, -2537289, 0,
+        160212871, -5503829, -2566269, 0, 162039241, -5566619, -2595571, 0,
+        163875646, -5629754, -2625034, 0, 165722086, -5693234, -2654658, 0,
+        167568526, -5756714, -2684282, 0, 169445071, -5821229, -2714389, 0,
+        171321616, -5885744, -2744496, 0, 173208196, -5950604, -2774764, 0,
+        175114846, -6016154, -2805354, 0, 177021496, -6081704, -2835944, 0,
+        178948216, -6147944, -2866856, 0, 180884971, -6214529, -2897929, 0,
+        182831761, -6281459, -2929163, 0, 184788586, -6348734, -2960558, 0,
+        186755446, -6416354, -2992114, 0, 188732341, -6484319, -3023831, 0,
+        190729306, -6552974, -3055870, 0, 192736306, -6621974, -3088070, 0,
+        194743306, -6690974, -3120270, 0, 196770376, -6760664, -3152792, 0,
+        198807481, -6830699, -3185475, 0, 200864656, -6901424, -3218480, 0,
+        202921831, -6972149, -3251485, 0, 204989041, -7043219, -3284651, 0,
+        207076321, -7114979, -3318139, 0, 209173636, -7187084, -3351788, 0,
+        211280986, -7259534, -3385598, 0, 213398371, -7332329, -3419569, 0,
+        215525791, -7405469, -3453701, 0, 217673281, -7479299, -3488155, 0,
+        219820771, -7553129, -3522609, 0, 221988331, -7627649, -3557385, 0,
+        224165926, -7702514, -3592322, 0, 226353556, -7777724, -3627420, 0,
+        228551221, -7853279, -3662679, 0, 230758921, -7929179, -3698099, 0,
+        232986691, -8005769, -3733841, 0, 235214461, -8082359, -3769583, 0,
+        237462301, -8159639, -3805647, 0, 239720176, -8237264, -3841872, 0,
+        241988086, -8315234, -3878258, 0, 244266031, -8393549, -3914805, 0,
+        246564046, -8472554, -3951674, 0, 248862061, -8551559, -3988543, 0,
+        251180146, -8631254, -4025734, 0, 253508266, -8711294, -4063086, 0,
+        255846421, -8791679, -4100599, 0, 258194611, -8872409, -4138273, 0,
+        260562871, -8953829, -4176269, 0, 262931131, -9035249, -4214265, 0,
+        265319461, -9117359, -4252583, 0, 267717826, -9199814, -4291062, 0,
+        270126226, -9282614, -4329702, 0, 272554696, -9366104, -4368664, 0,
+        274983166, -9449594, -4407626, 0, 277431706, -9533774, -4446910, 0,
+        279890281, -9618299, -4486355, 0, 282358891, -9703169, -4525961, 0,
+        284837536, -9788384, -4565728, 0, 287326216, -9873944, -4605656, 0,
+        289834966, -9960194, -4645906, 0, 292343716, -10046444, -4686156, 0,
+        294872536, -10133384, -4726728, 0, 297411391, -10220669, -4767461, 0,
+        299970316, -10308644, -4808516, 0, 302529241, -10396619, -4849571, 0,
+        305108236, -10485284, -4890948, 0, 307697266, -10574294, -4932486, 0,
+        310296331, -10663649, -4974185, 0, 312905431, -10753349, -5016045, 0,
+        315524566, -10843394, -5058066, 0, 318163771, -10934129, -5100409, 0,
+        320813011, -11025209, -5142913, 0, 323462251, -11116289, -5185417, 0,
+        326141596, -11208404, -5228404, 0, 328820941, -11300519, -5271391, 0,
+        0, 0, 0, 0, -18430, 85370, -6440, 0,
+        -36860, 170740, -12880, 0, -55290, 256110, -19320, 0,
+        -73720, 341480, -25760, 0, -92150, 426850, -32200, 0,
+        -110580, 512220, -38640, 0, -129010, 597590, -45080, 0,
+        -147440, 682960, -51520, 0, -165870, 768330, -57960, 0,
+        -182457, 845163, -63756, 0, -324368, 1502512, -113344, 0,
+        -353856, 1639104, -123648, 0, -385187, 1784233, -134596, 0,
+        -416518, 1929362, -145544, 0, -449692, 2083028, -157136, 0,
+        -484709, 2245231, -169372, 0, -521569, 2415971, -182252, 0,
+        -558429, 2586711, -195132, 0, -598975, 2774525, -209300, 0,
+        -639521, 2962339, -223468, 0, -680067, 3150153, -237636, 0,
+        -724299, 3355041, -253092, 0, -768531, 3559929, -268548, 0,
+        -816449, 3781891, -285292, 0, -864367, 4003853, -302036, 0,
+        -912285, 4225815, -318780, 0, -963889, 4464851, -336812, 0,
+        -1017336, 4712424, -355488, 0, -1070783, 4959997, -374164, 0,
+        -1126073, 5216107, -393484, 0, -1183206, 5480754, -413448, 0,
+        -1242182, 5753938, -434056, 0, -1301158, 6027122, -454664, 0,
+        -1363820, 6317380, -476560, 0, -1426482, 6607638, -498456, 0,
+        -1490987, 6906433, -520996, 0, -1557335, 7213765, -544180, 0,
+        -1625526, 7529634, -568008, 0, -1695560, 7854040, -592480, 0,
+        -1767437, 8186983, -617596, 0, -1839314, 8519926, -642712, 0,
+        -1913034, 8861406, -668472, 0, -1990440, 9219960, -695520, 0,
+        -2067846, 9578514, -722568, 0, -2147095, 9945605, -750260, 0,
+        -2226344, 10312696, -777952, 0, -2309279, 10696861, -806932, 0,
+        -2394057, 11089563, -836556, 0, -2478835, 11482265, -866180, 0,
+        -2567299, 11892041, -897092, 0, -2655763, 12301817, -928004, 0,
+        -2746070, 12720130, -959560, 0, -2838220, 13146980, -991760, 0,
+        -2932213, 13582367, -1024604, 0, -3028049, 14026291, -1058092, 0,
+        -3125728, 14478752, -1092224, 0, -3225250, 14939750, -1127000, 0,
+        -3324772, 15400748, -1161776, 0, -3427980, 15878820, -1197840, 0,
+        -3533031, 16365429, -1234548, 0, -3638082, 16852038, -1271256, 0,
+        -3744976, 17347184, -1308608, 0, -3855556, 17859404, -1347248, 0,
+        -3966136, 18371624, -1385888, 0, -4078559, 18892381, -1425172, 0,
+        -4192825, 19421675, -1465100, 0, -4308934, 19959506, -1505672, 0,
+        -4426886, 20505874, -1546888, 0, -4546681, 21060779, -1588748, 0,
+        -4668319, 21624221, -1631252, 0, -4791800, 22196200, -1674400, 0,
+        -4915281, 22768179, -1717548, 0, -5042448, 23357232, -1761984, 0,
+        -5171458, 23954822, -1807064, 0, -5300468, 24552412, -1852144, 0,
+        -5433164, 25167076, -1898512, 0, -5565860, 25781740, -1944880, 0,
+        -5702242, 26413478, -1992536, 0, -5838624, 27045216, -2040192, 0,
+        -5978692, 27694028, -2089136, 0, -6118760, 28342840, -2138080, 0,
+        -6260671, 29000189, -2187668, 0, -6406268, 29674612, -2238544, 0,
+        -6551865, 30349035, -2289420, 0, -6699305, 31031995, -2340940, 0,
+        -6848588, 31723492, -2393104, 0, -7001557, 32432063, -2446556, 0,
+        -7154526, 33140634, -2500008, 0, -7309338, 33857742, -2554104, 0,
+        -7465993, 34583387, -2608844, 0, -7624491, 35317569, -2664228, 0,
+        -7786675, 36068825, -2720900, 0, -7948859, 36820081, -2777572, 0,
+        -8112886, 37579874, -2834888, 0, -8278756, 38348204, -2892848, 0,
+        -8446469, 39125071, -2951452, 0, -8616025, 39910475, -3010700, 0,
+        -8789267, 40712953, -3071236, 0, -8962509, 41515431, -3131772, 0,
+        -9137594, 42326446, -3192952, 0, -9314522, 43145998, -3254776, 0,
+        -9493293, 43974087, -3317244, 0, -9673907, 44810713, -3380356, 0,
+        -9858207, 45664413, -3444756, 0, -10042507, 46518113, -3509156, 0,
+        -10228650, 47380350, -3574200, 0, -10416636, 48251124, -3639888, 0,
+        -10606465, 49130435, -3706220, 0, -10799980, 50026820, -3773840, 0,
+        -10993495, 50923205, -3841460, 0, -11188853, 51828127, -3909724, 0,
+        -11387897, 52750123, -3979276, 0, -11586941, 53672119, -4048828, 0,
+        -11787828, 54602652, -4119024, 0, -11992401, 55550259, -4190508, 0,
+        -12196974, 56497866, -4261992, 0, -12405233, 57462547, -4334764, 0,
+        -12613492, 58427228, -4407536, 0, -12825437, 59408983, -4481596, 0,
+        -13039225, 60399275, -4556300, 0, -13253013, 61389567, -4631004, 0,
+        -13470487, 62396933, -4706996, 0, -13689804, 63412836, -4783632, 0,
+        -13909121, 64428739, -4860268, 0, -14132124, 65461716, -4938192, 0,
+        -14356970, 66503230, -5016760, 0, -14583659, 67553281, -5095972, 0,
+        -14812191, 68611869, -5175828, 0, -15042566, 69678994, -5256328, 0,
+        -15274784, 70754656, -5337472, 0, -15508845, 71838855, -5419260, 0,
+        -15744749, 72931591, -5501692, 0, -15984339, 74041401, -5585412, 0,
+        -16223929, 75151211, -5669132, 0, -16465362, 76269558, -5753496, 0,
+        -16710481, 77404979, -5839148, 0, -16955600, 78540400, -5924800, 0,
+        -17204405, 79692895, -6011740, 0, -17453210, 80845390, -6098680, 0,
+        -17705701, 82014959, -6186908, 0, -17960035, 83193065, -6275780, 0,
+        -18216212, 84379708, -6365296, 0, -18474232, 85574888, -6455456, 0,
+        -18734095, 86778605, -6546260, 0, -18995801, 87990859, -6637708, 0,
+        -19259350, 89211650, -6729800, 0, -19524742, 90440978, -6822536, 0,
+        -19791977, 91678843, -6915916, 0, -20062898, 92933782, -7010584, 0,
+        -20333819, 94188721, -7105252, 0, -20608426, 95460734, -7201208, 0,
+        -20883033, 96732747, -7297164, 0, -21161326, 98021834, -7394408, 0,
+        -21441462, 99319458, -7492296, 0, -21723441, 100625619, -7590828, 0,
+        -22005420, 101931780, -7689360, 0, -22292928, 103263552, -7789824, 0,
+        -22580436, 104595324, -7890288, 0, -22869787, 105935633, -7991396, 0,
+        -23160981, 107284479, -8093148, 0, -23455861, 108650399, -8196188, 0,
+        -23750741, 110016319, -8299228, 0, -24049307, 111399313, -8403556, 0,
+        -24347873, 112782307, -8507884, 0, -24650125, 114182375, -8613500, 0,
+        -24954220, 115590980, -8719760, 0, -25260158, 117008122, -8826664, 0,
+        -25567939, 118433801, -8934212, 0, -25879406, 119876554, -9043048, 0,
+        -26190873, 121319307, -9151884, 0, -26504183, 122770597, -9261364, 0,
+        -26821179, 124238961, -9372132, 0, -27140018, 125715862, -9483544, 0,
+        -27458857, 127192763, -9594956, 0, -27781382, 128686738, -9707656, 0,
+        -28105750, 130189250, -9821000, 0, -28431961, 131700299, -9934988, 0,
+        -28761858, 133228422, -10050264, 0, -29091755, 134756545, -10165540, 0,
+        -29423495, 136293205, -10281460, 0, -29758921, 137846939, -10398668, 0,
+        -30096190, 139409210, -10516520, 0, -30435302, 140980018, -10635016, 0,
+        -30774414, 142550826, -10753512, 0, -31119055, 144147245, -10873940, 0,
+        -31463696, 145743664, -10994368, 0, -31810180, 147348620, -11115440, 0,
+        -32160350, 148970650, -11237800, 0, -32510520, 150592680, -11360160, 0,
+        -32864376, 152231784, -11483808, 0, -33220075, 153879425, -11608100, 0,
+        -33577617, 155535603, -11733036, 0, -33937002, 157200318, -11858616, 0,
+        -34298230, 158873570, -11984840, 0, -34661301, 160555359, -12111708, 0,
+        -35028058, 162254222, -12239864, 0, -35396658, 163961622, -12368664, 0,
+        -35765258, 165669022, -12497464, 0, -36137544, 167393496, -12627552, 0,
+        -36511673, 169126507, -12758284, 0, -36889488, 170876592, -12890304, 0,
+        -37267303, 172626677, -13022324, 0, -37646961, 174385299, -13154988, 0,
+        -38030305, 176160995, -13288940, 0, -38415492, 177945228, -13423536, 0,
+        -38802522, 179737998, -13558776, 0, -39191395, 181539305, -13694660, 0,
+        -39582111, 183349149, -13831188, 0, -39976513, 185176067, -13969004, 0,
+        -40370915, 187002985, -14106820, 0, -40769003, 188846977, -14245924, 0,
+        -41168934, 190699506, -14385672, 0, -41570708, 192560572, -14526064, 0,
+        -41974325, 194430175, -14667100, 0, -42379785, 196308315, -14808780, 0,
+        -42788931, 198203529, -14951748, 0, -43198077, 200098743, -15094716, 0,
+        -43610909, 202011031, -15238972, 0, -44025584, 203931856, -15383872, 0,
+        -44442102, 205861218, -15529416, 0, -44860463, 207799117, -15675604, 0,
+        -45282510, 209754090, -15823080, 0, -45704557, 211709063, -15970556, 0,
+        -46130290, 213681110, -16119320, 0, -46557866, 215661694, -16268728, 0,
+        -46987285, 217650815, -16418780, 0, -47418547, 219648473, -16569476, 0,
+        -47853495, 221663205, -16721460, 0, -48288443, 223677937, -16873444, 0,
+        -48727077, 225709743, -17026716, 0, -49167554, 227750086, -17180632, 0,
+        -49609874, 229798966, -17335192, 0, -50055880, 231864920, -17491040, 0,
+        -50501886, 233930874, -17646888, 0, -50951578, 236013902, -17804024, 0,
+        -51403113, 238105467, -17961804, 0, -51856491, 240205569, -18120228, 0,
+        -52311712, 242314208, -18279296, 0, -52768776, 244431384, -18439008, 0,
+        -53229526, 246565634, -18600008, 0, -53690276, 248699884, -18761008, 0,
+        -54154712, 250851208, -18923296, 0, -54620991, 253011069, -19086228, 0,
+        -55090956, 255188004, -19250448, 0, -55560921, 257364939, -19414668, 0,
+        -56034572, 259558948, -19580176, 0, -56510066, 261761494, -19746328, 0,
+        -56987403, 263972577, -19913124, 0, -57466583, 266192197, -20080564, 0,
+        -57947606, 268420354, -20248648, 0, -58432315, 270665585, -20418020, 0,
+        -58918867, 272919353, -20588036, 0, -59405419, 275173121, -20758052, 0,
+        -59897500, 277452500, -20930000, 0, -60389581, 279731879, -21101948, 0,
+        0, 0, 0, 0, 0, 0, 89970, 0,
+        0, 0, 179940, 0, 0, 0, 269910, 0,
+        0, 0, 359880, 0, 0, 0, 449850, 0,
+        0, 0, 539820, 0, 0, 0, 629790, 0,
+        0, 0, 719760, 0, 0, 0, 809730, 0,
+        0, 0, 890703, 0, 0, 0, 1583472, 0,
+        0, 0, 1727424, 0, 0, 0, 1880373, 0,
+        0, 0, 2033322, 0, 0, 0, 2195268, 0,
+        0, 0, 2366211, 0, 0, 0, 2546151, 0,
+        0, 0, 2726091, 0, 0, 0, 2924025, 0,
+        0, 0, 3121959, 0, 0, 0, 3319893, 0,
+        0, 0, 3535821, 0, 0, 0, 3751749, 0,
+        0, 0, 3985671, 0, 0, 0, 4219593, 0,
+        0, 0, 4453515, 0, 0, 0, 4705431, 0,
+        0, 0, 4966344, 0, 0, 0, 5227257, 0,
+        0, 0, 5497167, 0, 0, 0, 5776074, 0,
+        0, 0, 6063978, 0, 0, 0, 6351882, 0,
+        0, 0, 6657780, 0, 0, 0, 6963678, 0,
+        0, 0, 7278573, 0, 0, 0, 7602465, 0,
+        0, 0, 7935354, 0, 0, 0, 8277240, 0,
+        0, 0, 8628123, 0, 0, 0, 8979006, 0,
+        0, 0, 9338886, 0, 0, 0, 9716760, 0,
+        0, 0, 10094634, 0, 0, 0, 10481505, 0,
+        0, 0, 10868376, 0, 0, 0, 11273241, 0,
+        0, 0, 11687103, 0, 0, 0, 12100965, 0,
+        0, 0, 12532821, 0, 0, 0, 12964677, 0,
+        0, 0, 13405530, 0, 0, 0, 13855380, 0,
+        0, 0, 14314227, 0, 0, 0, 14782071, 0,
+        0, 0, 15258912, 0, 0, 0, 15744750, 0,
+        0, 0, 16230588, 0, 0, 0, 16734420, 0,
+        0, 0, 17247249, 0, 0, 0, 17760078, 0,
+        0, 0, 18281904, 0, 0, 0, 18821724, 0,
+        0, 0, 19361544, 0, 0, 0, 19910361, 0,
+        0, 0, 20468175, 0, 0, 0, 21034986, 0,
+        0, 0, 21610794, 0, 0, 0, 22195599, 0,
+        0, 0, 22789401, 0, 0, 0, 23392200, 0,
+        0, 0, 23994999, 0, 0, 0, 24615792, 0,
+        0, 0, 25245582, 0, 0, 0, 25875372, 0,
+        0, 0, 26523156, 0, 0, 0, 27170940, 0,
+        0, 0, 27836718, 0, 0, 0, 28502496, 0,
+        0, 0, 29186268, 0, 0, 0, 29870040, 0,
+        0, 0, 30562809, 0, 0, 0, 31273572, 0,
+        0, 0, 31984335, 0, 0, 0, 32704095, 0,
+        0, 0, 33432852, 0, 0, 0, 34179603, 0,
+        0, 0, 34926354, 0, 0, 0, 35682102, 0,
+        0, 0, 36446847, 0, 0, 0, 37220589, 0,
+        0, 0, 38012325, 0, 0, 0, 38804061, 0,
+        0, 0, 39604794, 0, 0, 0, 40414524, 0,
+        0, 0, 41233251, 0, 0, 0, 42060975, 0,
+        0, 0, 42906693, 0, 0, 0, 43752411, 0,
+        0, 0, 44607126, 0, 0, 0, 45470838, 0,
+        0, 0, 46343547, 0, 0, 0, 47225253, 0,
+        0, 0, 48124953, 0, 0, 0, 49024653, 0,
+        0, 0, 49933350, 0, 0, 0, 50851044, 0,
+        0, 0, 51777735, 0, 0, 0, 52722420, 0,
+        0, 0, 53667105, 0, 0, 0, 54620787, 0,
+        0, 0, 55592463, 0, 0, 0, 56564139, 0,
+        0, 0, 57544812, 0, 0, 0, 58543479, 0,
+        0, 0, 59542146, 0, 0, 0, 60558807, 0,
+        0, 0, 61575468, 0, 0, 0, 62610123, 0,
+        0, 0, 63653775, 0, 0, 0, 64697427, 0,
+        0, 0, 65759073, 0, 0, 0, 66829716, 0,
+        0, 0, 67900359, 0, 0, 0, 68988996, 0,
+        0, 0, 70086630, 0, 0, 0, 71193261, 0,
+        0, 0, 72308889, 0, 0, 0, 73433514, 0,
+        0, 0, 74567136, 0, 0, 0, 75709755, 0,
+        0, 0, 76861371, 0, 0, 0, 78030981, 0,
+        0, 0, 79200591, 0, 0, 0, 80379198, 0,
+        0, 0, 81575799, 0, 0, 0, 82772400, 0,
+        0, 0, 83986995, 0, 0, 0, 85201590, 0,
+        0, 0, 86434179, 0, 0, 0, 87675765, 0,
+        0, 0, 88926348, 0, 0, 0, 90185928, 0,
+        0, 0, 91454505, 0, 0, 0, 92732079, 0,
+        0, 0, 94018650, 0, 0, 0, 95314218, 0,
+        0, 0, 96618783, 0, 0, 0, 97941342, 0,
+        0, 0, 99263901, 0, 0, 0, 100604454, 0,
+        0, 0, 101945007, 0, 0, 0, 103303554, 0,
+        0, 0, 104671098, 0, 0, 0, 106047639, 0,
+        0, 0, 107424180, 0, 0, 0, 108827712, 0,
+        0, 0, 110231244, 0, 0, 0, 111643773, 0,
+        0, 0, 113065299, 0, 0, 0, 114504819, 0,
+        0, 0, 115944339, 0, 0, 0, 117401853, 0,
+        0, 0, 118859367, 0, 0, 0, 120334875, 0,
+        0, 0, 121819380, 0, 0, 0, 123312882, 0,
+        0, 0, 124815381, 0, 0, 0, 126335874, 0,
+        0, 0, 127856367, 0, 0, 0, 129385857, 0,
+        0, 0, 130933341, 0, 0, 0, 132489822, 0,
+        0, 0, 134046303, 0, 0, 0, 135620778, 0,
+        0, 0, 137204250, 0, 0, 0, 138796719, 0,
+        0, 0, 140407182, 0, 0, 0, 142017645, 0,
+        0, 0, 143637105, 0, 0, 0, 145274559, 0,
+        0, 0, 146921010, 0, 0, 0, 148576458, 0,
+        0, 0, 150231906, 0, 0, 0, 151914345, 0,
+        0, 0, 153596784, 0, 0, 0, 155288220, 0,
+        0, 0, 156997650, 0, 0, 0, 158707080, 0,
+        0, 0, 160434504, 0, 0, 0, 162170925, 0,
+        0, 0, 163916343, 0, 0, 0, 165670758, 0,
+        0, 0, 167434170, 0, 0, 0, 169206579, 0,
+        0, 0, 170996982, 0, 0, 0, 172796382, 0,
+        0, 0, 174595782, 0, 0, 0, 176413176, 0,
+        0, 0, 178239567, 0, 0, 0, 180083952, 0,
+        0, 0, 181928337, 0, 0, 0, 183781719, 0,
+        0, 0, 185653095, 0, 0, 0, 187533468, 0,
+        0, 0, 189422838, 0, 0, 0, 191321205, 0,
+        0, 0, 193228569, 0, 0, 0, 195153927, 0,
+        0, 0, 197079285, 0, 0, 0, 199022637, 0,
+        0, 0, 200974986, 0, 0, 0, 202936332, 0,
+        0, 0, 204906675, 0, 0, 0, 206886015, 0,
+        0, 0, 208883349, 0, 0, 0, 210880683, 0,
+        0, 0, 212896011, 0, 0, 0, 214920336, 0,
+        0, 0, 216953658, 0, 0, 0, 218995977, 0,
+        0, 0, 221056290, 0, 0, 0, 223116603, 0,
+        0, 0, 225194910, 0, 0, 0, 227282214, 0,
+        0, 0, 229378515, 0, 0, 0, 231483813, 0,
+        0, 0, 233607105, 0, 0, 0, 235730397, 0,
+        0, 0, 237871683, 0, 0, 0, 240021966, 0,
+        0, 0, 242181246, 0, 0, 0, 244358520, 0,
+        0, 0, 246535794, 0, 0, 0, 248731062, 0,
+        0, 0, 250935327, 0, 0, 0, 253148589, 0,
+        0, 0, 255370848, 0, 0, 0, 257602104, 0,
+        0, 0, 259851354, 0, 0, 0, 262100604, 0,
+        0, 0, 264367848, 0, 0, 0, 266644089, 0,
+        0, 0, 268938324, 0, 0, 0, 271232559, 0,
+        0, 0, 273544788, 0, 0, 0, 275866014, 0,
+        0, 0, 278196237, 0, 0, 0, 280535457, 0,
+        0, 0, 282883674, 0, 0, 0, 285249885, 0,
+        0, 0, 287625093, 0, 0, 0, 290000301, 0,
+        0, 0, 292402500, 0, 0, 0, 294804699, 0}},
+    // P3_D65 (gamma 0.4545) -> P3_D65_INV (gamma 0.4545), clip: SRGB_D65
+    {{
+            0,    10,    20,    30,    40,    50,    60,    70,    80,    90,    99,   176,
+          192,   209,   226,   244,   263,   283,   303,   325,   347,   369,   393,   417,
+          443,   469,   495,   523,   552,   581,   611,   642,   674,   706,   740,   774,
+          809,   845,   882,   920,   959,   998,  1038,  1080,  1122,  1165,  1208,  1253,
+         1299,  1345,  1393,  1441,  1490,  1540,  1591,  1643,  1696,  1750,  1804,  1860,
+         1917,  1974,  2032,  2092,  2152,  2213,  2275,  2338,  2402,  2467,  2533,  2600,
+         2667,  2736,  2806,  2876,  2948,  3020,  3094,  3168,  3244,  3320,  3397,  3476,
+         3555,  3635,  3716,  3799,  3882,  3966,  4051,  4137,  4225,  4313,  4402,  4492,
+         4583,  4675,  4769,  4863,  4958,  5054,  5151,  5249,  5349,  5449,  5550,  5652,
+         5755,  5860,  5965,  6071,  6179,  6287,  6396,  6507,  6618,  6731,  6844,  6959,
+         7075,  7191,  7309,  7428,  7547,  7668,  7790,  7913,  8037,  8162,  8288,  8415,
+         8543,  8673,  8803,  8934,  9067,  9200,  9335,  9470,  9607,  9745,  9884, 10024,
+        10165, 10307, 10450, 10594, 10739, 10886, 11033, 11182, 11331, 11482, 11634, 11787,
+        11940, 12096, 12252, 12409, 12567, 12727, 12887, 13049, 13211, 13375, 13540, 13706,
+        13873, 14042, 14211, 14381, 14553, 14726, 14899, 15074, 15250, 15427, 15606, 15785,
+        15965, 16147, 16330, 16514, 16698, 16885, 17072, 17260, 17450, 17640, 17832, 18025,
+        18219, 18414, 18610, 18807, 19006, 19206, 19406, 19608, 19811, 20016, 20221, 20427,
+        20635, 20844, 21054, 21265, 21477, 21691, 21905, 22121, 22338, 22556, 22775, 22995,
+        23217, 23439, 23663, 23888, 24114, 24341, 24570, 24799, 25030, 25262, 25495, 25729,
+        25965, 26201, 26439, 26678, 26918, 27160, 27402, 27646, 27891, 28137, 28384, 28632,
+        28882, 29132, 29384, 29637, 29892, 30147, 30404, 30662, 30921, 31181, 31442, 31705,
+        31969, 32233, 32500, 32767},
+     {10035, -1843, 0, -345, 8537, 0, -161, -644, 8997},
+     {6738, 1454, 0, 272, 7920, 0, 140, 593, 7459},
+     true, PIXEL_RGBA8,
+     {
+          0,   1,   2,   3,   4,   4,   5,   6,   7,   8,   8,   9,
+         10,   6,   7,   7,   8,   9,   9,  10,  10,  11,  11,  12,
+         12,  13,  13,  14,  14,  15,  15,  15,  16,  16,  17,  17,
+         17,  18,  18,  19,  19,  19,  20,  20,  20,  21,  21,  21,
+         22,  22,  22,  23,  23,  23,  24,  24,  24,  25,  25,  25,
+         26,  26,  26,  26,  27,  27,  27,  28,  28,  28,  28,  29,
+         29,  29,  30,  30,  30,  30,  31,  31,  31,  31,  32,  32,
+         32,  32,  33,  33,  33,  33,  34,  34,  34,  34,  34,  35,
+         35,  35,  35,  36,  36,  36,  36,  37,  37,  37,  37,  37,
+         38,  38,  38,  38,  38,  39,  39,  39,  39,  40,  40,  40,
+         40,  40,  41,  41,  41,  41,  41,  42,  42,  42,  42,  42,
+         43,  43,  43,  43,  43,  43,  44,  44,  44,  44,  44,  45,
+         45,  45,  45,  45,  46,  46,  46,  46,  46,  46,  47,  47,
+         47,  47,  47,  48,  48,  48,  48,  48,  48,  49,  49,  49,
+         49,  49,  49,  50,  50,  50,  50,  50,  50,  51,  51,  51,
+         51,  51,  51,  52,  52,  52,  52,  52,  52,  53,  53,  53,
+         53,  53,  53,  53,  54,  54,  54,  54,  54,  54,  55,  55,
+         55,  55,  55,  55,  55,  56,  56,  56,  56,  56,  56,  57,
+         57,  57,  57,  57,  57,  57,  58,  58,  58,  58,  58,  58,
+         58,  59,  59,  59,  59,  59,  59,  59,  60,  60,  60,  60,
+         60,  60,  60,  61,  61,  61,  61,  61,  61,  61,  62,  62,
+         62,  62,  62,  62,  62,  62,  63,  63,  63,  63,  63,  63,
+         63,  64,  64,  64,  64,  64,  64,  64,  64,  65,  65,  65,
+         65,  65,  65,  65,  66,  66,  66,  66,  66,  66,  66,  66,
+         67,  67,  67,  67,  67,  67,  67,  67,  68,  68,  68,  68,
+         68,  68,  68,  68,  69,  69,  69,  69,  69,  69,  69,  69,
+         70,  70,  70,  70,  70,  70,  70,  70,  70,  71,  71,  71,
+         71,  71,  71,  71,  71,  72,  72,  72,  72,  72,  72,  72,
+         72,  72,  73,  73,  73,  73,  73,  73,  73,  73,  74,  74,
+         74,  74,  74,  74,  74,  74,  74,  75,  75,  75,  75,  75,
+         75,  75,  75,  75,  76,  76,  76,  76,  76,  76,  76,  76,
+         76,  77,  77,  77,  77,  77,  77,  77,  77,  77,  78,  78,
+         78,  78,  78,  78,  78,  78,  78,  79,  79,  79,  79,  79,
+         79,  79,  79,  79,  79,  80,  80,  80,  80,  80,  80,  80,
+         80,  80,  81,  81,  81,  81,  81,  81,  81,  81,  81,  81,
+         82,  82,  82,  82,  82,  82,  82,  82,  82,  82,  83,  83,
+         83,  83,  83,  83,  83,  83,  83,  84,  84,  84,  84,  84,
+         84,  84,  84,  84,  84,  85,  85,  85,  85,  85,  85,  85,
+         85,  85,  85,  86,  86,  86,  86,  86,  86,  86,  86,  86,
+         86,  86,  87,  87,  87,  87,  87,  87,  87,  87,  87,  87,
+         88,  88,  88,  88,  88,  88,  88,  88,  88,  88,  89,  89,
+         89,  89,  89,  89,  89,  89,  89,  89,  89,  90,  90,  90,
+         90,  90,  90,  90,  90,  90,  90,  90,  91,  91,  91,  91,
+         91,  91,  91,  91,  91,  91,  91,  92,  92,  92,  92,  92,
+         92,  92,  92,  92,  92,  92,  93,  93,  93,  93,  93,  93,
+         93,  93,  93,  93,  93,  94,  94,  94,  94,  94,  94,  94,
+         94,  94,  94,  94,  95,  95,  95,  95,  95,  95,  95,  95,
+         95,  95,  95,  96,  96,  96,  96,  96,  96,  96,  96,  96,
+         96,  96,  96,  97,  97,  97,  97,  97,  97,  97,  97,  97,
+         97,  97,  98,  98,  98,  98,  98,  98,  98,  98,  98,  98,
+         98,  98,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,
+         99,  99, 100, 100, 100, 100, 100, 100, 100, 100, 100, 100,
+        100, 100, 101, 101, 101, 101, 101, 101, 101, 101, 101, 101,
+        101, 101, 102, 102, 102, 102, 102, 102, 102, 102, 102, 102,
+        102, 102, 103, 103, 103, 103, 103, 103, 103, 103, 103, 103,
+        103, 103, 104, 104, 104, 104, 104, 104, 104, 104, 104, 104,
+        104, 104, 104, 105, 105, 105, 105, 105, 105, 105, 105, 105,
+        105, 105, 105, 106, 106, 106, 106, 106, 106, 106, 106, 106,
+        106, 106, 106, 106, 107, 107, 107, 107, 107, 107, 107, 107,
+        107, 107, 107, 107, 107, 108, 108, 108, 108, 108, 108, 108,
+        108, 108, 108, 108, 108, 108, 109, 109, 109, 109, 109, 109,
+        109, 109, 109, 109, 109, 109, 109, 110, 110, 110, 110, 110,
+        110, 110, 110, 110, 110, 110, 110, 110, 111, 111, 111, 111,
+        111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 112, 112,
+        112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 113,
+        113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113, 113,
+        113, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114,
+        114, 114, 115, 115, 115, 115, 115, 115, 115, 115, 115, 115,
+        115, 115, 115, 115, 116, 116, 116, 116, 116, 116, 116, 116,
+        116, 116, 116, 116, 116, 116, 117, 117, 117, 117, 117, 117,
+        117, 117, 117, 117, 117, 117, 117, 117, 118, 118, 118, 118,
+        118, 118, 118, 118, 118, 118, 118, 118, 118, 118, 118, 119,
+        119, 119, 119, 119, 119, 119, 119, 119, 119, 119, 119, 119,
+        119, 120, 120, 120, 120, 120, 120, 120, 120, 120, 120, 120,
+        120, 120, 120, 120, 121, 121, 121, 121, 121, 121, 121, 121,
+        121, 121, 121, 121, 121, 121, 122, 122, 122, 122, 122, 122,
+        122, 122, 122, 122, 122, 122, 122, 122, 122, 123, 123, 123,
+        123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123,
+        124, 124, 124, 124, 124, 124, 124, 124, 124, 124, 124, 124,
+        124, 124, 124, 125, 125, 125, 125, 125, 125, 125, 125, 125,
+        125, 125, 125, 125, 125, 125, 126, 126, 126, 126, 126, 126,
+        126, 126, 126, 126, 126, 126, 126, 126, 126, 127, 127, 127,
+        127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+        127, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128, 128,
+        128, 128, 128, 128, 129, 129, 129, 129, 129, 129, 129, 129,
+        129, 129, 129, 129, 129, 129, 129, 129, 130, 130, 130, 130,
+        130, 130, 130, 130, 130, 130, 130, 130, 130, 130, 130, 130,
+        131, 131, 131, 131, 131, 131, 131, 131, 131, 131, 131, 131,
+        131, 131, 131, 131, 132, 132, 132, 132, 132, 132, 132, 132,
+        132, 132, 132, 132, 132, 132, 132, 132, 133, 133, 133, 133,
+        133, 133, 133, 133, 133, 133, 133, 133, 133, 133, 133, 133,
+        134, 134, 134, 134, 134, 134, 134, 134, 134, 134, 134, 134,
+        134, 134, 134, 134, 134, 135, 135, 135, 135, 135, 135, 135,
+        135, 135, 135, 135, 135, 135, 135, 135, 135, 136, 136, 136,
+        136, 136, 136, 136, 136, 136, 136, 136, 136, 136, 136, 136,
+        136, 136, 137, 137, 137, 137, 137, 137, 137, 137, 137, 137,
+        137, 137, 137, 137, 137, 137, 138, 138, 138, 138, 138, 138,
+        138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 139,
+        139, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139,
+        139, 139, 139, 139, 140, 140, 140, 140, 140, 140, 140, 140,
+        140, 140, 140, 140, 140, 140, 140, 140, 140, 141, 141, 141,
+        141, 141, 141, 141, 141, 141, 141, 141, 141, 141, 141, 141,
+        141, 141, 141, 142, 142, 142, 142, 142, 142, 142, 142, 142,
+        142, 142, 142, 142, 142, 142, 142, 142, 143, 143, 143, 143,
+        143, 143, 143, 143, 143, 143, 143, 143, 143, 143, 143, 143,
+        143, 143, 144, 144, 144, 144, 144, 144, 144, 144, 144, 144,
+        144, 144, 144, 144, 144, 144, 144, 145, 145, 145, 145, 145,
+        145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145,
+        145, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146,
+        146, 146, 146, 146, 146, 146, 146, 147, 147, 147, 147, 147,
+        147, 147, 147, 147, 147, 147, 147, 147, 147, 147, 147, 147,
+        147, 148, 148, 148, 148, 148, 148, 148, 148, 148, 148, 148,
+        148, 148, 148, 148, 148, 148, 148, 148, 149, 149, 149, 149,
+        149, 149, 149, 149, 149, 149, 149, 149, 149, 149, 149, 149,
+        149, 149, 150, 150, 150, 150, 150, 150, 150, 150, 150, 150,
+        150, 150, 150, 150, 150, 150, 150, 150, 151, 151, 151, 151,
+        151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151,
+        151, 151, 151, 152, 152, 152, 152, 152, 152, 152, 152, 152,
+        152, 152, 152, 152, 152, 152, 152, 152, 152, 152, 153, 153,
+        153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153,
+        153, 153, 153, 153, 153, 154, 154, 154, 154, 154, 154, 154,
+        154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154,
+        155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155,
+        155, 155, 155, 155, 155, 155, 155, 156, 156, 156, 156, 156,
+        156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156,
+        156, 156, 157, 157, 157, 157, 157, 157, 157, 157, 157, 157,
+        157, 157, 157, 157, 157, 157, 157, 157, 157, 157, 158, 158,
+        158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158,
+        158, 158, 158, 158, 158, 159, 159, 159, 159, 159, 159, 159,
+        159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159,
+        159, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160,
+        160, 160, 160, 160, 160, 160, 160, 160, 160, 161, 161, 161,
+        161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161,
+        161, 161, 161, 161, 161, 162, 162, 162, 162, 162, 162, 162,
+        162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162,
+        162, 163, 163, 163, 163, 163, 163, 163, 163, 163, 163, 163,
+        163, 163, 163, 163, 163, 163, 163, 163, 163, 164, 164, 164,
+        164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164,
+        164, 164, 164, 164, 164, 164, 165, 165, 165, 165, 165, 165,
+        165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165,
+        165, 165, 166, 166, 166, 166, 166, 166, 166, 166, 166, 166,
+        166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 167,
+        167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167,
+        167, 167, 167, 167, 167, 167, 167, 167, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 168,
+        168, 168, 168, 168, 168, 169, 169, 169, 169, 169, 169, 169,
+        169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169,
+        169, 169, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 171,
+        171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171,
+        171, 171, 171, 171, 171, 171, 171, 171, 172, 172, 172, 172,
+        172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172,
+        172, 172, 172, 172, 172, 172, 173, 173, 173, 173, 173, 173,
+        173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173,
+        173, 173, 173, 173, 174, 174, 174, 174, 174, 174, 174, 174,
+        174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
+        174, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175,
+        175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 176,
+        176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
+        176, 176, 176, 176, 176, 176, 176, 176, 176, 177, 177, 177,
+        177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177,
+        177, 177, 177, 177, 177, 177, 177, 177, 178, 178, 178, 178,
+        178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178,
+        178, 178, 178, 178, 178, 178, 179, 179, 179, 179, 179, 179,
+        179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179,
+        179, 179, 179, 179, 180, 180, 180, 180, 180, 180, 180, 180,
+        180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180,
+        180, 180, 180, 181, 181, 181, 181, 181, 181, 181, 181, 181,
+        181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 181,
+        181, 181, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182,
+        182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182,
+        182, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183,
+        183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183,
+        184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184,
+        184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 185,
+        185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185,
+        185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 186, 186,
+        186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186,
+        186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 187, 187,
+        187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187,
+        187, 187, 187, 187, 187, 187, 187, 187, 187, 188, 188, 188,
+        188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188,
+        188, 188, 188, 188, 188, 188, 188, 188, 188, 189, 189, 189,
+        189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189,
+        189, 189, 189, 189, 189, 189, 189, 189, 189, 190, 190, 190,
+        190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190,
+        190, 190, 190, 190, 190, 190, 190, 190, 190, 191, 191, 191,
+        191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191,
+        191, 191, 191, 191, 191, 191, 191, 191, 191, 192, 192, 192,
+        192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192,
+        192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 193, 193,
+        193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193,
+        193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 194, 194,
+        194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194,
+        194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 195,
+        195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195,
+        195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 196,
+        196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196,
+        196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196,
+        197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197,
+        197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197,
+        197, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198,
+        198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198,
+        198, 198, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199,
+        199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199,
+        199, 199, 199, 199, 200, 200, 200, 200, 200, 200, 200, 200,
+        200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200,
+        200, 200, 200, 200, 200, 201, 201, 201, 201, 201, 201, 201,
+        201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201,
+        201, 201, 201, 201, 201, 201, 201, 202, 202, 202, 202, 202,
+        202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202,
+        202, 202, 202, 202, 202, 202, 202, 202, 202, 203, 203, 203,
+        203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203,
+        203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 204, 204,
+        204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204,
+        204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204,
+        205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205,
+        205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205,
+        205, 205, 205, 206, 206, 206, 206, 206, 206, 206, 206, 206,
+        206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206,
+        206, 206, 206, 206, 206, 207, 207, 207, 207, 207, 207, 207,
+        207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207,
+        207, 207, 207, 207, 207, 207, 207, 208, 208, 208, 208, 208,
+        208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208,
+        208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 209, 209,
+        209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209,
+        209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209,
+        209, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210,
+        210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210,
+        210, 210, 210, 210, 211, 211, 211, 211, 211, 211, 211, 211,
+        211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211,
+        211, 211, 211, 211, 211, 211, 211, 212, 212, 212, 212, 212,
+        212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212,
+        212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 213, 213,
+        213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213,
+        213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213,
+        213, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214,
+        214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214,
+        214, 214, 214, 214, 214, 215, 215, 215, 215, 215, 215, 215,
+        215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215,
+        215, 215, 215, 215, 215, 215, 215, 215, 216, 216, 216, 216,
+        216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216,
+        216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216,
+        217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217,
+        217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217,
+        217, 217, 217, 217, 218, 218, 218, 218, 218, 218, 218, 218,
+        218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218,
+        218, 218, 218, 218, 218, 218, 218, 218, 219, 219, 219, 219,
+        219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219,
+        219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219,
+        220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220,
+        220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220,
+        220, 220, 220, 220, 221, 221, 221, 221, 221, 221, 221, 221,
+        221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221,
+        221, 221, 221, 221, 221, 221, 221, 221, 221, 222, 222, 222,
+        222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222,
+        222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222,
+        222, 222, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223,
+        223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223,
+        223, 223, 223, 223, 223, 223, 224, 224, 224, 224, 224, 224,
+        224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224,
+        224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 225,
+        225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225,
+        225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225,
+        225, 225, 225, 225, 226, 226, 226, 226, 226, 226, 226, 226,
+        226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226,
+        226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 227, 227,
+        227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227,
+        227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227,
+        227, 227, 227, 228, 228, 228, 228, 228, 228, 228, 228, 228,
+        228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228,
+        228, 228, 228, 228, 228, 228, 228, 228, 229, 229, 229, 229,
+        229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229,
+        229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229,
+        229, 229, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230,
+        230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230,
+        230, 230, 230, 230, 230, 230, 230, 230, 231, 231, 231, 231,
+        231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231,
+        231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231,
+        231, 231, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232,
+        232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232,
+        232, 232, 232, 232, 232, 232, 232, 232, 233, 233, 233, 233,
+        233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233,
+        233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233,
+        233, 233, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234,
+        234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234,
+        234, 234, 234, 234, 234, 234, 234, 234, 235, 235, 235, 235,
+        235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235,
+        235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235,
+        235, 235, 235, 236, 236, 236, 236, 236, 236, 236, 236, 236,
+        236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236,
+        236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 237, 237,
+        237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237,
+        237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237,
+        237, 237, 237, 237, 238, 238, 238, 238, 238, 238, 238, 238,
+        238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238,
+        238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 239,
+        239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239,
+        239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239,
+        239, 239, 239, 239, 239, 239, 239, 240, 240, 240, 240, 240,
+        240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240,
+        240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240,
+        240, 240, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241,
+        241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241,
+        241, 241, 241, 241, 241, 241, 241, 241, 241, 242, 242, 242,
+        242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242,
+        242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242,
+        242, 242, 242, 242, 242, 243, 243, 243, 243, 243, 243, 243,
+        243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243,
+        243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243,
+        243, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244,
+        244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244,
+        244, 244, 244, 244, 244, 244, 244, 244, 245, 245, 245, 245,
+        245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245,
+        245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245,
+        245, 245, 245, 245, 246, 246, 246, 246, 246, 246, 246, 246,
+        246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246,
+        246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246,
+        246, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247,
+        247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247,
+        247, 247, 247, 247, 247, 247, 247, 247, 247, 248, 248, 248,
+        248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248,
+        248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248,
+        248, 248, 248, 248, 248, 249, 249, 249, 249, 249, 249, 249,
+        249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249,
+        249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249,
+        249, 249, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250,
+        250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250,
+        250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 251,
+        251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251,
+        251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251,
+        251, 251, 251, 251, 251, 251, 251, 251, 252, 252, 252, 252,
+        252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252,
+        252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252,
+        252, 252, 252, 252, 252, 253, 253, 253, 253, 253, 253, 253,
+        253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253,
+        253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253,
+        253, 253, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254,
+        254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254,
+        254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 255,
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255},
+     {
+        0x0000, 0x1c04, 0x2004, 0x2206, 0x2404, 0x2505, 0x2606, 0x2707, 0x2804, 0x2885,
+        0x2905, 0x2986, 0x2a06, 0x2a87, 0x2b07, 0x2b88, 0x2c04, 0x2c44, 0x2c85, 0x2cc5,
+        0x2d05, 0x2d45, 0x2d86, 0x2dc6, 0x2e06, 0x2e46, 0x2e87, 0x2ec7, 0x2f07, 0x2f47,
+        0x2f88, 0x2fc8, 0x3004, 0x3024, 0x3044, 0x3064, 0x3085, 0x30a5, 0x30c5, 0x30e5,
+        0x3105, 0x3125, 0x3145, 0x3165, 0x3186, 0x31a6, 0x31c6, 0x31e6, 0x3206, 0x3226,
+        0x3246, 0x3266, 0x3287, 0x32a7, 0x32c7, 0x32e7, 0x3307, 0x3327, 0x3347, 0x3367,
+        0x3388, 0x33a8, 0x33c8, 0x33e8, 0x3404, 0x3414, 0x3424, 0x3434, 0x3444, 0x3454,
+        0x3464, 0x3474, 0x3485, 0x3495, 0x34a5, 0x34b5, 0x34c5, 0x34d5, 0x34e5, 0x34f5,
+        0x3505, 0x3515, 0x3525, 0x3535, 0x3545, 0x3555, 0x3565, 0x3575, 0x3586, 0x3596,
+        0x35a6, 0x35b6, 0x35c6, 0x35d6, 0x35e6, 0x35f6, 0x3606, 0x3616, 0x3626, 0x3636,
+        0x3646, 0x3656, 0x3666, 0x3676, 0x3687, 0x3697, 0x36a7, 0x36b7, 0x36c7, 0x36d7,
+        0x36e7, 0x36f7, 0x3707, 0x3717, 0x3727, 0x3737, 0x3747, 0x3757, 0x3767, 0x3777,
+        0x3788, 0x3798, 0x37a8, 0x37b8, 0x37c8, 0x37d8, 0x37e8, 0x37f8, 0x3804, 0x380c,
+        0x3814, 0x381c, 0x3824, 0x382c, 0x3834, 0x383c, 0x3844, 0x384c, 0x3854, 0x385c,
+        0x3864, 0x386c, 0x3874, 0x387c, 0x3885, 0x388d, 0x3895, 0x389d, 0x38a5, 0x38ad,
+        0x38b5, 0x38bd, 0x38c5, 0x38cd, 0x38d5, 0x38dd, 0x38e5, 0x38ed, 0x38f5, 0x38fd,
+        0x3905, 0x390d, 0x3915, 0x391d, 0x3925, 0x392d, 0x3935, 0x393d, 0x3945, 0x394d,
+        0x3955, 0x395d, 0x3965, 0x396d, 0x3975, 0x397d, 0x3986, 0x398e, 0x3996, 0x399e,
+        0x39a6, 0x39ae, 0x39b6, 0x39be, 0x39c6, 0x39ce, 0x39d6, 0x39de, 0x39e6, 0x39ee,
+        0x39f6, 0x39fe, 0x3a06, 0x3a0e, 0x3a16, 0x3a1e, 0x3a26, 0x3a2e, 0x3a36, 0x3a3e,
+        0x3a46, 0x3a4e, 0x3a56, 0x3a5e, 0x3a66, 0x3a6e, 0x3a76, 0x3a7e, 0x3a87, 0x3a8f,
+        0x3a97, 0x3a9f, 0x3aa7, 0x3aaf, 0x3ab7, 0x3abf, 0x3ac7, 0x3acf, 0x3ad7, 0x3adf,
+        0x3ae7, 0x3aef, 0x3af7, 0x3aff, 0x3b07, 0x3b0f, 0x3b17, 0x3b1f, 0x3b27, 0x3b2f,
+        0x3b37, 0x3b3f, 0x3b47, 0x3b4f, 0x3b57, 0x3b5f, 0x3b67, 0x3b6f, 0x3b77, 0x3b7f,
+        0x3b88, 0x3b90, 0x3b98, 0x3ba0, 0x3ba8, 0x3bb0, 0x3bb8, 0x3bc0, 0x3bc8, 0x3bd0,
+        0x3bd8, 0x3be0, 0x3be8, 0x3bf0, 0x3bf8, 0x3c00},
+     {}},
+};
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#include "TexturePipeline.h"
+
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "ColorSpaceTransform.h"
+#include "android_debug.h"
+#include "simple_png.h"
+
+// decoded rows are converted this many at a time
+#define PREPARE_BAND_ROWS 64
+
+TexturePipeline::TexturePipeline(uint32_t workerCount, uint32_t queueSize)
+    : queueSize_(std::max(queueSize, 1u)),
+      generation_(0),
+      count_(0),
+      nextIndex_(0),
+      taken_(0),
+      p3Display_(false),
+      exit_(false) {
+  if (!workerCount) {
+    workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+  }
+  for (uint32_t idx = 0; idx < workerCount; idx++) {
+    workers_.emplace_back(&TexturePipeline::Worker, this);
+  }
+}
+
+TexturePipeline::~TexturePipeline() {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    exit_ = true;
+    generation_++;
+  }
+  work_.notify_all();
+  space_.notify_all();
+  for (std::thread& worker : workers_) worker.join();
+}
+
+void TexturePipeline::Start(uint32_t count, const FileReader& reader,
+                            bool p3Display) {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    generation_++;
+    queue_.clear();
+    reader_ = reader;
+    count_ = count;
+    nextIndex_ = taken_ = 0;
+    p3Display_ = p3Display;
+  }
+  work_.notify_all();
+  space_.notify_all();
+  prepared_.notify_all();
+}
+
+void TexturePipeline::Cancel(void) {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    generation_++;
+    queue_.clear();
+    reader_ = nullptr;
+    count_ = nextIndex_ = taken_ = 0;
+  }
+  space_.notify_all();
+  prepared_.notify_all();
+}
+
+bool TexturePipeline::Next(std::unique_ptr<PREPARED_IMAGE>& image,
+                           bool wait) {
+  std::unique_lock<std::mutex> lock(lock_);
+  if (wait) {
+    prepared_.wait(lock,
+                   [this] { return !queue_.empty() || taken_ == count_; });
+  }
+  if (queue_.empty()) return false;
+
+  image = std::move(queue_.front());
+  queue_.pop_front();
+  taken_++;
+  lock.unlock();
+  space_.notify_one();
+  return true;
+}
+
+uint32_t TexturePipeline::Pending(void) {
+  std::lock_guard<std::mutex> lock(lock_);
+  return count_ - taken_;
+}
+
+/*
+ * Worker()
+ *     Prepares the next image of the current Start() until there are none
+ *     left, then waits for the next Start(). An image whose Start() has been
+ *     replaced is dropped, wherever it got to.
+ */
+void TexturePipeline::Worker(void) {
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true) {
+    work_.wait(lock, [this] { return exit_ || nextIndex_ < count_; });
+    if (exit_) return;
+
+    uint32_t generation = generation_;
+    std::unique_ptr<PREPARED_IMAGE> image(new PREPARED_IMAGE());
+    image->index_ = nextIndex_++;
+    FileReader reader = reader_;
+    bool p3Display = p3Display_;
+    lock.unlock();
+
+    auto cancelled = [this, generation] { return generation_ != generation; };
+    std::vector<uint8_t> file;
+    image->valid_ = reader(image->index_, file) &&
+                    Prepare(file, p3Display, *image, cancelled);
+    file = std::vector<uint8_t>();
+
+    lock.lock();
+    space_.wait(lock, [&] {
+      return cancelled() || queue_.size() < queueSize_;
+    });
+    if (cancelled()) continue;
+    queue_.push_back(std::move(image));
+    prepared_.notify_one();
+  }
+}
+
+/*
+ * GetSourceSpace()
+ *     Primaries within SOURCE_P3_TOLERANCE (per NPM entry) of display P3 count
+ *     as P3, and keep the default P3 gamma: the app has always shown these
+ *     images as they are coded.
+ */
+#define SOURCE_P3_TOLERANCE 0.002f
+SOURCE_SPACE TexturePipeline::GetSourceSpace(const uint8_t* png, size_t size) {
+  const mathfu::mat3& p3 = *GetTransformNPM(NPM_TYPE::P3_D65);
+  SOURCE_SPACE source{p3, DEFAULT_P3_IMAGE_GAMMA, true};
+  PNGHeader header("", png, size);
+  if (!header.HasNPM()) return source;
+
+  const mathfu::mat3& npm = *header.NPM();
+  for (int32_t idx = 0; idx < 9; idx++) {
+    float delta = npm(idx / 3, idx % 3) - p3(idx / 3, idx % 3);
+    if (delta > SOURCE_P3_TOLERANCE || delta < -SOURCE_P3_TOLERANCE) {
+      source.p3_ = false;
+    }
+  }
+  if (!source.p3_) {
+    source.npm_ = npm;
+    source.gamma_ = header.GetGamma();
+  }
+  return source;
+}
+
+void TexturePipeline::ConvertRows(bool p3Display, const SOURCE_SPACE& source,
+                                  uint32_t width, uint32_t rowCount,
+                                  uint8_t* rows, uint8_t* sRGBView) {
+  IMAGE_FORMAT src{
+      .buf_ = rows,
+      .width_ = width,
+      .height_ = rowCount,
+      .gamma_ = source.gamma_,
+      .npm_ = &source.npm_,
+  };
+  IMAGE_FORMAT dst{
+      .buf_ = sRGBView,
+      .width_ = width,
+      .height_ = rowCount,
+      .gamma_ = DEFAULT_DISPLAY_GAMMA,
+  };
+  if (!p3Display) {
+    dst.npm_ = GetTransformNPM(NPM_TYPE::SRGB_D65_INV);
+    TransformColorSpaceHighPrecision(dst, src);
+    return;
+  }
+
+  // in one pass without an 8 bit intermediate
+  dst.npm_ = GetTransformNPM(NPM_TYPE::P3_D65_INV);
+  TransformColorSpaceHighPrecision(dst, src,
+                                   GetTransformNPM(NPM_TYPE::SRGB_D65));
+  if (!source.p3_) {
+    dst.buf_ = rows;
+    TransformColorSpaceHighPrecision(dst, src);
+  }
+}
+
+/*
+ * Prepare()
+ *     Decodes with PNGDecoder, converting each band of rows as it is done;
+ *     PNGs it can't handle are decoded whole with stb_image.
+ */
+bool TexturePipeline::Prepare(const std::vector<uint8_t>& png,
+                              bool p3Display, PREPARED_IMAGE& image,
+                              const std::function<bool(void)>& cancelled) {
+  PNGDecoder decoder(png.data(), png.size());
+  if (!decoder.IsSupported()) {
+    int width, height, n;
+    uint8_t* imageData = stbi_load_from_memory(png.data(), png.size(), &width,
+                                               &height, &n, 4);
+    if (!imageData) return false;
+    SOURCE_SPACE source = GetSourceSpace(png.data(), png.size());
+    image.width_ = width;
+    image.height_ = height;
+    size_t bytes = static_cast<size_t>(width) * height * 4;
+    image.sRGBView_.resize(bytes);
+    ConvertRows(p3Display, source, width, height, imageData,
+                image.sRGBView_.data());
+    if (p3Display) image.p3_.assign(imageData, imageData + bytes);
+    stbi_image_free(imageData);
+    return !cancelled || !cancelled();
+  }
+
+  SOURCE_SPACE source = GetSourceSpace(png.data(), png.size());
+  uint32_t width = decoder.Width(), height = decoder.Height();
+  size_t rowBytes = width * 4;
+  image.width_ = width;
+  image.height_ = height;
+  image.sRGBView_.resize(rowBytes * height);
+  // the rows go straight into p3_ (converted there to P3 if they are not);
+  // for an sRGB display, into a band
+  std::vector<uint8_t> band;
+  if (p3Display) {
+    image.p3_.resize(rowBytes * height);
+  } else {
+    band.resize(rowBytes * PREPARE_BAND_ROWS);
+  }
+  return decoder.Decode([&](uint32_t row, uint8_t* rgba) {
+    uint32_t bandRow = row % PREPARE_BAND_ROWS;
+    uint8_t* bandStart = p3Display ? &image.p3_[(row - bandRow) * rowBytes]
+                                   : band.data();
+    memcpy(bandStart + bandRow * rowBytes, rgba, rowBytes);
+    if (bandRow + 1 == PREPARE_BAND_ROWS || row + 1 == height) {
+      ConvertRows(p3Display, source, width, bandRow + 1, bandStart,
+                  &image.sRGBView_[(row - bandRow) * rowBytes]);
+      if (cancelled && cancelled()) return false;
+    }
+    return true;
+  });
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef __TEXTURE_PIPELINE_H__
+#define __TEXTURE_PIPELINE_H__
+
+#include <mathfu/glsl_mappings.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * PREPARED_IMAGE
+ *     The pixels of an AssetTexture's two textures (RGBA8), ready to upload:
+ *       sRGB display: both textures are sRGBView_; p3_ is empty
+ *       P3 displays:  p3_ is the original image, sRGBView_ the image clipped
+ *                     to the sRGB gamut and back to P3
+ */
+struct PREPARED_IMAGE {
+  uint32_t index_;  // of the image in TexturePipeline::Start()
+  uint32_t width_, height_;
+  bool valid_;  // false if the image could not be read or decoded
+  std::vector<uint8_t> p3_;
+  std::vector<uint8_t> sRGBView_;
+};
+
+/*
+ * SOURCE_SPACE
+ *     Color space of an image file, from its iCCP profile or cHRM / gAMA
+ *     chunks (see PNGHeader); display P3 if it has none. Images in the P3
+ *     primaries (p3_) go to P3 displays untouched, others are converted.
+ */
+struct SOURCE_SPACE {
+  mathfu::mat3 npm_;
+  float gamma_;
+  bool p3_;
+};
+
+/*
+ * TexturePipeline
+ *     Prepares images for AssetTexture on a pool of worker threads: each
+ *     worker reads a file, decodes it and converts it, then puts it on a
+ *     bounded queue for the GL thread, which only uploads. Workers wait while
+ *     the queue is full (so at most queue size + worker count images are in
+ *     memory), and Start() or Cancel() abandons everything of the previous
+ *     Start(), including images being decoded, e.g. when the display color
+ *     space changes.
+ */
+class TexturePipeline {
+ public:
+  // reads image index into data; called on the worker threads
+  typedef std::function<bool(uint32_t index, std::vector<uint8_t>& data)>
+      FileReader;
+
+  static const uint32_t DEFAULT_QUEUE_SIZE = 2;
+
+  // workerCount 0: one per CPU but the GL thread's
+  explicit TexturePipeline(uint32_t workerCount = 0,
+                           uint32_t queueSize = DEFAULT_QUEUE_SIZE);
+  ~TexturePipeline();
+
+  // prepares images 0 -- count - 1, read with reader, for a P3 or an sRGB
+  // display, in no particular order
+  void Start(uint32_t count, const FileReader& reader, bool p3Display);
+  void Cancel(void);
+
+  /*
+   * Next()
+   *     Takes the next prepared image off the queue. With wait, blocks until
+   *     there is one; returns false when every image of the current Start()
+   *     has been taken (or it was cancelled), or nothing is ready without
+   *     wait.
+   */
+  bool Next(std::unique_ptr<PREPARED_IMAGE>& image, bool wait);
+
+  // images of the current Start() not taken yet
+  uint32_t Pending(void);
+
+  uint32_t WorkerCount(void) const {
+    return static_cast<uint32_t>(workers_.size());
+  }
+
+  // what a worker does with a PNG file, on the calling thread; stops early
+  // (returning false) once cancelled returns true
+  static bool Prepare(const std::vector<uint8_t>& png, bool p3Display,
+                      PREPARED_IMAGE& image,
+                      const std::function<bool(void)>& cancelled = nullptr);
+
+  static SOURCE_SPACE GetSourceSpace(const uint8_t* png, size_t size);
+
+  // converts rowCount rows (RGBA8) in the source color space to the sRGB
+  // view of PREPARED_IMAGE, without 8 bit intermediates; on P3 displays,
+  // rows not in P3 already are converted to it in place
+  static void ConvertRows(bool p3Display, const SOURCE_SPACE& source,
+                          uint32_t width, uint32_t rowCount, uint8_t* rows,
+                          uint8_t* sRGBView);
+
+ private:
+  void Worker(void);
+
+  std::vector<std::thread> workers_;
+  std::mutex lock_;
+  std::condition_variable work_;      // workers: an image to prepare, or exit
+  std::condition_variable space_;     // workers: room on the queue
+  std::condition_variable prepared_;  // Next(): an image on the queue
+  std::deque<std::unique_ptr<PREPARED_IMAGE>> queue_;
+  uint32_t queueSize_;
+
+  // the current Start(); generation_ changes with each Start() / Cancel()
+  FileReader reader_;
+  std::atomic<uint32_t> generation_;
+  uint32_t count_, nextIndex_, taken_;
+  bool p3Display_;
+  bool exit_;
+};
+
+#endif  // __TEXTURE_PIPELINE_H__
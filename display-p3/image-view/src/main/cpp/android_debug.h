@@ -16,9 +16,27 @@
  */
 #ifndef __SAMPLE_ANDROID_DEBUG_H__
 #define __SAMPLE_ANDROID_DEBUG_H__
+#if !defined(__ANDROID__)
+// host builds (see host/CMakeLists.txt): only report problems, on stderr
+#include <cstdio>
+#include <cstdlib>
+
+#define LOGV(...)
+#define LOGD(...)
+#define LOGI(...)
+#define LOGW(...) (fprintf(stderr, __VA_ARGS__), fputc('\n', stderr))
+#define LOGE(...) (fprintf(stderr, __VA_ARGS__), fputc('\n', stderr))
+#define LOGF(...) (fprintf(stderr, __VA_ARGS__), fputc('\n', stderr))
+
+#define ASSERT(cond, ...)         \
+  if (!(cond)) {                  \
+    fprintf(stderr, __VA_ARGS__); \
+    fputc('\n', stderr);          \
+    abort();                      \
+  }
+#elif 1
 #include <android/log.h>
 
-#if 1
 #ifndef MODULE_NAME
 #define MODULE_NAME "OpenGL-Wide-Color"
 #endif
@@ -16,9 +16,19 @@
  */
 #include "simple_png.h"
 
+#include <zlib.h>
+
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
 
-#include "common.h"
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 union littleEndianUint32 {
   uint8_t bytes[4];
@@ -33,6 +43,9 @@ union littleEndianUint32 {
     v.bytes[0] = s[o + 3];     \
   } while (0)
 
+// length and type; the CRC follows the data
+#define PNG_CHUNK_HEADER_SIZE 8
+
 // Little endian chunk name
 #define PNG_CHUNCK(c1, c2, c3, c4) \
   (((c1) << 24) | ((c2) << 16) | ((c3) << 8) | (c4))
@@ -41,7 +54,8 @@ union littleEndianUint32 {
  * Parse PNG file header, refer to:
  *    https://www.w3.org/TR/PNG/#11Chunks
  */
-PNGHeader::PNGHeader(std::string& name, uint8_t* buf, uint64_t len)
+PNGHeader::PNGHeader(const std::string& name, const uint8_t* buf,
+                     uint64_t len)
     : name_(name),
       buf_(buf),
       length_(len),
@@ -64,7 +78,7 @@ PNGHeader::PNGHeader(std::string& name, uint8_t* buf, uint64_t len)
   bool has_sRGB = false;
   bool has_iCCP = false;
   LOGV("=== Parsing File: %s", name_.c_str());
-  while (offset_ < length_) {
+  while (offset_ + PNG_CHUNK_HEADER_SIZE + sizeof(uint32_t) <= length_) {
     littleEndianUint32 len, type;
 
     /*
@@ -123,9 +137,7 @@ PNGHeader::PNGHeader(std::string& name, uint8_t* buf, uint64_t len)
         break;
       }
       case PNG_CHUNCK('i', 'C', 'C', 'P'):
-        LOGI("====iCCP: %s, compression Method %d", &buf_[offset_],
-             buf_[offset_ +
-                  strlen(reinterpret_cast<const char*>(&buf_[offset_])) + 1]);
+        if (len.value <= length_ - offset_) ParseICCP(len.value);
         has_iCCP = true;
         offset_ += sizeof(uint32_t) + len.value;
         break;
@@ -165,15 +177,74 @@ PNGHeader::PNGHeader(std::string& name, uint8_t* buf, uint64_t len)
     UpdateNPM();
   }
 
-  /*
-   * shortcut: if SRGB / iCCP present, assume to be P3 iamge
-   */
-  if (has_sRGB || has_iCCP) {
-    hasChrm_ = false;  // When no cHRM present, assume to be P3 colorspace
+  // the sRGB chunk overrides cHRM and iCCP: exactly sRGB D65
+  if (has_sRGB) {
+    NPM_ = *GetTransformNPM(NPM_TYPE::SRGB_D65);
+  } else if (has_iCCP && !profile_) {
+    // a profile we can't parse: like no color information, assume P3
+    hasChrm_ = false;
+  }
+
+  // a profile we could parse says exactly what the image is
+  if (profile_ && !has_sRGB) {
+    NPM_ = *profile_->NPM();
+    gamma_ = profile_->Gamma();
+    for (int32_t idx = 0; idx < 4; idx++) {
+      // white is the sum of the primaries' XYZ (the columns of the NPM)
+      float xyz[3];
+      for (int32_t r = 0; r < 3; r++) {
+        xyz[r] = idx ? NPM_(r, idx - 1) : NPM_(r, 0) + NPM_(r, 1) + NPM_(r, 2);
+      }
+      float sum = xyz[0] + xyz[1] + xyz[2];
+      chrm_[idx].x = xyz[0] / sum;
+      chrm_[idx].y = xyz[1] / sum;
+    }
+    hasChrm_ = true;
   }
   valid_ = true;
 }
 
+/*
+ * ParseICCP()
+ *     iCCP: profile name, compression method (0: zlib), compressed profile
+ */
+#define ICC_PROFILE_MAX_SIZE (4 * 1024 * 1024)
+void PNGHeader::ParseICCP(uint32_t len) {
+  const uint8_t* data = &buf_[offset_];
+  const uint8_t* nameEnd =
+      static_cast<const uint8_t*>(memchr(data, 0, std::min(len, 80u)));
+  if (!nameEnd || nameEnd + 2 > data + len || nameEnd[1] != 0) {
+    LOGE("==== Invalid iCCP chunk in %s", name_.c_str());
+    return;
+  }
+
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit(&stream) != Z_OK) return;
+  stream.next_in = const_cast<uint8_t*>(nameEnd + 2);
+  stream.avail_in = static_cast<uInt>(data + len - (nameEnd + 2));
+  std::vector<uint8_t> profile(4096);
+  int ret = Z_OK;
+  while (ret == Z_OK) {
+    if (stream.total_out == profile.size()) {
+      if (profile.size() >= ICC_PROFILE_MAX_SIZE) break;
+      profile.resize(profile.size() * 2);
+    }
+    stream.next_out = &profile[stream.total_out];
+    stream.avail_out = static_cast<uInt>(profile.size() - stream.total_out);
+    ret = inflate(&stream, Z_NO_FLUSH);
+  }
+  inflateEnd(&stream);
+  if (ret != Z_STREAM_END) {
+    LOGE("==== Could not inflate the iCCP profile of %s", name_.c_str());
+    return;
+  }
+
+  profile_ = IccProfile::Get(profile.data(), stream.total_out);
+  LOGV("====iCCP: %s, %lu bytes, %s", data, stream.total_out,
+       profile_ ? "matrix/TRC" : "not supported");
+}
+
 float PNGHeader::GetGamma() const { return gamma_; }
 
 /*
@@ -242,3 +313,500 @@ const mathfu::mat3* PNGHeader::NPM(void) {
   ASSERT(hasChrm_, "File does not have NPM info");
   return &NPM_;
 }
+
+/*
+ * PNGDecoder
+ *     Checks the signature and IHDR, and finds the first IDAT chunk
+ */
+#define PNG_SIGNATURE_SIZE 8
+#define PNG_CHUNK_OVERHEAD 12  // length, type, CRC
+#define PNG_MAX_DIMENSION (1 << 16)
+#define BLOCK_HEADER sizeof(std::max_align_t)
+
+// PNG color types
+#define PNG_GRAY 0
+#define PNG_RGB 2
+#define PNG_GRAY_ALPHA 4
+#define PNG_RGBA 6
+
+PNGDecoder::PNGDecoder(const uint8_t* buf, uint64_t len)
+    : buf_(buf),
+      length_(len),
+      idatOffset_(0),
+      width_(0),
+      height_(0),
+      bitDepth_(0),
+      colorType_(0),
+      channels_(0),
+      supported_(false),
+      memory_(0),
+      peakMemory_(0) {
+  uint8_t sig[] = {137, 80, 78, 71, 13, 10, 26, 10};
+  if (!buf_ || length_ < PNG_SIGNATURE_SIZE + PNG_CHUNK_OVERHEAD + 13 ||
+      memcmp(buf_, sig, sizeof(sig))) {
+    return;
+  }
+
+  uint64_t offset = PNG_SIGNATURE_SIZE;
+  bool interlaced = true;
+  while (offset + PNG_CHUNK_OVERHEAD <= length_) {
+    littleEndianUint32 len, type;
+    READ_INT_SWAP(len, buf_, offset);
+    READ_INT_SWAP(type, buf_, offset + 4);
+    if (len.value > length_ - offset - PNG_CHUNK_OVERHEAD) return;
+
+    const uint8_t* data = buf_ + offset + 8;
+    if (type.value == PNG_CHUNCK('I', 'H', 'D', 'R') && len.value == 13) {
+      littleEndianUint32 val;
+      READ_INT_SWAP(val, data, 0);
+      width_ = val.value;
+      READ_INT_SWAP(val, data, 4);
+      height_ = val.value;
+      bitDepth_ = data[8];
+      colorType_ = data[9];
+      // compression and filter methods must be 0
+      interlaced = data[10] || data[11] || data[12];
+    } else if (type.value == PNG_CHUNCK('I', 'D', 'A', 'T')) {
+      idatOffset_ = offset;
+      break;
+    }
+    offset += PNG_CHUNK_OVERHEAD + len.value;
+  }
+
+  switch (colorType_) {
+    case PNG_GRAY:
+      channels_ = 1;
+      break;
+    case PNG_RGB:
+      channels_ = 3;
+      break;
+    case PNG_GRAY_ALPHA:
+      channels_ = 2;
+      break;
+    case PNG_RGBA:
+      channels_ = 4;
+      break;
+    default:
+      channels_ = 0;  // palette
+      break;
+  }
+  supported_ = idatOffset_ && channels_ && !interlaced &&
+               (bitDepth_ == 8 || bitDepth_ == 16) && width_ && height_ &&
+               width_ <= PNG_MAX_DIMENSION && height_ <= PNG_MAX_DIMENSION;
+}
+
+/*
+ * Alloc() / Free()
+ *     zlib's allocator, counting what it holds for PeakMemory()
+ */
+void* PNGDecoder::Alloc(void* opaque, unsigned items, unsigned size) {
+  PNGDecoder* decoder = static_cast<PNGDecoder*>(opaque);
+  size_t bytes = static_cast<size_t>(items) * size;
+  // the size goes in front, keeping the block aligned
+  size_t* block = static_cast<size_t*>(malloc(bytes + BLOCK_HEADER));
+  if (!block) return Z_NULL;
+  *block = bytes;
+  decoder->memory_ += bytes;
+  decoder->peakMemory_ = std::max(decoder->peakMemory_, decoder->memory_);
+  return reinterpret_cast<uint8_t*>(block) + BLOCK_HEADER;
+}
+
+void PNGDecoder::Free(void* opaque, void* ptr) {
+  PNGDecoder* decoder = static_cast<PNGDecoder*>(opaque);
+  size_t* block =
+      reinterpret_cast<size_t*>(static_cast<uint8_t*>(ptr) - BLOCK_HEADER);
+  decoder->memory_ -= *block;
+  free(block);
+}
+
+/*
+ * Paeth predictor: whichever of left, up and up-left is closest to
+ * left + up - upLeft, preferring them in that order on ties
+ */
+static inline uint8_t Paeth(int32_t a, int32_t b, int32_t c) {
+  int32_t pa = std::abs(b - c), pb = std::abs(a - c),
+          pc = std::abs(a + b - 2 * c);
+  if (pa <= pb && pa <= pc) return static_cast<uint8_t>(a);
+  if (pb <= pc) return static_cast<uint8_t>(b);
+  return static_cast<uint8_t>(c);
+}
+
+bool PNGDecoder::UnfilterRowScalar(uint8_t filter, uint32_t pixelBytes,
+                                   uint8_t* row, const uint8_t* prev,
+                                   uint32_t bytes) {
+  uint32_t idx = 0;
+  switch (filter) {
+    case 0:  // none
+      return true;
+    case 1:  // sub
+      for (idx = pixelBytes; idx < bytes; idx++) {
+        row[idx] += row[idx - pixelBytes];
+      }
+      return true;
+    case 2:  // up
+      for (; idx < bytes; idx++) row[idx] += prev[idx];
+      return true;
+    case 3:  // average
+      for (; idx < pixelBytes; idx++) row[idx] += prev[idx] >> 1;
+      for (; idx < bytes; idx++) {
+        row[idx] += (row[idx - pixelBytes] + prev[idx]) >> 1;
+      }
+      return true;
+    case 4:  // Paeth
+      for (; idx < pixelBytes; idx++) row[idx] += prev[idx];
+      for (; idx < bytes; idx++) {
+        row[idx] += Paeth(row[idx - pixelBytes], prev[idx],
+                          prev[idx - pixelBytes]);
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__SSE2__)
+/*
+ * SIMD unfiltering of 3 and 4 byte pixels (8 bit RGB and RGBA). Sub,
+ * average and Paeth depend on the pixel to the left, so they go one pixel
+ * (all its channels) at a time; up does 16 bytes at a time.
+ * 3 byte pixels are loaded and stored as 4 bytes, with the predictor of the
+ * 4th byte masked to 0 so it is stored back unchanged; only the last pixel
+ * of the row is copied as 3 bytes, so nothing past the row is touched.
+ */
+template <uint32_t BPP>
+static inline uint32_t LoadPixel(const uint8_t* p, bool last) {
+  uint32_t val = 0;
+  if (BPP == 3 && last) {
+    memcpy(&val, p, 3);
+  } else {
+    memcpy(&val, p, 4);
+  }
+  return val;
+}
+
+template <uint32_t BPP>
+static inline void StorePixel(uint8_t* p, uint32_t val, bool last) {
+  if (BPP == 3 && last) {
+    memcpy(p, &val, 3);
+  } else {
+    memcpy(p, &val, 4);
+  }
+}
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+typedef uint8x8_t PIXEL_VEC;
+#define PIXEL_TO_VEC(v) vreinterpret_u8_u32(vdup_n_u32(v))
+#define VEC_TO_PIXEL(v) vget_lane_u32(vreinterpret_u32_u8(v), 0)
+#define ADD_PIXEL(x, y) vadd_u8(x, y)
+#define MASK_PIXEL(v, mask) vand_u8(v, PIXEL_TO_VEC(mask))
+
+static void UnfilterUp(uint8_t* row, const uint8_t* prev, uint32_t bytes) {
+  uint32_t idx = 0;
+  for (; idx + 16 <= bytes; idx += 16) {
+    vst1q_u8(row + idx, vaddq_u8(vld1q_u8(row + idx), vld1q_u8(prev + idx)));
+  }
+  for (; idx < bytes; idx++) row[idx] += prev[idx];
+}
+
+// floor((a + b) / 2)
+static inline uint8x8_t Average(uint8x8_t a, uint8x8_t b) {
+  return vhadd_u8(a, b);
+}
+
+// the Paeth predictor of 4 channels, 16 bit: left, up, up-left
+static inline uint8x8_t Paeth(int16x4_t a, int16x4_t b, int16x4_t c) {
+  int16x4_t pa = vsub_s16(b, c), pb = vsub_s16(a, c);
+  int16x4_t pc = vabs_s16(vadd_s16(pa, pb));
+  pa = vabs_s16(pa);
+  pb = vabs_s16(pb);
+  int16x4_t smallest = vmin_s16(pc, vmin_s16(pa, pb));
+  int16x4_t nearest = vbsl_s16(vceq_s16(smallest, pa), a,
+                               vbsl_s16(vceq_s16(smallest, pb), b, c));
+  uint16x4_t n16 = vreinterpret_u16_s16(nearest);
+  return vmovn_u16(vcombine_u16(n16, n16));
+}
+
+static inline int16x4_t Widen(uint8x8_t v) {
+  return vget_low_s16(vreinterpretq_s16_u16(vmovl_u8(v)));
+}
+#else
+typedef __m128i PIXEL_VEC;
+#define PIXEL_TO_VEC(v) _mm_cvtsi32_si128(static_cast<int32_t>(v))
+#define VEC_TO_PIXEL(v) static_cast<uint32_t>(_mm_cvtsi128_si32(v))
+#define ADD_PIXEL(x, y) _mm_add_epi8(x, y)
+#define MASK_PIXEL(v, mask) _mm_and_si128(v, PIXEL_TO_VEC(mask))
+
+static void UnfilterUp(uint8_t* row, const uint8_t* prev, uint32_t bytes) {
+  uint32_t idx = 0;
+  for (; idx + 16 <= bytes; idx += 16) {
+    __m128i* p = reinterpret_cast<__m128i*>(row + idx);
+    _mm_storeu_si128(
+        p, _mm_add_epi8(_mm_loadu_si128(p),
+                        _mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(prev + idx))));
+  }
+  for (; idx < bytes; idx++) row[idx] += prev[idx];
+}
+
+// floor((a + b) / 2): avg_epu8 rounds up
+static inline __m128i Average(__m128i a, __m128i b) {
+  return _mm_sub_epi8(_mm_avg_epu8(a, b),
+                      _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+}
+
+// the Paeth predictor of 4 channels, 16 bit: left, up, up-left
+static inline __m128i Paeth(__m128i a, __m128i b, __m128i c) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i pa = _mm_sub_epi16(b, c), pb = _mm_sub_epi16(a, c);
+  __m128i pc = _mm_add_epi16(pa, pb);
+  pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+  pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+  pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+  __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+  __m128i isA = _mm_cmpeq_epi16(smallest, pa);
+  __m128i isB = _mm_cmpeq_epi16(smallest, pb);
+  __m128i nearest =
+      _mm_or_si128(_mm_and_si128(isB, b), _mm_andnot_si128(isB, c));
+  nearest =
+      _mm_or_si128(_mm_and_si128(isA, a), _mm_andnot_si128(isA, nearest));
+  return _mm_packus_epi16(nearest, nearest);
+}
+
+static inline __m128i Widen(__m128i v) {
+  return _mm_unpacklo_epi8(v, _mm_setzero_si128());
+}
+#endif
+
+// the bytes of a pixel's predictor that belong to it
+template <uint32_t BPP>
+static inline PIXEL_VEC Predictor(PIXEL_VEC v) {
+  return BPP == 4 ? v : MASK_PIXEL(v, 0x00ffffffu);
+}
+
+/*
+ * The raw pixel is read before the previous one is stored: reading 4 bytes
+ * right after a 4 byte store that overlaps them stalls store forwarding.
+ */
+template <uint32_t BPP>
+static void UnfilterSub(uint8_t* row, uint32_t bytes) {
+  PIXEL_VEC a = PIXEL_TO_VEC(0);
+  uint32_t x = LoadPixel<BPP>(row, BPP >= bytes);
+  for (uint32_t idx = 0; idx < bytes; idx += BPP) {
+    bool last = idx + 4 > bytes, nextLast = idx + BPP + 4 > bytes;
+    a = ADD_PIXEL(PIXEL_TO_VEC(x), Predictor<BPP>(a));
+    if (idx + BPP < bytes) x = LoadPixel<BPP>(row + idx + BPP, nextLast);
+    StorePixel<BPP>(row + idx, VEC_TO_PIXEL(a), last);
+  }
+}
+
+template <uint32_t BPP>
+static void UnfilterAverage(uint8_t* row, const uint8_t* prev,
+                            uint32_t bytes) {
+  PIXEL_VEC a = PIXEL_TO_VEC(0);
+  uint32_t x = LoadPixel<BPP>(row, BPP >= bytes);
+  for (uint32_t idx = 0; idx < bytes; idx += BPP) {
+    bool last = idx + 4 > bytes, nextLast = idx + BPP + 4 > bytes;
+    PIXEL_VEC b = PIXEL_TO_VEC(LoadPixel<BPP>(prev + idx, last));
+    a = ADD_PIXEL(PIXEL_TO_VEC(x), Predictor<BPP>(Average(a, b)));
+    if (idx + BPP < bytes) x = LoadPixel<BPP>(row + idx + BPP, nextLast);
+    StorePixel<BPP>(row + idx, VEC_TO_PIXEL(a), last);
+  }
+}
+
+template <uint32_t BPP>
+static void UnfilterPaeth(uint8_t* row, const uint8_t* prev, uint32_t bytes) {
+  PIXEL_VEC a = PIXEL_TO_VEC(0);
+  auto a16 = Widen(a), c16 = Widen(a);
+  uint32_t x = LoadPixel<BPP>(row, BPP >= bytes);
+  for (uint32_t idx = 0; idx < bytes; idx += BPP) {
+    bool last = idx + 4 > bytes, nextLast = idx + BPP + 4 > bytes;
+    auto b16 = Widen(PIXEL_TO_VEC(LoadPixel<BPP>(prev + idx, last)));
+    a = ADD_PIXEL(PIXEL_TO_VEC(x), Predictor<BPP>(Paeth(a16, b16, c16)));
+    if (idx + BPP < bytes) x = LoadPixel<BPP>(row + idx + BPP, nextLast);
+    StorePixel<BPP>(row + idx, VEC_TO_PIXEL(a), last);
+    a16 = Widen(a);
+    c16 = b16;
+  }
+}
+
+template <uint32_t BPP>
+static void UnfilterPixels(uint8_t filter, uint8_t* row, const uint8_t* prev,
+                           uint32_t bytes) {
+  if (filter == 1) {
+    UnfilterSub<BPP>(row, bytes);
+  } else if (filter == 3) {
+    UnfilterAverage<BPP>(row, prev, bytes);
+  } else {
+    UnfilterPaeth<BPP>(row, prev, bytes);
+  }
+}
+
+bool PNGDecoder::UnfilterRow(uint8_t filter, uint32_t pixelBytes,
+                             uint8_t* row, const uint8_t* prev,
+                             uint32_t bytes) {
+  if (filter == 2) {
+    UnfilterUp(row, prev, bytes);
+    return true;
+  }
+  if (filter == 1 || filter == 3 || filter == 4) {
+    if (pixelBytes == 4) {
+      UnfilterPixels<4>(filter, row, prev, bytes);
+      return true;
+    }
+    if (pixelBytes == 3) {
+      UnfilterPixels<3>(filter, row, prev, bytes);
+      return true;
+    }
+  }
+  return UnfilterRowScalar(filter, pixelBytes, row, prev, bytes);
+}
+#else
+bool PNGDecoder::UnfilterRow(uint8_t filter, uint32_t pixelBytes,
+                             uint8_t* row, const uint8_t* prev,
+                             uint32_t bytes) {
+  return UnfilterRowScalar(filter, pixelBytes, row, prev, bytes);
+}
+#endif
+
+/*
+ * ToRGBA()
+ *    One unfiltered row to RGBA8; 16 bit samples keep their high byte
+ */
+void PNGDecoder::ToRGBA(const uint8_t* row, uint8_t* rgba) const {
+  uint32_t step = bitDepth_ / 8;  // bytes per sample
+  uint32_t pixelStep = channels_ * step;
+  uint8_t* end = rgba + width_ * 4;
+  switch (colorType_) {
+    case PNG_GRAY:
+      for (; rgba < end; rgba += 4, row += pixelStep) {
+        rgba[0] = rgba[1] = rgba[2] = row[0];
+        rgba[3] = 255;
+      }
+      break;
+    case PNG_GRAY_ALPHA:
+      for (; rgba < end; rgba += 4, row += pixelStep) {
+        rgba[0] = rgba[1] = rgba[2] = row[0];
+        rgba[3] = row[step];
+      }
+      break;
+    case PNG_RGB:
+      for (; rgba < end; rgba += 4, row += pixelStep) {
+        rgba[0] = row[0];
+        rgba[1] = row[step];
+        rgba[2] = row[2 * step];
+        rgba[3] = 255;
+      }
+      break;
+    default:
+      if (step == 1) {
+        memcpy(rgba, row, width_ * 4);
+        break;
+      }
+      for (; rgba < end; rgba += 4, row += pixelStep) {
+        rgba[0] = row[0];
+        rgba[1] = row[2];
+        rgba[2] = row[4];
+        rgba[3] = row[6];
+      }
+      break;
+  }
+}
+
+bool PNGDecoder::Decode(const RowHandler& handler, bool simd) {
+  if (!supported_) {
+    LOGE("==== PNG format not supported by the streaming decoder");
+    return false;
+  }
+
+  // filter byte + the row; the previous row starts as zeros
+  uint32_t pixelBytes = channels_ * bitDepth_ / 8;
+  uint32_t rowBytes = width_ * pixelBytes;
+  std::vector<uint8_t> cur(rowBytes + 1), prev(rowBytes + 1, 0);
+  std::vector<uint8_t> rgba(width_ * 4);
+  memory_ = peakMemory_ = cur.size() + prev.size() + rgba.size();
+
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  stream.zalloc = Alloc;
+  stream.zfree = Free;
+  stream.opaque = this;
+  if (inflateInit(&stream) != Z_OK) return false;
+
+  uint32_t row = 0, filled = 0;
+  bool ok = true;
+  uint64_t offset = idatOffset_;
+  while (ok && row < height_ && offset + PNG_CHUNK_OVERHEAD <= length_) {
+    littleEndianUint32 len, type;
+    READ_INT_SWAP(len, buf_, offset);
+    READ_INT_SWAP(type, buf_, offset + 4);
+    if (len.value > length_ - offset - PNG_CHUNK_OVERHEAD) {
+      ok = false;
+      break;
+    }
+    if (type.value == PNG_CHUNCK('I', 'E', 'N', 'D')) break;
+    if (type.value != PNG_CHUNCK('I', 'D', 'A', 'T')) {
+      offset += PNG_CHUNK_OVERHEAD + len.value;
+      continue;
+    }
+
+    stream.next_in = const_cast<Bytef*>(buf_ + offset + 8);
+    stream.avail_in = len.value;
+    // zlib may hold output back after the chunk's input is used up, so
+    // keep going while rows come out
+    while (row < height_) {
+      stream.next_out = cur.data() + filled;
+      stream.avail_out = rowBytes + 1 - filled;
+      int ret = inflate(&stream, Z_NO_FLUSH);
+      if (ret == Z_BUF_ERROR) break;  // needs the next chunk
+      if (ret != Z_OK && ret != Z_STREAM_END) {
+        ok = false;
+        break;
+      }
+      filled = rowBytes + 1 - stream.avail_out;
+      if (filled == rowBytes + 1) {
+        uint8_t* data = cur.data() + 1;
+        ok = simd ? UnfilterRow(cur[0], pixelBytes, data, prev.data() + 1,
+                                rowBytes)
+                  : UnfilterRowScalar(cur[0], pixelBytes, data,
+                                      prev.data() + 1, rowBytes);
+        if (!ok) break;
+        ToRGBA(data, rgba.data());
+        ok = handler(row, rgba.data());
+        cur.swap(prev);
+        filled = 0;
+        row++;
+        if (!ok) break;
+      } else if (!stream.avail_in || ret == Z_STREAM_END) {
+        break;
+      }
+    }
+    offset += PNG_CHUNK_OVERHEAD + len.value;
+  }
+  inflateEnd(&stream);
+
+  if (ok && row < height_) {
+    LOGE("==== PNG decoding stopped at row %d of %d", row, height_);
+    return false;
+  }
+  return ok;
+}
+
+bool PNGDecoder::DecodeTransformed(IMAGE_FORMAT& dst,
+                                   const IMAGE_FORMAT& srcSpace,
+                                   const mathfu::mat3* clipNPM) {
+  if (!dst.buf_ || dst.width_ != width_ || dst.height_ != height_) {
+    LOGE("=====Error: Invalid Parameters to %s", __FUNCTION__);
+    return false;
+  }
+  // the cached tables are looked up once, not for every row
+  IMAGE_FORMAT src = srcSpace;
+  src.format_ = PIXEL_RGBA8;
+  HighPrecisionTransform transform;
+  if (!transform.Prepare(dst, src, clipNPM)) return false;
+
+  uint32_t dstRowBytes = width_ * (dst.format_ == PIXEL_RGBA16F ? 8 : 4);
+  return Decode([&](uint32_t row, uint8_t* rgba) {
+    return transform.Apply(static_cast<uint8_t*>(dst.buf_) + row * dstRowBytes,
+                           rgba, width_);
+  });
+}
@@ -21,8 +21,13 @@
 #include <mathfu/glsl_mappings.h>
 
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "ColorSpaceTransform.h"
+#include "IccProfile.h"
 #include "android_debug.h"
 
 #pragma pack(push, 1)
@@ -31,6 +36,8 @@ struct CIE_POINT {
   float x, y;
 };
 
+#pragma pack(pop)
+
 #define REF_WHITE_IDX 0
 #define REF_RED_IDX 1
 #define REF_GREEN_IDX 2
@@ -42,21 +49,30 @@ struct CIE_POINT {
  */
 #define DEFAULT_IMAGE_GAMMA (1.0f / 2.2f)
 
+/*
+ * PNGHeader
+ *     Color space of a PNG file: from an iCCP profile if it has a matrix /
+ *     TRC one, otherwise from cHRM / gAMA / sRGB
+ */
 class PNGHeader {
  public:
-  explicit PNGHeader(std::string& name, uint8_t* buf, uint64_t len);
+  explicit PNGHeader(const std::string& name, const uint8_t* buf,
+                     uint64_t len);
   ~PNGHeader() { buf_ = nullptr, offset_ = 0; }
 
   float GetGamma(void) const;
   bool IsP3Image(void) const;
   bool HasNPM(void) const;
   const mathfu::mat3* NPM(void);
+  // the parsed iCCP profile; nullptr if none, or not supported
+  const IccProfile* Profile(void) const { return profile_.get(); }
 
  private:
   void UpdateNPM(void);
+  void ParseICCP(uint32_t len);
 
   std::string name_;
-  uint8_t* buf_;
+  const uint8_t* buf_;
   uint64_t length_;
   uint64_t offset_;
   float gamma_;
@@ -67,9 +83,67 @@ class PNGHeader {
   CIE_POINT chrm_[4];
   bool hasChrm_;
   mathfu::mat3 NPM_;
+  std::shared_ptr<const IccProfile> profile_;
   bool valid_;
 };
 
-#pragma pack(pop)
+/*
+ * PNGDecoder
+ *     Streaming PNG decoder: inflates the IDAT chunks as it goes, unfilters
+ *     one row at a time and hands each row over as RGBA8, so the decoded
+ *     image is never held in memory; it uses two rows plus zlib's state.
+ *     Decodes non-interlaced gray, gray + alpha, RGB and RGBA images of 8 or
+ *     16 bits (reduced to 8, as stb_image does); IsSupported() is false for
+ *     other PNGs (palette, interlaced, less than 8 bits), which need a full
+ *     decoder.
+ */
+class PNGDecoder {
+ public:
+  // gets each row in order: RGBA8, Width() pixels, which it may modify;
+  // returns false to stop decoding
+  typedef std::function<bool(uint32_t row, uint8_t* rgba)> RowHandler;
+
+  PNGDecoder(const uint8_t* buf, uint64_t len);
+
+  bool IsSupported(void) const { return supported_; }
+  uint32_t Width(void) const { return width_; }
+  uint32_t Height(void) const { return height_; }
+
+  // simd = false unfilters with plain C (the reference for the SIMD code)
+  bool Decode(const RowHandler& handler, bool simd = true);
+
+  /*
+   * DecodeTransformed()
+   *     Decodes into dst (RGBA8 or RGBA16F, Width() x Height()), converting
+   *     each row from srcSpace's color space (gamma_ and npm_; its buf_ is
+   *     not used) as it arrives, with a HighPrecisionTransform prepared
+   *     once for the image.
+   */
+  bool DecodeTransformed(IMAGE_FORMAT& dst, const IMAGE_FORMAT& srcSpace,
+                         const mathfu::mat3* clipNPM = nullptr);
+
+  // most memory the last Decode() allocated: rows and zlib state
+  size_t PeakMemory(void) const { return peakMemory_; }
+
+  // undoes the filter (PNG filter type 0 -- 4) of bytes row bytes, with
+  // pixelBytes bytes per pixel, given the unfiltered previous row
+  static bool UnfilterRow(uint8_t filter, uint32_t pixelBytes, uint8_t* row,
+                          const uint8_t* prev, uint32_t bytes);
+  static bool UnfilterRowScalar(uint8_t filter, uint32_t pixelBytes,
+                                uint8_t* row, const uint8_t* prev,
+                                uint32_t bytes);
+
+ private:
+  static void* Alloc(void* opaque, unsigned items, unsigned size);
+  static void Free(void* opaque, void* ptr);
+  void ToRGBA(const uint8_t* row, uint8_t* rgba) const;
+
+  const uint8_t* buf_;
+  uint64_t length_;
+  uint64_t idatOffset_;  // first IDAT chunk
+  uint32_t width_, height_, bitDepth_, colorType_, channels_;
+  bool supported_;
+  size_t memory_, peakMemory_;
+};
 
 #endif  //  __SIMPLE_PNG_H__
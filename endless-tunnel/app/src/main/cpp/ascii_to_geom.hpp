@@ -16,6 +16,7 @@
 #ifndef endlesstunnel_ascii_to_geom_hpp
 #define endlesstunnel_ascii_to_geom_hpp
 
+#include "ascii_to_lines.hpp"
 #include "engine.hpp"
 
 /* Converts ASCII art into a Vbo/Ibo pair. Useful for retro-looking
@@ -39,4 +40,8 @@
  */
 SimpleGeom* AsciiArtToGeom(const char* art, float scale);
 
+/* Same as AsciiArtToGeom, but from art that was already parsed at build time
+ * (see data/ascii_geom.inl), so all it has to do is upload it. */
+SimpleGeom* PackedLineGeomToGeom(const PackedLineGeom& geom, float scale);
+
 #endif
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ascii_to_lines.hpp"
+
+bool AsciiArtToLines(const char *art, float scale, std::vector<float> *outVerts,
+                     std::vector<unsigned short> *outIndices, int *outErrorRow,
+                     int *outErrorCol) {
+  // figure out width and height
+  int rows = 1;
+  int curCols = 0, cols = 0;
+  int r, c;
+  const char *p;
+  for (p = art; *p; ++p) {
+    if (*p == '\n') {
+      rows++;
+      curCols = 0;
+    } else {
+      curCols++;
+      cols = curCols > cols ? curCols : cols;
+    }
+  }
+
+  // a rows x cols array that we will use as working space
+  std::vector<unsigned int> v(rows * cols, 0);
+#define V(r, c) v[(r) * cols + (c)]
+
+  // copy the input into the array
+  r = c = 0;
+  for (p = art; *p; ++p) {
+    if (*p == '\n') {
+      r++, c = 0;
+    } else {
+      V(r, c++) = static_cast<unsigned int>(*p);
+    }
+  }
+
+  // remove redundant line markers
+  for (r = 0; r < rows; r++) {
+    for (c = 0; c < cols; c++) {
+      if (c + 1 < cols && V(r, c) == '-' && V(r, c + 1) == '-') {
+        V(r, c) = ' ';
+      }
+      if (r + 1 < rows && V(r, c) == '|' && V(r + 1, c) == '|') {
+        V(r, c) = ' ';
+      }
+      if (r + 1 < rows && c + 1 < cols && V(r, c) == '`' &&
+          V(r + 1, c + 1) == '`') {
+        V(r, c) = ' ';
+      }
+      if (r + 1 < rows && c > 0 && V(r, c) == '/' && V(r + 1, c - 1) == '/') {
+        V(r, c) = ' ';
+      }
+    }
+  }
+
+  // work in units of half a character, so the result is the same as
+  // UnpackLineVerts() on the precompiled tables, to the bit
+  float halfScale = 0.5f * scale;
+  int left = (-cols / 2) * 2;
+  if (cols % 2 == 0) left += 1;
+  int top = (rows / 2) * 2;
+  if (rows % 2 == 0) top += 1;
+
+  const int VERTEX_BIT = 0x1000;
+  const int VERTEX_INDEX_MASK = 0x0fff;
+
+  // process vertices
+  int vertices = 0;
+  for (r = 0; r < rows; r++) {
+    for (c = 0; c < cols; c++) {
+      if (V(r, c) == '+') {
+        outVerts->push_back((left + c * 2) * halfScale);
+        outVerts->push_back((top - r * 2) * halfScale);
+        // mark which vertex this is
+        V(r, c) = static_cast<unsigned int>(VERTEX_BIT | vertices);
+        vertices++;
+      }
+    }
+  }
+
+  // process lines
+  int col_dir, row_dir;
+  int start_c, start_r, end_c, end_r;
+  for (r = 0; r < rows; r++) {
+    for (c = 0; c < cols; c++) {
+      int t = V(r, c);
+      if (t == '-') {
+        // horizontal line
+        col_dir = -1, row_dir = 0;
+      } else if (t == '|') {
+        // vertical line
+        col_dir = 0, row_dir = -1;
+      } else if (t == '`') {
+        // horizontal line, slanting down
+        col_dir = -1, row_dir = -1;
+      } else if (t == '/') {
+        // horizontal line, slanting down
+        col_dir = -1, row_dir = 1;
+      } else {
+        continue;
+      }
+
+      // look for the vertex that starts the line, then the one that ends it
+      start_c = end_c = c;
+      start_r = end_r = r;
+      while (!(V(start_r, start_c) & VERTEX_BIT)) {
+        start_c += col_dir;
+        start_r += row_dir;
+        if (start_c < 0 || start_r < 0 || start_c >= cols || start_r >= rows) {
+          goto error;
+        }
+      }
+      while (!(V(end_r, end_c) & VERTEX_BIT)) {
+        end_c -= col_dir;
+        end_r -= row_dir;
+        if (end_c < 0 || end_r < 0 || end_c >= cols || end_r >= rows) {
+          goto error;
+        }
+      }
+
+      outIndices->push_back(
+          static_cast<unsigned short>(V(start_r, start_c) & VERTEX_INDEX_MASK));
+      outIndices->push_back(
+          static_cast<unsigned short>(V(end_r, end_c) & VERTEX_INDEX_MASK));
+    }
+  }
+#undef V
+  return true;
+
+error:
+  if (outErrorRow) *outErrorRow = r;
+  if (outErrorCol) *outErrorCol = c;
+  return false;
+}
+
+void UnpackLineVerts(const PackedLineGeom &geom, float scale,
+                     std::vector<float> *outVerts) {
+  float halfScale = 0.5f * scale;
+  for (int i = 0; i < geom.vertCount * 2; i++) {
+    outVerts->push_back(geom.verts[i] * halfScale);
+  }
+}
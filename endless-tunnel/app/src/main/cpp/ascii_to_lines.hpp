@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef endlesstunnel_ascii_to_lines_hpp
+#define endlesstunnel_ascii_to_lines_hpp
+
+#include <vector>
+
+/* Parses ASCII art (see AsciiArtToGeom for the format) into line geometry,
+ * without touching GL: appends the x,y of each vertex to outVerts and a pair
+ * of vertex indices per line to outIndices (indices are relative to the
+ * first vertex this call appends). scale is the size of each character; the
+ * center of the drawing will be 0,0.
+ *
+ * Returns false if the art is malformed (a line with no vertex at one of its
+ * ends), in which case *outErrorRow and *outErrorCol (if not NULL) tell where.
+ */
+bool AsciiArtToLines(const char *art, float scale, std::vector<float> *outVerts,
+                     std::vector<unsigned short> *outIndices,
+                     int *outErrorRow = 0, int *outErrorCol = 0);
+
+/* Line geometry parsed from ASCII art ahead of time (by host/ascii_geom_gen,
+ * into data/ascii_geom.inl), so the game doesn't have to parse it at startup.
+ * Vertices are stored in units of half a character, which makes them exact
+ * small integers; multiply by 0.5 * scale to get what AsciiArtToLines()
+ * would return for that scale. */
+struct PackedLineGeom {
+  const signed char *verts;  // x,y of each vertex
+  int vertCount;
+  const unsigned short *indices;  // a pair of vertex indices per line
+  int indexCount;
+};
+
+// appends the vertices of packed geometry to outVerts, at the given scale
+void UnpackLineVerts(const PackedLineGeom &geom, float scale,
+                     std::vector<float> *outVerts);
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Generated by host/ascii_geom_gen from alphabet.inl and ascii_art.inl.
+// DO NOT EDIT: change the art and rebuild the ascii_geom host target.
+
+#ifndef _mygame_ascii_geom_inl
+#define _mygame_ascii_geom_inl
+
+#include "ascii_to_lines.hpp"
+
+static const signed char ALPHABET_GEOM_VERTS[] = {
+    -4, 11, 4, 11, -4, 7, 4, 7, 0, 3, -2, 1, 2, 1, -2, -3,
+    2, -3, 0, 11, 0, 7, 0, 9, -4, 5, 0, 5, 4, 5, 0, 1,
+    2, 1, -2, -3, -4, 5, 4, 5, -2, 1, 2, 1, -2, -3, 2, -3,
+    4, 7, -4, -1, -4, 11, 4, 11, -4, -1, 4, -1, 2, 11, 2, -1,
+    -4, 11, 4, 11, -4, 5, 4, 5, -4, -1, 4, -1, -4, 11, 4, 11,
+    -4, 5, 4, 5, -4, -1, 4, -1, -4, 11, 4, 11, -4, 5, 4, 5,
+    4, -1, -4, 11, 4, 11, -4, 5, 4, 5, -4, -1, 4, -1, -4, 11,
+    4, 11, -4, 5, 4, 5, -4, -1, 4, -1, -4, 11, 4, 11, 4, -1,
+    -4, 11, 4, 11, -4, 5, 4, 5, -4, -1, 4, -1, -4, 11, 4, 11,
+    -4, 5, 4, 5, -4, -1, 4, -1, -2, 11, 2, 11, -2, 7, 2, 7,
+    -2, 3, 2, 3, -2, -1, 2, -1, -4, 11, 4, 11, 0, 7, 4, 7,
+    0, 3, -2, 1, 2, 1, -2, -3, 2, -3, -4, 11, 4, 11, -4, 5,
+    4, 5, -4, -1, 4, -1, -4, 11, 4, 11, -4, 5, 4, 5, -4, -1,
+    4, -1, -4, 11, 4, 11, -4, -1, 4, -1, -4, 11, 0, 11, 4, 7,
+    -4, -1, 4, -1, -4, 11, 4, 11, -4, 5, 2, 5, -4, -1, 4, -1,
+    -4, 11, 4, 11, -4, 5, 2, 5, -4, -1, -4, 11, 4, 11, 0, 5,
+    4, 5, -4, -1, 4, -1, -4, 11, 4, 11, -4, 5, 4, 5, -4, -1,
+    4, -1, -4, 11, 0, 11, 4, 11, -4, -1, 0, -1, 4, -1, -4, 11,
+    0, 11, 4, 11, -4, 3, -4, -1, 0, -1, -4, 11, 2, 11, -4, 5,
+    -4, -1, 2, -1, -4, 11, -4, -1, 4, -1, -4, 11, 0, 11, 4, 11,
+    0, 3, -4, -1, 4, -1, -4, 11, 0, 11, 4, 7, -4, -1, 4, -1,
+    0, 11, -4, 7, 4, 7, -4, 3, 4, 3, 0, -1, -4, 11, 4, 11,
+    -4, 5, 4, 5, -4, -1, -4, 11, 4, 11, 0, 3, -4, -1, 4, -1,
+    -4, 11, 4, 11, -4, 5, 4, 5, -4, -1, 2, -1, -4, 11, 4, 11,
+    -4, 5, 4, 5, -4, -1, 4, -1, -4, 11, 0, 11, 4, 11, 0, -1,
+    -4, 11, 4, 11, -4, -1, 4, -1, -4, 11, 4, 11, -4, 3, 4, 3,
+    0, -1, -4, 11, 4, 11, 0, 5, -4, -1, 0, -1, 4, -1, -4, 11,
+    4, 11, 0, 7, 0, 3, -4, -1, 4, -1, -4, 11, 4, 11, -4, 5,
+    0, 5, 4, 5, 0, -1, -4, 11, 4, 11, -4, 3, -4, -1, 4, -1,
+    -4, 11, 0, 11, -4, -1, 0, -1, -4, 9, 4, 1, 0, 11, 4, 11,
+    0, -1, 4, -1, 0, 11, -4, 7, 4, 7, -4, -1, 4, -1, -4, 7,
+    4, 7, -4, 3, 4, 3, -4, -1, 4, -1, -4, 11, -4, 7, 4, 7,
+    -4, -1, 4, -1, -4, 7, 4, 7, -4, -1, 4, -1, 4, 11, -4, 7,
+    4, 7, -4, -1, 4, -1, -4, 7, 4, 7, -4, 3, 4, 3, -4, -1,
+    4, -1, -4, 11, 2, 11, -4, 5, 0, 5, -4, -1, -4, 7, 4, 7,
+    -4, -1, 4, -1, -4, -5, 4, -5, -4, 11, -4, 7, 4, 7, -4, -1,
+    4, -1, 0, 7, 0, -1, 0, 7, -4, -1, -4, -5, 0, -5, -2, 11,
+    2, 7, -2, 3, -2, -1, 2, -1, 0, 11, 0, -1, -4, 7, 0, 7,
+    4, 7, -4, -1, 0, -1, 4, -1, -4, 7, 4, 7, -4, -1, 4, -1,
+    -4, 7, 4, 7, -4, -1, 4, -1, -4, 7, 4, 7, -4, -1, 4, -1,
+    -4, -5, -4, 7, 4, 7, -4, -1, 4, -1, 4, -5, -4, 7, 4, 7,
+    -4, -1, -4, 7, 4, 7, -4, 3, 4, 3, -4, -1, 4, -1, -4, 11,
+    -4, 7, 2, 7, -4, -1, 4, -1, -4, 7, 4, 7, -4, -1, 4, -1,
+    -4, 7, 4, 7, -4, 3, 4, 3, 0, -1, -4, 7, 4, 7, 0, 5,
+    -4, 3, 4, 3, -4, -1, 0, -1, 4, -1, -4, 7, 4, 7, -4, -1,
+    4, -1, -4, 7, 4, 7, -4, -1, 4, -1, -4, -5, 4, -5, -4, 7,
+    4, 7, -4, -1, 4, -1};
+
+static const unsigned short ALPHABET_GEOM_INDICES[] = {
+    0, 1, 0, 2, 1, 3, 2, 4, 4, 3, 5, 6,
+    5, 7, 6, 8, 7, 8, 9, 10, 11, 13, 12, 13,
+    13, 14, 13, 15, 17, 16, 18, 19, 20, 21, 20, 22,
+    21, 23, 22, 23, 25, 24, 26, 27, 26, 28, 27, 29,
+    28, 29, 30, 31, 32, 33, 33, 35, 34, 35, 34, 36,
+    36, 37, 38, 39, 39, 41, 40, 41, 41, 43, 42, 43,
+    44, 46, 45, 47, 46, 47, 47, 48, 49, 50, 49, 51,
+    51, 52, 52, 54, 53, 54, 55, 56, 55, 57, 57, 58,
+    57, 59, 58, 60, 59, 60, 61, 62, 62, 63, 64, 65,
+    64, 66, 65, 67, 66, 67, 66, 68, 67, 69, 68, 69,
+    70, 71, 70, 72, 71, 73, 72, 73, 73, 75, 74, 75,
+    76, 77, 76, 78, 77, 79, 78, 79, 80, 81, 80, 82,
+    81, 83, 82, 83, 84, 85, 85, 87, 86, 87, 86, 88,
+    89, 90, 89, 91, 90, 92, 91, 92, 93, 94, 93, 95,
+    94, 96, 95, 96, 95, 97, 96, 98, 99, 100, 99, 101,
+    100, 102, 101, 102, 101, 103, 102, 104, 103, 104, 105, 106,
+    105, 107, 107, 108, 109, 110, 110, 111, 109, 112, 111, 113,
+    112, 113, 114, 115, 114, 116, 116, 117, 116, 118, 118, 119,
+    120, 121, 120, 122, 122, 123, 122, 124, 125, 126, 127, 128,
+    125, 129, 128, 130, 129, 130, 131, 133, 132, 134, 133, 134,
+    133, 135, 134, 136, 137, 138, 138, 139, 138, 141, 140, 141,
+    141, 142, 143, 144, 144, 145, 146, 147, 144, 148, 147, 148,
+    149, 151, 151, 150, 151, 152, 151, 153, 154, 155, 155, 156,
+    157, 158, 158, 159, 158, 160, 157, 161, 159, 162, 163, 164,
+    164, 165, 163, 166, 165, 167, 169, 168, 168, 170, 169, 171,
+    170, 172, 171, 173, 173, 172, 174, 175, 174, 176, 175, 177,
+    176, 177, 176, 178, 179, 180, 179, 182, 181, 183, 180, 183,
+    182, 183, 184, 185, 184, 186, 185, 187, 186, 187, 186, 188,
+    186, 189, 190, 191, 190, 192, 192, 193, 193, 195, 194, 195,
+    196, 197, 197, 198, 197, 199, 200, 202, 201, 203, 202, 203,
+    204, 206, 205, 207, 206, 208, 208, 207, 209, 212, 211, 213,
+    210, 214, 212, 213, 213, 214, 215, 217, 217, 216, 217, 218,
+    219, 218, 218, 220, 221, 223, 222, 225, 223, 224, 224, 225,
+    224, 226, 227, 228, 229, 228, 229, 230, 230, 231, 232, 233,
+    232, 234, 234, 235, 236, 237, 238, 239, 239, 241, 240, 241,
+    243, 242, 242, 244, 245, 246, 247, 248, 248, 250, 249, 250,
+    249, 251, 250, 252, 251, 252, 253, 254, 254, 255, 254, 256,
+    255, 257, 256, 257, 258, 259, 258, 260, 260, 261, 262, 264,
+    263, 264, 263, 265, 264, 266, 265, 266, 267, 268, 267, 269,
+    268, 270, 269, 270, 269, 271, 271, 272, 273, 274, 273, 275,
+    275, 276, 275, 277, 278, 279, 278, 280, 279, 281, 280, 281,
+    281, 283, 282, 283, 284, 285, 285, 286, 285, 287, 286, 288,
+    289, 290, 292, 293, 291, 294, 293, 294, 295, 297, 297, 296,
+    297, 298, 297, 299, 300, 301, 302, 303, 303, 304, 302, 305,
+    303, 306, 304, 307, 308, 309, 308, 310, 309, 311, 312, 313,
+    312, 314, 313, 315, 314, 315, 316, 317, 316, 318, 317, 319,
+    318, 319, 318, 320, 321, 322, 321, 323, 322, 324, 323, 324,
+    324, 325, 326, 327, 326, 328, 329, 330, 329, 331, 331, 332,
+    332, 334, 333, 334, 335, 336, 336, 337, 336, 338, 338, 339,
+    340, 342, 341, 343, 342, 343, 344, 346, 345, 347, 346, 348,
+    348, 347, 349, 352, 350, 353, 352, 354, 351, 355, 353, 356,
+    354, 355, 355, 356, 357, 360, 359, 358, 359, 358, 357, 360,
+    361, 363, 362, 364, 363, 364, 364, 366, 365, 366, 367, 368,
+    369, 368, 369, 370};
+
+static const PackedLineGeom ALPHABET_GEOM = {
+    ALPHABET_GEOM_VERTS, 371, ALPHABET_GEOM_INDICES, 640};
+
+// char code i has the lines from ALPHABET_GEOM_FIRST_INDEX[i] up to (but
+// not including) ALPHABET_GEOM_FIRST_INDEX[i + 1]
+static const int ALPHABET_GEOM_FIRST_INDEX[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18,
+    18, 18, 18, 18, 20, 20, 20, 20, 28, 30, 32, 40,
+    42, 50, 52, 62, 72, 80, 90, 102, 106, 120, 132, 148,
+    148, 148, 148, 148, 164, 164, 176, 190, 196, 206, 216, 224,
+    234, 244, 254, 264, 272, 276, 286, 294, 306, 316, 326, 338,
+    348, 354, 360, 368, 378, 388, 398, 406, 412, 414, 420, 424,
+    426, 426, 438, 448, 454, 464, 476, 484, 496, 504, 506, 512,
+    520, 522, 532, 538, 546, 556, 566, 570, 580, 588, 594, 602,
+    616, 624, 634, 640, 640, 640, 640, 640, 640};
+
+static const signed char ART_LIFE_GEOM_VERTS[] = {
+    -7, 11, -3, 11, 5, 11, 9, 11, -11, 7, 1, 7, 13, 7, 1, -5};
+
+static const unsigned short ART_LIFE_GEOM_INDICES[] = {
+    0, 1, 2, 3, 4, 0, 1, 5, 5, 2, 3, 6,
+    4, 7, 7, 6};
+
+static const PackedLineGeom ART_LIFE_GEOM = {
+    ART_LIFE_GEOM_VERTS, 8, ART_LIFE_GEOM_INDICES, 16};
+
+#endif
@@ -62,4 +62,41 @@
   "+ u_PointLightColor * att, vec4(0), v_FogFactor);\n"                        \
   "}";
 
+// Variant of OUR_VERTEX_SHADER_SOURCE that renders a batch of boxes in one
+// draw call. u_MVP is the shared view-projection matrix; each box reads its
+// translation/scale and tint from u_Instances, two vec4 per box.
+#define OBSTACLE_SHADER_MAX_INSTANCES 48
+#define OBSTACLE_SHADER_STR_(x) #x
+#define OBSTACLE_SHADER_STR(x) OBSTACLE_SHADER_STR_(x)
+#define OBSTACLE_VERTEX_SHADER_SOURCE                                      \
+  "uniform mat4 u_MVP;            \n"                                      \
+  "uniform vec4 u_PointLightPos;  \n"                                      \
+  "uniform mediump vec4 u_PointLightColor; \n"                             \
+  "uniform vec4 u_Instances[2 * "                                          \
+  OBSTACLE_SHADER_STR(OBSTACLE_SHADER_MAX_INSTANCES) "];  \n"              \
+  "attribute vec4 a_Position;     \n"                                      \
+  "attribute vec4 a_Color;        \n"                                      \
+  "attribute vec2 a_TexCoord;     \n"                                      \
+  "attribute float a_InstanceId;  \n"                                      \
+  "varying vec4 v_Color;          \n"                                      \
+  "varying vec4 v_Pos;            \n"                                      \
+  "varying float v_FogFactor;     \n"                                      \
+  "varying vec2 v_TexCoord;      \n"                                       \
+  "float FOG_START = 100.0;        \n"                                     \
+  "float FOG_END = 200.0;         \n"                                      \
+  "varying vec4 v_PointLightPos;  \n"                                      \
+  "void main()                    \n"                                      \
+  "{                              \n"                                      \
+  "   int i = int(a_InstanceId) * 2; \n"                                   \
+  "   vec4 xform = u_Instances[i];   \n"                                   \
+  "   vec4 pos = vec4(a_Position.xyz * xform.w + xform.xyz, 1.0); \n"      \
+  "   v_Color = a_Color * u_Instances[i + 1]; \n"                          \
+  "   gl_Position = u_MVP * pos;  \n"                                      \
+  "   v_Pos = gl_Position;        \n"                                      \
+  "   v_PointLightPos = u_MVP * u_PointLightPos; \n"                       \
+  "   v_TexCoord = a_TexCoord;    \n"                                      \
+  "   v_FogFactor = clamp((v_Pos.z - FOG_START) / (FOG_END - FOG_START), " \
+  "0.0, 1.0); \n"                                                          \
+  "}                              \n";
+
 #endif
@@ -54,6 +54,17 @@
 // maximum delta T between two frames
 #define MAX_DELTA_T 0.05f
 
+// the game simulation always advances in steps of this many seconds,
+// regardless of the frame rate, so that a game can be replayed exactly
+#define SIM_TIMESTEP (1.0f / 120.0f)
+
+// set to 1 to record the player's input to a trace file (next to the save
+// file) that can be replayed on the host with sim_bench
+#define SIM_RECORD_TRACE 0
+
+// name of the input trace file
+#define SIM_TRACE_FILE_NAME "tunnel.trace"
+
 // player's speed
 #define PLAYER_SPEED 80.0f
 
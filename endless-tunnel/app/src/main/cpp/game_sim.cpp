@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "game_sim.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "util.hpp"
+
+// trace file header: magic number and version
+static const char TRACE_MAGIC[4] = {'E', 'T', 'T', 'R'};
+static const int32_t TRACE_VERSION = 1;
+
+static float GetSectionCenterY(int i) {
+  return (float)i * TUNNEL_SECTION_LENGTH;
+}
+
+static float GetSectionEndY(int i) {
+  return GetSectionCenterY(i) + 0.5f * TUNNEL_SECTION_LENGTH;
+}
+
+// FNV-1a, used to fingerprint the game state
+static uint32_t HashBytes(uint32_t h, const void *data, size_t len) {
+  const unsigned char *p = (const unsigned char *)data;
+  for (size_t i = 0; i < len; i++) {
+    h = (h ^ p[i]) * 16777619u;
+  }
+  return h;
+}
+
+template <typename T>
+static uint32_t HashValue(uint32_t h, T value) {
+  return HashBytes(h, &value, sizeof(value));
+}
+
+GameSim::GameSim() { Reset(1); }
+
+void GameSim::Reset(uint32_t seed) {
+  mPlayerPos = glm::vec3(0.0f, 0.0f, 0.0f);
+  mPlayerSpeed = 0.0f;
+  mRollAngle = 0.0f;
+  mLives = PLAYER_LIVES;
+  mDifficulty = 0;
+  mFirstSection = 0;
+  mObstacles.Clear();
+  mObstacleGen.SetSeed(seed);
+  mObstacleGen.SetDifficulty(0);
+  mFilteredSteerX = mFilteredSteerZ = 0.0f;
+  mBonusInARow = 0;
+  mLastCrashSection = -1;
+  mLastAmbientBeepEmitted = 0;
+  SetScore(0);
+}
+
+void GameSim::SetLevel(int difficulty) {
+  mDifficulty = difficulty;
+  SetScore(SCORE_PER_LEVEL * mDifficulty);
+  mObstacleGen.SetDifficulty(mDifficulty);
+}
+
+unsigned GameSim::Simulate(float deltaT, const SimInput &input) {
+  unsigned events = 0;
+  float previousY = mPlayerPos.y;
+
+  // update speed
+  float targetSpeed = PLAYER_SPEED + PLAYER_SPEED_INC_PER_LEVEL * mDifficulty;
+  float accel = mPlayerSpeed >= 0.0f ? PLAYER_ACCELERATION_POSITIVE_SPEED
+                                     : PLAYER_ACCELERATION_NEGATIVE_SPEED;
+  if (mLives <= 0) {
+    targetSpeed = 0.0f;
+  }
+  mPlayerSpeed = Approach(mPlayerSpeed, targetSpeed, deltaT * accel);
+
+  // apply noise filter on steering
+  mFilteredSteerX =
+      (mFilteredSteerX * (NOISE_FILTER_SAMPLES - 1) + input.steerX) /
+      NOISE_FILTER_SAMPLES;
+  mFilteredSteerZ =
+      (mFilteredSteerZ * (NOISE_FILTER_SAMPLES - 1) + input.steerZ) /
+      NOISE_FILTER_SAMPLES;
+
+  // move player
+  if (mLives > 0) {
+    float steerX = mFilteredSteerX, steerZ = mFilteredSteerZ;
+    if (input.steering == SimInput::STEERING_TOUCH) {
+      // touch steering
+      mPlayerPos.x =
+          Approach(mPlayerPos.x, steerX, PLAYER_MAX_LAT_SPEED * deltaT);
+      mPlayerPos.z =
+          Approach(mPlayerPos.z, steerZ, PLAYER_MAX_LAT_SPEED * deltaT);
+    } else if (input.steering == SimInput::STEERING_JOY) {
+      // joystick steering
+      mPlayerPos.x += deltaT * steerX;
+      mPlayerPos.z += deltaT * steerZ;
+    }
+  }
+  mPlayerPos.y += deltaT * mPlayerSpeed;
+
+  // make sure player didn't leave tunnel
+  mPlayerPos.x = Clamp(mPlayerPos.x, PLAYER_MIN_X, PLAYER_MAX_X);
+  mPlayerPos.z = Clamp(mPlayerPos.z, PLAYER_MIN_Z, PLAYER_MAX_Z);
+
+  // shift sections if needed
+  ShiftIfNeeded();
+
+  // generate more obstacles!
+  GenObstacles();
+
+  // detect collisions
+  events |= DetectCollisions(previousY);
+
+  // update ship's roll speed according to level
+  static const float roll_speeds[] = ROLL_SPEEDS;
+  int count = sizeof(roll_speeds) / sizeof(float);
+  float speed = roll_speeds[mDifficulty % count];
+  mRollAngle += deltaT * speed;
+  while (mRollAngle < 0) {
+    mRollAngle += 2 * M_PI;
+  }
+  while (mRollAngle > 2 * M_PI) {
+    mRollAngle -= 2 * M_PI;
+  }
+
+  // time for the ambient sound?
+  int soundPoint = (int)floor(mPlayerPos.y / (TUNNEL_SECTION_LENGTH / 3));
+  if (soundPoint % 3 != 0 && soundPoint > mLastAmbientBeepEmitted) {
+    mLastAmbientBeepEmitted = soundPoint;
+    events |= soundPoint % 2 ? EVENT_AMBIENT_0 : EVENT_AMBIENT_1;
+  }
+
+  return events;
+}
+
+void GameSim::GenObstacles() {
+  Obstacle o;
+  while (!mObstacles.IsFull()) {
+    // generate a new obstacle
+    int section = mFirstSection + mObstacles.GetCount();
+    if (section < OBS_START_SECTION) {
+      // generate an empty obstacle
+      o.Reset();
+      o.style = Obstacle::STYLE_NULL;
+    } else {
+      // generate a normal obstacle
+      mObstacleGen.Generate(&o);
+    }
+    mObstacles.PushBack(o);
+  }
+}
+
+void GameSim::ShiftIfNeeded() {
+  // is it time to discard a section and shift forward?
+  while (mPlayerPos.y > GetSectionEndY(mFirstSection) + SHIFT_THRESH) {
+    // shift to the next turnnel section
+    mFirstSection++;
+
+    // discard obstacle corresponding to the deleted section (discarding the
+    // first object is easy because it's a circular buffer!)
+    mObstacles.PopFront();
+  }
+}
+
+unsigned GameSim::DetectCollisions(float previousY) {
+  float obsCenter = GetSectionCenterY(mFirstSection);
+  float obsMin = obsCenter - OBS_BOX_SIZE;
+  float curY = mPlayerPos.y;
+
+  if (mObstacles.GetCount() == 0 || !(previousY < obsMin && curY >= obsMin)) {
+    // no collision
+    return 0;
+  }
+
+  int hit = mObstacles.TestHit(0, mPlayerPos.x, mPlayerPos.z);
+  if (hit == ObstacleRing::HIT_BOX) {
+    // crashed against obstacle
+    mLives--;
+    mPlayerPos.y = obsMin - PLAYER_RECEDE_AFTER_COLLISION;
+    mPlayerSpeed = PLAYER_SPEED_AFTER_COLLISION;
+    mLastCrashSection = mFirstSection;
+    return mLives > 0 ? EVENT_CRASH : EVENT_CRASH | EVENT_GAME_OVER;
+
+  } else if (hit == ObstacleRing::HIT_BONUS) {
+    unsigned events = EVENT_BONUS;
+    mObstacles.DeleteBonus(0);
+    AddScore(BONUS_POINTS);
+    mBonusInARow++;
+
+    if (mBonusInARow >= 10) {
+      mBonusInARow = 0;
+    }
+
+    // update difficulty level, if applicable
+    int score = GetScore();
+    if (mDifficulty < score / SCORE_PER_LEVEL) {
+      mDifficulty = score / SCORE_PER_LEVEL;
+      mObstacleGen.SetDifficulty(mDifficulty);
+      events |= EVENT_LEVEL_UP;
+    }
+    return events;
+
+  } else if (mObstacles.HasBonus(0)) {
+    // player missed bonus!
+    mBonusInARow = 0;
+  }
+  return 0;
+}
+
+uint32_t GameSim::GetStateHash() const {
+  uint32_t h = 2166136261u;
+  h = HashValue(h, mPlayerPos.x);
+  h = HashValue(h, mPlayerPos.y);
+  h = HashValue(h, mPlayerPos.z);
+  h = HashValue(h, mPlayerSpeed);
+  h = HashValue(h, mRollAngle);
+  h = HashValue(h, mLives);
+  h = HashValue(h, mEncryptedScore);
+  h = HashValue(h, mDifficulty);
+  h = HashValue(h, mFirstSection);
+  h = HashValue(h, mFilteredSteerX);
+  h = HashValue(h, mFilteredSteerZ);
+  h = HashValue(h, mBonusInARow);
+  h = HashValue(h, mObstacleGen.GetRngState());
+  for (int i = 0; i < mObstacles.GetCount(); i++) {
+    h = HashValue(h, mObstacles.GetMask(i));
+    h = HashValue(h, mObstacles.GetStyle(i));
+    h = HashValue(h, mObstacles.HasBonus(i) ? mObstacles.GetBonusRow(i) *
+                                                      OBS_GRID_SIZE +
+                                                  mObstacles.GetBonusCol(i)
+                                            : -1);
+  }
+  return h;
+}
+
+bool SimTrace::Save(const char *fileName) const {
+  FILE *f = fopen(fileName, "wb");
+  if (!f) {
+    return false;
+  }
+  int32_t header[3] = {TRACE_VERSION, (int32_t)startLevel,
+                       (int32_t)inputs.size()};
+  bool ok = 1 == fwrite(TRACE_MAGIC, sizeof(TRACE_MAGIC), 1, f) &&
+            1 == fwrite(&seed, sizeof(seed), 1, f) &&
+            1 == fwrite(header, sizeof(header), 1, f);
+  for (size_t i = 0; ok && i < inputs.size(); i++) {
+    int32_t steering = inputs[i].steering;
+    float steer[2] = {inputs[i].steerX, inputs[i].steerZ};
+    ok = 1 == fwrite(&steering, sizeof(steering), 1, f) &&
+         1 == fwrite(steer, sizeof(steer), 1, f);
+  }
+  return 0 == fclose(f) && ok;
+}
+
+bool SimTrace::Load(const char *fileName) {
+  FILE *f = fopen(fileName, "rb");
+  if (!f) {
+    return false;
+  }
+  char magic[4];
+  int32_t header[3];
+  bool ok = 1 == fread(magic, sizeof(magic), 1, f) &&
+            0 == memcmp(magic, TRACE_MAGIC, sizeof(magic)) &&
+            1 == fread(&seed, sizeof(seed), 1, f) &&
+            1 == fread(header, sizeof(header), 1, f) &&
+            header[0] == TRACE_VERSION && header[2] >= 0;
+  if (ok) {
+    startLevel = header[1];
+    inputs.resize(header[2]);
+  }
+  for (size_t i = 0; ok && i < inputs.size(); i++) {
+    int32_t steering;
+    float steer[2];
+    ok = 1 == fread(&steering, sizeof(steering), 1, f) &&
+         1 == fread(steer, sizeof(steer), 1, f);
+    inputs[i].steering = steering;
+    inputs[i].steerX = steer[0];
+    inputs[i].steerZ = steer[1];
+  }
+  fclose(f);
+  if (!ok) {
+    inputs.clear();
+  }
+  return ok;
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef endlesstunnel_game_sim_hpp
+#define endlesstunnel_game_sim_hpp
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "game_consts.hpp"
+#include "glm/glm.hpp"
+#include "obstacle.hpp"
+#include "obstacle_generator.hpp"
+#include "obstacle_ring.hpp"
+
+// The player's input for one simulation step.
+struct SimInput {
+  static const int STEERING_NONE = 0, STEERING_TOUCH = 1, STEERING_JOY = 2;
+
+  int steering;  // is player steering? If so, how?
+  float steerX,
+      steerZ;  // target x,z of ship (when using touch control) or
+               // velocity vector (when using joystick)
+
+  SimInput() {
+    steering = STEERING_NONE;
+    steerX = steerZ = 0.0f;
+  }
+};
+
+// A recorded game: the seed it started with, its starting level and the
+// input of each simulation step.
+struct SimTrace {
+  uint32_t seed;
+  int startLevel;
+  std::vector<SimInput> inputs;
+
+  SimTrace() {
+    seed = 1;
+    startLevel = 0;
+  }
+
+  bool Save(const char *fileName) const;
+  bool Load(const char *fileName);
+};
+
+/* The game simulation: the player flying down the tunnel, obstacle generation,
+ * collisions, score and difficulty. It does no rendering, sound or timing of
+ * its own -- the caller advances it in fixed steps and reacts to the events
+ * each step returns -- so, given the same seed and the same input, it always
+ * plays out the same game, on the device or headless on the host.
+ */
+class GameSim {
+ public:
+  // events that may happen during a step (bit flags)
+  static const unsigned EVENT_CRASH = 1;       // player lost a life
+  static const unsigned EVENT_GAME_OVER = 2;   // player lost the last life
+  static const unsigned EVENT_BONUS = 4;       // player picked up a bonus
+  static const unsigned EVENT_LEVEL_UP = 8;    // difficulty went up
+  static const unsigned EVENT_AMBIENT_0 = 16;  // time for an ambient beep
+  static const unsigned EVENT_AMBIENT_1 = 32;  // time for the other beep
+
+  GameSim();
+
+  // starts a new game
+  void Reset(uint32_t seed);
+
+  // jumps to the given level, as when resuming from a checkpoint
+  void SetLevel(int difficulty);
+
+  // advances the game by deltaT seconds; returns the EVENT_* that happened
+  unsigned Simulate(float deltaT, const SimInput &input);
+
+  const glm::vec3 &GetPlayerPos() const { return mPlayerPos; }
+  float GetPlayerSpeed() const { return mPlayerSpeed; }
+  float GetRollAngle() const { return mRollAngle; }
+  int GetLives() const { return mLives; }
+  int GetDifficulty() const { return mDifficulty; }
+  int GetBonusInARow() const { return mBonusInARow; }
+  int GetFirstSection() const { return mFirstSection; }
+  const ObstacleRing &GetObstacles() const { return mObstacles; }
+
+  // get current score
+  int GetScore() const { return (int)(mEncryptedScore ^ 0x600673); }
+
+  // a hash of the whole game state, to compare two runs
+  uint32_t GetStateHash() const;
+
+ private:
+  // player's position
+  glm::vec3 mPlayerPos;
+
+  // current speed
+  float mPlayerSpeed;
+
+  // current roll angle, in degrees, counterclockwise from original
+  float mRollAngle;
+
+  // lives left
+  int mLives;
+
+  // player's score. As a trivial form of protection (just to give crackers a
+  // hard time), we *actually* store the score encrypted in mEncryptedScore, but
+  // have a fake variable mFakeScore that stores a copy of it. This serves as a
+  // honeypot to an attacker who's trying to crack the game using a memory
+  // editor.
+  unsigned mFakeScore;
+  unsigned mEncryptedScore;
+
+  // current difficulty level
+  int mDifficulty;
+
+  // what is the first tunnel section that is alive
+  int mFirstSection;
+
+  // circular buffer of obstacles. There is exactly one obstacle for each
+  // tunnel section:
+  // obstacle 0 is at section mFirstSection
+  // obstacle 1 is at section mFirstSection + 1
+  // and so on and so forth.
+  ObstacleRing mObstacles;
+
+  // obstacle generator
+  ObstacleGenerator mObstacleGen;
+
+  // moving average filter for input (on steerX and steerZ). It runs once per
+  // step, so the number of samples is tuned to SIM_TIMESTEP.
+  static const int NOISE_FILTER_SAMPLES = 10;
+  float mFilteredSteerX, mFilteredSteerZ;
+
+  // how many bonuses were collected without missing one?
+  int mBonusInARow;
+
+  // what was the section number of the last obstacle with which the player
+  // crashed?
+  int mLastCrashSection;
+
+  // last subsection were an ambient sound was emitted
+  int mLastAmbientBeepEmitted;
+
+  // set current score
+  void SetScore(int s) {
+    mFakeScore = (unsigned)s;
+    mEncryptedScore = mFakeScore ^ 0x600673;
+  }
+
+  // add to current score
+  void AddScore(int s) { SetScore(GetScore() + s); }
+
+  // generate new obstacles as needed
+  void GenObstacles();
+
+  // Shift tunnel sections if needed (this means discarding the ones the
+  // player has already past and generating the obstacles for the new ones
+  // that came into view)
+  void ShiftIfNeeded();
+
+  // detect if the player hit obstacles or got the bonus
+  unsigned DetectCollisions(float previousY);
+};
+
+#endif
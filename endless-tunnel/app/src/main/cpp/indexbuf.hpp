@@ -21,7 +21,7 @@
 /* Represents an index buffer (IBO). */
 class IndexBuf {
  public:
-  IndexBuf(GLushort *data, int dataSizeBytes);
+  IndexBuf(const GLushort *data, int dataSizeBytes);
   ~IndexBuf();
 
   void BindBuffer();
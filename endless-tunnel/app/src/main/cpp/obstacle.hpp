@@ -16,48 +16,100 @@
 #ifndef endlesstunnel_obstacle_hpp
 #define endlesstunnel_obstacle_hpp
 
-#include "engine.hpp"
+#include <stdint.h>
+
 #include "game_consts.hpp"
+#include "glm/glm.hpp"
 #include "util.hpp"
 
 // An obstacle consists of a grid of OBS_GRID_SIZE x OBS_GRID_SIZE cells; each
 // of them may or may not contain a box. One of the cells may be the bonus cell,
 // which gives the player a bonus when hit.
 //
+// The occupancy of the grid is kept as a bit mask with one bit per cell (bit
+// row * OBS_GRID_SIZE + col), so rows, columns and neighborhoods can be tested
+// with a couple of bit operations instead of walking the grid.
+//
 // The obstacle grid lies on the XZ plane.
 class Obstacle {
  public:
-  bool grid[OBS_GRID_SIZE][OBS_GRID_SIZE];  // indexed as [col][row]
-  int style;  // obstacle style (currently, this specifies its color).
+  uint32_t mask;  // cells that contain a box, see CellBit()
+  int style;      // obstacle style (currently, this specifies its color).
   int bonusRow, bonusCol;
   const static int STYLE_NULL = 0;  // a null obstacle (not displayed)
 
-  glm::vec3 GetBoxCenter(int gridCol, int gridRow, float posY) {
+  // all bits of the grid, one row, and one column
+  static const uint32_t ALL_BITS =
+      (uint32_t)((1ull << (OBS_GRID_SIZE * OBS_GRID_SIZE)) - 1);
+  static const uint32_t ROW0_BITS = (1u << OBS_GRID_SIZE) - 1;
+  static const uint32_t COL0_BITS = ALL_BITS / ROW0_BITS;
+
+  static uint32_t CellBit(int gridCol, int gridRow) {
+    return 1u << (gridRow * OBS_GRID_SIZE + gridCol);
+  }
+  static uint32_t RowBits(int gridRow) {
+    return ROW0_BITS << (gridRow * OBS_GRID_SIZE);
+  }
+  static uint32_t ColBits(int gridCol) { return COL0_BITS << gridCol; }
+
+  // returns the given cells plus all cells adjacent to them (including
+  // diagonals)
+  static uint32_t Dilate(uint32_t bits) {
+    const uint32_t lastCol = ColBits(OBS_GRID_SIZE - 1);
+    uint32_t h = bits | ((bits << 1) & ~COL0_BITS & ALL_BITS) |
+                 ((bits >> 1) & ~lastCol);
+    return (h | (h << OBS_GRID_SIZE) | (h >> OBS_GRID_SIZE)) & ALL_BITS;
+  }
+
+  bool HasBox(int gridCol, int gridRow) const {
+    return 0 != (mask & CellBit(gridCol, gridRow));
+  }
+
+  void SetBox(int gridCol, int gridRow, bool hasBox) {
+    if (hasBox) {
+      mask |= CellBit(gridCol, gridRow);
+    } else {
+      mask &= ~CellBit(gridCol, gridRow);
+    }
+  }
+
+  static glm::vec3 GetBoxCenter(int gridCol, int gridRow, float posY) {
     return glm::vec3(-TUNNEL_HALF_W + (gridCol + 0.5f) * OBS_CELL_SIZE, posY,
                      -TUNNEL_HALF_H + (gridRow + 0.5f) * OBS_CELL_SIZE);
   }
 
-  glm::vec3 GetBoxSize(int gridCol, int gridRow) {
+  static glm::vec3 GetBoxSize(int gridCol, int gridRow) {
     return glm::vec3(OBS_BOX_SIZE, OBS_BOX_SIZE, OBS_BOX_SIZE);
   }
 
-  int GetRowAt(float z) {
+  static int GetRowAt(float z) {
     return Clamp((int)floor((z + TUNNEL_HALF_H) / OBS_CELL_SIZE), 0,
                  OBS_GRID_SIZE - 1);
   }
 
-  int GetColAt(float x) {
+  static int GetColAt(float x) {
     return Clamp((int)floor((x + TUNNEL_HALF_W) / OBS_CELL_SIZE), 0,
                  OBS_GRID_SIZE - 1);
   }
 
+  // cells touched by a player at (x, z) when displaced by up to
+  // CLOSE_CALL_CALC_DELTA on each axis
+  static uint32_t GetNearBits(float x, float z) {
+    uint32_t cols = 0, rows = 0;
+    for (int i = -1; i <= 1; i++) {
+      cols |= ColBits(GetColAt(x + i * CLOSE_CALL_CALC_DELTA));
+      rows |= RowBits(GetRowAt(z + i * CLOSE_CALL_CALC_DELTA));
+    }
+    return cols & rows;
+  }
+
   float GetMinY(float posY) { return posY - OBS_BOX_SIZE * 0.5f; }
   float GetMaxY(float posY) { return posY + OBS_BOX_SIZE * 0.5f; }
 
   void Reset() {
     style = STYLE_NULL;
     bonusRow = bonusCol = -1;
-    memset(grid, 0, sizeof(grid));
+    mask = 0;
   }
 
   void SetBonus(int col, int row) {
@@ -65,13 +117,13 @@ class Obstacle {
     bonusRow = row;
   }
 
-  void PutRandomBonus();
+  void PutRandomBonus(Rng *rng);
 
   void DeleteBonus() { bonusCol = bonusRow = -1; }
 
-  bool HasBonus() {
+  bool HasBonus() const {
     return bonusRow >= 0 && bonusRow < OBS_GRID_SIZE && bonusCol >= 0 &&
-           bonusCol < OBS_GRID_SIZE && !grid[bonusCol][bonusRow];
+           bonusCol < OBS_GRID_SIZE && !HasBox(bonusCol, bonusRow);
   }
 };
 
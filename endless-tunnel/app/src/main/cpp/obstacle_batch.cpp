@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "obstacle_batch.hpp"
+
+#include <cstring>
+
+// obstacle colors
+static const float OBS_COLORS[] = {0.0f, 0.0f, 0.0f,  // style 0 (not used)
+                                   0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+                                   0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f,
+                                   1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f};
+
+void GetObstacleColor(int style, float *r, float *g, float *b) {
+  style = Clamp(style, 1, 6);
+  *r = OBS_COLORS[style * 3];
+  *g = OBS_COLORS[style * 3 + 1];
+  *b = OBS_COLORS[style * 3 + 2];
+}
+
+int BuildObstacleInstances(const ObstacleRing &ring, int firstSection,
+                           BoxInstance *out, int maxCount) {
+  int n = 0;
+  for (int i = 0; i < ring.GetCount(); i++) {
+    int style = ring.GetStyle(i);
+    if (style == Obstacle::STYLE_NULL) {
+      continue;
+    }
+
+    BoxInstance proto;
+    proto.y = (float)(firstSection + i) * TUNNEL_SECTION_LENGTH;
+    proto.scale = OBS_BOX_SIZE;
+    GetObstacleColor(style, &proto.r, &proto.g, &proto.b);
+    proto.a = 1.0f;
+
+    for (uint32_t bits = ring.GetMask(i); bits && n < maxCount;
+         bits &= bits - 1) {
+      int cell = __builtin_ctz(bits);
+      glm::vec3 center = Obstacle::GetBoxCenter(
+          cell % OBS_GRID_SIZE, cell / OBS_GRID_SIZE, proto.y);
+      BoxInstance *inst = &out[n++];
+      *inst = proto;
+      inst->x = center.x;
+      inst->z = center.z;
+    }
+  }
+  return n;
+}
+
+void ReplicateGeom(const float *geom, int vertCount, int strideFloats,
+                   int copies, float *out) {
+  for (int c = 0; c < copies; c++) {
+    const float *v = geom;
+    for (int i = 0; i < vertCount; i++, v += strideFloats) {
+      memcpy(out, v, strideFloats * sizeof(float));
+      out[strideFloats] = (float)c;
+      out += strideFloats + 1;
+    }
+  }
+}
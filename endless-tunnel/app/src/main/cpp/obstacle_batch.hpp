@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef endlesstunnel_obstacle_batch_hpp
+#define endlesstunnel_obstacle_batch_hpp
+
+#include "obstacle_ring.hpp"
+
+// Per-box data for batched obstacle rendering. The view-projection matrix is
+// shared by all boxes, so a box only needs its translation, its (uniform)
+// scale and its tint color. The layout matches two vec4 shader uniforms.
+struct BoxInstance {
+  float x, y, z, scale;
+  float r, g, b, a;
+};
+
+// maximum number of boxes that can be visible at the same time
+#define OBS_MAX_BOX_INSTANCES \
+  (ObstacleRing::CAPACITY * OBS_GRID_SIZE * OBS_GRID_SIZE)
+
+// Returns the color of the given obstacle style.
+void GetObstacleColor(int style, float *r, float *g, float *b);
+
+// Fills out[] with one instance per box of the obstacles in the ring (the
+// first of which is at tunnel section firstSection). Null obstacles are
+// skipped. Returns the number of instances written (at most maxCount).
+int BuildObstacleInstances(const ObstacleRing &ring, int firstSection,
+                           BoxInstance *out, int maxCount);
+
+// Writes `copies` copies of the given geometry to out, each vertex followed by
+// one extra float holding the index of its copy, so a shader can look up the
+// per-instance data. out must have room for vertCount * (strideFloats + 1) *
+// copies floats.
+void ReplicateGeom(const float *geom, int vertCount, int strideFloats,
+                   int copies, float *out);
+
+#endif
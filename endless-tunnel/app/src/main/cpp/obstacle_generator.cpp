@@ -36,13 +36,13 @@ void ObstacleGenerator::Generate(Obstacle *result) {
       0,   0,   0,   100  // difficulty 12+
   };
   result->Reset();
-  result->style = 1 + Random(7);
+  result->style = 1 + mRng.Next(7);
 
   int d = Clamp(mDifficulty, 0, 12);
   int easyProb = PROB_TABLE[d * 4];
   int medProb = PROB_TABLE[d * 4 + 1];
   int intermediateProb = PROB_TABLE[d * 4 + 2];
-  int roll = Random(100);
+  int roll = mRng.Next(100);
   if (roll <= easyProb) {
     GenEasy(result);
   } else if (roll <= easyProb + medProb) {
@@ -52,33 +52,37 @@ void ObstacleGenerator::Generate(Obstacle *result) {
   } else {
     GenHard(result);
   }
-  result->PutRandomBonus();
+  result->PutRandomBonus(&mRng);
 }
 
 void ObstacleGenerator::FillRow(Obstacle *result, int row) {
-  for (int i = 0; i < OBS_GRID_SIZE; ++i) {
-    result->grid[i][row] = true;
-  }
+  result->mask |= Obstacle::RowBits(row);
 }
 
 void ObstacleGenerator::FillCol(Obstacle *result, int col) {
-  for (int i = 0; i < OBS_GRID_SIZE; ++i) {
-    result->grid[col][i] = true;
-  }
+  result->mask |= Obstacle::ColBits(col);
+}
+
+// clears one cell at random: column first, then row, so that the game does
+// not depend on the compiler's order of evaluating arguments
+void ObstacleGenerator::ClearRandomBox(Obstacle *result) {
+  int x = mRng.Next(0, OBS_GRID_SIZE);
+  int y = mRng.Next(0, OBS_GRID_SIZE);
+  result->SetBox(x, y, false);
 }
 
 void ObstacleGenerator::GenEasy(Obstacle *result) {
-  int n = Random(4);
+  int n = mRng.Next(4);
   int i, j;
   Obstacle *o = result;  // shorthand
   switch (n) {
     case 0:
-      i = Random(1, OBS_GRID_SIZE - 1);           // i is the row of the bonus
-      FillRow(result, i + (Random(2) ? 1 : -1));  // horizontal bar next to i
+      i = mRng.Next(1, OBS_GRID_SIZE - 1);  // i is the row of the bonus
+      FillRow(result, i + (mRng.Next(2) ? 1 : -1));  // horizontal bar next to i
       break;
     case 1:
-      i = Random(1, OBS_GRID_SIZE - 1);  // i is the column of the bonus
-      FillCol(result, i + (Random(2) ? 1 : -1));  // vertical bar next to i
+      i = mRng.Next(1, OBS_GRID_SIZE - 1);  // i is the column of the bonus
+      FillCol(result, i + (mRng.Next(2) ? 1 : -1));  // vertical bar next to i
       break;
     case 2:
       FillRow(result, 0);
@@ -87,30 +91,30 @@ void ObstacleGenerator::GenEasy(Obstacle *result) {
       FillCol(result, OBS_GRID_SIZE - 1);
       break;
     default:
-      i = Random(0, OBS_GRID_SIZE - 2);  // i is the row of the bonus
-      j = Random(0, OBS_GRID_SIZE - 2);  // i is the row of the bonus
-      o->grid[i][j] = o->grid[i + 1][j] = o->grid[i][j + 1] =
-          o->grid[i + 1][j + 1] = true;
+      i = mRng.Next(0, OBS_GRID_SIZE - 2);  // i is the row of the bonus
+      j = mRng.Next(0, OBS_GRID_SIZE - 2);  // i is the row of the bonus
+      o->mask |= Obstacle::CellBit(i, j) | Obstacle::CellBit(i + 1, j) |
+                 Obstacle::CellBit(i, j + 1) | Obstacle::CellBit(i + 1, j + 1);
       break;
   }
 }
 
 void ObstacleGenerator::GenMedium(Obstacle *result) {
-  int n = Random(3);
+  int n = mRng.Next(3);
   int i;
   switch (n) {
     case 0:
-      i = Random(1, OBS_GRID_SIZE - 1);  // i is the row of the bonus
+      i = mRng.Next(1, OBS_GRID_SIZE - 1);  // i is the row of the bonus
       FillRow(result, i + 1);
       FillRow(result, i - 1);
       break;
     case 1:
-      i = Random(1, OBS_GRID_SIZE - 1);  // i is the column of the bonus
+      i = mRng.Next(1, OBS_GRID_SIZE - 1);  // i is the column of the bonus
       FillCol(result, i - 1);
       FillCol(result, i + 1);
       break;
     default:
-      i = Random(1, OBS_GRID_SIZE - 1);  // i is the column of the bonus
+      i = mRng.Next(1, OBS_GRID_SIZE - 1);  // i is the column of the bonus
       FillRow(result, i);
       FillCol(result, i);
       break;
@@ -118,23 +122,23 @@ void ObstacleGenerator::GenMedium(Obstacle *result) {
 }
 
 void ObstacleGenerator::GenIntermediate(Obstacle *result) {
-  int n = Random(3);
+  int n = mRng.Next(3);
   int i;
   switch (n) {
     case 0:
-      i = Random(0, OBS_GRID_SIZE - 2);
+      i = mRng.Next(0, OBS_GRID_SIZE - 2);
       FillRow(result, i);
       FillRow(result, i + 1);
       FillRow(result, i + 2);
       break;
     case 1:
-      i = Random(0, OBS_GRID_SIZE - 2);  // i is the column of the bonus
+      i = mRng.Next(0, OBS_GRID_SIZE - 2);  // i is the column of the bonus
       FillCol(result, i);
       FillCol(result, i + 1);
       FillCol(result, i + 2);
       break;
     default:
-      i = Random(1, OBS_GRID_SIZE - 2);  // i is the column of the bonus
+      i = mRng.Next(1, OBS_GRID_SIZE - 2);  // i is the column of the bonus
       FillCol(result, i - 1);
       FillCol(result, i + 1);
       FillCol(result, i + 2);
@@ -143,43 +147,43 @@ void ObstacleGenerator::GenIntermediate(Obstacle *result) {
 }
 
 void ObstacleGenerator::GenHard(Obstacle *result) {
-  int n = Random(4);
+  int n = mRng.Next(4);
   int i;
   int j;
   switch (n) {
     case 0:
-      i = Random(0, OBS_GRID_SIZE - 3);
+      i = mRng.Next(0, OBS_GRID_SIZE - 3);
       FillRow(result, i);
       FillRow(result, i + 1);
       FillRow(result, i + 2);
       FillRow(result, i + 3);
-      result->grid[Random(0, OBS_GRID_SIZE)][Random(0, OBS_GRID_SIZE)] = false;
+      ClearRandomBox(result);
       break;
     case 1:
-      i = Random(0, OBS_GRID_SIZE - 3);
+      i = mRng.Next(0, OBS_GRID_SIZE - 3);
       FillCol(result, i);
       FillCol(result, i + 1);
       FillCol(result, i + 2);
       FillCol(result, i + 3);
-      result->grid[Random(0, OBS_GRID_SIZE)][Random(0, OBS_GRID_SIZE)] = false;
+      ClearRandomBox(result);
       break;
     case 2:
-      i = Random(0, OBS_GRID_SIZE);
+      i = mRng.Next(0, OBS_GRID_SIZE);
       for (j = 0; j < OBS_GRID_SIZE; j++) {
         if (i != j) {
           FillCol(result, i);
         }
       }
-      result->grid[Random(0, OBS_GRID_SIZE)][Random(0, OBS_GRID_SIZE)] = false;
+      ClearRandomBox(result);
       break;
     default:
-      i = Random(0, OBS_GRID_SIZE);
+      i = mRng.Next(0, OBS_GRID_SIZE);
       for (j = 0; j < OBS_GRID_SIZE; j++) {
         if (i != j) {
           FillRow(result, i);
         }
       }
-      result->grid[Random(0, OBS_GRID_SIZE)][Random(0, OBS_GRID_SIZE)] = false;
+      ClearRandomBox(result);
       break;
   }
 }
@@ -16,18 +16,21 @@
 #ifndef endlesstunnel_obstacle_generator_hpp
 #define endlesstunnel_obstacle_generator_hpp
 
-#include "engine.hpp"
 #include "obstacle.hpp"
 
-// Generates obstacles given a difficulty level.
+// Generates obstacles given a difficulty level. The obstacles depend only on
+// the seed and the sequence of difficulty levels, so a game can be replayed.
 class ObstacleGenerator {
  private:
   int mDifficulty;
+  Rng mRng;
 
  public:
   ObstacleGenerator() { mDifficulty = 0; }
 
   void SetDifficulty(int dif) { mDifficulty = dif; }
+  void SetSeed(uint32_t seed) { mRng.Seed(seed); }
+  uint32_t GetRngState() const { return mRng.GetState(); }
 
   // generate a new obstacle.
   void Generate(Obstacle *result);
@@ -40,6 +43,7 @@ class ObstacleGenerator {
 
   void FillRow(Obstacle *result, int row);
   void FillCol(Obstacle *result, int col);
+  void ClearRandomBox(Obstacle *result);
 };
 
 #endif
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef endlesstunnel_obstacle_ring_hpp
+#define endlesstunnel_obstacle_ring_hpp
+
+#include <stdint.h>
+
+#include "game_consts.hpp"
+#include "obstacle.hpp"
+
+// Circular buffer of the obstacles that are currently alive. There is exactly
+// one obstacle for each tunnel section: obstacle 0 is at the first section,
+// obstacle 1 at the next one, and so on.
+//
+// The obstacles are stored as parallel arrays (one for the occupancy masks, one
+// for the styles, one for the bonus cells) so that the per-frame collision test
+// only touches a few bytes.
+class ObstacleRing {
+ public:
+  static const int CAPACITY = RENDER_TUNNEL_SECTION_COUNT * 2;
+
+  // results of testing the player against an obstacle
+  static const int HIT_NONE = 0;   // player went through empty cells
+  static const int HIT_BOX = 1;    // player crashed against a box
+  static const int HIT_BONUS = 2;  // player picked up the bonus
+
+  ObstacleRing() { Clear(); }
+
+  void Clear() {
+    mFirst = 0;
+    mCount = 0;
+  }
+
+  int GetCount() const { return mCount; }
+  bool IsFull() const { return mCount >= CAPACITY; }
+
+  // appends an obstacle after the last one
+  void PushBack(const Obstacle &o) {
+    int i = (mFirst + mCount) % CAPACITY;
+    mMask[i] = o.mask;
+    mStyle[i] = (uint8_t)o.style;
+    mBonusCell[i] = o.HasBonus() ? (int8_t)(o.bonusRow * OBS_GRID_SIZE +
+                                            o.bonusCol)
+                                 : (int8_t)-1;
+    mCount++;
+  }
+
+  // discards the first obstacle
+  void PopFront() {
+    if (mCount > 0) {
+      mFirst = (mFirst + 1) % CAPACITY;
+      mCount--;
+    }
+  }
+
+  uint32_t GetMask(int i) const { return mMask[Index(i)]; }
+  int GetStyle(int i) const { return mStyle[Index(i)]; }
+
+  bool HasBonus(int i) const { return mBonusCell[Index(i)] >= 0; }
+  int GetBonusRow(int i) const { return mBonusCell[Index(i)] / OBS_GRID_SIZE; }
+  int GetBonusCol(int i) const { return mBonusCell[Index(i)] % OBS_GRID_SIZE; }
+  void DeleteBonus(int i) { mBonusCell[Index(i)] = -1; }
+
+  // tests a player at lateral position (x, z) against obstacle i
+  int TestHit(int i, float x, float z) const {
+    int col = Obstacle::GetColAt(x), row = Obstacle::GetRowAt(z);
+    int k = Index(i);
+    if (mMask[k] & Obstacle::CellBit(col, row)) {
+      return HIT_BOX;
+    }
+    return mBonusCell[k] == row * OBS_GRID_SIZE + col ? HIT_BONUS : HIT_NONE;
+  }
+
+  // is a player at lateral position (x, z) within CLOSE_CALL_CALC_DELTA of a
+  // box of obstacle i?
+  bool IsCloseCall(int i, float x, float z) const {
+    return 0 != (mMask[Index(i)] & Obstacle::GetNearBits(x, z));
+  }
+
+ private:
+  int Index(int i) const { return (mFirst + i) % CAPACITY; }
+
+  int mFirst;
+  int mCount;
+  uint32_t mMask[CAPACITY];
+  uint8_t mStyle[CAPACITY];
+  int8_t mBonusCell[CAPACITY];  // row * OBS_GRID_SIZE + col, or -1 if none
+};
+
+#endif
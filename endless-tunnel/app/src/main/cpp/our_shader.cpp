@@ -17,6 +17,7 @@
 #include "our_shader.hpp"
 
 #include "data/our_shader.inl"
+#include "obstacle_batch.hpp"
 
 OurShader::OurShader() : Shader() {
   mColorLoc = (GLint)-1;
@@ -127,3 +128,61 @@ const char* OurShader::GetVertShaderSource() {
 const char* OurShader::GetFragShaderSource() { return OUR_FRAG_SHADER_SOURCE; }
 
 const char* OurShader::GetShaderName() { return "OurShader"; }
+
+int ObstacleShader::GetMaxBatchInstances() {
+  return OBSTACLE_SHADER_MAX_INSTANCES;
+}
+
+ObstacleShader::ObstacleShader() : OurShader() {
+  mInstancesLoc = -1;
+  mInstanceIdLoc = -1;
+}
+
+void ObstacleShader::Compile() {
+  OurShader::Compile();
+
+  BindShader();
+  mInstancesLoc = glGetUniformLocation(mProgramH, "u_Instances");
+  if (mInstancesLoc < 0) {
+    LOGE("*** Couldn't get instances uniform location (ObstacleShader).");
+    ABORT_GAME;
+  }
+  mInstanceIdLoc = glGetAttribLocation(mProgramH, "a_InstanceId");
+  if (mInstanceIdLoc < 0) {
+    LOGE("*** Couldn't get instance id attrib location (ObstacleShader).");
+    ABORT_GAME;
+  }
+  UnbindShader();
+}
+
+void ObstacleShader::BeginRender(VertexBuf* geom) {
+  OurShader::BeginRender(geom);
+
+  MY_ASSERT(geom->HasInstanceIds());
+  glVertexAttribPointer(mInstanceIdLoc, 1, GL_FLOAT, GL_FALSE,
+                        geom->GetStride(),
+                        BUFFER_OFFSET(geom->GetInstanceIdsOffset()));
+  glEnableVertexAttribArray(mInstanceIdLoc);
+}
+
+void ObstacleShader::RenderInstances(glm::mat4* vpMat,
+                                     const BoxInstance* instances, int count) {
+  MY_ASSERT(mPreparedVertexBuf != NULL);
+
+  // the prepared geometry holds one copy of the box per instance slot
+  int vertsPerInstance =
+      mPreparedVertexBuf->GetCount() / OBSTACLE_SHADER_MAX_INSTANCES;
+
+  PushMVPMatrix(vpMat);
+  for (int first = 0; first < count; first += OBSTACLE_SHADER_MAX_INSTANCES) {
+    int n = Min(count - first, OBSTACLE_SHADER_MAX_INSTANCES);
+    glUniform4fv(mInstancesLoc, n * 2, &instances[first].x);
+    glDrawArrays(mPreparedVertexBuf->GetPrimitive(), 0, n * vertsPerInstance);
+  }
+}
+
+const char* ObstacleShader::GetVertShaderSource() {
+  return OBSTACLE_VERTEX_SHADER_SOURCE;
+}
+
+const char* ObstacleShader::GetShaderName() { return "ObstacleShader"; }
@@ -45,4 +45,33 @@ class OurShader : public Shader {
   virtual const char *GetShaderName();
 };
 
+struct BoxInstance;
+
+// Variant of OurShader that draws many copies of a box with a single draw call
+// per batch of instances. The geometry given to BeginRender() must have been
+// replicated with ReplicateGeom() (see obstacle_batch.hpp), once per instance
+// slot, and must have instance ids. Since GLES 2.0 has no instanced draw
+// calls, the per-instance data travels in a uniform array instead.
+class ObstacleShader : public OurShader {
+ protected:
+  int mInstancesLoc;
+  int mInstanceIdLoc;
+
+ public:
+  // number of instances that can be drawn with a single call
+  static int GetMaxBatchInstances();
+
+  ObstacleShader();
+  virtual void Compile();
+  virtual void BeginRender(VertexBuf *geom);
+
+  // Renders the given instances using vpMat as the view-projection matrix.
+  void RenderInstances(glm::mat4 *vpMat, const BoxInstance *instances,
+                       int count);
+
+ protected:
+  virtual const char *GetVertShaderSource();
+  virtual const char *GetShaderName();
+};
+
 #endif
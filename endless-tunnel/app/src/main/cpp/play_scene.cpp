@@ -19,12 +19,13 @@
 
 #include "anim.hpp"
 #include "ascii_to_geom.hpp"
-#include "data/ascii_art.inl"
+#include "data/ascii_geom.inl"
 #include "data/cube_geom.inl"
 #include "data/strings.inl"
 #include "data/tunnel_geom.inl"
 #include "game_consts.hpp"
 #include "our_shader.hpp"
+#include "proc_texture.hpp"
 #include "util.hpp"
 #include "welcome_scene.hpp"
 
@@ -34,11 +35,11 @@
 static const float MENUITEM_SEL_COLOR[] = {1.0f, 1.0f, 0.0f};
 static const float MENUITEM_COLOR[] = {1.0f, 1.0f, 1.0f};
 
-// obstacle colors
-static const float OBS_COLORS[] = {0.0f, 0.0f, 0.0f,  // style 0 (not used)
-                                   0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
-                                   0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f,
-                                   1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f};
+/*
+ * where do I put the program???
+ */
+static const char *SAVE_PATH =
+    "/mnt/sdcard/com.google.example.games.tunnel.fix";
 
 static const char *TONE_BONUS[] = {
     "d70 f150. f250. f350. f450.", "d70 f200. f300. f400. f500.",
@@ -49,22 +50,25 @@ static const char *TONE_BONUS[] = {
 
 PlayScene::PlayScene() : Scene() {
   mOurShader = NULL;
+  mObstacleShader = NULL;
   mTrivialShader = NULL;
   mTextRenderer = NULL;
   mShapeRenderer = NULL;
   mShipSteerX = mShipSteerZ = 0.0f;
-  mFilteredSteerX = mFilteredSteerZ = 0.0f;
 
   mPlayerDir = glm::vec3(0.0f, 1.0f, 0.0f);  // forward
-  mDifficulty = 0;
   mUseCloudSave = false;
 
+  // every game gets its own obstacle sequence; the seed is all it takes to
+  // play it again
+  mTrace.seed = (uint32_t)time(NULL);
+  mSim.Reset(mTrace.seed);
+  mSimTimeLeft = 0.0f;
+
   mCubeGeom = NULL;
+  mCubeBatchGeom = NULL;
   mTunnelGeom = NULL;
 
-  mObstacleCount = 0;
-  mFirstObstacle = 0;
-  mFirstSection = 0;
   mSteering = STEERING_NONE;
   mPointerId = -1;
   mPointerAnchorX = mPointerAnchorY = 0.0f;
@@ -89,32 +93,28 @@ PlayScene::PlayScene() : Scene() {
   mShowedHowto = false;
   mLifeGeom = NULL;
 
-  mLives = PLAYER_LIVES;
-
-  mRollAngle = 0.0f;
-
-  mPlayerSpeed = 0.0f;
   mBlinkingHeart = false;
   mGameStartTime = Clock();
 
-  mBonusInARow = 0;
-  mLastCrashSection = -1;
-
   mFrameClock.SetMaxDelta(MAX_DELTA_T);
-  mLastAmbientBeepEmitted = 0;
   mMenuTouchActive = false;
 
   mCheckpointSignPending = false;
 
-  SetScore(0);
+  // synthesize our sound effects now rather than in the middle of the game
+  SfxMan *sfxMan = SfxMan::GetInstance();
+  sfxMan->PrepareTone(TONE_LEVEL_UP);
+  sfxMan->PrepareTone(TONE_CRASHED);
+  sfxMan->PrepareTone(TONE_GAME_OVER);
+  sfxMan->PrepareTone(TONE_AMBIENT_0);
+  sfxMan->PrepareTone(TONE_AMBIENT_1);
+  for (unsigned i = 0; i < sizeof(TONE_BONUS) / sizeof(char *); i++) {
+    sfxMan->PrepareTone(TONE_BONUS[i]);
+  }
 
-  /*
-   * where do I put the program???
-   */
-  const char *savePath = "/mnt/sdcard/com.google.example.games.tunnel.fix";
-  int len = strlen(savePath) + strlen(SAVE_FILE_NAME) + 3;
+  int len = strlen(SAVE_PATH) + strlen(SAVE_FILE_NAME) + 3;
   mSaveFileName = new char[len];
-  strcpy(mSaveFileName, savePath);
+  strcpy(mSaveFileName, SAVE_PATH);
   strcat(mSaveFileName, "/");
   strcat(mSaveFileName, SAVE_FILE_NAME);
   LOGD("Save file name: %s", mSaveFileName);
@@ -185,28 +185,29 @@ void PlayScene::WriteSaveFile(int level) {
 }
 
 void PlayScene::SaveProgress() {
-  if (mDifficulty <= mSavedCheckpoint) {
+  int difficulty = mSim.GetDifficulty();
+  if (difficulty <= mSavedCheckpoint) {
     // nothing to do
-    LOGD("No need to save level, current = %d, saved = %d", mDifficulty,
+    LOGD("No need to save level, current = %d, saved = %d", difficulty,
          mSavedCheckpoint);
     return;
   } else if (!IsCheckpointLevel()) {
     LOGD("Current level %d is not a checkpoint level. Nothing to save.",
-         mDifficulty);
+         difficulty);
     return;
   }
 
-  mSavedCheckpoint = mDifficulty;
+  mSavedCheckpoint = difficulty;
 
   // Save state locally or to the cloud, depending on configuration:
   if (mUseCloudSave) {
-    LOGD("Saving progress to the cloud: level %d", mDifficulty);
+    LOGD("Saving progress to the cloud: level %d", difficulty);
     /*
      * No where to save
      */
   } else {
-    LOGD("Saving progress to LOCAL FILE: level %d", mDifficulty);
-    WriteSaveFile(mDifficulty);
+    LOGD("Saving progress to LOCAL FILE: level %d", difficulty);
+    WriteSaveFile(difficulty);
   }
 
   // Show a "checkpoint saved" sign when possible. We don't show it right away
@@ -215,22 +216,23 @@ void PlayScene::SaveProgress() {
   mCheckpointSignPending = true;
 }
 
-static unsigned char *_gen_wall_texture() {
-  static unsigned char pixel_data[WALL_TEXTURE_SIZE * WALL_TEXTURE_SIZE * 3];
-  unsigned char *p;
-  int x, y;
-  for (y = 0, p = pixel_data; y < WALL_TEXTURE_SIZE; y++) {
-    for (x = 0; x < WALL_TEXTURE_SIZE; x++, p += 3) {
-      p[0] = p[1] = p[2] = 128 + ((x > 2 && y > 2) ? Random(128) : 0);
-    }
-  }
-  return pixel_data;
+static ProcTexture *_gen_wall_texture() {
+  // gray noise from 128 to 255, with dark seams along two edges of each tile
+  ProcTextureParams params;
+  params.size = WALL_TEXTURE_SIZE;
+  params.noise = ProcTexture::NOISE_WHITE;
+  params.border = 3;
+  params.format = ProcTexture::FORMAT_RGB565;
+  params.mipFilter = ProcTexture::MIP_KAISER;
+  return new ProcTexture(params);
 }
 
 void PlayScene::OnStartGraphics() {
   // build shaders
   mOurShader = new OurShader();
   mOurShader->Compile();
+  mObstacleShader = new ObstacleShader();
+  mObstacleShader->Compile();
   mTrivialShader = new TrivialShader();
   mTrivialShader->Compile();
 
@@ -250,16 +252,33 @@ void PlayScene::OnStartGraphics() {
   mCubeGeom->vbuf->SetColorsOffset(CUBE_GEOM_COLOR_OFFSET);
   mCubeGeom->vbuf->SetTexCoordsOffset(CUBE_GEOM_TEXCOORD_OFFSET);
 
+  // build the batched cube geometry: one copy of the cube per instance slot,
+  // each vertex tagged with the index of its copy
+  int cubeFloats = CUBE_GEOM_STRIDE / sizeof(GLfloat);
+  int cubeVerts = sizeof(CUBE_GEOM) / CUBE_GEOM_STRIDE;
+  int slots = ObstacleShader::GetMaxBatchInstances();
+  int batchSize = (cubeFloats + 1) * cubeVerts * slots;
+  GLfloat *batchData = new GLfloat[batchSize];
+  ReplicateGeom(CUBE_GEOM, cubeVerts, cubeFloats, slots, batchData);
+  mCubeBatchGeom =
+      new SimpleGeom(new VertexBuf(batchData, batchSize * sizeof(GLfloat),
+                                   CUBE_GEOM_STRIDE + sizeof(GLfloat)));
+  mCubeBatchGeom->vbuf->SetColorsOffset(CUBE_GEOM_COLOR_OFFSET);
+  mCubeBatchGeom->vbuf->SetTexCoordsOffset(CUBE_GEOM_TEXCOORD_OFFSET);
+  mCubeBatchGeom->vbuf->SetInstanceIdsOffset(CUBE_GEOM_STRIDE);
+  delete[] batchData;
+
   // make the wall texture
+  ProcTexture *wallTexture = _gen_wall_texture();
   mWallTexture = new Texture();
-  mWallTexture->InitFromRawRGB(WALL_TEXTURE_SIZE, WALL_TEXTURE_SIZE, false,
-                               _gen_wall_texture());
+  mWallTexture->InitFromProcTexture(*wallTexture);
+  delete wallTexture;
 
   // reset frame clock so the animation doesn't jump
   mFrameClock.Reset();
 
   // life icon geometry
-  mLifeGeom = AsciiArtToGeom(ART_LIFE, LIFE_ICON_SCALE);
+  mLifeGeom = PackedLineGeomToGeom(ART_LIFE_GEOM, LIFE_ICON_SCALE);
 
   // create text renderer and shape renderer
   mTextRenderer = new TextRenderer(mTrivialShader);
@@ -270,16 +289,19 @@ void PlayScene::OnKillGraphics() {
   CleanUp(&mTextRenderer);
   CleanUp(&mShapeRenderer);
   CleanUp(&mOurShader);
+  CleanUp(&mObstacleShader);
   CleanUp(&mTrivialShader);
   CleanUp(&mTunnelGeom);
   CleanUp(&mCubeGeom);
+  CleanUp(&mCubeBatchGeom);
   CleanUp(&mWallTexture);
   CleanUp(&mLifeGeom);
 }
 
 void PlayScene::DoFrame() {
   float deltaT = mFrameClock.ReadDelta();
-  float previousY = mPlayerPos.y;
+  const glm::vec3 &playerPos = mSim.GetPlayerPos();
+  float rollAngle = mSim.GetRollAngle();
 
   // clear screen
   glClearColor(0.0, 0.0, 0.0, 1.0);
@@ -287,10 +309,10 @@ void PlayScene::DoFrame() {
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
   // rotate the view matrix according to current roll angle
-  glm::vec3 upVec = glm::vec3(-sin(mRollAngle), 0, cos(mRollAngle));
+  glm::vec3 upVec = glm::vec3(-sin(rollAngle), 0, cos(rollAngle));
 
   // set up view matrix according to player's ship position and direction
-  mViewMat = glm::lookAt(mPlayerPos, mPlayerPos + mPlayerDir, upVec);
+  mViewMat = glm::lookAt(playerPos, playerPos + mPlayerDir, upVec);
 
   // render tunnel walls
   RenderTunnel();
@@ -322,7 +344,7 @@ void PlayScene::DoFrame() {
   }
 
   // did we already show the howto?
-  if (!mShowedHowto && mDifficulty == 0) {
+  if (!mShowedHowto && mSim.GetDifficulty() == 0) {
     mShowedHowto = true;
     ShowSign(S_HOWTO_WITHOUT_JOY, SIGN_DURATION);
   }
@@ -332,114 +354,117 @@ void PlayScene::DoFrame() {
     mBlinkingHeart = false;
   }
 
-  // update speed
-  float targetSpeed = PLAYER_SPEED + PLAYER_SPEED_INC_PER_LEVEL * mDifficulty;
-  float accel = mPlayerSpeed >= 0.0f ? PLAYER_ACCELERATION_POSITIVE_SPEED
-                                     : PLAYER_ACCELERATION_NEGATIVE_SPEED;
-  if (mLives <= 0) {
-    targetSpeed = 0.0f;
-  }
-  mPlayerSpeed = Approach(mPlayerSpeed, targetSpeed, deltaT * accel);
-
-  // apply noise filter on steering
-  mFilteredSteerX =
-      (mFilteredSteerX * (NOISE_FILTER_SAMPLES - 1) + mShipSteerX) /
-      NOISE_FILTER_SAMPLES;
-  mFilteredSteerZ =
-      (mFilteredSteerZ * (NOISE_FILTER_SAMPLES - 1) + mShipSteerZ) /
-      NOISE_FILTER_SAMPLES;
-
-  // move player
-  if (mLives > 0) {
-    float steerX = mFilteredSteerX, steerZ = mFilteredSteerZ;
-    if (mSteering == STEERING_TOUCH) {
-      // touch steering
-      mPlayerPos.x =
-          Approach(mPlayerPos.x, steerX, PLAYER_MAX_LAT_SPEED * deltaT);
-      mPlayerPos.z =
-          Approach(mPlayerPos.z, steerZ, PLAYER_MAX_LAT_SPEED * deltaT);
-    } else if (mSteering == STEERING_JOY) {
-      // joystick steering
-      mPlayerPos.x += deltaT * steerX;
-      mPlayerPos.z += deltaT * steerZ;
-    }
+  // advance the simulation in fixed steps, carrying the remainder over to the
+  // next frame
+  mSimTimeLeft += deltaT;
+  while (mSimTimeLeft >= SIM_TIMESTEP) {
+    mSimTimeLeft -= SIM_TIMESTEP;
+    StepSim();
   }
-  mPlayerPos.y += deltaT * mPlayerSpeed;
-
-  // make sure player didn't leave tunnel
-  mPlayerPos.x = Clamp(mPlayerPos.x, PLAYER_MIN_X, PLAYER_MAX_X);
-  mPlayerPos.z = Clamp(mPlayerPos.z, PLAYER_MIN_Z, PLAYER_MAX_Z);
-
-  // shift sections if needed
-  ShiftIfNeeded();
 
-  // generate more obstacles!
-  GenObstacles();
+  // did the game expire?
+  if (mSim.GetLives() <= 0 && Clock() > mGameOverExpire) {
+    SceneManager::GetInstance()->RequestNewScene(new WelcomeScene());
+  }
+}
 
-  // detect collisions
-  DetectCollisions(previousY);
+void PlayScene::StepSim() {
+  SimInput input;
+  input.steering = mSteering;
+  input.steerX = mShipSteerX;
+  input.steerZ = mShipSteerZ;
+  if (SIM_RECORD_TRACE && mSim.GetLives() > 0) {
+    if (mTrace.inputs.empty()) {
+      mTrace.startLevel = mSim.GetDifficulty();
+    }
+    mTrace.inputs.push_back(input);
+  }
+  HandleSimEvents(mSim.Simulate(SIM_TIMESTEP, input));
+}
 
-  // update ship's roll speed according to level
-  static float roll_speeds[] = ROLL_SPEEDS;
-  int count = sizeof(roll_speeds) / sizeof(float);
-  float speed = roll_speeds[mDifficulty % count];
-  mRollAngle += deltaT * speed;
-  while (mRollAngle < 0) {
-    mRollAngle += 2 * M_PI;
+void PlayScene::HandleSimEvents(unsigned events) {
+  if (events & GameSim::EVENT_GAME_OVER) {
+    // say "Game Over"
+    ShowSign(S_GAME_OVER, SIGN_DURATION_GAME_OVER);
+    SfxMan::GetInstance()->PlayTone(TONE_GAME_OVER);
+    mGameOverExpire = Clock() + GAME_OVER_EXPIRE;
+    if (SIM_RECORD_TRACE) {
+      WriteTraceFile();
+    }
+  } else if (events & GameSim::EVENT_CRASH) {
+    ShowSign(S_OUCH, SIGN_DURATION);
+    SfxMan::GetInstance()->PlayTone(TONE_CRASHED);
   }
-  while (mRollAngle > 2 * M_PI) {
-    mRollAngle -= 2 * M_PI;
+  if (events & GameSim::EVENT_CRASH) {
+    mBlinkingHeart = true;
+    mBlinkingHeartExpire = Clock() + BLINKING_HEART_DURATION;
   }
 
-  // did the game expire?
-  if (mLives <= 0 && Clock() > mGameOverExpire) {
-    SceneManager::GetInstance()->RequestNewScene(new WelcomeScene());
+  if (events & GameSim::EVENT_BONUS) {
+    ShowSign(S_GOT_BONUS, SIGN_DURATION_BONUS);
+    if (events & GameSim::EVENT_LEVEL_UP) {
+      ShowLevelSign();
+      SfxMan::GetInstance()->PlayTone(TONE_LEVEL_UP);
+
+      // save progress, if needed
+      SaveProgress();
+    } else {
+      int score = mSim.GetScore();
+      int tone = (score % SCORE_PER_LEVEL) / BONUS_POINTS - 1;
+      tone = tone < 0 ? 0
+             : tone >= static_cast<int>(sizeof(TONE_BONUS) / sizeof(char *))
+                 ? static_cast<int>(sizeof(TONE_BONUS) / sizeof(char *) - 1)
+                 : tone;
+      SfxMan::GetInstance()->PlayTone(TONE_BONUS[tone]);
+    }
   }
 
   // produce the ambient sound
-  int soundPoint = (int)floor(mPlayerPos.y / (TUNNEL_SECTION_LENGTH / 3));
-  if (soundPoint % 3 != 0 && soundPoint > mLastAmbientBeepEmitted) {
-    mLastAmbientBeepEmitted = soundPoint;
-    SfxMan::GetInstance()->PlayTone(soundPoint % 2 ? TONE_AMBIENT_0
-                                                   : TONE_AMBIENT_1);
+  if (events & GameSim::EVENT_AMBIENT_0) {
+    SfxMan::GetInstance()->PlayTone(TONE_AMBIENT_0);
+  } else if (events & GameSim::EVENT_AMBIENT_1) {
+    SfxMan::GetInstance()->PlayTone(TONE_AMBIENT_1);
   }
 }
 
-static float GetSectionCenterY(int i) {
-  return (float)i * TUNNEL_SECTION_LENGTH;
-}
-
-static float GetSectionEndY(int i) {
-  return GetSectionCenterY(i) + 0.5f * TUNNEL_SECTION_LENGTH;
+void PlayScene::WriteTraceFile() {
+  int len = strlen(SAVE_PATH) + strlen(SIM_TRACE_FILE_NAME) + 3;
+  char *fileName = new char[len];
+  strcpy(fileName, SAVE_PATH);
+  strcat(fileName, "/");
+  strcat(fileName, SIM_TRACE_FILE_NAME);
+  LOGD("Writing input trace (%d steps) to file: %s",
+       (int)mTrace.inputs.size(), fileName);
+  if (!mTrace.Save(fileName)) {
+    LOGE("Error writing input trace file.");
+  }
+  delete[] fileName;
 }
 
-static void _get_obs_color(int style, float *r, float *g, float *b) {
-  style = Clamp(style, 1, 6);
-  *r = OBS_COLORS[style * 3];
-  *g = OBS_COLORS[style * 3 + 1];
-  *b = OBS_COLORS[style * 3 + 2];
+static float GetSectionCenterY(int i) {
+  return (float)i * TUNNEL_SECTION_LENGTH;
 }
 
 void PlayScene::RenderTunnel() {
   glm::mat4 modelMat;
   glm::mat4 mvpMat;
   int i, oi;
+  int firstSection = mSim.GetFirstSection();
+  const ObstacleRing &obstacles = mSim.GetObstacles();
 
   mOurShader->BeginRender(mTunnelGeom->vbuf);
   mOurShader->SetTexture(mWallTexture);
-  for (i = mFirstSection, oi = 0;
-       i <= mFirstSection + RENDER_TUNNEL_SECTION_COUNT; ++i, ++oi) {
+  for (i = firstSection, oi = 0;
+       i <= firstSection + RENDER_TUNNEL_SECTION_COUNT; ++i, ++oi) {
     float segCenterY = GetSectionCenterY(i);
     modelMat = glm::translate(glm::mat4(1.0), glm::vec3(0.0, segCenterY, 0.0));
     mvpMat = mProjMat * mViewMat * modelMat;
 
-    Obstacle *o = oi >= mObstacleCount ? NULL : GetObstacleAt(oi);
-
     // the point light is given in model coordinates, which is 0,0,0 is ok
     // (center of tunnel section)
-    if (o) {
+    if (oi < obstacles.GetCount()) {
       float red, green, blue;
-      _get_obs_color(o->style, &red, &green, &blue);
+      GetObstacleColor(obstacles.GetStyle(oi), &red, &green, &blue);
       mOurShader->EnablePointLight(glm::vec3(0.0, 0.0f, 0.0f), red, green,
                                    blue);
     } else {
@@ -454,94 +479,47 @@ void PlayScene::RenderTunnel() {
 
 void PlayScene::RenderObstacles() {
   int i;
-  int r, c;
-  float red, green, blue;
   glm::mat4 modelMat;
   glm::mat4 mvpMat;
-
+  int firstSection = mSim.GetFirstSection();
+  const ObstacleRing &obstacles = mSim.GetObstacles();
+
+  // all boxes share the view-projection matrix, so they are drawn as
+  // instances that only carry their own translation, scale and tint
+  int count = BuildObstacleInstances(obstacles, firstSection, mBoxInstances,
+                                     OBS_MAX_BOX_INSTANCES);
+  glm::mat4 vpMat = mProjMat * mViewMat;
+  mObstacleShader->BeginRender(mCubeBatchGeom->vbuf);
+  mObstacleShader->SetTexture(mWallTexture);
+  mObstacleShader->RenderInstances(&vpMat, mBoxInstances, count);
+  mObstacleShader->EndRender();
+
+  // bonuses spin, so they are rendered one by one (there is at most one per
+  // obstacle)
   mOurShader->BeginRender(mCubeGeom->vbuf);
   mOurShader->SetTexture(mWallTexture);
-
-  for (i = 0; i < mObstacleCount; i++) {
-    Obstacle *o = GetObstacleAt(i);
-    float posY = GetSectionCenterY(mFirstSection + i);
-
-    if (o->style == Obstacle::STYLE_NULL) {
-      // don't render null obstacles
+  mOurShader->SetTintColor(SineWave(0.8f, 1.0f, 0.5f, 0.0f),
+                           SineWave(0.8f, 1.0f, 0.5f, 0.0f),
+                           SineWave(0.8f, 1.0f, 0.5f, 0.0f));  // shimmering
+  for (i = 0; i < obstacles.GetCount(); i++) {
+    if (obstacles.GetStyle(i) == Obstacle::STYLE_NULL ||
+        !obstacles.HasBonus(i)) {
       continue;
     }
-
-    for (r = 0; r < OBS_GRID_SIZE; r++) {
-      for (c = 0; c < OBS_GRID_SIZE; c++) {
-        bool isBonus = r == o->bonusRow && c == o->bonusCol;
-        if (o->grid[c][r]) {
-          // set up matrices
-          modelMat =
-              glm::translate(glm::mat4(1.0f), o->GetBoxCenter(c, r, posY));
-          modelMat = glm::scale(modelMat, o->GetBoxSize(c, r));
-          mvpMat = mProjMat * mViewMat * modelMat;
-
-          // set up color
-          _get_obs_color(o->style, &red, &green, &blue);
-          mOurShader->SetTintColor(red, green, blue);
-
-          // render box
-          mOurShader->Render(&mvpMat);
-        } else if (isBonus) {
-          modelMat =
-              glm::translate(glm::mat4(1.0f), o->GetBoxCenter(c, r, posY));
-          modelMat = glm::scale(
-              modelMat,
-              glm::vec3(OBS_BONUS_SIZE, OBS_BONUS_SIZE, OBS_BONUS_SIZE));
-          modelMat = glm::rotate(modelMat, Clock() * 90.0f,
-                                 glm::vec3(0.0f, 0.0f, 1.0f));
-          mvpMat = mProjMat * mViewMat * modelMat;
-          mOurShader->SetTintColor(
-              SineWave(0.8f, 1.0f, 0.5f, 0.0f),
-              SineWave(0.8f, 1.0f, 0.5f, 0.0f),
-              SineWave(0.8f, 1.0f, 0.5f, 0.0f));  // shimmering color
-          mOurShader->Render(&mvpMat);            // render
-        }
-      }
-    }
+    float posY = GetSectionCenterY(firstSection + i);
+    int r = obstacles.GetBonusRow(i), c = obstacles.GetBonusCol(i);
+    modelMat =
+        glm::translate(glm::mat4(1.0f), Obstacle::GetBoxCenter(c, r, posY));
+    modelMat = glm::scale(
+        modelMat, glm::vec3(OBS_BONUS_SIZE, OBS_BONUS_SIZE, OBS_BONUS_SIZE));
+    modelMat =
+        glm::rotate(modelMat, Clock() * 90.0f, glm::vec3(0.0f, 0.0f, 1.0f));
+    mvpMat = mProjMat * mViewMat * modelMat;
+    mOurShader->Render(&mvpMat);
   }
   mOurShader->EndRender();
 }
 
-void PlayScene::GenObstacles() {
-  while (mObstacleCount < MAX_OBS) {
-    // generate a new obstacle
-    int index = (mFirstObstacle + mObstacleCount) % MAX_OBS;
-
-    int section = mFirstSection + mObstacleCount;
-    if (section < OBS_START_SECTION) {
-      // generate an empty obstacle
-      mObstacleCircBuf[index].Reset();
-      mObstacleCircBuf[index].style = Obstacle::STYLE_NULL;
-    } else {
-      // generate a normal obstacle
-      mObstacleGen.Generate(&mObstacleCircBuf[index]);
-    }
-    mObstacleCount++;
-  }
-}
-
-void PlayScene::ShiftIfNeeded() {
-  // is it time to discard a section and shift forward?
-  while (mPlayerPos.y > GetSectionEndY(mFirstSection) + SHIFT_THRESH) {
-    // shift to the next turnnel section
-    mFirstSection++;
-
-    // discard obstacle corresponding to the deleted section
-    if (mObstacleCount > 0) {
-      // discarding first object (shifting) is easy because it's a circular
-      // buffer!
-      mFirstObstacle = (mFirstObstacle + 1) % MAX_OBS;
-      --mObstacleCount;
-    }
-  }
-}
-
 void PlayScene::UpdateMenuSelFromTouch(float x, float y) {
   float sh = SceneManager::GetInstance()->GetScreenHeight();
   int item = (int)floor((y / sh) * (mMenuItemCount));
@@ -560,8 +538,8 @@ void PlayScene::OnPointerDown(int pointerId,
     mPointerId = pointerId;
     mPointerAnchorX = x;
     mPointerAnchorY = y;
-    mShipAnchorX = mPlayerPos.x;
-    mShipAnchorZ = mPlayerPos.z;
+    mShipAnchorX = mSim.GetPlayerPos().x;
+    mShipAnchorZ = mSim.GetPlayerPos().z;
     mSteering = STEERING_TOUCH;
   }
 }
@@ -587,10 +565,11 @@ void PlayScene::OnPointerMove(int pointerId,
   if (mMenu && mMenuTouchActive) {
     UpdateMenuSelFromTouch(x, y);
   } else if (mSteering == STEERING_TOUCH && pointerId == mPointerId) {
+    float rollAngle = mSim.GetRollAngle();
     float deltaX = (x - mPointerAnchorX) * TOUCH_CONTROL_SENSIVITY / rangeY;
     float deltaY = -(y - mPointerAnchorY) * TOUCH_CONTROL_SENSIVITY / rangeY;
-    float rotatedDx = cos(mRollAngle) * deltaX - sin(mRollAngle) * deltaY;
-    float rotatedDy = sin(mRollAngle) * deltaX + cos(mRollAngle) * deltaY;
+    float rotatedDx = cos(rollAngle) * deltaX - sin(rollAngle) * deltaY;
+    float rotatedDy = sin(rollAngle) * deltaX + cos(rollAngle) * deltaY;
 
     mShipSteerX = mShipAnchorX + rotatedDx;
     mShipSteerZ = mShipAnchorZ + rotatedDy;
@@ -608,7 +587,7 @@ void PlayScene::RenderHUD() {
   // render score digits
   int i, unit;
   static char score_str[6];
-  int score = GetScore();
+  int score = mSim.GetScore();
   for (i = 0, unit = 10000; i < 5; i++, unit /= 10) {
     score_str[i] = '0' + (score / unit) % 10;
   }
@@ -640,7 +619,8 @@ void PlayScene::RenderHUD() {
   float lifeX = LIFE_POS_X < 0.0f ? aspect + LIFE_POS_X : LIFE_POS_X;
   modelMat = glm::translate(glm::mat4(1.0), glm::vec3(lifeX, LIFE_POS_Y, 0.0f));
   modelMat = glm::scale(modelMat, glm::vec3(1.0f, LIFE_SCALE_Y, 1.0f));
-  int ubound = (mBlinkingHeart && BlinkFunc(0.2f)) ? mLives + 1 : mLives;
+  int lives = mSim.GetLives();
+  int ubound = (mBlinkingHeart && BlinkFunc(0.2f)) ? lives + 1 : lives;
   for (int i = 0; i < ubound; i++) {
     mat = orthoMat * modelMat;
     mTrivialShader->RenderSimpleGeom(&mat, mLifeGeom);
@@ -677,90 +657,6 @@ void PlayScene::RenderMenu() {
   glEnable(GL_DEPTH_TEST);
 }
 
-void PlayScene::DetectCollisions(float previousY) {
-  Obstacle *o = GetObstacleAt(0);
-  float obsCenter = GetSectionCenterY(mFirstSection);
-  float obsMin = obsCenter - OBS_BOX_SIZE;
-  float curY = mPlayerPos.y;
-
-  if (!o || !(previousY < obsMin && curY >= obsMin)) {
-    // no collision
-    return;
-  }
-
-  // what row/column is the player on?
-  int col = o->GetColAt(mPlayerPos.x);
-  int row = o->GetRowAt(mPlayerPos.z);
-
-  if (o->grid[col][row]) {
-    // crashed against obstacle
-    mLives--;
-    if (mLives > 0) {
-      ShowSign(S_OUCH, SIGN_DURATION);
-      SfxMan::GetInstance()->PlayTone(TONE_CRASHED);
-    } else {
-      // say "Game Over"
-      ShowSign(S_GAME_OVER, SIGN_DURATION_GAME_OVER);
-      SfxMan::GetInstance()->PlayTone(TONE_GAME_OVER);
-      mGameOverExpire = Clock() + GAME_OVER_EXPIRE;
-    }
-    mPlayerPos.y = obsMin - PLAYER_RECEDE_AFTER_COLLISION;
-    mPlayerSpeed = PLAYER_SPEED_AFTER_COLLISION;
-    mBlinkingHeart = true;
-    mBlinkingHeartExpire = Clock() + BLINKING_HEART_DURATION;
-
-    mLastCrashSection = mFirstSection;
-
-  } else if (row == o->bonusRow && col == o->bonusCol) {
-    ShowSign(S_GOT_BONUS, SIGN_DURATION_BONUS);
-    o->DeleteBonus();
-    AddScore(BONUS_POINTS);
-    mBonusInARow++;
-
-    if (mBonusInARow >= 10) {
-      mBonusInARow = 0;
-    }
-
-    // update difficulty level, if applicable
-    int score = GetScore();
-    if (mDifficulty < score / SCORE_PER_LEVEL) {
-      mDifficulty = score / SCORE_PER_LEVEL;
-      ShowLevelSign();
-      mObstacleGen.SetDifficulty(mDifficulty);
-      SfxMan::GetInstance()->PlayTone(TONE_LEVEL_UP);
-
-      // save progress, if needed
-      SaveProgress();
-    } else {
-      int tone = (score % SCORE_PER_LEVEL) / BONUS_POINTS - 1;
-      tone = tone < 0 ? 0
-             : tone >= static_cast<int>(sizeof(TONE_BONUS) / sizeof(char *))
-                 ? static_cast<int>(sizeof(TONE_BONUS) / sizeof(char *) - 1)
-                 : tone;
-      SfxMan::GetInstance()->PlayTone(TONE_BONUS[tone]);
-    }
-
-  } else if (o->HasBonus()) {
-    // player missed bonus!
-    mBonusInARow = 0;
-  }
-
-  // was it a close call?
-  if (!o->grid[col][row]) {
-    bool isCloseCall = false;
-    for (int i = -1; i <= 1 && !isCloseCall; i++) {
-      for (int j = -1; j <= 1; j++) {
-        int other_row = o->GetColAt(mPlayerPos.x + i * CLOSE_CALL_CALC_DELTA);
-        int other_col = o->GetRowAt(mPlayerPos.z + j * CLOSE_CALL_CALC_DELTA);
-        if (o->grid[other_col][other_row]) {
-          isCloseCall = true;
-          break;
-        }
-      }
-    }
-  }
-}
-
 bool PlayScene::OnBackKeyPressed() {
   if (mMenu) {
     // reset frame clock so that the animation doesn't jump:
@@ -777,10 +673,12 @@ bool PlayScene::OnBackKeyPressed() {
 
 void PlayScene::OnJoy(float joyX, float joyY) {
   if (!mSteering || mSteering == STEERING_JOY) {
+    float rollAngle = mSim.GetRollAngle();
+    float playerSpeed = mSim.GetPlayerSpeed();
     float deltaX = joyX * JOYSTICK_CONTROL_SENSIVITY;
     float deltaY = joyY * JOYSTICK_CONTROL_SENSIVITY;
-    float rotatedDx = cos(-mRollAngle) * deltaX - sin(-mRollAngle) * deltaY;
-    float rotatedDy = sin(-mRollAngle) * deltaX + cos(-mRollAngle) * deltaY;
+    float rotatedDx = cos(-rollAngle) * deltaX - sin(-rollAngle) * deltaY;
+    float rotatedDy = sin(-rollAngle) * deltaX + cos(-rollAngle) * deltaY;
     mShipSteerX = rotatedDx;
     mShipSteerZ = -rotatedDy;
     mSteering = STEERING_JOY;
@@ -788,9 +686,9 @@ void PlayScene::OnJoy(float joyX, float joyY) {
     // If player is going faster than the reference speed, PLAYER_SPEED, adjust
     // it. This makes the steering react faster as the ship accelerates in more
     // difficult levels.
-    if (mPlayerSpeed > PLAYER_SPEED) {
-      mShipSteerX *= mPlayerSpeed / PLAYER_SPEED;
-      mShipSteerZ *= mPlayerSpeed / PLAYER_SPEED;
+    if (playerSpeed > PLAYER_SPEED) {
+      mShipSteerX *= playerSpeed / PLAYER_SPEED;
+      mShipSteerZ *= playerSpeed / PLAYER_SPEED;
     }
   }
 }
@@ -831,6 +729,9 @@ void PlayScene::ShowMenu(int menu) {
 void PlayScene::HandleMenu(int menuItem) {
   switch (menuItem) {
     case MENUITEM_QUIT:
+      if (SIM_RECORD_TRACE) {
+        WriteTraceFile();
+      }
       SceneManager::GetInstance()->RequestNewScene(new WelcomeScene());
       break;
     case MENUITEM_UNPAUSE:
@@ -838,10 +739,8 @@ void PlayScene::HandleMenu(int menuItem) {
       break;
     case MENUITEM_RESUME:
       // resume from saved level
-      mDifficulty =
-          (mSavedCheckpoint / LEVELS_PER_CHECKPOINT) * LEVELS_PER_CHECKPOINT;
-      SetScore(SCORE_PER_LEVEL * mDifficulty);
-      mObstacleGen.SetDifficulty(mDifficulty);
+      mSim.SetLevel((mSavedCheckpoint / LEVELS_PER_CHECKPOINT) *
+                    LEVELS_PER_CHECKPOINT);
       ShowLevelSign();
       ShowMenu(MENU_NONE);
       break;
@@ -854,7 +753,7 @@ void PlayScene::HandleMenu(int menuItem) {
 
 void PlayScene::ShowLevelSign() {
   static char level_str[] = "LEVEL XX";
-  int level = mDifficulty + 1;
+  int level = mSim.GetDifficulty() + 1;
   level_str[6] = '0' + ((level > 9) ? (level / 10) % 10 : level % 10);
   level_str[7] = (level > 9) ? ('0' + level % 10) : '\0';
   level_str[8] = '\0';
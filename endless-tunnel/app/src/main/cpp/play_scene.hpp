@@ -17,14 +17,16 @@
 #define endlesstunnel_play_scene_h
 
 #include "engine.hpp"
+#include "game_sim.hpp"
 #include "obstacle.hpp"
-#include "obstacle_generator.hpp"
+#include "obstacle_batch.hpp"
 #include "sfxman.hpp"
 #include "shape_renderer.hpp"
 #include "text_renderer.hpp"
 #include "util.hpp"
 
 class OurShader;
+class ObstacleShader;
 
 /* This is the gameplay scene -- the scene that shows the player flying down
  * the infinite tunnel, dodging obstacles, collecting bonuses and being awesome.
@@ -47,6 +49,7 @@ class PlayScene : public Scene {
  protected:
   // shaders
   OurShader *mOurShader;
+  ObstacleShader *mObstacleShader;
   TrivialShader *mTrivialShader;
 
   // the wall texture
@@ -59,22 +62,17 @@ class PlayScene : public Scene {
   // matrices
   glm::mat4 mViewMat, mProjMat;
 
-  // player's position and direction
-  glm::vec3 mPlayerPos, mPlayerDir;
+  // player's direction
+  glm::vec3 mPlayerDir;
 
-  // lives left
-  int mLives;
+  // the game simulation (player, obstacles, score, lives, difficulty)
+  GameSim mSim;
 
-  // player's score. As a trivial form of protection (just to give crackers a
-  // hard time), we *actually* store the score encrypted in mEncryptedScore, but
-  // have a fake variable mFakeScore that stores a copy of it. This serves as a
-  // honeypot to an attacker who's trying to crack the game using a memory
-  // editor.
-  unsigned mFakeScore;
-  unsigned mEncryptedScore;
+  // game time not yet simulated (always less than SIM_TIMESTEP)
+  float mSimTimeLeft;
 
-  // current difficulty level
-  int mDifficulty;
+  // input recorded so far (only if SIM_RECORD_TRACE is on)
+  SimTrace mTrace;
 
   // should we use cloud save? If not, we will save progress to local data only.
   bool mUseCloudSave;
@@ -88,24 +86,17 @@ class PlayScene : public Scene {
   // vertex buffer to render obstacles
   SimpleGeom *mCubeGeom;
 
-  // what is the first tunnel section that we are rendering
-  int mFirstSection;
+  // the cube geometry replicated once per instance slot of mObstacleShader,
+  // so that a whole batch of obstacle boxes can be drawn with one call
+  SimpleGeom *mCubeBatchGeom;
 
-  // circular buffer of obstacles (mObstacleCircBuf[mFirstObstacle...])
-  // There is exactly one obstacle for each tunnel section:
-  // obstacle 0 is at section mFirstSection
-  // obstacle 1 is at section mFirstSection + 1
-  // and so on and so forth.
-  static const int MAX_OBS = RENDER_TUNNEL_SECTION_COUNT * 2;
-  int mFirstObstacle;
-  int mObstacleCount;
-  Obstacle mObstacleCircBuf[MAX_OBS];
-
-  // obstacle generator
-  ObstacleGenerator mObstacleGen;
+  // instances of the obstacle boxes visible on this frame
+  BoxInstance mBoxInstances[OBS_MAX_BOX_INSTANCES];
 
   // touch pointer ID and anchor position (where touch started)
-  static const int STEERING_NONE = 0, STEERING_TOUCH = 1, STEERING_JOY = 2;
+  static const int STEERING_NONE = SimInput::STEERING_NONE;
+  static const int STEERING_TOUCH = SimInput::STEERING_TOUCH;
+  static const int STEERING_JOY = SimInput::STEERING_JOY;
   int mSteering;   // is player steering at the moment? If so, how?
   int mPointerId;  // if so, what's the pointer ID
   float mPointerAnchorX, mPointerAnchorY;  // where the drag started
@@ -114,10 +105,6 @@ class PlayScene : public Scene {
       mShipSteerZ;  // target x,z of ship (when using touch control) or
                     // velocity vector (when using joystick)
 
-  // moving average filter for input (on mShipSteerX and mShipSteerY)
-  static const int NOISE_FILTER_SAMPLES = 5;
-  float mFilteredSteerX, mFilteredSteerZ;
-
   // frame clock -- it computes the deltas between successive frames so we can
   // update stuff properly
   DeltaClock mFrameClock;
@@ -159,54 +146,29 @@ class PlayScene : public Scene {
   // heart geom (to display # lives)
   SimpleGeom *mLifeGeom;
 
-  // current roll angle, in degrees, counterclockwise from original
-  float mRollAngle;
-
-  // current speed
-  float mPlayerSpeed;
-
   // are we showing the "just lost a heart" animation? If so, when does it
   // expire?
   bool mBlinkingHeart;
   float mBlinkingHeartExpire;
 
   // when should the game expire? This will be set after the game is over
-  // (mLives <= 0) and indicates when we should return to the main screen
+  // (no lives left) and indicates when we should return to the main screen
   float mGameOverExpire;
 
   // time when game started
   float mGameStartTime;
 
-  // how many bonuses were collected without missing one?
-  int mBonusInARow;
-
-  // what was the section number of the last obstacle with which the player
-  // crashed?
-  int mLastCrashSection;
-
-  // last subsection were an ambient sound was emitted
-  int mLastAmbientBeepEmitted;
-
   // name of the save file
   char *mSaveFileName;
 
   // pending to show a "checkpoint saved" sign?
   bool mCheckpointSignPending;
 
-  // get current score
-  int GetScore() { return (int)(mEncryptedScore ^ 0x600673); }
+  // advances the simulation by one SIM_TIMESTEP
+  void StepSim();
 
-  // set current score
-  void SetScore(int s) {
-    mFakeScore = (unsigned)s;
-    mEncryptedScore = mFakeScore ^ 0x600673;
-  }
-
-  // add to current score
-  void AddScore(int s) { SetScore(GetScore() + s); }
-
-  // generate new obstacles as needed
-  void GenObstacles();
+  // plays the sounds and shows the signs for the events of a simulation step
+  void HandleSimEvents(unsigned events);
 
   // renders the tunnel walls
   void RenderTunnel();
@@ -220,14 +182,6 @@ class PlayScene : public Scene {
   // renders the currently active menu
   void RenderMenu();
 
-  // Shift tunnel sections if needed (this means discarding the ones the
-  // player has already past and generating the obstacles for the new ones
-  // that came into view)
-  void ShiftIfNeeded();
-
-  // detect if the player hit obstacles or got the bonus
-  void DetectCollisions(float previousY);
-
   // shows a text sign on the middle of the screen
   void ShowSign(const char *sign, float timeout) {
     mSignTimeLeft = timeout;
@@ -240,9 +194,6 @@ class PlayScene : public Scene {
     mSignExpires = false;
     mSignStartTime = Clock();
   }
-  Obstacle *GetObstacleAt(int i) {
-    return &mObstacleCircBuf[(mFirstObstacle + i) % MAX_OBS];
-  }
 
   // shows the given menu
   void ShowMenu(int menu);
@@ -264,7 +215,9 @@ class PlayScene : public Scene {
 
   // returns whether or not this level is a "checkpoint level" (that is,
   // where progress should be saved)
-  bool IsCheckpointLevel() { return 0 == mDifficulty % LEVELS_PER_CHECKPOINT; }
+  bool IsCheckpointLevel() {
+    return 0 == mSim.GetDifficulty() % LEVELS_PER_CHECKPOINT;
+  }
 
   // shows the sign that tells the player they've reached a new level.
   // (like "LEVEL 5").
@@ -272,6 +225,9 @@ class PlayScene : public Scene {
 
   // update projection matrix
   void UpdateProjectionMatrix();
+
+  // writes the input recorded so far to the trace file
+  void WriteTraceFile();
 };
 
 #endif
@@ -0,0 +1,399 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "proc_texture.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#include "util.hpp"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PROC_TEX_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define PROC_TEX_SSE2
+#endif
+
+// Kaiser filter: taps per output pixel (in each direction), and window shape
+#define KAISER_TAPS 6
+#define KAISER_BETA 4.0f
+
+ProcTextureParams::ProcTextureParams() {
+  size = 64;
+  noise = ProcTexture::NOISE_WHITE;
+  cellSize = 8;
+  octaves = 4;
+  base[0] = base[1] = base[2] = 128;
+  amount[0] = amount[1] = amount[2] = 127;
+  border = 0;
+  format = ProcTexture::FORMAT_RGBA8;
+  mipFilter = ProcTexture::MIP_BOX;
+  seed = 1;
+}
+
+void ProcTexture::FillRandomScalar(uint32_t *lanes, unsigned char *out,
+                                   int bytes) {
+  const int chunk = RANDOM_LANES * (int)sizeof(uint32_t);
+  for (int i = 0; i < bytes; i += chunk) {
+    for (int l = 0; l < RANDOM_LANES; l++) {
+      lanes[l] ^= lanes[l] << 13;
+      lanes[l] ^= lanes[l] >> 17;
+      lanes[l] ^= lanes[l] << 5;
+    }
+    memcpy(out + i, lanes, Min(chunk, bytes - i));
+  }
+}
+
+void ProcTexture::FillRandom(uint32_t *lanes, unsigned char *out, int bytes) {
+#if defined(PROC_TEX_NEON)
+  uint32x4_t s = vld1q_u32(lanes);
+  int i = 0;
+  for (; i + 16 <= bytes; i += 16) {
+    s = veorq_u32(s, vshlq_n_u32(s, 13));
+    s = veorq_u32(s, vshrq_n_u32(s, 17));
+    s = veorq_u32(s, vshlq_n_u32(s, 5));
+    vst1q_u8(out + i, vreinterpretq_u8_u32(s));
+  }
+  vst1q_u32(lanes, s);
+  FillRandomScalar(lanes, out + i, bytes - i);
+#elif defined(PROC_TEX_SSE2)
+  __m128i s = _mm_loadu_si128((const __m128i *)lanes);
+  int i = 0;
+  for (; i + 16 <= bytes; i += 16) {
+    s = _mm_xor_si128(s, _mm_slli_epi32(s, 13));
+    s = _mm_xor_si128(s, _mm_srli_epi32(s, 17));
+    s = _mm_xor_si128(s, _mm_slli_epi32(s, 5));
+    _mm_storeu_si128((__m128i *)(out + i), s);
+  }
+  _mm_storeu_si128((__m128i *)lanes, s);
+  FillRandomScalar(lanes, out + i, bytes - i);
+#else
+  FillRandomScalar(lanes, out, bytes);
+#endif
+}
+
+// size x size value noise: random values on a lattice of cellSize x cellSize
+// cells, interpolated with a smoothstep; wraps around like the texture does
+static void _value_noise(uint32_t *lanes, int size, int cellSize,
+                         unsigned char *out) {
+  cellSize = Clamp(cellSize, 1, size);
+  int grid = size / cellSize;
+  std::vector<unsigned char> lattice(grid * grid);
+  ProcTexture::FillRandom(lanes, &lattice[0], grid * grid);
+
+  // smoothstep weights, 0-256, for each position inside a cell
+  std::vector<int> w(cellSize);
+  for (int i = 0; i < cellSize; i++) {
+    float t = (float)i / cellSize;
+    w[i] = (int)(t * t * (3.0f - 2.0f * t) * 256.0f + 0.5f);
+  }
+
+  // the horizontally interpolated rows of lattice values above and below the
+  // current row (x256)
+  std::vector<int> top(size), bottom(size);
+  for (int y = 0; y < size; y++) {
+    if (y % cellSize == 0) {
+      int j = y / cellSize;
+      const unsigned char *l0 = &lattice[j * grid];
+      const unsigned char *l1 = &lattice[((j + 1) % grid) * grid];
+      for (int i = 0; i < grid; i++) {
+        int i1 = i + 1 < grid ? i + 1 : 0;
+        int t0 = l0[i], dt = l0[i1] - t0, b0 = l1[i], db = l1[i1] - b0;
+        int *t = &top[i * cellSize], *b = &bottom[i * cellSize];
+        for (int k = 0; k < cellSize; k++) {
+          t[k] = t0 * 256 + dt * w[k];
+          b[k] = b0 * 256 + db * w[k];
+        }
+      }
+    }
+    int wy = w[y % cellSize];
+    unsigned char *p = out + y * size;
+    for (int x = 0; x < size; x++) {
+      p[x] = (unsigned char)((top[x] * 256 + (bottom[x] - top[x]) * wy +
+                              32768) >> 16);
+    }
+  }
+}
+
+// the sum of `octaves` octaves of value noise, each with half the cell size
+// and half the weight of the one before
+static void _fractal_noise(uint32_t *lanes, int size, int cellSize,
+                           int octaves, unsigned char *out) {
+  // the weights add up to less than 256, so the sum fits in 16 bits
+  std::vector<unsigned short> acc(size * size, 0);
+  std::vector<unsigned char> octave(size * size);
+  int totalWeight = 0;
+  for (int o = 0; o < octaves && (cellSize >> o) > 0 && (128 >> o) > 0; o++) {
+    int weight = 128 >> o;
+    _value_noise(lanes, size, cellSize >> o, &octave[0]);
+    for (int i = 0; i < size * size; i++) {
+      acc[i] = (unsigned short)(acc[i] + octave[i] * weight);
+    }
+    totalWeight += weight;
+  }
+  int scale = totalWeight ? 65536 / totalWeight : 0;
+  for (int i = 0; i < size * size; i++) {
+    out[i] = (unsigned char)((acc[i] * scale) >> 16);
+  }
+}
+
+// RGBA8 = base + noise * amount / 255, with the border in the base color
+static void _colorize(const ProcTextureParams &params,
+                      const unsigned char *noise, unsigned char *out) {
+  // the color of each noise value, as it is laid out in memory
+  unsigned char colors[256][4];
+  for (int v = 0; v < 256; v++) {
+    for (int c = 0; c < 3; c++) {
+      int t = v * params.amount[c] + 127;
+      t = params.base[c] + ((t + 1 + (t >> 8)) >> 8);  // base + t / 255
+      colors[v][c] = (unsigned char)(t < 255 ? t : 255);
+    }
+    colors[v][3] = 255;
+  }
+  uint32_t lut[256];
+  memcpy(lut, colors, sizeof(lut));
+
+  int size = params.size, border = Min(params.border, size);
+  uint32_t *p = reinterpret_cast<uint32_t *>(out);
+  for (int y = 0; y < size; y++, p += size) {
+    const unsigned char *n = noise + y * size;
+    int x = y < border ? size : border;
+    for (int i = 0; i < x; i++) {
+      p[i] = lut[0];
+    }
+    for (; x < size; x++) {
+      p[x] = lut[n[x]];
+    }
+  }
+}
+
+void ProcTexture::DownsampleBoxScalar(const unsigned char *src, int srcSize,
+                                      unsigned char *dst) {
+  int dstSize = srcSize / 2;
+  for (int y = 0; y < dstSize; y++) {
+    const unsigned char *r0 = src + y * 2 * srcSize * 4;
+    const unsigned char *r1 = r0 + srcSize * 4;
+    unsigned char *p = dst + y * dstSize * 4;
+    for (int i = 0; i < dstSize * 4; i++) {
+      int c = (i / 4) * 8 + i % 4;  // same channel of the first pixel
+      p[i] = (unsigned char)((r0[c] + r0[c + 4] + r1[c] + r1[c + 4] + 2) >> 2);
+    }
+  }
+}
+
+#if defined(PROC_TEX_SSE2)
+// adds up the pairs of adjacent pixels in 8 RGBA8 pixels, per channel, into
+// 16-bit lanes: pairs 0-1 and 2-3 go to *lo, 4-5 and 6-7 to *hi
+static inline void _sum_pixel_pairs(const unsigned char *p, __m128i *lo,
+                                    __m128i *hi) {
+  __m128 a = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)p));
+  __m128 b = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(p + 16)));
+  __m128i even =
+      _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+  __m128i odd =
+      _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  __m128i zero = _mm_setzero_si128();
+  *lo = _mm_add_epi16(_mm_unpacklo_epi8(even, zero),
+                      _mm_unpacklo_epi8(odd, zero));
+  *hi = _mm_add_epi16(_mm_unpackhi_epi8(even, zero),
+                      _mm_unpackhi_epi8(odd, zero));
+}
+#endif
+
+void ProcTexture::DownsampleBox(const unsigned char *src, int srcSize,
+                                unsigned char *dst) {
+#if defined(PROC_TEX_NEON) || defined(PROC_TEX_SSE2)
+  int dstSize = srcSize / 2;
+  for (int y = 0; y < dstSize; y++) {
+    const unsigned char *r0 = src + y * 2 * srcSize * 4;
+    const unsigned char *r1 = r0 + srcSize * 4;
+    unsigned char *p = dst + y * dstSize * 4;
+    int x = 0;
+#if defined(PROC_TEX_NEON)
+    // 16 source pixels, split into channels, make 8 destination pixels
+    for (; x + 8 <= dstSize; x += 8) {
+      uint8x16x4_t a = vld4q_u8(r0 + x * 8);
+      uint8x16x4_t b = vld4q_u8(r1 + x * 8);
+      uint8x8x4_t d;
+      for (int c = 0; c < 4; c++) {
+        uint16x8_t sum = vpadalq_u8(vpaddlq_u8(a.val[c]), b.val[c]);
+        d.val[c] = vrshrn_n_u16(sum, 2);
+      }
+      vst4_u8(p + x * 4, d);
+    }
+#else
+    // 8 source pixels make 4 destination pixels
+    __m128i two = _mm_set1_epi16(2);
+    for (; x + 4 <= dstSize; x += 4) {
+      __m128i lo0, hi0, lo1, hi1;
+      _sum_pixel_pairs(r0 + x * 8, &lo0, &hi0);
+      _sum_pixel_pairs(r1 + x * 8, &lo1, &hi1);
+      __m128i lo = _mm_add_epi16(_mm_add_epi16(lo0, lo1), two);
+      __m128i hi = _mm_add_epi16(_mm_add_epi16(hi0, hi1), two);
+      lo = _mm_srli_epi16(lo, 2);
+      hi = _mm_srli_epi16(hi, 2);
+      _mm_storeu_si128((__m128i *)(p + x * 4), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    // whatever is left of the row
+    for (int i = x * 4; i < dstSize * 4; i++) {
+      int c = (i / 4) * 8 + i % 4;
+      p[i] = (unsigned char)((r0[c] + r0[c + 4] + r1[c] + r1[c + 4] + 2) >> 2);
+    }
+  }
+#else
+  DownsampleBoxScalar(src, srcSize, dst);
+#endif
+}
+
+// modified Bessel function of the first kind, order 0
+static float _bessel_i0(float x) {
+  float sum = 1.0f, term = 1.0f;
+  for (int k = 1; k < 20; k++) {
+    term *= (x * 0.5f / k) * (x * 0.5f / k);
+    sum += term;
+  }
+  return sum;
+}
+
+void ProcTexture::DownsampleKaiser(const unsigned char *src, int srcSize,
+                                   unsigned char *dst) {
+  // Output pixel i is centered between source pixels 2i and 2i + 1; its taps
+  // are source pixels 2i - 2 to 2i + 3, at distances -2.5 to 2.5.
+  float w[KAISER_TAPS], sum = 0.0f;
+  for (int t = 0; t < KAISER_TAPS; t++) {
+    float d = t - (KAISER_TAPS - 1) * 0.5f;
+    float x = d * 0.5f * (float)M_PI;  // sinc cutoff at the new Nyquist
+    float r = d / (KAISER_TAPS * 0.5f);
+    w[t] = (sinf(x) / x) * _bessel_i0(KAISER_BETA * sqrtf(1.0f - r * r)) /
+           _bessel_i0(KAISER_BETA);
+    sum += w[t];
+  }
+  for (int t = 0; t < KAISER_TAPS; t++) {
+    w[t] /= sum;
+  }
+
+  int dstSize = srcSize / 2, mask = srcSize - 1, rowFloats = dstSize * 4;
+  const int first = -(KAISER_TAPS / 2 - 1);
+
+  // horizontal pass into a srcSize x dstSize float image, from each row
+  // converted to floats and padded with the pixels it wraps around to
+  std::vector<float> tmp(srcSize * rowFloats);
+  std::vector<float> padded((srcSize + KAISER_TAPS) * 4);
+  for (int y = 0; y < srcSize; y++) {
+    const unsigned char *row = src + y * srcSize * 4;
+    for (int i = 0; i < srcSize + KAISER_TAPS; i++) {
+      const unsigned char *s = row + ((i + first) & mask) * 4;
+      float *f = &padded[i * 4];
+      f[0] = s[0], f[1] = s[1], f[2] = s[2], f[3] = s[3];
+    }
+    float *out = &tmp[y * rowFloats];
+    for (int x = 0; x < dstSize; x++, out += 4) {
+      const float *s = &padded[x * 8];
+      float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+      for (int t = 0; t < KAISER_TAPS; t++, s += 4) {
+        for (int c = 0; c < 4; c++) {
+          acc[c] += w[t] * s[c];
+        }
+      }
+      memcpy(out, acc, sizeof(acc));
+    }
+  }
+
+  // vertical pass, whole rows at a time
+  std::vector<float> acc(rowFloats);
+  for (int y = 0; y < dstSize; y++) {
+    memset(&acc[0], 0, rowFloats * sizeof(float));
+    for (int t = 0; t < KAISER_TAPS; t++) {
+      const float *row = &tmp[((2 * y + first + t) & mask) * rowFloats];
+      for (int i = 0; i < rowFloats; i++) {
+        acc[i] += w[t] * row[i];
+      }
+    }
+    unsigned char *p = dst + y * rowFloats;
+    for (int i = 0; i < rowFloats; i++) {
+      // the negative lobes can overshoot
+      p[i] = (unsigned char)Clamp(acc[i] + 0.5f, 0.0f, 255.0f);
+    }
+  }
+}
+
+void ProcTexture::ToRGB565(const unsigned char *src, int pixels,
+                           unsigned short *dst) {
+  for (int i = 0; i < pixels; i++, src += 4) {
+    dst[i] = (unsigned short)(((src[0] >> 3) << 11) | ((src[1] >> 2) << 5) |
+                              (src[2] >> 3));
+  }
+}
+
+ProcTexture::ProcTexture(const ProcTextureParams &params) {
+  mSize = params.size;
+  mFormat = params.format;
+
+  Rng rng(params.seed);
+  uint32_t lanes[RANDOM_LANES];
+  for (int l = 0; l < RANDOM_LANES; l++) {
+    lanes[l] = rng.Next();
+  }
+
+  int pixels = mSize * mSize;
+  std::vector<unsigned char> noise(pixels);
+  switch (params.noise) {
+    case NOISE_VALUE:
+      _value_noise(lanes, mSize, params.cellSize, &noise[0]);
+      break;
+    case NOISE_FRACTAL:
+      _fractal_noise(lanes, mSize, params.cellSize, params.octaves, &noise[0]);
+      break;
+    default:
+      FillRandom(lanes, &noise[0], pixels);
+      break;
+  }
+
+  // lay out the levels
+  int levels = 1;
+  if (params.mipFilter != MIP_NONE) {
+    while ((mSize >> (levels - 1)) > 1) levels++;
+  }
+  int total = 0;
+  for (int l = 0; l < levels; l++) {
+    mLevelOffsets.push_back(total);
+    total += GetLevelSize(l) * GetLevelSize(l) * GetBytesPerPixel();
+  }
+  mData.resize(total);
+
+  // build the chain in RGBA8, storing each level in the output format
+  std::vector<unsigned char> cur(pixels * 4), next(pixels);
+  _colorize(params, &noise[0], &cur[0]);
+  for (int l = 0; l < levels; l++) {
+    int size = GetLevelSize(l);
+    unsigned char *out = &mData[mLevelOffsets[l]];
+    if (mFormat == FORMAT_RGB565) {
+      ToRGB565(&cur[0], size * size, reinterpret_cast<unsigned short *>(out));
+    } else {
+      memcpy(out, &cur[0], size * size * 4);
+    }
+    if (l + 1 < levels) {
+      if (params.mipFilter == MIP_KAISER) {
+        DownsampleKaiser(&cur[0], size, &next[0]);
+      } else {
+        DownsampleBox(&cur[0], size, &next[0]);
+      }
+      cur.swap(next);
+    }
+  }
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef endlesstunnel_proc_texture_hpp
+#define endlesstunnel_proc_texture_hpp
+
+#include <stdint.h>
+
+#include <vector>
+
+// How to generate a ProcTexture (see ProcTexture for the constants)
+struct ProcTextureParams {
+  int size;      // width and height in pixels, a power of two
+  int noise;     // ProcTexture::NOISE_*
+  int cellSize;  // value noise: size of the lattice cells (power of two)
+  int octaves;   // fractal noise: how many octaves (each has half the cells)
+  unsigned char base[3];    // color where the noise is 0 (RGB)
+  unsigned char amount[3];  // added to base where the noise is at maximum
+  int border;  // pixels along the top and left edges drawn in the base color
+  int format;     // ProcTexture::FORMAT_*
+  int mipFilter;  // ProcTexture::MIP_*
+  uint32_t seed;
+
+  // 64x64 gray white noise, RGBA8, box filtered mipmaps
+  ProcTextureParams();
+};
+
+/* A procedurally generated texture: noise, colorized, with its whole mipmap
+ * chain, in a pixel format GL can upload as it is. Doesn't touch GL itself
+ * (see Texture::InitFromProcTexture), so it can be generated and measured on
+ * the host.
+ *
+ * The random numbers come from RANDOM_LANES independent xorshift32
+ * generators stepped together, which maps onto one SIMD register. */
+class ProcTexture {
+ public:
+  // noise types: independent random pixels; smoothly interpolated random
+  // values on a lattice; several octaves of value noise added together
+  static const int NOISE_WHITE = 0, NOISE_VALUE = 1, NOISE_FRACTAL = 2;
+
+  // pixel formats: GL_RGBA/GL_UNSIGNED_BYTE and GL_RGB/GL_UNSIGNED_SHORT_5_6_5
+  static const int FORMAT_RGBA8 = 0, FORMAT_RGB565 = 1;
+
+  // mipmap filters: level 0 only; 2x2 average; Kaiser-windowed sinc (sharper)
+  static const int MIP_NONE = 0, MIP_BOX = 1, MIP_KAISER = 2;
+
+  static const int RANDOM_LANES = 4;
+
+  explicit ProcTexture(const ProcTextureParams &params);
+
+  int GetFormat() const { return mFormat; }
+  int GetBytesPerPixel() const { return mFormat == FORMAT_RGB565 ? 2 : 4; }
+  int GetLevelCount() const { return (int)mLevelOffsets.size(); }
+  int GetLevelSize(int level) const {
+    return mSize >> level > 0 ? mSize >> level : 1;
+  }
+  const unsigned char *GetLevelData(int level) const {
+    return &mData[mLevelOffsets[level]];
+  }
+  int GetByteCount() const { return (int)mData.size(); }
+
+  // The building blocks, public so host/tex_bench can measure them and check
+  // the SIMD versions against the plain C ones.
+
+  // fills out with random bytes from the given generator lanes (a lane state
+  // must not be 0), and advances them
+  static void FillRandom(uint32_t *lanes, unsigned char *out, int bytes);
+  static void FillRandomScalar(uint32_t *lanes, unsigned char *out, int bytes);
+
+  // halves a square RGBA8 image (srcSize > 1) into dst by averaging each 2x2
+  // block, rounding to nearest
+  static void DownsampleBox(const unsigned char *src, int srcSize,
+                            unsigned char *dst);
+  static void DownsampleBoxScalar(const unsigned char *src, int srcSize,
+                                  unsigned char *dst);
+
+  // halves a square RGBA8 image (srcSize > 1) into dst with a Kaiser-windowed
+  // sinc filter, wrapping around the edges like a repeating texture
+  static void DownsampleKaiser(const unsigned char *src, int srcSize,
+                               unsigned char *dst);
+
+  // converts RGBA8 pixels to RGB565
+  static void ToRGB565(const unsigned char *src, int pixels,
+                       unsigned short *dst);
+
+ private:
+  int mSize;
+  int mFormat;
+
+  // all levels, one after the other, in mFormat
+  std::vector<unsigned char> mData;
+  std::vector<int> mLevelOffsets;
+};
+
+#endif
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sfx_mixer.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SFX_MIX_NEON
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define SFX_MIX_SSSE3
+#endif
+
+#define DEFAULT_VOLUME 0.9f
+
+static const char *_parseInt(const char *s, int *result) {
+  *result = 0;
+  while (*s >= '0' && *s <= '9') {
+    *result = *result * 10 + (*s - '0');
+    s++;
+  }
+  return s;
+}
+
+static int _synth(int frequency, int duration, float amplitude,
+                  short *sample_buf, int samples) {
+  int i;
+
+  for (i = 0; i < samples; i++) {
+    float t = i / (float)SFX_SAMPLES_PER_SEC;
+    float v;
+    if (frequency > 0) {
+      v = amplitude * sin(frequency * t * 2 * M_PI) +
+          (amplitude * 0.1f) * sin(frequency * 2 * t * 2 * M_PI);
+    } else {
+      int r = rand();
+      r = r > 0 ? r : -r;
+      v = amplitude * (-0.5f + (r % 1024) / 512.0f);
+    }
+    int value = (int)(v * 32768.0f);
+    sample_buf[i] = value < -32767 ? -32767 : value > 32767 ? 32767 : value;
+
+    if (frequency > 0 && i > 0 && sample_buf[i - 1] < 0 &&
+        sample_buf[i] >= 0) {
+      // start of new wave -- check if we have room for a full period of it
+      int period_samples = (1.0f / frequency) * SFX_SAMPLES_PER_SEC;
+      if (i + period_samples >= samples) break;
+    }
+  }
+
+  return i;
+}
+
+static void _taper(short *sample_buf, int samples) {
+  int i;
+  const float TAPER_SAMPLES_FRACTION = 0.1f;
+  int taper_samples = (int)(TAPER_SAMPLES_FRACTION * samples);
+  for (i = 0; i < taper_samples && i < samples; i++) {
+    float factor = i / (float)taper_samples;
+    sample_buf[i] = (short)((float)sample_buf[i] * factor);
+  }
+  for (i = samples - taper_samples; i < samples; i++) {
+    if (i < 0) continue;
+    float factor = (samples - i) / (float)taper_samples;
+    sample_buf[i] = (short)((float)sample_buf[i] * factor);
+  }
+}
+
+SfxTone::SfxTone(const char *tone) {
+  static short sample_buf[SFX_TONE_SAMPLES_MAX];
+  int total_samples = 0;
+  int num_samples;
+  int frequency = 100;
+  int duration = 50;
+  int volume_int;
+  float amplitude = DEFAULT_VOLUME;
+
+  while (*tone) {
+    switch (*tone) {
+      case 'f':
+        // set frequency
+        tone = _parseInt(tone + 1, &frequency);
+        break;
+      case 'd':
+        // set duration
+        tone = _parseInt(tone + 1, &duration);
+        break;
+      case 'a':
+        // set amplitude.
+        tone = _parseInt(tone + 1, &volume_int);
+        amplitude = volume_int / 100.0f;
+        amplitude = amplitude < 0.0f   ? 0.0f
+                    : amplitude > 1.0f ? 1.0f
+                                       : amplitude;
+        break;
+      case '.':
+        // synth
+        num_samples = duration * SFX_SAMPLES_PER_SEC / 1000;
+        if (num_samples > (SFX_TONE_SAMPLES_MAX - total_samples - 1)) {
+          num_samples = SFX_TONE_SAMPLES_MAX - total_samples - 1;
+        }
+        num_samples = _synth(frequency, duration, amplitude,
+                             sample_buf + total_samples, num_samples);
+        total_samples += num_samples;
+        tone++;
+        break;
+      default:
+        // ignore and advance to next character
+        tone++;
+    }
+  }
+
+  _taper(sample_buf, total_samples);
+
+  mSampleCount = total_samples;
+  mSamples = new short[total_samples > 0 ? total_samples : 1];
+  memcpy(mSamples, sample_buf, total_samples * sizeof(short));
+}
+
+SfxTone::~SfxTone() { delete[] mSamples; }
+
+SfxMixer::SfxMixer() : mQueueHead(0), mQueueTail(0), mActiveVoices(0) {
+  memset(mVoices, 0, sizeof(mVoices));
+  memset(mQueue, 0, sizeof(mQueue));
+}
+
+bool SfxMixer::Play(const SfxTone *tone, float gain) {
+  if (!tone || tone->GetSampleCount() <= 0) {
+    return true;
+  }
+  unsigned tail = mQueueTail.load(std::memory_order_relaxed);
+  if (tail - mQueueHead.load(std::memory_order_acquire) >= QUEUE_SIZE) {
+    return false;
+  }
+  gain = gain < 0.0f ? 0.0f : gain > 1.0f ? 1.0f : gain;
+  mQueue[tail % QUEUE_SIZE].tone = tone;
+  mQueue[tail % QUEUE_SIZE].gain = (int)(gain * GAIN_ONE);
+  mQueueTail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+bool SfxMixer::IsIdle() const {
+  return mActiveVoices.load(std::memory_order_relaxed) == 0 &&
+         mQueueHead.load(std::memory_order_relaxed) ==
+             mQueueTail.load(std::memory_order_relaxed);
+}
+
+void SfxMixer::StartVoice(const Request &req) {
+  int best = 0, bestLeft = -1;
+  for (int i = 0; i < MAX_VOICES; i++) {
+    if (!mVoices[i].tone) {
+      best = i;
+      break;
+    }
+    // steal the voice that is closest to finishing
+    int left = mVoices[i].tone->GetSampleCount() - mVoices[i].pos;
+    if (bestLeft < 0 || left < bestLeft) {
+      best = i;
+      bestLeft = left;
+    }
+  }
+  mVoices[best].tone = req.tone;
+  mVoices[best].pos = 0;
+  mVoices[best].gain = req.gain;
+}
+
+void SfxMixer::Mix(short *out, int samples) {
+  // pick up new play requests
+  unsigned head = mQueueHead.load(std::memory_order_relaxed);
+  unsigned tail = mQueueTail.load(std::memory_order_acquire);
+  for (; head != tail; head++) {
+    StartVoice(mQueue[head % QUEUE_SIZE]);
+  }
+  mQueueHead.store(head, std::memory_order_release);
+
+  memset(out, 0, samples * sizeof(short));
+  int active = 0;
+  for (int i = 0; i < MAX_VOICES; i++) {
+    Voice *v = &mVoices[i];
+    if (!v->tone) {
+      continue;
+    }
+    int n = v->tone->GetSampleCount() - v->pos;
+    n = n < samples ? n : samples;
+    MixVoice(out, v->tone->GetSamples() + v->pos, n, v->gain);
+    v->pos += n;
+    if (v->pos >= v->tone->GetSampleCount()) {
+      v->tone = NULL;
+    } else {
+      active++;
+    }
+  }
+  mActiveVoices.store(active, std::memory_order_relaxed);
+}
+
+static inline short _mixSample(short acc, short s, int gain) {
+  // rounding Q15 multiply followed by saturating add, same as the SIMD paths
+  int v = acc + ((s * gain + (1 << 14)) >> 15);
+  return (short)(v < -32768 ? -32768 : v > 32767 ? 32767 : v);
+}
+
+void SfxMixer::MixVoiceScalar(short *out, const short *src, int samples,
+                              int gain) {
+  for (int i = 0; i < samples; i++) {
+    out[i] = _mixSample(out[i], src[i], gain);
+  }
+}
+
+void SfxMixer::MixVoice(short *out, const short *src, int samples, int gain) {
+  int i = 0;
+#if defined(SFX_MIX_NEON)
+  int16x8_t g = vdupq_n_s16((int16_t)gain);
+  for (; i + 8 <= samples; i += 8) {
+    int16x8_t s = vqrdmulhq_s16(vld1q_s16(src + i), g);
+    vst1q_s16(out + i, vqaddq_s16(vld1q_s16(out + i), s));
+  }
+#elif defined(SFX_MIX_SSSE3)
+  __m128i g = _mm_set1_epi16((short)gain);
+  for (; i + 8 <= samples; i += 8) {
+    __m128i s = _mm_mulhrs_epi16(
+        _mm_loadu_si128((const __m128i *)(src + i)), g);
+    __m128i acc = _mm_loadu_si128((const __m128i *)(out + i));
+    _mm_storeu_si128((__m128i *)(out + i), _mm_adds_epi16(acc, s));
+  }
+#endif
+  MixVoiceScalar(out + i, src + i, samples - i, gain);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef endlesstunnel_sfx_mixer_hpp
+#define endlesstunnel_sfx_mixer_hpp
+
+#include <stdint.h>
+
+#include <atomic>
+
+// output sample rate of the sound effects (mono, 16-bit)
+#define SFX_SAMPLES_PER_SEC 8000
+
+// longest tone we synthesize
+#define SFX_TONE_SAMPLES_MAX (SFX_SAMPLES_PER_SEC * 5)  // 5 seconds
+
+/* A tone recipe (see SfxMan::PlayTone) compiled to PCM. Tones are synthesized
+ * once, when first needed, and never change afterwards, so the mixer can read
+ * them from the audio thread without locking. */
+class SfxTone {
+ private:
+  short *mSamples;
+  int mSampleCount;
+
+ public:
+  // synthesizes the given recipe
+  explicit SfxTone(const char *recipe);
+  ~SfxTone();
+
+  const short *GetSamples() const { return mSamples; }
+  int GetSampleCount() const { return mSampleCount; }
+};
+
+/* Mixes up to MAX_VOICES tones into blocks of PCM. Play() is called from the
+ * game thread and Mix() from the audio thread; the two only share a small
+ * lock-free queue of play requests. When all voices are busy, a new tone
+ * steals the voice that has the least left to play. */
+class SfxMixer {
+ public:
+  static const int MAX_VOICES = 8;
+
+  // gains are Q15 fixed point (32767 is 1.0)
+  static const int GAIN_ONE = 32767;
+
+  SfxMixer();
+
+  // starts playing the given tone at the given gain (0.0 - 1.0). The tone must
+  // outlive the mixer. Returns false if the request queue is full.
+  bool Play(const SfxTone *tone, float gain);
+
+  // is nothing playing (or about to)?
+  bool IsIdle() const;
+
+  // renders the next block of samples
+  void Mix(short *out, int samples);
+
+  // out[i] = saturate(out[i] + src[i] * gain), using SIMD where available
+  static void MixVoice(short *out, const short *src, int samples, int gain);
+
+  // plain C version of MixVoice (the reference for the SIMD versions)
+  static void MixVoiceScalar(short *out, const short *src, int samples,
+                             int gain);
+
+ private:
+  struct Voice {
+    const SfxTone *tone;  // NULL if voice is free
+    int pos;              // next sample to play
+    int gain;
+  };
+  Voice mVoices[MAX_VOICES];
+
+  // play requests, written by Play() and consumed by Mix()
+  static const unsigned QUEUE_SIZE = 16;  // must be a power of 2
+  struct Request {
+    const SfxTone *tone;
+    int gain;
+  };
+  Request mQueue[QUEUE_SIZE];
+  std::atomic<unsigned> mQueueHead;  // next request to consume
+  std::atomic<unsigned> mQueueTail;  // next free slot
+  std::atomic<int> mActiveVoices;
+
+  // assigns a voice to a request, stealing one if needed
+  void StartVoice(const Request &req);
+};
+
+#endif
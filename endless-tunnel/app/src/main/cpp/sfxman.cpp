@@ -15,15 +15,20 @@
  */
 #include "sfxman.hpp"
 
-#include <random>
+#include <cstring>
 
-#define SAMPLES_PER_SEC 8000
-#define BUF_SAMPLES_MAX SAMPLES_PER_SEC * 5  // 5 seconds
-#define DEFAULT_VOLUME 0.9f
+// the buffer queue plays blocks of this many samples, so this is (roughly)
+// the latency between PlayTone() and hearing the tone
+#define BLOCK_SAMPLES (SFX_SAMPLES_PER_SEC / 50)  // 20ms
+#define NUM_BUFFERS 2
+// a drained queue is restarted with this much silence, whose callback then
+// mixes the first blocks (the game thread never mixes)
+#define START_SAMPLES (BLOCK_SAMPLES / 4)  // 5ms
 
 static SfxMan *_instance = new SfxMan();
-static short _sample_buf[BUF_SAMPLES_MAX];
-static volatile bool _bufferActive = false;
+static short _block_buf[NUM_BUFFERS][BLOCK_SAMPLES];
+static const short _start_buf[START_SAMPLES] = {0};
+static int _next_block = 0;
 
 SfxMan *SfxMan::GetInstance() {
   return _instance ? _instance : (_instance = new SfxMan());
@@ -38,8 +43,53 @@ static bool _checkError(SLresult r, const char *what) {
   return false;
 }
 
-static void _bqPlayerCallback(SLAndroidSimpleBufferQueueItf bq, void *context) {
-  _bufferActive = false;
+void SfxMan::BufferQueueCallback(SLAndroidSimpleBufferQueueItf bq,
+                                 void *context) {
+  SfxMan *sfx = (SfxMan *)context;
+  // a block finished playing: refill the queue, unless there is nothing left
+  // to play, in which case the blocks still queued drain and it stops (only
+  // silence would follow). PlayTone() makes its request visible before it
+  // checks for a drained queue, and this checks for requests after counting
+  // the block out, so a tone is never left waiting on a stopped queue.
+  int queued = sfx->mQueuedBlocks.fetch_sub(1) - 1;
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sfx->mMixer.IsIdle()) {
+    return;
+  }
+  while (queued < NUM_BUFFERS && sfx->EnqueueNextBlock()) {
+    queued = sfx->mQueuedBlocks.fetch_add(1) + 1;
+  }
+}
+
+bool SfxMan::EnqueueNextBlock() {
+  short *block = _block_buf[_next_block];
+  _next_block = (_next_block + 1) % NUM_BUFFERS;
+  mMixer.Mix(block, BLOCK_SAMPLES);
+  SLresult result = (*mPlayerBufferQueue)
+                        ->Enqueue(mPlayerBufferQueue, block, sizeof(short) *
+                                                             BLOCK_SAMPLES);
+  if (result != SL_RESULT_SUCCESS) {
+    LOGW("SfxMan: warning: failed to enqueue buffer: %lu",
+         (unsigned long)result);
+    return false;
+  }
+  return true;
+}
+
+void SfxMan::StartQueue() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int drained = 0;
+  if (!mQueuedBlocks.compare_exchange_strong(drained, 1)) {
+    return;  // still running: its callbacks will pick up the new tone
+  }
+  SLresult result =
+      (*mPlayerBufferQueue)
+          ->Enqueue(mPlayerBufferQueue, _start_buf, sizeof(_start_buf));
+  if (result != SL_RESULT_SUCCESS) {
+    LOGW("SfxMan: warning: failed to restart buffer queue: %lu",
+         (unsigned long)result);
+    mQueuedBlocks.fetch_sub(1);
+  }
 }
 
 SfxMan::SfxMan() {
@@ -57,7 +107,10 @@ SfxMan::SfxMan() {
       SL_I3DL2_ENVIRONMENT_PRESET_STONECORRIDOR;
 
   LOGD("SfxMan: initializing.");
+  mInitOk = false;
   mPlayerBufferQueue = NULL;
+  mToneCount = 0;
+  mQueuedBlocks = 0;
 
   // create engine
   result = slCreateEngine(&engineObject, 0, NULL, 0, NULL, NULL);
@@ -101,7 +154,7 @@ SfxMan::SfxMan() {
 
   // configure audio source
   SLDataLocator_AndroidSimpleBufferQueue loc_bufq = {
-      SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, 2};
+      SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, NUM_BUFFERS};
   SLDataFormat_PCM format_pcm = {
       SL_DATAFORMAT_PCM,           1,
       SL_SAMPLINGRATE_8,           SL_PCMSAMPLEFORMAT_FIXED_16,
@@ -142,7 +195,7 @@ SfxMan::SfxMan() {
 
   // register callback on the buffer queue
   result = (*mPlayerBufferQueue)
-               ->RegisterCallback(mPlayerBufferQueue, _bqPlayerCallback, NULL);
+               ->RegisterCallback(mPlayerBufferQueue, BufferQueueCallback, this);
   if (_checkError(result, "registering callback on buffer queue")) return;
 
   // get the effect send interface
@@ -164,129 +217,41 @@ SfxMan::SfxMan() {
   mInitOk = true;
 }
 
-bool SfxMan::IsIdle() { return !_bufferActive; }
+bool SfxMan::IsIdle() { return mMixer.IsIdle(); }
 
-static const char *_parseInt(const char *s, int *result) {
-  *result = 0;
-  while (*s >= '0' && *s <= '9') {
-    *result = *result * 10 + (*s - '0');
-    s++;
-  }
-  return s;
-}
-
-static int _synth(int frequency, int duration, float amplitude,
-                  short *sample_buf, int samples) {
+const SfxTone *SfxMan::GetTone(const char *recipe) {
   int i;
-
-  for (i = 0; i < samples; i++) {
-    float t = i / (float)SAMPLES_PER_SEC;
-    float v;
-    if (frequency > 0) {
-      v = amplitude * sin(frequency * t * 2 * M_PI) +
-          (amplitude * 0.1f) * sin(frequency * 2 * t * 2 * M_PI);
-    } else {
-      int r = rand();
-      r = r > 0 ? r : -r;
-      v = amplitude * (-0.5f + (r % 1024) / 512.0f);
+  for (i = 0; i < mToneCount; i++) {
+    if (mToneRecipes[i] == recipe || 0 == strcmp(mToneRecipes[i], recipe)) {
+      return mTones[i];
     }
-    int value = (int)(v * 32768.0f);
-    sample_buf[i] = value < -32767 ? -32767 : value > 32767 ? 32767 : value;
-
-    if (i > 0 && sample_buf[i - 1] < 0 && sample_buf[i] >= 0) {
-      // start of new wave -- check if we have room for a full period of it
-      int period_samples = (1.0f / frequency) * SAMPLES_PER_SEC;
-      if (i + period_samples >= samples) break;
-    }
-  }
-
-  return i;
-}
-
-static void _taper(short *sample_buf, int samples) {
-  int i;
-  const float TAPER_SAMPLES_FRACTION = 0.1f;
-  int taper_samples = (int)(TAPER_SAMPLES_FRACTION * samples);
-  for (i = 0; i < taper_samples && i < samples; i++) {
-    float factor = i / (float)taper_samples;
-    sample_buf[i] = (short)((float)sample_buf[i] * factor);
   }
-  for (i = samples - taper_samples; i < samples; i++) {
-    if (i < 0) continue;
-    float factor = (samples - i) / (float)taper_samples;
-    sample_buf[i] = (short)((float)sample_buf[i] * factor);
+  if (mToneCount >= MAX_TONES) {
+    LOGW("SfxMan: too many different tones, not playing: %s", recipe);
+    return NULL;
   }
+  mToneRecipes[mToneCount] = recipe;
+  mTones[mToneCount] = new SfxTone(recipe);
+  return mTones[mToneCount++];
 }
 
-void SfxMan::PlayTone(const char *tone) {
+void SfxMan::PlayTone(const char *tone, float gain) {
   if (!mInitOk) {
     LOGW("SfxMan: not playing sound because initialization failed.");
     return;
   }
-  if (_bufferActive) {
-    // can't play -- the buffer is in use
-    LOGW("SfxMan: can't play tone; buffer is active.");
-    return;
-  }
 
-  // synth the tone
-  int total_samples = 0;
-  int num_samples;
-  int frequency = 100;
-  int duration = 50;
-  int volume_int;
-  float amplitude = DEFAULT_VOLUME;
-
-  while (*tone) {
-    switch (*tone) {
-      case 'f':
-        // set frequency
-        tone = _parseInt(tone + 1, &frequency);
-        break;
-      case 'd':
-        // set duration
-        tone = _parseInt(tone + 1, &duration);
-        break;
-      case 'a':
-        // set amplitude.
-        tone = _parseInt(tone + 1, &volume_int);
-        amplitude = volume_int / 100.0f;
-        amplitude = amplitude < 0.0f   ? 0.0f
-                    : amplitude > 1.0f ? 1.0f
-                                       : amplitude;
-        break;
-      case '.':
-        // synth
-        num_samples = duration * SAMPLES_PER_SEC / 1000;
-        if (num_samples > (BUF_SAMPLES_MAX - total_samples - 1)) {
-          num_samples = BUF_SAMPLES_MAX - total_samples - 1;
-        }
-        num_samples = _synth(frequency, duration, amplitude,
-                             _sample_buf + total_samples, num_samples);
-        total_samples += num_samples;
-        tone++;
-        break;
-      default:
-        // ignore and advance to next character
-        tone++;
-    }
+  const SfxTone *t = GetTone(tone);
+  if (!t) {
+    return;
   }
-
-  SLresult result;
-  int total_size = total_samples * sizeof(short);
-  if (total_size <= 0) {
+  if (t->GetSampleCount() <= 0) {
     LOGW("Tone is empty. Not playing.");
     return;
   }
-
-  _taper(_sample_buf, total_samples);
-
-  _bufferActive = true;
-  result = (*mPlayerBufferQueue)
-               ->Enqueue(mPlayerBufferQueue, _sample_buf, total_size);
-  if (result != SL_RESULT_SUCCESS) {
-    LOGW("SfxMan: warning: failed to enqueue buffer: %lu",
-         (unsigned long)result);
+  if (!mMixer.Play(t, gain)) {
+    LOGW("SfxMan: can't play tone; too many tones requested at once.");
     return;
   }
+  StartQueue();
 }
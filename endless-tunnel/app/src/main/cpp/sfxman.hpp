@@ -19,19 +19,45 @@
 #include <SLES/OpenSLES.h>
 #include <SLES/OpenSLES_Android.h>
 
+#include <atomic>
+
 #include "engine.hpp"
+#include "sfx_mixer.hpp"
 
 /* Sound effect manager. This class is a singleton that manages sound effect
  * playback. Sound effects are defined by recipes (which are strings) that
  * indicate frequencies and durations. See the PlayTone() method for more info.
- * Note: our sfx generation code is very simplistic and lacks a mixer, so
- * only one sound can be playing at any given time. This is not a problematic
- * limitation for this simple sample but, needless to say, doesn't scale well
- * to a more complex game. */
+ * Each recipe is synthesized only once, the first time it's played (or
+ * prepared), and the resulting tones are mixed in small blocks as the audio
+ * buffer queue asks for them, so up to SfxMixer::MAX_VOICES sounds can be
+ * playing at any given time. The buffer queue only runs while there is
+ * something to play: it drains once the mixer is idle, and the next
+ * PlayTone() starts it again. */
 class SfxMan {
  private:
   bool mInitOk;
   SLAndroidSimpleBufferQueueItf mPlayerBufferQueue;
+  SfxMixer mMixer;
+
+  // tones synthesized so far, and the recipes they came from (recipes are
+  // expected to be string literals, so we keep just the pointers)
+  static const int MAX_TONES = 32;
+  const char* mToneRecipes[MAX_TONES];
+  SfxTone* mTones[MAX_TONES];
+  int mToneCount;
+
+  // returns the tone for the given recipe, synthesizing it if needed
+  const SfxTone* GetTone(const char* recipe);
+
+  // blocks in the buffer queue; 0 when it has drained
+  std::atomic<int> mQueuedBlocks;
+
+  // mixes the next block and hands it to the buffer queue
+  bool EnqueueNextBlock();
+  // restarts a drained buffer queue
+  void StartQueue();
+  static void BufferQueueCallback(SLAndroidSimpleBufferQueueItf bq,
+                                  void* context);
 
  public:
   SfxMan();
@@ -55,11 +81,16 @@ class SfxMan {
    * Example: "d100 f300. d50 f250. a0 d100. a100 d50 f0."
    * This will play a 300Hz tone for 100ms, followed by a 250Hz tone
    * for 50 milliseconds, followed by 100ms of silence, followed
-   * by 50 milliseconds of loud random noise. */
-  void PlayTone(const char* tone);
+   * by 50 milliseconds of loud random noise.
+   *
+   * The gain (0.0 - 1.0) scales the whole tone. */
+  void PlayTone(const char* tone, float gain = 1.0f);
+
+  // Synthesizes a tone ahead of time, so that playing it later costs nothing.
+  void PrepareTone(const char* tone) { GetTone(tone); }
 
-  // Returns whether or not the sound effect pipeline is idle (able to play
-  // a tone right now).
+  // Returns whether or not the sound effect pipeline is idle (nothing is
+  // playing).
   bool IsIdle();
 };
 
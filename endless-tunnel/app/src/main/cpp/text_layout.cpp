@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "text_layout.hpp"
+
+#include <cstring>
+
+#define CHAR_SPACING_F 0.1f  // as a fraction of char width
+#define LINE_SPACING_F 0.1f  // as a fraction of char height
+
+GlyphAtlas::GlyphAtlas(const char *const *art, float scale, int glyphCols,
+                       int glyphRows) {
+  mCharWidth = glyphCols * scale;
+  mCharHeight = glyphRows * scale;
+  for (int i = 0; i < CHAR_CODES; i++) {
+    mFirstIndex[i] = (int)mIndices.size();
+    if (!art[i]) {
+      continue;
+    }
+    int base = GetVertexCount();
+    int first = (int)mIndices.size();
+    if (!AsciiArtToLines(art[i], scale, &mVerts, &mIndices)) {
+      // leave the glyph out
+      mVerts.resize(base * 2);
+      mIndices.resize(first);
+      continue;
+    }
+    // make the indices absolute
+    for (int j = first; j < (int)mIndices.size(); j++) {
+      mIndices[j] += (unsigned short)base;
+    }
+  }
+  mFirstIndex[CHAR_CODES] = (int)mIndices.size();
+}
+
+GlyphAtlas::GlyphAtlas(const PackedLineGeom &geom, const int *firstIndex,
+                       float scale, int glyphCols, int glyphRows) {
+  mCharWidth = glyphCols * scale;
+  mCharHeight = glyphRows * scale;
+  mVerts.reserve(geom.vertCount * 2);
+  UnpackLineVerts(geom, scale, &mVerts);
+  mIndices.assign(geom.indices, geom.indices + geom.indexCount);
+  memcpy(mFirstIndex, firstIndex, sizeof(mFirstIndex));
+}
+
+int GlyphAtlas::CountVertices(const char *str) const {
+  int count = 0;
+  for (; *str; ++str) {
+    count += GetGlyphIndexCount((int)*str);
+  }
+  return count;
+}
+
+static void _count_rows_cols(const char *p, int *outCols, int *outRows) {
+  int textCols = 0, textRows = 1;
+  int curCols = 0;
+  for (; *p; ++p) {
+    if (*p == '\n') {
+      ++textRows;
+      curCols = 0;
+    } else {
+      ++curCols;
+      if (textCols < curCols) {
+        textCols = curCols;
+      }
+    }
+  }
+  *outCols = textCols;
+  *outRows = textRows;
+}
+
+int GlyphAtlas::LayoutText(const char *str, const glm::mat4 *glyphMat,
+                           float *out) const {
+  int cols, rows;
+  _count_rows_cols(str, &cols, &rows);
+  float charSpacing = CHAR_SPACING_F * mCharWidth;
+  float lineSpacing = LINE_SPACING_F * mCharHeight;
+  float width = cols * mCharWidth + (cols - 1) * charSpacing;
+  float height = rows * mCharHeight + (rows - 1) * lineSpacing;
+  float startX = -width * 0.5f + 0.5f * mCharWidth;
+  float startY = height * 0.5f - 0.5f * mCharHeight;
+  float x = startX, y = startY;
+  float *p = out;
+
+  for (; *str; ++str) {
+    if (*str == '\n') {
+      x = startX;
+      y -= mCharHeight + lineSpacing;
+      continue;
+    }
+    int code = (int)*str;
+    int n = GetGlyphIndexCount(code);
+    const unsigned short *idx = n ? &mIndices[mFirstIndex[code]] : NULL;
+    for (int i = 0; i < n; i++, p += TEXT_VERTEX_FLOATS) {
+      float vx = mVerts[idx[i] * 2], vy = mVerts[idx[i] * 2 + 1];
+      if (glyphMat) {
+        glm::vec4 v = *glyphMat * glm::vec4(vx, vy, 0.0f, 1.0f);
+        vx = v.x, vy = v.y;
+      }
+      p[0] = x + vx;
+      p[1] = y + vy;
+      p[2] = 0.0f;
+      p[3] = p[4] = p[5] = 1.0f;  // white (the shader tints it)
+    }
+    x += mCharWidth + charSpacing;
+  }
+  return (int)(p - out) / TEXT_VERTEX_FLOATS;
+}
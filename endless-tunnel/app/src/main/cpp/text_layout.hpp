@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef endlesstunnel_text_layout_hpp
+#define endlesstunnel_text_layout_hpp
+
+#include <vector>
+
+#include "ascii_to_lines.hpp"
+#include "glm/glm.hpp"
+
+// floats per vertex of laid out text: x, y, z, r, g, b
+#define TEXT_VERTEX_FLOATS 6
+#define TEXT_VERTEX_COLOR_OFFSET 3
+
+/* The line geometry of every glyph of the font, packed into one vertex array
+ * and one index array, and the code that lays out strings with it.
+ *
+ * Text is laid out at font scale 1, centered on 0,0, as GL_LINES (two
+ * vertices per line, no indices), so a layout can be drawn at any position
+ * and size just by changing its matrix. */
+class GlyphAtlas {
+ public:
+  static const int CHAR_CODES = 128;
+
+  // builds the atlas from ASCII art (one drawing per char code, NULL for
+  // chars with no glyph); scale is the size of each character of the art,
+  // and glyphCols x glyphRows the size of a glyph, in characters
+  GlyphAtlas(const char *const *art, float scale, int glyphCols,
+             int glyphRows);
+
+  // builds the atlas from geometry precompiled by host/ascii_geom_gen; the
+  // lines of char code i are firstIndex[i] to firstIndex[i + 1] - 1
+  GlyphAtlas(const PackedLineGeom &geom, const int *firstIndex, float scale,
+             int glyphCols, int glyphRows);
+
+  // how many vertices it takes to lay out the given string
+  int CountVertices(const char *str) const;
+
+  // lays out the given string into out (which must have room for
+  // CountVertices(str) vertices); glyphMat, if not NULL, is applied to each
+  // glyph around its own center. Returns the number of vertices written.
+  int LayoutText(const char *str, const glm::mat4 *glyphMat, float *out) const;
+
+  // size of a glyph (at font scale 1)
+  float GetCharWidth() const { return mCharWidth; }
+  float GetCharHeight() const { return mCharHeight; }
+
+  int GetVertexCount() const { return (int)mVerts.size() / 2; }
+  int GetIndexCount() const { return (int)mIndices.size(); }
+
+ private:
+  // x,y of the vertices of all glyphs
+  std::vector<float> mVerts;
+
+  // pairs of (absolute) indices into mVerts, one pair per line
+  std::vector<unsigned short> mIndices;
+
+  // the lines of char code i are indices mFirstIndex[i] to
+  // mFirstIndex[i + 1] - 1
+  int mFirstIndex[CHAR_CODES + 1];
+
+  float mCharWidth, mCharHeight;
+
+  int GetGlyphIndexCount(int code) const {
+    return code >= 0 && code < CHAR_CODES
+               ? mFirstIndex[code + 1] - mFirstIndex[code]
+               : 0;
+  }
+};
+
+#endif
@@ -15,39 +15,39 @@
  */
 #include "text_renderer.hpp"
 
+#include <cstring>
+
 #include "alphabet.inl"
-#include "ascii_to_geom.hpp"
+#include "ascii_geom.inl"
 #include "util.hpp"
 
 #define ALPHABET_SCALE 0.01f
-#define CHAR_SPACING_F 0.1f  // as a fraction of char width
-#define LINE_SPACING_F 0.1f  // as a fraction of char height
 #define TEXT_LINE_WIDTH 4.0f
 
 #define CORRECTION_Y -0.02f
 
-TextRenderer::TextRenderer(TrivialShader *t) {
+TextRenderer::TextRenderer(TrivialShader *t)
+    : mAtlas(ALPHABET_GEOM, ALPHABET_GEOM_FIRST_INDEX, ALPHABET_SCALE,
+             ALPHABET_GLYPH_COLS, ALPHABET_GLYPH_ROWS) {
   mTrivialShader = t;
-  memset(mCharGeom, 0, sizeof(mCharGeom));
   mFontScale = 1.0f;
   mMatrix = glm::mat4(1.0f);
   mColor[0] = mColor[1] = mColor[2] = 1.0f;
+  memset(mLayoutCache, 0, sizeof(mLayoutCache));
+  mUseCounter = 0;
+  mStreamBuf = NULL;
 
-  LOGD("Loading alphabet glyphs.");
-  int i;
-  for (i = 0; i < CHAR_CODES; ++i) {
-    if (ALPHABET_ART[i]) {
-      LOGD("Creating glyph for chr %d.", i);
-      mCharGeom[i] = AsciiArtToGeom(ALPHABET_ART[i], ALPHABET_SCALE);
-    }
-  }
+  LOGD("Loaded alphabet glyphs: %d vertices, %d indices.",
+       mAtlas.GetVertexCount(), mAtlas.GetIndexCount());
 }
 
 TextRenderer::~TextRenderer() {
   int i;
-  for (i = 0; i < CHAR_CODES; i++) {
-    CleanUp(&mCharGeom[i]);
+  for (i = 0; i < LAYOUT_CACHE_SIZE; i++) {
+    CleanUp(&mLayoutCache[i].vbuf);
+    delete[] mLayoutCache[i].text;
   }
+  CleanUp(&mStreamBuf);
 }
 
 TextRenderer *TextRenderer::SetFontScale(float scale) {
@@ -91,51 +91,88 @@ void TextRenderer::MeasureText(const char *str, float fontScale,
   }
 }
 
+int TextRenderer::LayoutText(const char *str, const glm::mat4 *glyphMat) {
+  int vertices = mAtlas.CountVertices(str);
+  mLayoutData.resize(vertices * TEXT_VERTEX_FLOATS + 1);
+  vertices = mAtlas.LayoutText(str, glyphMat, &mLayoutData[0]);
+  return vertices * TEXT_VERTEX_FLOATS * sizeof(GLfloat);
+}
+
+VertexBuf *TextRenderer::GetCachedLayout(const char *str) {
+  int i, victim = 0;
+  ++mUseCounter;
+  for (i = 0; i < LAYOUT_CACHE_SIZE; i++) {
+    CachedLayout *e = &mLayoutCache[i];
+    if (e->text && 0 == strcmp(e->text, str)) {
+      e->lastUse = mUseCounter;
+      return e->vbuf;
+    }
+    // if we have to lay it out, replace a free entry or the least recently
+    // used one
+    if (mLayoutCache[victim].text &&
+        (!e->text || e->lastUse < mLayoutCache[victim].lastUse)) {
+      victim = i;
+    }
+  }
+
+  CachedLayout *e = &mLayoutCache[victim];
+  CleanUp(&e->vbuf);
+  delete[] e->text;
+  e->text = new char[strlen(str) + 1];
+  strcpy(e->text, str);
+  int size = LayoutText(str, NULL);
+  e->vbuf = new VertexBuf(&mLayoutData[0], size,
+                          TEXT_VERTEX_FLOATS * sizeof(GLfloat));
+  e->vbuf->SetPrimitive(GL_LINES);
+  e->vbuf->SetColorsOffset(TEXT_VERTEX_COLOR_OFFSET * sizeof(GLfloat));
+  e->lastUse = mUseCounter;
+  return e->vbuf;
+}
+
 TextRenderer *TextRenderer::RenderText(const char *str, float centerX,
                                        float centerY) {
   float aspect = SceneManager::GetInstance()->GetScreenAspect();
   glm::mat4 orthoMat = glm::ortho(0.0f, aspect, 0.0f, 1.0f);
-  glm::mat4 modelMat, mat, scaleMat;
-  int cols, rows;
+  glm::mat4 modelMat, mat;
   bool hadDepthTest;
+  VertexBuf *vbuf;
 
   centerY += CORRECTION_Y * mFontScale;
 
+  if (mMatrix == glm::mat4(1.0f)) {
+    vbuf = GetCachedLayout(str);
+  } else {
+    // the matrix applies to each glyph, so this layout is good for this
+    // draw only
+    int size = LayoutText(str, &mMatrix);
+    if (!mStreamBuf) {
+      mStreamBuf = new VertexBuf(&mLayoutData[0], size,
+                                 TEXT_VERTEX_FLOATS * sizeof(GLfloat));
+      mStreamBuf->SetPrimitive(GL_LINES);
+      mStreamBuf->SetColorsOffset(TEXT_VERTEX_COLOR_OFFSET * sizeof(GLfloat));
+    } else {
+      mStreamBuf->Update(&mLayoutData[0], size);
+    }
+    vbuf = mStreamBuf;
+  }
+  if (vbuf->GetCount() == 0) {
+    return this;
+  }
+
   glLineWidth(TEXT_LINE_WIDTH);
 
   hadDepthTest = glIsEnabled(GL_DEPTH_TEST);
   glDisable(GL_DEPTH_TEST);
 
-  mTrivialShader->SetTintColor(mColor[0], mColor[1], mColor[2]);
+  // the layout is centered on 0,0 at font scale 1
+  modelMat = glm::translate(glm::mat4(1.0f), glm::vec3(centerX, centerY, 0.0f));
+  modelMat = glm::scale(modelMat, glm::vec3(mFontScale, mFontScale, 1.0f));
+  mat = orthoMat * modelMat;
 
-  _count_rows_cols(str, &cols, &rows);
-  scaleMat =
-      glm::scale(glm::mat4(1.0f), glm::vec3(mFontScale, mFontScale, 1.0f));
-  float charWidth = ALPHABET_GLYPH_COLS * ALPHABET_SCALE * mFontScale;
-  float charHeight = ALPHABET_GLYPH_ROWS * ALPHABET_SCALE * mFontScale;
-  float charSpacing = CHAR_SPACING_F * charWidth;
-  float lineSpacing = LINE_SPACING_F * charHeight;
-  float width = cols * charWidth + (cols - 1) * charSpacing;
-  float height = rows * charHeight + (rows - 1) * lineSpacing;
-  float startX = centerX - width * 0.5f + 0.5f * charWidth;
-  float startY = centerY + height * 0.5f - 0.5f * charHeight;
-  float y = startY;
-
-  modelMat = glm::translate(glm::mat4(1.0f), glm::vec3(startX, startY, 0.0f));
-  for (; *str; ++str) {
-    if (*str == '\n') {
-      y -= charHeight + lineSpacing;
-      modelMat = glm::translate(glm::mat4(1.0f), glm::vec3(startX, y, 0.0f));
-    } else {
-      int code = (int)*str;
-      if (code >= 0 && code < CHAR_CODES && mCharGeom[code]) {
-        mat = orthoMat * modelMat * scaleMat * mMatrix;
-        mTrivialShader->RenderSimpleGeom(&mat, mCharGeom[code]);
-      }
-      modelMat = glm::translate(modelMat,
-                                glm::vec3(charWidth + charSpacing, 0.0f, 0.0f));
-    }
-  }
+  mTrivialShader->SetTintColor(mColor[0], mColor[1], mColor[2]);
+  mTrivialShader->BeginRender(vbuf);
+  mTrivialShader->Render(NULL, &mat);
+  mTrivialShader->EndRender();
 
   glLineWidth(1);
   if (hadDepthTest) {
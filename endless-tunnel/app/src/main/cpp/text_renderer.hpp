@@ -16,16 +16,43 @@
 #ifndef endlesstunnel_text_renderer_hpp
 #define endlesstunnel_text_renderer_hpp
 
+#include <vector>
+
 #include "engine.hpp"
+#include "text_layout.hpp"
 
 /* Renders text to the screen. Uses the "normalized 2D coordinate system" as
- * described in the README. */
+ * described in the README.
+ *
+ * Each string is laid out into a single vertex buffer and drawn with one call.
+ * The layouts of recently drawn strings stay on the GPU, so drawing the same
+ * string again (at any position, scale or color) doesn't lay it out again. */
 class TextRenderer {
  private:
-  static const int CHAR_CODES = 128;
-  SimpleGeom *mCharGeom[CHAR_CODES];
+  GlyphAtlas mAtlas;
   TrivialShader *mTrivialShader;
 
+  // layouts of recently drawn strings
+  static const int LAYOUT_CACHE_SIZE = 16;
+  struct CachedLayout {
+    char *text;       // NULL if entry is free
+    VertexBuf *vbuf;  // the string, laid out
+    unsigned lastUse;
+  };
+  CachedLayout mLayoutCache[LAYOUT_CACHE_SIZE];
+  unsigned mUseCounter;
+
+  // buffer for text that can't be cached (drawn with a matrix), and the
+  // working space to lay text out in
+  VertexBuf *mStreamBuf;
+  std::vector<GLfloat> mLayoutData;
+
+  // lays out the given string into mLayoutData; returns the size in bytes
+  int LayoutText(const char *str, const glm::mat4 *glyphMat);
+
+  // returns the cached layout of the given string, laying it out if needed
+  VertexBuf *GetCachedLayout(const char *str);
+
   float mFontScale;
   float mColor[3];
   glm::mat4 mMatrix;
@@ -35,6 +35,32 @@ void Texture::InitFromRawRGB(int width, int height, bool hasAlpha,
   glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+void Texture::InitFromProcTexture(const ProcTexture &tex) {
+  bool rgb565 = tex.GetFormat() == ProcTexture::FORMAT_RGB565;
+  GLenum format = rgb565 ? GL_RGB : GL_RGBA;
+  GLenum type = rgb565 ? GL_UNSIGNED_SHORT_5_6_5 : GL_UNSIGNED_BYTE;
+  bool mipmapped = tex.GetLevelCount() > 1;
+
+  glGenTextures(1, &mTextureH);
+  glBindTexture(GL_TEXTURE_2D, mTextureH);
+
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                  mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  // the smallest RGB565 levels have rows of 2 bytes
+  glPixelStorei(GL_UNPACK_ALIGNMENT, rgb565 ? 2 : 4);
+
+  for (int level = 0; level < tex.GetLevelCount(); level++) {
+    int size = tex.GetLevelSize(level);
+    glTexImage2D(GL_TEXTURE_2D, level, format, size, size, 0, format, type,
+                 tex.GetLevelData(level));
+  }
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
 void Texture::Bind(int unit) {
   glActiveTexture(unit);
   glBindTexture(GL_TEXTURE_2D, mTextureH);
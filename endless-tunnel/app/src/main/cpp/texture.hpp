@@ -17,6 +17,7 @@
 #define endlesstunnel_texture_hpp
 
 #include "common.hpp"
+#include "proc_texture.hpp"
 
 /* Represents an OpenGL texture */
 class Texture {
@@ -30,6 +31,9 @@ class Texture {
   // pixel (RGBA), otherwise it's interpreted as 3 bytes per pixel (RGB).
   void InitFromRawRGB(int width, int height, bool hasAlpha,
                       const unsigned char *data);
+
+  // Initialize from a procedural texture, with all of its mipmap levels.
+  void InitFromProcTexture(const ProcTexture &tex);
   void Bind(int unit);
   void Unbind();
 };
@@ -16,6 +16,8 @@
 #ifndef endlesstunnel_util_hpp
 #define endlesstunnel_util_hpp
 
+#include <stdint.h>
+
 #include <cmath>
 #include <ctime>
 
@@ -31,6 +33,36 @@ void CleanUp(T** pptr) {
 int Random(int uboundExclusive);
 int Random(int lbound, int uboundExclusive);
 
+/* A small seedable pseudo-random number generator (xorshift32). Unlike the
+ * global Random() functions, which share the C library's rand() state, each
+ * instance produces a sequence that depends only on its seed, so anything
+ * driven by it can be replayed exactly. */
+class Rng {
+ private:
+  uint32_t mState;
+
+ public:
+  Rng(uint32_t seed = 1) { Seed(seed); }
+
+  void Seed(uint32_t seed) { mState = seed ? seed : 0x9e3779b9u; }
+  uint32_t GetState() const { return mState; }
+
+  uint32_t Next() {
+    mState ^= mState << 13;
+    mState ^= mState >> 17;
+    mState ^= mState << 5;
+    return mState;
+  }
+
+  // same contracts as the global Random() functions
+  int Next(int uboundExclusive) {
+    return (int)(Next() % (uint32_t)uboundExclusive);
+  }
+  int Next(int lbound, int uboundExclusive) {
+    return lbound + Next(uboundExclusive - lbound);
+  }
+};
+
 template <typename T>
 T Max(T a, T b) {
   return a > b ? a : b;
@@ -21,7 +21,7 @@ VertexBuf::VertexBuf(GLfloat *geomData, int dataSize, int stride) {
   mPrimitive = GL_TRIANGLES;
   mVbo = 0;
   mStride = stride;
-  mColorsOffset = mTexCoordsOffset = 0;
+  mColorsOffset = mTexCoordsOffset = mInstanceIdsOffset = 0;
   mCount = dataSize / stride;
 
   // build VBO
@@ -31,6 +31,14 @@ VertexBuf::VertexBuf(GLfloat *geomData, int dataSize, int stride) {
   UnbindBuffer();
 }
 
+void VertexBuf::Update(GLfloat *geomData, int dataSize) {
+  MY_ASSERT(dataSize % mStride == 0);
+  mCount = dataSize / mStride;
+  BindBuffer();
+  glBufferData(GL_ARRAY_BUFFER, dataSize, geomData, GL_STREAM_DRAW);
+  UnbindBuffer();
+}
+
 void VertexBuf::BindBuffer() { glBindBuffer(GL_ARRAY_BUFFER, mVbo); }
 
 void VertexBuf::UnbindBuffer() { glBindBuffer(GL_ARRAY_BUFFER, 0); }
@@ -26,12 +26,16 @@ class VertexBuf {
   int mStride;
   int mColorsOffset;
   int mTexCoordsOffset;
+  int mInstanceIdsOffset;
   int mCount;
 
  public:
   VertexBuf(GLfloat *geomData, int dataSize, int stride);
   ~VertexBuf();
 
+  // replaces the contents of the buffer (for geometry that changes often)
+  void Update(GLfloat *geomData, int dataSize);
+
   void BindBuffer();
   void UnbindBuffer();
 
@@ -47,6 +51,11 @@ class VertexBuf {
   void SetTexCoordsOffset(int offset) { mTexCoordsOffset = offset; }
   int GetTexCoordsOffset() { return mTexCoordsOffset; }
 
+  // per-vertex instance index, for geometry replicated with ReplicateGeom()
+  bool HasInstanceIds() { return mInstanceIdsOffset > 0; }
+  void SetInstanceIdsOffset(int offset) { mInstanceIdsOffset = offset; }
+  int GetInstanceIdsOffset() { return mInstanceIdsOffset; }
+
   GLenum GetPrimitive() { return mPrimitive; }
   void SetPrimitive(GLenum primitive) { mPrimitive = primitive; }
 };
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Parses the game's ASCII art (the font in alphabet.inl and the drawings in
+// ascii_art.inl) and writes the resulting line geometry as static tables, so
+// the game only has to upload them at startup. The output is checked in as
+// data/ascii_geom.inl; the ascii_geom target of the host build regenerates it
+// and must be run after changing the art.
+//
+// usage: ascii_geom_gen out.inl
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "alphabet.inl"
+#include "ascii_art.inl"
+#include "ascii_to_lines.hpp"
+
+struct Art {
+  const char *name;
+  const char *art;
+};
+
+// the drawings in ascii_art.inl
+static const Art ARTS[] = {{"ART_LIFE", ART_LIFE}};
+
+static bool Parse(const char *name, const char *art,
+                  std::vector<signed char> *verts,
+                  std::vector<unsigned short> *indices) {
+  std::vector<float> v;
+  int base = (int)verts->size() / 2, first = (int)indices->size();
+  int row, col;
+  if (!AsciiArtToLines(art, 1.0f, &v, indices, &row, &col)) {
+    fprintf(stderr, "%s: invalid line at %d,%d\n", name, row, col);
+    return false;
+  }
+  for (size_t i = 0; i < v.size(); i++) {
+    // in units of half a character, vertices are integers
+    float h = v[i] * 2.0f;
+    if (h != floorf(h) || h < -127.0f || h > 127.0f) {
+      fprintf(stderr, "%s: drawing too big\n", name);
+      return false;
+    }
+    verts->push_back((signed char)h);
+  }
+  for (int i = first; i < (int)indices->size(); i++) {
+    (*indices)[i] += (unsigned short)base;
+  }
+  return true;
+}
+
+static void WriteTables(FILE *f, const std::string &name,
+                        const std::vector<signed char> &verts,
+                        const std::vector<unsigned short> &indices) {
+  fprintf(f, "static const signed char %s_VERTS[] = {", name.c_str());
+  for (size_t i = 0; i < verts.size(); i++) {
+    fprintf(f, "%s%d%s", i % 16 ? " " : "\n    ", verts[i],
+            i + 1 < verts.size() ? "," : "");
+  }
+  fprintf(f, "};\n\n");
+  fprintf(f, "static const unsigned short %s_INDICES[] = {", name.c_str());
+  for (size_t i = 0; i < indices.size(); i++) {
+    fprintf(f, "%s%d%s", i % 12 ? " " : "\n    ", indices[i],
+            i + 1 < indices.size() ? "," : "");
+  }
+  fprintf(f, "};\n\n");
+  fprintf(f,
+          "static const PackedLineGeom %s = {\n"
+          "    %s_VERTS, %d, %s_INDICES, %d};\n\n",
+          name.c_str(), name.c_str(), (int)verts.size() / 2, name.c_str(),
+          (int)indices.size());
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s out.inl\n", argv[0]);
+    return 1;
+  }
+
+  // the font: all glyphs share one set of tables
+  const int charCodes = sizeof(ALPHABET_ART) / sizeof(char *);
+  std::vector<signed char> verts;
+  std::vector<unsigned short> indices;
+  std::vector<int> firstIndex;
+  for (int i = 0; i < charCodes; i++) {
+    firstIndex.push_back((int)indices.size());
+    if (ALPHABET_ART[i] && !Parse("ALPHABET_ART", ALPHABET_ART[i], &verts,
+                                  &indices)) {
+      return 1;
+    }
+  }
+  firstIndex.push_back((int)indices.size());
+
+  FILE *f = fopen(argv[1], "w");
+  if (!f) {
+    fprintf(stderr, "can't write %s\n", argv[1]);
+    return 1;
+  }
+  fprintf(f,
+          "/*\n"
+          " * Copyright (C) Google Inc.\n"
+          " *\n"
+          " * Licensed under the Apache License, Version 2.0 (the "
+          "\"License\");\n"
+          " * you may not use this file except in compliance with the "
+          "License.\n"
+          " * You may obtain a copy of the License at\n"
+          " *\n"
+          " *      http://www.apache.org/licenses/LICENSE-2.0\n"
+          " *\n"
+          " * Unless required by applicable law or agreed to in writing, "
+          "software\n"
+          " * distributed under the License is distributed on an \"AS IS\" "
+          "BASIS,\n"
+          " * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or "
+          "implied.\n"
+          " * See the License for the specific language governing permissions "
+          "and\n"
+          " * limitations under the License.\n"
+          " */\n"
+          "\n"
+          "// Generated by host/ascii_geom_gen from alphabet.inl and "
+          "ascii_art.inl.\n"
+          "// DO NOT EDIT: change the art and rebuild the ascii_geom host "
+          "target.\n"
+          "\n"
+          "#ifndef _mygame_ascii_geom_inl\n"
+          "#define _mygame_ascii_geom_inl\n"
+          "\n"
+          "#include \"ascii_to_lines.hpp\"\n"
+          "\n");
+
+  WriteTables(f, "ALPHABET_GEOM", verts, indices);
+  fprintf(f,
+          "// char code i has the lines from ALPHABET_GEOM_FIRST_INDEX[i] up "
+          "to (but\n"
+          "// not including) ALPHABET_GEOM_FIRST_INDEX[i + 1]\n"
+          "static const int ALPHABET_GEOM_FIRST_INDEX[] = {");
+  for (size_t i = 0; i < firstIndex.size(); i++) {
+    fprintf(f, "%s%d%s", i % 12 ? " " : "\n    ", firstIndex[i],
+            i + 1 < firstIndex.size() ? "," : "");
+  }
+  fprintf(f, "};\n\n");
+
+  for (size_t a = 0; a < sizeof(ARTS) / sizeof(ARTS[0]); a++) {
+    verts.clear();
+    indices.clear();
+    if (!Parse(ARTS[a].name, ARTS[a].art, &verts, &indices)) {
+      fclose(f);
+      return 1;
+    }
+    WriteTables(f, std::string(ARTS[a].name) + "_GEOM", verts, indices);
+  }
+
+  fprintf(f, "#endif\n");
+  if (fclose(f)) {
+    fprintf(stderr, "can't write %s\n", argv[1]);
+    return 1;
+  }
+  return 0;
+}
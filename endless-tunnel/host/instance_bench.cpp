@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the CPU side of obstacle rendering: building the per-frame box
+// instance array that PlayScene::RenderObstacles() draws in one call, compared
+// with computing a full model-view-projection matrix for every box (which is
+// what each per-box draw call needed).
+//
+// usage: instance_bench [frames] [difficulty]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "data/our_shader.inl"
+#include "glm/gtc/matrix_transform.hpp"
+#include "obstacle_batch.hpp"
+#include "obstacle_generator.hpp"
+
+int main(int argc, char **argv) {
+  long frames = argc > 1 ? atol(argv[1]) : 1000000L;
+  int difficulty = argc > 2 ? atoi(argv[2]) : 12;
+
+  // fill the ring with obstacles of the requested difficulty
+  ObstacleGenerator gen;
+  gen.SetSeed(1);
+  gen.SetDifficulty(difficulty);
+  ObstacleRing ring;
+  Obstacle o;
+  while (!ring.IsFull()) {
+    gen.Generate(&o);
+    ring.PushBack(o);
+  }
+
+  static BoxInstance instances[OBS_MAX_BOX_INSTANCES];
+  glm::mat4 projMat = glm::perspective(RENDER_FOV, 16.0f / 9.0f,
+                                       RENDER_NEAR_CLIP, RENDER_FAR_CLIP);
+  glm::mat4 viewMat = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+                                  glm::vec3(0.0f, 0.0f, 1.0f));
+
+  // instance array, as rendered now
+  long boxes = 0;
+  float checksum = 0.0f;
+  auto start = std::chrono::steady_clock::now();
+  for (long f = 0; f < frames; f++) {
+    int n = BuildObstacleInstances(ring, (int)(f & 15), instances,
+                                   OBS_MAX_BOX_INSTANCES);
+    boxes += n;
+    checksum += instances[n / 2].y;
+  }
+  std::chrono::duration<double> instTime =
+      std::chrono::steady_clock::now() - start;
+
+  // one matrix per box, as each separate draw call needed
+  start = std::chrono::steady_clock::now();
+  for (long f = 0; f < frames; f++) {
+    for (int i = 0; i < ring.GetCount(); i++) {
+      float posY = (float)((f & 15) + i) * TUNNEL_SECTION_LENGTH;
+      for (uint32_t bits = ring.GetMask(i); bits; bits &= bits - 1) {
+        int cell = __builtin_ctz(bits);
+        int r = cell / OBS_GRID_SIZE, c = cell % OBS_GRID_SIZE;
+        glm::mat4 modelMat = glm::translate(
+            glm::mat4(1.0f), Obstacle::GetBoxCenter(c, r, posY));
+        modelMat = glm::scale(modelMat, Obstacle::GetBoxSize(c, r));
+        glm::mat4 mvpMat = projMat * viewMat * modelMat;
+        checksum += mvpMat[3][1];
+      }
+    }
+  }
+  std::chrono::duration<double> matTime =
+      std::chrono::steady_clock::now() - start;
+
+  printf("frames:            %ld (difficulty %d)\n", frames, difficulty);
+  printf("boxes per frame:   %.1f\n", (double)boxes / frames);
+  printf("instance array:    %.1f ns/frame, %.1f boxes/us\n",
+         instTime.count() * 1e9 / frames, boxes / (instTime.count() * 1e6));
+  printf("per-box matrices:  %.1f ns/frame, %.1f boxes/us\n",
+         matTime.count() * 1e9 / frames, boxes / (matTime.count() * 1e6));
+  printf("draw calls:        %d per frame (was %.1f)\n",
+         (int)((boxes / frames + OBSTACLE_SHADER_MAX_INSTANCES - 1) /
+               OBSTACLE_SHADER_MAX_INSTANCES),
+         (double)boxes / frames);
+  printf("(checksum %g)\n", checksum);
+  return 0;
+}
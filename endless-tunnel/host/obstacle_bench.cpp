@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Headless driver for the obstacle logic of the game. It flies a simulated
+// player down the tunnel for a number of frames, generating obstacles and
+// testing for collisions exactly like PlayScene does, but without rendering,
+// so the cost of the game logic can be measured on its own.
+//
+// usage: obstacle_bench [frames] [difficulty]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "game_consts.hpp"
+#include "obstacle_generator.hpp"
+#include "obstacle_ring.hpp"
+#include "util.hpp"
+
+// simulated frame rate
+#define BENCH_DELTA_T (1.0f / 60.0f)
+
+static float GetSectionCenterY(int i) {
+  return (float)i * TUNNEL_SECTION_LENGTH;
+}
+
+static float GetSectionEndY(int i) {
+  return GetSectionCenterY(i) + 0.5f * TUNNEL_SECTION_LENGTH;
+}
+
+int main(int argc, char **argv) {
+  long frames = argc > 1 ? atol(argv[1]) : 10000000L;
+  int difficulty = argc > 2 ? atoi(argv[2]) : 12;
+
+  ObstacleGenerator gen;
+  gen.SetSeed(1);
+  gen.SetDifficulty(difficulty);
+  ObstacleRing ring;
+  Obstacle o;
+
+  int firstSection = 0;
+  float x = 0.0f, y = 0.0f, z = 0.0f;
+  float targetSpeed = PLAYER_SPEED + PLAYER_SPEED_INC_PER_LEVEL * difficulty;
+  float speed = targetSpeed;
+  long crashes = 0, bonuses = 0, closeCalls = 0, generated = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (long f = 0; f < frames; f++) {
+    float previousY = y;
+
+    // wander around the tunnel cross-section
+    x = Clamp(x + (Random(3) - 1) * PLAYER_MAX_LAT_SPEED * BENCH_DELTA_T,
+              PLAYER_MIN_X, PLAYER_MAX_X);
+    z = Clamp(z + (Random(3) - 1) * PLAYER_MAX_LAT_SPEED * BENCH_DELTA_T,
+              PLAYER_MIN_Z, PLAYER_MAX_Z);
+    float accel = speed >= 0.0f ? PLAYER_ACCELERATION_POSITIVE_SPEED
+                                : PLAYER_ACCELERATION_NEGATIVE_SPEED;
+    speed = Approach(speed, targetSpeed, BENCH_DELTA_T * accel);
+    y += speed * BENCH_DELTA_T;
+
+    // shift sections
+    while (y > GetSectionEndY(firstSection) + SHIFT_THRESH) {
+      firstSection++;
+      ring.PopFront();
+    }
+
+    // generate obstacles
+    while (!ring.IsFull()) {
+      if (firstSection + ring.GetCount() < OBS_START_SECTION) {
+        o.Reset();
+      } else {
+        gen.Generate(&o);
+      }
+      ring.PushBack(o);
+      generated++;
+    }
+
+    // detect collisions
+    float obsMin = GetSectionCenterY(firstSection) - OBS_BOX_SIZE;
+    if (previousY < obsMin && y >= obsMin) {
+      int hit = ring.TestHit(0, x, z);
+      if (hit == ObstacleRing::HIT_BOX) {
+        crashes++;
+        y = obsMin - PLAYER_RECEDE_AFTER_COLLISION;
+        speed = PLAYER_SPEED_AFTER_COLLISION;
+      } else {
+        if (hit == ObstacleRing::HIT_BONUS) {
+          ring.DeleteBonus(0);
+          bonuses++;
+        }
+        if (ring.IsCloseCall(0, x, z)) {
+          closeCalls++;
+        }
+      }
+    }
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  printf("frames:       %ld (difficulty %d)\n", frames, difficulty);
+  printf("obstacles:    %ld generated\n", generated);
+  printf("crashes:      %ld\n", crashes);
+  printf("bonuses:      %ld\n", bonuses);
+  printf("close calls:  %ld\n", closeCalls);
+  printf("time:         %.3f s, %.1f ns/frame, %.2f Mframes/s\n",
+         elapsed.count(), elapsed.count() * 1e9 / frames,
+         frames / elapsed.count() * 1e-6);
+  return 0;
+}
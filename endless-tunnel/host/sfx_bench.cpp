@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the sound effect mixer: the one-time cost of synthesizing the
+// game's tones, and the per-block cost of mixing 1 to MAX_VOICES voices, with
+// the SIMD and the plain C mixing loops. It also checks that both loops
+// produce exactly the same samples.
+//
+// usage: sfx_bench [blocks]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "game_consts.hpp"
+#include "sfx_mixer.hpp"
+
+// same block size as SfxMan
+#define BLOCK_SAMPLES (SFX_SAMPLES_PER_SEC / 50)
+
+typedef void (*MixFunc)(short *, const short *, int, int);
+
+static double Seconds(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+// mixes `voices` voices into `blocks` blocks with the given loop; returns a
+// checksum of the output so the work can't be optimized away
+static unsigned MixBlocks(MixFunc mix, const SfxTone *tone, int voices,
+                          long blocks) {
+  static short out[BLOCK_SAMPLES];
+  unsigned sum = 0;
+  int len = tone->GetSampleCount() - BLOCK_SAMPLES;
+  for (long b = 0; b < blocks; b++) {
+    memset(out, 0, sizeof(out));
+    for (int v = 0; v < voices; v++) {
+      int pos = (int)((b * BLOCK_SAMPLES + v * 997) % len);
+      mix(out, tone->GetSamples() + pos, BLOCK_SAMPLES,
+          SfxMixer::GAIN_ONE / (v + 1));
+    }
+    sum += (unsigned short)out[b % BLOCK_SAMPLES];
+  }
+  return sum;
+}
+
+int main(int argc, char **argv) {
+  long blocks = argc > 1 ? atol(argv[1]) : 200000L;
+  const char *recipes[] = {TONE_LEVEL_UP, TONE_CRASHED, TONE_GAME_OVER,
+                           TONE_AMBIENT_0, TONE_AMBIENT_1};
+  const int recipeCount = sizeof(recipes) / sizeof(char *);
+
+  // synthesis (done once per recipe by SfxMan)
+  auto start = std::chrono::steady_clock::now();
+  SfxTone *tones[recipeCount];
+  int totalSamples = 0;
+  for (int i = 0; i < recipeCount; i++) {
+    tones[i] = new SfxTone(recipes[i]);
+    totalSamples += tones[i]->GetSampleCount();
+  }
+  printf("synthesis:    %d tones, %d samples, %.3f ms\n", recipeCount,
+         totalSamples, Seconds(start) * 1e3);
+
+  // the SIMD loop must match the C loop exactly, including saturation
+  const SfxTone *tone = tones[2];  // the longest one
+  static short a[SFX_TONE_SAMPLES_MAX], b[SFX_TONE_SAMPLES_MAX];
+  int n = tone->GetSampleCount();
+  for (int i = 0; i < n; i++) {
+    a[i] = b[i] = (short)(rand() - RAND_MAX / 2);
+  }
+  for (int gain = 0; gain <= SfxMixer::GAIN_ONE; gain += 4681) {
+    SfxMixer::MixVoice(a, tone->GetSamples(), n - 3, gain);
+    SfxMixer::MixVoiceScalar(b, tone->GetSamples(), n - 3, gain);
+  }
+  if (memcmp(a, b, n * sizeof(short))) {
+    printf("ERROR: SIMD and scalar mixing differ!\n");
+    return 1;
+  }
+  printf("simd check:   ok\n");
+
+  // the mixer itself, with voice stealing: ask for twice as many voices as
+  // it has, so half of the requests steal a voice
+  SfxMixer mixer;
+  static short out[BLOCK_SAMPLES];
+  start = std::chrono::steady_clock::now();
+  for (long i = 0; i < blocks; i++) {
+    if (i % 8 == 0) {
+      mixer.Play(tones[i % recipeCount], 0.5f);
+      mixer.Play(tones[(i + 1) % recipeCount], 0.5f);
+    }
+    mixer.Mix(out, BLOCK_SAMPLES);
+  }
+  double t = Seconds(start);
+  printf("mixer:        %ld blocks of %d samples, %.1f ns/block\n", blocks,
+         BLOCK_SAMPLES, t * 1e9 / blocks);
+
+  // per-voice cost
+  printf("voices   simd ns/block   C ns/block   simd ns/voice   C ns/voice\n");
+  unsigned check = 0;
+  for (int voices = 1; voices <= SfxMixer::MAX_VOICES; voices++) {
+    start = std::chrono::steady_clock::now();
+    check += MixBlocks(SfxMixer::MixVoice, tone, voices, blocks);
+    double simd = Seconds(start) * 1e9 / blocks;
+    start = std::chrono::steady_clock::now();
+    check += MixBlocks(SfxMixer::MixVoiceScalar, tone, voices, blocks);
+    double scalar = Seconds(start) * 1e9 / blocks;
+    printf("%6d %15.1f %12.1f %15.1f %12.1f\n", voices, simd, scalar,
+           simd / voices, scalar / voices);
+  }
+  printf("(checksum %08x)\n", check);
+
+  for (int i = 0; i < recipeCount; i++) {
+    delete tones[i];
+  }
+  return 0;
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Headless driver for the game simulation. By default an autopilot plays the
+// game (starting a new one, with the next seed, whenever it loses) and the
+// first game can be saved as an input trace. Given a trace -- recorded here or
+// on a device with SIM_RECORD_TRACE -- it replays it instead. Either way it
+// prints the simulation rate and a hash of the final game state, which is
+// the same on every run for the same input. game_sim.cpp is built with
+// -ffp-contract=off so that ARM and x86 builds round alike; other compilers
+// or flags (e.g. -ffast-math) may still give a different hash.
+//
+// usage: sim_bench [-n steps] [-s seed] [-l level] [-o out.trace]
+//        sim_bench -r in.trace
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "game_sim.hpp"
+
+// picks where to steer: the bonus of the next obstacle if there is one,
+// otherwise the free cell nearest to the player
+static SimInput Autopilot(const GameSim &sim) {
+  const ObstacleRing &obstacles = sim.GetObstacles();
+  const glm::vec3 &pos = sim.GetPlayerPos();
+  SimInput input;
+
+  int i = 0;
+  while (i < obstacles.GetCount() &&
+         (sim.GetFirstSection() + i) * TUNNEL_SECTION_LENGTH - OBS_BOX_SIZE <=
+             pos.y) {
+    i++;
+  }
+  if (i >= obstacles.GetCount() ||
+      obstacles.GetStyle(i) == Obstacle::STYLE_NULL) {
+    return input;
+  }
+
+  int col = Obstacle::GetColAt(pos.x), row = Obstacle::GetRowAt(pos.z);
+  if (obstacles.HasBonus(i)) {
+    col = obstacles.GetBonusCol(i);
+    row = obstacles.GetBonusRow(i);
+  } else {
+    uint32_t mask = obstacles.GetMask(i);
+    int best = -1;
+    for (int r = 0; r < OBS_GRID_SIZE; r++) {
+      for (int c = 0; c < OBS_GRID_SIZE; c++) {
+        int dist = abs(c - col) + abs(r - row);
+        if (!(mask & Obstacle::CellBit(c, r)) && (best < 0 || dist < best)) {
+          best = dist;
+          col = c;
+          row = r;
+        }
+      }
+    }
+  }
+
+  glm::vec3 target = Obstacle::GetBoxCenter(col, row, 0.0f);
+  input.steering = SimInput::STEERING_TOUCH;
+  input.steerX = target.x;
+  input.steerZ = target.z;
+  return input;
+}
+
+int main(int argc, char **argv) {
+  long steps = 1000000L;
+  uint32_t seed = 1;
+  int level = 0;
+  const char *outFile = NULL, *inFile = NULL;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "-n")) {
+      steps = atol(argv[i + 1]);
+    } else if (!strcmp(argv[i], "-s")) {
+      seed = (uint32_t)strtoul(argv[i + 1], NULL, 10);
+    } else if (!strcmp(argv[i], "-l")) {
+      level = atoi(argv[i + 1]);
+    } else if (!strcmp(argv[i], "-o")) {
+      outFile = argv[i + 1];
+    } else if (!strcmp(argv[i], "-r")) {
+      inFile = argv[i + 1];
+    } else {
+      fprintf(stderr, "unknown option: %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  SimTrace trace;
+  if (inFile) {
+    if (!trace.Load(inFile)) {
+      fprintf(stderr, "can't load trace: %s\n", inFile);
+      return 1;
+    }
+    seed = trace.seed;
+    level = trace.startLevel;
+    steps = (long)trace.inputs.size();
+  } else {
+    trace.seed = seed;
+    trace.startLevel = level;
+  }
+
+  GameSim sim;
+  sim.Reset(seed);
+  sim.SetLevel(level);
+
+  long games = 1, crashes = 0, bonuses = 0, levelUps = 0;
+  bool recording = outFile != NULL;
+  uint32_t firstGameHash = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (long s = 0; s < steps; s++) {
+    SimInput input = inFile ? trace.inputs[s] : Autopilot(sim);
+    if (recording) {
+      trace.inputs.push_back(input);
+    }
+    unsigned events = sim.Simulate(SIM_TIMESTEP, input);
+    crashes += (events & GameSim::EVENT_CRASH) ? 1 : 0;
+    bonuses += (events & GameSim::EVENT_BONUS) ? 1 : 0;
+    levelUps += (events & GameSim::EVENT_LEVEL_UP) ? 1 : 0;
+
+    if (events & GameSim::EVENT_GAME_OVER) {
+      if (games == 1) {
+        firstGameHash = sim.GetStateHash();
+      }
+      recording = false;
+      if (!inFile) {
+        sim.Reset(seed + games++);
+        sim.SetLevel(level);
+      }
+    }
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  if (games == 1) {
+    firstGameHash = sim.GetStateHash();
+  }
+
+  if (outFile && !trace.Save(outFile)) {
+    fprintf(stderr, "can't save trace: %s\n", outFile);
+    return 1;
+  }
+
+  printf("steps:        %ld (%.1f s of game time, seed %u, level %d)\n",
+         steps, steps * SIM_TIMESTEP, seed, level);
+  printf("games:        %ld\n", games);
+  printf("crashes:      %ld\n", crashes);
+  printf("bonuses:      %ld\n", bonuses);
+  printf("level ups:    %ld\n", levelUps);
+  printf("final state:  level %d, score %d, lives %d\n",
+         sim.GetDifficulty() + 1, sim.GetScore(), sim.GetLives());
+  printf("state hash:   %08x (first game), %08x (final)\n", firstGameHash,
+         sim.GetStateHash());
+  printf("time:         %.3f s, %.1f ns/step, %.0f steps/s\n",
+         elapsed.count(), elapsed.count() * 1e9 / steps,
+         steps / elapsed.count());
+  return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the procedural texture generator: the random number generator and
+// the box mipmap filter, SIMD and plain C (checking that they produce the same
+// bytes), the Kaiser filter and the RGB565 conversion, then whole textures
+// with each noise type and mipmap filter. For comparison, it also times the
+// rand() loop the game used to fill its wall texture with.
+//
+// usage: tex_bench [size] [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "proc_texture.hpp"
+
+static double Seconds(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+// what PlayScene did before ProcTexture: level 0 only, RGB, rand() per pixel
+static unsigned OldWallTexture(int size, unsigned char *out) {
+  unsigned char *p = out;
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++, p += 3) {
+      p[0] = p[1] = p[2] = 128 + ((x > 2 && y > 2) ? rand() % 128 : 0);
+    }
+  }
+  return out[size * 3 + 9];
+}
+
+int main(int argc, char **argv) {
+  int size = argc > 1 ? atoi(argv[1]) : 256;
+  long iterations = argc > 2 ? atol(argv[2]) : 200L;
+  if (size < 8 || (size & (size - 1))) {
+    fprintf(stderr, "size must be a power of two, at least 8\n");
+    return 1;
+  }
+  int pixels = size * size;
+  double mpix = (double)pixels * iterations / 1e6;
+  unsigned check = 0;
+
+  // the SIMD versions must match the C versions exactly
+  std::vector<unsigned char> a(pixels * 4), b(pixels * 4), half(pixels);
+  uint32_t lanesA[ProcTexture::RANDOM_LANES] = {1, 2, 3, 4};
+  uint32_t lanesB[ProcTexture::RANDOM_LANES] = {1, 2, 3, 4};
+  for (int i = 0; i < 3; i++) {
+    ProcTexture::FillRandom(lanesA, &a[0], pixels * 4 - 7);
+    ProcTexture::FillRandomScalar(lanesB, &b[0], pixels * 4 - 7);
+  }
+  if (a != b || memcmp(lanesA, lanesB, sizeof(lanesA))) {
+    printf("ERROR: SIMD and scalar random numbers differ!\n");
+    return 1;
+  }
+  for (int s = size; s > 1; s /= 2) {
+    ProcTexture::DownsampleBox(&a[0], s, &half[0]);
+    ProcTexture::DownsampleBoxScalar(&a[0], s, &b[0]);
+    if (memcmp(&half[0], &b[0], (s / 2) * (s / 2) * 4)) {
+      printf("ERROR: SIMD and scalar box filters differ at %d!\n", s);
+      return 1;
+    }
+  }
+  printf("simd check:   ok\n");
+
+  printf("%dx%d, %ld iterations:\n", size, size, iterations);
+  std::vector<unsigned char> rgb(pixels * 3);
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    check += OldWallTexture(size, &rgb[0]);
+  }
+  printf("  rand() loop (old):   %8.1f Mpixels/s\n", mpix / Seconds(start));
+
+  // random bytes, one per pixel as the noise needs them
+  start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    ProcTexture::FillRandom(lanesA, &a[0], pixels);
+    check += a[i % pixels];
+  }
+  printf("  random simd:         %8.1f Mpixels/s\n", mpix / Seconds(start));
+  start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    ProcTexture::FillRandomScalar(lanesA, &a[0], pixels);
+    check += a[i % pixels];
+  }
+  printf("  random C:            %8.1f Mpixels/s\n", mpix / Seconds(start));
+
+  // filters, in source pixels
+  typedef void (*DownsampleFunc)(const unsigned char *, int, unsigned char *);
+  DownsampleFunc filters[] = {ProcTexture::DownsampleBox,
+                              ProcTexture::DownsampleBoxScalar,
+                              ProcTexture::DownsampleKaiser};
+  const char *filterNames[] = {"box simd", "box C", "kaiser"};
+  for (int f = 0; f < 3; f++) {
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) {
+      filters[f](&a[0], size, &half[0]);
+      check += half[i % (pixels / 4)];
+    }
+    printf("  %-20s %8.1f Mpixels/s\n", filterNames[f],
+           mpix / Seconds(start));
+  }
+
+  std::vector<unsigned short> rgb565(pixels);
+  start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    ProcTexture::ToRGB565(&a[0], pixels, &rgb565[0]);
+    check += rgb565[i % pixels];
+  }
+  printf("  to RGB565:           %8.1f Mpixels/s\n", mpix / Seconds(start));
+
+  // whole textures, RGB565 with all levels
+  const char *noiseNames[] = {"white", "value", "fractal"};
+  const char *mipNames[] = {"no mips", "box mips", "kaiser mips"};
+  printf("textures:\n");
+  for (int n = 0; n < 3; n++) {
+    for (int m = 0; m < 3; m++) {
+      ProcTextureParams params;
+      params.size = size;
+      params.noise = n;
+      params.format = ProcTexture::FORMAT_RGB565;
+      params.mipFilter = m;
+      start = std::chrono::steady_clock::now();
+      for (long i = 0; i < iterations; i++) {
+        params.seed = (uint32_t)i + 1;
+        ProcTexture tex(params);
+        check += tex.GetLevelData(tex.GetLevelCount() - 1)[0];
+      }
+      double t = Seconds(start);
+      printf("  %-8s %-12s %8.1f us, %8.1f Mpixels/s\n", noiseNames[n],
+             mipNames[m], t * 1e6 / iterations, mpix / t);
+    }
+  }
+  printf("(checksum %08x)\n", check);
+  return 0;
+}
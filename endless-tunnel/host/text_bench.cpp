@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the text layout engine: building the glyph atlas (by parsing the
+// ASCII art font, as the game used to at startup, and from the tables that
+// host/ascii_geom_gen precompiles from it, as it does now), and laying out
+// the strings the game shows (score, signs, menus) with and without a
+// per-glyph matrix (signs are animated with one). Reports glyph vertices per
+// microsecond, and how many draw calls the same text took when each character
+// was drawn on its own.
+//
+// usage: text_bench [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "alphabet.inl"
+#include "ascii_geom.inl"
+#include "glm/gtc/matrix_transform.hpp"
+#include "strings.inl"
+#include "text_layout.hpp"
+
+// same as TextRenderer
+#define ALPHABET_SCALE 0.01f
+
+static double Seconds(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+  return d.count();
+}
+
+static const char *TEXTS[] = {"01250",         S_HOWTO_WITHOUT_JOY,
+                              S_GOT_BONUS,     S_GAME_OVER,
+                              S_OUCH,          S_CHECKPOINT_SAVED,
+                              S_UNPAUSE,       S_QUIT,
+                              S_START_OVER,    S_RESUME,
+                              S_TITLE,         "LEVEL 12"};
+static const int TEXT_COUNT = sizeof(TEXTS) / sizeof(char *);
+
+int main(int argc, char **argv) {
+  long iterations = argc > 1 ? atol(argv[1]) : 200000L;
+
+  auto start = std::chrono::steady_clock::now();
+  GlyphAtlas parsed(ALPHABET_ART, ALPHABET_SCALE, ALPHABET_GLYPH_COLS,
+                    ALPHABET_GLYPH_ROWS);
+  double parseTime = Seconds(start);
+  start = std::chrono::steady_clock::now();
+  GlyphAtlas atlas(ALPHABET_GEOM, ALPHABET_GEOM_FIRST_INDEX, ALPHABET_SCALE,
+                   ALPHABET_GLYPH_COLS, ALPHABET_GLYPH_ROWS);
+  double packedTime = Seconds(start);
+  printf("atlas:        %d vertices, %d indices\n", atlas.GetVertexCount(),
+         atlas.GetIndexCount());
+  printf("  from art:   %.1f us (parsed at startup)\n", parseTime * 1e6);
+  printf("  from table: %.1f us (precompiled)\n", packedTime * 1e6);
+
+  // both must lay out the same
+  std::vector<float> a(2 * 9 * 1024), b(2 * 9 * 1024);
+  for (int i = 0; i < 128; i++) {
+    char s[2] = {(char)i, 0};
+    int n = parsed.LayoutText(s, NULL, &a[0]);
+    if (n != atlas.LayoutText(s, NULL, &b[0]) ||
+        memcmp(&a[0], &b[0], n * TEXT_VERTEX_FLOATS * sizeof(float))) {
+      printf("ERROR: glyph %d differs from the art, regenerate "
+             "ascii_geom.inl\n", i);
+      return 1;
+    }
+  }
+
+  int maxVerts = 0, totalVerts = 0, totalChars = 0;
+  for (int i = 0; i < TEXT_COUNT; i++) {
+    int n = atlas.CountVertices(TEXTS[i]);
+    maxVerts = n > maxVerts ? n : maxVerts;
+    totalVerts += n;
+    for (const char *p = TEXTS[i]; *p; p++) {
+      totalChars += (*p != '\n' && *p != ' ') ? 1 : 0;
+    }
+  }
+  printf("strings:      %d, %d glyphs, %d vertices\n", TEXT_COUNT, totalChars,
+         totalVerts);
+  printf("draw calls:   %d (was %d, one per glyph)\n", TEXT_COUNT, totalChars);
+
+  std::vector<float> out(maxVerts * TEXT_VERTEX_FLOATS);
+  glm::mat4 signMat =
+      glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 0.5f, 1.0f));
+  const glm::mat4 *mats[] = {NULL, &signMat};
+  const char *names[] = {"plain", "glyph matrix"};
+  float check = 0.0f;
+  for (int m = 0; m < 2; m++) {
+    start = std::chrono::steady_clock::now();
+    long verts = 0;
+    for (long it = 0; it < iterations; it++) {
+      const char *text = TEXTS[it % TEXT_COUNT];
+      verts += atlas.LayoutText(text, mats[m], &out[0]);
+      check += out[it % 8];
+    }
+    double t = Seconds(start);
+    printf("%-13s %ld layouts, %.1f ns/layout, %.1f vertices/us\n", names[m],
+           iterations, t * 1e9 / iterations, verts / (t * 1e6));
+  }
+  printf("(checksum %.3f)\n", check);
+  return 0;
+}
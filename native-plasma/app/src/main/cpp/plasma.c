@@ -15,6 +15,7 @@
  *
  */
 
+#include <android/hardware_buffer.h>
 #include <android/log.h>
 #include <android_native_app_glue.h>
 #include <errno.h>
@@ -26,6 +27,8 @@
 #include <sys/time.h>
 #include <time.h>
 
+#include "plasma.h"
+
 #define LOG_TAG "libplasma"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
@@ -34,9 +37,6 @@
 /* Set to 1 to enable debug log traces. */
 #define DEBUG 0
 
-/* Set to 1 to optimize memory stores when generating plasma. */
-#define OPTIMIZE_WRITES 1
-
 /* Return current time in milliseconds */
 static double now_ms(void) {
   struct timeval tv;
@@ -44,221 +44,6 @@ static double now_ms(void) {
   return tv.tv_sec * 1000. + tv.tv_usec / 1000.;
 }
 
-/* We're going to perform computations for every pixel of the target
- * bitmap. floating-point operations are very slow on ARMv5, and not
- * too bad on ARMv7 with the exception of trigonometric functions.
- *
- * For better performance on all platforms, we're going to use fixed-point
- * arithmetic and all kinds of tricks
- */
-
-typedef int32_t Fixed;
-
-#define FIXED_BITS 16
-#define FIXED_ONE (1 << FIXED_BITS)
-#define FIXED_AVERAGE(x, y) (((x) + (y)) >> 1)
-
-#define FIXED_FROM_INT(x) ((x) << FIXED_BITS)
-#define FIXED_TO_INT(x) ((x) >> FIXED_BITS)
-
-#define FIXED_FROM_FLOAT(x) ((Fixed)((x)*FIXED_ONE))
-#define FIXED_TO_FLOAT(x) ((x) / (1. * FIXED_ONE))
-
-#define FIXED_MUL(x, y) (((int64_t)(x) * (y)) >> FIXED_BITS)
-#define FIXED_DIV(x, y) (((int64_t)(x)*FIXED_ONE) / (y))
-
-#define FIXED_DIV2(x) ((x) >> 1)
-#define FIXED_AVERAGE(x, y) (((x) + (y)) >> 1)
-
-#define FIXED_FRAC(x) ((x) & ((1 << FIXED_BITS) - 1))
-#define FIXED_TRUNC(x) ((x) & ~((1 << FIXED_BITS) - 1))
-
-#define FIXED_FROM_INT_FLOAT(x, f) (Fixed)((x) * (FIXED_ONE * (f)))
-
-typedef int32_t Angle;
-
-#define ANGLE_BITS 9
-
-#if ANGLE_BITS < 8
-#error ANGLE_BITS must be at least 8
-#endif
-
-#define ANGLE_2PI (1 << ANGLE_BITS)
-#define ANGLE_PI (1 << (ANGLE_BITS - 1))
-#define ANGLE_PI2 (1 << (ANGLE_BITS - 2))
-#define ANGLE_PI4 (1 << (ANGLE_BITS - 3))
-
-#define ANGLE_FROM_FLOAT(x) (Angle)((x)*ANGLE_PI / M_PI)
-#define ANGLE_TO_FLOAT(x) ((x)*M_PI / ANGLE_PI)
-
-#if ANGLE_BITS <= FIXED_BITS
-#define ANGLE_FROM_FIXED(x) (Angle)((x) >> (FIXED_BITS - ANGLE_BITS))
-#define ANGLE_TO_FIXED(x) (Fixed)((x) << (FIXED_BITS - ANGLE_BITS))
-#else
-#define ANGLE_FROM_FIXED(x) (Angle)((x) << (ANGLE_BITS - FIXED_BITS))
-#define ANGLE_TO_FIXED(x) (Fixed)((x) >> (ANGLE_BITS - FIXED_BITS))
-#endif
-
-static Fixed angle_sin_tab[ANGLE_2PI + 1];
-
-static void init_angles(void) {
-  int nn;
-  for (nn = 0; nn < ANGLE_2PI + 1; nn++) {
-    double radians = nn * M_PI / ANGLE_PI;
-    angle_sin_tab[nn] = FIXED_FROM_FLOAT(sin(radians));
-  }
-}
-
-static __inline__ Fixed angle_sin(Angle a) {
-  return angle_sin_tab[(uint32_t)a & (ANGLE_2PI - 1)];
-}
-
-static __inline__ Fixed angle_cos(Angle a) { return angle_sin(a + ANGLE_PI2); }
-
-static __inline__ Fixed fixed_sin(Fixed f) {
-  return angle_sin(ANGLE_FROM_FIXED(f));
-}
-
-static __inline__ Fixed fixed_cos(Fixed f) {
-  return angle_cos(ANGLE_FROM_FIXED(f));
-}
-
-/* Color palette used for rendering the plasma */
-#define PALETTE_BITS 8
-#define PALETTE_SIZE (1 << PALETTE_BITS)
-
-#if PALETTE_BITS > FIXED_BITS
-#error PALETTE_BITS must be smaller than FIXED_BITS
-#endif
-
-static uint16_t palette[PALETTE_SIZE];
-
-static uint16_t make565(int red, int green, int blue) {
-  return (uint16_t)(((red << 8) & 0xf800) | ((green << 3) & 0x07e0) |
-                    ((blue >> 3) & 0x001f));
-}
-
-static void init_palette(void) {
-  int nn, mm = 0;
-  /* fun with colors */
-  for (nn = 0; nn < PALETTE_SIZE / 4; nn++) {
-    int jj = (nn - mm) * 4 * 255 / PALETTE_SIZE;
-    palette[nn] = make565(255, jj, 255 - jj);
-  }
-
-  for (mm = nn; nn < PALETTE_SIZE / 2; nn++) {
-    int jj = (nn - mm) * 4 * 255 / PALETTE_SIZE;
-    palette[nn] = make565(255 - jj, 255, jj);
-  }
-
-  for (mm = nn; nn < PALETTE_SIZE * 3 / 4; nn++) {
-    int jj = (nn - mm) * 4 * 255 / PALETTE_SIZE;
-    palette[nn] = make565(0, 255 - jj, 255);
-  }
-
-  for (mm = nn; nn < PALETTE_SIZE; nn++) {
-    int jj = (nn - mm) * 4 * 255 / PALETTE_SIZE;
-    palette[nn] = make565(jj, 0, 255);
-  }
-}
-
-static __inline__ uint16_t palette_from_fixed(Fixed x) {
-  if (x < 0) x = -x;
-  if (x >= FIXED_ONE) x = FIXED_ONE - 1;
-  int idx = FIXED_FRAC(x) >> (FIXED_BITS - PALETTE_BITS);
-  return palette[idx & (PALETTE_SIZE - 1)];
-}
-
-/* Angles expressed as fixed point radians */
-
-static void init_tables(void) {
-  init_palette();
-  init_angles();
-}
-
-static void fill_plasma(ANativeWindow_Buffer* buffer, double t) {
-  Fixed yt1 = FIXED_FROM_FLOAT(t / 1230.);
-  Fixed yt2 = yt1;
-  Fixed xt10 = FIXED_FROM_FLOAT(t / 3000.);
-  Fixed xt20 = xt10;
-
-#define YT1_INCR FIXED_FROM_FLOAT(1 / 100.)
-#define YT2_INCR FIXED_FROM_FLOAT(1 / 163.)
-
-  void* pixels = buffer->bits;
-  // LOGI("width=%d height=%d stride=%d format=%d", buffer->width,
-  // buffer->height,
-  //         buffer->stride, buffer->format);
-
-  int yy;
-  for (yy = 0; yy < buffer->height; yy++) {
-    uint16_t* line = (uint16_t*)pixels;
-    Fixed base = fixed_sin(yt1) + fixed_sin(yt2);
-    Fixed xt1 = xt10;
-    Fixed xt2 = xt20;
-
-    yt1 += YT1_INCR;
-    yt2 += YT2_INCR;
-
-#define XT1_INCR FIXED_FROM_FLOAT(1 / 173.)
-#define XT2_INCR FIXED_FROM_FLOAT(1 / 242.)
-
-#if OPTIMIZE_WRITES
-    /* optimize memory writes by generating one aligned 32-bit store
-     * for every pair of pixels.
-     */
-    uint16_t* line_end = line + buffer->width;
-
-    if (line < line_end) {
-      if (((uint32_t)(uintptr_t)line & 3) != 0) {
-        Fixed ii = base + fixed_sin(xt1) + fixed_sin(xt2);
-
-        xt1 += XT1_INCR;
-        xt2 += XT2_INCR;
-
-        line[0] = palette_from_fixed(ii >> 2);
-        line++;
-      }
-
-      while (line + 2 <= line_end) {
-        Fixed i1 = base + fixed_sin(xt1) + fixed_sin(xt2);
-        xt1 += XT1_INCR;
-        xt2 += XT2_INCR;
-
-        Fixed i2 = base + fixed_sin(xt1) + fixed_sin(xt2);
-        xt1 += XT1_INCR;
-        xt2 += XT2_INCR;
-
-        uint32_t pixel = ((uint32_t)palette_from_fixed(i1 >> 2) << 16) |
-                         (uint32_t)palette_from_fixed(i2 >> 2);
-
-        ((uint32_t*)line)[0] = pixel;
-        line += 2;
-      }
-
-      if (line < line_end) {
-        Fixed ii = base + fixed_sin(xt1) + fixed_sin(xt2);
-        line[0] = palette_from_fixed(ii >> 2);
-        line++;
-      }
-    }
-#else  /* !OPTIMIZE_WRITES */
-    int xx;
-    for (xx = 0; xx < buffer->width; xx++) {
-      Fixed ii = base + fixed_sin(xt1) + fixed_sin(xt2);
-
-      xt1 += XT1_INCR;
-      xt2 += XT2_INCR;
-
-      line[xx] = palette_from_fixed(ii / 4);
-    }
-#endif /* !OPTIMIZE_WRITES */
-
-    // go to next line
-    pixels = (uint16_t*)pixels + buffer->stride;
-  }
-}
-
 /* simple stats management */
 typedef struct {
   double renderTime;
@@ -354,6 +139,27 @@ struct engine {
   int animating;
 };
 
+/*
+ * The plasma format of a window format, and its bytes per pixel, so that
+ * plasma_fill() draws in the window's own format; -1 for the formats it
+ * doesn't draw.
+ */
+static int window_plasma_format(int32_t format, int32_t* bytes_per_pixel) {
+  switch (format) {
+    case WINDOW_FORMAT_RGB_565:
+      *bytes_per_pixel = 2;
+      return PLASMA_FORMAT_RGB565;
+    case WINDOW_FORMAT_RGBA_8888:
+    case WINDOW_FORMAT_RGBX_8888:
+      *bytes_per_pixel = 4;
+      return PLASMA_FORMAT_RGBX8888;
+    case AHARDWAREBUFFER_FORMAT_R16G16B16A16_FLOAT:
+      *bytes_per_pixel = 8;
+      return PLASMA_FORMAT_RGBA_F16;
+  }
+  return -1;
+}
+
 static int64_t start_ms;
 static void engine_draw_frame(struct engine* engine) {
   if (engine->app->window == NULL) {
@@ -367,6 +173,14 @@ static void engine_draw_frame(struct engine* engine) {
     return;
   }
 
+  int32_t bytes_per_pixel;
+  int format = window_plasma_format(buffer.format, &bytes_per_pixel);
+  if (format < 0) {
+    LOGW("Unsupported window format %d", buffer.format);
+    ANativeWindow_unlockAndPost(engine->app->window);
+    return;
+  }
+
   stats_startFrame(&engine->stats);
 
   struct timespec now;
@@ -376,7 +190,10 @@ static void engine_draw_frame(struct engine* engine) {
   time_ms -= start_ms;
 
   /* Now fill the values with a nice little plasma */
-  fill_plasma(&buffer, time_ms);
+  PlasmaSurface surface = {buffer.bits, buffer.width, buffer.height,
+                           buffer.stride * bytes_per_pixel,
+                           (PlasmaFormat)format};
+  plasma_fill(&surface, time_ms);
 
   ANativeWindow_unlockAndPost(engine->app->window);
 
@@ -403,16 +220,20 @@ static int32_t engine_handle_input(struct android_app* app,
 }
 
 static void engine_handle_cmd(struct android_app* app, int32_t cmd) {
-  static int32_t format = WINDOW_FORMAT_RGB_565;
+  static int32_t format = WINDOW_FORMAT_RGBX_8888;
   struct engine* engine = (struct engine*)app->userData;
+  int32_t bytes_per_pixel;
   switch (cmd) {
     case APP_CMD_INIT_WINDOW:
       if (engine->app->window != NULL) {
-        // fill_plasma() assumes 565 format, get it here
+        // plasma_fill() draws in the window's format, with no conversion;
+        // only a format it doesn't draw is changed, to RGBX_8888
         format = ANativeWindow_getFormat(app->window);
-        ANativeWindow_setBuffersGeometry(
-            app->window, ANativeWindow_getWidth(app->window),
-            ANativeWindow_getHeight(app->window), WINDOW_FORMAT_RGB_565);
+        if (window_plasma_format(format, &bytes_per_pixel) < 0) {
+          ANativeWindow_setBuffersGeometry(
+              app->window, ANativeWindow_getWidth(app->window),
+              ANativeWindow_getHeight(app->window), WINDOW_FORMAT_RGBX_8888);
+        }
         engine_draw_frame(engine);
       }
       break;
@@ -441,7 +262,7 @@ void android_main(struct android_app* state) {
   engine.app = state;
 
   if (!init) {
-    init_tables();
+    plasma_init();
     init = 1;
   }
 
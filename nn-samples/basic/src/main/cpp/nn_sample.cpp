@@ -43,7 +43,8 @@ Java_com_example_android_basic_MainActivity_initModel(JNIEnv *env,
     return 0;
   }
   env->ReleaseStringUTFChars(_assetName, assetName);
-  SimpleModel *nn_model = new SimpleModel(asset);
+  // Run the model on the CPU if NNAPI cannot compile it.
+  SimpleModel *nn_model = new SimpleModel(asset, /*cpuFallback=*/true);
   AAsset_close(asset);
   if (!nn_model->CreateCompiledModel()) {
     __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
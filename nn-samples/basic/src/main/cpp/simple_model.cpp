@@ -21,6 +21,7 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <string>
 
 namespace {
@@ -77,11 +78,29 @@ ANeuralNetworksMemory *createMemoryFromAsset(AAsset *asset) {
  *
  * Initialize the member variables, including the shared memory objects.
  */
-SimpleModel::SimpleModel(AAsset *asset)
-    : model_(nullptr), compilation_(nullptr), dimLength_(TENSOR_SIZE) {
+SimpleModel::SimpleModel(AAsset *asset, bool cpuFallback)
+    : model_(nullptr),
+      compilation_(nullptr),
+      dimLength_(TENSOR_SIZE),
+      cpuFallback_(cpuFallback) {
   tensorSize_ = dimLength_;
   inputTensor1_.resize(tensorSize_);
 
+  // Keep the values of the constant tensors (tensor0 and tensor2) for the CPU
+  // executor, then read the asset again from its start.
+  if (cpuFallback_) {
+    modelData_.resize(tensorSize_ * 2);
+    size_t length = modelData_.size() * sizeof(float);
+    if (AAsset_read(asset, modelData_.data(), length) !=
+        static_cast<int>(length)) {
+      __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                          "Failed to read the model data for the CPU executor");
+      modelData_.clear();
+      cpuFallback_ = false;
+    }
+    AAsset_seek(asset, 0, SEEK_SET);
+  }
+
   // Create ANeuralNetworksMemory from a file containing the trained data.
   memoryModel_ = createMemoryFromAsset(asset);
 
@@ -389,7 +408,7 @@ bool SimpleModel::CreateCompiledModel() {
   if (status != ANEURALNETWORKS_NO_ERROR) {
     __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
                         "ANeuralNetworksCompilation_create failed");
-    return false;
+    return CreateCpuModel();
   }
 
   // Set the preference for the compilation, so that the runtime and drivers
@@ -401,7 +420,7 @@ bool SimpleModel::CreateCompiledModel() {
   if (status != ANEURALNETWORKS_NO_ERROR) {
     __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
                         "ANeuralNetworksCompilation_setPreference failed");
-    return false;
+    return CreateCpuModel();
   }
 
   // Finish the compilation.
@@ -409,7 +428,7 @@ bool SimpleModel::CreateCompiledModel() {
   if (status != ANEURALNETWORKS_NO_ERROR) {
     __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
                         "ANeuralNetworksCompilation_finish failed");
-    return false;
+    return CreateCpuModel();
   }
 
   return true;
@@ -427,6 +446,12 @@ bool SimpleModel::Compute(float inputValue1, float inputValue2, float *result) {
     return false;
   }
 
+  // Without a compilation, the model runs on the CPU executor.
+  if (cpuModel_) {
+    return ComputeOnCpu(inputValue1, inputValue2) &&
+           ValidateOutput((inputValue1 + 0.5f) * (inputValue2 + 0.5f), result);
+  }
+
   // Create an ANeuralNetworksExecution object from the compiled model.
   // Note:
   //   1. All the input and output data are tied to the ANeuralNetworksExecution
@@ -521,7 +546,14 @@ bool SimpleModel::Compute(float inputValue1, float inputValue2, float *result) {
   ANeuralNetworksExecution_free(execution);
 
   // Validate the results.
-  const float goldenRef = (inputValue1 + 0.5f) * (inputValue2 + 0.5f);
+  return ValidateOutput((inputValue1 + 0.5f) * (inputValue2 + 0.5f), result);
+}
+
+/**
+ * Check every element of the output tensor is goldenRef, logging the ones
+ * that are not, and return the first one in result.
+ */
+bool SimpleModel::ValidateOutput(float goldenRef, float *result) {
   float *outputTensorPtr = reinterpret_cast<float *>(
       mmap(nullptr, tensorSize_ * sizeof(float), PROT_READ, MAP_SHARED,
            outputTensorFd_, 0));
@@ -537,7 +569,99 @@ bool SimpleModel::Compute(float inputValue1, float inputValue2, float *result) {
   }
   *result = outputTensorPtr[0];
   munmap(outputTensorPtr, tensorSize_ * sizeof(float));
-  return result;
+  return true;
+}
+
+/**
+ * Describe the graph of CreateCompiledModel() to the CPU executor, which runs
+ * it when NNAPI fails to compile it. The operands and operations are added in
+ * the same order, so they have the same indexes; the constant tensors get the
+ * same values, from the asset, which the executor copies.
+ *
+ * @return true for success, false otherwise (or without cpuFallback)
+ */
+bool SimpleModel::CreateCpuModel() {
+  if (!cpuFallback_) {
+    return false;
+  }
+  __android_log_print(ANDROID_LOG_WARN, LOG_TAG,
+                      "NNAPI could not compile the model, running it on the "
+                      "CPU executor instead");
+
+  auto model = std::make_unique<nn_cpu::Model>();
+  const std::vector<uint32_t> dimensions = {dimLength_};
+  const int32_t fusedActivationCodeValue = nn_cpu::kFusedNone;
+  const uint32_t fusedActivationFuncNone = 0, tensor0 = 1, tensor1 = 2,
+                 tensor2 = 3, tensor3 = 4, intermediateOutput0 = 5,
+                 intermediateOutput1 = 6, multiplierOutput = 7;
+  bool built =
+      model->AddOperand(nn_cpu::kInt32) &&
+      model->SetOperandValue(fusedActivationFuncNone,
+                             &fusedActivationCodeValue,
+                             sizeof(fusedActivationCodeValue)) &&
+      model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&
+      model->SetOperandValue(tensor0, modelData_.data(),
+                             tensorSize_ * sizeof(float)) &&
+      model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&
+      model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&
+      model->SetOperandValue(tensor2, modelData_.data() + tensorSize_,
+                             tensorSize_ * sizeof(float)) &&
+      model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&
+      model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&
+      model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&
+      model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&
+      model->AddOperation(nn_cpu::kAdd,
+                          {tensor0, tensor1, fusedActivationFuncNone},
+                          {intermediateOutput0}) &&
+      model->AddOperation(nn_cpu::kAdd,
+                          {tensor2, tensor3, fusedActivationFuncNone},
+                          {intermediateOutput1}) &&
+      model->AddOperation(
+          nn_cpu::kMul,
+          {intermediateOutput0, intermediateOutput1, fusedActivationFuncNone},
+          {multiplierOutput}) &&
+      model->IdentifyInputsAndOutputs({tensor1, tensor3}, {multiplierOutput}) &&
+      model->Finish();
+  if (!built) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "Failed to build the model for the CPU executor");
+    return false;
+  }
+  cpuModel_ = std::move(model);
+  return true;
+}
+
+/**
+ * Compute with the CPU executor, from the same input tensors to the same
+ * output tensor as with NNAPI.
+ *
+ * @return true for success, false otherwise
+ */
+bool SimpleModel::ComputeOnCpu(float inputValue1, float inputValue2) {
+  std::fill(inputTensor1_.begin(), inputTensor1_.end(), inputValue1);
+  float *inputTensor2Ptr = reinterpret_cast<float *>(
+      mmap(nullptr, tensorSize_ * sizeof(float), PROT_READ | PROT_WRITE,
+           MAP_SHARED, inputTensor2Fd_, 0));
+  float *outputTensorPtr = reinterpret_cast<float *>(
+      mmap(nullptr, tensorSize_ * sizeof(float), PROT_READ | PROT_WRITE,
+           MAP_SHARED, outputTensorFd_, 0));
+  bool computed = false;
+  if (inputTensor2Ptr != MAP_FAILED && outputTensorPtr != MAP_FAILED) {
+    std::fill(inputTensor2Ptr, inputTensor2Ptr + tensorSize_, inputValue2);
+    computed = cpuModel_->Compute({inputTensor1_.data(), inputTensor2Ptr},
+                                  {outputTensorPtr});
+  }
+  if (inputTensor2Ptr != MAP_FAILED) {
+    munmap(inputTensor2Ptr, tensorSize_ * sizeof(float));
+  }
+  if (outputTensorPtr != MAP_FAILED) {
+    munmap(outputTensorPtr, tensorSize_ * sizeof(float));
+  }
+  if (!computed) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "The CPU executor failed to compute");
+  }
+  return computed;
 }
 
 /**
@@ -20,8 +20,11 @@
 #include <android/NeuralNetworks.h>
 #include <android/asset_manager_jni.h>
 
+#include <memory>
 #include <vector>
 
+#include "cpu_executor.h"
+
 #define FLOAT_EPISILON (1e-6)
 #define TENSOR_SIZE 200
 #define LOG_TAG "NNAPI_BASIC"
@@ -37,16 +40,22 @@
  *       dimLength x dimLength
  *   with NO fused_activation operation
  *
+ * With cpuFallback, a model NNAPI fails to compile runs on the CPU executor
+ * of common/nn-cpu-executor instead.
  */
 class SimpleModel {
  public:
-  explicit SimpleModel(AAsset *asset);
+  explicit SimpleModel(AAsset *asset, bool cpuFallback = false);
   ~SimpleModel();
 
   bool CreateCompiledModel();
   bool Compute(float inputValue1, float inputValue2, float *result);
 
  private:
+  bool CreateCpuModel();
+  bool ComputeOnCpu(float inputValue1, float inputValue2);
+  bool ValidateOutput(float goldenRef, float *result);
+
   ANeuralNetworksModel *model_;
   ANeuralNetworksCompilation *compilation_;
   ANeuralNetworksMemory *memoryModel_;
@@ -59,6 +68,12 @@ class SimpleModel {
   std::vector<float> inputTensor1_;
   int inputTensor2Fd_;
   int outputTensorFd_;
+
+  // The CPU fallback: the constants of the model, read from the asset, and
+  // the model, once NNAPI has failed to compile it.
+  bool cpuFallback_;
+  std::vector<float> modelData_;
+  std::unique_ptr<nn_cpu::Model> cpuModel_;
 };
 
 #endif  // NNAPI_SIMPLE_MODEL_H
\ No newline at end of file
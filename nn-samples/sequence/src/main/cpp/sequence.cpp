@@ -31,7 +31,8 @@ extern "C" JNIEXPORT jlong JNICALL
 Java_com_example_android_sequence_MainActivity_initModel(JNIEnv* env,
                                                          jobject /* this */,
                                                          jfloat ratio) {
-  auto model = SimpleSequenceModel::Create(ratio);
+  // Run the model on the CPU if NNAPI cannot compile it.
+  auto model = SimpleSequenceModel::Create(ratio, /*cpuFallback=*/true);
   if (model == nullptr) {
     __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
                         "Failed to create the model.");
@@ -71,10 +71,17 @@ static void fillMemory(int fd, uint32_t size, float value) {
  *
  * @return A pointer to the created model on success, nullptr otherwise
  */
-std::unique_ptr<SimpleSequenceModel> SimpleSequenceModel::Create(float ratio) {
+std::unique_ptr<SimpleSequenceModel> SimpleSequenceModel::Create(
+    float ratio, bool cpuFallback) {
   auto model = std::make_unique<SimpleSequenceModel>(ratio);
-  if (model->CreateSharedMemories() && model->CreateModel() &&
-      model->CreateCompilation() && model->CreateOpaqueMemories()) {
+  if (!model->CreateSharedMemories() || !model->CreateModel()) {
+    return nullptr;
+  }
+  if (model->CreateCompilation() && model->CreateOpaqueMemories()) {
+    return model;
+  }
+  // NNAPI cannot run the model: run it on the CPU executor, if allowed.
+  if (cpuFallback && model->CreateCpuModel()) {
     return model;
   }
   return nullptr;
@@ -622,6 +629,11 @@ bool SimpleSequenceModel::Compute(float initialValue, uint32_t steps,
     return true;
   }
 
+  // Without a compilation, the model runs on the CPU executor.
+  if (cpuModel_) {
+    return ComputeOnCpu(initialValue, steps, result);
+  }
+
   // Setup initial values.
   // In reality, the values in the shared memory region will be manipulated by
   // other modules or processes.
@@ -699,6 +711,83 @@ bool SimpleSequenceModel::Compute(float initialValue, uint32_t steps,
   return true;
 }
 
+/**
+ * Describe the graph of CreateModel() to the CPU executor, which runs it when
+ * NNAPI fails to compile it. The operands and operations are added in the
+ * same order, so they have the same indexes, and the ratio tensor gets the
+ * same value.
+ *
+ * @return true for success, false otherwise
+ */
+bool SimpleSequenceModel::CreateCpuModel() {
+  __android_log_print(ANDROID_LOG_WARN, LOG_TAG,
+                      "NNAPI could not compile the model, running it on the "
+                      "CPU executor instead");
+
+  auto model = std::make_unique<nn_cpu::Model>();
+  const std::vector<uint32_t> dimensions = {dimLength_, dimLength_};
+  const std::vector<float> ratioValue(tensorSize_, ratio_);
+  const int32_t fusedActivationCodeValue = nn_cpu::kFusedNone;
+  const uint32_t fusedActivationFuncNone = 0, sumIn = 1, stateIn = 2,
+                 ratio = 3, sumOut = 4, stateOut = 5;
+  bool built =
+      model->AddOperand(nn_cpu::kInt32) &&
+      model->SetOperandValue(fusedActivationFuncNone,
+                             &fusedActivationCodeValue,
+                             sizeof(fusedActivationCodeValue)) &&
+      model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&
+      model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&
+      model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&
+      model->SetOperandValue(ratio, ratioValue.data(),
+                             tensorSize_ * sizeof(float)) &&
+      model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&
+      model->AddOperand(nn_cpu::kTensorFloat32, dimensions) &&
+      model->AddOperation(nn_cpu::kAdd,
+                          {sumIn, stateIn, fusedActivationFuncNone},
+                          {sumOut}) &&
+      model->AddOperation(nn_cpu::kMul,
+                          {stateIn, ratio, fusedActivationFuncNone},
+                          {stateOut}) &&
+      model->IdentifyInputsAndOutputs({sumIn, stateIn}, {sumOut, stateOut}) &&
+      model->Finish();
+  if (!built) {
+    __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                        "Failed to build the model for the CPU executor");
+    return false;
+  }
+  cpuModel_ = std::move(model);
+  cpuSumIn_.resize(tensorSize_);
+  cpuSumOut_.resize(tensorSize_);
+  cpuStateIn_.resize(tensorSize_);
+  cpuStateOut_.resize(tensorSize_);
+  return true;
+}
+
+/**
+ * Compute the steps one after the other with the CPU executor, the outputs of
+ * a step being the inputs of the next one.
+ *
+ * @return true for success, false otherwise
+ */
+bool SimpleSequenceModel::ComputeOnCpu(float initialValue, uint32_t steps,
+                                       float* result) {
+  std::fill(cpuSumIn_.begin(), cpuSumIn_.end(), 0.0f);
+  std::fill(cpuStateIn_.begin(), cpuStateIn_.end(), initialValue);
+  for (uint32_t i = 0; i < steps; i++) {
+    if (!cpuModel_->Compute({cpuSumIn_.data(), cpuStateIn_.data()},
+                            {cpuSumOut_.data(), cpuStateOut_.data()})) {
+      __android_log_print(ANDROID_LOG_ERROR, LOG_TAG,
+                          "The CPU executor failed to compute step %u", i);
+      return false;
+    }
+    std::swap(cpuSumIn_, cpuSumOut_);
+    std::swap(cpuStateIn_, cpuStateOut_);
+  }
+  // after the last swap, the last sums are the inputs of a next step
+  *result = cpuSumIn_[0];
+  return true;
+}
+
 /**
  * SimpleSequenceModel Destructor.
  *
@@ -21,6 +21,9 @@
 #include <android/NeuralNetworks.h>
 
 #include <memory>
+#include <vector>
+
+#include "cpu_executor.h"
 
 /**
  * SimpleSequenceModel
@@ -39,10 +42,13 @@
  * This graph is used for computing a single step of accumulating a finite
  * geometry progression.
  *
+ * With cpuFallback, a model NNAPI fails to compile runs on the CPU executor
+ * of common/nn-cpu-executor instead.
  */
 class SimpleSequenceModel {
  public:
-  static std::unique_ptr<SimpleSequenceModel> Create(float ratio);
+  static std::unique_ptr<SimpleSequenceModel> Create(float ratio,
+                                                     bool cpuFallback = false);
 
   // Prefer using SimpleSequenceModel::Create.
   explicit SimpleSequenceModel(float ratio);
@@ -55,6 +61,8 @@ class SimpleSequenceModel {
   bool CreateModel();
   bool CreateCompilation();
   bool CreateOpaqueMemories();
+  bool CreateCpuModel();
+  bool ComputeOnCpu(float initialValue, uint32_t steps, float* result);
 
   ANeuralNetworksModel* model_ = nullptr;
   ANeuralNetworksCompilation* compilation_ = nullptr;
@@ -80,6 +88,11 @@ class SimpleSequenceModel {
   ANeuralNetworksMemory* memoryOpaqueStateOut_ = nullptr;
   ANeuralNetworksMemory* memoryOpaqueSumIn_ = nullptr;
   ANeuralNetworksMemory* memoryOpaqueSumOut_ = nullptr;
+
+  // The CPU fallback, once NNAPI has failed to compile the model, with the
+  // tensors its steps swap as the opaque memories are.
+  std::unique_ptr<nn_cpu::Model> cpuModel_;
+  std::vector<float> cpuSumIn_, cpuSumOut_, cpuStateIn_, cpuStateOut_;
 };
 
 #define LOG_TAG "NNAPI_SEQUENCE"
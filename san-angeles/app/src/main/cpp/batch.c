@@ -0,0 +1,175 @@
+/* San Angeles Observation OpenGL ES version example
+ * Copyright 2004-2005 Jetro Lauha
+ * All rights reserved.
+ * Web: http://iki.fi/jetro/
+ *
+ * This source is free software; you can redistribute it and/or
+ * modify it under the terms of EITHER:
+ *   (1) The GNU Lesser General Public License as published by the Free
+ *       Software Foundation; either version 2.1 of the License, or (at
+ *       your option) any later version. The text of the GNU Lesser
+ *       General Public License is included with this source in the
+ *       file LICENSE-LGPL.txt.
+ *   (2) The BSD-style license that is included with this source in
+ *       the file LICENSE-BSD.txt.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files
+ * LICENSE-LGPL.txt and LICENSE-BSD.txt for more details.
+ */
+
+#include "batch.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#undef PI
+#define PI 3.1415926535897932
+#define MAX_BATCH_VERTICES 65536
+
+// Capped conversion from a 16.16 value to fixed.
+static GLfixed capFixed(double value) {
+  if (value < -2147483648.0) value = -2147483648.0;
+  if (value > 2147483647.0) value = 2147483647.0;
+  return (GLfixed)value;
+}
+
+// Largest coordinate of the vertices of instance, moved into place.
+static double instanceExtent(const GLINSTANCE *instance) {
+  const GLOBJECT *object = instance->object;
+  double extent = 0;
+  long i;
+  for (i = 0; i < object->count * 3; ++i) {
+    double value = fabs(object->vertexArray[i] / 65536.);
+    if (value > extent) extent = value;
+  }
+  // turned, x and y can reach sqrt(2) times the largest of them
+  extent *= 1.4143 * instance->scale;
+  return extent + fabs(instance->x) + fabs(instance->y) + fabs(instance->z);
+}
+
+// Copies instance into batch: its vertices from vertex first on, and its
+// indices from index firstIndex on. Positions are divided by the batch's
+// vertex scale.
+static void appendInstance(GLOBJECT *batch, const GLINSTANCE *instance,
+                           long first, long firstIndex) {
+  const GLOBJECT *object = instance->object;
+  const double radians = instance->rotation * PI / 180;
+  const double c = cos(radians), s = sin(radians);
+  const double toBatch = 65536. / batch->vertexScale;
+  const double scale = instance->scale * toBatch;
+  long v, i;
+
+  for (v = 0; v < object->count; ++v) {
+    const GLfixed *vertex = &object->vertexArray[v * 3];
+    const GLfixed *normal = &object->normalArray[v * 3];
+    GLfixed *toVertex = &batch->vertexArray[(first + v) * 3];
+    GLfixed *toNormal = &batch->normalArray[(first + v) * 3];
+    const double x = vertex[0] * scale;
+    const double y = vertex[1] * scale;
+    const double z = vertex[2] * scale;
+    double nx, ny, nz, length;
+
+    toVertex[0] = capFixed(c * x - s * y + instance->x * 65536 * toBatch);
+    toVertex[1] = capFixed(s * x + c * y + instance->y * 65536 * toBatch);
+    toVertex[2] = capFixed(z + instance->z * 65536 * toBatch);
+    /* The normals only turn, as the scale is uniform. GL_NORMALIZE would
+     * make them unit length anyway: they are stored so, as short ones
+     * would lose their direction turned and rounded to fixed.
+     */
+    nx = c * normal[0] - s * normal[1];
+    ny = s * normal[0] + c * normal[1];
+    nz = normal[2];
+    length = sqrt(nx * nx + ny * ny + nz * nz);
+    if (length > 0) length = 65536 / length;
+    toNormal[0] = capFixed(nx * length);
+    toNormal[1] = capFixed(ny * length);
+    toNormal[2] = capFixed(nz * length);
+  }
+  memcpy(&batch->colorArray[first * 4], object->colorArray,
+         object->count * 4 * sizeof(GLubyte));
+  for (i = 0; i < object->indexCount; ++i) {
+    batch->indexArray[firstIndex + i] =
+        (GLushort)(first + object->indexArray[i]);
+  }
+}
+
+void freeBatches(GLOBJECT **batches, int batchCount) {
+  int a;
+  if (batches == NULL) return;
+  for (a = 0; a < batchCount; ++a) freeGLObject(batches[a]);
+  free(batches);
+}
+
+GLOBJECT **createBatches(const GLINSTANCE *instances, int count,
+                         int *batchCount) {
+  const GLINSTANCE **order;
+  GLOBJECT **batches;
+  int grouped = 0, start = 0, a, b;
+
+  *batchCount = 0;
+  order = (const GLINSTANCE **)malloc(count * sizeof(*order));
+  // at most one batch per instance
+  batches = (GLOBJECT **)calloc(count, sizeof(*batches));
+  if (order == NULL || batches == NULL) {
+    free(order);
+    free(batches);
+    return NULL;
+  }
+
+  /* Group the instances by object, in the order the objects first appear.
+   * All the objects have the same material (their vertex colors are the
+   * material, through GL_COLOR_MATERIAL), so this is all the grouping
+   * they need.
+   */
+  for (a = 0; a < count; ++a) {
+    for (b = 0; b < a && instances[b].object != instances[a].object; ++b) {
+    }
+    if (b < a) continue;  // grouped with the first one of its object
+    for (b = a; b < count; ++b) {
+      if (instances[b].object == instances[a].object)
+        order[grouped++] = &instances[b];
+    }
+  }
+
+  while (start < count) {
+    long vertices = 0, indices = 0, first = 0, firstIndex = 0;
+    double extent = 0;
+    int end = start;
+    GLOBJECT *batch;
+
+    while (end < count &&
+           vertices + order[end]->object->count <= MAX_BATCH_VERTICES) {
+      double instance = instanceExtent(order[end]);
+      if (instance > extent) extent = instance;
+      vertices += order[end]->object->count;
+      indices += order[end]->object->indexCount;
+      ++end;
+    }
+    batch = end > start ? newGLObject(vertices, 3, 1, indices) : NULL;
+    if (batch == NULL) {
+      freeBatches(batches, *batchCount);
+      free(order);
+      *batchCount = 0;
+      return NULL;
+    }
+    /* Positions too far for GL_FIXED (a few shapes have points at its
+     * limit, which the instance scale takes further) are stored divided
+     * by a power of two, which drawing multiplies back.
+     */
+    while (extent * 65536 / batch->vertexScale >= 32767)
+      batch->vertexScale *= 2;
+    for (a = start; a < end; ++a) {
+      appendInstance(batch, order[a], first, firstIndex);
+      first += order[a]->object->count;
+      firstIndex += order[a]->object->indexCount;
+    }
+    batches[(*batchCount)++] = batch;
+    start = end;
+  }
+
+  free(order);
+  return batches;
+}
@@ -0,0 +1,56 @@
+/* San Angeles Observation OpenGL ES version example
+ * Copyright 2004-2005 Jetro Lauha
+ * All rights reserved.
+ * Web: http://iki.fi/jetro/
+ *
+ * This source is free software; you can redistribute it and/or
+ * modify it under the terms of EITHER:
+ *   (1) The GNU Lesser General Public License as published by the Free
+ *       Software Foundation; either version 2.1 of the License, or (at
+ *       your option) any later version. The text of the GNU Lesser
+ *       General Public License is included with this source in the
+ *       file LICENSE-LGPL.txt.
+ *   (2) The BSD-style license that is included with this source in
+ *       the file LICENSE-BSD.txt.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files
+ * LICENSE-LGPL.txt and LICENSE-BSD.txt for more details.
+ */
+
+#ifndef BATCH_H_INCLUDED
+#define BATCH_H_INCLUDED
+
+#include "supershape.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* One placed copy of an indexed object with normals: scaled by scale,
+ * rotated by rotation degrees about the z axis, then moved to (x, y, z),
+ * as glTranslate(), glRotate() and glScale() in that order would.
+ */
+typedef struct {
+  const GLOBJECT *object;
+  float x, y, z;
+  float rotation;
+  float scale;
+} GLINSTANCE;
+
+/* Transforms the instances on the CPU and merges them into as few objects
+ * as the GLushort indices allow (65536 vertices each), the instances of an
+ * object next to each other. Drawn with the matrix the instances were
+ * placed in, they draw what the instances drew one by one. Returns the
+ * batches and their number in batchCount, or NULL.
+ */
+extern GLOBJECT **createBatches(const GLINSTANCE *instances, int count,
+                                int *batchCount);
+extern void freeBatches(GLOBJECT **batches, int batchCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !BATCH_H_INCLUDED
@@ -28,9 +28,11 @@
 #include <stdlib.h>
 
 #include "app.h"
+#include "batch.h"
 #include "cams.h"
 #include "importgl.h"
 #include "shapes.h"
+#include "supershape.h"
 
 // Total run length is 20 * camera track base unit length (see cams.h).
 #define RUN_LENGTH (20 * CAMTRACK_LEN)
@@ -56,25 +58,6 @@ static long floatToFixed(float value) {
 
 #define FIXED(value) floatToFixed(value)
 
-// Definition of one GL object in this demo.
-typedef struct {
-  /* Vertex array and color array are enabled for all objects, so their
-   * pointers must always be valid and non-NULL. Normal array is not
-   * used by the ground plane, so when its pointer is NULL then normal
-   * array usage is disabled.
-   *
-   * Vertex array is supposed to use GL_FIXED datatype and stride 0
-   * (i.e. tightly packed array). Color array is supposed to have 4
-   * components per color with GL_UNSIGNED_BYTE datatype and stride 0.
-   * Normal array is supposed to use GL_FIXED datatype and stride 0.
-   */
-  GLfixed *vertexArray;
-  GLubyte *colorArray;
-  GLfixed *normalArray;
-  GLint vertexComponents;
-  GLsizei count;
-} GLOBJECT;
-
 static long sStartTick = 0;
 static long sTick = 0;
 
@@ -85,39 +68,12 @@ static long sNextCamTrackStartTick = 0x7fffffff;
 static GLOBJECT *sSuperShapeObjects[SUPERSHAPE_COUNT] = {NULL};
 static GLOBJECT *sGroundPlane = NULL;
 
-typedef struct {
-  float x, y, z;
-} VECTOR3;
-
-static void freeGLObject(GLOBJECT *object) {
-  if (object == NULL) return;
-  free(object->normalArray);
-  free(object->colorArray);
-  free(object->vertexArray);
-  free(object);
-}
-
-static GLOBJECT *newGLObject(long vertices, int vertexComponents,
-                             int useNormalArray) {
-  GLOBJECT *result;
-  result = (GLOBJECT *)malloc(sizeof(GLOBJECT));
-  if (result == NULL) return NULL;
-  result->count = vertices;
-  result->vertexComponents = vertexComponents;
-  result->vertexArray =
-      (GLfixed *)malloc(vertices * vertexComponents * sizeof(GLfixed));
-  result->colorArray = (GLubyte *)malloc(vertices * 4 * sizeof(GLubyte));
-  if (useNormalArray) {
-    result->normalArray = (GLfixed *)malloc(vertices * 3 * sizeof(GLfixed));
-  } else
-    result->normalArray = NULL;
-  if (result->vertexArray == NULL || result->colorArray == NULL ||
-      (useNormalArray && result->normalArray == NULL)) {
-    freeGLObject(result);
-    return NULL;
-  }
-  return result;
-}
+// The buildings of the city, which never move, in a few large objects.
+#define CITY_SIZE 5  // buildings from -CITY_SIZE to CITY_SIZE on x and y
+#define CITY_SPACING 9
+#define BUILDING_COUNT ((2 * CITY_SIZE + 1) * (2 * CITY_SIZE + 1))
+static GLOBJECT **sCityBatches = NULL;
+static int sCityBatchCount = 0;
 
 static void drawGLObject(GLOBJECT *object) {
   assert(object != NULL);
@@ -134,163 +90,16 @@ static void drawGLObject(GLOBJECT *object) {
     glEnableClientState(GL_NORMAL_ARRAY);
   } else
     glDisableClientState(GL_NORMAL_ARRAY);
-  glDrawArrays(GL_TRIANGLES, 0, object->count);
-}
-
-static void vector3Sub(VECTOR3 *dest, VECTOR3 *v1, VECTOR3 *v2) {
-  dest->x = v1->x - v2->x;
-  dest->y = v1->y - v2->y;
-  dest->z = v1->z - v2->z;
-}
-
-static void superShapeMap(VECTOR3 *point, float r1, float r2, float t,
-                          float p) {
-  // sphere-mapping of supershape parameters
-  point->x = (float)(cos(t) * cos(p) / r1 / r2);
-  point->y = (float)(sin(t) * cos(p) / r1 / r2);
-  point->z = (float)(sin(p) / r2);
-}
-
-static float ssFunc(const float t, const float *p) {
-  return (float)(pow(pow(fabs(cos(p[0] * t / 4)) / p[1], p[4]) +
-                         pow(fabs(sin(p[0] * t / 4)) / p[2], p[5]),
-                     1 / p[3]));
-}
-
-// Creates and returns a supershape object.
-// Based on Paul Bourke's POV-Ray implementation.
-// http://astronomy.swin.edu.au/~pbourke/povray/supershape/
-static GLOBJECT *createSuperShape(const float *params) {
-  const int resol1 = (int)params[SUPERSHAPE_PARAMS - 3];
-  const int resol2 = (int)params[SUPERSHAPE_PARAMS - 2];
-  // latitude 0 to pi/2 for no mirrored bottom
-  // (latitudeBegin==0 for -pi/2 to pi/2 originally)
-  const int latitudeBegin = resol2 / 4;
-  const int latitudeEnd = resol2 / 2;  // non-inclusive
-  const int longitudeCount = resol1;
-  const int latitudeCount = latitudeEnd - latitudeBegin;
-  const long triangleCount = longitudeCount * latitudeCount * 2;
-  const long vertices = triangleCount * 3;
-  GLOBJECT *result;
-  float baseColor[3];
-  int a, longitude, latitude;
-  long currentVertex, currentQuad;
-
-  result = newGLObject(vertices, 3, 1);
-  if (result == NULL) return NULL;
-
-  for (a = 0; a < 3; ++a) baseColor[a] = ((randomUInt() % 155) + 100) / 255.f;
-
-  currentQuad = 0;
-  currentVertex = 0;
-
-  // longitude -pi to pi
-  for (longitude = 0; longitude < longitudeCount; ++longitude) {
-    // latitude 0 to pi/2
-    for (latitude = latitudeBegin; latitude < latitudeEnd; ++latitude) {
-      float t1 = -PI + longitude * 2 * PI / resol1;
-      float t2 = -PI + (longitude + 1) * 2 * PI / resol1;
-      float p1 = -PI / 2 + latitude * 2 * PI / resol2;
-      float p2 = -PI / 2 + (latitude + 1) * 2 * PI / resol2;
-      float r0, r1, r2, r3;
-
-      r0 = ssFunc(t1, params);
-      r1 = ssFunc(p1, &params[6]);
-      r2 = ssFunc(t2, params);
-      r3 = ssFunc(p2, &params[6]);
-
-      if (r0 != 0 && r1 != 0 && r2 != 0 && r3 != 0) {
-        VECTOR3 pa, pb, pc, pd;
-        VECTOR3 v1, v2, n;
-        float ca;
-        int i;
-        // float lenSq, invLenSq;
-
-        superShapeMap(&pa, r0, r1, t1, p1);
-        superShapeMap(&pb, r2, r1, t2, p1);
-        superShapeMap(&pc, r2, r3, t2, p2);
-        superShapeMap(&pd, r0, r3, t1, p2);
-
-        // kludge to set lower edge of the object to fixed level
-        if (latitude == latitudeBegin + 1) pa.z = pb.z = 0;
-
-        vector3Sub(&v1, &pb, &pa);
-        vector3Sub(&v2, &pd, &pa);
-
-        // Calculate normal with cross product.
-        /*   i    j    k      i    j
-         * v1.x v1.y v1.z | v1.x v1.y
-         * v2.x v2.y v2.z | v2.x v2.y
-         */
-
-        n.x = v1.y * v2.z - v1.z * v2.y;
-        n.y = v1.z * v2.x - v1.x * v2.z;
-        n.z = v1.x * v2.y - v1.y * v2.x;
-
-        /* Pre-normalization of the normals is disabled here because
-         * they will be normalized anyway later due to automatic
-         * normalization (GL_NORMALIZE). It is enabled because the
-         * objects are scaled with glScale.
-         */
-        /*
-        lenSq = n.x * n.x + n.y * n.y + n.z * n.z;
-        invLenSq = (float)(1 / sqrt(lenSq));
-        n.x *= invLenSq;
-        n.y *= invLenSq;
-        n.z *= invLenSq;
-        */
-
-        ca = pa.z + 0.5f;
-
-        for (i = currentVertex * 3; i < (currentVertex + 6) * 3; i += 3) {
-          result->normalArray[i] = FIXED(n.x);
-          result->normalArray[i + 1] = FIXED(n.y);
-          result->normalArray[i + 2] = FIXED(n.z);
-        }
-        for (i = currentVertex * 4; i < (currentVertex + 6) * 4; i += 4) {
-          int a, color[3];
-          for (a = 0; a < 3; ++a) {
-            color[a] = (int)(ca * baseColor[a] * 255);
-            if (color[a] > 255) color[a] = 255;
-          }
-          result->colorArray[i] = (GLubyte)color[0];
-          result->colorArray[i + 1] = (GLubyte)color[1];
-          result->colorArray[i + 2] = (GLubyte)color[2];
-          result->colorArray[i + 3] = 0;
-        }
-        result->vertexArray[currentVertex * 3] = FIXED(pa.x);
-        result->vertexArray[currentVertex * 3 + 1] = FIXED(pa.y);
-        result->vertexArray[currentVertex * 3 + 2] = FIXED(pa.z);
-        ++currentVertex;
-        result->vertexArray[currentVertex * 3] = FIXED(pb.x);
-        result->vertexArray[currentVertex * 3 + 1] = FIXED(pb.y);
-        result->vertexArray[currentVertex * 3 + 2] = FIXED(pb.z);
-        ++currentVertex;
-        result->vertexArray[currentVertex * 3] = FIXED(pd.x);
-        result->vertexArray[currentVertex * 3 + 1] = FIXED(pd.y);
-        result->vertexArray[currentVertex * 3 + 2] = FIXED(pd.z);
-        ++currentVertex;
-        result->vertexArray[currentVertex * 3] = FIXED(pb.x);
-        result->vertexArray[currentVertex * 3 + 1] = FIXED(pb.y);
-        result->vertexArray[currentVertex * 3 + 2] = FIXED(pb.z);
-        ++currentVertex;
-        result->vertexArray[currentVertex * 3] = FIXED(pc.x);
-        result->vertexArray[currentVertex * 3 + 1] = FIXED(pc.y);
-        result->vertexArray[currentVertex * 3 + 2] = FIXED(pc.z);
-        ++currentVertex;
-        result->vertexArray[currentVertex * 3] = FIXED(pd.x);
-        result->vertexArray[currentVertex * 3 + 1] = FIXED(pd.y);
-        result->vertexArray[currentVertex * 3 + 2] = FIXED(pd.z);
-        ++currentVertex;
-      }  // r0 && r1 && r2 && r3
-      ++currentQuad;
-    }  // latitude
-  }    // longitude
-
-  // Set number of vertices in object to the actual amount created.
-  result->count = currentVertex;
-
-  return result;
+  if (object->vertexScale != 1 << 16) {
+    glPushMatrix();
+    glScalex(object->vertexScale, object->vertexScale, object->vertexScale);
+  }
+  if (object->indexArray) {
+    glDrawElements(GL_TRIANGLES, object->indexCount, GL_UNSIGNED_SHORT,
+                   object->indexArray);
+  } else
+    glDrawArrays(GL_TRIANGLES, 0, object->count);
+  if (object->vertexScale != 1 << 16) glPopMatrix();
 }
 
 static GLOBJECT *createGroundPlane() {
@@ -303,7 +112,7 @@ static GLOBJECT *createGroundPlane() {
   int x, y;
   long currentVertex, currentQuad;
 
-  result = newGLObject(vertices, 2, 0);
+  result = newGLObject(vertices, 2, 0, 0);
   if (result == NULL) return NULL;
 
   currentQuad = 0;
@@ -391,9 +200,32 @@ static void drawFadeQuad() {
   }
 }
 
+// Places the buildings of the city: shape, rotation and scale drawn from
+// the random numbers of seed 9.
+static void placeBuildings(GLINSTANCE *buildings) {
+  int x, y;
+
+  seedRandom(9);
+
+  for (y = -CITY_SIZE; y <= CITY_SIZE; ++y) {
+    for (x = -CITY_SIZE; x <= CITY_SIZE; ++x) {
+      int curShape = randomUInt() % SUPERSHAPE_COUNT;
+      buildings->object = sSuperShapeObjects[curShape];
+      buildings->x = (float)(x * CITY_SPACING);
+      buildings->y = (float)(y * CITY_SPACING);
+      buildings->z = 0;
+      buildings->rotation = (float)(randomUInt() % 360);
+      buildings->scale = sSuperShapeParams[curShape][SUPERSHAPE_PARAMS - 1];
+      ++buildings;
+    }
+  }
+}
+
 // Called from the app framework.
 void appInit() {
-  int a;
+  float baseColors[SUPERSHAPE_COUNT][3];
+  GLINSTANCE buildings[BUILDING_COUNT];
+  int a, b;
 
   glEnable(GL_NORMALIZE);
   glEnable(GL_DEPTH_TEST);
@@ -410,17 +242,30 @@ void appInit() {
 
   seedRandom(15);
 
+  // base colors in the order of the random numbers, then the shapes in
+  // parallel
   for (a = 0; a < SUPERSHAPE_COUNT; ++a) {
-    sSuperShapeObjects[a] = createSuperShape(sSuperShapeParams[a]);
-    assert(sSuperShapeObjects[a] != NULL);
+    for (b = 0; b < 3; ++b)
+      baseColors[a][b] = ((randomUInt() % 155) + 100) / 255.f;
   }
+  createSuperShapes(sSuperShapeObjects, sSuperShapeParams,
+                    (const float(*)[3])baseColors, SUPERSHAPE_COUNT, 0);
+  for (a = 0; a < SUPERSHAPE_COUNT; ++a) assert(sSuperShapeObjects[a] != NULL);
   sGroundPlane = createGroundPlane();
   assert(sGroundPlane != NULL);
+
+  // the city is transformed once here, instead of a draw per building
+  placeBuildings(buildings);
+  sCityBatches = createBatches(buildings, BUILDING_COUNT, &sCityBatchCount);
+  assert(sCityBatches != NULL);
 }
 
 // Called from the app framework.
 void appDeinit() {
   int a;
+  freeBatches(sCityBatches, sCityBatchCount);
+  sCityBatches = NULL;
+  sCityBatchCount = 0;
   for (a = 0; a < SUPERSHAPE_COUNT; ++a) freeGLObject(sSuperShapeObjects[a]);
   freeGLObject(sGroundPlane);
 }
@@ -477,32 +322,12 @@ static void configureLightAndMaterial() {
 }
 
 static void drawModels(float zScale) {
-  const int translationScale = 9;
-  int x, y;
-
-  seedRandom(9);
+  const int translationScale = CITY_SPACING;
+  int a, x;
 
   glScalex(1 << 16, 1 << 16, (GLfixed)(zScale * 65536));
 
-  for (y = -5; y <= 5; ++y) {
-    for (x = -5; x <= 5; ++x) {
-      float buildingScale;
-      GLfixed fixedScale;
-
-      int curShape = randomUInt() % SUPERSHAPE_COUNT;
-      buildingScale = sSuperShapeParams[curShape][SUPERSHAPE_PARAMS - 1];
-      fixedScale = (GLfixed)(buildingScale * 65536);
-
-      glPushMatrix();
-      glTranslatex((x * translationScale) * 65536,
-                   (y * translationScale) * 65536, 0);
-      glRotatex((GLfixed)((randomUInt() % 360) << 16), 0, 0, 1 << 16);
-      glScalex(fixedScale, fixedScale, fixedScale);
-
-      drawGLObject(sSuperShapeObjects[curShape]);
-      glPopMatrix();
-    }
-  }
+  for (a = 0; a < sCityBatchCount; ++a) drawGLObject(sCityBatches[a]);
 
   for (x = -2; x <= 2; ++x) {
     const int shipScale100 = translationScale * 500;
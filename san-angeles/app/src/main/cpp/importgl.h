@@ -97,6 +97,8 @@ FNDEF(void, glColorPointer,
 FNDEF(void, glDisable, (GLenum cap));
 FNDEF(void, glDisableClientState, (GLenum array));
 FNDEF(void, glDrawArrays, (GLenum mode, GLint first, GLsizei count));
+FNDEF(void, glDrawElements,
+      (GLenum mode, GLsizei count, GLenum type, const GLvoid *indices));
 FNDEF(void, glEnable, (GLenum cap));
 FNDEF(void, glEnableClientState, (GLenum array));
 FNDEF(void, glFrustumx,
@@ -152,6 +154,7 @@ FNDEF(void, glViewport, (GLint x, GLint y, GLsizei width, GLsizei height));
 #define glDisable FNPTR(glDisable)
 #define glDisableClientState FNPTR(glDisableClientState)
 #define glDrawArrays FNPTR(glDrawArrays)
+#define glDrawElements FNPTR(glDrawElements)
 #define glEnable FNPTR(glEnable)
 #define glEnableClientState FNPTR(glEnableClientState)
 #define glFrustumx FNPTR(glFrustumx)
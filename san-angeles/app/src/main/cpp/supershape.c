@@ -0,0 +1,312 @@
+/* San Angeles Observation OpenGL ES version example
+ * Copyright 2004-2005 Jetro Lauha
+ * All rights reserved.
+ * Web: http://iki.fi/jetro/
+ *
+ * This source is free software; you can redistribute it and/or
+ * modify it under the terms of EITHER:
+ *   (1) The GNU Lesser General Public License as published by the Free
+ *       Software Foundation; either version 2.1 of the License, or (at
+ *       your option) any later version. The text of the GNU Lesser
+ *       General Public License is included with this source in the
+ *       file LICENSE-LGPL.txt.
+ *   (2) The BSD-style license that is included with this source in
+ *       the file LICENSE-BSD.txt.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files
+ * LICENSE-LGPL.txt and LICENSE-BSD.txt for more details.
+ */
+
+#include "supershape.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#undef PI
+#define PI 3.1415926535897932f
+#define MAX_THREADS 8
+
+// Capped conversion from float to fixed.
+static long floatToFixed(float value) {
+  if (value < -32768) value = -32768;
+  if (value > 32767) value = 32767;
+  return (long)(value * 65536);
+}
+
+#define FIXED(value) floatToFixed(value)
+
+typedef struct {
+  float x, y, z;
+} VECTOR3;
+
+void freeGLObject(GLOBJECT *object) {
+  if (object == NULL) return;
+  free(object->indexArray);
+  free(object->normalArray);
+  free(object->colorArray);
+  free(object->vertexArray);
+  free(object);
+}
+
+GLOBJECT *newGLObject(long vertices, int vertexComponents, int useNormalArray,
+                      long indices) {
+  GLOBJECT *result;
+  result = (GLOBJECT *)malloc(sizeof(GLOBJECT));
+  if (result == NULL) return NULL;
+  result->count = vertices;
+  result->indexCount = indices;
+  result->vertexScale = 1 << 16;
+  result->vertexComponents = vertexComponents;
+  result->vertexArray =
+      (GLfixed *)malloc(vertices * vertexComponents * sizeof(GLfixed));
+  result->colorArray = (GLubyte *)malloc(vertices * 4 * sizeof(GLubyte));
+  if (useNormalArray) {
+    result->normalArray = (GLfixed *)malloc(vertices * 3 * sizeof(GLfixed));
+  } else
+    result->normalArray = NULL;
+  if (indices) {
+    result->indexArray = (GLushort *)malloc(indices * sizeof(GLushort));
+  } else
+    result->indexArray = NULL;
+  if (result->vertexArray == NULL || result->colorArray == NULL ||
+      (useNormalArray && result->normalArray == NULL) ||
+      (indices && result->indexArray == NULL)) {
+    freeGLObject(result);
+    return NULL;
+  }
+  return result;
+}
+
+static void vector3Sub(VECTOR3 *dest, VECTOR3 *v1, VECTOR3 *v2) {
+  dest->x = v1->x - v2->x;
+  dest->y = v1->y - v2->y;
+  dest->z = v1->z - v2->z;
+}
+
+static void superShapeMap(VECTOR3 *point, float r1, float r2, float t,
+                          float p) {
+  // sphere-mapping of supershape parameters
+  point->x = (float)(cos(t) * cos(p) / r1 / r2);
+  point->y = (float)(sin(t) * cos(p) / r1 / r2);
+  point->z = (float)(sin(p) / r2);
+}
+
+static float ssFunc(const float t, const float *p) {
+  return (float)(pow(pow(fabs(cos(p[0] * t / 4)) / p[1], p[4]) +
+                         pow(fabs(sin(p[0] * t / 4)) / p[2], p[5]),
+                     1 / p[3]));
+}
+
+// Sets the normal and color of vertex, as the ones of the quad (a, b, d).
+static void setQuadAttributes(GLOBJECT *object, long vertex, VECTOR3 *pa,
+                              VECTOR3 *pb, VECTOR3 *pd,
+                              const float *baseColor) {
+  VECTOR3 v1, v2, n;
+  float ca;
+  int a;
+
+  vector3Sub(&v1, pb, pa);
+  vector3Sub(&v2, pd, pa);
+
+  // Calculate normal with cross product.
+  /*   i    j    k      i    j
+   * v1.x v1.y v1.z | v1.x v1.y
+   * v2.x v2.y v2.z | v2.x v2.y
+   */
+
+  n.x = v1.y * v2.z - v1.z * v2.y;
+  n.y = v1.z * v2.x - v1.x * v2.z;
+  n.z = v1.x * v2.y - v1.y * v2.x;
+
+  /* Normals are not normalized here because they will be normalized
+   * anyway later due to automatic normalization (GL_NORMALIZE). It is
+   * enabled because the objects are scaled with glScale.
+   */
+  object->normalArray[vertex * 3] = FIXED(n.x);
+  object->normalArray[vertex * 3 + 1] = FIXED(n.y);
+  object->normalArray[vertex * 3 + 2] = FIXED(n.z);
+
+  ca = pa->z + 0.5f;
+  for (a = 0; a < 3; ++a) {
+    int color = (int)(ca * baseColor[a] * 255);
+    if (color > 255) color = 255;
+    object->colorArray[vertex * 4 + a] = (GLubyte)color;
+  }
+  object->colorArray[vertex * 4 + 3] = 0;
+}
+
+// Creates and returns a supershape object.
+// Based on Paul Bourke's POV-Ray implementation.
+// http://astronomy.swin.edu.au/~pbourke/povray/supershape/
+/* The radii of a point depend on its longitude alone (r0) and latitude
+ * alone (r1), so they are computed once per column and row of the grid,
+ * and the quads share the vertices of the grid through an index array.
+ * The shapes are flat shaded: a triangle takes the color and normal of
+ * its last vertex, which is d for both triangles (a, b, d) and (b, c, d)
+ * of a quad, and each grid vertex is the d of exactly one quad. So every
+ * vertex holds the color and normal of the quad it is d of, as the six
+ * vertices of the quad did before sharing.
+ */
+static GLOBJECT *createSuperShape(const float *params,
+                                  const float *baseColor) {
+  const int resol1 = (int)params[SUPERSHAPE_PARAMS - 3];
+  const int resol2 = (int)params[SUPERSHAPE_PARAMS - 2];
+  // latitude 0 to pi/2 for no mirrored bottom
+  // (latitudeBegin==0 for -pi/2 to pi/2 originally)
+  const int latitudeBegin = resol2 / 4;
+  const int latitudeEnd = resol2 / 2;  // non-inclusive
+  const int longitudeCount = resol1;
+  const int latitudeCount = latitudeEnd - latitudeBegin;
+  // rows latitudeBegin to latitudeEnd, columns -pi to pi (both ends, as
+  // their points round differently), plus a copy of row latitudeBegin + 1
+  // moved to z = 0 (see below)
+  const int rowCount = latitudeCount + 1;
+  const int columnCount = longitudeCount + 1;
+  const long flatRow = (long)rowCount * columnCount;
+  const long vertices = flatRow + columnCount;
+  const long quadCount = (long)longitudeCount * latitudeCount;
+  GLOBJECT *result;
+  VECTOR3 *points;
+  float *longitudeRadii, *latitudeRadii;
+  int longitude, row;
+  long currentIndex;
+
+  if (vertices > 65536) return NULL;  // more than GLushort indices
+
+  result = newGLObject(vertices, 3, 1, quadCount * 6);
+  points = (VECTOR3 *)malloc(vertices * sizeof(VECTOR3));
+  longitudeRadii = (float *)malloc(columnCount * sizeof(float));
+  latitudeRadii = (float *)malloc(rowCount * sizeof(float));
+  if (result == NULL || points == NULL || longitudeRadii == NULL ||
+      latitudeRadii == NULL) {
+    free(latitudeRadii);
+    free(longitudeRadii);
+    free(points);
+    freeGLObject(result);
+    return NULL;
+  }
+  // vertices no quad has as its d keep these
+  memset(result->normalArray, 0, vertices * 3 * sizeof(GLfixed));
+  memset(result->colorArray, 0, vertices * 4 * sizeof(GLubyte));
+
+  // longitude -pi to pi
+  for (longitude = 0; longitude < columnCount; ++longitude) {
+    float t = -PI + longitude * 2 * PI / resol1;
+    longitudeRadii[longitude] = ssFunc(t, params);
+  }
+  // latitude 0 to pi/2
+  for (row = 0; row < rowCount; ++row) {
+    float p = -PI / 2 + (latitudeBegin + row) * 2 * PI / resol2;
+    latitudeRadii[row] = ssFunc(p, &params[6]);
+    for (longitude = 0; longitude < columnCount; ++longitude) {
+      float t = -PI + longitude * 2 * PI / resol1;
+      VECTOR3 *point = &points[(long)row * columnCount + longitude];
+      long i = ((long)row * columnCount + longitude) * 3;
+      superShapeMap(point, longitudeRadii[longitude], latitudeRadii[row], t,
+                    p);
+      result->vertexArray[i] = FIXED(point->x);
+      result->vertexArray[i + 1] = FIXED(point->y);
+      result->vertexArray[i + 2] = FIXED(point->z);
+    }
+  }
+  // kludge to set lower edge of the object to fixed level: the quads of
+  // row latitudeBegin + 1 have their lower edge at z = 0, the quads below
+  // keep their upper edge where it is
+  for (longitude = 0; longitude < columnCount; ++longitude) {
+    VECTOR3 *point = &points[flatRow + longitude];
+    long i = (flatRow + longitude) * 3;
+    *point = points[columnCount + longitude];
+    point->z = 0;
+    result->vertexArray[i] = FIXED(point->x);
+    result->vertexArray[i + 1] = FIXED(point->y);
+    result->vertexArray[i + 2] = FIXED(point->z);
+  }
+
+  currentIndex = 0;
+  for (longitude = 0; longitude < longitudeCount; ++longitude) {
+    const int next = longitude + 1;
+    for (row = 0; row < latitudeCount; ++row) {
+      const long lower = row == 1 ? flatRow : (long)row * columnCount;
+      const long upper = (long)(row + 1) * columnCount;
+      const long a = lower + longitude, b = lower + next;
+      const long c = upper + next, d = upper + longitude;
+      GLushort *indices = &result->indexArray[currentIndex];
+
+      if (longitudeRadii[longitude] == 0 || longitudeRadii[next] == 0 ||
+          latitudeRadii[row] == 0 || latitudeRadii[row + 1] == 0)
+        continue;
+
+      setQuadAttributes(result, d, &points[a], &points[b], &points[d],
+                        baseColor);
+      indices[0] = (GLushort)a;
+      indices[1] = (GLushort)b;
+      indices[2] = (GLushort)d;
+      indices[3] = (GLushort)b;
+      indices[4] = (GLushort)c;
+      indices[5] = (GLushort)d;
+      currentIndex += 6;
+    }  // latitude
+  }    // longitude
+
+  // Set number of indices in object to the actual amount created.
+  result->indexCount = currentIndex;
+
+  free(latitudeRadii);
+  free(longitudeRadii);
+  free(points);
+  return result;
+}
+
+typedef struct {
+  GLOBJECT **objects;
+  const float (*params)[SUPERSHAPE_PARAMS];
+  const float (*baseColors)[3];
+  int count;
+  atomic_int next;
+} SUPERSHAPE_JOB;
+
+// Creates the shapes of job not taken by another thread yet.
+static void *superShapeWorker(void *arg) {
+  SUPERSHAPE_JOB *job = (SUPERSHAPE_JOB *)arg;
+  int a;
+  while ((a = atomic_fetch_add(&job->next, 1)) < job->count)
+    job->objects[a] = createSuperShape(job->params[a], job->baseColors[a]);
+  return NULL;
+}
+
+int createSuperShapes(GLOBJECT **objects,
+                      const float (*params)[SUPERSHAPE_PARAMS],
+                      const float (*baseColors)[3], int count, int threads) {
+  SUPERSHAPE_JOB job;
+  pthread_t workers[MAX_THREADS - 1];
+  int started = 0, a;
+
+  if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads > MAX_THREADS) threads = MAX_THREADS;
+  if (threads > count) threads = count;
+
+  job.objects = objects;
+  job.params = params;
+  job.baseColors = baseColors;
+  job.count = count;
+  atomic_init(&job.next, 0);
+
+  // this thread is one of them, and does them all if none can start
+  for (a = 1; a < threads; ++a) {
+    if (pthread_create(&workers[started], NULL, superShapeWorker, &job) == 0)
+      ++started;
+  }
+  superShapeWorker(&job);
+  for (a = 0; a < started; ++a) pthread_join(workers[a], NULL);
+
+  for (a = 0; a < count; ++a) {
+    if (objects[a] == NULL) return 0;
+  }
+  return 1;
+}
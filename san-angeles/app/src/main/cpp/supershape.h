@@ -0,0 +1,78 @@
+/* San Angeles Observation OpenGL ES version example
+ * Copyright 2004-2005 Jetro Lauha
+ * All rights reserved.
+ * Web: http://iki.fi/jetro/
+ *
+ * This source is free software; you can redistribute it and/or
+ * modify it under the terms of EITHER:
+ *   (1) The GNU Lesser General Public License as published by the Free
+ *       Software Foundation; either version 2.1 of the License, or (at
+ *       your option) any later version. The text of the GNU Lesser
+ *       General Public License is included with this source in the
+ *       file LICENSE-LGPL.txt.
+ *   (2) The BSD-style license that is included with this source in
+ *       the file LICENSE-BSD.txt.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files
+ * LICENSE-LGPL.txt and LICENSE-BSD.txt for more details.
+ */
+
+#ifndef SUPERSHAPE_H_INCLUDED
+#define SUPERSHAPE_H_INCLUDED
+
+#include "importgl.h"
+#include "shapes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Definition of one GL object in this demo.
+typedef struct {
+  /* Vertex array and color array are enabled for all objects, so their
+   * pointers must always be valid and non-NULL. Normal array is not
+   * used by the ground plane, so when its pointer is NULL then normal
+   * array usage is disabled.
+   *
+   * Vertex array is supposed to use GL_FIXED datatype and stride 0
+   * (i.e. tightly packed array). Color array is supposed to have 4
+   * components per color with GL_UNSIGNED_BYTE datatype and stride 0.
+   * Normal array is supposed to use GL_FIXED datatype and stride 0.
+   *
+   * When index array is non-NULL, the object is indexCount indices of
+   * triangles (GL_UNSIGNED_SHORT) into count vertices; otherwise it is
+   * count vertices of triangles.
+   *
+   * Vertex scale (fixed, 1.0 unless set) scales the vertex array when the
+   * object is drawn, for positions beyond the range of GL_FIXED.
+   */
+  GLfixed *vertexArray;
+  GLubyte *colorArray;
+  GLfixed *normalArray;
+  GLushort *indexArray;
+  GLint vertexComponents;
+  GLsizei count;
+  GLsizei indexCount;
+  GLfixed vertexScale;
+} GLOBJECT;
+
+extern GLOBJECT *newGLObject(long vertices, int vertexComponents,
+                             int useNormalArray, long indices);
+extern void freeGLObject(GLOBJECT *object);
+
+/* Creates the supershape objects of params[0] to params[count - 1], with
+ * base colors baseColors[0] to baseColors[count - 1], on up to threads
+ * threads (0 for one per CPU). Returns 0 if any of them failed.
+ */
+extern int createSuperShapes(GLOBJECT **objects,
+                             const float (*params)[SUPERSHAPE_PARAMS],
+                             const float (*baseColors)[3], int count,
+                             int threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !SUPERSHAPE_H_INCLUDED
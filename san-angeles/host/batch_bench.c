@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The city of the demo merged into batches by createBatches(): how long the
+ * merge takes at startup, how many batches and vertices it makes, and the
+ * draw calls per frame before and after (the models are drawn twice a
+ * frame, reflected and not, plus the ground plane). Also checks every
+ * batched vertex against the matrices glTranslatex(), glRotatex() and
+ * glScalex() made for the building before: positions to within a fixed
+ * point unit (of the batch's vertex scale), normals to the same direction.
+ *
+ * usage: batch_bench [runs]
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "batch.h"
+
+#define CITY_SIZE 5
+#define CITY_SPACING 9
+#define BUILDING_COUNT ((2 * CITY_SIZE + 1) * (2 * CITY_SIZE + 1))
+#define SHIP_DRAWS 10
+
+// the random numbers of demo.c, for the same city
+static unsigned long sRandomSeed = 0;
+
+static unsigned long randomUInt() {
+  sRandomSeed = sRandomSeed * 0x343fd + 0x269ec3;
+  return sRandomSeed >> 16;
+}
+
+static double nowMs(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000. + now.tv_nsec / 1000000.;
+}
+
+// column major 4x4 matrices, as GL has them
+static void multiply(double *m, const double *by) {
+  double result[16];
+  int row, col, k;
+  for (col = 0; col < 4; ++col) {
+    for (row = 0; row < 4; ++row) {
+      result[col * 4 + row] = 0;
+      for (k = 0; k < 4; ++k)
+        result[col * 4 + row] += m[k * 4 + row] * by[col * 4 + k];
+    }
+  }
+  for (k = 0; k < 16; ++k) m[k] = result[k];
+}
+
+// glTranslate(x, y, z) glRotate(angle, 0, 0, 1) glScale(scale) of the
+// building before
+static void buildingMatrix(double *m, const GLINSTANCE *building) {
+  const double angle = building->rotation * 3.14159265358979 / 180;
+  const double c = cos(angle), s = sin(angle), k = building->scale;
+  const double translate[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0,
+                                building->x, building->y, building->z, 1};
+  const double rotate[16] = {c, s, 0, 0, -s, c, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+  const double scale[16] = {k, 0, 0, 0, 0, k, 0, 0, 0, 0, k, 0, 0, 0, 0, 1};
+  int a;
+  for (a = 0; a < 16; ++a) m[a] = translate[a];
+  multiply(m, rotate);
+  multiply(m, scale);
+}
+
+static void normalize(double *v) {
+  double length = sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+  if (length > 0) {
+    v[0] /= length;
+    v[1] /= length;
+    v[2] /= length;
+  }
+}
+
+// vertex of building, at index in batch, is where GL would have put it
+static int sameVertex(const GLINSTANCE *building, const double *m, long vertex,
+                      const GLOBJECT *batch, long index) {
+  const GLOBJECT *object = building->object;
+  const GLfixed *from = &object->vertexArray[vertex * 3];
+  const GLfixed *to = &batch->vertexArray[index * 3];
+  const GLfixed *fromNormal = &object->normalArray[vertex * 3];
+  const GLfixed *toNormal = &batch->normalArray[index * 3];
+  // batched positions are divided by the vertex scale of the batch
+  const double scale = batch->vertexScale / 65536.;
+  double expected[3], normal[3], batched[3];
+  int a;
+  for (a = 0; a < 3; ++a) {
+    expected[a] = (m[a] * from[0] + m[4 + a] * from[1] + m[8 + a] * from[2]) /
+                      65536 +
+                  m[12 + a];
+    if (fabs(to[a] / 65536. * scale - expected[a]) > 1.5 / 65536 * scale)
+      return 0;
+    // the inverse transpose of rotate * scale is rotate / scale
+    normal[a] = m[a] * fromNormal[0] + m[4 + a] * fromNormal[1] +
+                m[8 + a] * fromNormal[2];
+    batched[a] = toNormal[a];
+  }
+  normalize(normal);
+  normalize(batched);
+  for (a = 0; a < 3; ++a) {
+    if (fabs(normal[a] - batched[a]) > 1e-4) return 0;
+  }
+  return 1;
+}
+
+// every triangle of every building is in a batch, where GL would have put
+// it, with its colors
+static int sameCity(const GLINSTANCE *buildings, GLOBJECT **batches,
+                    int batchCount) {
+  int batch = 0, a, b;
+  long first = 0, firstIndex = 0;
+  for (a = 0; a < BUILDING_COUNT; ++a) {
+    // grouped by object, in the order the objects first appear
+    for (b = 0; b < a && buildings[b].object != buildings[a].object; ++b) {
+    }
+    if (b < a) continue;
+    for (b = a; b < BUILDING_COUNT; ++b) {
+      const GLINSTANCE *building = &buildings[b];
+      const GLOBJECT *object = building->object;
+      double m[16];
+      long i;
+      if (object != buildings[a].object) continue;
+      if (batch < batchCount && firstIndex == batches[batch]->indexCount) {
+        ++batch;
+        first = firstIndex = 0;
+      }
+      if (batch == batchCount ||
+          firstIndex + object->indexCount > batches[batch]->indexCount)
+        return 0;
+      buildingMatrix(m, building);
+      for (i = 0; i < object->indexCount; ++i) {
+        if (batches[batch]->indexArray[firstIndex + i] !=
+            first + object->indexArray[i])
+          return 0;
+      }
+      for (i = 0; i < object->count; ++i) {
+        if (!sameVertex(building, m, i, batches[batch], first + i) ||
+            memcmp(&object->colorArray[i * 4],
+                   &batches[batch]->colorArray[(first + i) * 4], 4))
+          return 0;
+      }
+      first += object->count;
+      firstIndex += object->indexCount;
+    }
+  }
+  return batch == batchCount - 1 && firstIndex == batches[batch]->indexCount;
+}
+
+int main(int argc, char **argv) {
+  const int runs = argc > 1 && atoi(argv[1]) > 0 ? atoi(argv[1]) : 20;
+  float baseColors[SUPERSHAPE_COUNT][3];
+  GLOBJECT *shapes[SUPERSHAPE_COUNT];
+  GLINSTANCE buildings[BUILDING_COUNT];
+  GLOBJECT **batches = NULL;
+  int batchCount, run, a, b, x, y;
+  long vertices = 0, triangles = 0, cityVertices = 0;
+  double best = 1e9;
+
+  sRandomSeed = 15;
+  for (a = 0; a < SUPERSHAPE_COUNT; ++a) {
+    for (b = 0; b < 3; ++b)
+      baseColors[a][b] = ((randomUInt() % 155) + 100) / 255.f;
+  }
+  if (!createSuperShapes(shapes, sSuperShapeParams,
+                         (const float(*)[3])baseColors, SUPERSHAPE_COUNT, 0))
+    return 1;
+
+  sRandomSeed = 9;
+  a = 0;
+  for (y = -CITY_SIZE; y <= CITY_SIZE; ++y) {
+    for (x = -CITY_SIZE; x <= CITY_SIZE; ++x, ++a) {
+      int curShape = randomUInt() % SUPERSHAPE_COUNT;
+      buildings[a].object = shapes[curShape];
+      buildings[a].x = (float)(x * CITY_SPACING);
+      buildings[a].y = (float)(y * CITY_SPACING);
+      buildings[a].z = 0;
+      buildings[a].rotation = (float)(randomUInt() % 360);
+      buildings[a].scale = sSuperShapeParams[curShape][SUPERSHAPE_PARAMS - 1];
+      cityVertices += shapes[curShape]->count;
+    }
+  }
+
+  for (run = 0; run < runs; ++run) {
+    double start = nowMs(), time;
+    batches = createBatches(buildings, BUILDING_COUNT, &batchCount);
+    time = nowMs() - start;
+    if (batches == NULL) return 1;
+    if (time < best) best = time;
+    if (run < runs - 1) freeBatches(batches, batchCount);
+  }
+  for (a = 0; a < batchCount; ++a) {
+    vertices += batches[a]->count;
+    triangles += batches[a]->indexCount / 3;
+  }
+
+  printf("%d buildings, %ld vertices, %ld triangles\n", BUILDING_COUNT,
+         cityVertices, triangles);
+  printf("merged into %d batches of %ld vertices in %.2f ms (best of %d)\n",
+         batchCount, vertices, best, runs);
+  printf("draw calls per frame: %d before, %d batched%s\n",
+         2 * (BUILDING_COUNT + SHIP_DRAWS) + 1,
+         2 * (batchCount + SHIP_DRAWS) + 1,
+         sameCity(buildings, batches, batchCount) ? "" : "  DIFFERENT CITY");
+
+  freeBatches(batches, batchCount);
+  for (a = 0; a < SUPERSHAPE_COUNT; ++a) freeGLObject(shapes[a]);
+  return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The whole demo rendered without a GPU, through softgl.c: appRender() on
+ * ticks step milliseconds apart, from the start until the demo ends, each
+ * frame finished with glFinish(). Prints the checksum of the image every
+ * PRINT_EVERY frames and of all the frames, which are the same on any
+ * machine and for any number of threads, and the frames per second, split
+ * between appRender() (vertices, lighting, clipping and binning) and
+ * glFinish() (the tiles). With a directory, also writes the printed frames
+ * to it as PPM images.
+ *
+ * usage: render_bench [width height [threads [step [directory]]]]
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "app.h"
+#include "softgl.h"
+
+#define PRINT_EVERY 100
+
+// defined by the app framework, which this is
+int gAppAlive = 1;
+
+static double nowMs(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000. + now.tv_nsec / 1000000.;
+}
+
+// FNV-1a over the pixels, a word at a time
+static uint32_t checksum(const GLubyte *pixels, long count, uint32_t hash) {
+  long a;
+  for (a = 0; a < count; ++a) {
+    hash ^= (uint32_t)pixels[a * 4] | (uint32_t)pixels[a * 4 + 1] << 8 |
+            (uint32_t)pixels[a * 4 + 2] << 16 |
+            (uint32_t)pixels[a * 4 + 3] << 24;
+    hash *= 16777619;
+  }
+  return hash;
+}
+
+static int writePpm(const char *directory, long tick, int width, int height,
+                    const GLubyte *pixels) {
+  char path[1024];
+  FILE *file;
+  int x, y;
+
+  snprintf(path, sizeof(path), "%s/frame%06ld.ppm", directory, tick);
+  file = fopen(path, "wb");
+  if (file == NULL) return 0;
+  fprintf(file, "P6\n%d %d\n255\n", width, height);
+  // the top row first
+  for (y = height - 1; y >= 0; --y) {
+    for (x = 0; x < width; ++x)
+      fwrite(&pixels[((long)y * width + x) * 4], 1, 3, file);
+  }
+  return fclose(file) == 0;
+}
+
+int main(int argc, char **argv) {
+  const int width = argc > 2 ? atoi(argv[1]) : WINDOW_DEFAULT_WIDTH;
+  const int height = argc > 2 ? atoi(argv[2]) : WINDOW_DEFAULT_HEIGHT;
+  const int threads = argc > 3 ? atoi(argv[3]) : 0;
+  const long step = argc > 4 && atol(argv[4]) > 0 ? atol(argv[4]) : 40;
+  const char *directory = argc > 5 ? argv[5] : NULL;
+  uint32_t all = 2166136261u;
+  double renderMs = 0, finishMs = 0;
+  long frame;
+
+  if (!softGLInit(width, height, threads)) return 1;
+  appInit();
+
+  printf("%8s %8s\n", "tick", "checksum");
+  for (frame = 0;; ++frame) {
+    const long tick = (frame + 1) * step;
+    const GLubyte *pixels;
+    uint32_t sum;
+    double start = nowMs(), rendered;
+
+    appRender(tick, width, height);
+    if (!gAppAlive) break;  // the demo has ended, without drawing
+    rendered = nowMs();
+    glFinish();
+    renderMs += rendered - start;
+    finishMs += nowMs() - rendered;
+
+    pixels = softGLColorBuffer();
+    sum = checksum(pixels, (long)width * height, 2166136261u);
+    all = checksum(pixels, (long)width * height, all);
+    if (frame % PRINT_EVERY == 0) {
+      printf("%8ld %08x\n", tick, sum);
+      if (directory && !writePpm(directory, tick, width, height, pixels))
+        fprintf(stderr, "cannot write to %s\n", directory);
+    }
+  }
+  if (glGetError() != GL_NO_ERROR) printf("GL ERROR\n");
+
+  printf("%ld frames of %dx%d, checksum %08x\n", frame, width, height, all);
+  printf("%.1f frames/s: %.2f ms appRender() + %.2f ms glFinish()\n",
+         frame * 1000 / (renderMs + finishMs), renderMs / frame,
+         finishMs / frame);
+
+  appDeinit();
+  softGLDeinit();
+  return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Startup time and size of the supershapes the demo creates in appInit():
+ * the generator it had (legacy_supershape.c: six vertices per quad, four
+ * ssFunc() calls), against createSuperShapes() (shared vertices and an
+ * index array, radii once per row and column) on one thread and up to the
+ * number of CPUs. Also checks that both draw the same: the same triangles
+ * in the same order, and the same color and normal on the last vertex of
+ * each, which is all that flat shading uses.
+ *
+ * usage: shape_bench [runs]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "supershape.h"
+
+GLOBJECT *legacyCreateSuperShape(const float *params, const float *baseColor);
+
+// the random numbers of demo.c, for the same base colors
+static unsigned long sRandomSeed = 0;
+
+static unsigned long randomUInt() {
+  sRandomSeed = sRandomSeed * 0x343fd + 0x269ec3;
+  return sRandomSeed >> 16;
+}
+
+static double nowMs(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000. + now.tv_nsec / 1000000.;
+}
+
+static void freeShapes(GLOBJECT **objects) {
+  int a;
+  for (a = 0; a < SUPERSHAPE_COUNT; ++a) {
+    freeGLObject(objects[a]);
+    objects[a] = NULL;
+  }
+}
+
+// vertex of the legacy object and index of the indexed one are the same
+static int sameVertex(const GLOBJECT *legacy, long vertex,
+                      const GLOBJECT *indexed, long index, int attributes) {
+  const long other = indexed->indexArray[index];
+  if (memcmp(&legacy->vertexArray[vertex * 3], &indexed->vertexArray[other * 3],
+             3 * sizeof(GLfixed)))
+    return 0;
+  if (!attributes) return 1;
+  return !memcmp(&legacy->normalArray[vertex * 3],
+                 &indexed->normalArray[other * 3], 3 * sizeof(GLfixed)) &&
+         !memcmp(&legacy->colorArray[vertex * 4],
+                 &indexed->colorArray[other * 4], 4 * sizeof(GLubyte));
+}
+
+static int sameTriangles(const GLOBJECT *legacy, const GLOBJECT *indexed) {
+  long vertex;
+  if (legacy->count != indexed->indexCount) return 0;
+  for (vertex = 0; vertex < legacy->count; ++vertex) {
+    if (!sameVertex(legacy, vertex, indexed, vertex, vertex % 3 == 2))
+      return 0;
+  }
+  return 1;
+}
+
+int main(int argc, char **argv) {
+  const int runs = argc > 1 ? atoi(argv[1]) : 20;
+  const int cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  float baseColors[SUPERSHAPE_COUNT][3];
+  GLOBJECT *legacy[SUPERSHAPE_COUNT], *indexed[SUPERSHAPE_COUNT];
+  long legacyVertices = 0, vertices = 0, indices = 0;
+  double legacyMs = 1e9;
+  int a, b, run, threads, same = 1;
+
+  sRandomSeed = 15;
+  for (a = 0; a < SUPERSHAPE_COUNT; ++a) {
+    for (b = 0; b < 3; ++b)
+      baseColors[a][b] = ((randomUInt() % 155) + 100) / 255.f;
+  }
+
+  for (run = 0; run < runs; ++run) {
+    double start = nowMs(), time;
+    for (a = 0; a < SUPERSHAPE_COUNT; ++a)
+      legacy[a] = legacyCreateSuperShape(sSuperShapeParams[a], baseColors[a]);
+    time = nowMs() - start;
+    if (time < legacyMs) legacyMs = time;
+    if (run < runs - 1) freeShapes(legacy);
+  }
+
+  createSuperShapes(indexed, sSuperShapeParams,
+                    (const float(*)[3])baseColors, SUPERSHAPE_COUNT, 1);
+  for (a = 0; a < SUPERSHAPE_COUNT; ++a) {
+    same &= sameTriangles(legacy[a], indexed[a]);
+    legacyVertices += legacy[a]->count;
+    vertices += indexed[a]->count;
+    indices += indexed[a]->indexCount;
+  }
+  freeShapes(indexed);
+
+  printf("%d shapes, %ld triangles, %d CPUs, best of %d runs\n",
+         (int)SUPERSHAPE_COUNT, legacyVertices / 3, cpus, runs);
+  printf("%-14s %9s %9s %9s %10s %8s\n", "generator", "vertices", "indices",
+         "KB", "ms", "speedup");
+  // position, normal and color of a vertex, and an index
+  printf("%-14s %9ld %9s %9ld %10.2f %8s\n", "legacy", legacyVertices, "-",
+         legacyVertices * 28 / 1024, legacyMs, "1.00");
+  for (threads = 1; threads <= cpus && threads <= 8; threads *= 2) {
+    double best = 1e9;
+    char name[16];
+    for (run = 0; run < runs; ++run) {
+      double start = nowMs(), time;
+      createSuperShapes(indexed, sSuperShapeParams,
+                        (const float(*)[3])baseColors, SUPERSHAPE_COUNT,
+                        threads);
+      time = nowMs() - start;
+      if (time < best) best = time;
+      freeShapes(indexed);
+    }
+    snprintf(name, sizeof(name), "indexed x%d", threads);
+    printf("%-14s %9ld %9ld %9ld %10.2f %8.2f%s\n", name, vertices, indices,
+           (vertices * 28 + indices * 2) / 1024, best, legacyMs / best,
+           same ? "" : "  DIFFERENT TRIANGLES");
+  }
+  freeShapes(legacy);
+  return 0;
+}
@@ -0,0 +1,1268 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "softgl.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_THREADS 8
+#define TILE_SIZE 64
+#define SUBPIXEL 16  // window coordinates are 28.4 fixed point
+#define MAX_LIGHTS 8
+#define MODELVIEW_DEPTH 32
+#define PROJECTION_DEPTH 4
+#define MAX_CLIP_VERTICES 9  // a triangle clipped by the 6 planes
+
+// Client array of glVertexPointer(), glColorPointer() or glNormalPointer().
+typedef struct {
+  GLint size;
+  GLenum type;
+  GLsizei stride;
+  const GLvoid *pointer;
+  int enabled;
+} ARRAY;
+
+typedef struct {
+  float ambient[4], diffuse[4], specular[4];
+  float position[4];  // in eye coordinates
+  int enabled;
+} LIGHT;
+
+// A vertex in clip coordinates, lit.
+typedef struct {
+  float clip[4];
+  float color[4];
+  unsigned outside;  // bit per clip plane, set when outside of it
+} VERTEX;
+
+// What the fragments of a triangle do with the framebuffer.
+typedef struct {
+  int depthTest;
+  int blend;
+  GLenum srcFactor, dstFactor;
+} FRAGMENTSTATE;
+
+/* A triangle set up for rasterization: counter-clockwise 28.4 window
+ * coordinates, the pixels it can cover, and depth and colors as planes
+ * p[0] + p[1] * (x - x0) + p[2] * (y - y0) over the window.
+ */
+typedef struct {
+  int x[3], y[3];
+  int minX, minY, maxX, maxY;
+  float x0, y0;
+  float z[3];
+  float color[4][3];
+  int flat;  // colors are the same over the triangle, color[c][0]
+  int state;
+} TRIANGLE;
+
+// The triangles over a tile, in the order they were drawn.
+typedef struct {
+  int *triangles;
+  int count, capacity;
+} BIN;
+
+// Transforms and lights of the draw call being done.
+typedef struct {
+  float mvp[16];
+  const float *modelview;
+  float normalMatrix[3][3];  // columns of the inverse transpose
+  int lights[MAX_LIGHTS];
+  float direction[MAX_LIGHTS][3];  // of directional lights
+  float half[MAX_LIGHTS][3];       // of directional lights
+  int lightCount;
+} DRAW;
+
+static struct {
+  int width, height;
+  int threads;
+  GLubyte *colorBuffer;
+  float *depthBuffer;
+  GLenum error;
+
+  float modelview[MODELVIEW_DEPTH][16];
+  float projection[PROJECTION_DEPTH][16];
+  int modelviewDepth, projectionDepth;
+  GLenum matrixMode;
+  GLint viewport[4];
+
+  ARRAY vertexArray, colorArray, normalArray;
+  float color[4], normal[3];
+
+  int lighting, normalize, colorMaterial;
+  LIGHT lights[MAX_LIGHTS];
+  float sceneAmbient[4];
+  float ambient[4], diffuse[4], specular[4], emission[4], shininess;
+
+  GLenum shadeModel;
+  int cullFace;
+  FRAGMENTSTATE fragment;
+  GLubyte clearColor[4];
+  float clearDepth;
+  GLbitfield pendingClear;
+
+  VERTEX *vertices;
+  int vertexCapacity;
+  TRIANGLE *triangles;
+  int triangleCount, triangleCapacity;
+  FRAGMENTSTATE *states;
+  int stateCount, stateCapacity;
+  BIN *bins;
+  int tilesX, tilesY;
+  atomic_int nextTile;
+} sGL;
+
+static void setError(GLenum error) {
+  if (sGL.error == GL_NO_ERROR) sGL.error = error;
+}
+
+static float *currentMatrix() {
+  if (sGL.matrixMode == GL_PROJECTION)
+    return sGL.projection[sGL.projectionDepth - 1];
+  return sGL.modelview[sGL.modelviewDepth - 1];
+}
+
+static void loadIdentity(float *m) {
+  memset(m, 0, 16 * sizeof(float));
+  m[0] = m[5] = m[10] = m[15] = 1;
+}
+
+// m = m * by, column major as GL has them
+static void multiply(float *m, const float *by) {
+  float result[16];
+  int row, col;
+  for (col = 0; col < 4; ++col) {
+    for (row = 0; row < 4; ++row) {
+      result[col * 4 + row] =
+          m[row] * by[col * 4] + m[4 + row] * by[col * 4 + 1] +
+          m[8 + row] * by[col * 4 + 2] + m[12 + row] * by[col * 4 + 3];
+    }
+  }
+  memcpy(m, result, sizeof(result));
+}
+
+static void transform(const float *m, const float *v, float *out) {
+  int row;
+  for (row = 0; row < 4; ++row) {
+    out[row] = m[row] * v[0] + m[4 + row] * v[1] + m[8 + row] * v[2] +
+               m[12 + row] * v[3];
+  }
+}
+
+static float dot(const float *a, const float *b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static void cross(const float *a, const float *b, float *out) {
+  out[0] = a[1] * b[2] - a[2] * b[1];
+  out[1] = a[2] * b[0] - a[0] * b[2];
+  out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static void normalize(float *v) {
+  const float length = sqrtf(dot(v, v));
+  if (length > 0) {
+    v[0] /= length;
+    v[1] /= length;
+    v[2] /= length;
+  }
+}
+
+static float clamp(float value) {
+  return value < 0 ? 0 : value > 1 ? 1 : value;
+}
+
+static void fixedToFloat(const GLfixed *from, float *to, int count) {
+  int a;
+  for (a = 0; a < count; ++a) to[a] = from[a] / 65536.f;
+}
+
+// Reads element index of array as floats, unsigned bytes scaled to [0, 1].
+static void fetch(const ARRAY *array, int index, float *out) {
+  const int typeSize = array->type == GL_UNSIGNED_BYTE ? 1 : 4;
+  const GLsizei stride =
+      array->stride ? array->stride : array->size * typeSize;
+  const char *element = (const char *)array->pointer + (long)index * stride;
+  int a;
+  for (a = 0; a < array->size; ++a) {
+    if (array->type == GL_FIXED)
+      out[a] = ((const GLfixed *)element)[a] / 65536.f;
+    else if (array->type == GL_FLOAT)
+      out[a] = ((const GLfloat *)element)[a];
+    else
+      out[a] = ((const GLubyte *)element)[a] / 255.f;
+  }
+}
+
+static void setArray(ARRAY *array, GLint size, GLenum type, GLsizei stride,
+                     const GLvoid *pointer) {
+  array->size = size;
+  array->type = type;
+  array->stride = stride;
+  array->pointer = pointer;
+}
+
+static ARRAY *clientArray(GLenum array) {
+  switch (array) {
+    case GL_VERTEX_ARRAY:
+      return &sGL.vertexArray;
+    case GL_COLOR_ARRAY:
+      return &sGL.colorArray;
+    case GL_NORMAL_ARRAY:
+      return &sGL.normalArray;
+  }
+  return NULL;
+}
+
+// Per draw call: the matrices, and the lights as far as they are constant.
+static void prepareDraw(DRAW *draw) {
+  const float *m = sGL.modelview[sGL.modelviewDepth - 1];
+  const float *columns[3] = {&m[0], &m[4], &m[8]};
+  float det;
+  int a, b;
+
+  memcpy(draw->mvp, sGL.projection[sGL.projectionDepth - 1],
+         sizeof(draw->mvp));
+  multiply(draw->mvp, m);
+  draw->modelview = m;
+
+  /* Normals transform by the inverse transpose of the upper 3x3 of the
+   * modelview matrix, which has the cross products of its columns as its
+   * columns.
+   */
+  for (a = 0; a < 3; ++a)
+    cross(columns[(a + 1) % 3], columns[(a + 2) % 3], draw->normalMatrix[a]);
+  det = dot(columns[0], draw->normalMatrix[0]);
+  for (a = 0; a < 3; ++a) {
+    for (b = 0; b < 3; ++b)
+      draw->normalMatrix[a][b] = det != 0 ? draw->normalMatrix[a][b] / det : 0;
+  }
+
+  draw->lightCount = 0;
+  if (!sGL.lighting) return;
+  for (a = 0; a < MAX_LIGHTS; ++a) {
+    const LIGHT *light = &sGL.lights[a];
+    float *direction = draw->direction[draw->lightCount];
+    float *half = draw->half[draw->lightCount];
+    if (!light->enabled) continue;
+    draw->lights[draw->lightCount++] = a;
+    if (light->position[3] != 0) continue;
+    memcpy(direction, light->position, 3 * sizeof(float));
+    normalize(direction);
+    // the viewer is at infinity along +z, as GL_LIGHT_MODEL_LOCAL_VIEWER is
+    // off
+    half[0] = direction[0];
+    half[1] = direction[1];
+    half[2] = direction[2] + 1;
+    normalize(half);
+  }
+}
+
+// The lighting equation of OpenGL ES 1.x for the front face.
+static void lightVertex(const DRAW *draw, const float *eye,
+                        const float *normal, const float *color,
+                        float *out) {
+  const float *ambient = sGL.colorMaterial ? color : sGL.ambient;
+  const float *diffuse = sGL.colorMaterial ? color : sGL.diffuse;
+  float sum[3];
+  int a, k;
+
+  for (k = 0; k < 3; ++k)
+    sum[k] = sGL.emission[k] + sGL.sceneAmbient[k] * ambient[k];
+  for (a = 0; a < draw->lightCount; ++a) {
+    const LIGHT *light = &sGL.lights[draw->lights[a]];
+    float toLight[3], half[3], nDotL;
+    const float *direction = draw->direction[a], *halfway = draw->half[a];
+
+    if (light->position[3] != 0) {
+      for (k = 0; k < 3; ++k)
+        toLight[k] = light->position[k] / light->position[3] - eye[k];
+      normalize(toLight);
+      half[0] = toLight[0];
+      half[1] = toLight[1];
+      half[2] = toLight[2] + 1;
+      normalize(half);
+      direction = toLight;
+      halfway = half;
+    }
+    for (k = 0; k < 3; ++k) sum[k] += light->ambient[k] * ambient[k];
+    nDotL = dot(normal, direction);
+    if (nDotL > 0) {
+      const float nDotH = dot(normal, halfway);
+      const float specular =
+          nDotH > 0 || sGL.shininess == 0 ? powf(nDotH, sGL.shininess) : 0;
+      for (k = 0; k < 3; ++k) {
+        sum[k] += nDotL * light->diffuse[k] * diffuse[k] +
+                  specular * light->specular[k] * sGL.specular[k];
+      }
+    }
+  }
+  for (k = 0; k < 3; ++k) out[k] = clamp(sum[k]);
+  out[3] = clamp(diffuse[3]);
+}
+
+// Transforms and lights the vertices of the arrays from first to first +
+// count - 1, to sGL.vertices.
+static int processVertices(const DRAW *draw, int first, int count) {
+  int a, k;
+
+  if (count > sGL.vertexCapacity) {
+    VERTEX *vertices =
+        (VERTEX *)realloc(sGL.vertices, count * sizeof(VERTEX));
+    if (vertices == NULL) return 0;
+    sGL.vertices = vertices;
+    sGL.vertexCapacity = count;
+  }
+  for (a = 0; a < count; ++a) {
+    VERTEX *vertex = &sGL.vertices[a];
+    float position[4] = {0, 0, 0, 1}, color[4];
+    const float *w = &vertex->clip[3];
+
+    fetch(&sGL.vertexArray, first + a, position);
+    transform(draw->mvp, position, vertex->clip);
+    if (sGL.colorArray.enabled)
+      fetch(&sGL.colorArray, first + a, color);
+    else
+      memcpy(color, sGL.color, sizeof(color));
+
+    if (sGL.lighting) {
+      float eye[4], normal[3], transformed[3];
+      transform(draw->modelview, position, eye);
+      if (sGL.normalArray.enabled)
+        fetch(&sGL.normalArray, first + a, normal);
+      else
+        memcpy(normal, sGL.normal, sizeof(normal));
+      for (k = 0; k < 3; ++k) {
+        transformed[k] = draw->normalMatrix[0][k] * normal[0] +
+                         draw->normalMatrix[1][k] * normal[1] +
+                         draw->normalMatrix[2][k] * normal[2];
+      }
+      if (sGL.normalize) normalize(transformed);
+      lightVertex(draw, eye, transformed, color, vertex->color);
+    } else {
+      for (k = 0; k < 4; ++k) vertex->color[k] = clamp(color[k]);
+    }
+
+    vertex->outside = 0;
+    for (k = 0; k < 3; ++k) {
+      if (vertex->clip[k] < -*w) vertex->outside |= 1 << (k * 2);
+      if (vertex->clip[k] > *w) vertex->outside |= 2 << (k * 2);
+    }
+  }
+  return 1;
+}
+
+// Distance inside clip plane (-w <= x, x <= w, then the same for y and z).
+static float planeDistance(const VERTEX *vertex, int plane) {
+  const float coordinate = vertex->clip[plane >> 1];
+  return plane & 1 ? vertex->clip[3] - coordinate
+                   : vertex->clip[3] + coordinate;
+}
+
+static void lerpVertex(const VERTEX *from, const VERTEX *to, float t,
+                       VERTEX *out) {
+  int k;
+  for (k = 0; k < 4; ++k) {
+    out->clip[k] = from->clip[k] + (to->clip[k] - from->clip[k]) * t;
+    out->color[k] = from->color[k] + (to->color[k] - from->color[k]) * t;
+  }
+}
+
+/* Clips polygon (count vertices) by the planes set in planes, in place.
+ * An edge is always cut from its inside end, so the triangles on both sides
+ * of it get the same vertex. Returns the vertices left.
+ */
+static int clipPolygon(VERTEX *polygon, int count, unsigned planes) {
+  VERTEX clipped[MAX_CLIP_VERTICES];
+  int plane, a;
+
+  for (plane = 0; plane < 6 && count >= 3; ++plane) {
+    int out = 0;
+    if (!(planes & (1 << plane))) continue;
+    for (a = 0; a < count; ++a) {
+      const VERTEX *from = &polygon[a], *to = &polygon[(a + 1) % count];
+      const float fromDistance = planeDistance(from, plane);
+      const float toDistance = planeDistance(to, plane);
+      if (fromDistance >= 0) clipped[out++] = *from;
+      if (fromDistance >= 0 && toDistance < 0) {
+        lerpVertex(from, to, fromDistance / (fromDistance - toDistance),
+                   &clipped[out++]);
+      } else if (fromDistance < 0 && toDistance >= 0) {
+        lerpVertex(to, from, toDistance / (toDistance - fromDistance),
+                   &clipped[out++]);
+      }
+    }
+    memcpy(polygon, clipped, out * sizeof(VERTEX));
+    count = out;
+  }
+  return count;
+}
+
+static int grow(void **array, int *capacity, int count, size_t size) {
+  void *grown;
+  int newCapacity;
+  if (count < *capacity) return 1;
+  newCapacity = *capacity ? *capacity * 2 : 1024;
+  grown = realloc(*array, newCapacity * size);
+  if (grown == NULL) return 0;
+  *array = grown;
+  *capacity = newCapacity;
+  return 1;
+}
+
+// Evaluated at (x0 + dx, y0 + dy): p[0] + p[1] * dx + p[2] * dy.
+static void plane(const float *values, float dx1, float dy1, float dx2,
+                  float dy2, float inverseArea, float *p) {
+  const float d1 = values[1] - values[0], d2 = values[2] - values[0];
+  p[0] = values[0];
+  p[1] = (d1 * dy2 - d2 * dy1) * inverseArea;
+  p[2] = (d2 * dx1 - d1 * dx2) * inverseArea;
+}
+
+/* Sets up the triangle of 28.4 window coordinates x and y, depths z and
+ * colors, and bins it to the tiles its bounds overlap.
+ */
+static void addTriangle(int *x, int *y, float *z, const float **color) {
+  const int minViewX = sGL.viewport[0] > 0 ? sGL.viewport[0] : 0;
+  const int minViewY = sGL.viewport[1] > 0 ? sGL.viewport[1] : 0;
+  const int maxViewX = sGL.viewport[0] + sGL.viewport[2] < sGL.width
+                           ? sGL.viewport[0] + sGL.viewport[2] - 1
+                           : sGL.width - 1;
+  const int maxViewY = sGL.viewport[1] + sGL.viewport[3] < sGL.height
+                           ? sGL.viewport[1] + sGL.viewport[3] - 1
+                           : sGL.height - 1;
+  const int64_t area = (int64_t)(x[1] - x[0]) * (y[2] - y[0]) -
+                       (int64_t)(x[2] - x[0]) * (y[1] - y[0]);
+  float dx1, dy1, dx2, dy2, inverseArea, values[3];
+  TRIANGLE *triangle;
+  int a, c, tileX, tileY;
+
+  if (area == 0) return;
+  // clockwise is the back face, as glFrontFace() is GL_CCW
+  if (area < 0 && sGL.cullFace) return;
+  if (area < 0) {
+    const float *swapColor = color[1];
+    int swap = x[1];
+    float swapZ = z[1];
+    x[1] = x[2];
+    x[2] = swap;
+    swap = y[1];
+    y[1] = y[2];
+    y[2] = swap;
+    z[1] = z[2];
+    z[2] = swapZ;
+    color[1] = color[2];
+    color[2] = swapColor;
+  }
+
+  if (!grow((void **)&sGL.triangles, &sGL.triangleCapacity,
+            sGL.triangleCount, sizeof(TRIANGLE))) {
+    setError(GL_OUT_OF_MEMORY);
+    return;
+  }
+  triangle = &sGL.triangles[sGL.triangleCount];
+  triangle->minX = triangle->maxX = x[0];
+  triangle->minY = triangle->maxY = y[0];
+  for (a = 0; a < 3; ++a) {
+    triangle->x[a] = x[a];
+    triangle->y[a] = y[a];
+    if (x[a] < triangle->minX) triangle->minX = x[a];
+    if (x[a] > triangle->maxX) triangle->maxX = x[a];
+    if (y[a] < triangle->minY) triangle->minY = y[a];
+    if (y[a] > triangle->maxY) triangle->maxY = y[a];
+  }
+  // from 28.4 to the pixels whose centers can be inside
+  triangle->minX = triangle->minX >> 4;
+  triangle->minY = triangle->minY >> 4;
+  triangle->maxX = triangle->maxX >> 4;
+  triangle->maxY = triangle->maxY >> 4;
+  if (triangle->minX < minViewX) triangle->minX = minViewX;
+  if (triangle->minY < minViewY) triangle->minY = minViewY;
+  if (triangle->maxX > maxViewX) triangle->maxX = maxViewX;
+  if (triangle->maxY > maxViewY) triangle->maxY = maxViewY;
+  if (triangle->minX > triangle->maxX || triangle->minY > triangle->maxY)
+    return;
+
+  triangle->x0 = (float)x[0] / SUBPIXEL;
+  triangle->y0 = (float)y[0] / SUBPIXEL;
+  dx1 = (float)(x[1] - x[0]) / SUBPIXEL;
+  dy1 = (float)(y[1] - y[0]) / SUBPIXEL;
+  dx2 = (float)(x[2] - x[0]) / SUBPIXEL;
+  dy2 = (float)(y[2] - y[0]) / SUBPIXEL;
+  inverseArea = 1 / (dx1 * dy2 - dx2 * dy1);
+  plane(z, dx1, dy1, dx2, dy2, inverseArea, triangle->z);
+  triangle->flat = !memcmp(color[0], color[1], 4 * sizeof(float)) &&
+                   !memcmp(color[0], color[2], 4 * sizeof(float));
+  for (c = 0; c < 4; ++c) {
+    if (triangle->flat) {
+      triangle->color[c][0] = color[0][c];
+      continue;
+    }
+    for (a = 0; a < 3; ++a) values[a] = color[a][c];
+    plane(values, dx1, dy1, dx2, dy2, inverseArea, triangle->color[c]);
+  }
+
+  if (sGL.stateCount == 0 ||
+      memcmp(&sGL.states[sGL.stateCount - 1], &sGL.fragment,
+             sizeof(FRAGMENTSTATE))) {
+    if (!grow((void **)&sGL.states, &sGL.stateCapacity, sGL.stateCount,
+              sizeof(FRAGMENTSTATE))) {
+      setError(GL_OUT_OF_MEMORY);
+      return;
+    }
+    sGL.states[sGL.stateCount++] = sGL.fragment;
+  }
+  triangle->state = sGL.stateCount - 1;
+
+  for (tileY = triangle->minY / TILE_SIZE; tileY <= triangle->maxY / TILE_SIZE;
+       ++tileY) {
+    for (tileX = triangle->minX / TILE_SIZE;
+         tileX <= triangle->maxX / TILE_SIZE; ++tileX) {
+      BIN *bin = &sGL.bins[tileY * sGL.tilesX + tileX];
+      if (!grow((void **)&bin->triangles, &bin->capacity, bin->count,
+                sizeof(int))) {
+        setError(GL_OUT_OF_MEMORY);
+        continue;
+      }
+      bin->triangles[bin->count++] = sGL.triangleCount;
+    }
+  }
+  ++sGL.triangleCount;
+}
+
+// Clips the triangle of vertices a, b and c, and adds what is left of it.
+static void drawTriangle(const VERTEX *a, const VERTEX *b, const VERTEX *c) {
+  VERTEX polygon[MAX_CLIP_VERTICES];
+  int x[MAX_CLIP_VERTICES], y[MAX_CLIP_VERTICES];
+  float z[MAX_CLIP_VERTICES];
+  const unsigned outside = a->outside | b->outside | c->outside;
+  int count = 3, v;
+
+  if (a->outside & b->outside & c->outside) return;
+  polygon[0] = *a;
+  polygon[1] = *b;
+  polygon[2] = *c;
+  // the last vertex of a triangle colors it all with flat shading
+  if (sGL.shadeModel == GL_FLAT) {
+    memcpy(polygon[0].color, c->color, sizeof(c->color));
+    memcpy(polygon[1].color, c->color, sizeof(c->color));
+  }
+  if (outside) count = clipPolygon(polygon, count, outside);
+
+  for (v = 0; v < count; ++v) {
+    const float *clip = polygon[v].clip;
+    const float w = 1 / clip[3];
+    if (clip[3] <= 0) return;
+    x[v] = (int)lrintf(((clip[0] * w + 1) * 0.5f * sGL.viewport[2] +
+                        sGL.viewport[0]) *
+                       SUBPIXEL);
+    y[v] = (int)lrintf(((clip[1] * w + 1) * 0.5f * sGL.viewport[3] +
+                        sGL.viewport[1]) *
+                       SUBPIXEL);
+    z[v] = (clip[2] * w + 1) * 0.5f;
+  }
+  for (v = 1; v + 1 < count; ++v) {
+    int fanX[3] = {x[0], x[v], x[v + 1]}, fanY[3] = {y[0], y[v], y[v + 1]};
+    float fanZ[3] = {z[0], z[v], z[v + 1]};
+    const float *fanColor[3] = {polygon[0].color, polygon[v].color,
+                                polygon[v + 1].color};
+    addTriangle(fanX, fanY, fanZ, fanColor);
+  }
+}
+
+static int indexAt(const GLvoid *indices, GLenum type, int a) {
+  if (type == GL_UNSIGNED_BYTE) return ((const GLubyte *)indices)[a];
+  return ((const GLushort *)indices)[a];
+}
+
+/* Draws count vertices as mode, from first on or through the indices of
+ * type; first is the smallest of the indices then.
+ */
+static void drawVertices(GLenum mode, int first, GLsizei count,
+                         const GLvoid *indices, GLenum type) {
+  DRAW draw;
+  int vertices = count, a;
+
+  if (mode != GL_TRIANGLES && mode != GL_TRIANGLE_STRIP &&
+      mode != GL_TRIANGLE_FAN)
+    return;  // points and lines are not drawn
+  if (!sGL.vertexArray.enabled || count < 3) return;
+  if (indices) {
+    int last = first;
+    for (a = 0; a < count; ++a) {
+      if (indexAt(indices, type, a) > last) last = indexAt(indices, type, a);
+    }
+    vertices = last - first + 1;
+  }
+
+  prepareDraw(&draw);
+  if (!processVertices(&draw, first, vertices)) {
+    setError(GL_OUT_OF_MEMORY);
+    return;
+  }
+  for (a = 0; a + 2 < count; a += mode == GL_TRIANGLES ? 3 : 1) {
+    int v[3] = {a, a + 1, a + 2}, k;
+    if (mode == GL_TRIANGLE_FAN) {
+      v[0] = 0;
+    } else if (mode == GL_TRIANGLE_STRIP && (a & 1)) {
+      // every other strip triangle is turned, to keep its winding
+      v[0] = a + 1;
+      v[1] = a;
+    }
+    if (indices) {
+      for (k = 0; k < 3; ++k) v[k] = indexAt(indices, type, v[k]) - first;
+    }
+    drawTriangle(&sGL.vertices[v[0]], &sGL.vertices[v[1]],
+                 &sGL.vertices[v[2]]);
+  }
+}
+
+// The four channels of blend factor, for fragment color src over dst.
+static void blendFactor(GLenum factor, const float *src, const float *dst,
+                        float *out) {
+  float value;
+  int c;
+  switch (factor) {
+    case GL_SRC_COLOR:
+      memcpy(out, src, 4 * sizeof(float));
+      return;
+    case GL_ONE_MINUS_SRC_COLOR:
+      for (c = 0; c < 4; ++c) out[c] = 1 - src[c];
+      return;
+    case GL_DST_COLOR:
+      memcpy(out, dst, 4 * sizeof(float));
+      return;
+    case GL_ONE_MINUS_DST_COLOR:
+      for (c = 0; c < 4; ++c) out[c] = 1 - dst[c];
+      return;
+    case GL_SRC_ALPHA_SATURATE:
+      value = src[3] < 1 - dst[3] ? src[3] : 1 - dst[3];
+      out[0] = out[1] = out[2] = value;
+      out[3] = 1;
+      return;
+    case GL_ONE:
+      value = 1;
+      break;
+    case GL_SRC_ALPHA:
+      value = src[3];
+      break;
+    case GL_ONE_MINUS_SRC_ALPHA:
+      value = 1 - src[3];
+      break;
+    case GL_DST_ALPHA:
+      value = dst[3];
+      break;
+    case GL_ONE_MINUS_DST_ALPHA:
+      value = 1 - dst[3];
+      break;
+    default:
+      value = 0;  // GL_ZERO
+  }
+  for (c = 0; c < 4; ++c) out[c] = value;
+}
+
+static GLubyte toByte(float value) {
+  return (GLubyte)(clamp(value) * 255 + 0.5f);
+}
+
+// Writes color to pixel, blended with what it has if state blends.
+static void writeColor(const FRAGMENTSTATE *state, const float *color,
+                       GLubyte *pixel) {
+  float dst[4], srcFactor[4], dstFactor[4];
+  int c;
+  if (!state->blend) {
+    for (c = 0; c < 4; ++c) pixel[c] = toByte(color[c]);
+    return;
+  }
+  for (c = 0; c < 4; ++c) dst[c] = pixel[c] / 255.f;
+  blendFactor(state->srcFactor, color, dst, srcFactor);
+  blendFactor(state->dstFactor, color, dst, dstFactor);
+  for (c = 0; c < 4; ++c)
+    pixel[c] = toByte(color[c] * srcFactor[c] + dst[c] * dstFactor[c]);
+}
+
+/* The first and last of count pixels along a row that an edge function of
+ * value at the first and step from pixel to pixel is >= 0 at, narrowing
+ * from and to. Returns 0 when there are none.
+ */
+static int edgeSpan(int64_t value, int64_t step, int count, int *from,
+                    int *to) {
+  if (step > 0) {
+    if (value < 0) {
+      const int64_t first = (-value + step - 1) / step;
+      if (first >= count) return 0;
+      if (first > *from) *from = (int)first;
+    }
+  } else if (value < 0) {
+    return 0;
+  } else if (step < 0) {
+    const int64_t last = value / -step;
+    if (last < *to) *to = (int)last;
+  }
+  return *from <= *to;
+}
+
+/* Rasterizes triangle over the pixels from (left, bottom) to (right, top)
+ * with edge functions on its 28.4 coordinates, sampled at pixel centers.
+ * Pixels on an edge belong to the triangle if the edge is a left or top
+ * one, so that triangles sharing an edge draw each pixel once. The edge
+ * functions are linear along a row, which gives the span of it inside all
+ * three without testing every pixel of the bounds (long thin triangles
+ * have large ones).
+ */
+static void rasterize(const TRIANGLE *triangle, int left, int bottom,
+                      int right, int top) {
+  const FRAGMENTSTATE *state = &sGL.states[triangle->state];
+  const int minX = triangle->minX > left ? triangle->minX : left;
+  const int minY = triangle->minY > bottom ? triangle->minY : bottom;
+  const int maxX = triangle->maxX < right ? triangle->maxX : right;
+  const int maxY = triangle->maxY < top ? triangle->maxY : top;
+  int64_t row[3], stepX[3], stepY[3];
+  GLubyte flatColor[4];
+  float color[4];
+  int e, x, y, c;
+
+  if (minX > maxX || minY > maxY) return;
+  for (e = 0; e < 3; ++e) {
+    const int from = e, to = (e + 1) % 3;
+    const int64_t dx = triangle->x[to] - triangle->x[from];
+    const int64_t dy = triangle->y[to] - triangle->y[from];
+    const int topLeft = dy < 0 || (dy == 0 && dx < 0);
+    // inside is on the left of each edge, >= 0
+    row[e] = dx * (minY * SUBPIXEL + SUBPIXEL / 2 - triangle->y[from]) -
+             dy * (minX * SUBPIXEL + SUBPIXEL / 2 - triangle->x[from]) -
+             !topLeft;
+    stepX[e] = -dy * SUBPIXEL;
+    stepY[e] = dx * SUBPIXEL;
+  }
+  if (triangle->flat) {
+    for (c = 0; c < 4; ++c) {
+      color[c] = triangle->color[c][0];
+      flatColor[c] = toByte(color[c]);
+    }
+  }
+
+  for (y = minY; y <= maxY; ++y) {
+    const float dy = y + 0.5f - triangle->y0;
+    int from = 0, to = maxX - minX;
+    int inside = 1;
+    for (e = 0; e < 3 && inside; ++e)
+      inside = edgeSpan(row[e], stepX[e], maxX - minX + 1, &from, &to);
+    for (e = 0; e < 3; ++e) row[e] += stepY[e];
+    if (!inside) continue;
+
+    for (x = minX + from; x <= minX + to; ++x) {
+      const long pixel = (long)y * sGL.width + x;
+      const float dx = x + 0.5f - triangle->x0;
+      if (state->depthTest) {
+        const float z = clamp(triangle->z[0] + triangle->z[1] * dx +
+                              triangle->z[2] * dy);
+        if (!(z < sGL.depthBuffer[pixel])) continue;
+        sGL.depthBuffer[pixel] = z;
+      }
+      if (triangle->flat && !state->blend) {
+        memcpy(&sGL.colorBuffer[pixel * 4], flatColor, 4);
+        continue;
+      }
+      if (!triangle->flat) {
+        for (c = 0; c < 4; ++c) {
+          const float *p = triangle->color[c];
+          color[c] = p[0] + p[1] * dx + p[2] * dy;
+        }
+      }
+      writeColor(state, color, &sGL.colorBuffer[pixel * 4]);
+    }
+  }
+}
+
+static void drawTile(int tile) {
+  const BIN *bin = &sGL.bins[tile];
+  const int left = tile % sGL.tilesX * TILE_SIZE;
+  const int bottom = tile / sGL.tilesX * TILE_SIZE;
+  const int right =
+      (left + TILE_SIZE < sGL.width ? left + TILE_SIZE : sGL.width) - 1;
+  const int top =
+      (bottom + TILE_SIZE < sGL.height ? bottom + TILE_SIZE : sGL.height) - 1;
+  int x, y, a;
+
+  for (y = bottom; y <= top; ++y) {
+    const long start = (long)y * sGL.width;
+    if (sGL.pendingClear & GL_COLOR_BUFFER_BIT) {
+      for (x = left; x <= right; ++x)
+        memcpy(&sGL.colorBuffer[(start + x) * 4], sGL.clearColor, 4);
+    }
+    if (sGL.pendingClear & GL_DEPTH_BUFFER_BIT) {
+      for (x = left; x <= right; ++x)
+        sGL.depthBuffer[start + x] = sGL.clearDepth;
+    }
+  }
+  for (a = 0; a < bin->count; ++a)
+    rasterize(&sGL.triangles[bin->triangles[a]], left, bottom, right, top);
+}
+
+// Draws the tiles not taken by another thread yet.
+static void *tileWorker(void *unused) {
+  const int tileCount = sGL.tilesX * sGL.tilesY;
+  int tile;
+  (void)unused;
+  while ((tile = atomic_fetch_add(&sGL.nextTile, 1)) < tileCount)
+    drawTile(tile);
+  return NULL;
+}
+
+// Rasterizes the clear and the triangles binned so far.
+static void flush() {
+  pthread_t workers[MAX_THREADS - 1];
+  int started = 0, a;
+
+  if (sGL.triangleCount == 0 && sGL.pendingClear == 0) return;
+  atomic_init(&sGL.nextTile, 0);
+  // this thread is one of them, and does them all if none can start
+  for (a = 1; a < sGL.threads; ++a) {
+    if (pthread_create(&workers[started], NULL, tileWorker, NULL) == 0)
+      ++started;
+  }
+  tileWorker(NULL);
+  for (a = 0; a < started; ++a) pthread_join(workers[a], NULL);
+
+  for (a = 0; a < sGL.tilesX * sGL.tilesY; ++a) sGL.bins[a].count = 0;
+  sGL.triangleCount = 0;
+  sGL.stateCount = 0;
+  sGL.pendingClear = 0;
+}
+
+int softGLInit(int width, int height, int threads) {
+  static const float black[4] = {0, 0, 0, 1}, white[4] = {1, 1, 1, 1};
+  int a;
+
+  softGLDeinit();
+  if (width <= 0 || height <= 0) return 0;
+  if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads > MAX_THREADS) threads = MAX_THREADS;
+  if (threads < 1) threads = 1;
+  sGL.width = width;
+  sGL.height = height;
+  sGL.threads = threads;
+  sGL.tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+  sGL.tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+  sGL.colorBuffer = (GLubyte *)calloc((size_t)width * height, 4);
+  sGL.depthBuffer = (float *)calloc((size_t)width * height, sizeof(float));
+  sGL.bins = (BIN *)calloc(sGL.tilesX * sGL.tilesY, sizeof(BIN));
+  if (sGL.colorBuffer == NULL || sGL.depthBuffer == NULL || sGL.bins == NULL) {
+    softGLDeinit();
+    return 0;
+  }
+
+  // the initial state of OpenGL ES 1.x
+  sGL.error = GL_NO_ERROR;
+  sGL.modelviewDepth = sGL.projectionDepth = 1;
+  loadIdentity(sGL.modelview[0]);
+  loadIdentity(sGL.projection[0]);
+  sGL.matrixMode = GL_MODELVIEW;
+  sGL.viewport[2] = width;
+  sGL.viewport[3] = height;
+  setArray(&sGL.vertexArray, 4, GL_FLOAT, 0, NULL);
+  setArray(&sGL.colorArray, 4, GL_FLOAT, 0, NULL);
+  setArray(&sGL.normalArray, 3, GL_FLOAT, 0, NULL);
+  memcpy(sGL.color, white, sizeof(white));
+  sGL.normal[2] = 1;
+  for (a = 0; a < MAX_LIGHTS; ++a) {
+    LIGHT *light = &sGL.lights[a];
+    memcpy(light->ambient, black, sizeof(black));
+    memcpy(light->diffuse, a == 0 ? white : black, sizeof(black));
+    memcpy(light->specular, a == 0 ? white : black, sizeof(black));
+    light->position[2] = 1;
+  }
+  for (a = 0; a < 3; ++a) {
+    sGL.sceneAmbient[a] = 0.2f;
+    sGL.ambient[a] = 0.2f;
+    sGL.diffuse[a] = 0.8f;
+  }
+  sGL.sceneAmbient[3] = sGL.ambient[3] = sGL.diffuse[3] = 1;
+  sGL.specular[3] = sGL.emission[3] = 1;
+  sGL.shadeModel = GL_SMOOTH;
+  sGL.fragment.srcFactor = GL_ONE;
+  sGL.fragment.dstFactor = GL_ZERO;
+  sGL.clearDepth = 1;
+  return 1;
+}
+
+void softGLDeinit() {
+  int a;
+  if (sGL.bins) {
+    for (a = 0; a < sGL.tilesX * sGL.tilesY; ++a) free(sGL.bins[a].triangles);
+  }
+  free(sGL.bins);
+  free(sGL.colorBuffer);
+  free(sGL.depthBuffer);
+  free(sGL.vertices);
+  free(sGL.triangles);
+  free(sGL.states);
+  memset(&sGL, 0, sizeof(sGL));
+}
+
+const GLubyte *softGLColorBuffer() {
+  flush();
+  return sGL.colorBuffer;
+}
+
+void GL_APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor) {
+  sGL.fragment.srcFactor = sfactor;
+  sGL.fragment.dstFactor = dfactor;
+}
+
+void GL_APIENTRY glClear(GLbitfield mask) {
+  // triangles drawn before it are rasterized first
+  if (sGL.triangleCount) flush();
+  sGL.pendingClear |= mask & (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void GL_APIENTRY glClearColorx(GLclampx red, GLclampx green, GLclampx blue,
+                               GLclampx alpha) {
+  sGL.clearColor[0] = toByte(red / 65536.f);
+  sGL.clearColor[1] = toByte(green / 65536.f);
+  sGL.clearColor[2] = toByte(blue / 65536.f);
+  sGL.clearColor[3] = toByte(alpha / 65536.f);
+}
+
+void GL_APIENTRY glColor4x(GLfixed red, GLfixed green, GLfixed blue,
+                           GLfixed alpha) {
+  const GLfixed color[4] = {red, green, blue, alpha};
+  fixedToFloat(color, sGL.color, 4);
+}
+
+void GL_APIENTRY glColorPointer(GLint size, GLenum type, GLsizei stride,
+                                const void *pointer) {
+  if (type != GL_UNSIGNED_BYTE && type != GL_FIXED && type != GL_FLOAT) {
+    setError(GL_INVALID_ENUM);
+    return;
+  }
+  if (size != 4 || stride < 0) {
+    setError(GL_INVALID_VALUE);
+    return;
+  }
+  setArray(&sGL.colorArray, size, type, stride, pointer);
+}
+
+static void setCapability(GLenum cap, int enabled) {
+  if (cap >= GL_LIGHT0 && cap < GL_LIGHT0 + MAX_LIGHTS) {
+    sGL.lights[cap - GL_LIGHT0].enabled = enabled;
+    return;
+  }
+  switch (cap) {
+    case GL_LIGHTING:
+      sGL.lighting = enabled;
+      break;
+    case GL_NORMALIZE:
+    case GL_RESCALE_NORMAL:
+      sGL.normalize = enabled;
+      break;
+    case GL_COLOR_MATERIAL:
+      sGL.colorMaterial = enabled;
+      break;
+    case GL_CULL_FACE:
+      sGL.cullFace = enabled;
+      break;
+    case GL_DEPTH_TEST:
+      sGL.fragment.depthTest = enabled;
+      break;
+    case GL_BLEND:
+      sGL.fragment.blend = enabled;
+      break;
+    case GL_DITHER:
+      break;  // on or off, the colors are exact
+    default:
+      setError(GL_INVALID_ENUM);
+  }
+}
+
+void GL_APIENTRY glDisable(GLenum cap) { setCapability(cap, 0); }
+
+void GL_APIENTRY glEnable(GLenum cap) { setCapability(cap, 1); }
+
+void GL_APIENTRY glDisableClientState(GLenum array) {
+  ARRAY *clientState = clientArray(array);
+  if (clientState)
+    clientState->enabled = 0;
+  else if (array != GL_TEXTURE_COORD_ARRAY)
+    setError(GL_INVALID_ENUM);
+}
+
+void GL_APIENTRY glEnableClientState(GLenum array) {
+  ARRAY *clientState = clientArray(array);
+  if (clientState)
+    clientState->enabled = 1;
+  else if (array != GL_TEXTURE_COORD_ARRAY)
+    setError(GL_INVALID_ENUM);
+}
+
+void GL_APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count) {
+  if (first < 0 || count < 0) {
+    setError(GL_INVALID_VALUE);
+    return;
+  }
+  drawVertices(mode, first, count, NULL, GL_UNSIGNED_SHORT);
+}
+
+void GL_APIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type,
+                                const void *indices) {
+  int first = 0x7fffffff, a;
+  if (type != GL_UNSIGNED_BYTE && type != GL_UNSIGNED_SHORT) {
+    setError(GL_INVALID_ENUM);
+    return;
+  }
+  if (count < 0) {
+    setError(GL_INVALID_VALUE);
+    return;
+  }
+  for (a = 0; a < count; ++a) {
+    if (indexAt(indices, type, a) < first) first = indexAt(indices, type, a);
+  }
+  drawVertices(mode, first, count, indices, type);
+}
+
+void GL_APIENTRY glFinish(void) { flush(); }
+
+void GL_APIENTRY glFlush(void) { flush(); }
+
+void GL_APIENTRY glFrustumx(GLfixed left, GLfixed right, GLfixed bottom,
+                            GLfixed top, GLfixed zNear, GLfixed zFar) {
+  const float l = left / 65536.f, r = right / 65536.f;
+  const float b = bottom / 65536.f, t = top / 65536.f;
+  const float n = zNear / 65536.f, f = zFar / 65536.f;
+  float m[16] = {0};
+
+  if (n <= 0 || f <= 0 || l == r || b == t || n == f) {
+    setError(GL_INVALID_VALUE);
+    return;
+  }
+  m[0] = 2 * n / (r - l);
+  m[5] = 2 * n / (t - b);
+  m[8] = (r + l) / (r - l);
+  m[9] = (t + b) / (t - b);
+  m[10] = -(f + n) / (f - n);
+  m[11] = -1;
+  m[14] = -2 * f * n / (f - n);
+  multiply(currentMatrix(), m);
+}
+
+GLenum GL_APIENTRY glGetError(void) {
+  const GLenum error = sGL.error;
+  sGL.error = GL_NO_ERROR;
+  return error;
+}
+
+void GL_APIENTRY glLightxv(GLenum light, GLenum pname,
+                           const GLfixed *params) {
+  LIGHT *target;
+  float position[4];
+
+  if (light < GL_LIGHT0 || light >= GL_LIGHT0 + MAX_LIGHTS) {
+    setError(GL_INVALID_ENUM);
+    return;
+  }
+  target = &sGL.lights[light - GL_LIGHT0];
+  switch (pname) {
+    case GL_AMBIENT:
+      fixedToFloat(params, target->ambient, 4);
+      break;
+    case GL_DIFFUSE:
+      fixedToFloat(params, target->diffuse, 4);
+      break;
+    case GL_SPECULAR:
+      fixedToFloat(params, target->specular, 4);
+      break;
+    case GL_POSITION:
+      // to eye coordinates, by the modelview matrix of now
+      fixedToFloat(params, position, 4);
+      transform(sGL.modelview[sGL.modelviewDepth - 1], position,
+                target->position);
+      break;
+    default:
+      setError(GL_INVALID_ENUM);  // attenuation and spot are not supported
+  }
+}
+
+void GL_APIENTRY glLoadIdentity(void) { loadIdentity(currentMatrix()); }
+
+void GL_APIENTRY glMaterialx(GLenum face, GLenum pname, GLfixed param) {
+  if (pname != GL_SHININESS) {
+    setError(GL_INVALID_ENUM);
+    return;
+  }
+  glMaterialxv(face, pname, &param);
+}
+
+void GL_APIENTRY glMaterialxv(GLenum face, GLenum pname,
+                              const GLfixed *params) {
+  // ES 1.x lights the front face only, which both faces share
+  if (face != GL_FRONT_AND_BACK) {
+    setError(GL_INVALID_ENUM);
+    return;
+  }
+  switch (pname) {
+    case GL_AMBIENT:
+      fixedToFloat(params, sGL.ambient, 4);
+      break;
+    case GL_DIFFUSE:
+      fixedToFloat(params, sGL.diffuse, 4);
+      break;
+    case GL_AMBIENT_AND_DIFFUSE:
+      fixedToFloat(params, sGL.ambient, 4);
+      fixedToFloat(params, sGL.diffuse, 4);
+      break;
+    case GL_SPECULAR:
+      fixedToFloat(params, sGL.specular, 4);
+      break;
+    case GL_EMISSION:
+      fixedToFloat(params, sGL.emission, 4);
+      break;
+    case GL_SHININESS:
+      if (params[0] < 0 || params[0] > 128 << 16) {
+        setError(GL_INVALID_VALUE);
+        return;
+      }
+      sGL.shininess = params[0] / 65536.f;
+      break;
+    default:
+      setError(GL_INVALID_ENUM);
+  }
+}
+
+void GL_APIENTRY glMatrixMode(GLenum mode) {
+  if (mode != GL_MODELVIEW && mode != GL_PROJECTION) {
+    setError(GL_INVALID_ENUM);  // there is no texturing
+    return;
+  }
+  sGL.matrixMode = mode;
+}
+
+void GL_APIENTRY glMultMatrixx(const GLfixed *m) {
+  float by[16];
+  fixedToFloat(m, by, 16);
+  multiply(currentMatrix(), by);
+}
+
+void GL_APIENTRY glNormalPointer(GLenum type, GLsizei stride,
+                                 const void *pointer) {
+  if (type != GL_FIXED && type != GL_FLOAT) {
+    setError(GL_INVALID_ENUM);
+    return;
+  }
+  if (stride < 0) {
+    setError(GL_INVALID_VALUE);
+    return;
+  }
+  setArray(&sGL.normalArray, 3, type, stride, pointer);
+}
+
+void GL_APIENTRY glPopMatrix(void) {
+  int *depth = sGL.matrixMode == GL_PROJECTION ? &sGL.projectionDepth
+                                               : &sGL.modelviewDepth;
+  if (*depth == 1) {
+    setError(GL_STACK_UNDERFLOW);
+    return;
+  }
+  --*depth;
+}
+
+void GL_APIENTRY glPushMatrix(void) {
+  const int projection = sGL.matrixMode == GL_PROJECTION;
+  int *depth = projection ? &sGL.projectionDepth : &sGL.modelviewDepth;
+  const float *top = currentMatrix();
+  if (*depth == (projection ? PROJECTION_DEPTH : MODELVIEW_DEPTH)) {
+    setError(GL_STACK_OVERFLOW);
+    return;
+  }
+  ++*depth;
+  memcpy(currentMatrix(), top, 16 * sizeof(float));
+}
+
+void GL_APIENTRY glRotatex(GLfixed angle, GLfixed x, GLfixed y, GLfixed z) {
+  const float radians = angle / 65536.f * 3.14159265f / 180;
+  const float c = cosf(radians), s = sinf(radians);
+  float axis[3] = {x / 65536.f, y / 65536.f, z / 65536.f};
+  float m[16] = {0};
+
+  normalize(axis);
+  m[0] = axis[0] * axis[0] * (1 - c) + c;
+  m[1] = axis[1] * axis[0] * (1 - c) + axis[2] * s;
+  m[2] = axis[0] * axis[2] * (1 - c) - axis[1] * s;
+  m[4] = axis[0] * axis[1] * (1 - c) - axis[2] * s;
+  m[5] = axis[1] * axis[1] * (1 - c) + c;
+  m[6] = axis[1] * axis[2] * (1 - c) + axis[0] * s;
+  m[8] = axis[0] * axis[2] * (1 - c) + axis[1] * s;
+  m[9] = axis[1] * axis[2] * (1 - c) - axis[0] * s;
+  m[10] = axis[2] * axis[2] * (1 - c) + c;
+  m[15] = 1;
+  multiply(currentMatrix(), m);
+}
+
+void GL_APIENTRY glScalex(GLfixed x, GLfixed y, GLfixed z) {
+  float m[16] = {0};
+  m[0] = x / 65536.f;
+  m[5] = y / 65536.f;
+  m[10] = z / 65536.f;
+  m[15] = 1;
+  multiply(currentMatrix(), m);
+}
+
+void GL_APIENTRY glShadeModel(GLenum mode) {
+  if (mode != GL_FLAT && mode != GL_SMOOTH) {
+    setError(GL_INVALID_ENUM);
+    return;
+  }
+  sGL.shadeModel = mode;
+}
+
+void GL_APIENTRY glTranslatex(GLfixed x, GLfixed y, GLfixed z) {
+  float m[16];
+  loadIdentity(m);
+  m[12] = x / 65536.f;
+  m[13] = y / 65536.f;
+  m[14] = z / 65536.f;
+  multiply(currentMatrix(), m);
+}
+
+void GL_APIENTRY glVertexPointer(GLint size, GLenum type, GLsizei stride,
+                                 const void *pointer) {
+  if (type != GL_FIXED && type != GL_FLOAT) {
+    setError(GL_INVALID_ENUM);
+    return;
+  }
+  if (size < 2 || size > 4 || stride < 0) {
+    setError(GL_INVALID_VALUE);
+    return;
+  }
+  setArray(&sGL.vertexArray, size, type, stride, pointer);
+}
+
+void GL_APIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+  if (width < 0 || height < 0) {
+    setError(GL_INVALID_VALUE);
+    return;
+  }
+  sGL.viewport[0] = x;
+  sGL.viewport[1] = y;
+  sGL.viewport[2] = width;
+  sGL.viewport[3] = height;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * A software OpenGL ES 1.x for the fixed function subset the demo uses, to
+ * run appRender() on a machine without a GPU. softgl.c defines the gl*
+ * functions of demo.c and importgl.h (link it instead of libGLESv1_CM):
+ * vertices are transformed, lit and clipped on the calling thread, and the
+ * triangles binned to tiles of the framebuffer, which glFinish() rasterizes
+ * on several threads. The triangles of a tile are drawn in order, so the
+ * image does not depend on the number of threads.
+ *
+ * Supported: GL_FIXED and GL_FLOAT client arrays (and GL_UNSIGNED_BYTE
+ * colors), triangles (points and lines are not drawn), the modelview and
+ * projection stacks, up to 8 directional or positional lights without
+ * attenuation or spot, color material, flat and smooth (Gouraud) shading,
+ * back face culling, the GL_LESS depth test and blending.
+ */
+#ifndef SOFTGL_H_INCLUDED
+#define SOFTGL_H_INCLUDED
+
+#include <GLES/gl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Makes the context, with a width x height framebuffer rasterized on up to
+ * threads threads (0 for one per CPU). Returns 0 on failure.
+ */
+extern int softGLInit(int width, int height, int threads);
+extern void softGLDeinit();
+
+/* The color buffer, finished: RGBA bytes, width * 4 per row, the bottom
+ * row first as in glReadPixels().
+ */
+extern const GLubyte *softGLColorBuffer();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !SOFTGL_H_INCLUDED
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// ring_allocator_test.cpp
+// Checks UniformRingAllocator, the uniform ring bookkeeping of more-teapots,
+// without GL: block alignment, running out of a frame region, and the
+// regions coming back around after kNumFrames frames.
+//
+// usage: ring_allocator_test (exits with 1 if a check fails)
+//--------------------------------------------------------------------------------
+#include <stdio.h>
+
+#include "UniformRingAllocator.h"
+
+static int32_t failures = 0;
+
+#define CHECK_EQ(actual, expected)                                         \
+  do {                                                                     \
+    int32_t a = (actual), e = (expected);                                  \
+    if (a != e) {                                                          \
+      printf("%s:%d: %s is %d, expected %d\n", __FILE__, __LINE__, #actual, \
+             a, e);                                                        \
+      failures++;                                                          \
+    }                                                                      \
+  } while (0)
+
+static void TestAlignUp() {
+  CHECK_EQ(UniformRingAllocator::AlignUp(0, 256), 0);
+  CHECK_EQ(UniformRingAllocator::AlignUp(1, 256), 256);
+  CHECK_EQ(UniformRingAllocator::AlignUp(256, 256), 256);
+  CHECK_EQ(UniformRingAllocator::AlignUp(257, 256), 512);
+  CHECK_EQ(UniformRingAllocator::AlignUp(100, 1), 100);
+}
+
+// blocks start on alignment boundaries, in every frame region
+static void TestAlignment() {
+  UniformRingAllocator allocator;
+  // the frame size is rounded up so that every region starts aligned
+  allocator.Init(1000, 256);
+  CHECK_EQ(allocator.GetFrameSize(), 1024);
+  CHECK_EQ(allocator.GetBufferSize(),
+           1024 * UniformRingAllocator::kNumFrames);
+
+  for (int32_t frame = 0; frame < UniformRingAllocator::kNumFrames; ++frame) {
+    CHECK_EQ(allocator.BeginFrame(), frame);
+    int32_t base = frame * 1024;
+    CHECK_EQ(allocator.Allocate(100), base);
+    CHECK_EQ(allocator.Allocate(100), base + 256);
+    CHECK_EQ(allocator.Allocate(256), base + 512);
+    CHECK_EQ(allocator.GetFrameUsed(), 768);
+  }
+
+  // an alignment of 0 (not queried) means none
+  allocator.Init(10, 0);
+  allocator.BeginFrame();
+  CHECK_EQ(allocator.Allocate(3), 0);
+  CHECK_EQ(allocator.Allocate(3), 3);
+}
+
+// a full region returns -1 and stays as it was; the next frame has room
+static void TestOverflow() {
+  UniformRingAllocator allocator;
+  allocator.Init(512, 256);
+  allocator.BeginFrame();
+  CHECK_EQ(allocator.Allocate(0), -1);
+  CHECK_EQ(allocator.Allocate(-4), -1);
+  CHECK_EQ(allocator.Allocate(513), -1);
+  CHECK_EQ(allocator.GetFrameUsed(), 0);
+
+  CHECK_EQ(allocator.Allocate(300), 0);
+  // 300 rounds up to 512, which leaves nothing
+  CHECK_EQ(allocator.Allocate(1), -1);
+  CHECK_EQ(allocator.GetFrameUsed(), 300);
+
+  CHECK_EQ(allocator.BeginFrame(), 1);
+  CHECK_EQ(allocator.Allocate(512), 512);
+  CHECK_EQ(allocator.Allocate(1), -1);
+}
+
+// regions are handed out in turn, and each frame starts empty
+static void TestWraparound() {
+  UniformRingAllocator allocator;
+  allocator.Init(256, 256);
+  for (int32_t frame = 0; frame < 4 * UniformRingAllocator::kNumFrames;
+       ++frame) {
+    int32_t index = frame % UniformRingAllocator::kNumFrames;
+    CHECK_EQ(allocator.BeginFrame(), index);
+    CHECK_EQ(allocator.GetFrameIndex(), index);
+    CHECK_EQ(allocator.GetFrameOffset(), index * 256);
+    CHECK_EQ(allocator.GetFrameUsed(), 0);
+    CHECK_EQ(allocator.Allocate(200), index * 256);
+  }
+
+  // Init() starts over from the first region
+  allocator.Init(256, 256);
+  CHECK_EQ(allocator.BeginFrame(), 0);
+}
+
+static void TestInstancesPerBlock() {
+  // 16 KB blocks of 144 byte instances (two matrices and a vector)
+  CHECK_EQ(UniformRingAllocator::ComputeInstancesPerBlock(1000, 16384, 144),
+           113);
+  CHECK_EQ(UniformRingAllocator::ComputeInstancesPerBlock(50, 16384, 144), 50);
+  CHECK_EQ(UniformRingAllocator::ComputeInstancesPerBlock(50, 100, 144), 1);
+  CHECK_EQ(UniformRingAllocator::ComputeInstancesPerBlock(50, 16384, 0), 50);
+}
+
+int main() {
+  TestAlignUp();
+  TestAlignment();
+  TestOverflow();
+  TestWraparound();
+  TestInstancesPerBlock();
+  if (failures) {
+    printf("%d checks failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
@@ -25,16 +25,28 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 //--------------------------------------------------------------------------------
 // Teapot model data
 //--------------------------------------------------------------------------------
 #include "teapot.inl"
 
+//--------------------------------------------------------------------------------
+// Constants
+//--------------------------------------------------------------------------------
+static const GLuint UBO_BINDING_POINT = 1;
+// Upper bound for a single wait on a ring region fence, in nanoseconds
+static const GLuint64 UBO_FENCE_TIMEOUT = 1000000000ull;
+
 //--------------------------------------------------------------------------------
 // Ctor
 //--------------------------------------------------------------------------------
 MoreTeapotsRenderer::MoreTeapotsRenderer()
-    : geometry_instancing_support_(false) {}
+    : ubo_(0), geometry_instancing_support_(false) {
+  for (int32_t i = 0; i < UniformRingAllocator::kNumFrames; ++i)
+    ubo_fences_[i] = NULL;
+}
 
 //--------------------------------------------------------------------------------
 // Dtor
@@ -124,11 +136,20 @@ void MoreTeapotsRenderer::Init(const int32_t numX, const int32_t numY,
       }
 
   if (geometry_instancing_support_) {
+    //
+    // The uniform block can hold only GL_MAX_UNIFORM_BLOCK_SIZE bytes (16KB
+    // on many devices), so teapots are split into several instanced draws.
+    // std140 layout: Mat4 + Mat4 + Vec3 padded to a Vec4 per instance.
+    GLint max_block_size = 0;
+    glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &max_block_size);
+    instances_per_block_ = UniformRingAllocator::ComputeInstancesPerBlock(
+        teapot_x_ * teapot_y_ * teapot_z_, max_block_size,
+        (16 + 16 + 4) * sizeof(float));
+
     //
     // Create parameter dictionary for shader patch
     std::map<std::string, std::string> param;
-    param[std::string("%NUM_TEAPOT%")] =
-        ToString(teapot_x_ * teapot_y_ * teapot_z_);
+    param[std::string("%NUM_TEAPOT%")] = ToString(instances_per_block_);
     param[std::string("%LOCATION_VERTEX%")] = ToString(ATTRIB_VERTEX);
     param[std::string("%LOCATION_NORMAL%")] = ToString(ATTRIB_NORMAL);
     if (arb_support_)
@@ -143,10 +164,10 @@ void MoreTeapotsRenderer::Init(const int32_t numX, const int32_t numY,
       //
       // Create uniform buffer
       //
-      GLuint bindingPoint = 1;
       GLuint blockIndex;
       blockIndex = glGetUniformBlockIndex(shader_param_.program_, "ParamBlock");
-      glUniformBlockBinding(shader_param_.program_, blockIndex, bindingPoint);
+      glUniformBlockBinding(shader_param_.program_, blockIndex,
+                            UBO_BINDING_POINT);
 
       // Retrieve array stride value
       int32_t num_indices;
@@ -162,26 +183,27 @@ void MoreTeapotsRenderer::Init(const int32_t numX, const int32_t numY,
       ubo_matrix_stride_ = stride[0] / sizeof(float);
       ubo_vector_stride_ = stride[2] / sizeof(float);
 
+      GLint block_size = 0;
+      glGetActiveUniformBlockiv(shader_param_.program_, blockIndex,
+                                GL_UNIFORM_BLOCK_DATA_SIZE, &block_size);
+      GLint alignment = 0;
+      glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+      ubo_block_size_ = block_size;
+
+      // Every frame gets its own region holding all blocks of that frame
+      int32_t num_blocks =
+          (teapot_x_ * teapot_y_ * teapot_z_ + instances_per_block_ - 1) /
+          instances_per_block_;
+      ubo_allocator_.Init(
+          num_blocks * UniformRingAllocator::AlignUp(block_size, alignment),
+          alignment);
+      ubo_block_offsets_.resize(num_blocks);
+
       glGenBuffers(1, &ubo_);
       glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
-      glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, ubo_);
-
-      // Store color value which wouldn't be updated every frame
-      int32_t size = teapot_x_ * teapot_y_ * teapot_z_ *
-                     (ubo_matrix_stride_ + ubo_matrix_stride_ +
-                      ubo_vector_stride_);  // Mat4 + Mat4 + Vec3 + 1 stride
-      float* pBuffer = new float[size];
-      float* pColor =
-          pBuffer + teapot_x_ * teapot_y_ * teapot_z_ * ubo_matrix_stride_ * 2;
-      for (int32_t i = 0; i < teapot_x_ * teapot_y_ * teapot_z_; ++i) {
-        memcpy(pColor, &vec_colors_[i], 3 * sizeof(float));
-        pColor += ubo_vector_stride_;  // Assuming std140 layout which is 4
-                                       // DWORD stride for vectors
-      }
-
-      glBufferData(GL_UNIFORM_BUFFER, size * sizeof(float), pBuffer,
+      glBufferData(GL_UNIFORM_BUFFER, ubo_allocator_.GetBufferSize(), NULL,
                    GL_DYNAMIC_DRAW);
-      delete[] pBuffer;
+      glBindBuffer(GL_UNIFORM_BUFFER, 0);
     } else {
       LOGI("Shader compilation failed!! Falls back to ES2.0 pass");
       // This happens some devices.
@@ -228,6 +250,12 @@ void MoreTeapotsRenderer::Unload() {
     glDeleteBuffers(1, &ubo_);
     ubo_ = 0;
   }
+  for (int32_t i = 0; i < UniformRingAllocator::kNumFrames; ++i) {
+    if (ubo_fences_[i]) {
+      glDeleteSync(ubo_fences_[i]);
+      ubo_fences_[i] = NULL;
+    }
+  }
   if (ibo_) {
     glDeleteBuffers(1, &ibo_);
     ibo_ = 0;
@@ -301,39 +329,82 @@ void MoreTeapotsRenderer::Render() {
     // Geometry instancing, new feature in GLES3.0
     //
 
-    // Update UBO
-    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
-    float* p = (float*)glMapBufferRange(
-        GL_UNIFORM_BUFFER, 0,
-        teapot_x_ * teapot_y_ * teapot_z_ * (ubo_matrix_stride_ * 2) *
-            sizeof(float),
-        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
-    float* mat_mvp = p;
-    float* mat_mv = p + teapot_x_ * teapot_y_ * teapot_z_ * ubo_matrix_stride_;
-    for (int32_t i = 0; i < teapot_x_ * teapot_y_ * teapot_z_; ++i) {
-      // Rotation
-      float x, y;
-      vec_current_rotations_[i] += vec_rotations_[i];
-      vec_current_rotations_[i].Value(x, y);
-      ndk_helper::Mat4 mat_rotation =
-          ndk_helper::Mat4::RotationX(x) * ndk_helper::Mat4::RotationY(y);
+    // Pick the next ring region and make sure the GPU is done reading it;
+    // with three regions this normally returns immediately.
+    const int32_t frame = ubo_allocator_.BeginFrame();
+    WaitFrameFence(frame);
 
-      // Feed Projection and Model View matrices to the shaders
-      ndk_helper::Mat4 mat_v = mat_view_ * vec_mat_models_[i] * mat_rotation;
-      ndk_helper::Mat4 mat_vp = mat_projection_ * mat_v;
+    const int32_t num_teapots = teapot_x_ * teapot_y_ * teapot_z_;
+    int32_t num_blocks =
+        (num_teapots + instances_per_block_ - 1) / instances_per_block_;
 
-      memcpy(mat_mvp, mat_vp.Ptr(), sizeof(mat_v));
-      mat_mvp += ubo_matrix_stride_;
+    // Update UBO. The region is fenced, so no implicit synchronization with
+    // the previous frames is needed.
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    uint8_t* region = (uint8_t*)glMapBufferRange(
+        GL_UNIFORM_BUFFER, ubo_allocator_.GetFrameOffset(),
+        ubo_allocator_.GetFrameSize(),
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+            GL_MAP_UNSYNCHRONIZED_BIT);
+    if (region == NULL) {
+      glBindBuffer(GL_UNIFORM_BUFFER, 0);
+      return;
+    }
 
-      memcpy(mat_mv, mat_v.Ptr(), sizeof(mat_v));
-      mat_mv += ubo_matrix_stride_;
+    for (int32_t block = 0; block < num_blocks; ++block) {
+      int32_t offset = ubo_allocator_.Allocate(ubo_block_size_);
+      if (offset < 0 || block >= (int32_t)ubo_block_offsets_.size()) {
+        // The region holds the blocks counted in Init(); teapots beyond
+        // them are not drawn
+        num_blocks = block;
+        break;
+      }
+      ubo_block_offsets_[block] = offset;
+      float* p = (float*)(region + offset - ubo_allocator_.GetFrameOffset());
+      float* mat_mvp = p;
+      float* mat_mv = p + instances_per_block_ * ubo_matrix_stride_;
+      float* color = p + instances_per_block_ * ubo_matrix_stride_ * 2;
+
+      int32_t begin = block * instances_per_block_;
+      int32_t end = std::min(begin + instances_per_block_, num_teapots);
+      for (int32_t i = begin; i < end; ++i) {
+        // Rotation
+        float x, y;
+        vec_current_rotations_[i] += vec_rotations_[i];
+        vec_current_rotations_[i].Value(x, y);
+        ndk_helper::Mat4 mat_rotation =
+            ndk_helper::Mat4::RotationX(x) * ndk_helper::Mat4::RotationY(y);
+
+        // Feed Projection and Model View matrices to the shaders
+        ndk_helper::Mat4 mat_v = mat_view_ * vec_mat_models_[i] * mat_rotation;
+        ndk_helper::Mat4 mat_vp = mat_projection_ * mat_v;
+
+        memcpy(mat_mvp, mat_vp.Ptr(), sizeof(mat_v));
+        mat_mvp += ubo_matrix_stride_;
+
+        memcpy(mat_mv, mat_v.Ptr(), sizeof(mat_v));
+        mat_mv += ubo_matrix_stride_;
+
+        memcpy(color, &vec_colors_[i], 3 * sizeof(float));
+        color += ubo_vector_stride_;  // Assuming std140 layout which is 4
+                                      // DWORD stride for vectors
+      }
     }
     glUnmapBuffer(GL_UNIFORM_BUFFER);
 
-    // Instanced rendering
-    glDrawElementsInstanced(GL_TRIANGLES, num_indices_, GL_UNSIGNED_SHORT,
-                            BUFFER_OFFSET(0),
-                            teapot_x_ * teapot_y_ * teapot_z_);
+    // Instanced rendering, one draw per uniform block
+    for (int32_t block = 0; block < num_blocks; ++block) {
+      int32_t begin = block * instances_per_block_;
+      int32_t count = std::min(instances_per_block_, num_teapots - begin);
+      glBindBufferRange(GL_UNIFORM_BUFFER, UBO_BINDING_POINT, ubo_,
+                        ubo_block_offsets_[block], ubo_block_size_);
+      glDrawElementsInstanced(GL_TRIANGLES, num_indices_, GL_UNSIGNED_SHORT,
+                              BUFFER_OFFSET(0), count);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // Guard this region until the GPU has consumed it
+    ubo_fences_[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 
   } else {
     // Regular rendering pass
@@ -523,6 +594,22 @@ bool MoreTeapotsRenderer::Bind(ndk_helper::TapCamera* camera) {
   return true;
 }
 
+//--------------------------------------------------------------------------------
+// WaitFrameFence
+//--------------------------------------------------------------------------------
+void MoreTeapotsRenderer::WaitFrameFence(const int32_t frame) {
+  if (ubo_fences_[frame] == NULL) return;
+
+  GLenum result = glClientWaitSync(ubo_fences_[frame],
+                                   GL_SYNC_FLUSH_COMMANDS_BIT,
+                                   UBO_FENCE_TIMEOUT);
+  if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+    LOGI("Uniform ring fence wait failed: 0x%x", result);
+  }
+  glDeleteSync(ubo_fences_[frame]);
+  ubo_fences_[frame] = NULL;
+}
+
 //--------------------------------------------------------------------------------
 // Helper functions
 //--------------------------------------------------------------------------------
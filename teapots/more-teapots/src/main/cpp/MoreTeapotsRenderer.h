@@ -40,6 +40,7 @@
 #define APPLICATION_CLASS_NAME "com/sample/moreteapots/MoreTeapotsApplication"
 
 #include "NDKHelper.h"
+#include "UniformRingAllocator.h"
 
 #define BUFFER_OFFSET(i) ((char*)NULL + (i))
 
@@ -99,10 +100,16 @@ class MoreTeapotsRenderer {
   int32_t teapot_z_;
   int32_t ubo_matrix_stride_;
   int32_t ubo_vector_stride_;
+  int32_t ubo_block_size_;
+  int32_t instances_per_block_;
+  UniformRingAllocator ubo_allocator_;
+  std::vector<int32_t> ubo_block_offsets_;  // of this frame's blocks
+  GLsync ubo_fences_[UniformRingAllocator::kNumFrames];
   bool geometry_instancing_support_;
   bool arb_support_;
 
   std::string ToString(const int32_t i);
+  void WaitFrameFence(const int32_t frame);
 
  public:
   MoreTeapotsRenderer();
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// UniformRingAllocator.cpp
+//--------------------------------------------------------------------------------
+#include "UniformRingAllocator.h"
+
+UniformRingAllocator::UniformRingAllocator()
+    : frame_size_(0), alignment_(1), frame_index_(kNumFrames - 1), head_(0) {}
+
+void UniformRingAllocator::Init(const int32_t frame_size,
+                                const int32_t alignment) {
+  alignment_ = alignment > 0 ? alignment : 1;
+  // Keep every frame region aligned so its first block is aligned too
+  frame_size_ = AlignUp(frame_size, alignment_);
+  frame_index_ = kNumFrames - 1;
+  head_ = 0;
+}
+
+int32_t UniformRingAllocator::BeginFrame() {
+  frame_index_ = (frame_index_ + 1) % kNumFrames;
+  head_ = 0;
+  return frame_index_;
+}
+
+int32_t UniformRingAllocator::Allocate(const int32_t size) {
+  int32_t offset = AlignUp(head_, alignment_);
+  if (size <= 0 || offset + size > frame_size_) return -1;
+  head_ = offset + size;
+  return GetFrameOffset() + offset;
+}
+
+int32_t UniformRingAllocator::AlignUp(const int32_t value,
+                                      const int32_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+int32_t UniformRingAllocator::ComputeInstancesPerBlock(
+    const int32_t num_instances, const int32_t max_block_size,
+    const int32_t instance_size) {
+  if (instance_size <= 0) return num_instances;
+  int32_t n = max_block_size / instance_size;
+  if (n < 1) n = 1;
+  return n < num_instances ? n : num_instances;
+}
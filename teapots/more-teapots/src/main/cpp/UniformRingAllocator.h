@@ -0,0 +1,71 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//--------------------------------------------------------------------------------
+// UniformRingAllocator.h
+// CPU side bookkeeping for a multi-buffered uniform ring buffer.
+//
+// The ring is split into kNumFrames equally sized regions, one per frame in
+// flight. Each frame sub-allocates blocks from its own region; the region is
+// handed out again only after kNumFrames frames, by which time the renderer
+// has waited on the fence that guards it. No GL calls are made here, so the
+// allocator can be exercised without a GL context.
+//--------------------------------------------------------------------------------
+#ifndef _UniformRingAllocator_H
+#define _UniformRingAllocator_H
+
+#include <stdint.h>
+
+class UniformRingAllocator {
+ public:
+  static const int32_t kNumFrames = 3;
+
+  UniformRingAllocator();
+
+  // frame_size is the number of bytes a single frame may sub-allocate,
+  // alignment is GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT (or any power of two).
+  void Init(const int32_t frame_size, const int32_t alignment);
+
+  // Advances to the next region and returns its index, which is also the
+  // index of the fence guarding it.
+  int32_t BeginFrame();
+
+  // Returns the absolute buffer offset of an aligned block of size bytes,
+  // or -1 when the current frame region is exhausted.
+  int32_t Allocate(const int32_t size);
+
+  int32_t GetBufferSize() const { return frame_size_ * kNumFrames; }
+  int32_t GetFrameSize() const { return frame_size_; }
+  int32_t GetFrameIndex() const { return frame_index_; }
+  int32_t GetFrameOffset() const { return frame_index_ * frame_size_; }
+  int32_t GetFrameUsed() const { return head_; }
+
+  static int32_t AlignUp(const int32_t value, const int32_t alignment);
+
+  // Number of instances that fit a uniform block of max_block_size bytes
+  // when each instance needs instance_size bytes, clamped to num_instances.
+  static int32_t ComputeInstancesPerBlock(const int32_t num_instances,
+                                          const int32_t max_block_size,
+                                          const int32_t instance_size);
+
+ private:
+  int32_t frame_size_;
+  int32_t alignment_;
+  int32_t frame_index_;
+  int32_t head_;
+};
+
+#endif
@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * WebpAnimPlayer playing an animation for a few loops, with a display
+ * polling it at every vsync (60 Hz) and drawing each new frame into a
+ * window sized buffer, for cache budgets from a few frames to the whole
+ * animation:
+ *   - frames per second shown, and how many came late
+ *   - time to draw a frame into the window (the display thread's share)
+ *   - frames decoded, and shown from the cache
+ *   - decode time per frame, and cache memory at most
+ * The animation is made up (a large one, so the cache matters) unless a
+ * file is given.
+ *
+ * usage: anim_bench [loops] [frames width height duration ms] [file.webp]
+ */
+#include <webp/decode.h>
+#include <webp/encode.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "webp_anim.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// serves one file held in memory
+class MemoryFileReader : public WebpFileReader {
+ public:
+  explicit MemoryFileReader(const std::vector<uint8_t>& data) : data_(data) {}
+  const uint8_t* Read(const char* name, size_t* size) override {
+    *size = data_.size();
+    return data_.data();
+  }
+
+ private:
+  const std::vector<uint8_t>& data_;
+};
+
+static void Put24(std::vector<uint8_t>& out, uint32_t value) {
+  for (int idx = 0; idx < 3; idx++) out.push_back((value >> (idx * 8)) & 0xff);
+}
+static void Put32(std::vector<uint8_t>& out, uint32_t value) {
+  Put24(out, value);
+  out.push_back(value >> 24);
+}
+static void PutChunk(std::vector<uint8_t>& out, const char* fourcc,
+                     const std::vector<uint8_t>& payload) {
+  out.insert(out.end(), fourcc, fourcc + 4);
+  Put32(out, static_cast<uint32_t>(payload.size()));
+  out.insert(out.end(), payload.begin(), payload.end());
+  if (payload.size() & 1) out.push_back(0);
+}
+
+/*
+ * MakeAnimation():
+ *     Encodes frameCount full canvas frames (moving rings over a gradient,
+ *     so that VP8 has something to work on) and puts them in an animated
+ *     webp container: VP8X, ANIM, then one ANMF chunk per frame.
+ */
+static std::vector<uint8_t> MakeAnimation(uint32_t frameCount, int32_t width,
+                                          int32_t height,
+                                          uint32_t durationMs) {
+  std::vector<uint8_t> body;
+  std::vector<uint8_t> vp8x = {0x02, 0, 0, 0};  // animation
+  Put24(vp8x, width - 1);
+  Put24(vp8x, height - 1);
+  PutChunk(body, "VP8X", vp8x);
+  std::vector<uint8_t> anim;
+  Put32(anim, 0xff000000);  // background
+  anim.push_back(0);        // loop forever
+  anim.push_back(0);
+  PutChunk(body, "ANIM", anim);
+
+  std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+  for (uint32_t frame = 0; frame < frameCount; frame++) {
+    float phase = 6.2831853f * frame / frameCount;
+    float cx = width * (0.5f + 0.3f * std::cos(phase));
+    float cy = height * (0.5f + 0.3f * std::sin(phase));
+    for (int32_t y = 0; y < height; y++) {
+      uint8_t* p = &rgba[static_cast<size_t>(y) * width * 4];
+      for (int32_t x = 0; x < width; x++, p += 4) {
+        float dist = std::hypot(x - cx, y - cy);
+        uint8_t ring = static_cast<uint8_t>(128 + 127 * std::sin(dist / 9));
+        p[0] = ring;
+        p[1] = static_cast<uint8_t>(255 * x / width);
+        p[2] = static_cast<uint8_t>(255 * y / height) ^ (ring >> 2);
+        p[3] = 0xff;
+      }
+    }
+    uint8_t* encoded = nullptr;
+    size_t size =
+        WebPEncodeRGBA(rgba.data(), width, height, width * 4, 75, &encoded);
+    if (!size) return std::vector<uint8_t>();
+
+    // a frame's payload: its position, size, duration and the bitstream
+    // chunks of the still picture (everything after "RIFF....WEBP")
+    std::vector<uint8_t> anmf;
+    Put24(anmf, 0);
+    Put24(anmf, 0);
+    Put24(anmf, width - 1);
+    Put24(anmf, height - 1);
+    Put24(anmf, durationMs);
+    anmf.push_back(0x02);  // no blending, no disposal
+    anmf.insert(anmf.end(), encoded + 12, encoded + size);
+    free(encoded);
+    PutChunk(body, "ANMF", anmf);
+  }
+
+  std::vector<uint8_t> file;
+  PutChunk(file, "RIFF", std::vector<uint8_t>());
+  file.resize(4);
+  Put32(file, static_cast<uint32_t>(body.size() + 4));
+  file.insert(file.end(), {'W', 'E', 'B', 'P'});
+  file.insert(file.end(), body.begin(), body.end());
+  return file;
+}
+
+static bool ReadFile(const char* path, std::vector<uint8_t>& data) {
+  FILE* file = fopen(path, "rb");
+  if (!file) return false;
+  fseek(file, 0, SEEK_END);
+  data.resize(ftell(file));
+  fseek(file, 0, SEEK_SET);
+  data.resize(fread(data.data(), 1, data.size(), file));
+  fclose(file);
+  return true;
+}
+
+// peak resident memory of the process, in KB
+static long PeakRssKb(void) {
+  FILE* file = fopen("/proc/self/status", "r");
+  if (!file) return -1;
+  char line[256];
+  long kb = -1;
+  while (fgets(line, sizeof(line), file)) {
+    if (!strncmp(line, "VmHWM:", 6)) kb = atol(line + 6);
+  }
+  fclose(file);
+  return kb;
+}
+
+int main(int argc, char** argv) {
+  uint32_t loops = argc > 1 ? atoi(argv[1]) : 3;
+  uint32_t frameCount = argc > 5 ? atoi(argv[2]) : 120;
+  int32_t width = argc > 5 ? atoi(argv[3]) : 1280;
+  int32_t height = argc > 5 ? atoi(argv[4]) : 720;
+  uint32_t durationMs = argc > 5 ? atoi(argv[5]) : 33;
+  const char* path = argc == 3 ? argv[2] : argc > 6 ? argv[6] : nullptr;
+
+  std::vector<uint8_t> data;
+  if (path) {
+    if (!ReadFile(path, data)) {
+      fprintf(stderr, "Can't read %s\n", path);
+      return 1;
+    }
+  } else {
+    auto start = Clock::now();
+    data = MakeAnimation(frameCount, width, height, durationMs);
+    printf("made the animation, %zu KB, in %.1f s\n", data.size() / 1024,
+           std::chrono::duration<double>(Clock::now() - start).count());
+  }
+  MemoryFileReader reader(data);
+
+  // output at the canvas size, so the numbers are the decoder's
+  WebPBitstreamFeatures features;
+  if (WebPGetFeatures(data.data(), data.size(), &features) != VP8_STATUS_OK ||
+      !features.has_animation) {
+    fprintf(stderr, "Not an animated webp\n");
+    return 1;
+  }
+  DecodeSurfaceDescriptor output;
+  output.format_ = SurfaceFormat::SURFACE_FORMAT_RGBA_8888;
+  output.width_ = output.stride_ = features.width;
+  output.height_ = features.height;
+  size_t frameBytes = static_cast<size_t>(output.stride_) * output.height_ * 4;
+  uint32_t loopDuration;
+  {
+    WebpAnimPlayer player("", &reader, output, 0);
+    if (!player.IsValid()) {
+      fprintf(stderr, "Unable to open the animation\n");
+      return 1;
+    }
+    frameCount = player.FrameCount();
+    loopDuration = player.LoopDuration();
+  }
+  printf("%u frames of %dx%d, %.1f fps, %zu KB decoded per frame\n",
+         frameCount, output.width_, output.height_,
+         frameCount * 1000.0 / loopDuration, frameBytes / 1024);
+
+  printf("%-10s %7s %6s %6s %8s %6s %8s %8s %8s %10s\n", "cache", "fps",
+         "late", "shown", "decoded", "hits", "avg ms", "max ms", "draw ms",
+         "peak KB");
+  // window rows are padded, as ANativeWindow_lock() gives them
+  int32_t windowStride = (output.width_ + 63) & ~63;
+  const uint32_t budgets[] = {4, frameCount / 2, frameCount};
+  for (uint32_t budget : budgets) {
+    WebpAnimPlayer player("", &reader, output, budget * frameBytes);
+    std::vector<uint8_t> window(static_cast<size_t>(windowStride) *
+                                output.height_ * 4);
+    uint32_t index, shownIndex = UINT32_MAX;
+    while (!player.GetFrame(0, &index)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto start = Clock::now();
+    std::chrono::microseconds vsync(16667);
+    uint32_t shown = 0;
+    double drawMs = 0.0;
+    uint32_t playMs = loops * loopDuration;
+    for (auto now = start; now - start < std::chrono::milliseconds(playMs);
+         now = Clock::now()) {
+      uint32_t timeMs = static_cast<uint32_t>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(now - start)
+              .count());
+      player.GetFrame(timeMs, &index);
+      if (index != shownIndex) {
+        auto drawStart = Clock::now();
+        player.DrawFrame(window.data(), windowStride);
+        drawMs += std::chrono::duration<double, std::milli>(Clock::now() -
+                                                            drawStart)
+                      .count();
+        shown++;
+      }
+      shownIndex = index;
+      std::this_thread::sleep_until(now + vsync);
+    }
+    double seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    AnimStats stats = player.GetStats();
+    printf("%3u frames %7.1f %6u %6u %8u %6u %8.2f %8.2f %8.3f %10zu\n",
+           budget, shown / seconds, stats.framesLate_, stats.framesShown_,
+           stats.framesDecoded_, stats.cacheHits_, stats.avgDecodeMs_,
+           stats.maxDecodeMs_, shown ? drawMs / shown : 0.0,
+           stats.peakCacheBytes_ / 1024);
+  }
+  printf("process peak RSS %ld KB\n", PeakRssKb());
+  return 0;
+}
@@ -0,0 +1,454 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The tuning matrix behind DecodePreset: every webp picture of the corpus
+ * (the asset directory, plus a made up 1920x1080 one) decoded with each
+ * combination of the libwebp options (filtering, fancy upsampling,
+ * threads), into each output format (RGB565, RGBA, YUV 420), scaled by
+ * 0.5, 1 and 2. For each:
+ *   - decode time
+ *   - libwebp's heap at most while decoding, and the output's size
+ *   - PSNR against the full quality decode (libwebp's default options) at
+ *     the same size: RGB against RGBA, YUV against YUV
+ * The summary averages the corpus: time relative to the full quality
+ * decode, and the lowest PSNR. Then what rescaling costs at 1:1, which
+ * DecodeWebpFrame() skips.
+ *
+ * usage: decode_bench [-v (every picture)] [asset dir]
+ */
+#include <malloc.h>
+#include <webp/decode.h>
+#include <webp/encode.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+#include "webp_frame.h"
+
+typedef std::chrono::steady_clock Clock;
+
+#ifdef __GLIBC__
+/*
+ * The heap in use, and its peak: malloc and friends are replaced, so that
+ * libwebp's allocations are counted too.
+ */
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+static std::atomic<long> heapNow(0), heapPeak(0);
+
+static void* Track(void* ptr) {
+  if (ptr) {
+    long now = heapNow += malloc_usable_size(ptr);
+    long peak = heapPeak;
+    while (now > peak && !heapPeak.compare_exchange_weak(peak, now)) {
+    }
+  }
+  return ptr;
+}
+extern "C" void* malloc(size_t size) { return Track(__libc_malloc(size)); }
+extern "C" void* calloc(size_t count, size_t size) {
+  return Track(__libc_calloc(count, size));
+}
+extern "C" void* realloc(void* ptr, size_t size) {
+  if (ptr) heapNow -= malloc_usable_size(ptr);
+  return Track(__libc_realloc(ptr, size));
+}
+extern "C" void free(void* ptr) {
+  if (ptr) heapNow -= malloc_usable_size(ptr);
+  __libc_free(ptr);
+}
+static void ResetHeapPeak(void) { heapPeak = heapNow.load(); }
+static long HeapPeakSince(long start) { return heapPeak - start; }
+static long HeapNow(void) { return heapNow; }
+#else
+static void ResetHeapPeak(void) {}
+static long HeapPeakSince(long start) { return 0; }
+static long HeapNow(void) { return 0; }
+#endif
+
+struct Picture {
+  std::string name_;
+  std::vector<uint8_t> data_;
+  int32_t width_, height_;
+};
+
+static bool ReadFile(const std::string& path, std::vector<uint8_t>& data) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) return false;
+  fseek(file, 0, SEEK_END);
+  data.resize(ftell(file));
+  fseek(file, 0, SEEK_SET);
+  data.resize(fread(data.data(), 1, data.size(), file));
+  fclose(file);
+  return true;
+}
+
+// the still webp pictures of dir and its sub directories
+static void ReadCorpus(const std::string& dir, std::vector<Picture>& corpus) {
+  DIR* d = opendir(dir.c_str());
+  if (!d) return;
+  std::vector<std::string> names;
+  while (struct dirent* entry = readdir(d)) {
+    if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+  }
+  closedir(d);
+  std::sort(names.begin(), names.end());
+  for (const std::string& name : names) {
+    std::string path = dir + "/" + name;
+    if (name.size() < 5 || name.compare(name.size() - 5, 5, ".webp")) {
+      ReadCorpus(path, corpus);
+      continue;
+    }
+    Picture picture;
+    WebPBitstreamFeatures features;
+    if (!ReadFile(path, picture.data_) ||
+        WebPGetFeatures(picture.data_.data(), picture.data_.size(),
+                        &features) != VP8_STATUS_OK ||
+        features.has_animation) {
+      continue;
+    }
+    picture.name_ = name;
+    picture.width_ = features.width;
+    picture.height_ = features.height;
+    corpus.push_back(picture);
+  }
+}
+
+// a 1920x1080 picture with smooth areas, edges and noise, at quality 80
+static Picture MakePicture(void) {
+  Picture picture;
+  picture.name_ = "made-1920x1080";
+  picture.width_ = 1920;
+  picture.height_ = 1080;
+  std::vector<uint8_t> rgba(picture.width_ * picture.height_ * 4);
+  uint32_t seed = 1;
+  for (int32_t y = 0; y < picture.height_; y++) {
+    for (int32_t x = 0; x < picture.width_; x++) {
+      uint8_t* p = &rgba[(y * picture.width_ + x) * 4];
+      seed = seed * 1103515245 + 12345;
+      int noise = static_cast<int>((seed >> 16) & 15) - 8;
+      float ring = std::sin(std::hypot(x - 700.0f, y - 400.0f) / 23.0f);
+      bool square = (x / 120 + y / 120) % 2;
+      p[0] = static_cast<uint8_t>(std::min(255, std::max(
+          0, static_cast<int>(255 * x / picture.width_) + noise)));
+      p[1] = static_cast<uint8_t>(128 + 100 * ring);
+      p[2] = square ? 220 : static_cast<uint8_t>(64 + noise);
+      p[3] = 0xff;
+    }
+  }
+  uint8_t* encoded = nullptr;
+  size_t size = WebPEncodeRGBA(rgba.data(), picture.width_, picture.height_,
+                               picture.width_ * 4, 80, &encoded);
+  picture.data_.assign(encoded, encoded + size);
+  free(encoded);
+  return picture;
+}
+
+/*
+ * Rgb565IsNative(): libwebp writes RGB565 in memory order (big endian)
+ *                   unless built with WEBP_ENABLE_SWAP_16BIT_CSP, as the
+ *                   app does; find out which by decoding a red pixel
+ */
+static bool Rgb565IsNative(void) {
+  const uint8_t red[4] = {0xff, 0, 0, 0xff};
+  uint8_t* encoded = nullptr;
+  size_t size = WebPEncodeLosslessRGBA(red, 1, 1, 4, &encoded);
+  DecodeSurfaceDescriptor desc = {1, 1, 1,
+                                  SurfaceFormat::SURFACE_FORMAT_RGB_565};
+  uint16_t pixel = 0;
+  DecodeWebpFrame(encoded, size, desc, reinterpret_cast<uint8_t*>(&pixel),
+                  DecodePreset::DECODE_PRESET_QUALITY);
+  free(encoded);
+  return pixel == 0xf800;
+}
+static bool rgb565Native;
+
+// RGB of pixel x of a row, in 8 bits
+static void GetRgb(const uint8_t* row, SurfaceFormat format, int32_t x,
+                   int* rgb) {
+  if (format == SurfaceFormat::SURFACE_FORMAT_RGB_565) {
+    const uint8_t* p = row + x * 2;
+    uint16_t pixel = rgb565Native ? p[0] | (p[1] << 8) : (p[0] << 8) | p[1];
+    int r = pixel >> 11, g = (pixel >> 5) & 0x3f, b = pixel & 0x1f;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+  } else {
+    for (int c = 0; c < 3; c++) rgb[c] = row[x * 4 + c];
+  }
+}
+
+/*
+ * Psnr(): of pixels (laid out as desc) against ref, decoded as RGBA, or as
+ *         YUV for YUV pixels; all the planes / channels together
+ */
+static double Psnr(const DecodeSurfaceDescriptor& desc, const uint8_t* pixels,
+                   const uint8_t* ref) {
+  double squares = 0.0;
+  size_t count = 0;
+  if (desc.format_ == SurfaceFormat::SURFACE_FORMAT_YUV_420) {
+    size_t size = SurfaceBytes(desc);
+    for (size_t idx = 0; idx < size; idx++) {
+      int diff = pixels[idx] - ref[idx];
+      squares += diff * diff;
+    }
+    count = size;
+  } else {
+    uint32_t bpp = BytesPerPixel(desc.format_);
+    for (int32_t y = 0; y < desc.height_; y++) {
+      const uint8_t* row = pixels + y * desc.stride_ * bpp;
+      const uint8_t* refRow = ref + y * desc.stride_ * 4;
+      for (int32_t x = 0; x < desc.width_; x++) {
+        int rgb[3];
+        GetRgb(row, desc.format_, x, rgb);
+        for (int c = 0; c < 3; c++) {
+          int diff = rgb[c] - refRow[x * 4 + c];
+          squares += diff * diff;
+        }
+      }
+    }
+    count = static_cast<size_t>(desc.width_) * desc.height_ * 3;
+  }
+  if (squares == 0.0) return 99.0;
+  return 10.0 * std::log10(255.0 * 255.0 * count / squares);
+}
+
+struct Measure {
+  double ms_;
+  long heapBytes_;
+  bool ok_;
+};
+
+// the best of 5 runs of enough decodes for 20 ms (2 at least), after one
+// to warm up: on a busy machine the best run is the one to trust
+template <typename Decode>
+static Measure Time(Decode decode) {
+  Measure measure;
+  long start = HeapNow();
+  ResetHeapPeak();
+  measure.ok_ = decode();
+  measure.heapBytes_ = HeapPeakSince(start);
+  measure.ms_ = 1e9;
+  for (int run = 0; run < 5; run++) {
+    uint32_t count = 0;
+    auto begin = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed;
+    do {
+      decode();
+      count++;
+      elapsed = Clock::now() - begin;
+    } while (count < 2 || elapsed.count() < 20.0);
+    measure.ms_ = std::min(measure.ms_, elapsed.count() / count);
+  }
+  return measure;
+}
+
+static const char* FormatName(SurfaceFormat format) {
+  switch (format) {
+    case SurfaceFormat::SURFACE_FORMAT_RGB_565:
+      return "565";
+    case SurfaceFormat::SURFACE_FORMAT_YUV_420:
+      return "YUV";
+    default:
+      return "RGBA";
+  }
+}
+
+static const char* OptionsName(const DecodeOptions& options) {
+  static char name[24];
+  snprintf(name, sizeof(name), "%s %s %s",
+           options.bypassFiltering_ ? "nofilt" : "filter",
+           options.noFancyUpsampling_ ? "plain" : "fancy",
+           options.useThreads_ ? "mt" : "st");
+  return name;
+}
+
+// the preset with these options, if any
+static const char* PresetName(const DecodeOptions& options) {
+  const DecodePreset presets[] = {DecodePreset::DECODE_PRESET_SPEED,
+                                  DecodePreset::DECODE_PRESET_QUALITY};
+  const char* names[] = {"SPEED", "QUALITY"};
+  for (int idx = 0; idx < 2; idx++) {
+    DecodeOptions preset = GetDecodeOptions(presets[idx]);
+    if (preset.bypassFiltering_ == options.bypassFiltering_ &&
+        preset.noFancyUpsampling_ == options.noFancyUpsampling_ &&
+        preset.useThreads_ == options.useThreads_) {
+      return names[idx];
+    }
+  }
+  return "";
+}
+
+// one cell of the matrix, summed over the corpus
+struct Cell {
+  double relTime_;  // sum of time / quality decode time
+  double minPsnr_, sumPsnr_;
+  long maxHeap_;
+  uint32_t count_;
+};
+
+int main(int argc, char** argv) {
+  bool verbose = argc > 1 && !strcmp(argv[1], "-v");
+  std::string assetDir = argc > 1 + verbose ? argv[1 + verbose]
+                                            : WEBP_ASSET_DIR;
+  std::vector<Picture> corpus;
+  ReadCorpus(assetDir, corpus);
+  corpus.push_back(MakePicture());
+  rgb565Native = Rgb565IsNative();
+
+  const SurfaceFormat formats[] = {SurfaceFormat::SURFACE_FORMAT_RGB_565,
+                                   SurfaceFormat::SURFACE_FORMAT_RGBA_8888,
+                                   SurfaceFormat::SURFACE_FORMAT_YUV_420};
+  const float scales[] = {0.5f, 1.0f, 2.0f};
+  const DecodeOptions quality =
+      GetDecodeOptions(DecodePreset::DECODE_PRESET_QUALITY);
+  const uint32_t kCOMBINATIONS = 8;
+  Cell cells[3][3][kCOMBINATIONS];
+  memset(cells, 0, sizeof(cells));
+  for (auto& byFormat : cells) {
+    for (auto& byScale : byFormat) {
+      for (Cell& cell : byScale) cell.minPsnr_ = 99.0;
+    }
+  }
+
+  if (verbose) {
+    printf("%-16s %5s %-4s %-18s %8s %9s %9s %6s\n", "picture", "scale",
+           "out", "options", "ms", "heap KB", "out KB", "PSNR");
+  }
+  for (const Picture& picture : corpus) {
+    for (uint32_t s = 0; s < 3; s++) {
+      DecodeSurfaceDescriptor desc;
+      desc.width_ = desc.stride_ =
+          std::max(1, static_cast<int32_t>(picture.width_ * scales[s]));
+      desc.height_ =
+          std::max(1, static_cast<int32_t>(picture.height_ * scales[s]));
+      for (uint32_t f = 0; f < 3; f++) {
+        // the reference: full quality, RGBA or YUV
+        DecodeSurfaceDescriptor refDesc = desc;
+        if (formats[f] != SurfaceFormat::SURFACE_FORMAT_YUV_420) {
+          refDesc.format_ = SurfaceFormat::SURFACE_FORMAT_RGBA_8888;
+        } else {
+          refDesc.format_ = formats[f];
+        }
+        std::vector<uint8_t> ref(SurfaceBytes(refDesc));
+        DecodeWebpFrame(picture.data_.data(), picture.data_.size(), refDesc,
+                        ref.data(), quality);
+        desc.format_ = formats[f];
+        std::vector<uint8_t> pixels(SurfaceBytes(desc));
+        Measure base = Time([&] {
+          return DecodeWebpFrame(picture.data_.data(), picture.data_.size(),
+                                 desc, pixels.data(), quality);
+        });
+
+        for (uint32_t combo = 0; combo < kCOMBINATIONS; combo++) {
+          DecodeOptions options;
+          options.bypassFiltering_ = combo & 1;
+          options.noFancyUpsampling_ = combo & 2;
+          options.useThreads_ = combo & 4;
+          Measure measure = Time([&] {
+            return DecodeWebpFrame(picture.data_.data(),
+                                   picture.data_.size(), desc, pixels.data(),
+                                   options);
+          });
+          double psnr = measure.ok_ ? Psnr(desc, pixels.data(), ref.data())
+                                    : 0.0;
+          Cell& cell = cells[f][s][combo];
+          cell.relTime_ += measure.ms_ / base.ms_;
+          cell.minPsnr_ = std::min(cell.minPsnr_, psnr);
+          cell.sumPsnr_ += psnr;
+          cell.maxHeap_ = std::max(cell.maxHeap_, measure.heapBytes_);
+          cell.count_++;
+          if (verbose) {
+            printf("%-16s %5.2f %-4s %-18s %8.3f %9ld %9zu %6.2f\n",
+                   picture.name_.c_str(), scales[s], FormatName(formats[f]),
+                   OptionsName(options), measure.ms_,
+                   measure.heapBytes_ / 1024, pixels.size() / 1024, psnr);
+          }
+        }
+      }
+    }
+  }
+
+  printf("%zu pictures; time relative to filter fancy st in the same "
+         "format and scale\n", corpus.size());
+  printf("%-4s %5s %-18s %8s %9s %9s %9s %s\n", "out", "scale", "options",
+         "time", "PSNR min", "PSNR avg", "heap KB", "preset");
+  for (uint32_t f = 0; f < 3; f++) {
+    for (uint32_t s = 0; s < 3; s++) {
+      for (uint32_t combo = 0; combo < kCOMBINATIONS; combo++) {
+        const Cell& cell = cells[f][s][combo];
+        // upsampling does nothing to YUV
+        if (formats[f] == SurfaceFormat::SURFACE_FORMAT_YUV_420 &&
+            (combo & 2)) {
+          continue;
+        }
+        DecodeOptions options;
+        options.bypassFiltering_ = combo & 1;
+        options.noFancyUpsampling_ = combo & 2;
+        options.useThreads_ = combo & 4;
+        printf("%-4s %5.2f %-18s %8.3f %9.2f %9.2f %9ld %s\n",
+               FormatName(formats[f]), scales[s], OptionsName(options),
+               cell.relTime_ / cell.count_, cell.minPsnr_,
+               cell.sumPsnr_ / cell.count_, cell.maxHeap_ / 1024,
+               PresetName(options));
+      }
+    }
+  }
+
+  // rescaling at 1:1, as DecodeWebpFrame() did before it skipped it
+  printf("rescaler at 1:1 (RGBA, full quality):\n");
+  for (const Picture& picture : corpus) {
+    DecodeSurfaceDescriptor desc = {picture.width_, picture.height_,
+                                    picture.width_,
+                                    SurfaceFormat::SURFACE_FORMAT_RGBA_8888};
+    std::vector<uint8_t> pixels(SurfaceBytes(desc));
+    Measure plain = Time([&] {
+      return DecodeWebpFrame(picture.data_.data(), picture.data_.size(),
+                             desc, pixels.data(), quality);
+    });
+    WebPDecoderConfig config;
+    WebPInitDecoderConfig(&config);
+    config.options.use_scaling = 1;
+    config.options.scaled_width = desc.width_;
+    config.options.scaled_height = desc.height_;
+    config.output.colorspace = MODE_RGBA;
+    config.output.is_external_memory = 1;
+    config.output.u.RGBA.rgba = pixels.data();
+    config.output.u.RGBA.stride = desc.stride_ * 4;
+    config.output.u.RGBA.size = pixels.size();
+    Measure scaled = Time([&] {
+      return WebPDecode(picture.data_.data(), picture.data_.size(),
+                        &config) == VP8_STATUS_OK;
+    });
+    printf("  %-16s %8.3f ms, rescaled %8.3f ms, heap %ld KB / %ld KB\n",
+           picture.name_.c_str(), plain.ms_, scaled.ms_,
+           plain.heapBytes_ / 1024, scaled.heapBytes_ / 1024);
+  }
+  return 0;
+}
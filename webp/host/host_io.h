@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __HOST_IO_H__
+#define __HOST_IO_H__
+
+/*
+ * Host stand-ins for the app's AssetFileReader and WindowSurface
+ */
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "webp_frame.h"
+
+// reads the files from a directory, instead of the apk's assets
+class DirFileReader : public WebpFileReader {
+ public:
+  explicit DirFileReader(const std::string& dir) : dir_(dir) {}
+  const uint8_t* Read(const char* name, size_t* size) override {
+    FILE* file = fopen((dir_ + "/" + name).c_str(), "rb");
+    if (!file) return nullptr;
+    fseek(file, 0, SEEK_END);
+    buf_.resize(ftell(file));
+    fseek(file, 0, SEEK_SET);
+    *size = fread(buf_.data(), 1, buf_.size(), file);
+    fclose(file);
+    return buf_.data();
+  }
+
+ private:
+  std::string dir_;
+  std::vector<uint8_t> buf_;
+};
+
+/*
+ * MemorySurface: a window in memory, with a chain of bufferCount buffers
+ * whose stride is the width rounded up to kSTRIDE_ALIGN pixels, like
+ * gralloc's. Post() takes the locked buffer to the "screen" and records when.
+ */
+class MemorySurface : public FrameSurface {
+ public:
+  static const int32_t kSTRIDE_ALIGN = 64;
+
+  MemorySurface(int32_t width, int32_t height, SurfaceFormat format,
+                uint32_t bufferCount = 3)
+      : next_(0), locked_(false) {
+    desc_.width_ = width;
+    desc_.height_ = height;
+    desc_.stride_ = (width + kSTRIDE_ALIGN - 1) / kSTRIDE_ALIGN * kSTRIDE_ALIGN;
+    desc_.format_ = format;
+    size_t size = static_cast<size_t>(desc_.stride_) * height *
+                  BytesPerPixel(format);
+    buffers_.resize(bufferCount, std::vector<uint8_t>(size));
+  }
+
+  bool Lock(DecodeSurfaceDescriptor* desc, uint8_t** bits) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    assert(!locked_);
+    locked_ = true;
+    *desc = desc_;
+    *bits = buffers_[next_].data();
+    return true;
+  }
+
+  void Post(void) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    assert(locked_);
+    locked_ = false;
+    next_ = (next_ + 1) % buffers_.size();
+    postTimes_.push_back(std::chrono::steady_clock::now());
+  }
+
+  const DecodeSurfaceDescriptor& Descriptor(void) const { return desc_; }
+  std::vector<std::chrono::steady_clock::time_point> PostTimes(void) {
+    std::lock_guard<std::mutex> lock(lock_);
+    return postTimes_;
+  }
+
+ private:
+  DecodeSurfaceDescriptor desc_;
+  std::vector<std::vector<uint8_t>> buffers_;
+  uint32_t next_;
+  bool locked_;
+  std::mutex lock_;
+  std::vector<std::chrono::steady_clock::time_point> postTimes_;
+};
+
+#endif  // __HOST_IO_H__
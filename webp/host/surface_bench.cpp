@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The two display paths of the view, on an in-memory window: pictures
+ * decoded into WebpDecoder's ring then copied into the window's buffer, or
+ * decoded straight into the locked window buffer. For each, as fast as
+ * pictures come (throughput) and then paced at one picture per interval
+ * (as the slide show, only faster):
+ *   - bytes the display thread copies per frame
+ *   - display thread time per frame, from a decoded picture to posted
+ *   - paced: how late frames are posted after they are due
+ *
+ * usage: surface_bench [frames] [interval ms] [width height] [565|8888]
+ *                      [asset dir]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "host_io.h"
+#include "webp_decode.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* frames[] = {
+    "clips/frame1.webp",
+    "clips/frame2.webp",
+    "clips/frame3.webp",
+};
+
+static double Ms(Clock::duration d) {
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+struct RunResult {
+  double fps;
+  double copiedPerFrame;
+  double displayAvgMs, displayMaxMs;
+  double lateAvgMs, lateMaxMs;
+  DecodeStats stats;
+};
+
+static RunResult Run(bool direct, uint32_t frameCount, uint32_t intervalMs,
+                     MemorySurface& surface, WebpFileReader& reader) {
+  DecodeSurfaceDescriptor desc = surface.Descriptor();
+  WebpDecoder* decoder =
+      direct ? new WebpDecoder(frames, 3, &surface, &reader)
+             : new WebpDecoder(frames, 3, &desc, &reader);
+  uint32_t bpp = BytesPerPixel(desc.format_);
+
+  RunResult result;
+  memset(&result, 0, sizeof(result));
+  uint64_t copied = 0;
+  auto start = Clock::now();
+  auto due = start;
+  for (uint32_t shown = 0; shown < frameCount;) {
+    if (intervalMs) std::this_thread::sleep_until(due);
+    uint8_t* frame = decoder->GetDecodedFrame();
+    if (!frame) {
+      // the view polls from its event loop
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+      continue;
+    }
+    auto displayStart = Clock::now();
+    if (!direct) {
+      // Engine::UpdateFrameBuffer()
+      DecodeSurfaceDescriptor window;
+      uint8_t* bits;
+      surface.Lock(&window, &bits);
+      for (int32_t row = 0; row < window.height_; row++) {
+        memcpy(bits + row * window.stride_ * bpp,
+               frame + row * desc.stride_ * bpp, window.width_ * bpp);
+      }
+      copied += static_cast<uint64_t>(window.width_) * window.height_ * bpp;
+      surface.Post();
+    }
+    decoder->ReleaseFrame();
+    auto posted = Clock::now();
+
+    double displayMs = Ms(posted - displayStart);
+    result.displayAvgMs += displayMs;
+    result.displayMaxMs = std::max(result.displayMaxMs, displayMs);
+    if (intervalMs) {
+      double late = Ms(posted - due);
+      result.lateAvgMs += late;
+      result.lateMaxMs = std::max(result.lateMaxMs, late);
+      due += std::chrono::milliseconds(intervalMs);
+    }
+    shown++;
+  }
+  double time = Ms(Clock::now() - start);
+  result.stats = decoder->GetStats();
+  delete decoder;
+
+  result.fps = frameCount * 1000.0 / time;
+  result.copiedPerFrame = static_cast<double>(copied) / frameCount;
+  result.displayAvgMs /= frameCount;
+  result.lateAvgMs /= frameCount;
+  return result;
+}
+
+int main(int argc, char** argv) {
+  uint32_t frameCount = argc > 1 ? atoi(argv[1]) : 60;
+  uint32_t intervalMs = argc > 2 ? atoi(argv[2]) : 33;
+  int32_t width = argc > 4 ? atoi(argv[3]) : 1080;
+  int32_t height = argc > 4 ? atoi(argv[4]) : 1920;
+  SurfaceFormat format = argc > 5 && !strcmp(argv[5], "8888")
+                             ? SurfaceFormat::SURFACE_FORMAT_RGBA_8888
+                             : SurfaceFormat::SURFACE_FORMAT_RGB_565;
+  std::string assetDir = argc > 6 ? argv[6] : WEBP_ASSET_DIR;
+
+  DirFileReader reader(assetDir);
+  printf("%u frames, %d x %d %s, paced run: one frame per %u ms\n",
+         frameCount, width, height,
+         format == SurfaceFormat::SURFACE_FORMAT_RGB_565 ? "RGB565" : "RGBA",
+         intervalMs);
+  printf("%-12s %-7s %8s %12s %16s %16s %10s\n", "path", "run", "fps",
+         "copied/frame", "display ms avg", "late ms avg/max", "decode ms");
+  for (int direct = 0; direct < 2; direct++) {
+    for (int paced = 0; paced < 2; paced++) {
+      MemorySurface surface(width, height, format);
+      RunResult r = Run(direct, frameCount, paced ? intervalMs : 0, surface,
+                        reader);
+      if (r.stats.framesDecoded_ < frameCount) {
+        printf("ERROR: %u pictures decoded, %u errors\n",
+               r.stats.framesDecoded_, r.stats.decodeErrors_);
+        return 1;
+      }
+      char late[32] = "-";
+      if (paced) snprintf(late, sizeof(late), "%.2f/%.2f", r.lateAvgMs,
+                          r.lateMaxMs);
+      printf("%-12s %-7s %8.1f %9.0f KB %9.3f/%-6.3f %16s %10.2f\n",
+             direct ? "direct" : "ring + copy", paced ? "paced" : "max",
+             r.fps, r.copiedPerFrame / 1024, r.displayAvgMs, r.displayMaxMs,
+             late, r.stats.avgDecodeMs_);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "android_io.h"
+
+#include <cassert>
+
+bool ToSurfaceFormat(int32_t windowFormat, SurfaceFormat* format) {
+  switch (windowFormat) {
+    case WINDOW_FORMAT_RGB_565:
+      *format = SurfaceFormat::SURFACE_FORMAT_RGB_565;
+      return true;
+    case WINDOW_FORMAT_RGBX_8888:
+      *format = SurfaceFormat::SURFACE_FORMAT_RGBX_8888;
+      return true;
+    case WINDOW_FORMAT_RGBA_8888:
+      *format = SurfaceFormat::SURFACE_FORMAT_RGBA_8888;
+      return true;
+    default:
+      return false;
+  }
+}
+
+AssetFileReader::AssetFileReader(AAssetManager* assetMgr)
+    : assetMgr_(assetMgr), asset_(nullptr) {}
+
+AssetFileReader::~AssetFileReader() {
+  if (asset_) AAsset_close(asset_);
+}
+
+const uint8_t* AssetFileReader::Read(const char* name, size_t* size) {
+  if (asset_) AAsset_close(asset_);
+  asset_ = AAssetManager_open(assetMgr_, name, AASSET_MODE_BUFFER);
+  assert(asset_ != NULL);
+  if (!asset_) return nullptr;
+
+  *size = AAsset_getLength(asset_);
+  const void* mapped = AAsset_getBuffer(asset_);
+  if (mapped) return reinterpret_cast<const uint8_t*>(mapped);
+
+  buf_.resize(*size);
+  int32_t len = AAsset_read(asset_, buf_.data(), buf_.size());
+  assert(len > 0);
+  if (len <= 0) return nullptr;
+  *size = len;
+  return buf_.data();
+}
+
+bool WindowSurface::Lock(DecodeSurfaceDescriptor* desc, uint8_t** bits) {
+  ANativeWindow_Buffer buf;
+  if (ANativeWindow_lock(window_, &buf, nullptr) < 0) return false;
+  if (!ToSurfaceFormat(buf.format, &desc->format_)) {
+    ANativeWindow_unlockAndPost(window_);
+    return false;
+  }
+  desc->width_ = buf.width;
+  desc->height_ = buf.height;
+  desc->stride_ = buf.stride;
+  *bits = reinterpret_cast<uint8_t*>(buf.bits);
+  return true;
+}
+
+void WindowSurface::Post(void) { ANativeWindow_unlockAndPost(window_); }
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __ANDROID_IO_H__
+#define __ANDROID_IO_H__
+#include <android/asset_manager.h>
+#include <android/native_window.h>
+
+#include <vector>
+
+#include "webp_frame.h"
+
+// window format to SurfaceFormat; false if the decoder can't draw it
+bool ToSurfaceFormat(int32_t windowFormat, SurfaceFormat* format);
+
+/*
+ * AssetFileReader: reads webp files from the apk's assets, mapped when
+ * they are stored uncompressed, copied otherwise
+ */
+class AssetFileReader : public WebpFileReader {
+ public:
+  explicit AssetFileReader(AAssetManager* assetMgr);
+  ~AssetFileReader();
+  const uint8_t* Read(const char* name, size_t* size) override;
+
+ private:
+  AAssetManager* assetMgr_;
+  AAsset* asset_;  // the file last read
+  std::vector<uint8_t> buf_;
+};
+
+/*
+ * WindowSurface: decodes go straight into the native window's buffers
+ */
+class WindowSurface : public FrameSurface {
+ public:
+  explicit WindowSurface(ANativeWindow* window) : window_(window) {}
+  bool Lock(DecodeSurfaceDescriptor* desc, uint8_t** bits) override;
+  void Post(void) override;
+
+ private:
+  ANativeWindow* window_;
+};
+#endif  // __ANDROID_IO_H__
@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "webp_anim.h"
+
+#include <webp/demux.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+
+// frame durations this short are shown for 100 ms, as browsers do
+#define MIN_FRAME_DURATION 10
+#define SHORT_FRAME_DURATION 100
+
+WebpAnimPlayer::WebpAnimPlayer(const char* file, WebpFileReader* reader,
+                               const DecodeSurfaceDescriptor& output,
+                               size_t cacheBytes)
+    : output_(output),
+      frameBytes_(0),
+      cacheBytes_(cacheBytes),
+      data_(nullptr),
+      dataSize_(0),
+      anim_(nullptr),
+      canvasWidth_(0),
+      canvasHeight_(0),
+      loopCount_(0),
+      loopDuration_(0),
+      animNext_(0),
+      playIndex_(0),
+      lastLate_(UINT32_MAX),
+      exit_(false),
+      totalDecodeMs_(0.0) {
+  memset(&stats_, 0, sizeof(stats_));
+  uint32_t bytePerPix = BytesPerPixel(output.format_);
+  if (!bytePerPix || !reader) return;
+  data_ = reader->Read(file, &dataSize_);
+  if (!data_) return;
+  WebPAnimDecoderOptions options;
+  if (!WebPAnimDecoderOptionsInit(&options)) {
+    assert(0);
+    return;
+  }
+  options.color_mode = MODE_RGBA;
+  options.use_threads = 1;
+  WebPData webpData = {data_, dataSize_};
+  anim_ = WebPAnimDecoderNew(&webpData, &options);
+  if (!anim_) return;
+
+  WebPAnimInfo info;
+  WebPAnimDecoderGetInfo(anim_, &info);
+  canvasWidth_ = info.canvas_width;
+  canvasHeight_ = info.canvas_height;
+  loopCount_ = info.loop_count;
+  frameBytes_ =
+      static_cast<size_t>(output_.width_) * output_.height_ * bytePerPix;
+  // room for the frame on screen and the next one, at least
+  cacheBytes_ = std::max(cacheBytes, 2 * frameBytes_);
+
+  // the timeline, from the frame headers: nothing is decoded yet
+  const WebPDemuxer* demux = WebPAnimDecoderGetDemuxer(anim_);
+  WebPIterator iter;
+  if (WebPDemuxGetFrame(demux, 1, &iter)) {
+    do {
+      starts_.push_back(loopDuration_);
+      loopDuration_ += iter.duration <= MIN_FRAME_DURATION
+                           ? SHORT_FRAME_DURATION
+                           : iter.duration;
+    } while (WebPDemuxNextFrame(&iter));
+    WebPDemuxReleaseIterator(&iter);
+  }
+  if (starts_.empty()) {
+    WebPAnimDecoderDelete(anim_);
+    anim_ = nullptr;
+    return;
+  }
+
+  srcX_.resize(output_.width_);
+  for (int32_t x = 0; x < output_.width_; x++) {
+    srcX_[x] = static_cast<int32_t>(static_cast<int64_t>(x) * canvasWidth_ /
+                                    output_.width_);
+  }
+  cached_.resize(starts_.size());
+  broken_.resize(starts_.size());
+  worker_ = std::thread(&WebpAnimPlayer::DecodeLoop, this);
+}
+
+WebpAnimPlayer::~WebpAnimPlayer() {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    exit_ = true;
+  }
+  wake_.notify_all();
+  if (worker_.joinable()) worker_.join();
+  if (anim_) WebPAnimDecoderDelete(anim_);
+}
+
+/*
+ * FrameAt(): the frame of the timeline at timeMs, looping; ended when the
+ *            loops are over (the last frame stays)
+ */
+uint32_t WebpAnimPlayer::FrameAt(uint32_t timeMs, bool* ended) {
+  *ended = loopCount_ && timeMs / loopDuration_ >= loopCount_;
+  if (*ended) return FrameCount() - 1;
+  uint32_t t = timeMs % loopDuration_;
+  return static_cast<uint32_t>(
+      std::upper_bound(starts_.begin(), starts_.end(), t) - starts_.begin() -
+      1);
+}
+
+/*
+ * IsUpcoming(): is the frame the one playing or to be shown within
+ *               kDECODE_AHEAD_MS (the next frame always is)
+ */
+bool WebpAnimPlayer::IsUpcoming(uint32_t index) {
+  uint32_t count = FrameCount();
+  if (index == playIndex_ || index == (playIndex_ + 1) % count) return true;
+  uint32_t ahead = (starts_[index] + loopDuration_ - starts_[playIndex_]) %
+                   loopDuration_;
+  return ahead <= kDECODE_AHEAD_MS;
+}
+
+// first upcoming frame not in the cache nor broken, -1 if none
+int32_t WebpAnimPlayer::NextToDecode(void) {
+  uint32_t count = FrameCount();
+  for (uint32_t n = 0; n < count; n++) {
+    uint32_t index = (playIndex_ + n) % count;
+    if (!IsUpcoming(index)) break;
+    if (!cached_[index] && !broken_[index]) {
+      return static_cast<int32_t>(index);
+    }
+  }
+  return -1;
+}
+
+/*
+ * DecodeLoop():
+ *     decodes the first upcoming frame not cached, waiting while there is
+ *     none or the cache is full of upcoming frames. A frame that fails to
+ *     decode is marked broken and never tried again; the decoder restarts
+ *     from the first frame for the next one.
+ */
+void WebpAnimPlayer::DecodeLoop(void) {
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true) {
+    int32_t index = -1;
+    wake_.wait(lock, [&] { return exit_ || (index = NextToDecode()) >= 0; });
+    if (exit_) return;
+    lock.unlock();
+
+    std::shared_ptr<CachedFrame> frame(new CachedFrame());
+    frame->index_ = index;
+    frame->shown_ = false;
+    frame->pixels_.resize(frameBytes_);
+    auto start = std::chrono::steady_clock::now();
+    bool ok = DecodeFrame(index, frame.get());
+    std::chrono::duration<float, std::milli> time =
+        std::chrono::steady_clock::now() - start;
+
+    lock.lock();
+    if (!ok) {
+      stats_.decodeErrors_++;
+      broken_[index] = true;
+      continue;
+    }
+    stats_.framesDecoded_++;
+    stats_.maxDecodeMs_ = std::max(stats_.maxDecodeMs_, time.count());
+    totalDecodeMs_ += time.count();
+    stats_.avgDecodeMs_ =
+        static_cast<float>(totalDecodeMs_ / stats_.framesDecoded_);
+    while (!Insert(frame)) {
+      // far enough ahead for this cache size: wait for the playback, and
+      // keep the frame if it is still to come
+      uint32_t play = playIndex_;
+      wake_.wait(lock, [&] { return exit_ || playIndex_ != play; });
+      if (exit_) return;
+      if (!IsUpcoming(frame->index_) || cached_[frame->index_]) break;
+    }
+  }
+}
+
+/*
+ * DecodeFrame(): WebPAnimDecoder only goes forward, from the first frame:
+ *                frames before index are decoded (to composite index
+ *                onto them) but not kept, index is converted for the
+ *                output. After a failure, the decoder is reset before the
+ *                next frame.
+ */
+bool WebpAnimPlayer::DecodeFrame(uint32_t index, CachedFrame* frame) {
+  if (index < animNext_) {
+    WebPAnimDecoderReset(anim_);
+    animNext_ = 0;
+  }
+  uint8_t* canvas = nullptr;
+  int timestamp;
+  while (animNext_ <= index) {
+    if (!WebPAnimDecoderGetNext(anim_, &canvas, &timestamp)) {
+      animNext_ = UINT32_MAX;
+      return false;
+    }
+    animNext_++;
+  }
+  ConvertCanvas(canvas, frame->pixels_.data());
+  return true;
+}
+
+/*
+ * ConvertCanvas(): RGBA canvas to the output format, scaled (nearest) to
+ *                  the output size, in packed rows
+ */
+void WebpAnimPlayer::ConvertCanvas(const uint8_t* canvas, uint8_t* dst) {
+  size_t rowBytes = output_.width_ * BytesPerPixel(output_.format_);
+  for (int32_t y = 0; y < output_.height_; y++) {
+    uint32_t srcY = static_cast<uint32_t>(static_cast<int64_t>(y) *
+                                          canvasHeight_ / output_.height_);
+    const uint8_t* src = canvas + srcY * canvasWidth_ * 4;
+    uint8_t* row = dst + y * rowBytes;
+    if (output_.format_ == SurfaceFormat::SURFACE_FORMAT_RGB_565) {
+      uint16_t* pixels = reinterpret_cast<uint16_t*>(row);
+      for (int32_t x = 0; x < output_.width_; x++) {
+        const uint8_t* p = src + srcX_[x] * 4;
+        pixels[x] = static_cast<uint16_t>(((p[0] & 0xf8) << 8) |
+                                          ((p[1] & 0xfc) << 3) | (p[2] >> 3));
+      }
+    } else {
+      for (int32_t x = 0; x < output_.width_; x++) {
+        memcpy(row + x * 4, src + srcX_[x] * 4, 4);
+      }
+    }
+  }
+}
+
+/*
+ * Insert(): caches a decoded frame, evicting the least recently used
+ *           frames that are not upcoming nor on screen; false if there is
+ *           no room
+ */
+bool WebpAnimPlayer::Insert(const std::shared_ptr<CachedFrame>& frame) {
+  while ((lru_.size() + 1) * frameBytes_ > cacheBytes_) {
+    auto victim = lru_.rbegin();
+    while (victim != lru_.rend() &&
+           (IsUpcoming(*victim) || cached_[*victim] == shown_)) {
+      ++victim;
+    }
+    if (victim == lru_.rend()) return false;
+    uint32_t index = *victim;
+    lru_.erase(std::next(victim).base());
+    cached_[index] = nullptr;
+  }
+
+  lru_.push_front(frame->index_);
+  frame->lru_ = lru_.begin();
+  cached_[frame->index_] = frame;
+  stats_.cacheBytes_ = lru_.size() * frameBytes_;
+  stats_.peakCacheBytes_ = std::max(stats_.peakCacheBytes_, stats_.cacheBytes_);
+  return true;
+}
+
+bool WebpAnimPlayer::GetFrame(uint32_t timeMs, uint32_t* index) {
+  // only this thread changes shown_, so it can be read without the lock
+  std::unique_lock<std::mutex> lock(lock_, std::try_to_lock);
+  if (lock.owns_lock() && anim_) {
+    bool ended;
+    uint32_t want = FrameAt(timeMs, &ended);
+    stats_.loops_ = ended ? loopCount_ : timeMs / loopDuration_;
+    if (!shown_ || shown_->index_ != want) {
+      const std::shared_ptr<CachedFrame>& frame = cached_[want];
+      if (frame) {
+        stats_.cacheHits_ += frame->shown_;
+        stats_.framesShown_++;
+        frame->shown_ = true;
+        lru_.splice(lru_.begin(), lru_, frame->lru_);
+        shown_ = frame;
+      } else if (shown_ && want != lastLate_ && !broken_[want]) {
+        stats_.framesLate_++;
+        lastLate_ = want;
+      }
+      if (playIndex_ != want) {
+        playIndex_ = want;
+        wake_.notify_one();
+      }
+    }
+  }
+
+  if (!shown_) return false;
+  *index = shown_->index_;
+  return true;
+}
+
+void WebpAnimPlayer::DrawFrame(uint8_t* dst, int32_t stride) {
+  // only this thread changes shown_, which keeps the frame alive
+  if (!shown_) return;
+  uint32_t bytePerPix = BytesPerPixel(output_.format_);
+  size_t rowBytes = output_.width_ * bytePerPix;
+  if (stride == output_.width_) {
+    memcpy(dst, shown_->pixels_.data(), frameBytes_);
+    return;
+  }
+  const uint8_t* src = shown_->pixels_.data();
+  for (int32_t y = 0; y < output_.height_; y++) {
+    memcpy(dst, src, rowBytes);
+    dst += static_cast<size_t>(stride) * bytePerPix;
+    src += rowBytes;
+  }
+}
+
+AnimStats WebpAnimPlayer::GetStats(void) {
+  std::lock_guard<std::mutex> lock(lock_);
+  return stats_;
+}
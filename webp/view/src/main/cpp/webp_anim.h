@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WEBP_ANIM_H__
+#define __WEBP_ANIM_H__
+
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "webp_frame.h"
+
+struct WebPAnimDecoder;
+
+/*
+ * Player statistics, since the player was created:
+ *   framesLate_:  frames whose time came before they were decoded (the
+ *                 previous frame stayed on screen longer)
+ *   decodeErrors_: frames that failed to decode; they are skipped (the
+ *                 previous frame stays on screen)
+ *   cacheHits_:   frames shown from the cache without decoding them again
+ *   cacheBytes_:  memory of the cached frames, now and at most
+ */
+struct AnimStats {
+  uint32_t framesDecoded_;
+  uint32_t framesShown_;
+  uint32_t framesLate_;
+  uint32_t decodeErrors_;
+  uint32_t cacheHits_;
+  uint32_t loops_;
+  float avgDecodeMs_, maxDecodeMs_;
+  size_t cacheBytes_, peakCacheBytes_;
+};
+
+/*
+ * Animated webp player:
+ *     A thread decodes the frames with WebPAnimDecoder (which composites
+ *     them onto the canvas) ahead of the playback, by up to kDECODE_AHEAD_MS
+ *     of frame durations. The canvases go into a cache of at most
+ *     cacheBytes, whose least recently used frames are evicted (never the
+ *     ones coming up); when the whole animation fits, later loops are
+ *     played from the cache without decoding. The decoding thread also
+ *     converts and scales each canvas to the output format and size, so the
+ *     cache holds frames ready to show.
+ *     GetFrame() never waits: when the frame for the time is not decoded
+ *     yet, the frame already on screen stays. DrawFrame() only copies the
+ *     frame into the output surface (e.g. the locked window buffer).
+ *     The file is read once with reader (keep it for this player only): the
+ *     app's reader maps the asset, so frames are paged in as they are
+ *     decoded.
+ */
+class WebpAnimPlayer {
+ public:
+  static const size_t kDEFAULT_CACHE_BYTES = 32 * 1024 * 1024;
+  static const uint32_t kDECODE_AHEAD_MS = 500;
+
+  WebpAnimPlayer(const char* file, WebpFileReader* reader,
+                 const DecodeSurfaceDescriptor& output,
+                 size_t cacheBytes = kDEFAULT_CACHE_BYTES);
+  ~WebpAnimPlayer();
+
+  // false if the file is not an animation that could be opened
+  bool IsValid(void) const { return anim_ != nullptr; }
+  uint32_t FrameCount(void) const {
+    return static_cast<uint32_t>(starts_.size());
+  }
+  uint32_t LoopDuration(void) const { return loopDuration_; }
+
+  /*
+   * GetFrame():
+   *     Picks the frame to show timeMs after the playback started; false
+   *     until the first frame is decoded. index: the frame's number.
+   */
+  bool GetFrame(uint32_t timeMs, uint32_t* index);
+  /*
+   * DrawFrame():
+   *     Copies the frame GetFrame() picked into dst, laid out as the output
+   *     surface but with stride pixels per row.
+   */
+  void DrawFrame(uint8_t* dst, int32_t stride);
+
+  AnimStats GetStats(void);
+
+ private:
+  struct CachedFrame {
+    uint32_t index_;
+    bool shown_;  // on screen before: showing it again is a cache hit
+    std::list<uint32_t>::iterator lru_;
+    std::vector<uint8_t> pixels_;  // output format and size, packed rows
+  };
+
+  void DecodeLoop(void);
+  uint32_t FrameAt(uint32_t timeMs, bool* ended);
+  bool IsUpcoming(uint32_t index);
+  int32_t NextToDecode(void);
+  bool DecodeFrame(uint32_t index, CachedFrame* frame);
+  void ConvertCanvas(const uint8_t* canvas, uint8_t* dst);
+  bool Insert(const std::shared_ptr<CachedFrame>& frame);
+
+  DecodeSurfaceDescriptor output_;
+  size_t frameBytes_, cacheBytes_;
+  const uint8_t* data_;
+  size_t dataSize_;
+
+  // the animation: frame i is shown from starts_[i] to starts_[i + 1]
+  WebPAnimDecoder* anim_;
+  uint32_t canvasWidth_, canvasHeight_, loopCount_;
+  std::vector<uint32_t> starts_;
+  uint32_t loopDuration_;
+  uint32_t animNext_;  // frame WebPAnimDecoderGetNext() gives next
+  std::vector<int32_t> srcX_;  // canvas column of each output column
+
+  std::mutex lock_;
+  std::condition_variable wake_;
+  std::vector<std::shared_ptr<CachedFrame>> cached_;  // by frame index
+  std::vector<bool> broken_;  // by frame index: failed to decode
+  std::list<uint32_t> lru_;  // cached frame indices, most recent first
+  std::shared_ptr<CachedFrame> shown_;
+  uint32_t playIndex_;
+  uint32_t lastLate_;
+  bool exit_;
+  std::thread worker_;
+
+  AnimStats stats_;
+  double totalDecodeMs_;
+};
+
+#endif  // __WEBP_ANIM_H__
@@ -15,192 +15,190 @@
  */
 #include "webp_decode.h"
 
-#include <pthread.h>
-#include <webp/decode.h>
-
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstring>
 
 WebpDecoder::WebpDecoder(const char** files, uint32_t count,
                          DecodeSurfaceDescriptor* frameBuf,
-                         AAssetManager* assetMgr)
-    : assetMgr_(assetMgr),
-      buf_(nullptr),
-      stopPending_(false),
-      state_(state_idle),
-      worker_(nullptr) {
-  for (auto i = 0; i < count; i++) {
-    files_.push(files[i]);
-  }
-  if (count && assetMgr && frameBuf) {
-    bufInfo_ = *frameBuf;
-    switch (bufInfo_.format_) {
-      case SurfaceFormat::SURFACE_FORMAT_RGB_565:
-        bytePerPix_ = 2;
-        break;
-      case SurfaceFormat::SURFACE_FORMAT_RGBA_8888:
-      case SurfaceFormat::SURFACE_FORMAT_RGBX_8888:
-        bytePerPix_ = 4;
-        break;
-      default:
-        assert(0);
-        return;
-    }
-    // allocate a private decode buffer
-    uint32_t size = bufInfo_.height_ * bufInfo_.stride_ * bytePerPix_;
-    buf_ = new uint8_t[size];
-    assert(buf_);
+                         WebpFileReader* reader, uint32_t ringSize)
+    : reader_(reader),
+      surface_(nullptr),
+      files_(files, files + count),
+      nextFile_(0),
+      options_(GetDecodeOptions(DecodePreset::DECODE_PRESET_QUALITY)),
+      head_(0),
+      ready_(0),
+      locked_(nullptr),
+      exit_(false),
+      totalDecodeMs_(0.0),
+      depthSamples_(0),
+      depthTotal_(0) {
+  memset(&stats_, 0, sizeof(stats_));
+  if (!count || !reader || !frameBuf || !ringSize) return;
+
+  bufInfo_ = *frameBuf;
+  uint32_t bytePerPix = BytesPerPixel(bufInfo_.format_);
+  if (!bytePerPix) {
+    assert(0);
+    return;
   }
+  // allocate the private decode buffers, in the window's layout
+  uint32_t size = bufInfo_.height_ * bufInfo_.stride_ * bytePerPix;
+  ring_.resize(ringSize, std::vector<uint8_t>(size));
+
+  worker_ = std::thread(&WebpDecoder::DecodeLoop, this);
 }
 
-/*
- * GetDecodedFrame():  return decoded frame if available,
- *                     return nullptr otherwise
- */
-uint8_t* WebpDecoder::GetDecodedFrame(void) {
-  return (state_ == state_ready ? buf_ : nullptr);
+WebpDecoder::WebpDecoder(const char** files, uint32_t count,
+                         FrameSurface* surface, WebpFileReader* reader)
+    : reader_(reader),
+      surface_(surface),
+      files_(files, files + count),
+      nextFile_(0),
+      options_(GetDecodeOptions(DecodePreset::DECODE_PRESET_QUALITY)),
+      head_(0),
+      ready_(0),
+      locked_(nullptr),
+      exit_(false),
+      totalDecodeMs_(0.0),
+      depthSamples_(0),
+      depthTotal_(0) {
+  memset(&stats_, 0, sizeof(stats_));
+  memset(&bufInfo_, 0, sizeof(bufInfo_));
+  if (!count || !reader || !surface) return;
+
+  worker_ = std::thread(&WebpDecoder::DecodeLoop, this);
 }
 
 /*
- * DecodeFrame():
- *    thread function to decode a picture
- *    directly pass through to internal decoding function
+ * ~WebpDecoder():
+ *     Stops the decoding thread; a picture being decoded is finished first.
+ *     A surface buffer still locked is posted: there is no other way to
+ *     give it back.
  */
-void* DecodeFrame(void* decoder) {
-  reinterpret_cast<WebpDecoder*>(decoder)->DecodeFrameInternal();
-  return nullptr;
+WebpDecoder::~WebpDecoder() {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    exit_ = true;
+  }
+  space_.notify_all();
+  if (worker_.joinable()) worker_.join();
+  if (locked_) surface_->Post();
 }
 
 /*
- * DecodeFrameInternal():
- *    Main decoding function from app side, and executing inside its own thread
+ * GetDecodedFrame():  return the oldest decoded frame if available,
+ *                     return nullptr otherwise
  */
-void WebpDecoder::DecodeFrameInternal() {
-  const char* webpFile = files_.front();
-  files_.pop();
-  files_.push(webpFile);
-
-  AAsset* frameFile =
-      AAssetManager_open(assetMgr_, webpFile, AASSET_MODE_BUFFER);
-  assert(frameFile != NULL);
-  int32_t len = AAsset_getLength(frameFile);
-  uint8_t* buf = new uint8_t[len];
-  assert(buf);
-  len = AAsset_read(frameFile, buf, len);
-  assert(len > 0);
-  AAsset_close(frameFile);
-
-  WebPDecoderConfig config;
-  if (!WebPInitDecoderConfig(&config)) {
-    assert(0);
-  }
-
-  VP8StatusCode status = WebPGetFeatures(buf, len, &config.input);
-  assert(status == VP8_STATUS_OK);
-
-  // let's decode it into a buffer ...
-  config.options.bypass_filtering = 1;
-  config.options.no_fancy_upsampling = 1;
-  config.options.flip = 0;
-  config.options.use_scaling = 1;
-  config.options.scaled_width = bufInfo_.width_;
-  config.options.scaled_height = bufInfo_.height_;
-
-  // this does not seems to have difference on Nexus 5
-  config.options.use_threads = 1;
-  switch (bufInfo_.format_) {
-    case SurfaceFormat::SURFACE_FORMAT_RGB_565:
-      config.output.colorspace = MODE_RGB_565;
-      break;
-    case SurfaceFormat::SURFACE_FORMAT_RGBA_8888:
-    case SurfaceFormat::SURFACE_FORMAT_RGBX_8888:
-      config.output.colorspace = MODE_RGBA;
-      break;
-    default:
-      assert(0);
-      delete[] buf;
-      return;
-  }
-  config.output.width = bufInfo_.width_;
-  config.output.height = bufInfo_.height_;
-  config.output.is_external_memory = 1;
-  config.output.private_memory = reinterpret_cast<uint8_t*>(buf_);
-  config.output.u.RGBA.stride = bufInfo_.stride_ * bytePerPix_;
-  config.output.u.RGBA.rgba = config.output.private_memory;
-  config.output.u.RGBA.size =
-      config.output.height * config.output.u.RGBA.stride;
-
-  status = WebPDecode(buf, len, &config);
-  WebPFreeDecBuffer(&config.output);
-  delete[] buf;
-
-  // only change state when it is decoded OK. Our small decoder engine will be
-  // in decoding state when error happens
-  assert(status == VP8_STATUS_OK);
-  if (status == VP8_STATUS_OK) {
-    state_ = state_ready;
+uint8_t* WebpDecoder::GetDecodedFrame(void) {
+  std::lock_guard<std::mutex> lock(lock_);
+  depthTotal_ += ready_;
+  depthSamples_++;
+  if (!ready_) {
+    stats_.underruns_++;
+    return nullptr;
   }
+  return surface_ ? locked_ : ring_[head_].data();
+}
 
-  delete worker_;
-  worker_ = nullptr;
-
-  // if we were asked to release while we are busy decoding (at this point,
-  // this is dangling pointer), we perform the release here to complete the
-  // request.
-  if (stopPending_) {
-    stopPending_ = false;
-    delete this;
+void WebpDecoder::ReleaseFrame(void) {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    if (!ready_) return;
+    if (surface_) {
+      // before the thread may lock the next buffer
+      surface_->Post();
+      locked_ = nullptr;
+    } else {
+      head_ = (head_ + 1) % ring_.size();
+    }
+    ready_--;
   }
+  space_.notify_one();
 }
 
-/*
- * DecodeFrame(void):
- *     Start to decode a picture into internal frame memory
- *     The internal memory layout and size are the same as andriod native
- *     window to save copying when possible.
- *
- *     The decoded frames are scaled up/down by webp decoder to fix the display
- *     window size.
- */
-bool WebpDecoder::DecodeFrame(void) {
-  if (state_ == state_decoding) return false;
-  pthread_t worker_;
-  pthread_attr_t attrib;
-  pthread_attr_init(&attrib);
-  pthread_attr_setdetachstate(&attrib, PTHREAD_CREATE_DETACHED);
-  int status = pthread_create(&worker_, &attrib, ::DecodeFrame, this);
-  pthread_attr_destroy(&attrib);
-
-  if (status == 0) {
-    state_ = state_decoding;
-    return true;
-  }
+void WebpDecoder::SetPreset(DecodePreset preset) {
+  std::lock_guard<std::mutex> lock(lock_);
+  options_ = GetDecodeOptions(preset);
+}
 
-  // create thread failed...
-  assert(false);
-  return false;
+DecodeStats WebpDecoder::GetStats(void) {
+  std::lock_guard<std::mutex> lock(lock_);
+  DecodeStats stats = stats_;
+  stats.queueDepth_ = ready_;
+  stats.avgQueueDepth_ =
+      depthSamples_ ? static_cast<float>(depthTotal_) / depthSamples_ : 0.0f;
+  return stats;
 }
 
 /*
- * DestroyDecoder(void):
- *     Self-delete if decoder is idle
- *     Otherwise set up a flag to let decoding thread perform self-delete when
- *     it finishes. Upon returning from the function, the class pointer is
- * invalid and should not be used
+ * DecodeLoop():
+ *    the decoding thread: decodes the next picture into the first free
+ *    buffer of the ring, or the surface's next buffer, waiting while there
+ *    is none. One thread is enough for a slide show; it keeps the pictures
+ *    in order.
  */
-bool WebpDecoder::DestroyDecoder(void) {
-  if (state_ == state_decoding) {
-    stopPending_ = true;
-    return false;
+void WebpDecoder::DecodeLoop(void) {
+  uint32_t failures = 0;  // in a row
+  uint32_t capacity = surface_ ? 1 : static_cast<uint32_t>(ring_.size());
+  DecodeSurfaceDescriptor desc = bufInfo_;
+  uint8_t* dst = nullptr;  // surface buffer locked by this thread
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true) {
+    space_.wait(lock, [&] { return exit_ || ready_ < capacity; });
+    if (exit_) break;
+    if (!surface_) dst = ring_[(head_ + ready_) % ring_.size()].data();
+    DecodeOptions options = options_;
+    lock.unlock();
+
+    if (surface_ && !dst && !surface_->Lock(&desc, &dst)) {
+      // the surface is gone
+      dst = nullptr;
+      lock.lock();
+      stats_.decodeErrors_++;
+      break;
+    }
+    auto start = std::chrono::steady_clock::now();
+    bool ok = DecodeNext(desc, dst, options);
+    std::chrono::duration<float, std::milli> time =
+        std::chrono::steady_clock::now() - start;
+
+    lock.lock();
+    if (!ok) {
+      // skip the picture, its buffer stays free; give up if none decodes
+      stats_.decodeErrors_++;
+      if (++failures == files_.size()) break;
+      continue;
+    }
+    failures = 0;
+    if (surface_) locked_ = dst;
+    dst = nullptr;
+    ready_++;
+    stats_.framesDecoded_++;
+    stats_.lastDecodeMs_ = time.count();
+    stats_.maxDecodeMs_ = std::max(stats_.maxDecodeMs_, time.count());
+    totalDecodeMs_ += time.count();
+    stats_.avgDecodeMs_ =
+        static_cast<float>(totalDecodeMs_ / stats_.framesDecoded_);
   }
-
-  delete this;
-  return true;
+  if (surface_ && dst) surface_->Post();
 }
 
 /*
- * private destructor prevent object directly call delete
+ * DecodeNext():
+ *    Reads the next webp file and decodes it into dst, in the window's
+ *    format and layout. The decoded frames are scaled up/down by webp
+ *    decoder to fix the display window size.
  */
-WebpDecoder::~WebpDecoder() {
-  if (buf_) delete[] buf_;
-  buf_ = nullptr;
+bool WebpDecoder::DecodeNext(const DecodeSurfaceDescriptor& desc,
+                             uint8_t* dst, const DecodeOptions& options) {
+  const char* webpFile = files_[nextFile_];
+  nextFile_ = (nextFile_ + 1) % files_.size();
+
+  size_t len;
+  const uint8_t* buf = reader_->Read(webpFile, &len);
+  assert(buf != nullptr);
+  return buf && DecodeWebpFrame(buf, len, desc, dst, options);
 }
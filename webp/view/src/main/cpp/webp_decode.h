@@ -15,63 +15,96 @@
  */
 #ifndef __WEBP_DECODE_H__
 #define __WEBP_DECODE_H__
-#include <android/asset_manager.h>
 
-#include <queue>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-enum DecodeState { state_idle, state_decoding, state_ready };
-enum class SurfaceFormat : unsigned int {
-  SURFACE_FORMAT_RGBA_8888,
-  SURFACE_FORMAT_RGBX_8888,
-  SURFACE_FORMAT_RGB_565,
-  SURFACE_FORMAT_YUV_420  // Not implemented yet
-};
-struct DecodeSurfaceDescriptor {
-  // surface size in pixels
-  int32_t width_, height_, stride_;
-  SurfaceFormat format_;
+#include "webp_frame.h"
+
+/*
+ * Decoder statistics, since the decoder was created:
+ *   decode latency: time to read and decode one picture
+ *   queue depth:    decoded pictures waiting in the ring, sampled each time
+ *                   the display side asks for one; underruns_ counts the
+ *                   times there was none
+ */
+struct DecodeStats {
+  uint32_t framesDecoded_;
+  uint32_t decodeErrors_;
+  float lastDecodeMs_, avgDecodeMs_, maxDecodeMs_;
+  uint32_t queueDepth_;
+  float avgQueueDepth_;
+  uint32_t underruns_;
 };
 
 /*
  * Webp decoder wrapper:
- *     Select a picture to decode in its own thread. The thread is deleted
- *     once a picture is decoded into its internal memory. The next picture
- *     will be decoded when:
- *       - the decoded frame is retrieved
- *       - Another DecodeFrame() is called [this is trigger]
- *    when display format changes, call DestroyDecoder() to release this decoder
- *    and allocate a new deocder object.
+ *     One decoding thread lives as long as the decoder. It decodes the
+ *     pictures in turn, ahead of the display, and waits while it is far
+ *     enough ahead. The display side takes the oldest picture with
+ *     GetDecodedFrame() and is done with it with ReleaseFrame().
+ *       - into a ring of ringSize frame buffers (in the window's geometry),
+ *         which the display copies to the window
+ *       - or directly into a FrameSurface: the thread locks its next
+ *         buffer and decodes the next picture there while the current one
+ *         is on screen; ReleaseFrame() posts it. Nothing is copied.
+ *     When display format changes, delete this decoder (the thread finishes
+ *     its current picture and exits) and create a new one.
  */
 class WebpDecoder {
  public:
+  static const uint32_t kDEFAULT_RING_SIZE = 3;
+
   explicit WebpDecoder(const char** files, uint32_t count,
                        DecodeSurfaceDescriptor* surfDesc,
-                       AAssetManager* assetMgr);
-  // Start decode a picture
-  bool DecodeFrame(void);
+                       WebpFileReader* reader,
+                       uint32_t ringSize = kDEFAULT_RING_SIZE);
+  explicit WebpDecoder(const char** files, uint32_t count,
+                       FrameSurface* surface, WebpFileReader* reader);
+  ~WebpDecoder();
 
-  // Poll to see if a picture is decoded and ready to be used/displayed
+  // Poll to see if a picture is decoded and ready to be used/displayed;
+  // the same picture is returned until ReleaseFrame()
   uint8_t* GetDecodedFrame(void);
 
-  // WebpDecoder internal decoding function, no called from user
-  void DecodeFrameInternal(void);
+  // Done with the picture of GetDecodedFrame(): its ring buffer can be
+  // reused, or, decoding into a surface, it is posted
+  void ReleaseFrame(void);
+
+  // libwebp options for the pictures decoded from now on; QUALITY to begin
+  // with: scaled up to the window, it costs little more than SPEED
+  void SetPreset(DecodePreset preset);
 
-  // Release this decoder after usage
-  bool DestroyDecoder(void);
+  bool IsDirect(void) const { return surface_ != nullptr; }
+  DecodeStats GetStats(void);
 
  private:
+  void DecodeLoop(void);
+  bool DecodeNext(const DecodeSurfaceDescriptor& desc, uint8_t* dst,
+                  const DecodeOptions& options);
+
   DecodeSurfaceDescriptor bufInfo_;
-  AAssetManager* assetMgr_;
-  std::queue<const char*> files_;
-  uint8_t* buf_;
-  bool stopPending_;
-  DecodeState state_;
+  WebpFileReader* reader_;
+  FrameSurface* surface_;
+  std::vector<const char*> files_;
+  uint32_t nextFile_;
+  DecodeOptions options_;
 
-  uint32_t bytePerPix_;
-  pthread_t* worker_;
-  /*
-   * private destructor prevent object directly call delete
-   */
-  ~WebpDecoder();
+  // ring: ready_ decoded pictures from head_ on, the rest are free; direct:
+  // ready_ is 1 while locked_ holds a decoded picture
+  std::vector<std::vector<uint8_t>> ring_;
+  uint32_t head_, ready_;
+  uint8_t* locked_;
+  bool exit_;
+  std::mutex lock_;
+  std::condition_variable space_;
+  std::thread worker_;
+
+  DecodeStats stats_;
+  double totalDecodeMs_;
+  uint64_t depthSamples_, depthTotal_;
 };
-#endif  // __WEBP_DECODE_H__
\ No newline at end of file
+#endif  // __WEBP_DECODE_H__
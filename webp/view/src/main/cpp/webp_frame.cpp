@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "webp_frame.h"
+
+#include <webp/decode.h>
+
+#include <cassert>
+
+uint32_t BytesPerPixel(SurfaceFormat format) {
+  switch (format) {
+    case SurfaceFormat::SURFACE_FORMAT_RGB_565:
+      return 2;
+    case SurfaceFormat::SURFACE_FORMAT_RGBA_8888:
+    case SurfaceFormat::SURFACE_FORMAT_RGBX_8888:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+size_t SurfaceBytes(const DecodeSurfaceDescriptor& surface) {
+  size_t stride = static_cast<size_t>(surface.stride_);
+  size_t height = static_cast<size_t>(surface.height_);
+  if (surface.format_ == SurfaceFormat::SURFACE_FORMAT_YUV_420) {
+    return stride * height + 2 * ((stride + 1) / 2) * ((height + 1) / 2);
+  }
+  return stride * height * BytesPerPixel(surface.format_);
+}
+
+DecodeOptions GetDecodeOptions(DecodePreset preset) {
+  DecodeOptions options;
+  options.bypassFiltering_ = preset == DecodePreset::DECODE_PRESET_SPEED;
+  options.noFancyUpsampling_ = false;
+  options.useThreads_ = true;
+  return options;
+}
+
+bool DecodeWebpFrame(const uint8_t* data, size_t size,
+                     const DecodeSurfaceDescriptor& surface, uint8_t* dst,
+                     DecodePreset preset) {
+  return DecodeWebpFrame(data, size, surface, dst, GetDecodeOptions(preset));
+}
+
+bool DecodeWebpFrame(const uint8_t* data, size_t size,
+                     const DecodeSurfaceDescriptor& surface, uint8_t* dst,
+                     const DecodeOptions& options) {
+  WebPDecoderConfig config;
+  if (!WebPInitDecoderConfig(&config)) {
+    assert(0);
+    return false;
+  }
+
+  VP8StatusCode status = WebPGetFeatures(data, size, &config.input);
+  assert(status == VP8_STATUS_OK);
+  if (status != VP8_STATUS_OK) return false;
+
+  // let's decode it into a buffer ...
+  config.options.bypass_filtering = options.bypassFiltering_;
+  config.options.no_fancy_upsampling = options.noFancyUpsampling_;
+  config.options.flip = 0;
+  config.options.use_scaling = config.input.width != surface.width_ ||
+                               config.input.height != surface.height_;
+  config.options.scaled_width = surface.width_;
+  config.options.scaled_height = surface.height_;
+  config.options.use_threads = options.useThreads_;
+
+  config.output.width = surface.width_;
+  config.output.height = surface.height_;
+  config.output.is_external_memory = 1;
+  config.output.private_memory = dst;
+  switch (surface.format_) {
+    case SurfaceFormat::SURFACE_FORMAT_RGB_565:
+      config.output.colorspace = MODE_RGB_565;
+      break;
+    case SurfaceFormat::SURFACE_FORMAT_RGBA_8888:
+    case SurfaceFormat::SURFACE_FORMAT_RGBX_8888:
+      config.output.colorspace = MODE_RGBA;
+      break;
+    case SurfaceFormat::SURFACE_FORMAT_YUV_420: {
+      config.output.colorspace = MODE_YUV;
+      WebPYUVABuffer& yuv = config.output.u.YUVA;
+      yuv.y_stride = surface.stride_;
+      yuv.y_size = static_cast<size_t>(yuv.y_stride) * surface.height_;
+      yuv.u_stride = yuv.v_stride = (surface.stride_ + 1) / 2;
+      yuv.u_size = yuv.v_size =
+          static_cast<size_t>(yuv.u_stride) * ((surface.height_ + 1) / 2);
+      yuv.y = dst;
+      yuv.u = yuv.y + yuv.y_size;
+      yuv.v = yuv.u + yuv.u_size;
+      break;
+    }
+    default:
+      assert(0);
+      return false;
+  }
+  if (config.output.colorspace != MODE_YUV) {
+    config.output.u.RGBA.stride =
+        surface.stride_ * BytesPerPixel(surface.format_);
+    config.output.u.RGBA.rgba = dst;
+    config.output.u.RGBA.size =
+        config.output.height * config.output.u.RGBA.stride;
+  }
+
+  status = WebPDecode(data, size, &config);
+  WebPFreeDecBuffer(&config.output);
+
+  assert(status == VP8_STATUS_OK);
+  return status == VP8_STATUS_OK;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WEBP_FRAME_H__
+#define __WEBP_FRAME_H__
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * What the decoder needs from the platform, and decoding one picture into a
+ * surface; nothing here depends on Android, so the decoder also builds on
+ * the host (see webp/host).
+ */
+enum class SurfaceFormat : unsigned int {
+  SURFACE_FORMAT_RGBA_8888,
+  SURFACE_FORMAT_RGBX_8888,
+  SURFACE_FORMAT_RGB_565,
+  SURFACE_FORMAT_YUV_420  // I420: Y plane, then U and V at half size
+};
+struct DecodeSurfaceDescriptor {
+  // surface size in pixels
+  int32_t width_, height_, stride_;
+  SurfaceFormat format_;
+};
+
+// 0 for formats the decoder does not support, and for YUV_420 (planar)
+uint32_t BytesPerPixel(SurfaceFormat format);
+// bytes of a surface's pixels, all planes
+size_t SurfaceBytes(const DecodeSurfaceDescriptor& surface);
+
+/*
+ * libwebp's speed / quality options:
+ *   bypassFiltering_:   skip VP8's in-loop deblocking filter; blocks show
+ *                       at low qualities
+ *   noFancyUpsampling_: replicate chroma instead of interpolating it (RGB
+ *                       output only); chroma edges get jaggy
+ *   useThreads_:        filter in a second thread, with a core to spare
+ * libwebp itself turns filtering and fancy upsampling off when scaling down
+ * below 3/4. Scaling to the surface is not an option: the rescaler only
+ * runs when the picture and the surface sizes differ.
+ */
+struct DecodeOptions {
+  bool bypassFiltering_;
+  bool noFancyUpsampling_;
+  bool useThreads_;
+};
+
+/*
+ * Presets, picked with host/decode_bench (see the README):
+ *   SPEED:   no filtering, for about 3/4 of QUALITY's time on large
+ *            pictures at 1:1; down to 30 dB PSNR
+ *   QUALITY: libwebp's defaults, the reference
+ * Neither takes noFancyUpsampling_: plain upsampling measured no faster.
+ * Both keep useThreads_, as the sample always had: on one core the thread
+ * doubled libwebp's heap for no gain, but that can't show what it gains
+ * on a phone's several cores, which decode_bench has not measured yet.
+ */
+enum class DecodePreset : unsigned int {
+  DECODE_PRESET_SPEED,
+  DECODE_PRESET_QUALITY,
+};
+DecodeOptions GetDecodeOptions(DecodePreset preset);
+
+/*
+ * DecodeWebpFrame():
+ *     Decodes a webp picture into dst, laid out as surface (stride in
+ *     pixels), scaled to the surface size.
+ */
+bool DecodeWebpFrame(const uint8_t* data, size_t size,
+                     const DecodeSurfaceDescriptor& surface, uint8_t* dst,
+                     const DecodeOptions& options);
+bool DecodeWebpFrame(const uint8_t* data, size_t size,
+                     const DecodeSurfaceDescriptor& surface, uint8_t* dst,
+                     DecodePreset preset);
+
+/*
+ * Surface to decode into directly, e.g. ANativeWindow: Lock() gets the next
+ * buffer to draw, Post() shows it. Lock() and Post() may be called on
+ * another thread than the one displaying.
+ */
+class FrameSurface {
+ public:
+  virtual ~FrameSurface() {}
+  // geometry and pixels of the locked buffer; false if it can't be locked
+  virtual bool Lock(DecodeSurfaceDescriptor* desc, uint8_t** bits) = 0;
+  virtual void Post(void) = 0;
+};
+
+/*
+ * Reads the webp files: Read() returns the content of a file, which stays
+ * valid until the next Read() (the reader may keep the file mapped)
+ */
+class WebpFileReader {
+ public:
+  virtual ~WebpFileReader() {}
+  virtual const uint8_t* Read(const char* name, size_t* size) = 0;
+};
+
+#endif  // __WEBP_FRAME_H__
@@ -21,6 +21,8 @@
 #include <cassert>
 #include <cstdio>
 
+#include "android_io.h"
+#include "webp_anim.h"
 #include "webp_decode.h"
 
 #define LOG_TAG "libwebp-view"
@@ -40,6 +42,19 @@ const char* frames[] = {
 };
 const int kFRAME_COUNT = sizeof(frames) / sizeof(frames[0]);
 const int kFRAME_DISPLAY_TIME = 2;
+// log decoder statistics every kSTATS_INTERVAL frames displayed
+const uint32_t kSTATS_INTERVAL = 10;
+// decode straight into the window's buffers, instead of into the decoder's
+// own buffers then copying them to the window
+const bool kDECODE_TO_WINDOW = true;
+
+/*
+ * true to play an animated webp (looping) instead of the slide show, if it
+ * opens
+ */
+const bool kPLAY_ANIMATION = false;
+const char* kANIMATION = "clips/anim.webp";
+const uint32_t kANIM_STATS_INTERVAL = 200;
 
 /*
  * main object handles Android window frame update, and use webp to decode
@@ -48,18 +63,36 @@ const int kFRAME_DISPLAY_TIME = 2;
 class Engine {
  public:
   explicit Engine(android_app* app)
-      : app_(app), decoder_(nullptr), animating_(false) {
+      : app_(app),
+        reader_(new AssetFileReader(app->activity->assetManager)),
+        animReader_(new AssetFileReader(app->activity->assetManager)),
+        surface_(nullptr),
+        decoder_(nullptr),
+        player_(nullptr),
+        animating_(false),
+        framesShown_(0),
+        playStarted_(false),
+        animFrame_(UINT32_MAX) {
     memset(&frameStartTime_, 0, sizeof(frameStartTime_));
+    memset(&playStartTime_, 0, sizeof(playStartTime_));
   }
 
-  ~Engine() {}
+  ~Engine() {
+    ReleaseDecoder();
+    delete reader_;
+    delete animReader_;
+  }
 
   struct android_app* AndroidApp(void) const {
     return app_;
   }
   void StartAnimation(bool start) { animating_ = start; }
   bool IsAnimating(void) const { return animating_; }
-  void TerminateDisplay(void) { StartAnimation(false); }
+  // the decoder may hold a window buffer: release it with the window
+  void TerminateDisplay(void) {
+    StartAnimation(false);
+    ReleaseDecoder();
+  }
 
   // PrepareDrawing(): Initialize the Engine with current native window geometry
   //   and blank current screen to avoid garbbage displaying on device
@@ -70,11 +103,28 @@ class Engine {
   bool UpdateDisplay(void);
 
  private:
-  void UpdateFrameBuffer(ANativeWindow_Buffer* buf, uint8_t* src);
+  void UpdateFrameBuffer(ANativeWindow_Buffer* buf, const uint8_t* src);
+  bool UpdateAnimation(void);
+  void ReleaseDecoder(void) {
+    delete decoder_;
+    delete surface_;
+    delete player_;
+    decoder_ = nullptr;
+    surface_ = nullptr;
+    player_ = nullptr;
+  }
   struct android_app* app_;
+  AssetFileReader* reader_;
+  AssetFileReader* animReader_;  // the player keeps its file mapped
+  WindowSurface* surface_;
   WebpDecoder* decoder_;
+  WebpAnimPlayer* player_;
   bool animating_;
+  uint32_t framesShown_;
   struct timespec frameStartTime_;
+  bool playStarted_;
+  uint32_t animFrame_;  // on screen
+  struct timespec playStartTime_;
 };
 
 static int32_t ProcessAndroidInput(struct android_app* app,
@@ -167,9 +217,7 @@ extern "C" void android_main(struct android_app* state) {
 // Engine class implementations
 bool Engine::PrepareDrawing(void) {
   // create decoder
-  if (decoder_) {
-    decoder_->DestroyDecoder();
-  }
+  ReleaseDecoder();
   ANativeWindow_Buffer buf;
   if (ANativeWindow_lock(app_->window, &buf, NULL) < 0) {
     LOGW("Unable to lock window buffer to create decoder");
@@ -177,44 +225,54 @@ bool Engine::PrepareDrawing(void) {
   }
   UpdateFrameBuffer(&buf, nullptr);
   ANativeWindow_unlockAndPost(app_->window);
+
   DecodeSurfaceDescriptor descriptor;
-  switch (buf.format) {
-    case WINDOW_FORMAT_RGB_565:
-      descriptor.format_ = SurfaceFormat::SURFACE_FORMAT_RGB_565;
-      break;
-    case WINDOW_FORMAT_RGBX_8888:
-      descriptor.format_ = SurfaceFormat::SURFACE_FORMAT_RGBX_8888;
-      break;
-    case WINDOW_FORMAT_RGBA_8888:
-      descriptor.format_ = SurfaceFormat::SURFACE_FORMAT_RGBA_8888;
-      break;
-    default:
-      return false;
+  if (!ToSurfaceFormat(buf.format, &descriptor.format_)) {
+    return false;
   }
   descriptor.width_ = buf.width;
   descriptor.height_ = buf.height;
   descriptor.stride_ = buf.stride;
 
-  decoder_ = new WebpDecoder(frames, kFRAME_COUNT, &descriptor,
-                             app_->activity->assetManager);
+  if (kPLAY_ANIMATION) {
+    player_ = new WebpAnimPlayer(kANIMATION, animReader_, descriptor);
+    if (player_->IsValid()) {
+      LOGI("Playing %s: %u frames, %u ms", kANIMATION, player_->FrameCount(),
+           player_->LoopDuration());
+      playStarted_ = false;
+      animFrame_ = UINT32_MAX;
+      return true;
+    }
+    LOGW("Unable to play %s, showing pictures", kANIMATION);
+    delete player_;
+    player_ = nullptr;
+  }
+
+  if (kDECODE_TO_WINDOW) {
+    surface_ = new WindowSurface(app_->window);
+    decoder_ = new WebpDecoder(frames, kFRAME_COUNT, surface_, reader_);
+    return true;
+  }
+
+  decoder_ = new WebpDecoder(frames, kFRAME_COUNT, &descriptor, reader_);
   assert(decoder_);
   if (!decoder_) {
     return false;
   }
-  decoder_->DecodeFrame();
 
   return true;
 }
 
 /*
- * Only copy decoded webp picture when:
+ * Only show decoded webp picture when:
  *  - current frame has been on for kFrame_DISPLAY_TIME seconds
  *  - a new picture is decoded
- * After copying, start decoding the next frame
+ * Pictures decoded into the window's buffer are just posted; others are
+ * copied to it, then their buffer goes back to the decoder
  */
 bool Engine::UpdateDisplay(void) {
+  if (player_) return UpdateAnimation();
   if (!app_->window || !decoder_) {
-    assert(0);
     return false;
   }
   struct timespec curTime;
@@ -227,17 +285,69 @@ bool Engine::UpdateDisplay(void) {
   uint8_t* frame = decoder_->GetDecodedFrame();
   if (!frame) return false;
 
+  if (!decoder_->IsDirect()) {
+    ANativeWindow_Buffer buffer;
+    if (ANativeWindow_lock(app_->window, &buffer, nullptr) < 0) {
+      LOGW("Unable to lock window buffer");
+      return false;
+    }
+    UpdateFrameBuffer(&buffer, frame);
+    ANativeWindow_unlockAndPost(app_->window);
+  }
+  decoder_->ReleaseFrame();
+  clock_gettime(CLOCK_MONOTONIC, &frameStartTime_);
+
+  if (++framesShown_ % kSTATS_INTERVAL == 0) {
+    DecodeStats stats = decoder_->GetStats();
+    LOGI("decoded %u (%u errors): %.1f ms avg, %.1f ms max; queue depth %u, "
+         "%.2f avg, %u underruns",
+         stats.framesDecoded_, stats.decodeErrors_, stats.avgDecodeMs_,
+         stats.maxDecodeMs_, stats.queueDepth_, stats.avgQueueDepth_,
+         stats.underruns_);
+  }
+  return true;
+}
+
+/*
+ * UpdateAnimation():
+ *     Shows the animation frame for the time since the first frame was
+ *     ready, when it is not on screen yet, drawn by the player straight
+ *     into the window buffer. The player never makes us wait: if that frame
+ *     is not decoded yet, the one on screen stays.
+ */
+bool Engine::UpdateAnimation(void) {
+  if (!app_->window) return false;
+  struct timespec curTime;
+  clock_gettime(CLOCK_MONOTONIC, &curTime);
+  uint32_t index;
+  if (!playStarted_) {
+    if (!player_->GetFrame(0, &index)) return false;
+    playStartTime_ = curTime;
+    playStarted_ = true;
+  }
+  uint32_t timeMs = static_cast<uint32_t>(
+      (curTime.tv_sec - playStartTime_.tv_sec) * 1000 +
+      (curTime.tv_nsec - playStartTime_.tv_nsec) / 1000000);
+  if (!player_->GetFrame(timeMs, &index) || index == animFrame_) return false;
+
   ANativeWindow_Buffer buffer;
   if (ANativeWindow_lock(app_->window, &buffer, nullptr) < 0) {
     LOGW("Unable to lock window buffer");
     return false;
   }
-  UpdateFrameBuffer(&buffer, frame);
+  player_->DrawFrame(reinterpret_cast<uint8_t*>(buffer.bits), buffer.stride);
   ANativeWindow_unlockAndPost(app_->window);
-  clock_gettime(CLOCK_MONOTONIC, &frameStartTime_);
+  animFrame_ = index;
 
-  // start decoding next frame
-  decoder_->DecodeFrame();
+  if (++framesShown_ % kANIM_STATS_INTERVAL == 0) {
+    AnimStats stats = player_->GetStats();
+    LOGI("shown %u (%u from cache, %u late), decoded %u (%u errors): "
+         "%.1f ms avg, %.1f ms max; cache %zu KB, %zu KB peak",
+         stats.framesShown_, stats.cacheHits_, stats.framesLate_,
+         stats.framesDecoded_, stats.decodeErrors_, stats.avgDecodeMs_,
+         stats.maxDecodeMs_, stats.cacheBytes_ / 1024,
+         stats.peakCacheBytes_ / 1024);
+  }
   return true;
 }
 
@@ -250,7 +360,8 @@ bool Engine::UpdateDisplay(void) {
  *     assumption:
  *         src and bug MUST be in the same geometry format & layout
  */
-void Engine::UpdateFrameBuffer(ANativeWindow_Buffer* buf, uint8_t* src) {
+void Engine::UpdateFrameBuffer(ANativeWindow_Buffer* buf,
+                               const uint8_t* src) {
   // src is either null: to blank the screen
   //     or holding exact pixels with the same fmt [stride is the SAME]
   uint8_t* dst = reinterpret_cast<uint8_t*>(buf->bits);